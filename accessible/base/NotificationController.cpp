@@ -852,8 +852,21 @@ NotificationController::WillRefresh(mozilla::TimeStamp aTime)
     mutEvent = nextEvent;
   }
 
+  // Send the show events for a chunk of inserted content in as few messages
+  // as possible.
+  DocAccessibleChild* ipcDoc = mDocument->IPCDoc();
+  if (ipcDoc) {
+    ipcDoc->BeginShowEventBatch();
+  }
+
   ProcessEventQueue();
 
+  // The document, and with it its IPC actor, may have been shut down while
+  // processing events.
+  if (ipcDoc && mDocument && mDocument->IPCDoc() == ipcDoc) {
+    ipcDoc->EndShowEventBatch();
+  }
+
   if (IPCAccessibilityActive()) {
     size_t newDocCount = newChildDocs.Length();
     for (size_t i = 0; i < newDocCount; i++) {
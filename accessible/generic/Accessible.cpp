@@ -859,6 +859,11 @@ Accessible::HandleAccEvent(AccEvent* aEvent)
       uint64_t id = aEvent->GetAccessible()->IsDoc() ? 0 :
         reinterpret_cast<uintptr_t>(aEvent->GetAccessible());
 
+      // The parent has to see any batched show events before this one.
+      if (aEvent->GetEventType() != nsIAccessibleEvent::EVENT_SHOW) {
+        ipcDoc->FlushShowEvents();
+      }
+
       switch(aEvent->GetEventType()) {
         case nsIAccessibleEvent::EVENT_SHOW:
           ipcDoc->ShowEvent(downcast_accEvent(aEvent));
@@ -86,10 +86,45 @@ DocAccessibleChildBase::ShowEvent(AccShowEvent* aShowEvent)
   Accessible* parent = aShowEvent->Parent();
   uint64_t parentID = parent->IsDoc() ? 0 : reinterpret_cast<uint64_t>(parent->UniqueID());
   uint32_t idxInParent = aShowEvent->GetAccessible()->IndexInParent();
+  bool fromUser = aShowEvent->IsFromUserInput();
+
+  // The parent inserts each subtree in the event at the index after the
+  // previous one's, so a subtree inserted right after those already pending
+  // can join them.
+  if (mPendingShowEvent && mPendingShowEvent->ID() == parentID &&
+      mPendingShowEvent->Idx() + mPendingShowRootCount == idxInParent &&
+      mPendingShowFromUser == fromUser) {
+    SerializeTree(aShowEvent->GetAccessible(), mPendingShowEvent->NewTree());
+    mPendingShowRootCount++;
+    return;
+  }
+
+  FlushShowEvents();
+
   nsTArray<AccessibleData> shownTree;
+  if (mBatchingShowEvents) {
+    mPendingShowEvent.emplace(parentID, idxInParent, shownTree);
+    mPendingShowRootCount = 1;
+    mPendingShowFromUser = fromUser;
+    SerializeTree(aShowEvent->GetAccessible(), mPendingShowEvent->NewTree());
+    return;
+  }
+
   ShowEventData data(parentID, idxInParent, shownTree);
   SerializeTree(aShowEvent->GetAccessible(), data.NewTree());
-  MaybeSendShowEvent(data, aShowEvent->IsFromUserInput());
+  MaybeSendShowEvent(data, fromUser);
+}
+
+void
+DocAccessibleChildBase::FlushShowEvents()
+{
+  if (!mPendingShowEvent) {
+    return;
+  }
+
+  MaybeSendShowEvent(mPendingShowEvent.ref(), mPendingShowFromUser);
+  mPendingShowEvent.reset();
+  mPendingShowRootCount = 0;
 }
 
 } // namespace a11y
@@ -9,6 +9,7 @@
 
 #include "mozilla/a11y/DocAccessible.h"
 #include "mozilla/a11y/PDocAccessibleChild.h"
+#include "mozilla/Maybe.h"
 #include "mozilla/Unused.h"
 #include "nsISupportsImpl.h"
 
@@ -23,6 +24,9 @@ class DocAccessibleChildBase : public PDocAccessibleChild
 public:
   explicit DocAccessibleChildBase(DocAccessible* aDoc)
     : mDoc(aDoc)
+    , mPendingShowRootCount(0)
+    , mPendingShowFromUser(false)
+    , mBatchingShowEvents(false)
   {
     MOZ_COUNT_CTOR(DocAccessibleChildBase);
   }
@@ -41,12 +45,33 @@ public:
 
   virtual void Shutdown()
   {
+    mPendingShowEvent.reset();
+    mBatchingShowEvents = false;
     DetachDocument();
     SendShutdown();
   }
 
   void ShowEvent(AccShowEvent* aShowEvent);
 
+  /**
+   * Between these calls, show events for consecutive siblings are sent to the
+   * parent as a single message once the batch ends or some other event has
+   * to be sent, rather than one message each. Inserting a large chunk of
+   * content otherwise takes a message per top-level node.
+   */
+  void BeginShowEventBatch() { mBatchingShowEvents = true; }
+  void EndShowEventBatch()
+  {
+    FlushShowEvents();
+    mBatchingShowEvents = false;
+  }
+
+  /**
+   * Send any show events held back by the current batch. This must be called
+   * before sending any other event so that the parent sees them in order.
+   */
+  void FlushShowEvents();
+
   virtual void ActorDestroy(ActorDestroyReason) override
   {
     if (!mDoc) {
@@ -73,6 +98,14 @@ protected:
   }
 
   DocAccessible*  mDoc;
+
+private:
+  // The show event being batched, whose NewTree holds mPendingShowRootCount
+  // sibling subtrees inserted at consecutive indexes from its Idx.
+  Maybe<ShowEventData> mPendingShowEvent;
+  uint32_t mPendingShowRootCount;
+  bool mPendingShowFromUser;
+  bool mBatchingShowEvents;
 };
 
 } // namespace a11y
@@ -49,48 +49,54 @@ DocAccessibleParent::RecvShowEvent(const ShowEventData& aData,
 #endif
   }
 
+  // The tree holds one or more sibling subtrees, which the child batched
+  // together, to be inserted at consecutive indexes.
+  const nsTArray<AccessibleData>& newTree = aData.NewTree();
   uint32_t newChildIdx = aData.Idx();
-  if (newChildIdx > parent->ChildrenCount()) {
-    NS_ERROR("invalid index to add child at");
+  for (uint32_t consumed = 0; consumed < newTree.Length(); newChildIdx++) {
+    if (newChildIdx > parent->ChildrenCount()) {
+      NS_ERROR("invalid index to add child at");
 #ifdef DEBUG
-    return IPC_FAIL(this, "invalid index");
+      return IPC_FAIL(this, "invalid index");
 #else
-    return IPC_OK();
+      return IPC_OK();
 #endif
-  }
+    }
 
-  uint32_t consumed = AddSubtree(parent, aData.NewTree(), 0, newChildIdx);
-  MOZ_ASSERT(consumed == aData.NewTree().Length());
+    uint32_t added = AddSubtree(parent, newTree, consumed, newChildIdx);
 
-  // XXX This shouldn't happen, but if we failed to add children then the below
-  // is pointless and can crash.
-  if (!consumed) {
-    return IPC_FAIL(this, "failed to add children");
-  }
+    // XXX This shouldn't happen, but if we failed to add children then the
+    // below is pointless and can crash.
+    if (!added) {
+      return IPC_FAIL(this, "failed to add children");
+    }
 
 #ifdef DEBUG
-  for (uint32_t i = 0; i < consumed; i++) {
-    uint64_t id = aData.NewTree()[i].ID();
-    MOZ_ASSERT(mAccessibles.GetEntry(id));
-  }
+    for (uint32_t i = consumed; i < consumed + added; i++) {
+      uint64_t id = newTree[i].ID();
+      MOZ_ASSERT(mAccessibles.GetEntry(id));
+    }
 #endif
 
-  MOZ_ASSERT(CheckDocTree());
+    consumed += added;
 
-  ProxyAccessible* target = parent->ChildAt(newChildIdx);
-  ProxyShowHideEvent(target, parent, true, aFromUser);
+    MOZ_ASSERT(CheckDocTree());
 
-  if (!nsCoreUtils::AccEventObserversExist()) {
-    return IPC_OK();
-  }
+    ProxyAccessible* target = parent->ChildAt(newChildIdx);
+    ProxyShowHideEvent(target, parent, true, aFromUser);
 
-  uint32_t type = nsIAccessibleEvent::EVENT_SHOW;
-  xpcAccessibleGeneric* xpcAcc = GetXPCAccessible(target);
-  xpcAccessibleDocument* doc = GetAccService()->GetXPCDocument(this);
-  nsIDOMNode* node = nullptr;
-  RefPtr<xpcAccEvent> event = new xpcAccEvent(type, xpcAcc, doc, node,
-                                              aFromUser);
-  nsCoreUtils::DispatchAccEvent(Move(event));
+    if (!nsCoreUtils::AccEventObserversExist()) {
+      continue;
+    }
+
+    uint32_t type = nsIAccessibleEvent::EVENT_SHOW;
+    xpcAccessibleGeneric* xpcAcc = GetXPCAccessible(target);
+    xpcAccessibleDocument* doc = GetAccService()->GetXPCDocument(this);
+    nsIDOMNode* node = nullptr;
+    RefPtr<xpcAccEvent> event = new xpcAccEvent(type, xpcAcc, doc, node,
+                                                aFromUser);
+    nsCoreUtils::DispatchAccEvent(Move(event));
+  }
 
   return IPC_OK();
 }
@@ -89,6 +89,14 @@ var Agent = {
    */
   maxUpgradeBackups: null,
 
+  /**
+   * The serialized state last written to `Paths.recovery`, or null if
+   * that file may not match it. An idle session produces the same state
+   * on each periodic save, and with many tabs rewriting and compressing
+   * it every time is a lot of wasted I/O.
+   */
+  lastWrittenState: null,
+
   /**
    * Initialize (or reinitialize) the worker
    *
@@ -117,6 +125,7 @@ var Agent = {
     this.maxSerializeBack = prefs.maxSerializeBack;
     this.maxSerializeForward = prefs.maxSerializeForward;
     this.upgradeBackupNeeded = paths.nextUpgradeBackup != paths.upgradeBackup;
+    this.lastWrittenState = null;
     return {result: true};
   },
 
@@ -158,6 +167,20 @@ var Agent = {
     }
 
     let stateString = JSON.stringify(state);
+
+    // Nothing has changed since we last wrote $Paths.recovery, which is
+    // still good, so there is no need to write it again.
+    if (!options.isFinalWrite && this.state == STATE_RECOVERY &&
+        stateString === this.lastWrittenState) {
+      return {
+        result: {
+          upgradeBackup: false
+        },
+        telemetry,
+      };
+    }
+    this.lastWrittenState = null;
+
     let data = Encoder.encode(stateString);
 
     try {
@@ -222,6 +245,10 @@ var Agent = {
         fileStat = File.stat(this.Paths.recovery);
       }
 
+      if (!options.isFinalWrite) {
+        this.lastWrittenState = stateString;
+      }
+
       telemetry.FX_SESSION_RESTORE_WRITE_FILE_MS = Date.now() - startWriteMs;
       telemetry.FX_SESSION_RESTORE_FILE_SIZE_BYTES = fileStat.size;
 
@@ -289,6 +316,7 @@ var Agent = {
       // these files.
       File.remove(this.Paths.recoveryBackup);
       File.remove(this.Paths.recovery);
+      this.lastWrittenState = null;
     }
 
     this.state = STATE_RECOVERY;
@@ -345,6 +373,7 @@ var Agent = {
 
 
     this.state = STATE_EMPTY;
+    this.lastWrittenState = null;
     if (exn) {
       throw exn;
     }
@@ -0,0 +1,270 @@
+/* -*-  Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2; -*- */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "mozilla/devtools/BackgroundGzipOutputStream.h"
+
+#include <algorithm>
+#include <google/protobuf/io/gzip_stream.h>
+
+#include "mozilla/devtools/ZeroCopyNSIOutputStream.h"
+#include "mozilla/Monitor.h"
+#include "mozilla/Move.h"
+#include "mozilla/Unused.h"
+#include "nsTArray.h"
+#include "nsThreadUtils.h"
+
+namespace mozilla {
+namespace devtools {
+
+// The state shared between the thread writing the stream and the background
+// thread compressing it.
+class BackgroundGzipOutputStream::State final
+{
+  ~State() {}
+
+public:
+  NS_INLINE_DECL_THREADSAFE_REFCOUNTING(State)
+
+  struct Chunk
+  {
+    UniquePtr<char[]> data;
+    int length;
+  };
+
+  State()
+    : monitor("BackgroundGzipOutputStream::State::monitor")
+    , pendingBytes(0)
+    , closed(false)
+    , finished(false)
+    , result(NS_OK)
+  { }
+
+  Monitor monitor;
+
+  // Chunks waiting to be compressed, and their total length.
+  nsTArray<Chunk> pending;
+  size_t pendingBytes;
+
+  // Set by the writing thread once it won't append any more chunks.
+  bool closed;
+
+  // Set by the background thread once everything has been written.
+  bool finished;
+
+  // The status of compressing and writing the data.
+  nsresult result;
+};
+
+// Runs on the background thread for the lifetime of the stream, compressing
+// and writing chunks as they arrive.
+class BackgroundGzipOutputStream::WriteTask final : public Runnable
+{
+  RefPtr<State> state;
+  nsCOMPtr<nsIOutputStream> out;
+
+  // Copy `length` bytes of `data` to `stream`.
+  static bool writeAll(::google::protobuf::io::ZeroCopyOutputStream& stream,
+                       const char* data, int length)
+  {
+    while (length > 0) {
+      void* buffer;
+      int size;
+      if (!stream.Next(&buffer, &size))
+        return false;
+
+      int amount = std::min(size, length);
+      memcpy(buffer, data, amount);
+      if (amount < size)
+        stream.BackUp(size - amount);
+
+      data += amount;
+      length -= amount;
+    }
+    return true;
+  }
+
+public:
+  WriteTask(State* state, nsIOutputStream* out)
+    : Runnable("devtools::BackgroundGzipOutputStream::WriteTask")
+    , state(state)
+    , out(out)
+  { }
+
+  NS_IMETHOD Run() override
+  {
+    nsresult rv = NS_OK;
+    {
+      ZeroCopyNSIOutputStream zeroCopyStream(out);
+      ::google::protobuf::io::GzipOutputStream gzipStream(&zeroCopyStream);
+
+      while (true) {
+        State::Chunk chunk;
+        {
+          MonitorAutoLock lock(state->monitor);
+          while (state->pending.IsEmpty() && !state->closed)
+            lock.Wait();
+          if (state->pending.IsEmpty())
+            break;
+
+          chunk = Move(state->pending[0]);
+          state->pending.RemoveElementAt(0);
+          state->pendingBytes -= chunk.length;
+          // Wake up the writing thread if it is waiting for room.
+          lock.NotifyAll();
+        }
+
+        // After a failure, keep draining the chunks so that the writing thread
+        // never waits on us, but don't write them anywhere.
+        if (NS_SUCCEEDED(rv) &&
+            !writeAll(gzipStream, chunk.data.get(), chunk.length)) {
+          rv = zeroCopyStream.failed() ? zeroCopyStream.result()
+                                       : NS_ERROR_UNEXPECTED;
+          MonitorAutoLock lock(state->monitor);
+          state->result = rv;
+        }
+      }
+
+      if (NS_SUCCEEDED(rv)) {
+        if (!gzipStream.Close()) {
+          rv = zeroCopyStream.failed() ? zeroCopyStream.result()
+                                       : NS_ERROR_UNEXPECTED;
+        } else {
+          rv = zeroCopyStream.flush();
+        }
+      }
+    }
+
+    if (NS_SUCCEEDED(rv))
+      rv = out->Close();
+
+    MonitorAutoLock lock(state->monitor);
+    if (NS_SUCCEEDED(state->result))
+      state->result = rv;
+    state->finished = true;
+    lock.NotifyAll();
+    return NS_OK;
+  }
+};
+
+BackgroundGzipOutputStream::BackgroundGzipOutputStream(nsIOutputStream* out)
+  : state(new State())
+  , amountUsed(0)
+  , writtenCount(0)
+{
+  RefPtr<WriteTask> task = new WriteTask(state, out);
+  nsresult rv = NS_NewNamedThread("HeapSnapshotIO", getter_AddRefs(thread),
+                                  task);
+  if (NS_WARN_IF(NS_FAILED(rv))) {
+    state->result = rv;
+    state->finished = true;
+  }
+}
+
+BackgroundGzipOutputStream::~BackgroundGzipOutputStream()
+{
+  Unused << NS_WARN_IF(NS_FAILED(close()));
+}
+
+nsresult
+BackgroundGzipOutputStream::result() const
+{
+  MonitorAutoLock lock(state->monitor);
+  return state->result;
+}
+
+bool
+BackgroundGzipOutputStream::flushChunk()
+{
+  if (amountUsed == 0)
+    return !failed();
+
+  MonitorAutoLock lock(state->monitor);
+  while (NS_SUCCEEDED(state->result) &&
+         state->pendingBytes + amountUsed > MAX_PENDING_BYTES) {
+    lock.Wait();
+  }
+  if (NS_FAILED(state->result))
+    return false;
+
+  state->pending.AppendElement(State::Chunk { Move(chunk), amountUsed });
+  state->pendingBytes += amountUsed;
+  writtenCount += amountUsed;
+  amountUsed = 0;
+  lock.NotifyAll();
+  return true;
+}
+
+nsresult
+BackgroundGzipOutputStream::close()
+{
+  if (!thread)
+    return result();
+
+  bool flushed = flushChunk();
+
+  {
+    MonitorAutoLock lock(state->monitor);
+    state->closed = true;
+    lock.NotifyAll();
+    while (!state->finished)
+      lock.Wait();
+  }
+
+  // The task has finished, so this doesn't need to spin the event loop.
+  thread->AsyncShutdown();
+  thread = nullptr;
+
+  nsresult rv = result();
+  return NS_SUCCEEDED(rv) && !flushed ? NS_ERROR_UNEXPECTED : rv;
+}
+
+// ZeroCopyOutputStream Interface
+
+bool
+BackgroundGzipOutputStream::Next(void** data, int* size)
+{
+  MOZ_ASSERT(data != nullptr);
+  MOZ_ASSERT(size != nullptr);
+
+  if (!thread)
+    return false;
+
+  if (amountUsed == CHUNK_SIZE) {
+    if (!flushChunk())
+      return false;
+  }
+
+  if (!chunk) {
+    chunk = MakeUnique<char[]>(CHUNK_SIZE);
+    amountUsed = 0;
+  }
+
+  *data = chunk.get() + amountUsed;
+  *size = CHUNK_SIZE - amountUsed;
+  amountUsed = CHUNK_SIZE;
+  return true;
+}
+
+void
+BackgroundGzipOutputStream::BackUp(int count)
+{
+  MOZ_ASSERT(count >= 0,
+             "Cannot back up a negative amount of bytes.");
+  MOZ_ASSERT(amountUsed == CHUNK_SIZE,
+             "Can only call BackUp directly after calling Next.");
+  MOZ_ASSERT(count <= amountUsed,
+             "Can't back up further than we've given out.");
+
+  amountUsed -= count;
+}
+
+::google::protobuf::int64
+BackgroundGzipOutputStream::ByteCount() const
+{
+  return writtenCount + amountUsed;
+}
+
+} // namespace devtools
+} // namespace mozilla
@@ -0,0 +1,85 @@
+/* -*-  Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2; -*- */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef mozilla_devtools_BackgroundGzipOutputStream__
+#define mozilla_devtools_BackgroundGzipOutputStream__
+
+#include <google/protobuf/io/zero_copy_stream.h>
+#include <google/protobuf/stubs/common.h>
+
+#include "mozilla/RefPtr.h"
+#include "mozilla/UniquePtr.h"
+#include "nsCOMPtr.h"
+#include "nsIOutputStream.h"
+#include "nsIThread.h"
+
+namespace mozilla {
+namespace devtools {
+
+// A `google::protobuf::io::ZeroCopyOutputStream` implementation that gzips
+// its data and writes it to an `nsIOutputStream` on a background thread.
+//
+// Data is collected in large chunks, and each full chunk is handed to the
+// background thread, so the thread writing the stream only pays for copying
+// its data into memory. To bound memory use, `Next` blocks while too much
+// data is waiting to be compressed.
+//
+// Call `close` to wait for all the data to be compressed and written. The
+// destructor closes the stream if that hasn't been done, but if you care
+// whether writing succeeded or failed, then you should call `close` yourself.
+class MOZ_STACK_CLASS BackgroundGzipOutputStream
+  : public ::google::protobuf::io::ZeroCopyOutputStream
+{
+  class State;
+  class WriteTask;
+
+  // The size of the chunks handed to the background thread.
+  static const int CHUNK_SIZE = 256 * 1024;
+
+  // The maximum number of bytes waiting to be compressed before `Next`
+  // blocks.
+  static const size_t MAX_PENDING_BYTES = 32 * 1024 * 1024;
+
+  RefPtr<State> state;
+  nsCOMPtr<nsIThread> thread;
+
+  // The chunk we are currently handing out space in.
+  UniquePtr<char[]> chunk;
+
+  // The number of bytes in the current chunk that have been used thus far.
+  int amountUsed;
+
+  // Excluding the current chunk, the number of bytes handed to the background
+  // thread.
+  int64_t writtenCount;
+
+  // Hand the current chunk to the background thread. Returns false if writing
+  // has failed.
+  bool flushChunk();
+
+public:
+  // Note that `out` is written to on the background thread.
+  explicit BackgroundGzipOutputStream(nsIOutputStream* out);
+
+  // Wait for all the data to be compressed and written, and return the status
+  // of doing so.
+  nsresult close();
+
+  // Return true if compressing or writing ever failed.
+  bool failed() const { return NS_FAILED(result()); }
+
+  nsresult result() const;
+
+  // ZeroCopyOutputStream Interface
+  virtual ~BackgroundGzipOutputStream() override;
+  virtual bool Next(void** data, int* size) override;
+  virtual void BackUp(int count) override;
+  virtual ::google::protobuf::int64 ByteCount() const override;
+};
+
+} // namespace devtools
+} // namespace mozilla
+
+#endif // mozilla_devtools_BackgroundGzipOutputStream__
@@ -18,6 +18,7 @@
 #include "mozilla/Attributes.h"
 #include "mozilla/CycleCollectedJSContext.h"
 #include "mozilla/devtools/AutoMemMap.h"
+#include "mozilla/devtools/BackgroundGzipOutputStream.h"
 #include "mozilla/devtools/CoreDump.pb.h"
 #include "mozilla/devtools/DeserializedNode.h"
 #include "mozilla/devtools/DominatorTree.h"
@@ -1587,8 +1588,10 @@ ThreadSafeChromeUtils::SaveHeapSnapshotShared(GlobalObject& global,
   if (NS_WARN_IF(rv.Failed()))
     return;
 
-  ZeroCopyNSIOutputStream zeroCopyStream(outputStream);
-  ::google::protobuf::io::GzipOutputStream gzipStream(&zeroCopyStream);
+  // Only walking the heap graph and encoding it happens on this thread; the
+  // encoded messages are compressed and written to disk on a background thread
+  // while we go.
+  BackgroundGzipOutputStream gzipStream(outputStream);
 
   JSContext* cx = global.Context();
 
@@ -1621,13 +1624,19 @@ ThreadSafeChromeUtils::SaveHeapSnapshotShared(GlobalObject& global,
                         nodeCount,
                         edgeCount))
     {
-      rv.Throw(zeroCopyStream.failed()
-               ? zeroCopyStream.result()
+      rv.Throw(gzipStream.failed()
+               ? gzipStream.result()
                : NS_ERROR_UNEXPECTED);
       return;
     }
   }
 
+  nsresult closeResult = gzipStream.close();
+  if (NS_WARN_IF(NS_FAILED(closeResult))) {
+    rv.Throw(closeResult);
+    return;
+  }
+
   Telemetry::AccumulateTimeDelta(Telemetry::DEVTOOLS_SAVE_HEAP_SNAPSHOT_MS,
                                  start);
   Telemetry::Accumulate(Telemetry::DEVTOOLS_HEAP_SNAPSHOT_NODE_COUNT,
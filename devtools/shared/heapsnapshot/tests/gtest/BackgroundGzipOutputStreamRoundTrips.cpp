@@ -0,0 +1,87 @@
+/* -*-  Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2; -*- */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+// Test that data written through a BackgroundGzipOutputStream, across many
+// chunks and with partial writes, comes back intact after gunzipping the file.
+
+#include "gtest/gtest.h"
+
+#include <google/protobuf/io/gzip_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+
+#include "mozilla/devtools/BackgroundGzipOutputStream.h"
+#include "nsDirectoryServiceDefs.h"
+#include "nsDirectoryServiceUtils.h"
+#include "nsIFile.h"
+#include "nsIInputStream.h"
+#include "nsNetUtil.h"
+#include "nsString.h"
+
+using namespace mozilla::devtools;
+
+static char
+ExpectedByte(size_t i)
+{
+  return char((i * 131) ^ (i >> 7));
+}
+
+TEST(DevTools, BackgroundGzipOutputStreamRoundTrips)
+{
+  nsCOMPtr<nsIFile> file;
+  ASSERT_EQ(NS_OK, NS_GetSpecialDirectory(NS_OS_TEMP_DIR, getter_AddRefs(file)));
+  ASSERT_EQ(NS_OK, file->Append(NS_LITERAL_STRING("heapsnapshot-gzip-test")));
+  ASSERT_EQ(NS_OK, file->CreateUnique(nsIFile::NORMAL_FILE_TYPE, 0600));
+
+  nsCOMPtr<nsIOutputStream> out;
+  ASSERT_EQ(NS_OK, NS_NewLocalFileOutputStream(getter_AddRefs(out), file));
+
+  // Several chunks' worth, handed out by Next and partly given back, the way
+  // CodedOutputStream uses it.
+  static const size_t kLength = 3 * 1024 * 1024 + 17;
+  size_t written = 0;
+  {
+    BackgroundGzipOutputStream stream(out);
+    while (written < kLength) {
+      void* data;
+      int size;
+      ASSERT_TRUE(stream.Next(&data, &size));
+      ASSERT_GT(size, 0);
+
+      size_t amount = std::min(std::min(size_t(size), kLength - written),
+                               size_t(written % 5000 + 1));
+      for (size_t i = 0; i < amount; i++)
+        static_cast<char*>(data)[i] = ExpectedByte(written + i);
+      stream.BackUp(size - int(amount));
+      written += amount;
+      ASSERT_EQ(int64_t(written), stream.ByteCount());
+    }
+    ASSERT_EQ(NS_OK, stream.close());
+  }
+
+  nsCOMPtr<nsIInputStream> in;
+  ASSERT_EQ(NS_OK, NS_NewLocalFileInputStream(getter_AddRefs(in), file));
+  int64_t fileSize = 0;
+  ASSERT_EQ(NS_OK, file->GetFileSize(&fileSize));
+  nsAutoCString compressed;
+  ASSERT_EQ(NS_OK, NS_ReadInputStreamToString(in, compressed,
+                                              uint32_t(fileSize)));
+  in->Close();
+  file->Remove(false);
+  ASSERT_LT(compressed.Length(), kLength);
+
+  ::google::protobuf::io::ArrayInputStream arrayStream(compressed.get(),
+                                                       compressed.Length());
+  ::google::protobuf::io::GzipInputStream gzipStream(&arrayStream);
+  size_t read = 0;
+  const void* data;
+  int size;
+  while (gzipStream.Next(&data, &size)) {
+    for (int i = 0; i < size; i++) {
+      ASSERT_EQ(ExpectedByte(read + i), static_cast<const char*>(data)[i]);
+    }
+    read += size;
+  }
+  ASSERT_EQ(kLength, read);
+}
@@ -808,6 +808,17 @@ protected:
 public:
   bool HasAttrs() const { return mAttrsAndChildren.HasAttrs(); }
 
+  /**
+   * Reserve room for aCount attributes that are about to be set, for callers
+   * such as the parser that know them all up front.  Only useful before any
+   * attribute or child has been added, and for attributes that are not
+   * mapped (the mapped ones of HTML elements are stored elsewhere).
+   */
+  nsresult ReserveAttrCapacity(uint32_t aCount)
+  {
+    return mAttrsAndChildren.EnsureCapacityForAttrs(aCount);
+  }
+
   inline bool GetAttr(const nsAString& aName, DOMString& aResult) const
   {
     MOZ_ASSERT(aResult.HasStringBuffer() && aResult.StringBufferLength() == 0,
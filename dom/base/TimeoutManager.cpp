@@ -20,6 +20,8 @@
 #include "mozilla/net/WebSocketEventService.h"
 #include "mozilla/MediaManager.h"
 
+#include <math.h>
+
 #ifdef MOZ_WEBRTC
 #include "IPeerConnection.h"
 #endif // MOZ_WEBRTC
@@ -56,6 +58,13 @@ static int32_t gForegroundThrottlingMaxBudget = 0;
 static int32_t gBudgetThrottlingMaxDelay = 0;
 static bool    gEnableBudgetTimeoutThrottling = false;
 
+// Wake-ups of background windows are aligned to multiples of this many
+// milliseconds, counted from a process wide origin, so that the timers of
+// all the background windows tend to fire together.
+#define DEFAULT_BACKGROUND_COALESCING_WINDOW 100 // 100ms
+static int32_t gBackgroundCoalescingWindow = 0;
+static TimeStamp gCoalescingOrigin;
+
 // static
 const uint32_t TimeoutManager::InvalidFiringId = 0;
 
@@ -225,7 +234,34 @@ TimeoutManager::MaybeSchedule(const TimeStamp& aWhen, const TimeStamp& aNow)
   // Before we can schedule the executor we need to make sure that we
   // have an updated execution budget.
   UpdateBudget(aNow);
-  return mExecutor->MaybeSchedule(aWhen, MinSchedulingDelay());
+  TimeDuration minDelay =
+    CoalescedSchedulingDelay(aWhen, aNow, MinSchedulingDelay());
+  return mExecutor->MaybeSchedule(aWhen, minDelay);
+}
+
+TimeDuration
+TimeoutManager::CoalescedSchedulingDelay(const TimeStamp& aWhen,
+                                         const TimeStamp& aNow,
+                                         const TimeDuration& aMinDelay) const
+{
+  if (gBackgroundCoalescingWindow <= 0 || IsActive() ||
+      !mWindow.IsBackgroundInternal()) {
+    return aMinDelay;
+  }
+
+  // Round the time the executor would fire at up to the next multiple of
+  // the coalescing window.  Only the timer is delayed, the deadline of the
+  // timeout is left alone, so nothing is rescheduled in between.
+  TimeStamp target = aNow + aMinDelay;
+  if (aWhen > target) {
+    target = aWhen;
+  }
+  double window = gBackgroundCoalescingWindow;
+  double aligned =
+    ceil((target - gCoalescingOrigin).ToMilliseconds() / window) * window;
+  TimeStamp wakeUp =
+    gCoalescingOrigin + TimeDuration::FromMilliseconds(aligned);
+  return TimeDuration::Max(aMinDelay, wakeUp - aNow);
 }
 
 bool
@@ -306,6 +342,7 @@ TimeoutManager::RecordExecution(Timeout* aRunningTimeout,
     TimeDuration duration = budgetManager.RecordExecution(
       now, aRunningTimeout, mWindow.IsBackgroundInternal());
     budgetManager.MaybeCollectTelemetry(now);
+    mTotalExecutionTime += duration;
 
     UpdateBudget(now, duration);
   }
@@ -405,7 +442,8 @@ TimeoutManager::~TimeoutManager()
   mExecutor->Shutdown();
 
   MOZ_LOG(gLog, LogLevel::Debug,
-          ("TimeoutManager %p destroyed\n", this));
+          ("TimeoutManager %p destroyed, ran timeouts for %fms\n",
+           this, mTotalExecutionTime.ToMilliseconds()));
 }
 
 /* static */
@@ -460,6 +498,11 @@ TimeoutManager::Initialize()
   Preferences::AddBoolVarCache(&gEnableBudgetTimeoutThrottling,
                                "dom.timeout.enable_budget_timer_throttling",
                                DEFAULT_ENABLE_BUDGET_TIMEOUT_THROTTLING);
+  Preferences::AddIntVarCache(&gBackgroundCoalescingWindow,
+                              "dom.timeout.background_coalescing_window",
+                              DEFAULT_BACKGROUND_COALESCING_WINDOW);
+
+  gCoalescingOrigin = TimeStamp::Now();
 }
 
 uint32_t
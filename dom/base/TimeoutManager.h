@@ -139,6 +139,10 @@ private:
   TimeDuration
   MinSchedulingDelay() const;
 
+  TimeDuration
+  CoalescedSchedulingDelay(const TimeStamp& aWhen, const TimeStamp& aNow,
+                           const TimeDuration& aMinDelay) const;
+
   nsresult MaybeSchedule(const TimeStamp& aWhen,
                          const TimeStamp& aNow = TimeStamp::Now());
 
@@ -237,6 +241,8 @@ private:
   nsCOMPtr<nsITimer>          mThrottleTimeoutsTimer;
   mozilla::TimeStamp          mLastBudgetUpdate;
   mozilla::TimeDuration       mExecutionBudget;
+  // The total time spent running this window's timeout callbacks.
+  mozilla::TimeDuration       mTotalExecutionTime;
 
   bool                        mThrottleTimeouts;
   bool                        mThrottleTrackingTimeouts;
@@ -843,6 +843,36 @@ nsresult nsAttrAndChildArray::EnsureCapacityToClone(const nsAttrAndChildArray& a
   return NS_OK;
 }
 
+nsresult
+nsAttrAndChildArray::EnsureCapacityForAttrs(uint32_t aAttrCount)
+{
+  if (mImpl || aAttrCount == 0) {
+    return NS_OK;
+  }
+
+  // Anything past the limit would fail to be set anyway.
+  if (aAttrCount > ATTRCHILD_ARRAY_MAX_ATTR_COUNT) {
+    aAttrCount = ATTRCHILD_ARRAY_MAX_ATTR_COUNT;
+  }
+
+  uint32_t size = aAttrCount * ATTRSIZE;
+  uint32_t totalSize = size + NS_IMPL_EXTRA_SIZE;
+
+  mImpl = static_cast<Impl*>(malloc(totalSize * sizeof(void*)));
+  NS_ENSURE_TRUE(mImpl, NS_ERROR_OUT_OF_MEMORY);
+
+  mImpl->mMappedAttrs = nullptr;
+  mImpl->mBufferSize = size;
+
+  // As in EnsureCapacityToClone, the slots are only reserved; AddAttrSlot
+  // fills the first empty one.
+  memset(static_cast<void*>(mImpl->mBuffer), 0,
+         sizeof(InternalAttr) * aAttrCount);
+  SetAttrSlotAndChildCount(aAttrCount, 0);
+
+  return NS_OK;
+}
+
 bool
 nsAttrAndChildArray::GrowBy(uint32_t aGrowSize)
 {
@@ -160,6 +160,11 @@ public:
   nsresult EnsureCapacityToClone(const nsAttrAndChildArray& aOther,
                                  bool aAllocateChildren);
 
+  // Reserves exactly enough space for |aAttrCount| unmapped attributes, so
+  // that setting them one by one does not grow the buffer each time.  Does
+  // nothing if the array already has a buffer.
+  nsresult EnsureCapacityForAttrs(uint32_t aAttrCount);
+
 private:
   nsAttrAndChildArray(const nsAttrAndChildArray& aOther) = delete;
   nsAttrAndChildArray& operator=(const nsAttrAndChildArray& aOther) = delete;
@@ -865,12 +865,49 @@ nsContentList::ContentRemoved(nsIDocument *aDocument,
   // Note that aContainer can be null here if we are removing from
   // the document itself; any attempted optimizations to this method
   // should deal with that.
-  if (mState != LIST_DIRTY &&
-      MayContainRelevantNodes(NODE_FROM(aContainer, aDocument)) &&
-      nsContentUtils::IsInSameAnonymousTree(mRootNode, aChild) &&
-      MatchSelf(aChild)) {
+  if (mState == LIST_DIRTY ||
+      !MayContainRelevantNodes(NODE_FROM(aContainer, aDocument)) ||
+      !nsContentUtils::IsInSameAnonymousTree(mRootNode, aChild)) {
+    return;
+  }
+
+  // Find the first element of the removed subtree that we match.
+  nsIContent* firstMatch = nullptr;
+  for (nsIContent* cur = aChild;
+       cur;
+       cur = mDeep ? cur->GetNextNode(aChild) : nullptr) {
+    if (cur->IsElement() && Match(cur->AsElement())) {
+      firstMatch = cur;
+      break;
+    }
+  }
+
+  if (!firstMatch) {
+    ASSERT_IN_SYNC;
+    return;
+  }
+
+  /*
+   * The elements of the subtree we have are a contiguous run of our list,
+   * since it is in document order; drop that run rather than rebuilding
+   * the whole list.  If firstMatch is not where that run starts (it was
+   * never picked up by a lazy list, or our function matches differently now
+   * that the subtree is gone), give up and invalidate.
+   */
+  size_t start = mElements.IndexOf(firstMatch);
+  if (start == mElements.NoIndex ||
+      (start > 0 &&
+       nsContentUtils::ContentIsDescendantOf(mElements[start - 1], aChild))) {
     SetDirty();
+    return;
+  }
+
+  size_t end = start + 1;
+  while (end < mElements.Length() &&
+         nsContentUtils::ContentIsDescendantOf(mElements[end], aChild)) {
+    ++end;
   }
+  mElements.RemoveElementsAt(start, end - start);
 
   ASSERT_IN_SYNC;
 }
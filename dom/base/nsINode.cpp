@@ -2793,6 +2793,43 @@ FindMatchingElementsWithId(const nsAString& aId, nsINode* aRoot,
   }
 }
 
+// If every match of aSelector must be a descendant of an element with some
+// id, because a compound selector to its left has that id and is joined by a
+// descendant or child combinator, and the document has just one element with
+// that id, find the node whose descendants are the only candidates under
+// aRoot: that element if it is below aRoot, or aRoot if the element is aRoot
+// or contains it.  Returns null if nothing under aRoot can match, and aRoot if
+// there is no such id.  aRoot must be in the document.
+static nsINode*
+NarrowSubtreeForAncestorId(nsINode* aRoot, nsCSSSelector* aSelector)
+{
+  for (nsCSSSelector* sel = aSelector->mNext; sel; sel = sel->mNext) {
+    if (!sel->mIDList ||
+        (sel->mOperator != char16_t(' ') && sel->mOperator != char16_t('>'))) {
+      continue;
+    }
+
+    nsDependentAtomString id(sel->mIDList->mAtom);
+    const nsTArray<Element*>* elements =
+      aRoot->OwnerDoc()->GetAllElementsForId(id);
+    if (!elements || elements->IsEmpty()) {
+      return nullptr;
+    }
+    if (elements->Length() != 1) {
+      continue;
+    }
+
+    Element* element = elements->ElementAt(0);
+    if (element == aRoot ||
+        nsContentUtils::ContentIsDescendantOf(aRoot, element)) {
+      return aRoot;
+    }
+    return nsContentUtils::ContentIsDescendantOf(element, aRoot) ? element
+                                                                 : nullptr;
+  }
+  return aRoot;
+}
+
 // Actually find elements matching aSelectorList (which must not be
 // null) and which are descendants of aRoot and put them in aList.  If
 // onlyFirstMatch, then stop once the first one is found.
@@ -2828,10 +2865,22 @@ FindMatchingElements(nsINode* aRoot, nsCSSSelectorList* aSelectorList, T &aList,
     return;
   }
 
+  // Likewise, when the id is further left in the selector, only the subtree
+  // of the element with that id needs walking.
+  nsINode* walkRoot = aRoot;
+  if (aRoot->IsInUncomposedDoc() &&
+      doc->GetCompatibilityMode() != eCompatibility_NavQuirks &&
+      !aSelectorList->mNext) {
+    walkRoot = NarrowSubtreeForAncestorId(aRoot, aSelectorList->mSelectors);
+    if (!walkRoot) {
+      return;
+    }
+  }
+
   Collector results;
-  for (nsIContent* cur = aRoot->GetFirstChild();
+  for (nsIContent* cur = walkRoot->GetFirstChild();
        cur;
-       cur = cur->GetNextNode(aRoot)) {
+       cur = cur->GetNextNode(walkRoot)) {
     if (cur->IsElement() &&
         nsCSSRuleProcessor::SelectorListMatches(cur->AsElement(),
                                                 matchingContext,
@@ -374,6 +374,13 @@ CollectWindowReports(nsGlobalWindow *aWindow,
   aWindowTotalSizes->mArenaSizes.mLineBoxes
     += windowSizes.mArenaSizes.mLineBoxes;
 
+  REPORT_SIZE("/layout/free-arena-objects",
+              windowSizes.mArenaSizes.mFreeObjects,
+              "Memory used by freed objects in layout's PresShell arena, "
+              "waiting to be reused, within a window.");
+  aWindowTotalSizes->mArenaSizes.mFreeObjects
+    += windowSizes.mArenaSizes.mFreeObjects;
+
   REPORT_SIZE("/layout/rule-nodes", windowSizes.mArenaSizes.mRuleNodes,
               "Memory used by CSS rule nodes within a window.");
   aWindowTotalSizes->mArenaSizes.mRuleNodes
@@ -567,6 +574,11 @@ nsWindowMemoryReporter::CollectReports(nsIHandleReportCallback* aHandleReport,
          windowTotalSizes.mArenaSizes.mLineBoxes,
          "This is the sum of all windows' 'layout/line-boxes' numbers.");
 
+  REPORT("window-objects/layout/free-arena-objects",
+         windowTotalSizes.mArenaSizes.mFreeObjects,
+         "This is the sum of all windows' 'layout/free-arena-objects' "
+         "numbers.");
+
   REPORT("window-objects/layout/rule-nodes",
          windowTotalSizes.mArenaSizes.mRuleNodes,
          "This is the sum of all windows' 'layout/rule-nodes' numbers.");
@@ -81,6 +81,13 @@ static_assert(sizeof(void*) == 4, "Only support 32-bit and 64-bit");
  * updated. It does this by calling UpdateWrapper() on the wrapper
  * cache. SetWrapper() asserts that the hook is implemented for any wrapper set.
  *
+ * Wrappers for interfaces marked [ProbablyShortLivingWrapper] may be allocated
+ * in the nursery. SetWrapper() records such caches with the
+ * CycleCollectedJSRuntime, and after each minor GC the wrappers that were not
+ * tenured are finalized from CycleCollectedJSRuntime::JSObjectsTenured(),
+ * since the nursery doesn't run finalizers itself. Preserving a nursery
+ * wrapper roots it until it has been tenured.
+ *
  * A number of the methods are implemented in nsWrapperCacheInlines.h because we
  * have to include some JS headers that don't play nicely with the rest of the
  * codebase. Include nsWrapperCacheInlines.h if you need to call those methods.
@@ -2679,7 +2679,18 @@ NormalizeUSVString(nsAString& aString)
 void
 NormalizeUSVString(binding_detail::FakeString& aString)
 {
-  NormalizeUSVStringInternal(aString);
+  // aString may be sharing its characters with a DOM string or a literal, so
+  // it needs a copy of its own before it can be modified.  Unpaired
+  // surrogates are rare, so only make that copy once we've found one.
+  const char16_t* nextChar = aString.Data();
+  const char16_t* end = nextChar + aString.Length();
+  while (nextChar < end) {
+    if (UTF16CharEnumerator::NextChar(&nextChar, end) == UCS2_REPLACEMENT_CHAR) {
+      aString.EnsureMutable();
+      NormalizeUSVStringInternal(aString);
+      return;
+    }
+  }
 }
 
 bool
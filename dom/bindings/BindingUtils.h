@@ -2024,6 +2024,34 @@ enum StringificationBehavior {
   eNull
 };
 
+// Like AssignJSString, but for strings that came out of the DOM in the first
+// place and are being passed back in, shares their characters instead of
+// copying them.
+inline bool
+AssignJSString(JSContext* cx, binding_detail::FakeString& result, JSString* s)
+{
+  if (JS_IsExternalString(s)) {
+    size_t length = js::GetStringLength(s);
+    if (XPCStringConvert::IsDOMString(s)) {
+      // The characters are an nsStringBuffer shared by
+      // XPCStringConvert::ReadableToJSVal.
+      const char16_t* chars = JS_GetTwoByteExternalStringChars(s);
+      if (chars[length] == '\0') {
+        result.ShareStringBuffer(nsStringBuffer::FromData((void*)chars),
+                                 length);
+        return true;
+      }
+    } else if (XPCStringConvert::IsLiteral(s)) {
+      // The characters are a char16_t string constant compiled into libxul.
+      const char16_t* chars = JS_GetTwoByteExternalStringChars(s);
+      result.RebindLiteral(chars, length);
+      return true;
+    }
+  }
+
+  return ::AssignJSString(cx, result, s);
+}
+
 template<typename T>
 static inline bool
 ConvertJSValueToString(JSContext* cx, JS::Handle<JS::Value> v,
@@ -49,6 +49,45 @@ struct FakeString {
     }
   }
 
+  // Share aBuffer, whose characters must be null-terminated at aLength.
+  void ShareStringBuffer(nsStringBuffer* aBuffer, nsString::size_type aLength) {
+    RefPtr<nsStringBuffer> sharedBuffer = aBuffer;
+    AssignFromStringBuffer(sharedBuffer.forget());
+    mLength = aLength;
+  }
+
+  // Make this string depend upon a null-terminated string constant, which
+  // nsStrings assigned from this one will then depend upon too.
+  void RebindLiteral(const nsString::char_type* aData,
+                     nsString::size_type aLength) {
+    Rebind(aData, aLength);
+    mDataFlags |= nsString::DataFlags::LITERAL;
+  }
+
+  // Copy our characters into storage of our own if they might be shared with
+  // someone else, so that they can be modified through BeginWriting().
+  void EnsureMutable() {
+    if (mData == mInlineStorage) {
+      return;
+    }
+    nsStringBuffer* oldBuffer = nullptr;
+    if (mDataFlags & nsString::DataFlags::SHARED) {
+      oldBuffer = nsStringBuffer::FromData(mData);
+      if (!oldBuffer->IsReadonly()) {
+        return;
+      }
+    }
+    const nsString::char_type* oldData = mData;
+    mDataFlags = nsString::DataFlags::TERMINATED;
+    if (MOZ_UNLIKELY(!SetLength(mLength, mozilla::fallible))) {
+      NS_ABORT_OOM((mLength + 1) * sizeof(nsString::char_type));
+    }
+    memcpy(mData, oldData, mLength * sizeof(nsString::char_type));
+    if (oldBuffer) {
+      oldBuffer->Release();
+    }
+  }
+
   void Truncate() {
     MOZ_ASSERT(mDataFlags == nsString::DataFlags::TERMINATED);
     mData = nsString::char_traits::sEmptyBuffer;
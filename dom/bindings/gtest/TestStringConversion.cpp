@@ -0,0 +1,144 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "gtest/gtest.h"
+#include "gtest/MozGTestBench.h" // For MOZ_GTEST_BENCH
+
+#include "jsapi.h"
+#include "mozilla/dom/BindingUtils.h"
+#include "mozilla/dom/ScriptSettings.h"
+#include "mozilla/dom/SimpleGlobalObject.h"
+#include "xpcpublic.h"
+
+using namespace mozilla;
+using namespace mozilla::dom;
+
+// Long enough that it isn't one of the JS engine's static strings.
+#define TEST_STRING "A string being passed from the DOM back into the DOM"
+
+static void
+InitJSAPI(AutoJSAPI& aJSAPI)
+{
+  JSObject* global =
+    SimpleGlobalObject::Create(SimpleGlobalObject::GlobalType::BindingDetail);
+  ASSERT_TRUE(global);
+  ASSERT_TRUE(aJSAPI.Init(global));
+}
+
+TEST(BindingStrings, DOMStringIsShared)
+{
+  AutoJSAPI jsapi;
+  InitJSAPI(jsapi);
+  JSContext* cx = jsapi.cx();
+
+  nsAutoString domString;
+  domString.AssignLiteral(TEST_STRING);
+  const nsString string(domString);
+  ASSERT_TRUE(nsStringBuffer::FromString(string));
+
+  JS::Rooted<JS::Value> v(cx);
+  ASSERT_TRUE(xpc::NonVoidStringToJsval(cx, string, &v));
+
+  binding_detail::FakeString arg;
+  ASSERT_TRUE(ConvertJSValueToString(cx, v, arg));
+  EXPECT_EQ(string.BeginReading(), arg.Data());
+  EXPECT_TRUE(string.Equals(arg));
+}
+
+TEST(BindingStrings, LiteralIsShared)
+{
+  AutoJSAPI jsapi;
+  InitJSAPI(jsapi);
+  JSContext* cx = jsapi.cx();
+
+  NS_NAMED_LITERAL_STRING(literal, TEST_STRING);
+  JS::Rooted<JS::Value> v(cx);
+  ASSERT_TRUE(xpc::NonVoidStringToJsval(cx, literal, &v));
+
+  binding_detail::FakeString arg;
+  ASSERT_TRUE(ConvertJSValueToString(cx, v, arg));
+  EXPECT_EQ(literal.BeginReading(), arg.Data());
+
+  nsString copy(arg);
+  EXPECT_TRUE(copy.IsLiteral());
+}
+
+TEST(BindingStrings, JSStringIsCopied)
+{
+  AutoJSAPI jsapi;
+  InitJSAPI(jsapi);
+  JSContext* cx = jsapi.cx();
+
+  JSString* str = JS_NewStringCopyZ(cx, TEST_STRING);
+  ASSERT_TRUE(str);
+  JS::Rooted<JS::Value> v(cx, JS::StringValue(str));
+
+  binding_detail::FakeString arg;
+  ASSERT_TRUE(ConvertJSValueToString(cx, v, arg));
+  EXPECT_TRUE(arg.ToAStringPtr()->EqualsLiteral(TEST_STRING));
+}
+
+TEST(BindingStrings, USVStringDoesNotModifyDOMString)
+{
+  AutoJSAPI jsapi;
+  InitJSAPI(jsapi);
+  JSContext* cx = jsapi.cx();
+
+  nsAutoString domString;
+  domString.AssignLiteral(TEST_STRING);
+  domString.Append(char16_t(0xD841));
+  const nsString string(domString);
+
+  JS::Rooted<JS::Value> v(cx);
+  ASSERT_TRUE(xpc::NonVoidStringToJsval(cx, string, &v));
+
+  binding_detail::FakeString arg;
+  ASSERT_TRUE(ConvertJSValueToUSVString(cx, v, arg));
+  EXPECT_NE(string.BeginReading(), arg.Data());
+  EXPECT_EQ(char16_t(0xFFFD), arg.Data()[arg.Length() - 1]);
+  EXPECT_EQ(char16_t(0xD841), string.Last());
+}
+
+static const uint32_t kBenchIterations = 100000;
+
+MOZ_GTEST_BENCH(BindingStrings, ConvertDOMString, [] {
+  AutoJSAPI jsapi;
+  InitJSAPI(jsapi);
+  JSContext* cx = jsapi.cx();
+
+  nsAutoString domString;
+  for (int i = 0; i < 20; i++) {
+    domString.AppendLiteral(TEST_STRING);
+  }
+  const nsString string(domString);
+  JS::Rooted<JS::Value> v(cx);
+  ASSERT_TRUE(xpc::NonVoidStringToJsval(cx, string, &v));
+
+  for (uint32_t i = 0; i < kBenchIterations; i++) {
+    binding_detail::FakeString arg;
+    ASSERT_TRUE(ConvertJSValueToString(cx, v, arg));
+  }
+});
+
+MOZ_GTEST_BENCH(BindingStrings, ConvertJSString, [] {
+  AutoJSAPI jsapi;
+  InitJSAPI(jsapi);
+  JSContext* cx = jsapi.cx();
+
+  nsAutoString jsString;
+  for (int i = 0; i < 20; i++) {
+    jsString.AppendLiteral(TEST_STRING);
+  }
+  JSString* str =
+    JS_NewUCStringCopyN(cx, jsString.BeginReading(), jsString.Length());
+  ASSERT_TRUE(str);
+  JS::Rooted<JS::Value> v(cx, JS::StringValue(str));
+
+  for (uint32_t i = 0; i < kBenchIterations; i++) {
+    binding_detail::FakeString arg;
+    ASSERT_TRUE(ConvertJSValueToString(cx, v, arg));
+  }
+});
@@ -61,6 +61,10 @@ CacheStreamControlParent::SerializeStream(CacheReadStream* aReadStreamOut,
   MOZ_DIAGNOSTIC_ASSERT(aReadStreamOut);
   MOZ_DIAGNOSTIC_ASSERT(aStream);
 
+  // Bodies opened by BodyOpen() are still snappy compressed file streams.
+  // Being nsIIPCSerializableInputStreams, they cross to the child as file
+  // descriptors rather than as data pumped through an IPCStream actor, and
+  // the child's ReadStream uncompresses them as they are read.
   UniquePtr<AutoIPCStream> autoStream(new AutoIPCStream(aReadStreamOut->stream()));
   DebugOnly<bool> ok = autoStream->Serialize(aStream, Manager());
   MOZ_ASSERT(ok);
@@ -114,6 +114,7 @@ WebGLContext::WebGLContext()
     , mNumPerfWarnings(0)
     , mMaxAcceptableFBStatusInvals(gfxPrefs::WebGLMaxAcceptableFBStatusInvals())
     , mDataAllocGLCallCount(0)
+    , mDrawCallCount(0)
     , mBufferFetchingIsVerified(false)
     , mBufferFetchingHasPerVertex(false)
     , mMaxFetchedVertices(0)
@@ -1589,6 +1590,14 @@ WebGLContext::OnEndOfFrame() const
                            mDataAllocGLCallCount);
    }
    mDataAllocGLCallCount = 0;
+
+   if (gfxPrefs::WebGLSpewFrameDraws()) {
+      GeneratePerfWarning("[webgl.perf.spew-frame-draws] %" PRIu64 " draw calls this"
+                          " frame, taking %.3fms.",
+                          mDrawCallCount, mDrawCallTime.ToMilliseconds());
+   }
+   mDrawCallCount = 0;
+   mDrawCallTime = TimeDuration();
    gl->ResetSyncCallCount("WebGLContext PresentScreenBuffer");
 }
 
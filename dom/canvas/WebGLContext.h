@@ -19,6 +19,7 @@
 #include "mozilla/ErrorResult.h"
 #include "mozilla/gfx/2D.h"
 #include "mozilla/LinkedList.h"
+#include "mozilla/TimeStamp.h"
 #include "mozilla/UniquePtr.h"
 #include "nsCycleCollectionNoteChild.h"
 #include "nsICanvasRenderingContextInternal.h"
@@ -1044,6 +1045,16 @@ private:
        return mDataAllocGLCallCount;
     }
 
+    // Draw call debugging variables, for webgl.perf.spew-frame-draws.
+    // mDrawCallTime is only measured while that pref is set.
+    mutable uint64_t mDrawCallCount;
+    mutable TimeDuration mDrawCallTime;
+
+    void OnDrawCall(const TimeDuration& cost) const {
+       mDrawCallCount++;
+       mDrawCallTime += cost;
+    }
+
     void OnEndOfFrame() const;
 
 // -----------------------------------------------------------------------------
@@ -2085,6 +2096,7 @@ public:
 
     // Friend list
     friend class ScopedCopyTexImageSource;
+    friend class ScopedDrawCallCost;
     friend class ScopedResolveTexturesForDraw;
     friend class ScopedUnpackReset;
     friend class webgl::TexUnpackBlob;
@@ -6,6 +6,7 @@
 #include "WebGLContext.h"
 
 #include "GLContext.h"
+#include "gfxPrefs.h"
 #include "mozilla/CheckedInt.h"
 #include "mozilla/UniquePtrExtensions.h"
 #include "nsPrintfCString.h"
@@ -29,6 +30,27 @@ static const int MAX_DRAW_CALLS_SINCE_FLUSH = 100;
 
 ////////////////////////////////////////
 
+// Counts a draw call, and measures how long it took the CPU to validate and
+// issue it if webgl.perf.spew-frame-draws is set.
+class ScopedDrawCallCost
+{
+    const WebGLContext* const mWebGL;
+    const TimeStamp mStart;
+
+public:
+    explicit ScopedDrawCallCost(const WebGLContext* webgl)
+        : mWebGL(webgl)
+        , mStart(gfxPrefs::WebGLSpewFrameDraws() ? TimeStamp::Now() : TimeStamp())
+    { }
+
+    ~ScopedDrawCallCost() {
+        mWebGL->OnDrawCall(mStart.IsNull() ? TimeDuration()
+                                           : TimeStamp::Now() - mStart);
+    }
+};
+
+////////////////////////////////////////
+
 class ScopedResolveTexturesForDraw
 {
     struct TexRebindRequest
@@ -555,6 +577,7 @@ WebGLContext::DrawArrays(GLenum mode, GLint first, GLsizei vertCount)
     if (IsContextLost())
         return;
 
+    const ScopedDrawCallCost scopedCost(this);
     MakeContextCurrent();
 
     bool error = false;
@@ -592,6 +615,7 @@ WebGLContext::DrawArraysInstanced(GLenum mode, GLint first, GLsizei vertCount,
     if (IsContextLost())
         return;
 
+    const ScopedDrawCallCost scopedCost(this);
     MakeContextCurrent();
 
     bool error = false;
@@ -780,6 +804,7 @@ WebGLContext::DrawElements(GLenum mode, GLsizei vertCount, GLenum type,
     if (IsContextLost())
         return;
 
+    const ScopedDrawCallCost scopedCost(this);
     MakeContextCurrent();
 
     bool error = false;
@@ -825,6 +850,7 @@ WebGLContext::DrawElementsInstanced(GLenum mode, GLsizei vertCount, GLenum type,
     if (IsContextLost())
         return;
 
+    const ScopedDrawCallCost scopedCost(this);
     MakeContextCurrent();
 
     bool error = false;
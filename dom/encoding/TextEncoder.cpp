@@ -6,10 +6,69 @@
 
 #include "mozilla/dom/TextEncoder.h"
 #include "mozilla/Encoding.h"
+#include "mozilla/UniquePtr.h"
+#include "mozilla/Unused.h"
+#include "js/Utility.h"
+#include "jsfriendapi.h"
 
 namespace mozilla {
 namespace dom {
 
+// Strings at least this long are encoded straight into the memory of the
+// returned ArrayBuffer.  Shorter ones are cheaper to copy into a Uint8Array
+// that can live in the nursery.
+static const uint32_t kEncodeInPlaceMinLength = 4096;
+
+static JSObject*
+EncodeInPlace(JSContext* aCx, const nsAString& aString)
+{
+  UniquePtr<Encoder> encoder = UTF_8_ENCODING->NewEncoder();
+  CheckedInt<size_t> needed =
+    encoder->MaxBufferLengthFromUTF16WithoutReplacement(aString.Length());
+  if (!needed.isValid() || needed.value() > INT32_MAX) {
+    return nullptr;
+  }
+
+  UniquePtr<uint8_t[], JS::FreePolicy> buffer(
+    js_pod_malloc<uint8_t>(needed.value()));
+  if (!buffer) {
+    return nullptr;
+  }
+
+  uint32_t result;
+  size_t read;
+  size_t written;
+  bool hadReplacements;
+  Tie(result, read, written, hadReplacements) =
+    encoder->EncodeFromUTF16(MakeSpan(aString.BeginReading(), aString.Length()),
+                             MakeSpan(buffer.get(), needed.value()), true);
+  MOZ_ASSERT(result == kInputEmpty);
+  MOZ_ASSERT(read == aString.Length());
+  MOZ_ASSERT(written <= needed.value());
+  Unused << hadReplacements;
+
+  // Hand back whatever the worst case estimate did not use.  If that fails
+  // the larger buffer is still good.
+  if (written && written < needed.value()) {
+    uint8_t* shrunk =
+      js_pod_realloc<uint8_t>(buffer.get(), needed.value(), written);
+    if (shrunk) {
+      Unused << buffer.release();
+      buffer.reset(shrunk);
+    }
+  }
+
+  JS::Rooted<JSObject*> arrayBuffer(aCx,
+    JS_NewArrayBufferWithContents(aCx, written, buffer.get()));
+  if (!arrayBuffer) {
+    return nullptr;
+  }
+  // The ArrayBuffer owns the data now.
+  Unused << buffer.release();
+
+  return JS_NewUint8ArrayWithBuffer(aCx, arrayBuffer, 0, int32_t(written));
+}
+
 void
 TextEncoder::Init()
 {
@@ -22,6 +81,17 @@ TextEncoder::Encode(JSContext* aCx,
                     JS::MutableHandle<JSObject*> aRetval,
                     ErrorResult& aRv)
 {
+  if (aString.Length() >= kEncodeInPlaceMinLength) {
+    JSAutoCompartment ac(aCx, aObj);
+    JSObject* outView = EncodeInPlace(aCx, aString);
+    if (!outView) {
+      aRv.Throw(NS_ERROR_OUT_OF_MEMORY);
+      return;
+    }
+    aRetval.set(outView);
+    return;
+  }
+
   nsAutoCString utf8;
   nsresult rv;
   const Encoding* ignored;
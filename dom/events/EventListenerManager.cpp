@@ -117,6 +117,7 @@ IsWebkitPrefixSupportEnabled()
 
 EventListenerManagerBase::EventListenerManagerBase()
   : mNoListenerForEvent(eVoidEvent)
+  , mNoListenerForPreviousEvent(eVoidEvent)
   , mMayHavePaintEventListener(false)
   , mMayHaveMutationListeners(false)
   , mMayHaveCapturingListeners(false)
@@ -130,7 +131,8 @@ EventListenerManagerBase::EventListenerManagerBase()
   , mClearingListeners(false)
   , mIsMainThreadELM(NS_IsMainThread())
 {
-  static_assert(sizeof(EventListenerManagerBase) == sizeof(uint32_t),
+  static_assert(sizeof(EventListenerManagerBase) ==
+                  sizeof(uint32_t) + sizeof(EventMessageType),
                 "Keep the size of EventListenerManagerBase size compact!");
 }
 
@@ -275,6 +277,7 @@ EventListenerManager::AddEventListenerInternal(
   }
 
   mNoListenerForEvent = eVoidEvent;
+  mNoListenerForPreviousEvent = eVoidEvent;
   mNoListenerForEventAtom = nullptr;
 
   listener = aAllEvents ? mListeners.InsertElementAt(0) :
@@ -592,6 +595,7 @@ EventListenerManager::NotifyEventListenerRemoved(nsIAtom* aUserType,
   // If the following code is changed, other callsites of EventListenerRemoved
   // and NotifyAboutMainThreadListenerChange should be changed too.
   mNoListenerForEvent = eVoidEvent;
+  mNoListenerForPreviousEvent = eVoidEvent;
   mNoListenerForEventAtom = nullptr;
   if (mTarget) {
     if (aUserType) {
@@ -1352,6 +1356,10 @@ EventListenerManager::HandleEventInternal(nsPresContext* aPresContext,
   }
 
   if (mIsMainThreadELM && !hasListener) {
+    if (mNoListenerForEvent != aEvent->mMessage &&
+        mNoListenerForEvent != eUnidentifiedEvent) {
+      mNoListenerForPreviousEvent = mNoListenerForEvent;
+    }
     mNoListenerForEvent = aEvent->mMessage;
     mNoListenerForEventAtom = aEvent->mSpecifiedEventType;
   }
@@ -156,6 +156,10 @@ protected:
   EventListenerManagerBase();
 
   EventMessage mNoListenerForEvent;
+  // The event (other than eUnidentifiedEvent) that mNoListenerForEvent held
+  // before it, so that targets which see interleaved events, such as
+  // pointermove and mousemove, do not keep walking their listeners for both.
+  EventMessage mNoListenerForPreviousEvent;
   uint16_t mMayHavePaintEventListener : 1;
   uint16_t mMayHaveMutationListeners : 1;
   uint16_t mMayHaveCapturingListeners : 1;
@@ -372,6 +376,9 @@ public:
          mNoListenerForEventAtom == aEvent->mSpecifiedEventType)) {
       return;
     }
+    if (mNoListenerForPreviousEvent == aEvent->mMessage) {
+      return;
+    }
     HandleEventInternal(aPresContext, aEvent, aDOMEvent, aCurrentTarget,
                         aEventStatus);
   }
@@ -3651,6 +3651,14 @@ public:
     MOZ_ASSERT(mActionFunc);
   }
 
+  // Makes Run a no-op, for when the actor goes away first.
+  void
+  Disconnect()
+  {
+    mActor = nullptr;
+    mRequest = nullptr;
+  }
+
 private:
   ~DelayedActionRunnable()
   { }
@@ -3668,6 +3676,8 @@ BackgroundCursorChild::BackgroundCursorChild(IDBRequest* aRequest,
   , mIndex(nullptr)
   , mCursor(nullptr)
   , mStrongRequest(aRequest)
+  , mCachedResponsesWriteCount(0)
+  , mDelayedResponseDispatcher(nullptr)
   , mDirection(aDirection)
 {
   MOZ_ASSERT(aObjectStore);
@@ -3686,6 +3696,8 @@ BackgroundCursorChild::BackgroundCursorChild(IDBRequest* aRequest,
   , mIndex(aIndex)
   , mCursor(nullptr)
   , mStrongRequest(aRequest)
+  , mCachedResponsesWriteCount(0)
+  , mDelayedResponseDispatcher(nullptr)
   , mDirection(aDirection)
 {
   MOZ_ASSERT(aIndex);
@@ -3700,8 +3712,38 @@ BackgroundCursorChild::~BackgroundCursorChild()
   MOZ_COUNT_DTOR(indexedDB::BackgroundCursorChild);
 }
 
+bool
+BackgroundCursorChild::CanUseCachedResponses(
+                                    const CursorRequestParams& aParams) const
+{
+  AssertIsOnOwningThread();
+  MOZ_ASSERT(mTransaction);
+
+  if (mCachedResponses.IsEmpty() ||
+      mCachedResponsesWriteCount != mTransaction->WriteRequestCount()) {
+    return false;
+  }
+
+  // Requests made before this one must get their results first.
+  if (mTransaction->HasPendingRequests()) {
+    return false;
+  }
+
+  switch (aParams.type()) {
+    case CursorRequestParams::TContinueParams:
+      return aParams.get_ContinueParams().key().IsUnset();
+
+    case CursorRequestParams::TAdvanceParams:
+      return aParams.get_AdvanceParams().count() <= mCachedResponses.Length();
+
+    default:
+      return false;
+  }
+}
+
 void
-BackgroundCursorChild::SendContinueInternal(const CursorRequestParams& aParams)
+BackgroundCursorChild::SendContinueInternal(const CursorRequestParams& aParams,
+                                            const Key& aCurrentKey)
 {
   AssertIsOnOwningThread();
   MOZ_ASSERT(mRequest);
@@ -3709,6 +3751,8 @@ BackgroundCursorChild::SendContinueInternal(const CursorRequestParams& aParams)
   MOZ_ASSERT(mCursor);
   MOZ_ASSERT(!mStrongRequest);
   MOZ_ASSERT(!mStrongCursor);
+  MOZ_ASSERT(!mDelayedResponseDispatcher);
+  MOZ_ASSERT_IF(!mCachedResponses.IsEmpty(), !aCurrentKey.IsUnset());
 
   // Make sure all our DOM objects stay alive.
   mStrongCursor = mCursor;
@@ -3716,9 +3760,66 @@ BackgroundCursorChild::SendContinueInternal(const CursorRequestParams& aParams)
   MOZ_ASSERT(mRequest->ReadyState() == IDBRequestReadyState::Done);
   mRequest->Reset();
 
+  if (CanUseCachedResponses(aParams)) {
+    if (aParams.type() == CursorRequestParams::TAdvanceParams) {
+      // Drop the records advance() steps over.
+      uint32_t skipCount = aParams.get_AdvanceParams().count() - 1;
+      mCachedResponses.RemoveElementsAt(mCachedResponses.Length() - skipCount,
+                                        skipCount);
+    }
+
+    mTransaction->OnNewRequest();
+
+    // The success event must not be fired from within continue().
+    RefPtr<DelayedActionRunnable> dispatcher = new DelayedActionRunnable(
+      this, &BackgroundCursorChild::SendCachedResponse);
+    mDelayedResponseDispatcher = dispatcher;
+    MOZ_ALWAYS_SUCCEEDS(this->GetActorEventTarget()->
+      Dispatch(dispatcher.forget(), NS_DISPATCH_NORMAL));
+    return;
+  }
+
+  // Anything else is answered by the parent, which is told where we are in
+  // case it prefetched records we are now dropping.
+  mCachedResponses.Clear();
+
+  // Only object store cursors pass their key, and only they prefetch.
+  uint32_t prefetchCount = 0;
+  if (!aCurrentKey.IsUnset()) {
+    prefetchCount = IndexedDatabaseManager::CursorPrefetchCount();
+    mCachedResponsesWriteCount = mTransaction->WriteRequestCount();
+  }
+
   mTransaction->OnNewRequest();
 
-  MOZ_ALWAYS_TRUE(PBackgroundIDBCursorChild::SendContinue(aParams));
+  MOZ_ALWAYS_TRUE(PBackgroundIDBCursorChild::SendContinue(aParams,
+                                                          aCurrentKey,
+                                                          prefetchCount));
+}
+
+void
+BackgroundCursorChild::SendCachedResponse()
+{
+  AssertIsOnOwningThread();
+  MOZ_ASSERT(mRequest);
+  MOZ_ASSERT(mTransaction);
+  MOZ_ASSERT(mCursor);
+  MOZ_ASSERT(mStrongCursor);
+  MOZ_ASSERT(!mCachedResponses.IsEmpty());
+
+  mDelayedResponseDispatcher = nullptr;
+
+  RefPtr<IDBCursor> cursor;
+  mStrongCursor.swap(cursor);
+
+  CachedResponse& response = mCachedResponses.LastElement();
+  mCursor->Reset(Move(response.mKey), Move(response.mCloneInfo));
+  mCachedResponses.RemoveElementAt(mCachedResponses.Length() - 1);
+
+  ResultHelper helper(mRequest, mTransaction, mCursor);
+  DispatchSuccessEvent(&helper);
+
+  mTransaction->OnRequestFinished(/* aActorDestroyedNormally */ true);
 }
 
 void
@@ -3790,13 +3891,18 @@ BackgroundCursorChild::HandleResponse(
   MOZ_ASSERT(!mStrongRequest);
   MOZ_ASSERT(!mStrongCursor);
 
-  MOZ_ASSERT(aResponses.Length() == 1);
+  MOZ_ASSERT(!aResponses.IsEmpty());
+  MOZ_ASSERT(mCachedResponses.IsEmpty());
 
   // XXX Fix this somehow...
   auto& responses =
     const_cast<nsTArray<ObjectStoreCursorResponse>&>(aResponses);
 
-  for (ObjectStoreCursorResponse& response : responses) {
+  // The first record is the one asked for. Any others were prefetched for the
+  // next continue() calls and are kept, in reverse order.
+  for (uint32_t index = responses.Length(); index > 0; index--) {
+    ObjectStoreCursorResponse& response = responses[index - 1];
+
     StructuredCloneReadInfo cloneReadInfo(Move(response.cloneInfo()));
     cloneReadInfo.mDatabase = mTransaction->Database();
 
@@ -3805,6 +3911,13 @@ BackgroundCursorChild::HandleResponse(
                                     nullptr,
                                     cloneReadInfo.mFiles);
 
+    if (index > 1) {
+      CachedResponse* cachedResponse = mCachedResponses.AppendElement();
+      cachedResponse->mKey = Move(response.key());
+      cachedResponse->mCloneInfo = Move(cloneReadInfo);
+      continue;
+    }
+
     RefPtr<IDBCursor> newCursor;
 
     if (mCursor) {
@@ -3934,6 +4047,14 @@ BackgroundCursorChild::ActorDestroy(ActorDestroyReason aWhy)
                                     aWhy == Deletion);
   }
 
+  // A continue() served from prefetched records must not touch us anymore.
+  if (mDelayedResponseDispatcher) {
+    mDelayedResponseDispatcher->Disconnect();
+    mDelayedResponseDispatcher = nullptr;
+  }
+
+  mCachedResponses.Clear();
+
   if (mCursor) {
     mCursor->ClearBackgroundActor();
 #ifdef DEBUG
@@ -4005,7 +4126,10 @@ NS_IMETHODIMP
 BackgroundCursorChild::
 DelayedActionRunnable::Run()
 {
-  MOZ_ASSERT(mActor);
+  if (!mActor) {
+    return NS_OK;
+  }
+
   mActor->AssertIsOnOwningThread();
   MOZ_ASSERT(mRequest);
   MOZ_ASSERT(mActionFunc);
@@ -8,6 +8,7 @@
 #define mozilla_dom_indexeddb_actorschild_h__
 
 #include "IDBTransaction.h"
+#include "IndexedDatabase.h"
 #include "js/RootingAPI.h"
 #include "mozilla/Attributes.h"
 #include "mozilla/dom/indexedDB/PBackgroundIDBCursorChild.h"
@@ -750,6 +751,12 @@ class BackgroundCursorChild final
 
   class DelayedActionRunnable;
 
+  struct CachedResponse
+  {
+    Key mKey;
+    StructuredCloneReadInfo mCloneInfo;
+  };
+
   IDBRequest* mRequest;
   IDBTransaction* mTransaction;
   IDBObjectStore* mObjectStore;
@@ -760,6 +767,16 @@ class BackgroundCursorChild final
   RefPtr<IDBRequest> mStrongRequest;
   RefPtr<IDBCursor> mStrongCursor;
 
+  // Records the parent sent after the one an object store cursor asked for,
+  // in reverse order so that the next one is last.
+  nsTArray<CachedResponse> mCachedResponses;
+
+  // The transaction's WriteRequestCount() when those records were requested.
+  uint64_t mCachedResponsesWriteCount;
+
+  // Set while a continue() served from mCachedResponses is pending.
+  DelayedActionRunnable* mDelayedResponseDispatcher;
+
   Direction mDirection;
 
   NS_DECL_OWNINGTHREAD
@@ -780,7 +797,8 @@ public:
   }
 
   void
-  SendContinueInternal(const CursorRequestParams& aParams);
+  SendContinueInternal(const CursorRequestParams& aParams,
+                       const Key& aCurrentKey);
 
   void
   SendDeleteMeInternal();
@@ -822,6 +840,12 @@ private:
   // BackgroundVersionChangeTransactionChild.
   ~BackgroundCursorChild();
 
+  bool
+  CanUseCachedResponses(const CursorRequestParams& aParams) const;
+
+  void
+  SendCachedResponse();
+
   void
   HandleResponse(nsresult aResponse);
 
@@ -849,7 +873,9 @@ private:
 
   // Force callers to use SendContinueInternal.
   bool
-  SendContinue(const CursorRequestParams& aParams) = delete;
+  SendContinue(const CursorRequestParams& aParams,
+               const Key& aCurrentKey,
+               const uint32_t& aPrefetchCount) = delete;
 
   bool
   SendDeleteMe() = delete;
@@ -242,6 +242,21 @@ const uint32_t kConnectionThreadIdleMS = 30 * 1000; // 30 seconds
 
 const uint32_t kFileCopyBufferSize = 32768;
 
+// The most records an object store cursor sends ahead of continue() calls,
+// and the structured clone size after which it stops adding more.
+const uint32_t kMaxCursorPrefetchCount = 1000;
+const size_t kMaxCursorPrefetchSize = 1024 * 1024;
+
+// The segment capacity and alignment JSStructuredCloneData uses.
+const size_t kCloneSegmentCapacity = 4096;
+const size_t kCloneSegmentAlignment = 8;
+
+constexpr size_t
+AlignedCloneSegmentSize(size_t aSize)
+{
+  return (aSize + kCloneSegmentAlignment - 1) & ~(kCloneSegmentAlignment - 1);
+}
+
 #define JOURNAL_DIRECTORY_NAME "journals"
 
 const char kFileManagerDirectoryNameSuffix[] = ".files";
@@ -8740,7 +8755,9 @@ private:
   RecvDeleteMe() override;
 
   mozilla::ipc::IPCResult
-  RecvContinue(const CursorRequestParams& aParams) override;
+  RecvContinue(const CursorRequestParams& aParams,
+               const Key& aCurrentKey,
+               const uint32_t& aPrefetchCount) override;
 
   bool
   IsLocaleAware() const {
@@ -8833,15 +8850,21 @@ class Cursor::ContinueOp final
   friend class Cursor;
 
   const CursorRequestParams mParams;
+  const uint32_t mPrefetchCount;
 
 private:
   // Only created by Cursor.
   ContinueOp(Cursor* aCursor,
-             const CursorRequestParams& aParams)
+             const CursorRequestParams& aParams,
+             uint32_t aPrefetchCount)
     : CursorOpBase(aCursor)
     , mParams(aParams)
+    , mPrefetchCount(aPrefetchCount)
   {
     MOZ_ASSERT(aParams.type() != CursorRequestParams::T__None);
+    MOZ_ASSERT_IF(aPrefetchCount,
+                  aCursor->mType ==
+                    OpenCursorParams::TObjectStoreOpenCursorParams);
   }
 
   // Reference counted.
@@ -16953,7 +16976,9 @@ Cursor::RecvDeleteMe()
 }
 
 mozilla::ipc::IPCResult
-Cursor::RecvContinue(const CursorRequestParams& aParams)
+Cursor::RecvContinue(const CursorRequestParams& aParams,
+                     const Key& aCurrentKey,
+                     const uint32_t& aPrefetchCount)
 {
   AssertIsOnBackgroundThread();
   MOZ_ASSERT(aParams.type() != CursorRequestParams::T__None);
@@ -16963,6 +16988,29 @@ Cursor::RecvContinue(const CursorRequestParams& aParams)
                   mType == OpenCursorParams::TIndexOpenKeyCursorParams,
                 mIndexMetadata);
 
+  // Only object store cursors prefetch records, and their position is just
+  // their key.
+  if (mType != OpenCursorParams::TObjectStoreOpenCursorParams &&
+      (!aCurrentKey.IsUnset() || aPrefetchCount)) {
+    ASSERT_UNLESS_FUZZING();
+    return IPC_FAIL_NO_REASON(this);
+  }
+
+  if (NS_WARN_IF(mCurrentlyRunningOp)) {
+    ASSERT_UNLESS_FUZZING();
+    return IPC_FAIL_NO_REASON(this);
+  }
+
+  // The child may not have used all of the records prefetched for it, in
+  // which case it continues from an earlier key than ours.
+  if (!aCurrentKey.IsUnset()) {
+    if (NS_WARN_IF(mKey.IsUnset())) {
+      ASSERT_UNLESS_FUZZING();
+      return IPC_FAIL_NO_REASON(this);
+    }
+    mKey = aCurrentKey;
+  }
+
   const bool trustParams =
 #ifdef DEBUG
   // Always verify parameters in DEBUG builds!
@@ -16977,17 +17025,14 @@ Cursor::RecvContinue(const CursorRequestParams& aParams)
     return IPC_FAIL_NO_REASON(this);
   }
 
-  if (NS_WARN_IF(mCurrentlyRunningOp)) {
-    ASSERT_UNLESS_FUZZING();
-    return IPC_FAIL_NO_REASON(this);
-  }
-
   if (NS_WARN_IF(mTransaction->mCommitOrAbortReceived)) {
     ASSERT_UNLESS_FUZZING();
     return IPC_FAIL_NO_REASON(this);
   }
 
-  RefPtr<ContinueOp> continueOp = new ContinueOp(this, aParams);
+  RefPtr<ContinueOp> continueOp =
+    new ContinueOp(this, aParams,
+                   std::min(aPrefetchCount, kMaxCursorPrefetchCount));
   if (NS_WARN_IF(!continueOp->Init(mTransaction))) {
     continueOp->Cleanup();
     return IPC_FAIL_NO_REASON(this);
@@ -19769,20 +19814,44 @@ DatabaseOperationBase::GetStructuredCloneReadInfoFromBlob(
     return NS_ERROR_FILE_CORRUPTED;
   }
 
-  AutoTArray<uint8_t, 512> uncompressed;
-  if (NS_WARN_IF(!uncompressed.SetLength(uncompressedLength, fallible))) {
-    return NS_ERROR_OUT_OF_MEMORY;
-  }
+  // Uncompress straight into a single segment of the clone buffer when one can
+  // be allocated, rather than into a temporary that is then copied.
+  bool uncompressedInPlace = false;
+  if (!aInfo->mData.Size() && uncompressedLength) {
+    JSStructuredCloneData data(0,
+                               AlignedCloneSegmentSize(uncompressedLength),
+                               kCloneSegmentCapacity);
 
-  char* uncompressedBuffer = reinterpret_cast<char*>(uncompressed.Elements());
+    size_t allocated;
+    char* buffer = data.AllocateBytes(uncompressedLength, &allocated);
+    if (buffer && allocated == uncompressedLength) {
+      if (NS_WARN_IF(!snappy::RawUncompress(compressed, compressedLength,
+                                            buffer))) {
+        return NS_ERROR_FILE_CORRUPTED;
+      }
 
-  if (NS_WARN_IF(!snappy::RawUncompress(compressed, compressedLength,
-                                        uncompressedBuffer))) {
-    return NS_ERROR_FILE_CORRUPTED;
+      aInfo->mData = Move(data);
+      uncompressedInPlace = true;
+    }
   }
 
-  if (!aInfo->mData.WriteBytes(uncompressedBuffer, uncompressed.Length())) {
-    return NS_ERROR_OUT_OF_MEMORY;
+  if (!uncompressedInPlace) {
+    AutoTArray<uint8_t, 512> uncompressed;
+    if (NS_WARN_IF(!uncompressed.SetLength(uncompressedLength, fallible))) {
+      return NS_ERROR_OUT_OF_MEMORY;
+    }
+
+    char* uncompressedBuffer =
+      reinterpret_cast<char*>(uncompressed.Elements());
+
+    if (NS_WARN_IF(!snappy::RawUncompress(compressed, compressedLength,
+                                          uncompressedBuffer))) {
+      return NS_ERROR_FILE_CORRUPTED;
+    }
+
+    if (!aInfo->mData.WriteBytes(uncompressedBuffer, uncompressed.Length())) {
+      return NS_ERROR_OUT_OF_MEMORY;
+    }
   }
 
   if (!aFileIds.IsVoid()) {
@@ -26420,13 +26489,22 @@ ObjectStoreAddOrPutRequestOp::DoDatabaseWork(DatabaseConnection* aConnection)
       return rv;
     }
   } else {
+    // Small clones usually live in a single segment, in which case they can be
+    // compressed in place rather than flattened into a copy first.
     nsCString flatCloneData;
-    flatCloneData.SetLength(cloneDataSize);
+    const char* uncompressed;
     auto iter = cloneData.Iter();
-    cloneData.ReadBytes(iter, flatCloneData.BeginWriting(), cloneDataSize);
+    if (!iter.Done() && iter.HasRoomFor(cloneDataSize)) {
+      uncompressed = iter.Data();
+    } else {
+      if (NS_WARN_IF(!flatCloneData.SetLength(cloneDataSize, fallible))) {
+        return NS_ERROR_OUT_OF_MEMORY;
+      }
+      cloneData.ReadBytes(iter, flatCloneData.BeginWriting(), cloneDataSize);
+      uncompressed = flatCloneData.BeginReading();
+    }
 
     // Compress the bytes before adding into the database.
-    const char* uncompressed = flatCloneData.BeginReading();
     size_t uncompressedLength = cloneDataSize;
 
     size_t compressedLength = snappy::MaxCompressedLength(uncompressedLength);
@@ -27842,7 +27920,8 @@ CursorOpBase::PopulateResponseFromStatement(
     bool aInitializeResponse)
 {
   Transaction()->AssertIsOnConnectionThread();
-  MOZ_ASSERT(mResponse.type() == CursorResponse::T__None);
+  MOZ_ASSERT_IF(aInitializeResponse,
+                mResponse.type() == CursorResponse::T__None);
   MOZ_ASSERT_IF(mFiles.IsEmpty(), aInitializeResponse);
 
   nsresult rv = mCursor->mKey.SetFromStatement(aStmt, 0);
@@ -28924,7 +29003,7 @@ ContinueOp::DoDatabaseWork(DatabaseConnection* aConnection)
 
   MOZ_ASSERT(advanceCount > 0);
   nsAutoCString countString;
-  countString.AppendInt(advanceCount);
+  countString.AppendInt(uint64_t(advanceCount) + mPrefetchCount);
 
   nsCString query = continueQuery + countString;
 
@@ -29005,6 +29084,32 @@ ContinueOp::DoDatabaseWork(DatabaseConnection* aConnection)
     return rv;
   }
 
+  // Send the records that follow along too, so that the child can serve the
+  // next continue() calls without a round trip. This leaves our key on the
+  // last record sent; the child tells us where it really is when it next
+  // asks for more.
+  size_t prefetchedSize = 0;
+  for (uint32_t index = 0;
+       index < mPrefetchCount && prefetchedSize < kMaxCursorPrefetchSize;
+       index++) {
+    rv = stmt->ExecuteStep(&hasResult);
+    if (NS_WARN_IF(NS_FAILED(rv))) {
+      return rv;
+    }
+
+    if (!hasResult) {
+      break;
+    }
+
+    rv = PopulateResponseFromStatement(stmt, false);
+    if (NS_WARN_IF(NS_FAILED(rv))) {
+      return rv;
+    }
+
+    prefetchedSize += mResponse.get_ArrayOfObjectStoreCursorResponse()
+                        .LastElement().cloneInfo().data().data.Size();
+  }
+
   return NS_OK;
 }
 
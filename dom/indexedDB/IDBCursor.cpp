@@ -73,6 +73,12 @@ IDBCursor::IsLocaleAware() const
 }
 #endif
 
+Key
+IDBCursor::PositionKey() const
+{
+  return mType == Type_ObjectStore ? mKey : Key();
+}
+
 IDBCursor::~IDBCursor()
 {
   AssertIsOnOwningThread();
@@ -507,7 +513,7 @@ IDBCursor::Continue(JSContext* aCx,
                  IDB_LOG_STRINGIFY(key));
   }
 
-  mBackgroundActor->SendContinueInternal(ContinueParams(key));
+  mBackgroundActor->SendContinueInternal(ContinueParams(key), PositionKey());
 
   mContinueCalled = true;
 }
@@ -617,7 +623,8 @@ IDBCursor::ContinuePrimaryKey(JSContext* aCx,
                IDB_LOG_STRINGIFY(key),
                IDB_LOG_STRINGIFY(primaryKey));
 
-  mBackgroundActor->SendContinueInternal(ContinuePrimaryKeyParams(key, primaryKey));
+  mBackgroundActor->SendContinueInternal(ContinuePrimaryKeyParams(key, primaryKey),
+                                         PositionKey());
 
   mContinueCalled = true;
 }
@@ -675,7 +682,7 @@ IDBCursor::Advance(uint32_t aCount, ErrorResult &aRv)
                  aCount);
   }
 
-  mBackgroundActor->SendContinueInternal(AdvanceParams(aCount));
+  mBackgroundActor->SendContinueInternal(AdvanceParams(aCount), PositionKey());
 
   mContinueCalled = true;
 }
@@ -216,6 +216,12 @@ private:
 
   bool
   IsSourceDeleted() const;
+
+  // The key the parent resumes an object store cursor from, which may be
+  // behind its own position if it prefetched records for us. Unset for the
+  // other cursor types.
+  Key
+  PositionKey() const;
 };
 
 } // namespace dom
@@ -81,6 +81,7 @@ IDBTransaction::IDBTransaction(IDBDatabase* aDatabase,
   , mNextIndexId(0)
   , mAbortCode(NS_OK)
   , mPendingRequestCount(0)
+  , mWriteRequestCount(0)
   , mLineNo(0)
   , mColumn(0)
   , mReadyState(IDBTransaction::INITIAL)
@@ -317,6 +318,18 @@ IDBTransaction::StartRequest(IDBRequest* aRequest, const RequestParams& aParams)
   MOZ_ASSERT(actor->GetActorEventTarget(),
     "The event target shall be inherited from its manager actor.");
 
+  switch (aParams.type()) {
+    case RequestParams::TObjectStoreAddParams:
+    case RequestParams::TObjectStorePutParams:
+    case RequestParams::TObjectStoreDeleteParams:
+    case RequestParams::TObjectStoreClearParams:
+      ++mWriteRequestCount;
+      break;
+
+    default:
+      break;
+  }
+
   // Balanced in BackgroundRequestChild::Recv__delete__().
   OnNewRequest();
 
@@ -99,6 +99,10 @@ private:
   nsresult mAbortCode;
   uint32_t mPendingRequestCount;
 
+  // Bumped for every request that may change records, so that cursors can
+  // tell whether the records prefetched for them may be stale.
+  uint64_t mWriteRequestCount;
+
   nsString mFilename;
   uint32_t mLineNo;
   uint32_t mColumn;
@@ -276,6 +280,22 @@ public:
     return mLoggingSerialNumber;
   }
 
+  bool
+  HasPendingRequests() const
+  {
+    AssertIsOnOwningThread();
+
+    return mPendingRequestCount;
+  }
+
+  uint64_t
+  WriteRequestCount() const
+  {
+    AssertIsOnOwningThread();
+
+    return mWriteRequestCount;
+  }
+
   nsPIDOMWindowInner*
   GetParentObject() const;
 
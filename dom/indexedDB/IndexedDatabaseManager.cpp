@@ -142,6 +142,10 @@ const int32_t kDefaultDataThresholdBytes = 1024 * 1024; // 1MB
 // The maximal size of a serialized object to be transfered through IPC.
 const int32_t kDefaultMaxSerializedMsgSize = IPC::Channel::kMaximumMessageSize;
 
+// How many records an object store cursor asks to have sent along with the
+// one continue() requested.
+const int32_t kDefaultCursorPrefetchCount = 10;
+
 #define IDB_PREF_BRANCH_ROOT "dom.indexedDB."
 
 const char kTestingPref[] = IDB_PREF_BRANCH_ROOT "testing";
@@ -149,6 +153,7 @@ const char kPrefExperimental[] = IDB_PREF_BRANCH_ROOT "experimental";
 const char kPrefFileHandle[] = "dom.fileHandle.enabled";
 const char kDataThresholdPref[] = IDB_PREF_BRANCH_ROOT "dataThreshold";
 const char kPrefMaxSerilizedMsgSize[] = IDB_PREF_BRANCH_ROOT "maxSerializedMsgSize";
+const char kPrefCursorPrefetchCount[] = IDB_PREF_BRANCH_ROOT "cursorPrefetchCount";
 
 #define IDB_PREF_LOGGING_BRANCH_ROOT IDB_PREF_BRANCH_ROOT "logging."
 
@@ -172,6 +177,7 @@ Atomic<bool> gExperimentalFeaturesEnabled(false);
 Atomic<bool> gFileHandleEnabled(false);
 Atomic<int32_t> gDataThresholdBytes(0);
 Atomic<int32_t> gMaxSerializedMsgSize(0);
+Atomic<int32_t> gCursorPrefetchCount(0);
 
 class DeleteFilesRunnable final
   : public nsIRunnable
@@ -287,6 +293,18 @@ MaxSerializedMsgSizePrefChangeCallback(const char* aPrefName, void* aClosure)
   MOZ_ASSERT(gMaxSerializedMsgSize > 0);
 }
 
+void
+CursorPrefetchCountPrefChangedCallback(const char* aPrefName, void* aClosure)
+{
+  MOZ_ASSERT(NS_IsMainThread());
+  MOZ_ASSERT(!strcmp(aPrefName, kPrefCursorPrefetchCount));
+  MOZ_ASSERT(!aClosure);
+
+  int32_t prefetchCount =
+    Preferences::GetInt(aPrefName, kDefaultCursorPrefetchCount);
+  gCursorPrefetchCount = prefetchCount > 0 ? prefetchCount : 0;
+}
+
 } // namespace
 
 IndexedDatabaseManager::IndexedDatabaseManager()
@@ -430,6 +448,9 @@ IndexedDatabaseManager::Init()
   Preferences::RegisterCallbackAndCall(MaxSerializedMsgSizePrefChangeCallback,
                                        kPrefMaxSerilizedMsgSize);
 
+  Preferences::RegisterCallbackAndCall(CursorPrefetchCountPrefChangedCallback,
+                                       kPrefCursorPrefetchCount);
+
 #ifdef ENABLE_INTL_API
   nsAutoCString acceptLang;
   Preferences::GetLocalizedCString("intl.accept_languages", acceptLang);
@@ -496,6 +517,9 @@ IndexedDatabaseManager::Destroy()
   Preferences::UnregisterCallback(MaxSerializedMsgSizePrefChangeCallback,
                                   kPrefMaxSerilizedMsgSize);
 
+  Preferences::UnregisterCallback(CursorPrefetchCountPrefChangedCallback,
+                                  kPrefCursorPrefetchCount);
+
   delete this;
 }
 
@@ -818,6 +842,16 @@ IndexedDatabaseManager::MaxSerializedMsgSize()
   return gMaxSerializedMsgSize;
 }
 
+// static
+uint32_t
+IndexedDatabaseManager::CursorPrefetchCount()
+{
+  MOZ_ASSERT(gDBManager,
+             "CursorPrefetchCount() called before indexedDB has been initialized!");
+
+  return gCursorPrefetchCount;
+}
+
 void
 IndexedDatabaseManager::ClearBackgroundActor()
 {
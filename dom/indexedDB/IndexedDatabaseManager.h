@@ -140,6 +140,9 @@ public:
   static uint32_t
   MaxSerializedMsgSize();
 
+  static uint32_t
+  CursorPrefetchCount();
+
   void
   ClearBackgroundActor();
 
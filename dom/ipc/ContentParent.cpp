@@ -764,6 +764,7 @@ ContentParent::GetNewOrUsedBrowserProcess(const nsAString& aRemoteType,
                                           ProcessPriority aPriority,
                                           ContentParent* aOpener)
 {
+  TimeStamp requestTS = TimeStamp::Now();
   nsTArray<ContentParent*>& contentParents = GetOrCreatePool(aRemoteType);
   uint32_t maxContentParents = GetMaxProcessCount(aRemoteType);
 
@@ -816,6 +817,8 @@ ContentParent::GetNewOrUsedBrowserProcess(const nsAString& aRemoteType,
       p->mOpener = aOpener;
       contentParents.AppendElement(p);
       p->mActivateTS = TimeStamp::Now();
+      p->mRequestTS = requestTS;
+      p->mWasPreallocated = true;
       return p.forget();
     }
   }
@@ -834,6 +837,9 @@ ContentParent::GetNewOrUsedBrowserProcess(const nsAString& aRemoteType,
 
   contentParents.AppendElement(p);
   p->mActivateTS = TimeStamp::Now();
+  if (aRemoteType.EqualsLiteral(DEFAULT_REMOTE_TYPE)) {
+    p->mRequestTS = requestTS;
+  }
   return p.forget();
 }
 
@@ -1810,6 +1816,21 @@ ContentParent::TryToRecycle()
   return true;
 }
 
+void
+ContentParent::NotifyTabPresented()
+{
+  if (mRequestTS.IsNull()) {
+    return;
+  }
+
+  Telemetry::Accumulate(Telemetry::CONTENT_PROCESS_FIRST_PAINT_MS,
+                        mWasPreallocated ? NS_LITERAL_CSTRING("preallocated")
+                                         : NS_LITERAL_CSTRING("launched"),
+                        static_cast<uint32_t>((TimeStamp::Now() - mRequestTS)
+                                              .ToMilliseconds()));
+  mRequestTS = TimeStamp();
+}
+
 bool
 ContentParent::ShouldKeepProcessAlive() const
 {
@@ -2082,6 +2103,7 @@ ContentParent::ContentParent(ContentParent* aOpener,
   , mCreatedPairedMinidumps(false)
   , mShutdownPending(false)
   , mIPCOpen(true)
+  , mWasPreallocated(false)
   , mHangMonitorActor(nullptr)
 {
   // Insert ourselves into the global linked list of ContentParent objects.
@@ -331,6 +331,12 @@ public:
   void NotifyTabDestroyed(const TabId& aTabId,
                           bool aNotifiedDestroying);
 
+  /**
+   * Notify that one of our tabs presented its layers for the first time.
+   * Records how long the first tab handed this process took to paint.
+   */
+  void NotifyTabPresented();
+
   TestShellParent* CreateTestShell();
 
   bool DestroyTestShell(TestShellParent* aTestShell);
@@ -1169,6 +1175,9 @@ private:
   GeckoChildProcessHost* mSubprocess;
   const TimeStamp mLaunchTS; // used to calculate time to start content process
   TimeStamp mActivateTS;
+  // When GetNewOrUsedBrowserProcess handed this process to its first tab,
+  // null once that tab has painted.
+  TimeStamp mRequestTS;
   ContentParent* mOpener;
 
   nsString mRemoteType;
@@ -1210,6 +1219,8 @@ private:
   bool mCreatedPairedMinidumps;
   bool mShutdownPending;
   bool mIPCOpen;
+  // True if we were taken from the PreallocatedProcessManager.
+  bool mWasPreallocated;
 
   RefPtr<nsConsoleService>  mConsoleService;
   nsConsoleService* GetConsoleService();
@@ -13,12 +13,22 @@
 #include "nsIPropertyBag2.h"
 #include "ProcessPriorityManager.h"
 #include "nsServiceManagerUtils.h"
+#include "prsystem.h"
+
+#include <algorithm>
 
 // This number is fairly arbitrary ... the intention is to put off
 // launching another app process until the last one has finished
 // loading its content, to reduce CPU/memory/IO contention.
 #define DEFAULT_ALLOCATE_DELAY 1000
 
+// The number of spare processes we keep, overridden by
+// dom.ipc.processPrelaunch.count. We keep fewer on machines with less than
+// dom.ipc.processPrelaunch.memoryPerProcessMB of physical memory for each of
+// them, but always at least one.
+#define DEFAULT_PROCESS_COUNT 2
+#define DEFAULT_MEMORY_PER_PROCESS_MB 2048
+
 using namespace mozilla;
 using namespace mozilla::hal;
 using namespace mozilla::dom;
@@ -61,13 +71,20 @@ private:
   void RereadPrefs();
   void Enable();
   void Disable();
-  void CloseProcess();
+  void CloseProcesses(uint32_t aKeep);
+
+  // How many spare processes we can keep without going over
+  // dom.ipc.processCount, counting the processes in use.
+  uint32_t NumProcessesAllowed();
 
   void ObserveProcessShutdown(nsISupports* aSubject);
 
   bool mEnabled;
   bool mShutdown;
-  RefPtr<ContentParent> mPreallocatedProcess;
+  uint32_t mMaxProcesses;
+  // The oldest process, which is the most likely to have finished starting
+  // up, is the first one.
+  nsTArray<RefPtr<ContentParent>> mPreallocatedProcesses;
   nsTHashtable<nsUint64HashKey> mBlockers;
 };
 
@@ -92,12 +109,14 @@ NS_IMPL_ISUPPORTS(PreallocatedProcessManagerImpl, nsIObserver)
 PreallocatedProcessManagerImpl::PreallocatedProcessManagerImpl()
   : mEnabled(false)
   , mShutdown(false)
+  , mMaxProcesses(1)
 {}
 
 void
 PreallocatedProcessManagerImpl::Init()
 {
   Preferences::AddStrongObserver(this, "dom.ipc.processPrelaunch.enabled");
+  Preferences::AddStrongObserver(this, "dom.ipc.processPrelaunch.count");
   // We have to respect processCount at all time. This is especially important
   // for testing.
   Preferences::AddStrongObserver(this, "dom.ipc.processCount");
@@ -126,6 +145,7 @@ PreallocatedProcessManagerImpl::Observe(nsISupports* aSubject,
   } else if (!strcmp(NS_XPCOM_SHUTDOWN_OBSERVER_ID, aTopic) ||
              !strcmp("profile-change-teardown", aTopic)) {
     Preferences::RemoveObserver(this, "dom.ipc.processPrelaunch.enabled");
+    Preferences::RemoveObserver(this, "dom.ipc.processPrelaunch.count");
     Preferences::RemoveObserver(this, "dom.ipc.processCount");
     nsCOMPtr<nsIObserverService> os = services::GetObserverService();
     if (os) {
@@ -134,7 +154,7 @@ PreallocatedProcessManagerImpl::Observe(nsISupports* aSubject,
       os->RemoveObserver(this, "profile-change-teardown");
     }
     // Let's prevent any new preallocated processes from starting. ContentParent will
-    // handle the shutdown of the existing process and the mPreallocatedProcess reference
+    // handle the shutdown of the existing processes and the mPreallocatedProcesses references
     // will be cleared by the ClearOnShutdown of the manager singleton.
     mShutdown = true;
   } else {
@@ -147,44 +167,73 @@ PreallocatedProcessManagerImpl::Observe(nsISupports* aSubject,
 void
 PreallocatedProcessManagerImpl::RereadPrefs()
 {
+  mMaxProcesses = Preferences::GetUint("dom.ipc.processPrelaunch.count",
+                                       DEFAULT_PROCESS_COUNT);
+
+  uint64_t memoryMB = PR_GetPhysicalMemorySize() / (1024 * 1024);
+  uint32_t memoryPerProcessMB =
+    Preferences::GetUint("dom.ipc.processPrelaunch.memoryPerProcessMB",
+                         DEFAULT_MEMORY_PER_PROCESS_MB);
+  // PR_GetPhysicalMemorySize returns 0 if it can't tell.
+  if (memoryMB && memoryPerProcessMB) {
+    mMaxProcesses = std::min<uint64_t>(mMaxProcesses,
+                                       std::max<uint64_t>(memoryMB / memoryPerProcessMB, 1));
+  }
+
   if (mozilla::BrowserTabsRemoteAutostart() &&
-      Preferences::GetBool("dom.ipc.processPrelaunch.enabled")) {
+      Preferences::GetBool("dom.ipc.processPrelaunch.enabled") &&
+      mMaxProcesses > 0) {
     Enable();
   } else {
     Disable();
   }
 
-  if (ContentParent::IsMaxProcessCountReached(NS_LITERAL_STRING(DEFAULT_REMOTE_TYPE))) {
-    CloseProcess();
-  }
+  CloseProcesses(NumProcessesAllowed());
+}
+
+uint32_t
+PreallocatedProcessManagerImpl::NumProcessesAllowed()
+{
+  NS_NAMED_LITERAL_STRING(remoteType, DEFAULT_REMOTE_TYPE);
+  uint32_t used = ContentParent::GetPoolSize(remoteType);
+  uint32_t max = ContentParent::GetMaxProcessCount(remoteType);
+  return used < max ? std::min(mMaxProcesses, max - used) : 0;
 }
 
 already_AddRefed<ContentParent>
 PreallocatedProcessManagerImpl::Take()
 {
-  if (!mEnabled || mShutdown) {
+  if (!mEnabled || mShutdown || mPreallocatedProcesses.IsEmpty()) {
     return nullptr;
   }
 
-  if (mPreallocatedProcess) {
-    // The preallocated process is taken. Let's try to start up a new one soon.
-    AllocateOnIdle();
-  }
+  RefPtr<ContentParent> process = mPreallocatedProcesses[0].forget();
+  mPreallocatedProcesses.RemoveElementAt(0);
 
-  return mPreallocatedProcess.forget();
+  // A preallocated process is taken. Let's try to start up a new one soon.
+  AllocateOnIdle();
+
+  return process.forget();
 }
 
 bool
 PreallocatedProcessManagerImpl::Provide(ContentParent* aParent)
 {
-  if (mEnabled && !mShutdown && !mPreallocatedProcess) {
-    mPreallocatedProcess = aParent;
-  }
-
   // We might get a call from both NotifyTabDestroying and NotifyTabDestroyed with the same
   // ContentParent. Returning true here for both calls is important to avoid the cached process
   // to be destroyed.
-  return aParent == mPreallocatedProcess;
+  if (mPreallocatedProcesses.Contains(aParent)) {
+    return true;
+  }
+
+  // The process being recycled is still counted by GetPoolSize, so don't
+  // check NumProcessesAllowed here; it no longer is once we have it.
+  if (mEnabled && !mShutdown && mPreallocatedProcesses.Length() < mMaxProcesses) {
+    mPreallocatedProcesses.AppendElement(aParent);
+    return true;
+  }
+
+  return false;
 }
 
 void
@@ -212,7 +261,7 @@ PreallocatedProcessManagerImpl::RemoveBlocker(ContentParent* aParent)
   uint64_t childID = aParent->ChildID();
   MOZ_ASSERT(mBlockers.Contains(childID));
   mBlockers.RemoveEntry(childID);
-  if (!mPreallocatedProcess && mBlockers.IsEmpty()) {
+  if (mBlockers.IsEmpty() && mPreallocatedProcesses.Length() < mMaxProcesses) {
     AllocateAfterDelay();
   }
 }
@@ -222,9 +271,8 @@ PreallocatedProcessManagerImpl::CanAllocate()
 {
   return mEnabled &&
          mBlockers.IsEmpty() &&
-         !mPreallocatedProcess &&
          !mShutdown &&
-         !ContentParent::IsMaxProcessCountReached(NS_LITERAL_STRING(DEFAULT_REMOTE_TYPE));
+         mPreallocatedProcesses.Length() < NumProcessesAllowed();
 }
 
 void
@@ -259,14 +307,20 @@ void
 PreallocatedProcessManagerImpl::AllocateNow()
 {
   if (!CanAllocate()) {
-    if (mEnabled && !mShutdown && !mPreallocatedProcess && !mBlockers.IsEmpty()) {
+    if (mEnabled && !mShutdown && mPreallocatedProcesses.Length() < mMaxProcesses &&
+        !mBlockers.IsEmpty()) {
       // If it's too early to allocate a process let's retry later.
       AllocateAfterDelay();
     }
     return;
   }
 
-  mPreallocatedProcess = ContentParent::PreallocateProcess();
+  // The new process blocks further allocations until it has started up, so
+  // the pool is refilled one process at a time, from RemoveBlocker.
+  RefPtr<ContentParent> process = ContentParent::PreallocateProcess();
+  if (process) {
+    mPreallocatedProcesses.AppendElement(process.forget());
+  }
 }
 
 void
@@ -277,15 +331,18 @@ PreallocatedProcessManagerImpl::Disable()
   }
 
   mEnabled = false;
-  CloseProcess();
+  CloseProcesses(0);
 }
 
 void
-PreallocatedProcessManagerImpl::CloseProcess()
+PreallocatedProcessManagerImpl::CloseProcesses(uint32_t aKeep)
 {
-  if (mPreallocatedProcess) {
-    mPreallocatedProcess->ShutDownProcess(ContentParent::SEND_SHUTDOWN_MESSAGE);
-    mPreallocatedProcess = nullptr;
+  // Close the newest processes first, since they're the least likely to have
+  // finished starting up.
+  while (mPreallocatedProcesses.Length() > aKeep) {
+    RefPtr<ContentParent> process = mPreallocatedProcesses.LastElement().forget();
+    mPreallocatedProcesses.RemoveElementAt(mPreallocatedProcesses.Length() - 1);
+    process->ShutDownProcess(ContentParent::SEND_SHUTDOWN_MESSAGE);
   }
 }
 
@@ -299,8 +356,11 @@ PreallocatedProcessManagerImpl::ObserveProcessShutdown(nsISupports* aSubject)
   props->GetPropertyAsUint64(NS_LITERAL_STRING("childID"), &childID);
   NS_ENSURE_TRUE_VOID(childID != CONTENT_PROCESS_ID_UNKNOWN);
 
-  if (mPreallocatedProcess && childID == mPreallocatedProcess->ChildID()) {
-    mPreallocatedProcess = nullptr;
+  for (uint32_t i = 0; i < mPreallocatedProcesses.Length(); i++) {
+    if (mPreallocatedProcesses[i]->ChildID() == childID) {
+      mPreallocatedProcesses.RemoveElementAt(i);
+      break;
+    }
   }
 
   mBlockers.RemoveEntry(childID);
@@ -16,14 +16,18 @@ class ContentParent;
 } // namespace dom
 
 /**
- * This class manages a ContentParent that it starts up ahead of any particular
- * need.  You can then call Take() to get this process and use it.  Since we
- * already started it up, it should be ready for use faster than if you'd
- * created the process when you needed it.
+ * This class manages a small pool of ContentParents that it starts up ahead of
+ * any particular need.  You can then call Take() to get one of these processes
+ * and use it.  Since we already started it up, it should be ready for use
+ * faster than if you'd created the process when you needed it.
+ *
+ * The pool holds up to dom.ipc.processPrelaunch.count processes, fewer on
+ * machines with little memory, and never more than dom.ipc.processCount
+ * allows.  It's refilled one process at a time, when the browser is idle.
  *
  * This class watches the dom.ipc.processPrelaunch.enabled pref.  If it changes
- * from false to true, it preallocates a process.  If it changes from true to
- * false, it kills the preallocated process, if any.
+ * from false to true, it preallocates processes.  If it changes from true to
+ * false, it kills the preallocated processes, if any.
  *
  * We don't expect this pref to flip between true and false in production, but
  * flipping the pref is important for tests.
@@ -43,15 +47,11 @@ public:
   static void RemoveBlocker(ContentParent* aParent);
 
   /**
-   * Take the preallocated process, if we have one.  If we don't have one, this
-   * returns null.
-   *
-   * If you call Take() twice in a row, the second call is guaranteed to return
-   * null.
+   * Take the oldest preallocated process, if we have one.  If we don't have
+   * one, this returns null.
    *
-   * After you Take() the preallocated process, you need to call one of the
-   * Allocate* functions (or change the dom.ipc.processPrelaunch pref from
-   * false to true) before we'll create a new process.
+   * After you Take() a preallocated process, a new one is started once the
+   * browser is idle.
    */
   static already_AddRefed<ContentParent> Take();
 
@@ -54,8 +54,10 @@ public:
   static already_AddRefed<SharedJSAllocatedData>
   CreateFromExternalData(const char* aData, size_t aDataLength)
   {
-    JSStructuredCloneData buf;
-    buf.WriteBytes(aData, aDataLength);
+    JSStructuredCloneData buf = AllocateBuffer(aDataLength);
+    if (NS_WARN_IF(!buf.WriteBytes(aData, aDataLength))) {
+      return nullptr;
+    }
     RefPtr<SharedJSAllocatedData> sharedData =
       new SharedJSAllocatedData(Move(buf));
     return sharedData.forget();
@@ -64,10 +66,13 @@ public:
   static already_AddRefed<SharedJSAllocatedData>
   CreateFromExternalData(const JSStructuredCloneData& aData)
   {
-    JSStructuredCloneData buf;
+    JSStructuredCloneData buf = AllocateBuffer(aData.Size());
     auto iter = aData.Iter();
     while (!iter.Done()) {
-      buf.WriteBytes(iter.Data(), iter.RemainingInSegment());
+      if (NS_WARN_IF(!buf.WriteBytes(iter.Data(),
+                                     iter.RemainingInSegment()))) {
+        return nullptr;
+      }
       iter.Advance(aData, iter.RemainingInSegment());
     }
     RefPtr<SharedJSAllocatedData> sharedData =
@@ -83,6 +88,20 @@ public:
 private:
   ~SharedJSAllocatedData() { }
 
+  // Copies are written into a single segment of the right size when it can be
+  // allocated, instead of a chain of 4k ones (which remain the fallback).
+  static JSStructuredCloneData
+  AllocateBuffer(size_t aDataLength)
+  {
+    const size_t kAlignment = JSStructuredCloneData::kSegmentAlignment;
+    const size_t kStandardCapacity = 4096;
+    size_t capacity = (aDataLength + kAlignment - 1) & ~(kAlignment - 1);
+    if (!capacity || capacity < aDataLength) {
+      return JSStructuredCloneData();
+    }
+    return JSStructuredCloneData(0, capacity, kStandardCapacity);
+  }
+
   JSStructuredCloneData mData;
 };
 
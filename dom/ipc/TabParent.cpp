@@ -2903,6 +2903,9 @@ TabParent::LayerTreeUpdate(uint64_t aEpoch, bool aActive)
 
   RefPtr<Event> event = NS_NewDOMEvent(mFrameElement, nullptr, nullptr);
   if (aActive) {
+    if (!mHasPresented && Manager()->IsContentParent()) {
+      Manager()->AsContentParent()->NotifyTabPresented();
+    }
     mHasPresented = true;
     event->InitEvent(NS_LITERAL_STRING("MozLayerTreeReady"), true, false);
   } else {
@@ -330,6 +330,45 @@ nsresult FileBlockCache::WriteBlockToFile(int32_t aBlockIndex,
   return NS_OK;
 }
 
+nsresult FileBlockCache::WriteBlocksToFile(
+  int32_t aFirstBlockIndex,
+  const nsTArray<RefPtr<BlockChange>>& aChanges)
+{
+  LOG("WriteBlocksToFile(index=%u, count=%zu)",
+      aFirstBlockIndex, aChanges.Length());
+
+  mFileMutex.AssertCurrentThreadOwns();
+  MOZ_ASSERT(mFD);
+  MOZ_ASSERT(!aChanges.IsEmpty() &&
+             aChanges.Length() <= PR_MAX_IOVECTOR_SIZE);
+
+  if (aChanges.Length() == 1) {
+    return WriteBlockToFile(aFirstBlockIndex, aChanges[0]->mData.get());
+  }
+
+  nsresult rv = Seek(BlockIndexToOffset(aFirstBlockIndex));
+  if (NS_FAILED(rv)) return rv;
+
+  PRIOVec iov[PR_MAX_IOVECTOR_SIZE];
+  for (size_t i = 0; i < aChanges.Length(); ++i) {
+    MOZ_ASSERT(aChanges[i]->IsWrite());
+    iov[i].iov_base = reinterpret_cast<char*>(aChanges[i]->mData.get());
+    iov[i].iov_len = BLOCK_SIZE;
+  }
+  int32_t length = int32_t(aChanges.Length()) * BLOCK_SIZE;
+  int32_t amount = PR_Writev(mFD, iov, int32_t(aChanges.Length()),
+                             PR_INTERVAL_NO_TIMEOUT);
+  if (amount < length) {
+    NS_WARNING("Failed to write media cache blocks!");
+    // We don't know where a short write left the file pointer.
+    mFDCurrentPos = -1;
+    return NS_ERROR_FAILURE;
+  }
+  mFDCurrentPos += length;
+
+  return NS_OK;
+}
+
 nsresult FileBlockCache::MoveBlockInFile(int32_t aSourceBlockIndex,
                                          int32_t aDestBlockIndex)
 {
@@ -386,6 +425,26 @@ FileBlockCache::PerformBlockIOs()
     MOZ_ASSERT(change,
                "Change index list should only contain entries for blocks "
                "with changes");
+
+    // Media is mostly downloaded sequentially, so the next changes are
+    // often writes to the following blocks. Gather those in a run written
+    // with a single system call, rather than seeking and writing each block
+    // on its own.
+    AutoTArray<RefPtr<BlockChange>, PR_MAX_IOVECTOR_SIZE> run;
+    if (change->IsWrite()) {
+      run.AppendElement(change);
+      for (auto it = mChangeIndexList.begin() + 1;
+           it != mChangeIndexList.end() &&
+           run.Length() < PR_MAX_IOVECTOR_SIZE &&
+           *it == blockIndex + int32_t(run.Length());
+           ++it) {
+        BlockChange* next = mBlockChanges[*it];
+        if (!next->IsWrite()) {
+          break;
+        }
+        run.AppendElement(next);
+      }
+    }
     {
       MutexAutoUnlock unlock(mDataMutex);
       MutexAutoLock lock(mFileMutex);
@@ -395,17 +454,27 @@ FileBlockCache::PerformBlockIOs()
         return;
       }
       if (change->IsWrite()) {
-        WriteBlockToFile(blockIndex, change->mData.get());
+        WriteBlocksToFile(blockIndex, run);
       } else if (change->IsMove()) {
         MoveBlockInFile(change->mSourceBlockIndex, blockIndex);
       }
     }
-    mChangeIndexList.pop_front();
-    // If a new change has not been made to the block while we dropped
-    // mDataMutex, clear reference to the old change. Otherwise, the old
-    // reference has been cleared already.
-    if (mBlockChanges[blockIndex] == change) {
-      mBlockChanges[blockIndex] = nullptr;
+    if (run.IsEmpty()) {
+      run.AppendElement(Move(change));
+    }
+    for (size_t i = 0; i < run.Length(); ++i) {
+      int32_t index = blockIndex + int32_t(i);
+      if (mChangeIndexList.empty() || mChangeIndexList.front() != index) {
+        // The pending changes were discarded by Init() meanwhile.
+        break;
+      }
+      mChangeIndexList.pop_front();
+      // If a new change has not been made to the block while we dropped
+      // mDataMutex, clear reference to the old change. Otherwise, the old
+      // reference has been cleared already.
+      if (mBlockChanges[index] == run[i]) {
+        mBlockChanges[index] = nullptr;
+      }
     }
   }
 
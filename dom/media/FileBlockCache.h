@@ -163,6 +163,10 @@ private:
                         int32_t aBytesToRead,
                         int32_t& aBytesRead);
   nsresult WriteBlockToFile(int32_t aBlockIndex, const uint8_t* aBlockData);
+  // Writes the data of consecutive block write changes, the first one being
+  // for aFirstBlockIndex, with a single seek and vectored write.
+  nsresult WriteBlocksToFile(int32_t aFirstBlockIndex,
+                             const nsTArray<RefPtr<BlockChange>>& aChanges);
   // File descriptor we're writing to. This is created externally, but
   // shutdown by us.
   PRFileDesc* mFD;
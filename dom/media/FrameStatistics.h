@@ -38,6 +38,10 @@ struct FrameStatisticsData
   // Maximum inter-keyframe segment duration, in microseconds.
   uint64_t mInterKeyFrameMax_us = 0;
 
+  // Number of decoded frames whose image buffer had to be allocated, rather
+  // than recycled from a previously displayed frame.
+  uint64_t mAllocatedFrameBuffers = 0;
+
   FrameStatisticsData() = default;
   FrameStatisticsData(uint64_t aParsed, uint64_t aDecoded, uint64_t aDropped)
     : mParsedFrames(aParsed)
@@ -54,6 +58,7 @@ struct FrameStatisticsData
     mDroppedFrames += aStats.mDroppedFrames;
     mInterKeyframeSum_us += aStats.mInterKeyframeSum_us;
     mInterKeyframeCount += aStats.mInterKeyframeCount;
+    mAllocatedFrameBuffers += aStats.mAllocatedFrameBuffers;
     // It doesn't make sense to add max numbers, instead keep the bigger one.
     if (mInterKeyFrameMax_us < aStats.mInterKeyFrameMax_us) {
       mInterKeyFrameMax_us = aStats.mInterKeyFrameMax_us;
@@ -113,6 +118,15 @@ public:
     return mFrameStatisticsData.mDroppedFrames;
   }
 
+  // Returns the number of frame buffers which have been allocated rather than
+  // recycled. Sampled over time, this gives the allocation rate of playback.
+  // Can be called on any thread.
+  uint64_t GetAllocatedFrameBuffers() const
+  {
+    ReentrantMonitorAutoEnter mon(mReentrantMonitor);
+    return mFrameStatisticsData.mAllocatedFrameBuffers;
+  }
+
   // Increments the parsed and decoded frame counters by the passed in counts.
   // Can be called on any thread.
   void NotifyDecodedFrames(const FrameStatisticsData& aStats)
@@ -7,6 +7,7 @@
 #include "mozilla/dom/AudioContext.h"
 #include "mozilla/SharedThreadPool.h"
 #include "mozilla/ClearOnShutdown.h"
+#include "mozilla/Telemetry.h"
 #include "mozilla/Unused.h"
 #include "CubebUtils.h"
 
@@ -563,6 +564,8 @@ AudioCallbackDriver::AudioCallbackDriver(MediaStreamGraphImpl* aGraphImpl)
   , mSampleRate(0)
   , mInputChannels(1)
   , mIterationDurationMS(MEDIA_GRAPH_TARGET_PERIOD_MS)
+  , mLoad(0.0)
+  , mPeakLoad(0.0)
   , mStarted(false)
   , mAudioInput(nullptr)
   , mAddedMixer(false)
@@ -576,6 +579,10 @@ AudioCallbackDriver::AudioCallbackDriver(MediaStreamGraphImpl* aGraphImpl)
 AudioCallbackDriver::~AudioCallbackDriver()
 {
   MOZ_ASSERT(mPromisesForOperation.IsEmpty());
+  if (mPeakLoad > 0.0) {
+    Telemetry::Accumulate(Telemetry::MEDIA_GRAPH_AUDIO_CALLBACK_PEAK_LOAD,
+                          uint32_t(std::min(mPeakLoad, 2.0) * 100));
+  }
 }
 
 bool IsMacbookOrMacbookAir()
@@ -929,6 +936,7 @@ AudioCallbackDriver::DataCallback(const AudioDataValue* aInputBuffer,
     mGraphImpl->SwapMessageQueues();
   }
 
+  TimeStamp callbackStart = TimeStamp::Now();
   uint32_t durationMS = aFrames * 1000 / mSampleRate;
 
   // For now, simply average the duration with the previous
@@ -1012,6 +1020,16 @@ AudioCallbackDriver::DataCallback(const AudioDataValue* aInputBuffer,
   mGraphImpl->NotifyOutputData(aOutputBuffer, static_cast<size_t>(aFrames),
                                mSampleRate, ChannelCount);
 
+  double load =
+    (TimeStamp::Now() - callbackStart).ToSeconds() * mSampleRate / aFrames;
+  if (load > 1.0) {
+    LOG(LogLevel::Warning,
+        ("MediaStreamGraph %p callback took %.0f%% of its budget",
+         mGraphImpl, load * 100));
+  }
+  mLoad = mLoad == 0.0 ? load : (mLoad * 3 + load) / 4;
+  mPeakLoad = std::max(mPeakLoad, mLoad);
+
   bool switching = false;
   {
     MonitorAutoLock mon(mGraphImpl->GetMonitor());
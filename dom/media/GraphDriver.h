@@ -495,6 +495,13 @@ private:
    * video frames. This is in milliseconds. Only even used (after
    * inizatialization) on the audio callback thread. */
   uint32_t mIterationDurationMS;
+  /* How long the callbacks take to run compared to the duration of audio they
+   * produce, averaged like mIterationDurationMS. Above 1.0, this graph cannot
+   * keep up and will underrun. mPeakLoad is the highest mLoad seen, reported
+   * to telemetry when the driver goes away. Only used on the audio callback
+   * thread, and in the destructor. */
+  double mLoad;
+  double mPeakLoad;
   /* cubeb_stream_init calls the audio callback to prefill the buffers. The
    * previous driver has to be kept alive until the audio stream has been
    * started, because it is responsible to call cubeb_stream_start, so we delay
@@ -1102,6 +1102,7 @@ MediaFormatReader::MediaFormatReader(MediaFormatReaderInit& aInit,
   , mDemuxerInitDone(false)
   , mPendingNotifyDataArrived(false)
   , mLastReportedNumDecodedFrames(0)
+  , mLastReportedFrameBufferAllocations(0)
   , mPreviousDecodedKeyframeTime_us(sNoPreviousDecodedKeyframe)
   , mKnowsCompositor(aInit.mKnowsCompositor)
   , mInitDone(false)
@@ -2195,6 +2196,15 @@ MediaFormatReader::Update(TrackType aTrack)
           decoder.mNumSamplesOutputTotal - mLastReportedNumDecodedFrames;
         a.mStats.mDecodedFrames = static_cast<uint32_t>(delta);
         mLastReportedNumDecodedFrames = decoder.mNumSamplesOutputTotal;
+        if (layers::ImageContainer* container = GetImageContainer()) {
+          uint32_t allocations = container->GetFrameBufferAllocationCount();
+          // The count goes down if the container's ImageClient is recreated.
+          if (allocations > mLastReportedFrameBufferAllocations) {
+            a.mStats.mAllocatedFrameBuffers =
+              allocations - mLastReportedFrameBufferAllocations;
+          }
+          mLastReportedFrameBufferAllocations = allocations;
+        }
         if (output->mKeyframe) {
           if (mPreviousDecodedKeyframeTime_us < output->mTime.ToMicroseconds()) {
             // There is a previous keyframe -> Record inter-keyframe stats.
@@ -665,6 +665,10 @@ private:
   // delta there.
   uint64_t mLastReportedNumDecodedFrames;
 
+  // The image container's frame buffer allocation count when decoded frames
+  // were last reported; the delta is reported along with them.
+  uint32_t mLastReportedFrameBufferAllocations;
+
   // Timestamp of the previous decoded keyframe, in microseconds.
   int64_t mPreviousDecodedKeyframeTime_us;
   // Default mLastDecodedKeyframeTime_us value, must be bigger than anything.
@@ -16,6 +16,9 @@
 #include "AlignmentUtils.h"
 #include "AudioNodeEngineSSE2.h"
 #endif
+#ifdef USE_AVX
+#include "AudioNodeEngineAVX.h"
+#endif
 #include "AudioBlock.h"
 
 namespace mozilla {
@@ -101,7 +104,15 @@ void AudioBufferAddWithScale(const float* aInput,
     // we need to round aSize down to the nearest multiple of 16
     uint32_t alignedSize = aSize & ~0x0F;
     if (alignedSize > 0) {
+#ifdef USE_AVX
+      if (mozilla::supports_avx()) {
+        AudioBufferAddWithScale_AVX(aInput, aScale, aOutput, alignedSize);
+      } else {
+        AudioBufferAddWithScale_SSE(aInput, aScale, aOutput, alignedSize);
+      }
+#else
       AudioBufferAddWithScale_SSE(aInput, aScale, aOutput, alignedSize);
+#endif
 
       // adjust parameters for use with scalar operations below
       aInput += alignedSize;
@@ -145,6 +156,13 @@ AudioBlockCopyChannelWithScale(const float* aInput,
     }
 #endif
 
+#ifdef USE_AVX
+    if (mozilla::supports_avx()) {
+      AudioBlockCopyChannelWithScale_AVX(aInput, aScale, aOutput);
+      return;
+    }
+#endif
+
 #ifdef USE_SSE2
     if (mozilla::supports_sse2()) {
       AudioBlockCopyChannelWithScale_SSE(aInput, aScale, aOutput);
@@ -209,6 +227,13 @@ AudioBlockCopyChannelWithScale(const float aInput[WEBAUDIO_BLOCK_SIZE],
   }
 #endif
 
+#ifdef USE_AVX
+  if (mozilla::supports_avx()) {
+    AudioBlockCopyChannelWithScale_AVX(aInput, aScale, aOutput);
+    return;
+  }
+#endif
+
 #ifdef USE_SSE2
   if (mozilla::supports_sse2()) {
     AudioBlockCopyChannelWithScale_SSE(aInput, aScale, aOutput);
@@ -243,6 +268,13 @@ AudioBufferInPlaceScale(float* aBlock,
   }
 #endif
 
+#ifdef USE_AVX
+  if (mozilla::supports_avx()) {
+    AudioBufferInPlaceScale_AVX(aBlock, aScale, aSize);
+    return;
+  }
+#endif
+
 #ifdef USE_SSE2
   if (mozilla::supports_sse2()) {
     AudioBufferInPlaceScale_SSE(aBlock, aScale, aSize);
@@ -292,6 +324,15 @@ AudioBlockPanStereoToStereo(const float aInputL[WEBAUDIO_BLOCK_SIZE],
   }
 #endif
 
+#ifdef USE_AVX
+  if (mozilla::supports_avx()) {
+    AudioBlockPanStereoToStereo_AVX(aInputL, aInputR,
+                                    aGainL, aGainR, aIsOnTheLeft,
+                                    aOutputL, aOutputR);
+    return;
+  }
+#endif
+
 #ifdef USE_SSE2
   if (mozilla::supports_sse2()) {
     AudioBlockPanStereoToStereo_SSE(aInputL, aInputR,
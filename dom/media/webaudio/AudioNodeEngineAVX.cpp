@@ -0,0 +1,189 @@
+/* -*- mode: c++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* this source code form is subject to the terms of the mozilla public
+ * license, v. 2.0. if a copy of the mpl was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "AudioNodeEngineAVX.h"
+#include "AlignmentUtils.h"
+#include <immintrin.h>
+
+// Audio buffers are only guaranteed to be 16 byte aligned, so these use
+// unaligned loads and stores, which cost nothing extra on aligned data.
+// Multiplies and adds are kept separate rather than fused so that the
+// results are bit for bit the same as the SSE and scalar versions.
+
+namespace mozilla {
+void
+AudioBufferAddWithScale_AVX(const float* aInput,
+                            float aScale,
+                            float* aOutput,
+                            uint32_t aSize)
+{
+  __m256 vin0, vin1,
+         vscaled0, vscaled1,
+         vout0, vout1,
+         vgain;
+
+  ASSERT_ALIGNED16(aInput);
+  ASSERT_ALIGNED16(aOutput);
+  ASSERT_MULTIPLE16(aSize);
+
+  vgain = _mm256_set1_ps(aScale);
+
+  for (unsigned i = 0; i < aSize; i+=16) {
+    vin0 = _mm256_loadu_ps(&aInput[i]);
+    vin1 = _mm256_loadu_ps(&aInput[i + 8]);
+
+    vscaled0 = _mm256_mul_ps(vin0, vgain);
+    vscaled1 = _mm256_mul_ps(vin1, vgain);
+
+    vin0 = _mm256_loadu_ps(&aOutput[i]);
+    vin1 = _mm256_loadu_ps(&aOutput[i + 8]);
+
+    vout0 = _mm256_add_ps(vin0, vscaled0);
+    vout1 = _mm256_add_ps(vin1, vscaled1);
+
+    _mm256_storeu_ps(&aOutput[i], vout0);
+    _mm256_storeu_ps(&aOutput[i + 8], vout1);
+  }
+}
+
+void
+AudioBlockCopyChannelWithScale_AVX(const float* aInput,
+                                   float aScale,
+                                   float* aOutput)
+{
+  __m256 vin0, vin1,
+         vout0, vout1;
+
+  ASSERT_ALIGNED16(aInput);
+  ASSERT_ALIGNED16(aOutput);
+
+  __m256 vgain = _mm256_set1_ps(aScale);
+
+  for (unsigned i = 0 ; i < WEBAUDIO_BLOCK_SIZE; i+=16) {
+    vin0 = _mm256_loadu_ps(&aInput[i]);
+    vin1 = _mm256_loadu_ps(&aInput[i + 8]);
+    vout0 = _mm256_mul_ps(vin0, vgain);
+    vout1 = _mm256_mul_ps(vin1, vgain);
+    _mm256_storeu_ps(&aOutput[i], vout0);
+    _mm256_storeu_ps(&aOutput[i + 8], vout1);
+  }
+}
+
+void
+AudioBlockCopyChannelWithScale_AVX(const float aInput[WEBAUDIO_BLOCK_SIZE],
+                                   const float aScale[WEBAUDIO_BLOCK_SIZE],
+                                   float aOutput[WEBAUDIO_BLOCK_SIZE])
+{
+  __m256 vin0, vin1,
+         vscaled0, vscaled1,
+         vout0, vout1;
+
+  ASSERT_ALIGNED16(aInput);
+  ASSERT_ALIGNED16(aScale);
+  ASSERT_ALIGNED16(aOutput);
+
+  for (unsigned i = 0 ; i < WEBAUDIO_BLOCK_SIZE; i+=16) {
+    vscaled0 = _mm256_loadu_ps(&aScale[i]);
+    vscaled1 = _mm256_loadu_ps(&aScale[i + 8]);
+
+    vin0 = _mm256_loadu_ps(&aInput[i]);
+    vin1 = _mm256_loadu_ps(&aInput[i + 8]);
+
+    vout0 = _mm256_mul_ps(vin0, vscaled0);
+    vout1 = _mm256_mul_ps(vin1, vscaled1);
+
+    _mm256_storeu_ps(&aOutput[i], vout0);
+    _mm256_storeu_ps(&aOutput[i + 8], vout1);
+  }
+}
+
+void
+AudioBufferInPlaceScale_AVX(float* aBlock,
+                            float aScale,
+                            uint32_t aSize)
+{
+  __m256 vout0, vout1,
+         vin0, vin1;
+
+  ASSERT_ALIGNED16(aBlock);
+  ASSERT_MULTIPLE16(aSize);
+
+  __m256 vgain = _mm256_set1_ps(aScale);
+
+  for (unsigned i = 0; i < aSize; i+=16) {
+    vin0 = _mm256_loadu_ps(&aBlock[i]);
+    vin1 = _mm256_loadu_ps(&aBlock[i + 8]);
+    vout0 = _mm256_mul_ps(vin0, vgain);
+    vout1 = _mm256_mul_ps(vin1, vgain);
+    _mm256_storeu_ps(&aBlock[i], vout0);
+    _mm256_storeu_ps(&aBlock[i + 8], vout1);
+  }
+}
+
+void
+AudioBlockPanStereoToStereo_AVX(const float aInputL[WEBAUDIO_BLOCK_SIZE],
+                                const float aInputR[WEBAUDIO_BLOCK_SIZE],
+                                float aGainL, float aGainR, bool aIsOnTheLeft,
+                                float aOutputL[WEBAUDIO_BLOCK_SIZE],
+                                float aOutputR[WEBAUDIO_BLOCK_SIZE])
+{
+  __m256 vinl0, vinr0, vinl1, vinr1,
+         vout0, vout1,
+         vscaled0, vscaled1,
+         vgainl, vgainr;
+
+  ASSERT_ALIGNED16(aInputL);
+  ASSERT_ALIGNED16(aInputR);
+  ASSERT_ALIGNED16(aOutputL);
+  ASSERT_ALIGNED16(aOutputR);
+
+  vgainl = _mm256_set1_ps(aGainL);
+  vgainr = _mm256_set1_ps(aGainR);
+
+  if (aIsOnTheLeft) {
+    for (unsigned i = 0; i < WEBAUDIO_BLOCK_SIZE; i+=16) {
+      vinl0 = _mm256_loadu_ps(&aInputL[i]);
+      vinr0 = _mm256_loadu_ps(&aInputR[i]);
+      vinl1 = _mm256_loadu_ps(&aInputL[i+8]);
+      vinr1 = _mm256_loadu_ps(&aInputR[i+8]);
+
+      /* left channel : aOutputL  = aInputL + aInputR * gainL */
+      vscaled0 = _mm256_mul_ps(vinr0, vgainl);
+      vscaled1 = _mm256_mul_ps(vinr1, vgainl);
+      vout0 = _mm256_add_ps(vscaled0, vinl0);
+      vout1 = _mm256_add_ps(vscaled1, vinl1);
+      _mm256_storeu_ps(&aOutputL[i], vout0);
+      _mm256_storeu_ps(&aOutputL[i+8], vout1);
+
+      /* right channel : aOutputR = aInputR * gainR */
+      vscaled0 = _mm256_mul_ps(vinr0, vgainr);
+      vscaled1 = _mm256_mul_ps(vinr1, vgainr);
+      _mm256_storeu_ps(&aOutputR[i], vscaled0);
+      _mm256_storeu_ps(&aOutputR[i+8], vscaled1);
+    }
+  } else {
+    for (unsigned i = 0; i < WEBAUDIO_BLOCK_SIZE; i+=16) {
+      vinl0 = _mm256_loadu_ps(&aInputL[i]);
+      vinr0 = _mm256_loadu_ps(&aInputR[i]);
+      vinl1 = _mm256_loadu_ps(&aInputL[i+8]);
+      vinr1 = _mm256_loadu_ps(&aInputR[i+8]);
+
+      /* left channel : aInputL * gainL */
+      vscaled0 = _mm256_mul_ps(vinl0, vgainl);
+      vscaled1 = _mm256_mul_ps(vinl1, vgainl);
+      _mm256_storeu_ps(&aOutputL[i], vscaled0);
+      _mm256_storeu_ps(&aOutputL[i+8], vscaled1);
+
+      /* right channel: aOutputR = aInputR + aInputL * gainR */
+      vscaled0 = _mm256_mul_ps(vinl0, vgainr);
+      vscaled1 = _mm256_mul_ps(vinl1, vgainr);
+      vout0 = _mm256_add_ps(vscaled0, vinr0);
+      vout1 = _mm256_add_ps(vscaled1, vinr1);
+      _mm256_storeu_ps(&aOutputR[i], vout0);
+      _mm256_storeu_ps(&aOutputR[i+8], vout1);
+    }
+  }
+}
+}
@@ -11,6 +11,7 @@
 #include "nsContentUtils.h"
 
 #include "mozilla/Telemetry.h"
+#include "mozilla/Unused.h"
 
 namespace mozilla {
 namespace dom {
@@ -291,6 +292,16 @@ ScriptLoadHandler::EnsureKnownDataType(nsIIncrementalStreamLoader* aLoader)
     if (altDataType.Equals(nsContentUtils::JSBytecodeMimeType())) {
       mRequest->mDataType = ScriptLoadRequest::DataType::Bytecode;
       TRACE_FOR_TEST(mRequest->mElement, "scriptloader_load_bytecode");
+
+      // The channel knows the size of the alternate data, so allocate the
+      // bytecode buffer once instead of regrowing (and copying) it as the
+      // chunks come in.  Failing here is fine, appending will try again.
+      nsCOMPtr<nsIChannel> channel = do_QueryInterface(req);
+      int64_t length = -1;
+      if (channel && NS_SUCCEEDED(channel->GetContentLength(&length)) &&
+          length > 0 && length <= INT32_MAX) {
+        Unused << mRequest->mScriptBytecode.reserve(length);
+      }
     } else {
       MOZ_ASSERT(altDataType.IsEmpty());
       mRequest->mDataType = ScriptLoadRequest::DataType::Source;
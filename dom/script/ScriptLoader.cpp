@@ -1543,6 +1543,14 @@ ScriptLoader::ProcessOffThreadRequest(ScriptLoadRequest* aRequest)
     return NS_OK;
   }
 
+  if (aRequest->mIsDefer) {
+    // Deferred scripts are compiled as soon as they are loaded, but must
+    // still run in order once parsing is done.
+    ProcessPendingRequests();
+    mDocument->UnblockOnload(false);
+    return NS_OK;
+  }
+
   nsresult rv = ProcessRequest(aRequest);
   mDocument->UnblockOnload(false);
   return rv;
@@ -2867,8 +2875,11 @@ ScriptLoader::PrepareLoadedRequest(ScriptLoadRequest* aRequest,
   // The script is now loaded and ready to run.
   aRequest->SetReady();
 
-  // If this is currently blocking the parser, attempt to compile it off-main-thread.
-  if (aRequest == mParserBlockingRequest && NumberOfProcessors() > 1) {
+  // If this is currently blocking the parser, or is deferred and would
+  // otherwise only be compiled when its turn to run comes, attempt to compile
+  // it off-main-thread.
+  if ((aRequest == mParserBlockingRequest || aRequest->mIsDefer) &&
+      NumberOfProcessors() > 1) {
     MOZ_ASSERT(!aRequest->IsModuleRequest());
     nsresult rv = AttemptAsyncScriptCompile(aRequest);
     if (rv == NS_OK) {
@@ -317,15 +317,21 @@ StorageDBChild::RecvOriginsHavingData(nsTArray<nsCString>&& aOrigins)
 }
 
 mozilla::ipc::IPCResult
-StorageDBChild::RecvLoadItem(const nsCString& aOriginSuffix,
-                             const nsCString& aOriginNoSuffix,
-                             const nsString& aKey,
-                             const nsString& aValue)
+StorageDBChild::RecvLoadItems(const nsCString& aOriginSuffix,
+                              const nsCString& aOriginNoSuffix,
+                              nsTArray<nsString>&& aKeys,
+                              nsTArray<nsString>&& aValues)
 {
+  if (NS_WARN_IF(aKeys.Length() != aValues.Length())) {
+    return IPC_FAIL_NO_REASON(this);
+  }
+
   LocalStorageCache* aCache =
     mManager->GetCache(aOriginSuffix, aOriginNoSuffix);
   if (aCache) {
-    aCache->LoadItem(aKey, aValue);
+    for (uint32_t i = 0; i < aKeys.Length(); ++i) {
+      aCache->LoadItem(aKeys[i], aValues[i]);
+    }
   }
 
   return IPC_OK();
@@ -890,12 +896,15 @@ StorageDBParent::Observe(const nsCString& aTopic,
 
 namespace {
 
+// The most preloaded items sent to a child in one message.
+const uint32_t kLoadItemsBatchSize = 256;
+
 // Results must be sent back on the main thread
 class LoadRunnable : public Runnable
 {
 public:
   enum TaskType {
-    loadItem,
+    loadItems,
     loadDone
   };
 
@@ -903,15 +912,15 @@ public:
                TaskType aType,
                const nsACString& aOriginSuffix,
                const nsACString& aOriginNoSuffix,
-               const nsAString& aKey = EmptyString(),
-               const nsAString& aValue = EmptyString())
+               nsTArray<nsString>&& aKeys,
+               nsTArray<nsString>&& aValues)
     : Runnable("dom::LoadRunnable")
     , mParent(aParent)
     , mType(aType)
     , mSuffix(aOriginSuffix)
     , mOrigin(aOriginNoSuffix)
-    , mKey(aKey)
-    , mValue(aValue)
+    , mKeys(Move(aKeys))
+    , mValues(Move(aValues))
   { }
 
   LoadRunnable(StorageDBParent* aParent,
@@ -931,8 +940,8 @@ private:
   RefPtr<StorageDBParent> mParent;
   TaskType mType;
   nsCString mSuffix, mOrigin;
-  nsString mKey;
-  nsString mValue;
+  nsTArray<nsString> mKeys;
+  nsTArray<nsString> mValues;
   nsresult mRv;
 
   NS_IMETHOD Run() override
@@ -943,8 +952,9 @@ private:
 
     switch (mType)
     {
-    case loadItem:
-      mozilla::Unused << mParent->SendLoadItem(mSuffix, mOrigin, mKey, mValue);
+    case loadItems:
+      mozilla::Unused << mParent->SendLoadItems(mSuffix, mOrigin, mKeys,
+                                                mValues);
       break;
     case loadDone:
       mozilla::Unused << mParent->SendLoadDone(mSuffix, mOrigin, mRv);
@@ -977,14 +987,30 @@ StorageDBParent::CacheParentBridge::LoadItem(const nsAString& aKey,
 
   ++mLoadedCount;
 
+  mPendingKeys.AppendElement(aKey);
+  mPendingValues.AppendElement(aValue);
+  if (mPendingKeys.Length() >= kLoadItemsBatchSize) {
+    FlushLoadedItems();
+  }
+
+  return true;
+}
+
+void
+StorageDBParent::CacheParentBridge::FlushLoadedItems()
+{
+  if (mPendingKeys.IsEmpty()) {
+    return;
+  }
+
   RefPtr<LoadRunnable> r =
-    new LoadRunnable(mParent, LoadRunnable::loadItem, mOriginSuffix,
-                     mOriginNoSuffix, aKey, aValue);
+    new LoadRunnable(mParent, LoadRunnable::loadItems, mOriginSuffix,
+                     mOriginNoSuffix, Move(mPendingKeys), Move(mPendingValues));
+  mPendingKeys.Clear();
+  mPendingValues.Clear();
 
   MOZ_ALWAYS_SUCCEEDS(
     mOwningEventTarget->Dispatch(r, NS_DISPATCH_NORMAL));
-
-  return true;
 }
 
 void
@@ -997,6 +1023,8 @@ StorageDBParent::CacheParentBridge::LoadDone(nsresult aRv)
 
   mLoaded = true;
 
+  FlushLoadedItems();
+
   RefPtr<LoadRunnable> r =
     new LoadRunnable(mParent, LoadRunnable::loadDone, mOriginSuffix,
                      mOriginNoSuffix, aRv);
@@ -96,10 +96,10 @@ private:
   mozilla::ipc::IPCResult RecvObserve(const nsCString& aTopic,
                                       const nsString& aOriginAttributesPattern,
                                       const nsCString& aOriginScope);
-  mozilla::ipc::IPCResult RecvLoadItem(const nsCString& aOriginSuffix,
-                                       const nsCString& aOriginNoSuffix,
-                                       const nsString& aKey,
-                                       const nsString& aValue);
+  mozilla::ipc::IPCResult RecvLoadItems(const nsCString& aOriginSuffix,
+                                        const nsCString& aOriginNoSuffix,
+                                        nsTArray<nsString>&& aKeys,
+                                        nsTArray<nsString>&& aValues);
   mozilla::ipc::IPCResult RecvLoadDone(const nsCString& aOriginSuffix,
                                        const nsCString& aOriginNoSuffix,
                                        const nsresult& aRv);
@@ -188,11 +188,20 @@ public:
     void
     Destroy();
 
+    // Sends the items loaded since the last call to the child.
+    void
+    FlushLoadedItems();
+
     nsCOMPtr<nsISerialEventTarget> mOwningEventTarget;
     RefPtr<StorageDBParent> mParent;
     nsCString mOriginSuffix, mOriginNoSuffix;
     bool mLoaded;
     uint32_t mLoadedCount;
+
+    // Loaded items not sent yet, so that a preload takes a message per batch
+    // of items rather than per item.
+    nsTArray<nsString> mPendingKeys;
+    nsTArray<nsString> mPendingValues;
   };
 
   // Fake usage class receiving async callbacks from DB thread
@@ -1915,12 +1915,17 @@ RuntimeService::ScheduleWorker(WorkerPrivate* aWorkerPrivate)
 
   const WorkerThreadFriendKey friendKey;
 
+  Telemetry::Accumulate(Telemetry::WORKER_THREAD_REUSED, !!thread);
+
   if (!thread) {
+    TimeStamp creationStart = TimeStamp::Now();
     thread = WorkerThread::Create(friendKey);
     if (!thread) {
       UnregisterWorker(aWorkerPrivate);
       return false;
     }
+    Telemetry::AccumulateTimeDelta(Telemetry::WORKER_THREAD_CREATION_MS,
+                                   creationStart);
   }
 
   int32_t priority = aWorkerPrivate->IsChromeWorker() ?
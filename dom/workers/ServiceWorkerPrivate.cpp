@@ -1905,6 +1905,7 @@ ServiceWorkerPrivate::TerminateWorker()
   AssertIsOnMainThread();
 
   mIdleWorkerTimer->Cancel();
+  mIdleDeadline = TimeStamp();
   mIdleKeepAliveToken = nullptr;
   if (mWorkerPrivate) {
     if (Preferences::GetBool("dom.serviceWorkers.testing.enabled")) {
@@ -1989,6 +1990,7 @@ ServiceWorkerPrivate::AttachDebugger()
     NS_ENSURE_SUCCESS(rv, rv);
 
     mIdleWorkerTimer->Cancel();
+    mIdleDeadline = TimeStamp();
   }
 
   ++mDebuggerCount;
@@ -2077,6 +2079,15 @@ ServiceWorkerPrivate::NoteIdleWorkerCallback(nsITimer* aTimer)
 
   MOZ_ASSERT(aTimer == mIdleWorkerTimer, "Invalid timer!");
 
+  // Events since the timer was armed may have extended the grace period.
+  TimeStamp now = TimeStamp::Now();
+  if (!mIdleDeadline.IsNull() && mIdleDeadline > now) {
+    // Round up, so that the timer does not fire again just short of it.
+    ArmIdleTimer(uint32_t((mIdleDeadline - now).ToMilliseconds()) + 1);
+    return;
+  }
+  mIdleDeadline = TimeStamp();
+
   // Release ServiceWorkerPrivate's token, since the grace period has ended.
   mIdleKeepAliveToken = nullptr;
 
@@ -2133,10 +2144,22 @@ void
 ServiceWorkerPrivate::ResetIdleTimeout()
 {
   uint32_t timeout = Preferences::GetInt("dom.serviceWorkers.idle_timeout");
+  bool timerArmed = !mIdleDeadline.IsNull();
+  mIdleDeadline = TimeStamp::Now() + TimeDuration::FromMilliseconds(timeout);
+
+  // The pending callback re-arms itself until the new deadline.
+  if (!timerArmed) {
+    ArmIdleTimer(timeout);
+  }
+}
+
+void
+ServiceWorkerPrivate::ArmIdleTimer(uint32_t aTimeout)
+{
   nsCOMPtr<nsITimerCallback> cb = new ServiceWorkerPrivateTimerCallback(
     this, &ServiceWorkerPrivate::NoteIdleWorkerCallback);
   DebugOnly<nsresult> rv =
-    mIdleWorkerTimer->InitWithCallback(cb, timeout, nsITimer::TYPE_ONE_SHOT);
+    mIdleWorkerTimer->InitWithCallback(cb, aTimeout, nsITimer::TYPE_ONE_SHOT);
   MOZ_ASSERT(NS_SUCCEEDED(rv));
 }
 
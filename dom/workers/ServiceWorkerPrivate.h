@@ -187,6 +187,9 @@ private:
   void
   ResetIdleTimeout();
 
+  void
+  ArmIdleTimer(uint32_t aTimeout);
+
   void
   AddToken();
 
@@ -218,6 +221,12 @@ private:
 
   nsCOMPtr<nsITimer> mIdleWorkerTimer;
 
+  // When mIdleWorkerTimer is armed for NoteIdleWorkerCallback, the time the
+  // grace period actually ends.  Events only push this forward, and the
+  // callback re-arms the timer for whatever is left, so that a burst of fetch
+  // events does not reschedule the timer once per event.
+  TimeStamp mIdleDeadline;
+
   // We keep a token for |dom.serviceWorkers.idle_timeout| seconds to give the
   // worker a grace period after each event.
   RefPtr<KeepAliveToken> mIdleKeepAliveToken;
@@ -193,9 +193,10 @@ struct DrawSurfaceOptions {
 /**
  * This class is used to store gradient stops, it can only be used with a
  * matching DrawTarget. Not adhering to this condition will make a draw call
- * fail.
+ * fail. Recorded draw commands may hold on to them, and release them, on the
+ * thread they are replayed on.
  */
-class GradientStops : public RefCounted<GradientStops>
+class GradientStops : public external::AtomicRefCounted<GradientStops>
 {
 public:
   MOZ_DECLARE_REFCOUNTED_VIRTUAL_TYPENAME(GradientStops)
@@ -600,9 +601,10 @@ class PathBuilder;
 class FlattenedPath;
 
 /** The path class is used to create (sets of) figures of any shape that can be
- * filled or stroked to a DrawTarget
+ * filled or stroked to a DrawTarget. Like GradientStops, paths can be released
+ * by the thread a DrawTargetCapture is replayed on.
  */
-class Path : public RefCounted<Path>
+class Path : public external::AtomicRefCounted<Path>
 {
 public:
   MOZ_DECLARE_REFCOUNTED_VIRTUAL_TYPENAME(Path)
@@ -864,9 +866,9 @@ public:
  * parameters to the glyph drawing functions. This is an empty wrapper class
  * merely used to allow holding on to and passing around platform specific
  * parameters. This is because different platforms have unique rendering
- * parameters.
+ * parameters. Recorded FillGlyphs commands share them with the main thread.
  */
-class GlyphRenderingOptions : public RefCounted<GlyphRenderingOptions>
+class GlyphRenderingOptions : public external::AtomicRefCounted<GlyphRenderingOptions>
 {
 public:
   MOZ_DECLARE_REFCOUNTED_VIRTUAL_TYPENAME(GlyphRenderingOptions)
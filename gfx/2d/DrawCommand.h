@@ -200,6 +200,46 @@ private:
   DrawOptions mOptions;
 };
 
+class DrawSurfaceWithShadowCommand : public DrawingCommand
+{
+public:
+  DrawSurfaceWithShadowCommand(SourceSurface* aSurface,
+                               const Point& aDest,
+                               const Color& aColor,
+                               const Point& aOffset,
+                               Float aSigma,
+                               CompositionOp aOperator)
+    : DrawingCommand(CommandType::DRAWSURFACEWITHSHADOW)
+    , mSurface(aSurface)
+    , mDest(aDest)
+    , mColor(aColor)
+    , mOffset(aOffset)
+    , mSigma(aSigma)
+    , mOperator(aOperator)
+  {
+  }
+
+  virtual void ExecuteOnDT(DrawTarget* aDT, const Matrix* aTransform) const
+  {
+    // Like CopySurface, this draws in device space.
+    MOZ_ASSERT(!aTransform || !aTransform->HasNonIntegerTranslation());
+    Point dest = mDest;
+    if (aTransform) {
+      dest = aTransform->TransformPoint(dest);
+    }
+    aDT->DrawSurfaceWithShadow(mSurface, dest, mColor, mOffset, mSigma,
+                               mOperator);
+  }
+
+private:
+  RefPtr<SourceSurface> mSurface;
+  Point mDest;
+  Color mColor;
+  Point mOffset;
+  Float mSigma;
+  CompositionOp mOperator;
+};
+
 class ClearRectCommand : public DrawingCommand
 {
 public:
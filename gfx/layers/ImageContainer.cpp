@@ -61,6 +61,7 @@ BufferRecycleBin::BufferRecycleBin()
   // initialized in RecycleBuffer, but initializing it here avoids static analysis
   // noise.
   , mRecycledBufferSize(0)
+  , mAllocationCount(0)
 {
 }
 
@@ -81,8 +82,10 @@ BufferRecycleBin::GetBuffer(uint32_t aSize)
 {
   MutexAutoLock lock(mLock);
 
-  if (mRecycledBuffers.IsEmpty() || mRecycledBufferSize != aSize)
+  if (mRecycledBuffers.IsEmpty() || mRecycledBufferSize != aSize) {
+    ++mAllocationCount;
     return MakeUnique<uint8_t[]>(aSize);
+  }
 
   uint32_t last = mRecycledBuffers.Length() - 1;
   UniquePtr<uint8_t[]> result = Move(mRecycledBuffers[last]);
@@ -100,6 +103,13 @@ BufferRecycleBin::ClearRecycledBuffers()
   mRecycledBufferSize = 0;
 }
 
+uint32_t
+BufferRecycleBin::GetAllocationCount()
+{
+  MutexAutoLock lock(mLock);
+  return mAllocationCount;
+}
+
 ImageContainerListener::ImageContainerListener(ImageContainer* aImageContainer)
   : mLock("mozilla.layers.ImageContainerListener.mLock")
   , mImageContainer(aImageContainer)
@@ -214,6 +224,17 @@ ImageContainer::CreatePlanarYCbCrImage()
   return mImageFactory->CreatePlanarYCbCrImage(mScaleHint, mRecycleBin);
 }
 
+uint32_t
+ImageContainer::GetFrameBufferAllocationCount()
+{
+  RecursiveMutexAutoLock lock(mRecursiveMutex);
+  uint32_t count = mRecycleBin ? mRecycleBin->GetAllocationCount() : 0;
+  if (mImageClient && mImageClient->HasTextureClientRecycler()) {
+    count += mImageClient->GetTextureClientRecycler()->GetAllocationCount();
+  }
+  return count;
+}
+
 RefPtr<SharedRGBImage>
 ImageContainer::CreateSharedRGBImage()
 {
@@ -286,6 +286,9 @@ public:
   // Returns a recycled buffer of the right size, or allocates a new buffer.
   mozilla::UniquePtr<uint8_t[]> GetBuffer(uint32_t aSize);
   virtual void ClearRecycledBuffers();
+  // Returns how many times GetBuffer had no buffer to recycle and had to
+  // allocate a new one.
+  uint32_t GetAllocationCount();
 private:
   typedef mozilla::Mutex Mutex;
 
@@ -303,6 +306,8 @@ private:
   nsTArray<mozilla::UniquePtr<uint8_t[]>> mRecycledBuffers;
   // This is only valid if mRecycledBuffers is non-empty
   uint32_t mRecycledBufferSize;
+  // See GetAllocationCount. Accessed only with mLock held.
+  uint32_t mAllocationCount;
 };
 
 /**
@@ -599,6 +604,14 @@ public:
     return mDroppedImageCount;
   }
 
+  /**
+   * Returns how many image buffers created for this container had to be
+   * freshly allocated because there was no buffer of the right format and
+   * size to recycle, whether from the container's BufferRecycleBin or from
+   * the TextureClientRecycleAllocator of its ImageClient.
+   */
+  uint32_t GetFrameBufferAllocationCount();
+
   void NotifyComposite(const ImageCompositeNotification& aNotification);
 
   ImageContainerListener* GetImageContainerListener()
@@ -29,6 +29,7 @@
 #include "mozilla/mozalloc.h"           // for operator new
 #include "mozilla/TouchEvents.h"
 #include "mozilla/Preferences.h"        // for Preferences
+#include "mozilla/Telemetry.h"          // for Telemetry
 #include "mozilla/EventStateManager.h"  // for WheelPrefs
 #include "mozilla/webrender/WebRenderAPI.h"
 #include "nsDebug.h"                    // for NS_WARNING
@@ -2058,12 +2059,15 @@ APZCTreeManager::GetTargetAPZC(const ScreenPoint& aPoint,
                                RefPtr<HitTestingTreeNode>* aOutScrollbarNode)
 {
   MutexAutoLock lock(mTreeLock);
+  TimeStamp hitTestStart = TimeStamp::Now();
   HitTestResult hitResult = HitNothing;
   HitTestingTreeNode* scrollbarNode = nullptr;
   ParentLayerPoint point = ViewAs<ParentLayerPixel>(aPoint,
     PixelCastJustification::ScreenIsParentLayerForRoot);
   RefPtr<AsyncPanZoomController> target = GetAPZCAtPoint(mRootNode, point,
       &hitResult, &scrollbarNode);
+  mozilla::Telemetry::Accumulate(mozilla::Telemetry::APZ_HIT_TEST_US,
+      uint32_t((TimeStamp::Now() - hitTestStart).ToMicroseconds()));
 
   if (aOutHitResult) {
     *aOutHitResult = hitResult;
@@ -2201,20 +2205,22 @@ APZCTreeManager::GetAPZCAtPoint(HitTestingTreeNode* aNode,
   // APZCs front-to-back on the screen.
   HitTestingTreeNode* resultNode;
   HitTestingTreeNode* root = aNode;
-  std::stack<LayerPoint> hitTestPoints;
-  hitTestPoints.push(ViewAs<LayerPixel>(aHitTestPoint,
+  // One point per level of the tree being walked. This runs for every input
+  // event, so keep the usual depths off the heap.
+  AutoTArray<LayerPoint, 16> hitTestPoints;
+  hitTestPoints.AppendElement(ViewAs<LayerPixel>(aHitTestPoint,
       PixelCastJustification::MovingDownToChildren));
 
   ForEachNode<ReverseIterator>(root,
       [&hitTestPoints, this](HitTestingTreeNode* aNode) {
-        ParentLayerPoint hitTestPointForParent = ViewAs<ParentLayerPixel>(hitTestPoints.top(),
+        ParentLayerPoint hitTestPointForParent = ViewAs<ParentLayerPixel>(hitTestPoints.LastElement(),
             PixelCastJustification::MovingDownToChildren);
         if (aNode->IsOutsideClip(hitTestPointForParent)) {
           // If the point being tested is outside the clip region for this node
           // then we don't need to test against this node or any of its children.
           // Just skip it and move on.
           APZCTM_LOG("Point %f %f outside clip for node %p\n",
-            hitTestPoints.top().x, hitTestPoints.top().y, aNode);
+            hitTestPoints.LastElement().x, hitTestPoints.LastElement().y, aNode);
           return TraversalFlag::Skip;
         }
         // First check the subtree rooted at this node, because deeper nodes
@@ -2227,14 +2233,14 @@ APZCTreeManager::GetAPZCAtPoint(HitTestingTreeNode* aNode,
         if (!hitTestPoint) {
           return TraversalFlag::Skip;
         }
-        hitTestPoints.push(hitTestPoint.ref());
+        hitTestPoints.AppendElement(hitTestPoint.ref());
         return TraversalFlag::Continue;
       },
       [&resultNode, &hitTestPoints, &aOutHitResult](HitTestingTreeNode* aNode) {
-        HitTestResult hitResult = aNode->HitTest(hitTestPoints.top());
-        hitTestPoints.pop();
+        HitTestResult hitResult = aNode->HitTest(hitTestPoints.LastElement());
+        hitTestPoints.RemoveElementAt(hitTestPoints.Length() - 1);
         APZCTM_LOG("Testing Layer point %s against node %p\n",
-                Stringify(hitTestPoints.top()).c_str(), aNode);
+                Stringify(hitTestPoints.LastElement()).c_str(), aNode);
         if (hitResult != HitTestResult::HitNothing) {
           resultNode = aNode;
           // If event regions are disabled, *aOutHitResult will be HitLayer
@@ -11,7 +11,11 @@
 
 #include "gfxPrefs.h"
 
+#include "mozilla/Atomics.h"
 #include "nsComponentManagerUtils.h"
+#include "nsIMemoryReporter.h"
+
+#include <algorithm>
 
 #define TCP_LOG(...)
 //#define TCP_LOG(...) printf_stderr(__VA_ARGS__);
@@ -19,6 +23,42 @@
 namespace mozilla {
 namespace layers {
 
+// The extra unused clients a pool may keep is limited to this many times its
+// configured unused size.
+static const uint32_t kMaxExtraUnusedFactor = 4;
+
+// Process wide counts of GetTextureClient calls that did and did not find an
+// unused client in their pool.
+static Atomic<size_t> sPoolHits;
+static Atomic<size_t> sPoolMisses;
+
+class TextureClientPoolReporter final : public nsIMemoryReporter
+{
+public:
+  NS_DECL_ISUPPORTS
+
+  NS_IMETHOD CollectReports(nsIHandleReportCallback* aHandleReport,
+                            nsISupports* aData,
+                            bool aAnonymize) override
+  {
+    MOZ_COLLECT_REPORT(
+      "texture-client-pool-hits", KIND_OTHER, UNITS_COUNT_CUMULATIVE,
+      sPoolHits,
+      "Tile texture clients that were reused from a texture client pool.");
+    MOZ_COLLECT_REPORT(
+      "texture-client-pool-misses", KIND_OTHER, UNITS_COUNT_CUMULATIVE,
+      sPoolMisses,
+      "Tile texture clients that were allocated because their texture client "
+      "pool was empty.");
+    return NS_OK;
+  }
+
+private:
+  ~TextureClientPoolReporter() {}
+};
+
+NS_IMPL_ISUPPORTS(TextureClientPoolReporter, nsIMemoryReporter)
+
 // We want to shrink to our maximum size of N unused tiles
 // after a timeout to allow for short-term budget requirements
 static void
@@ -56,6 +96,8 @@ TextureClientPool::TextureClientPool(LayersBackend aLayersBackend,
   , mClearTimeoutMsec(aClearTimeoutMsec)
   , mInitialPoolSize(aInitialPoolSize)
   , mPoolUnusedSize(aPoolUnusedSize)
+  , mExtraUnusedSize(0)
+  , mMissesSinceShrink(0)
   , mOutstandingClients(0)
   , mSurfaceAllocator(aAllocator)
   , mDestroyed(false)
@@ -67,6 +109,12 @@ TextureClientPool::TextureClientPool(LayersBackend aLayersBackend,
   if (aFormat == gfx::SurfaceFormat::UNKNOWN) {
     gfxWarning() << "Creating texture pool for SurfaceFormat::UNKNOWN format";
   }
+
+  static bool sReporterRegistered = false;
+  if (!sReporterRegistered) {
+    RegisterStrongMemoryReporter(new TextureClientPoolReporter());
+    sReporterRegistered = true;
+  }
 }
 
 TextureClientPool::~TextureClientPool()
@@ -118,7 +166,11 @@ TextureClientPool::GetTextureClient()
   // out of TextureClients, we allocate additional TextureClients to try and keep around
   // mPoolUnusedSize
   if (mTextureClients.empty()) {
+    sPoolMisses++;
+    mMissesSinceShrink++;
     AllocateTextureClient();
+  } else {
+    sPoolHits++;
   }
 
   if (mTextureClients.empty()) {
@@ -177,7 +229,8 @@ TextureClientPool::ResetTimers()
 {
   // Shrink down if we're beyond our maximum size
   if (mShrinkTimeoutMsec &&
-      mTextureClients.size() + mTextureClientsDeferred.size() > mPoolUnusedSize) {
+      mTextureClients.size() + mTextureClientsDeferred.size() >
+        mPoolUnusedSize + mExtraUnusedSize) {
     TCP_LOG("TexturePool %p scheduling a shrink-to-max-size\n", this);
     mShrinkTimer->InitWithNamedFuncCallback(
       ShrinkCallback,
@@ -237,6 +290,21 @@ TextureClientPool::ReturnTextureClientDeferred(TextureClient* aClient)
   ResetTimers();
 }
 
+void
+TextureClientPool::UpdateExtraUnusedSize()
+{
+  // A burst that found the pool empty would have reused as many more clients,
+  // so keep those around for the next one. Otherwise slowly give the memory
+  // back, so that an idle pool ends up at its configured size.
+  if (mMissesSinceShrink) {
+    mExtraUnusedSize = std::min(mExtraUnusedSize + mMissesSinceShrink,
+                                mPoolUnusedSize * kMaxExtraUnusedFactor);
+  } else if (mExtraUnusedSize) {
+    mExtraUnusedSize--;
+  }
+  mMissesSinceShrink = 0;
+}
+
 void
 TextureClientPool::ShrinkToMaximumSize()
 {
@@ -250,11 +318,14 @@ TextureClientPool::ShrinkToMaximumSize()
   // If we have > mInitialPoolSize outstanding, then we want to keep around
   // mPoolUnusedSize at a maximum. If we have fewer than mInitialPoolSize
   // outstanding, then keep around the entire initial pool size.
+  UpdateExtraUnusedSize();
+
   uint32_t targetUnusedClients;
   if (mOutstandingClients > mInitialPoolSize) {
-    targetUnusedClients = mPoolUnusedSize;
+    targetUnusedClients = mPoolUnusedSize + mExtraUnusedSize;
   } else {
-    targetUnusedClients = mInitialPoolSize;
+    targetUnusedClients = std::max(mInitialPoolSize,
+                                   mPoolUnusedSize + mExtraUnusedSize);
   }
 
   TCP_LOG("TexturePool %p shrinking to maximum unused size %u; current pool size %u; total outstanding %u\n",
@@ -335,12 +406,21 @@ TextureClientPool::Clear()
   }
 }
 
+void
+TextureClientPool::HandleMemoryPressure()
+{
+  mExtraUnusedSize = 0;
+  mMissesSinceShrink = 0;
+  Clear();
+}
+
 void TextureClientPool::Destroy()
 {
   Clear();
   mDestroyed = true;
   mInitialPoolSize = 0;
   mPoolUnusedSize = 0;
+  mExtraUnusedSize = 0;
 }
 
 } // namespace layers
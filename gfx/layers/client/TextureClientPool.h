@@ -102,6 +102,12 @@ public:
    */
   void Clear();
 
+  /**
+   * Clear the pool and forget how many extra clients recent allocations
+   * asked us to keep, so that only the configured sizes are kept again.
+   */
+  void HandleMemoryPressure();
+
   LayersBackend GetBackend() const { return mBackend; }
   int32_t GetMaxTextureSize() const { return mMaxTextureSize; }
   gfx::SurfaceFormat GetFormat() { return mFormat; }
@@ -121,6 +127,9 @@ private:
   /// Reset and/or initialise timers for shrinking/clearing the pool.
   void ResetTimers();
 
+  /// Grow or decay mExtraUnusedSize from the misses since the last shrink.
+  void UpdateExtraUnusedSize();
+
   /// Backend passed to the TextureClient for buffer creation.
   LayersBackend mBackend;
 
@@ -152,6 +161,16 @@ private:
   // the initial allocation
   uint32_t mPoolUnusedSize;
 
+  // How many unused texture clients to keep on top of mPoolUnusedSize,
+  // because the last bursts of allocations found the pool empty. Grows by the
+  // misses of each burst, up to a few times mPoolUnusedSize, and decays when
+  // the pool is shrunk without having missed.
+  uint32_t mExtraUnusedSize;
+
+  // How many GetTextureClient calls found the pool empty since the last
+  // ShrinkToMaximumSize.
+  uint32_t mMissesSinceShrink;
+
   /// This is a total number of clients in the wild and in the stack of
   /// deferred clients (see below).  So, the total number of clients in
   /// existence is always mOutstandingClients + the size of mTextureClients.
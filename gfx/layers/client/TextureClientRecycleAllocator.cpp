@@ -130,6 +130,7 @@ TextureClientRecycleAllocator::TextureClientRecycleAllocator(KnowsCompositor* aA
   , mMaxPooledSize(kMaxPooledSized)
   , mLock("TextureClientRecycleAllocatorImp.mLock")
   , mIsDestroyed(false)
+  , mAllocationCount(0)
 {
 }
 
@@ -171,6 +172,7 @@ TextureClientRecycleAllocator::CreateOrRecycle(ITextureClientAllocationHelper& a
   MOZ_ASSERT(aHelper.mTextureFlags & TextureFlags::RECYCLE);
 
   RefPtr<TextureClientHolder> textureHolder;
+  bool allocated = false;
 
   {
     MutexAutoLock lock(mLock);
@@ -202,10 +204,14 @@ TextureClientRecycleAllocator::CreateOrRecycle(ITextureClientAllocationHelper& a
       return nullptr;
     }
     textureHolder = new TextureClientHolder(texture);
+    allocated = true;
   }
 
   {
     MutexAutoLock lock(mLock);
+    if (allocated) {
+      ++mAllocationCount;
+    }
     MOZ_ASSERT(mInUseClients.find(textureHolder->GetTextureClient()) == mInUseClients.end());
     // Register TextureClient
     mInUseClients[textureHolder->GetTextureClient()] = textureHolder;
@@ -229,6 +235,13 @@ TextureClientRecycleAllocator::Allocate(gfx::SurfaceFormat aFormat,
                                          aSelector, aTextureFlags, aAllocFlags);
 }
 
+uint32_t
+TextureClientRecycleAllocator::GetAllocationCount()
+{
+  MutexAutoLock lock(mLock);
+  return mAllocationCount;
+}
+
 void
 TextureClientRecycleAllocator::ShrinkToMinimumSize()
 {
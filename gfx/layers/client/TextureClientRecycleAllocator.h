@@ -107,6 +107,10 @@ public:
 
   void Destroy();
 
+  // Returns how many TextureClients had to be allocated because none of the
+  // pooled ones could be recycled.
+  uint32_t GetAllocationCount();
+
 protected:
   virtual already_AddRefed<TextureClient>
   Allocate(gfx::SurfaceFormat aFormat,
@@ -129,6 +133,7 @@ protected:
   std::stack<RefPtr<TextureClientHolder> > mPooledClients;
   Mutex mLock;
   bool mIsDestroyed;
+  uint32_t mAllocationCount;
 };
 
 } // namespace layers
@@ -973,6 +973,16 @@ void ClientMultiTiledLayerBuffer::Update(const nsIntRegion& newValidRegion,
       for (size_t i = 0; i < mMoz2DTiles.size(); ++i) {
         mMoz2DTiles[i].mTileOrigin -= mTilingOrigin;
       }
+      if (mMoz2DTiles.size() > 1 && gfxPrefs::LayersTilesReplayCapture() &&
+          PaintTilesFromCapture(aPaintRegion, aDirtyRegion)) {
+        mMoz2DTiles.clear();
+        mTilingOrigin = IntPoint(std::numeric_limits<int32_t>::max(),
+                                 std::numeric_limits<int32_t>::max());
+      }
+    }
+
+    if (!mMoz2DTiles.empty()) {
+      gfx::TileSet tileset;
       tileset.mTiles = &mMoz2DTiles[0];
       tileset.mTileCount = mMoz2DTiles.size();
       RefPtr<DrawTarget> drawTarget = gfx::Factory::CreateTiledDrawTarget(tileset);
@@ -1037,6 +1047,56 @@ void ClientMultiTiledLayerBuffer::Update(const nsIntRegion& newValidRegion,
   mPaintedRegion.OrWith(aPaintRegion);
 }
 
+bool
+ClientMultiTiledLayerBuffer::PaintTilesFromCapture(const nsIntRegion& aPaintRegion,
+                                                   const nsIntRegion& aDirtyRegion)
+{
+  AUTO_PROFILER_LABEL("ClientMultiTiledLayerBuffer::PaintTilesFromCapture", GRAPHICS);
+
+  // The recording covers the same area as a DrawTargetTiled of these tiles
+  // would, so that the callback sees the same target either way.
+  DrawTarget* firstTarget = mMoz2DTiles[0].mDrawTarget;
+  IntRect bounds;
+  for (const gfx::Tile& tile : mMoz2DTiles) {
+    bounds = bounds.Union(IntRect(tile.mTileOrigin, tile.mDrawTarget->GetSize()));
+  }
+
+  RefPtr<DrawTargetCapture> captureDT =
+    Factory::CreateCaptureDrawTarget(firstTarget->GetBackendType(),
+                                     bounds.Size(),
+                                     firstTarget->GetFormat());
+  if (!captureDT) {
+    return false;
+  }
+
+  {
+    AutoProfilerTracing tracing("Paint", "CaptureTiles");
+
+    captureDT->SetTransform(Matrix());
+    captureDT->SetPermitSubpixelAA(IsOpaque(firstTarget->GetFormat()));
+
+    RefPtr<gfxContext> ctx = gfxContext::CreateOrNull(captureDT);
+    if (!ctx) {
+      return false;
+    }
+    ctx->SetMatrix(
+      ctx->CurrentMatrix().PreScale(mResolution, mResolution).PreTranslate(ThebesPoint(-mTilingOrigin)));
+
+    mCallback(&mPaintedLayer, ctx, aPaintRegion, aDirtyRegion,
+              DrawRegionClip::DRAW, nsIntRegion(), mCallbackData);
+  }
+
+  // Each tile only rasterizes its own part of the recording, one tile at a
+  // time, rather than every draw call being split across all the tiles.
+  for (const gfx::Tile& tile : mMoz2DTiles) {
+    AutoProfilerTracing tracing("Paint", "ReplayTile");
+    tile.mDrawTarget->DrawCapturedDT(captureDT,
+                                     Matrix::Translation(-tile.mTileOrigin.x,
+                                                         -tile.mTileOrigin.y));
+  }
+  return true;
+}
+
 bool
 ClientMultiTiledLayerBuffer::ValidateTile(TileClient& aTile,
                                           const nsIntPoint& aTileOrigin,
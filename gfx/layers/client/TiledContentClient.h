@@ -420,6 +420,14 @@ protected:
   TileClient GetPlaceholderTile() const { return TileClient(); }
 
 private:
+  /**
+   * Records the paint of aPaintRegion once and replays it into each of
+   * mMoz2DTiles in turn, with a tracing marker for every tile. Returns false,
+   * without painting anything, if the recording could not be created.
+   */
+  bool PaintTilesFromCapture(const nsIntRegion& aPaintRegion,
+                             const nsIntRegion& aDirtyRegion);
+
   RefPtr<ClientLayerManager> mManager;
   LayerManager::DrawPaintedLayerCallback mCallback;
   void* mCallbackData;
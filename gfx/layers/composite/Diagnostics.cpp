@@ -64,6 +64,10 @@ Diagnostics::GetFrameOverlayString(const GPUStats& aStats)
   if (aStats.mDrawTime) {
     mGPUDrawMs.Add(aStats.mDrawTime.value());
   }
+  if (aStats.mScreenPixels) {
+    mDamagePercent.Add(100.0f * float(aStats.mDamagedPixels) /
+                       float(aStats.mScreenPixels));
+  }
 
   std::string gpuTimeString;
   if (mGPUDrawMs.Empty()) {
@@ -80,7 +84,9 @@ Diagnostics::GetFrameOverlayString(const GPUStats& aStats)
   // UP  = LayerTransactionParent::RecvUpdate (IPDL deserialize, update, APZ update)
   // CC_BUILD = Container prepare/composite frame building
   // CC_EXEC  = Container render/composite drawing
-  nsPrintfCString line1("FPS: %d (TXN: %d)", fps, txnFps);
+  // Damage = part of the screen recomposited after diffing the layer tree
+  nsPrintfCString line1("FPS: %d (TXN: %d) Damage: %0.1f%%",
+    fps, txnFps, mDamagePercent.Average());
   nsPrintfCString line2("[CC] Build: %0.1fms Exec: %0.1fms GPU: %s Fill Ratio: %0.1f/%0.1f",
     mPrepareMs.Average(),
     mCompositeMs.Average(),
@@ -48,12 +48,16 @@ struct GPUStats
   GPUStats()
    : mInvalidPixels(0),
      mScreenPixels(0),
-     mPixelsFilled(0)
+     mPixelsFilled(0),
+     mDamagedPixels(0)
   {}
 
   uint32_t mInvalidPixels;
   uint32_t mScreenPixels;
   uint32_t mPixelsFilled;
+  // The area of the region the layer manager asked to be recomposited, as
+  // found by diffing the layer tree against the previous composite.
+  uint32_t mDamagedPixels;
   Maybe<float> mDrawTime;
 };
 
@@ -109,6 +113,7 @@ private:
   TimedMetric mPrepareMs;
   TimedMetric mCompositeMs;
   TimedMetric mGPUDrawMs;
+  TimedMetric mDamagePercent;
 };
 
 } // namespace layers
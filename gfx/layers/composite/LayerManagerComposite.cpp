@@ -146,6 +146,7 @@ LayerManagerComposite::LayerManagerComposite(Compositor* aCompositor)
 : mUnusedApzTransformWarning(false)
 , mDisabledApzWarning(false)
 , mCompositor(aCompositor)
+, mLastDamagedPixels(0)
 , mInTransaction(false)
 , mIsCompositorReady(false)
 #if defined(MOZ_WIDGET_ANDROID)
@@ -533,6 +534,10 @@ LayerManagerComposite::UpdateAndRender()
     return;
   }
 
+  if (!mTarget) {
+    mLastDamagedPixels = uint32_t(std::min<uint64_t>(invalid.Area(), UINT32_MAX));
+  }
+
   // We don't want our debug overlay to cause more frames to happen
   // so we will invalidate after we've decided if something changed.
   InvalidateDebugOverlay(invalid, mRenderBounds);
@@ -653,6 +658,7 @@ LayerManagerComposite::RenderDebugOverlay(const IntRect& aBounds)
 
     GPUStats stats;
     stats.mScreenPixels = mRenderBounds.width * mRenderBounds.height;
+    stats.mDamagedPixels = mLastDamagedPixels;
     mCompositor->GetFrameStats(&stats);
 
     std::string text = mDiagnostics->GetFrameOverlayString(stats);
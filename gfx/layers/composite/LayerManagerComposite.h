@@ -495,6 +495,10 @@ private:
 
   nsIntRegion mInvalidRegion;
 
+  // The area of the region the last window composite was asked to redraw,
+  // not counting the debug overlay itself.
+  uint32_t mLastDamagedPixels;
+
   typedef nsClassHashtable<nsGenericHashKey<ScrollableLayerGuid>,
                            CSSIntRegion> VisibleRegions;
   VisibleRegions mVisibleRegions;
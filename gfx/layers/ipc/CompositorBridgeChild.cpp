@@ -953,7 +953,7 @@ void
 CompositorBridgeChild::HandleMemoryPressure()
 {
   for (size_t i = 0; i < mTexturePools.Length(); i++) {
-    mTexturePools[i]->Clear();
+    mTexturePools[i]->HandleMemoryPressure();
   }
 }
 
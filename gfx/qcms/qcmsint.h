@@ -283,6 +283,15 @@ void qcms_transform_data_rgba_out_lut_altivec(qcms_transform *transform,
                                               unsigned char *dest,
                                               size_t length);
 
+void qcms_transform_data_rgb_out_lut_neon(qcms_transform *transform,
+                                          unsigned char *src,
+                                          unsigned char *dest,
+                                          size_t length);
+void qcms_transform_data_rgba_out_lut_neon(qcms_transform *transform,
+                                           unsigned char *src,
+                                           unsigned char *dest,
+                                           size_t length);
+
 extern qcms_bool qcms_supports_iccv4;
 
 #ifdef _MSC_VER
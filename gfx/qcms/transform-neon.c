@@ -0,0 +1,114 @@
+#include <arm_neon.h>
+
+#include "qcmsint.h"
+
+#define FLOATSCALE  (float)(PRECACHE_OUTPUT_SIZE)
+#define CLAMPMAXVAL ( ((float) (PRECACHE_OUTPUT_SIZE - 1)) / PRECACHE_OUTPUT_SIZE )
+
+/* Computes the output table indices of one pixel. vcvtq truncates, unlike
+ * the rounding conversion of the SSE2 path, so add a half first; the values
+ * are never negative. */
+static inline uint32x4_t
+transform_indices(float32x4_t mat0, float32x4_t mat1, float32x4_t mat2,
+                  float r, float g, float b,
+                  float32x4_t min, float32x4_t max, float32x4_t scale,
+                  float32x4_t half)
+{
+    float32x4_t vec = vmulq_n_f32(mat0, r);
+    vec = vmlaq_n_f32(vec, mat1, g);
+    vec = vmlaq_n_f32(vec, mat2, b);
+    vec = vmaxq_f32(min, vec);
+    vec = vminq_f32(max, vec);
+    return vcvtq_u32_f32(vmlaq_f32(half, vec, scale));
+}
+
+void qcms_transform_data_rgb_out_lut_neon(qcms_transform *transform,
+                                          unsigned char *src,
+                                          unsigned char *dest,
+                                          size_t length)
+{
+    size_t i;
+    float (*mat)[4] = transform->matrix;
+
+    /* deref *transform now to avoid it in loop */
+    const float *igtbl_r = transform->input_gamma_table_r;
+    const float *igtbl_g = transform->input_gamma_table_g;
+    const float *igtbl_b = transform->input_gamma_table_b;
+
+    /* deref *transform now to avoid it in loop */
+    const uint8_t *otdata_r = &transform->output_table_r->data[0];
+    const uint8_t *otdata_g = &transform->output_table_g->data[0];
+    const uint8_t *otdata_b = &transform->output_table_b->data[0];
+
+    /* input matrix values never change */
+    const float32x4_t mat0 = vld1q_f32(mat[0]);
+    const float32x4_t mat1 = vld1q_f32(mat[1]);
+    const float32x4_t mat2 = vld1q_f32(mat[2]);
+
+    /* these values don't change, either */
+    const float32x4_t max   = vdupq_n_f32(CLAMPMAXVAL);
+    const float32x4_t min   = vdupq_n_f32(0.0f);
+    const float32x4_t scale = vdupq_n_f32(FLOATSCALE);
+    const float32x4_t half  = vdupq_n_f32(0.5f);
+
+    for (i = 0; i < length; i++) {
+        uint32x4_t result = transform_indices(mat0, mat1, mat2,
+                                              igtbl_r[src[0]],
+                                              igtbl_g[src[1]],
+                                              igtbl_b[src[2]],
+                                              min, max, scale, half);
+        src += 3;
+
+        dest[OUTPUT_R_INDEX] = otdata_r[vgetq_lane_u32(result, 0)];
+        dest[OUTPUT_G_INDEX] = otdata_g[vgetq_lane_u32(result, 1)];
+        dest[OUTPUT_B_INDEX] = otdata_b[vgetq_lane_u32(result, 2)];
+        dest += RGB_OUTPUT_COMPONENTS;
+    }
+}
+
+void qcms_transform_data_rgba_out_lut_neon(qcms_transform *transform,
+                                           unsigned char *src,
+                                           unsigned char *dest,
+                                           size_t length)
+{
+    size_t i;
+    float (*mat)[4] = transform->matrix;
+
+    /* deref *transform now to avoid it in loop */
+    const float *igtbl_r = transform->input_gamma_table_r;
+    const float *igtbl_g = transform->input_gamma_table_g;
+    const float *igtbl_b = transform->input_gamma_table_b;
+
+    /* deref *transform now to avoid it in loop */
+    const uint8_t *otdata_r = &transform->output_table_r->data[0];
+    const uint8_t *otdata_g = &transform->output_table_g->data[0];
+    const uint8_t *otdata_b = &transform->output_table_b->data[0];
+
+    /* input matrix values never change */
+    const float32x4_t mat0 = vld1q_f32(mat[0]);
+    const float32x4_t mat1 = vld1q_f32(mat[1]);
+    const float32x4_t mat2 = vld1q_f32(mat[2]);
+
+    /* these values don't change, either */
+    const float32x4_t max   = vdupq_n_f32(CLAMPMAXVAL);
+    const float32x4_t min   = vdupq_n_f32(0.0f);
+    const float32x4_t scale = vdupq_n_f32(FLOATSCALE);
+    const float32x4_t half  = vdupq_n_f32(0.5f);
+
+    for (i = 0; i < length; i++) {
+        /* read the whole pixel first, src and dest may be the same */
+        unsigned char alpha = src[3];
+        uint32x4_t result = transform_indices(mat0, mat1, mat2,
+                                              igtbl_r[src[0]],
+                                              igtbl_g[src[1]],
+                                              igtbl_b[src[2]],
+                                              min, max, scale, half);
+        src += 4;
+
+        dest[OUTPUT_R_INDEX] = otdata_r[vgetq_lane_u32(result, 0)];
+        dest[OUTPUT_G_INDEX] = otdata_g[vgetq_lane_u32(result, 1)];
+        dest[OUTPUT_B_INDEX] = otdata_b[vgetq_lane_u32(result, 2)];
+        dest[OUTPUT_A_INDEX] = alpha;
+        dest += RGBA_OUTPUT_COMPONENTS;
+    }
+}
@@ -112,6 +112,61 @@ static inline qcms_bool have_altivec() {
 #endif
 #endif // (defined(__POWERPC__) || defined(__powerpc__))
 
+/**
+ * The NEON paths are only built when the build allows NEON code, but the CPU
+ * may still lack it on 32-bit ARM, so check the hardware capabilities the
+ * kernel reports.
+ */
+#if defined(BUILD_ARM_NEON)
+#if defined(__aarch64__)
+#define have_neon() true
+#elif defined(__linux__)
+#include <unistd.h>
+#include <fcntl.h>
+#include <elf.h>
+#include <link.h>
+
+#ifndef HWCAP_NEON
+#define HWCAP_NEON (1 << 12)
+#endif
+
+static inline qcms_bool have_neon() {
+	static int available = -1;
+	int new_avail = 0;
+	ElfW(auxv_t) auxv;
+	ssize_t count;
+	int fd;
+
+	if (available != -1)
+		return (available != 0 ? true : false);
+
+	fd = open("/proc/self/auxv", O_RDONLY);
+	if (fd < 0)
+		goto out;
+	do {
+		count = read(fd, &auxv, sizeof(auxv));
+		if (count < (ssize_t)sizeof(auxv))
+			goto out_close;
+
+		if (auxv.a_type == AT_HWCAP) {
+			new_avail = !!(auxv.a_un.a_val & HWCAP_NEON);
+			goto out_close;
+		}
+	} while (auxv.a_type != AT_NULL);
+
+out_close:
+	close(fd);
+out:
+	available = new_avail;
+	return (available != 0 ? true : false);
+}
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#define have_neon() true
+#else
+#define have_neon() false
+#endif
+#endif // defined(BUILD_ARM_NEON)
+
 // Build a White point, primary chromas transfer matrix from RGB to CIE XYZ
 // This is just an approximation, I am not handling all the non-linear
 // aspects of the RGB to XYZ process, and assumming that the gamma correction
@@ -1303,6 +1358,14 @@ qcms_transform* qcms_transform_create(
 			    else
 				    transform->transform_fn = qcms_transform_data_rgba_out_lut_altivec;
 		    } else
+#endif
+#if defined(BUILD_ARM_NEON)
+		    if (have_neon()) {
+			    if (in_type == QCMS_DATA_RGB_8)
+				    transform->transform_fn = qcms_transform_data_rgb_out_lut_neon;
+			    else
+				    transform->transform_fn = qcms_transform_data_rgba_out_lut_neon;
+		    } else
 #endif
 			{
 				if (in_type == QCMS_DATA_RGB_8)
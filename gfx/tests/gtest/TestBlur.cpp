@@ -0,0 +1,112 @@
+/* -*- Mode: C++; tab-width: 20; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "gtest/gtest.h"
+#include "gtest/MozGTestBench.h" // For MOZ_GTEST_BENCH
+
+#include "Blur.h"
+#include "mozilla/UniquePtr.h"
+
+#include <string.h>
+
+using namespace mozilla;
+using namespace mozilla::gfx;
+
+// An alpha surface for blurring |aRect| with the given standard deviation.
+class BlurSurface
+{
+public:
+  BlurSurface(const Rect& aRect, float aSigma)
+    : mBlur(aRect, IntSize(),
+            AlphaBoxBlur::CalculateBlurRadius(Point(aSigma, aSigma)),
+            nullptr, nullptr)
+  {
+    mData = MakeUnique<uint8_t[]>(mBlur.GetSurfaceAllocationSize());
+    memset(mData.get(), 0, mBlur.GetSurfaceAllocationSize());
+  }
+
+  // Make the pixels of |aRect|, in surface coordinates, opaque.
+  void Fill(const IntRect& aRect)
+  {
+    for (int32_t y = aRect.y; y < aRect.YMost(); ++y) {
+      memset(mData.get() + y * mBlur.GetStride() + aRect.x, 0xff, aRect.width);
+    }
+  }
+
+  void Blur() { mBlur.Blur(mData.get()); }
+
+  uint8_t At(int32_t aX, int32_t aY)
+  {
+    return mData[aY * mBlur.GetStride() + aX];
+  }
+
+  IntSize Size() { return mBlur.GetSize(); }
+
+private:
+  AlphaBoxBlur mBlur;
+  UniquePtr<uint8_t[]> mData;
+};
+
+TEST(Blur, EmptyStaysEmpty) {
+  BlurSurface surface(Rect(0, 0, 100, 80), 5);
+  surface.Blur();
+
+  IntSize size = surface.Size();
+  for (int32_t y = 0; y < size.height; ++y) {
+    for (int32_t x = 0; x < size.width; ++x) {
+      ASSERT_EQ(surface.At(x, y), 0) << "pixel " << x << "," << y;
+    }
+  }
+}
+
+TEST(Blur, OpaqueInteriorStaysOpaque) {
+  BlurSurface surface(Rect(0, 0, 200, 160), 4);
+  IntSize size = surface.Size();
+  surface.Fill(IntRect(0, 0, size.width, size.height));
+  surface.Blur();
+
+  // Pixels further than the blur radius from the edges only see opaque ones.
+  for (int32_t y = 60; y < 100; ++y) {
+    for (int32_t x = 60; x < 140; ++x) {
+      ASSERT_EQ(surface.At(x, y), 255) << "pixel " << x << "," << y;
+    }
+  }
+}
+
+TEST(Blur, EdgeIsSmoothed) {
+  BlurSurface surface(Rect(0, 0, 200, 100), 6);
+  IntSize size = surface.Size();
+  surface.Fill(IntRect(size.width / 2, 0, size.width - size.width / 2,
+                       size.height));
+  surface.Blur();
+
+  // Across the edge the alpha increases monotonically, and pixels next to it
+  // are neither transparent nor opaque any more.
+  int32_t y = size.height / 2;
+  for (int32_t x = size.width / 2 - 20; x < size.width / 2 + 20; ++x) {
+    ASSERT_LE(surface.At(x - 1, y), surface.At(x, y)) << "pixel " << x;
+  }
+  EXPECT_GT(surface.At(size.width / 2 - 1, y), 0);
+  EXPECT_LT(surface.At(size.width / 2, y), 255);
+}
+
+// Blurring full HD shadows, as for a box-shadow on a maximized window.
+static void
+BenchBlur(float aSigma)
+{
+  BlurSurface surface(Rect(0, 0, 1920, 1080), aSigma);
+  surface.Fill(IntRect(100, 100, 1720, 880));
+  for (int i = 0; i < 10; ++i) {
+    surface.Blur();
+  }
+}
+
+MOZ_GTEST_BENCH(Blur, Blur1080pSmallRadius, [] {
+  BenchBlur(2);
+});
+
+MOZ_GTEST_BENCH(Blur, Blur1080pLargeRadius, [] {
+  BenchBlur(30);
+});
@@ -5,11 +5,14 @@
 
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
+#include "gtest/MozGTestBench.h" // For MOZ_GTEST_BENCH
 
 #include "mozilla/ArrayUtils.h"
 #include "qcms.h"
 #include "transform_util.h"
 
+#include <stdlib.h>
+
 const size_t allGBSize = 1 * 256 * 256 * 4;
 static unsigned char* createAllGB() {
   unsigned char* buff = (unsigned char*)malloc(allGBSize);
@@ -166,3 +169,67 @@ TEST(GfxQcms, LutInverseNonMonotonic) {
 
   // Make sure we don't crash, hang or let sanitizers do their magic
 }
+
+// With a precached output profile, transforms use the SIMD paths where the
+// CPU has them.
+static qcms_transform* createPrecachedTransform(qcms_data_type aType) {
+  qcms_profile* input_profile = qcms_profile_sRGB();
+  qcms_profile* output_profile = qcms_profile_sRGB();
+  qcms_profile_precache_output_transform(output_profile);
+
+  qcms_transform* transform = qcms_transform_create(input_profile, aType,
+                                                    output_profile, aType,
+                                                    QCMS_INTENT_DEFAULT);
+
+  qcms_profile_release(input_profile);
+  qcms_profile_release(output_profile);
+  return transform;
+}
+
+TEST(GfxQcms, PrecachedIdentity) {
+  qcms_transform* transform = createPrecachedTransform(QCMS_DATA_RGBA_8);
+  ASSERT_TRUE(transform);
+
+  unsigned char *data_in = createAllGB();
+  unsigned char *data_out = (unsigned char*)malloc(allGBSize);
+  qcms_transform_data(transform, data_in, data_out, allGBSize / 4);
+
+  for (size_t i = 0; i < allGBSize; i += 4) {
+    ASSERT_LE(abs(data_out[i + 0] - data_in[i + 0]), 1) << "pixel " << i / 4;
+    ASSERT_LE(abs(data_out[i + 1] - data_in[i + 1]), 1) << "pixel " << i / 4;
+    ASSERT_LE(abs(data_out[i + 2] - data_in[i + 2]), 1) << "pixel " << i / 4;
+    ASSERT_EQ(data_out[i + 3], data_in[i + 3]) << "pixel " << i / 4;
+  }
+
+  qcms_transform_release(transform);
+  free(data_in);
+  free(data_out);
+}
+
+// Transforming a decoded full HD image in place, a row at a time, as the
+// image decoders do.
+static void BenchTransform(qcms_data_type aType, size_t aBytesPerPixel) {
+  const size_t width = 1920;
+  const size_t height = 1080;
+  qcms_transform* transform = createPrecachedTransform(aType);
+  ASSERT_TRUE(transform);
+
+  unsigned char *row = (unsigned char*)malloc(width * aBytesPerPixel);
+  for (size_t i = 0; i < width * aBytesPerPixel; i++) {
+    row[i] = i & 0xff;
+  }
+  for (size_t y = 0; y < height; y++) {
+    qcms_transform_data(transform, row, row, width);
+  }
+
+  qcms_transform_release(transform);
+  free(row);
+}
+
+MOZ_GTEST_BENCH(GfxQcms, TransformRGB1080p, [] {
+  BenchTransform(QCMS_DATA_RGB_8, 3);
+});
+
+MOZ_GTEST_BENCH(GfxQcms, TransformRGBA1080p, [] {
+  BenchTransform(QCMS_DATA_RGBA_8, 4);
+});
@@ -0,0 +1,146 @@
+/* -*- Mode: C++; tab-width: 20; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "gtest/gtest.h"
+#include "gtest/MozGTestBench.h" // For MOZ_GTEST_BENCH
+
+#include "gfxPrefs.h"
+#include "ImageContainer.h"
+#include "mozilla/UniquePtr.h"
+#include "YCbCrUtils.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+using namespace mozilla;
+using namespace mozilla::gfx;
+using namespace mozilla::layers;
+
+// A 4:2:0 frame of a single color.
+class YCbCrFrame
+{
+public:
+  YCbCrFrame(const IntSize& aSize, uint8_t aY, uint8_t aCb, uint8_t aCr,
+             YUVColorSpace aColorSpace = YUVColorSpace::BT601)
+  {
+    IntSize cbcrSize((aSize.width + 1) / 2, (aSize.height + 1) / 2);
+    size_t ySize = size_t(aSize.width) * aSize.height;
+    size_t cbcrLength = size_t(cbcrSize.width) * cbcrSize.height;
+    mBuffer = MakeUnique<uint8_t[]>(ySize + 2 * cbcrLength);
+    memset(mBuffer.get(), aY, ySize);
+    memset(mBuffer.get() + ySize, aCb, cbcrLength);
+    memset(mBuffer.get() + ySize + cbcrLength, aCr, cbcrLength);
+
+    mData.mYChannel = mBuffer.get();
+    mData.mYStride = aSize.width;
+    mData.mYSize = aSize;
+    mData.mCbChannel = mBuffer.get() + ySize;
+    mData.mCrChannel = mBuffer.get() + ySize + cbcrLength;
+    mData.mCbCrStride = cbcrSize.width;
+    mData.mCbCrSize = cbcrSize;
+    mData.mPicSize = aSize;
+    mData.mYUVColorSpace = aColorSpace;
+  }
+
+  const PlanarYCbCrData& Data() const { return mData; }
+
+private:
+  UniquePtr<uint8_t[]> mBuffer;
+  PlanarYCbCrData mData;
+};
+
+static void
+Convert(const YCbCrFrame& aFrame, const IntSize& aDestSize, uint8_t* aDest)
+{
+  // The conversion reads the accurate conversion pref.
+  gfxPrefs::GetSingleton();
+  ConvertYCbCrToRGB(aFrame.Data(), SurfaceFormat::B8G8R8X8, aDestSize, aDest,
+                    aDestSize.width * 4);
+}
+
+// libyuv trades some accuracy for speed.
+static void
+CheckColor(const uint8_t* aDest, const IntSize& aSize,
+           uint8_t aR, uint8_t aG, uint8_t aB)
+{
+  const int kTolerance = 3;
+  for (int i = 0; i < aSize.width * aSize.height; ++i) {
+    const uint8_t* pixel = aDest + i * 4;
+    ASSERT_LE(abs(pixel[0] - aB), kTolerance) << "pixel " << i;
+    ASSERT_LE(abs(pixel[1] - aG), kTolerance) << "pixel " << i;
+    ASSERT_LE(abs(pixel[2] - aR), kTolerance) << "pixel " << i;
+  }
+}
+
+TEST(YCbCr, ConvertGrays) {
+  const IntSize size(66, 34);
+  auto dest = MakeUnique<uint8_t[]>(size.width * size.height * 4);
+
+  for (YUVColorSpace colorSpace : { YUVColorSpace::BT601,
+                                    YUVColorSpace::BT709 }) {
+    // Video range black and white map to full range ones.
+    Convert(YCbCrFrame(size, 16, 128, 128, colorSpace), size, dest.get());
+    CheckColor(dest.get(), size, 0, 0, 0);
+    Convert(YCbCrFrame(size, 235, 128, 128, colorSpace), size, dest.get());
+    CheckColor(dest.get(), size, 255, 255, 255);
+  }
+}
+
+TEST(YCbCr, ConvertRed) {
+  const IntSize size(32, 32);
+  auto dest = MakeUnique<uint8_t[]>(size.width * size.height * 4);
+
+  // BT.601 video range red.
+  Convert(YCbCrFrame(size, 81, 90, 240), size, dest.get());
+  CheckColor(dest.get(), size, 255, 0, 0);
+}
+
+TEST(YCbCr, ScaleKeepsColor) {
+  const IntSize size(64, 48);
+  YCbCrFrame frame(size, 126, 128, 128);
+
+  for (IntSize destSize : { IntSize(32, 24), IntSize(45, 31),
+                            IntSize(100, 80) }) {
+    auto dest = MakeUnique<uint8_t[]>(destSize.width * destSize.height * 4);
+    Convert(frame, destSize, dest.get());
+    CheckColor(dest.get(), destSize, 128, 128, 128);
+  }
+}
+
+// Conversion throughput of frames of the common video sizes, at their own
+// size and scaled for display in a smaller window.
+static void
+BenchConvert(const IntSize& aSize, const IntSize& aDestSize)
+{
+  YCbCrFrame frame(aSize, 126, 100, 150);
+  auto dest = MakeUnique<uint8_t[]>(aDestSize.width * aDestSize.height * 4);
+  for (int i = 0; i < 10; ++i) {
+    Convert(frame, aDestSize, dest.get());
+  }
+}
+
+MOZ_GTEST_BENCH(YCbCr, Convert480p, [] {
+  BenchConvert(IntSize(854, 480), IntSize(854, 480));
+});
+
+MOZ_GTEST_BENCH(YCbCr, Convert1080p, [] {
+  BenchConvert(IntSize(1920, 1080), IntSize(1920, 1080));
+});
+
+MOZ_GTEST_BENCH(YCbCr, Convert2160p, [] {
+  BenchConvert(IntSize(3840, 2160), IntSize(3840, 2160));
+});
+
+MOZ_GTEST_BENCH(YCbCr, Scale1080pTo720p, [] {
+  BenchConvert(IntSize(1920, 1080), IntSize(1280, 720));
+});
+
+MOZ_GTEST_BENCH(YCbCr, Scale2160pTo1080p, [] {
+  BenchConvert(IntSize(3840, 2160), IntSize(1920, 1080));
+});
+
+MOZ_GTEST_BENCH(YCbCr, Scale2160pTo1440p, [] {
+  BenchConvert(IntSize(3840, 2160), IntSize(2560, 1440));
+});
@@ -308,7 +308,8 @@ struct BlurCacheKey : public PLDHashEntryHdr {
         aKey->mBlurRadius == mBlurRadius &&
         aKey->mCornerRadii == mCornerRadii &&
         aKey->mShadowColor == mShadowColor &&
-        aKey->mBackend == mBackend) {
+        aKey->mBackend == mBackend &&
+        aKey->mIsInset == mIsInset) {
 
       if (mIsInset) {
         return (mInnerMinSize == aKey->mInnerMinSize);
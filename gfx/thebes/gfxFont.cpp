@@ -2539,6 +2539,31 @@ gfxFont::AgeCachedWords()
     }
 }
 
+void
+gfxFont::EvictCachedWords(uint32_t aMaxEntries)
+{
+    if (!mWordCache) {
+        return;
+    }
+    // Words are only aged by the gfxFontCache timer, so their ages tell
+    // how many timer periods ago they were last used. Drop the oldest ones
+    // first, and only throw everything out if the recently used words alone
+    // are too many.
+    for (uint32_t age = kShapedWordCacheMaxAge - 1;
+         age > 0 && mWordCache->Count() > aMaxEntries; --age) {
+        for (auto it = mWordCache->Iter(); !it.Done(); it.Next()) {
+            CacheHashEntry *entry = it.Get();
+            if (!entry->mShapedWord || entry->mShapedWord->GetAge() >= age) {
+                it.Remove();
+            }
+        }
+    }
+    if (mWordCache->Count() > aMaxEntries) {
+        NS_WARNING("flushing shaped-word cache");
+        ClearCachedWords();
+    }
+}
+
 void
 gfxFont::NotifyGlyphsChanged()
 {
@@ -2585,12 +2610,12 @@ gfxFont::GetShapedWord(DrawTarget *aDrawTarget,
                        RoundingFlags aRounding,
                        gfxTextPerfMetrics *aTextPerf GFX_MAYBE_UNUSED)
 {
-    // if the cache is getting too big, flush it and start over
+    // if the cache is getting too big, make room for more words, leaving
+    // some slack so that this doesn't happen again on the next new word
     uint32_t wordCacheMaxEntries =
         gfxPlatform::GetPlatform()->WordCacheMaxEntries();
     if (mWordCache->Count() > wordCacheMaxEntries) {
-        NS_WARNING("flushing shaped-word cache");
-        ClearCachedWords();
+        EvictCachedWords(wordCacheMaxEntries / 4 * 3);
     }
 
     // if there's a cached entry for this word, just return it
@@ -1281,6 +1281,9 @@ public:
     uint32_t IncrementAge() {
         return ++mAgeCounter;
     }
+    uint32_t GetAge() const {
+        return mAgeCounter;
+    }
 
     // Helper used when hashing a word for the shaped-word caches
     static uint32_t HashMix(uint32_t aHash, char16_t aCh)
@@ -1800,6 +1803,10 @@ public:
     // so that they'll expire after a sufficient period of non-use
     void AgeCachedWords();
 
+    // Discard the least recently used cached words until no more than
+    // aMaxEntries remain; called when the cache grows too big.
+    void EvictCachedWords(uint32_t aMaxEntries);
+
     // Discard all cached word records; called on memory-pressure notification.
     void ClearCachedWords() {
         if (mWordCache) {
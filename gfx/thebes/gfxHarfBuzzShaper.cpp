@@ -65,6 +65,7 @@ gfxHarfBuzzShaper::gfxHarfBuzzShaper(gfxFont *aFont)
       mUseFontGlyphWidths(false),
       mInitialized(false),
       mVerticalInitialized(false),
+      mCanShapeSimpleText(false),
       mLoadedLocaGlyf(false),
       mLocaLongOffsets(false)
 {
@@ -1304,6 +1305,11 @@ gfxHarfBuzzShaper::Initialize()
     uint32_t scale = FloatToFixed(mFont->GetAdjustedSize()); // 16.16 fixed-point
     hb_font_set_scale(mHBFont, scale, scale);
 
+    mCanShapeSimpleText =
+        !hb_ot_layout_has_substitution(mHBFace) &&
+        !hb_ot_layout_has_positioning(mHBFace) &&
+        !entry->HasFontTable(TRUETYPE_TAG('k','e','r','n'));
+
     return true;
 }
 
@@ -1453,6 +1459,11 @@ gfxHarfBuzzShaper::ShapeText(DrawTarget      *aDrawTarget,
         }
     }
 
+    if (mCanShapeSimpleText && !aVertical && !aShapedText->IsRightToLeft() &&
+        ShapeSimpleText(aShapedText, aOffset, aLength, aText, aRounding)) {
+        return true;
+    }
+
     const gfxFontStyle *style = mFont->GetStyle();
 
     // determine whether petite-caps falls back to small-caps
@@ -1532,6 +1543,58 @@ gfxHarfBuzzShaper::ShapeText(DrawTarget      *aDrawTarget,
     return NS_SUCCEEDED(rv);
 }
 
+bool
+gfxHarfBuzzShaper::ShapeSimpleText(gfxShapedText  *aShapedText,
+                                   uint32_t        aOffset,
+                                   uint32_t        aLength,
+                                   const char16_t *aText,
+                                   RoundingFlags   aRounding)
+{
+    // Control characters and anything beyond ASCII may need normalization,
+    // mirroring, fallback spacing or cluster handling from harfbuzz.
+    for (uint32_t i = 0; i < aLength; ++i) {
+        if (aText[i] < 0x20 || aText[i] > 0x7e) {
+            return false;
+        }
+    }
+
+    bool roundI = bool(aRounding & RoundingFlags::kRoundX);
+    int32_t appUnitsPerDevUnit = aShapedText->GetAppUnitsPerDevUnit();
+    double hb2appUnits = FixedToFloat(appUnitsPerDevUnit);
+    gfxShapedText::CompressedGlyph *charGlyphs =
+        aShapedText->GetCharacterGlyphs() + aOffset;
+
+    // The advances are rounded exactly as SetGlyphsFromRun would round the
+    // positions harfbuzz returns for this text, so that the results don't
+    // depend on which path was taken.
+    hb_position_t residual = 0;
+    for (uint32_t i = 0; i < aLength; ++i) {
+        hb_codepoint_t gid = GetNominalGlyph(aText[i]);
+        if (!gid || !charGlyphs[i].IsClusterStart() ||
+            !gfxTextRun::CompressedGlyph::IsSimpleGlyphID(gid)) {
+            return false;
+        }
+        hb_position_t width = GetGlyphHAdvance(gid);
+        nscoord advance;
+        if (roundI) {
+            if (FixedToIntRound(residual) != 0) {
+                return false;
+            }
+            int intWidth = FixedToIntRound(width);
+            residual = width - FloatToFixed(intWidth);
+            advance = appUnitsPerDevUnit * intWidth;
+        } else {
+            advance = floor(hb2appUnits * width + 0.5);
+        }
+        if (!gfxTextRun::CompressedGlyph::IsSimpleAdvance(advance)) {
+            return false;
+        }
+        charGlyphs[i].SetSimpleGlyph(advance, gid);
+    }
+
+    return true;
+}
+
 #define SMALL_GLYPH_RUN 128 // some testing indicates that 90%+ of text runs
                             // will fit without requiring separate allocation
                             // for charToGlyphArray
@@ -103,6 +103,18 @@ protected:
                               bool            aVertical,
                               RoundingFlags   aRounding);
 
+    // Fill in the glyphs of plain horizontal left-to-right ASCII text
+    // directly from the cmap and hmtx tables, without running harfbuzz.
+    // Only used for fonts that have no GSUB, GPOS or kern tables, where
+    // shaping such text would give the nominal glyphs and advances anyway.
+    // Returns false, having possibly stored some glyphs, if the text needs
+    // to be shaped normally.
+    bool ShapeSimpleText(gfxShapedText  *aShapedText,
+                         uint32_t        aOffset,
+                         uint32_t        aLength,
+                         const char16_t *aText,
+                         RoundingFlags   aRounding);
+
     // retrieve glyph positions, applying advance adjustments and attachments
     // returns results in appUnits
     nscoord GetGlyphPositions(gfxContext *aContext,
@@ -181,6 +193,10 @@ protected:
     bool mInitialized;
     bool mVerticalInitialized;
 
+    // Whether the font has no layout tables that could change the nominal
+    // glyphs or advances, so ShapeSimpleText may be tried.
+    bool mCanShapeSimpleText;
+
     // Whether to use vertical presentation forms for CJK characters
     // when available (only set if the 'vert' feature is not available).
     bool mUseVerticalPresentationForms;
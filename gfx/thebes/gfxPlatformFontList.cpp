@@ -1532,6 +1532,15 @@ gfxPlatformFontList::CleanupLoader()
                       (forceReflow ? "(global reflow)" : "")));
     }
 
+    // Every process loads the same font info, so record how much that
+    // costs each of them.
+    if (mFontInfo && !mLoadTime.IsZero()) {
+        Telemetry::Accumulate(Telemetry::FONTLIST_FONTINFO_LOAD_TIME,
+                              uint32_t(mLoadTime.ToMilliseconds()));
+        Telemetry::Accumulate(Telemetry::FONTLIST_FONTINFO_CMAPS,
+                              mFontInfo->mLoadStats.cmaps);
+    }
+
     gfxFontInfoLoader::CleanupLoader();
 }
 
@@ -6,6 +6,7 @@
 #include "AnimationSurfaceProvider.h"
 
 #include "gfxPrefs.h"
+#include "mozilla/Telemetry.h"
 #include "nsProxyRelease.h"
 
 #include "Decoder.h"
@@ -268,6 +269,23 @@ AnimationSurfaceProvider::FinishDecoding()
   // Send notifications.
   NotifyDecodeComplete(WrapNotNull(mImage), WrapNotNull(mDecoder));
 
+  // Record what keeping the whole animation decoded costs us. This is the data
+  // we need to size a window of decoded frames, should we stop keeping them
+  // all.
+  {
+    MutexAutoLock lock(mFramesMutex);
+
+    uint64_t decodedBytes = 0;
+    for (const RawAccessFrameRef& frame : mFrames) {
+      decodedBytes += frame->GetImageDataLength() + frame->PaletteDataLength();
+    }
+
+    Telemetry::Accumulate(Telemetry::IMAGE_ANIMATED_FRAME_COUNT,
+                          mFrames.Length());
+    Telemetry::Accumulate(Telemetry::IMAGE_ANIMATED_DECODED_SIZE_KB,
+                          uint32_t(decodedBytes / 1024));
+  }
+
   // Destroy our decoder; we don't need it anymore.
   mDecoder = nullptr;
 
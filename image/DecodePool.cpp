@@ -9,6 +9,8 @@
 
 #include "mozilla/ClearOnShutdown.h"
 #include "mozilla/Monitor.h"
+#include "mozilla/Telemetry.h"
+#include "mozilla/TimeStamp.h"
 #include "nsCOMPtr.h"
 #include "nsIObserverService.h"
 #include "nsIThreadPool.h"
@@ -49,6 +51,13 @@ struct Work
   RefPtr<IDecodingTask> mTask;
 };
 
+/// A task waiting in one of the DecodePool's queues.
+struct QueuedTask
+{
+  RefPtr<IDecodingTask> mTask;
+  TimeStamp mQueueTime;
+};
+
 class DecodePoolImpl
 {
 public:
@@ -94,10 +103,14 @@ public:
       return;
     }
 
+    QueuedTask queued;
+    queued.mQueueTime = TimeStamp::Now();
     if (task->Priority() == TaskPriority::eHigh) {
-      mHighPriorityQueue.AppendElement(Move(task));
+      queued.mTask = Move(task);
+      mHighPriorityQueue.AppendElement(Move(queued));
     } else {
-      mLowPriorityQueue.AppendElement(Move(task));
+      queued.mTask = Move(task);
+      mLowPriorityQueue.AppendElement(Move(queued));
     }
 
     mMonitor.Notify();
@@ -110,11 +123,13 @@ public:
 
     do {
       if (!mHighPriorityQueue.IsEmpty()) {
-        return PopWorkFromQueue(mHighPriorityQueue);
+        return PopWorkFromQueue(mHighPriorityQueue,
+                                NS_LITERAL_CSTRING("high"));
       }
 
       if (!mLowPriorityQueue.IsEmpty()) {
-        return PopWorkFromQueue(mLowPriorityQueue);
+        return PopWorkFromQueue(mLowPriorityQueue,
+                                NS_LITERAL_CSTRING("low"));
       }
 
       if (mShuttingDown) {
@@ -137,11 +152,16 @@ public:
 private:
   ~DecodePoolImpl() { }
 
-  Work PopWorkFromQueue(nsTArray<RefPtr<IDecodingTask>>& aQueue)
+  Work PopWorkFromQueue(nsTArray<QueuedTask>& aQueue,
+                        const nsCString& aPriority)
   {
+    QueuedTask& queued = aQueue.LastElement();
+    Telemetry::Accumulate(Telemetry::IMAGE_DECODE_QUEUE_LATENCY_US, aPriority,
+      uint32_t((TimeStamp::Now() - queued.mQueueTime).ToMicroseconds()));
+
     Work work;
     work.mType = Work::Type::TASK;
-    work.mTask = aQueue.LastElement().forget();
+    work.mTask = queued.mTask.forget();
     aQueue.RemoveElementAt(aQueue.Length() - 1);
 
     return work;
@@ -151,8 +171,8 @@ private:
 
   // mMonitor guards the queues and mShuttingDown.
   Monitor mMonitor;
-  nsTArray<RefPtr<IDecodingTask>> mHighPriorityQueue;
-  nsTArray<RefPtr<IDecodingTask>> mLowPriorityQueue;
+  nsTArray<QueuedTask> mHighPriorityQueue;
+  nsTArray<QueuedTask> mLowPriorityQueue;
   bool mShuttingDown;
 };
 
@@ -23,6 +23,7 @@ DecodedSurfaceProvider::DecodedSurfaceProvider(NotNull<RasterImage*> aImage,
   , mImage(aImage.get())
   , mMutex("mozilla::image::DecodedSurfaceProvider")
   , mDecoder(aDecoder.get())
+  , mRemovedFromCache(false)
 {
   MOZ_ASSERT(!mDecoder->IsMetadataDecode(),
              "Use MetadataDecodingTask for metadata decodes");
@@ -130,6 +131,15 @@ DecodedSurfaceProvider::Run()
 {
   MutexAutoLock lock(mMutex);
 
+  if (mRemovedFromCache) {
+    // Our surface was discarded or evicted while we were waiting to run, so
+    // nothing would ever draw what we decode. Stop here, without notifying;
+    // the image will start a new decode if it needs this surface again.
+    mDecoder = nullptr;
+    DropImageReference();
+    return;
+  }
+
   if (!mDecoder || !mImage) {
     MOZ_ASSERT_UNREACHABLE("Running after decoding finished?");
     return;
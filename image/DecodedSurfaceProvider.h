@@ -13,6 +13,7 @@
 #include "IDecodingTask.h"
 #include "ISurfaceProvider.h"
 #include "SurfaceCache.h"
+#include "mozilla/Atomics.h"
 
 namespace mozilla {
 namespace image {
@@ -59,6 +60,8 @@ public:
   // don't block layout or page load.
   TaskPriority Priority() const override { return TaskPriority::eLow; }
 
+protected:
+  void RemovedFromCache() override { mRemovedFromCache = true; }
 
 private:
   virtual ~DecodedSurfaceProvider();
@@ -81,6 +84,10 @@ private:
 
   /// A drawable reference to our service; used for locking.
   DrawableFrameRef mLockRef;
+
+  /// Set once our surface cache entry is gone, so nobody can use our surface
+  /// anymore and the rest of the decode would be wasted work.
+  Atomic<bool> mRemovedFromCache;
 };
 
 } // namespace image
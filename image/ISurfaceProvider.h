@@ -111,6 +111,12 @@ protected:
   /// SurfaceCache code as it relies on SurfaceCache for synchronization.
   virtual void SetLocked(bool aLocked) = 0;
 
+  /// Called once this ISurfaceProvider's entry has left the surface cache, so
+  /// that nothing can look up its surfaces anymore. Providers that are still
+  /// generating surfaces can use this to stop early. Should only be called
+  /// from SurfaceCache code.
+  virtual void RemovedFromCache() { }
+
 private:
   friend class CachedSurface;
   friend class DrawableSurface;
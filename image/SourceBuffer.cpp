@@ -342,7 +342,7 @@ SourceBuffer::ExpectLength(size_t aExpectedLength)
 }
 
 nsresult
-SourceBuffer::Append(const char* aData, size_t aLength)
+SourceBuffer::Append(const char* aData, size_t aLength, bool aResumeConsumers)
 {
   MOZ_ASSERT(aData, "Should have a buffer");
   MOZ_ASSERT(aLength > 0, "Writing a zero-sized chunk");
@@ -430,19 +430,21 @@ SourceBuffer::Append(const char* aData, size_t aLength)
     }
 
     // Resume any waiting readers now that there's new data.
-    ResumeWaitingConsumers();
+    if (aResumeConsumers) {
+      ResumeWaitingConsumers();
+    }
   }
 
   return NS_OK;
 }
 
-static nsresult
-AppendToSourceBuffer(nsIInputStream*,
-                     void* aClosure,
-                     const char* aFromRawSegment,
-                     uint32_t,
-                     uint32_t aCount,
-                     uint32_t* aWriteCount)
+/* static */ nsresult
+SourceBuffer::AppendToSourceBuffer(nsIInputStream*,
+                                   void* aClosure,
+                                   const char* aFromRawSegment,
+                                   uint32_t,
+                                   uint32_t aCount,
+                                   uint32_t* aWriteCount)
 {
   SourceBuffer* sourceBuffer = static_cast<SourceBuffer*>(aClosure);
 
@@ -450,7 +452,8 @@ AppendToSourceBuffer(nsIInputStream*,
   // because returning an error means that ReadSegments stops reading data, and
   // we want to ensure that we read everything we get. If we hit OOM then we
   // return a failed status to the caller.
-  nsresult rv = sourceBuffer->Append(aFromRawSegment, aCount);
+  nsresult rv = sourceBuffer->Append(aFromRawSegment, aCount,
+                                     /* aResumeConsumers = */ false);
   if (rv == NS_ERROR_OUT_OF_MEMORY) {
     return rv;
   }
@@ -472,6 +475,15 @@ SourceBuffer::AppendFromInputStream(nsIInputStream* aInputStream,
     MOZ_ASSERT(bytesRead == aCount,
                "AppendToSourceBuffer should consume everything");
   }
+
+  // Resume any waiting readers now that all the new data is in. Waking them
+  // for each segment would just make them run, and dispatch decoding tasks,
+  // for every few kilobytes of the stream.
+  {
+    MutexAutoLock lock(mMutex);
+    ResumeWaitingConsumers();
+  }
+
   return rv;
 }
 
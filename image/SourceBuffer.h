@@ -329,9 +329,16 @@ public:
   nsresult ExpectLength(size_t aExpectedLength);
 
   /// Append the provided data to the buffer.
-  nsresult Append(const char* aData, size_t aLength);
+  nsresult Append(const char* aData, size_t aLength)
+  {
+    return Append(aData, aLength, /* aResumeConsumers = */ true);
+  }
 
-  /// Append the data available on the provided nsIInputStream to the buffer.
+  /**
+   * Append the data available on the provided nsIInputStream to the buffer.
+   * Waiting consumers are resumed once all of it has been appended, rather
+   * than once per segment of the stream.
+   */
   nsresult AppendFromInputStream(nsIInputStream* aInputStream, uint32_t aCount);
 
   /**
@@ -375,6 +382,15 @@ private:
 
   ~SourceBuffer();
 
+  nsresult Append(const char* aData, size_t aLength, bool aResumeConsumers);
+
+  static nsresult AppendToSourceBuffer(nsIInputStream*,
+                                       void* aClosure,
+                                       const char* aFromRawSegment,
+                                       uint32_t,
+                                       uint32_t aCount,
+                                       uint32_t* aWriteCount);
+
   //////////////////////////////////////////////////////////////////////////////
   // Chunk type and chunk-related methods.
   //////////////////////////////////////////////////////////////////////////////
@@ -28,6 +28,7 @@
 #include "Image.h"
 #include "ISurfaceProvider.h"
 #include "LookupResult.h"
+#include "nsDataHashtable.h"
 #include "nsExpirationTracker.h"
 #include "nsHashKeys.h"
 #include "nsRefPtrHashtable.h"
@@ -122,13 +123,14 @@ private:
  */
 class CachedSurface
 {
-  ~CachedSurface() { }
+  ~CachedSurface() { mProvider->RemovedFromCache(); }
 public:
   MOZ_DECLARE_REFCOUNTED_TYPENAME(CachedSurface)
   NS_INLINE_DECL_THREADSAFE_REFCOUNTING(CachedSurface)
 
   explicit CachedSurface(NotNull<ISurfaceProvider*> aProvider)
     : mProvider(aProvider)
+    , mOwner(static_cast<Image*>(aProvider->GetImageKey())->InnerWindowID())
     , mIsLocked(false)
   { }
 
@@ -168,6 +170,11 @@ public:
   SurfaceKey GetSurfaceKey() const { return mProvider->GetSurfaceKey(); }
   nsExpirationState* GetExpirationState() { return &mExpirationState; }
 
+  /// The inner window of the document that owns our image, or 0 if it has
+  /// none. Surfaces are evicted to make room per owner; see
+  /// SurfaceCacheImpl::EvictionCandidate().
+  uint64_t GetOwner() const { return mOwner; }
+
   CostEntry GetCostEntry()
   {
     return image::CostEntry(WrapNotNull(this), mProvider->LogicalSizeInBytes());
@@ -215,6 +222,7 @@ public:
 private:
   nsExpirationState                 mExpirationState;
   NotNull<RefPtr<ISurfaceProvider>> mProvider;
+  const uint64_t                    mOwner;
   bool                              mIsLocked;
 };
 
@@ -401,6 +409,9 @@ public:
     , mAvailableCost(aSurfaceCacheSize)
     , mLockedCost(0)
     , mOverflowCount(0)
+    , mHitCount(0)
+    , mMissCount(0)
+    , mEvictionCount(0)
   {
     nsCOMPtr<nsIObserverService> os = services::GetObserverService();
     if (os) {
@@ -453,12 +464,14 @@ public:
       return InsertOutcome::FAILURE;
     }
 
-    // Remove elements in order of cost until we can fit this in the cache. Note
-    // that locked surfaces aren't in mCosts, so we never remove them here.
+    // Remove surfaces until we can fit this in the cache, taking them from
+    // whichever document uses the most of it. Note that locked surfaces aren't
+    // in mCosts, so we never remove them here.
     while (cost > mAvailableCost) {
       MOZ_ASSERT(!mCosts.IsEmpty(),
                  "Removed everything and it still won't fit");
-      Remove(mCosts.LastElement().Surface(), aAutoLock);
+      Remove(EvictionCandidate(), aAutoLock);
+      mEvictionCount++;
     }
 
     // Locate the appropriate per-image cache. If there's not an existing cache
@@ -532,6 +545,7 @@ public:
       MOZ_ASSERT(mLockedCost <= mMaxCost, "Locked more than we can hold?");
     } else {
       mCosts.InsertElementSorted(costEntry);
+      mOwnerCosts.GetOrInsert(aSurface->GetOwner(), 0) += costEntry.GetCost();
       // This may fail during XPCOM shutdown, so we need to ensure the object is
       // tracked before calling RemoveObject in StopTracking.
       mExpirationTracker.AddObjectLocked(aSurface, aAutoLock);
@@ -561,6 +575,13 @@ public:
 
       DebugOnly<bool> foundInCosts = mCosts.RemoveElementSorted(costEntry);
       MOZ_ASSERT(foundInCosts, "Lost track of costs for this surface");
+
+      Cost& ownerCost = mOwnerCosts.GetOrInsert(aSurface->GetOwner(), 0);
+      MOZ_ASSERT(ownerCost >= costEntry.GetCost(), "Owner costs don't balance");
+      ownerCost -= costEntry.GetCost();
+      if (ownerCost == 0) {
+        mOwnerCosts.Remove(aSurface->GetOwner());
+      }
     }
 
     mAvailableCost += costEntry.GetCost();
@@ -582,6 +603,9 @@ public:
     RefPtr<CachedSurface> surface = cache->Lookup(aSurfaceKey);
     if (!surface) {
       // Lookup in the per-image cache missed.
+      if (aMarkUsed) {
+        mMissCount++;
+      }
       return LookupResult(MatchType::NOT_FOUND);
     }
 
@@ -598,6 +622,7 @@ public:
     }
 
     if (aMarkUsed) {
+      mHitCount++;
       MarkUsed(WrapNotNull(surface), WrapNotNull(cache), aAutoLock);
     }
 
@@ -629,6 +654,7 @@ public:
       Tie(surface, matchType) = cache->LookupBestMatch(aSurfaceKey);
 
       if (!surface) {
+        mMissCount++;
         return LookupResult(matchType);  // Lookup in the per-image cache missed.
       }
 
@@ -651,7 +677,10 @@ public:
       surface->GetSurfaceKey().Flags() == aSurfaceKey.Flags());
 
     if (matchType == MatchType::EXACT) {
+      mHitCount++;
       MarkUsed(WrapNotNull(surface), WrapNotNull(cache), aAutoLock);
+    } else {
+      mMissCount++;
     }
 
     return LookupResult(Move(drawableSurface), matchType);
@@ -819,6 +848,23 @@ public:
 "Count of how many times the surface cache has hit its capacity and been "
 "unable to insert a new surface.");
 
+    MOZ_COLLECT_REPORT(
+      "imagelib-surface-cache-hits",
+      KIND_OTHER, UNITS_COUNT_CUMULATIVE, mHitCount,
+"Count of surface cache lookups that found the surface they asked for.");
+
+    MOZ_COLLECT_REPORT(
+      "imagelib-surface-cache-misses",
+      KIND_OTHER, UNITS_COUNT_CUMULATIVE, mMissCount,
+"Count of surface cache lookups that found no surface or only a substitute "
+"for the one they asked for.");
+
+    MOZ_COLLECT_REPORT(
+      "imagelib-surface-cache-evictions",
+      KIND_OTHER, UNITS_COUNT_CUMULATIVE, mEvictionCount,
+"Count of surfaces removed from the surface cache to make room for new ones. "
+"Many evictions compared to misses mean the cache is thrashing.");
+
     return NS_OK;
   }
 
@@ -856,6 +902,35 @@ private:
     return aCost <= mMaxCost - mLockedCost;
   }
 
+  // Picks the surface Insert() should remove to make room: the costliest
+  // unlocked surface of the document with the most unlocked surfaces, so that
+  // a background page full of large images evicts its own surfaces rather
+  // than those of the page in front of the user.
+  NotNull<CachedSurface*> EvictionCandidate() const
+  {
+    MOZ_ASSERT(!mCosts.IsEmpty(), "Nothing to evict");
+
+    uint64_t heaviestOwner = mCosts.LastElement().Surface()->GetOwner();
+    Cost heaviestCost = mOwnerCosts.Get(heaviestOwner);
+    for (auto iter = mOwnerCosts.ConstIter(); !iter.Done(); iter.Next()) {
+      if (iter.Data() > heaviestCost) {
+        heaviestOwner = iter.Key();
+        heaviestCost = iter.Data();
+      }
+    }
+
+    // mCosts is sorted by cost, so search it from the end.
+    for (size_t i = mCosts.Length(); i > 0; --i) {
+      NotNull<CachedSurface*> surface = mCosts[i - 1].Surface();
+      if (surface->GetOwner() == heaviestOwner) {
+        return surface;
+      }
+    }
+
+    MOZ_ASSERT_UNREACHABLE("Owner costs out of sync with mCosts");
+    return mCosts.LastElement().Surface();
+  }
+
   void MarkUsed(NotNull<CachedSurface*> aSurface,
                 NotNull<ImageSurfaceCache*> aCache,
                 const StaticMutexAutoLock& aAutoLock)
@@ -945,6 +1020,7 @@ private:
   };
 
   nsTArray<CostEntry>                     mCosts;
+  nsDataHashtable<nsUint64HashKey, Cost>  mOwnerCosts;
   nsRefPtrHashtable<nsPtrHashKey<Image>,
     ImageSurfaceCache> mImageCaches;
   SurfaceTracker                          mExpirationTracker;
@@ -954,6 +1030,9 @@ private:
   Cost                                    mAvailableCost;
   Cost                                    mLockedCost;
   size_t                                  mOverflowCount;
+  size_t                                  mHitCount;
+  size_t                                  mMissCount;
+  size_t                                  mEvictionCount;
 };
 
 NS_IMPL_ISUPPORTS(SurfaceCacheImpl, nsIMemoryReporter)
@@ -378,9 +378,33 @@ nsJPEGDecoder::ReadJPEGData(const char* aData, size_t aLength)
     mInfo.buffered_image = mDecodeStyle == PROGRESSIVE &&
                            jpeg_has_multiple_scans(&mInfo);
 
+    // If we're downscaling, let libjpeg do as much of it as it can in the
+    // IDCT, which is much cheaper than decoding at full size and downscaling
+    // every row afterwards. We pick the smallest scale that is still no
+    // smaller than the output size, and the Downscaler takes care of the rest.
+    if (mDownscaler) {
+      mInfo.scale_num = 1;
+      mInfo.scale_denom = 1;
+      for (unsigned int denom = 8; denom > 1; denom /= 2) {
+        if ((mInfo.image_width + denom - 1) / denom >=
+              uint32_t(OutputSize().width) &&
+            (mInfo.image_height + denom - 1) / denom >=
+              uint32_t(OutputSize().height)) {
+          mInfo.scale_denom = denom;
+          break;
+        }
+      }
+    }
+
     /* Used to set up image size so arrays can be allocated */
     jpeg_calc_output_dimensions(&mInfo);
 
+    // libjpeg may have scaled the image all the way down to the output size.
+    const gfx::IntSize scaledSize(mInfo.output_width, mInfo.output_height);
+    if (mDownscaler && scaledSize == OutputSize()) {
+      mDownscaler.reset();
+    }
+
     MOZ_ASSERT(!mImageData, "Already have a buffer allocated?");
     nsresult rv = AllocateFrame(/* aFrameNum = */ 0, OutputSize(),
                                 FullOutputFrame(), SurfaceFormat::B8G8R8X8);
@@ -394,7 +418,7 @@ nsJPEGDecoder::ReadJPEGData(const char* aData, size_t aLength)
     MOZ_ASSERT(mImageData, "Should have a buffer now");
 
     if (mDownscaler) {
-      nsresult rv = mDownscaler->BeginFrame(Size(), Nothing(),
+      nsresult rv = mDownscaler->BeginFrame(scaledSize, Nothing(),
                                             mImageData,
                                             /* aHasAlpha = */ false);
       if (NS_FAILED(rv)) {
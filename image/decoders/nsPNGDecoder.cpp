@@ -12,6 +12,7 @@
 
 #include "gfxColor.h"
 #include "gfxPlatform.h"
+#include "mozilla/gfx/Swizzle.h"
 #include "imgFrame.h"
 #include "nsColor.h"
 #include "nsIInputStream.h"
@@ -113,6 +114,7 @@ nsPNGDecoder::nsPNGDecoder(RasterImage* aImage)
  , mInfo(nullptr)
  , mCMSLine(nullptr)
  , interlacebuf(nullptr)
+ , mPackedRow(nullptr)
  , mInProfile(nullptr)
  , mTransform(nullptr)
  , mFormat(SurfaceFormat::UNKNOWN)
@@ -135,6 +137,9 @@ nsPNGDecoder::~nsPNGDecoder()
   if (interlacebuf) {
     free(interlacebuf);
   }
+  if (mPackedRow) {
+    free(mPackedRow);
+  }
   if (mInProfile) {
     qcms_profile_release(mInProfile);
 
@@ -741,6 +746,17 @@ nsPNGDecoder::info_callback(png_structp png_ptr, png_infop info_ptr)
     }
   }
 
+  // Rows with alpha are converted to BGRA a whole row at a time, which needs
+  // a buffer to hold the result. (Rows without alpha are packed one pixel at a
+  // time, as there is no row routine we could use for three byte pixels.)
+  if (decoder->HasAlphaChannel() && !decoder->mPackedRow) {
+    decoder->mPackedRow =
+      static_cast<uint32_t*>(malloc(sizeof(uint32_t) * width));
+    if (!decoder->mPackedRow) {
+      png_error(decoder->mPNG, "malloc of mPackedRow failed");
+    }
+  }
+
   if (interlace_type == PNG_INTERLACE_ADAM7) {
     if (frameRect.height < INT32_MAX / (frameRect.width * int32_t(channels))) {
       const size_t bufferSize = channels * frameRect.width * frameRect.height;
@@ -779,25 +795,6 @@ PackRGBPixelAndAdvance(uint8_t*& aRawPixelInOut)
   return AsVariant(pixel);
 }
 
-static NextPixel<uint32_t>
-PackRGBAPixelAndAdvance(uint8_t*& aRawPixelInOut)
-{
-  const uint32_t pixel =
-    gfxPackedPixel(aRawPixelInOut[3], aRawPixelInOut[0],
-                   aRawPixelInOut[1], aRawPixelInOut[2]);
-  aRawPixelInOut += 4;
-  return AsVariant(pixel);
-}
-
-static NextPixel<uint32_t>
-PackUnpremultipliedRGBAPixelAndAdvance(uint8_t*& aRawPixelInOut)
-{
-  const uint32_t pixel =
-    gfxPackedPixelNoPreMultiply(aRawPixelInOut[3], aRawPixelInOut[0],
-                                aRawPixelInOut[1], aRawPixelInOut[2]);
-  aRawPixelInOut += 4;
-  return AsVariant(pixel);
-}
 
 void
 nsPNGDecoder::row_callback(png_structp png_ptr, png_bytep new_row,
@@ -905,15 +902,19 @@ nsPNGDecoder::WriteRow(uint8_t* aRow)
   // Write this row to the SurfacePipe.
   DebugOnly<WriteState> result;
   if (HasAlphaChannel()) {
+    // The row is RGBA at this point, either straight from libpng or from
+    // mCMSLine. Convert it with the SIMD row routines of Moz2D.
+    MOZ_ASSERT(mPackedRow);
+    const IntSize rowSize(width, 1);
+    uint8_t* packedRow = reinterpret_cast<uint8_t*>(mPackedRow);
     if (mDisablePremultipliedAlpha) {
-      result = mPipe.WritePixelsToRow<uint32_t>([&]{
-        return PackUnpremultipliedRGBAPixelAndAdvance(rowToWrite);
-      });
+      SwizzleData(rowToWrite, width * 4, SurfaceFormat::R8G8B8A8,
+                  packedRow, width * 4, SurfaceFormat::B8G8R8A8, rowSize);
     } else {
-      result = mPipe.WritePixelsToRow<uint32_t>([&]{
-        return PackRGBAPixelAndAdvance(rowToWrite);
-      });
+      PremultiplyData(rowToWrite, width * 4, SurfaceFormat::R8G8B8A8,
+                      packedRow, width * 4, SurfaceFormat::B8G8R8A8, rowSize);
     }
+    result = mPipe.WriteBuffer(mPackedRow);
   } else {
     result = mPipe.WritePixelsToRow<uint32_t>([&]{
       return PackRGBPixelAndAdvance(rowToWrite);
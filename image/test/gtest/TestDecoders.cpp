@@ -3,6 +3,7 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
 
 #include "gtest/gtest.h"
+#include "gtest/MozGTestBench.h" // For MOZ_GTEST_BENCH
 
 #include "Common.h"
 #include "Decoder.h"
@@ -254,6 +255,18 @@ TEST_F(ImageDecoders, JPGDownscaleDuringDecode)
   CheckDownscaleDuringDecode(DownscaledJPGTestCase());
 }
 
+TEST_F(ImageDecoders, JPGDownscaleInIDCT)
+{
+  // 100x100 to 25x25 is done entirely by libjpeg, without a Downscaler.
+  ImageTestCase testCase = GreenJPGTestCase();
+  testCase.mOutputSize = IntSize(25, 25);
+
+  WithSingleChunkDecode(testCase, Some(testCase.mOutputSize),
+                        [&](Decoder* aDecoder) {
+    CheckDecoderResults(testCase, aDecoder);
+  });
+}
+
 TEST_F(ImageDecoders, BMPSingleChunk)
 {
   CheckDecoderSingleChunk(GreenBMPTestCase());
@@ -776,3 +789,29 @@ TEST_F(ImageDecoders, MultipleSizesICOSingleChunk)
     EXPECT_EQ(expectedSizes[i], nativeSizes[i]);
   }
 }
+
+// Decode time of a JPEG at its own size and at the sizes a thumbnail of it
+// may be drawn at, which libjpeg can mostly or entirely produce in the IDCT.
+static void
+BenchJPGDecode(const Maybe<IntSize>& aOutputSize)
+{
+  AutoInitializeImageLib init;
+  for (int i = 0; i < 100; ++i) {
+    WithSingleChunkDecode(DownscaledJPGTestCase(), aOutputSize,
+                          [](Decoder* aDecoder) {
+      EXPECT_TRUE(aDecoder->GetDecodeDone());
+    });
+  }
+}
+
+MOZ_GTEST_BENCH(ImageDecoders, JPGDecodeFullSize, [] {
+  BenchJPGDecode(Nothing());
+});
+
+MOZ_GTEST_BENCH(ImageDecoders, JPGDecodeDownscaled, [] {
+  BenchJPGDecode(Some(IntSize(20, 20)));
+});
+
+MOZ_GTEST_BENCH(ImageDecoders, JPGDecodeDownscaledInIDCT, [] {
+  BenchJPGDecode(Some(IntSize(25, 25)));
+});
@@ -57,6 +57,10 @@ class Channel {
 
     // Maximum size of a message that we allow to be copied (rather than moved).
     kMaxCopySize = 32 * 1024,
+
+    // Messages at least this big are handed over in a shared memory segment
+    // rather than written to the pipe, where the platform supports it.
+    kShmemMessageThreshold = 256 * 1024,
   };
 
   // Initialize a Channel.
@@ -169,6 +173,14 @@ class Channel {
     RECEIVED_FDS_MESSAGE_TYPE = kuint16max - 1,
 #endif
 
+#if defined(OS_POSIX)
+    // A message of kShmemMessageThreshold bytes or more can be replaced with
+    // this one, which carries a file descriptor for a shared memory segment
+    // holding the original message, and its size. The receiving channel
+    // unwraps it before handing it to its listener.
+    SHMEM_MESSAGE_TYPE = kuint16max - 2,
+#endif
+
     // The Hello message is internal to the Channel class.  It is sent
     // by the peer when the channel is connected.  The message contains
     // just the process id (pid).  The message has a special routing_id
@@ -28,6 +28,7 @@
 #include "base/lock.h"
 #include "base/logging.h"
 #include "base/process_util.h"
+#include "base/shared_memory.h"
 #include "base/string_util.h"
 #include "base/singleton.h"
 #include "chrome/common/chrome_switches.h"
@@ -555,6 +556,13 @@ bool Channel::ChannelImpl::ProcessIncomingMessages() {
         DCHECK(m.fd_cookie() != 0);
         CloseDescriptors(m.fd_cookie());
 #endif
+      } else if (m.routing_id() == MSG_ROUTING_NONE &&
+                 m.type() == SHMEM_MESSAGE_TYPE) {
+        if (!ReceiveSharedMemoryMessage(m)) {
+          CHROMIUM_LOG(ERROR) << "invalid shared memory message"
+                              << " channel:" << this;
+          return false;
+        }
       } else {
         listener_->OnMessageReceived(mozilla::Move(m));
       }
@@ -576,6 +584,82 @@ bool Channel::ChannelImpl::ProcessIncomingMessages() {
   return true;
 }
 
+// Unwrap a SHMEM_MESSAGE_TYPE message built by MoveToSharedMemory and pass
+// the original message on to the listener.
+bool Channel::ChannelImpl::ReceiveSharedMemoryMessage(const Message& wrapper) {
+  PickleIterator iter(wrapper);
+  uint32_t size;
+  base::FileDescriptor descriptor;
+  if (!wrapper.ReadUInt32(&iter, &size) ||
+      !wrapper.ReadFileDescriptor(&iter, &descriptor)) {
+    return false;
+  }
+
+  // The descriptor is ours to close from here on. Only messages of at least
+  // kShmemMessageThreshold bytes are sent this way, which also guarantees
+  // there is room for any header.
+  struct stat st;
+  if (fstat(descriptor.fd, &st) != 0 ||
+      size < kShmemMessageThreshold || size > kMaximumMessageSize ||
+      static_cast<uint64_t>(st.st_size) < size) {
+    HANDLE_EINTR(close(descriptor.fd));
+    return false;
+  }
+
+  base::SharedMemory shmem;
+  descriptor.auto_close = true;
+  if (!shmem.SetHandle(descriptor, /* read_only = */ true)) {
+    HANDLE_EINTR(close(descriptor.fd));
+    return false;
+  }
+  if (!shmem.Map(size)) {
+    return false;
+  }
+
+  // Nothing stops a misbehaving sender from still writing to the segment,
+  // so only validate the copy.
+  Message m(static_cast<const char*>(shmem.memory()), size);
+  if (m.size() != size || m.header()->num_fds ||
+      (m.routing_id() == MSG_ROUTING_NONE &&
+       m.type() == SHMEM_MESSAGE_TYPE)) {
+    return false;
+  }
+
+  listener_->OnMessageReceived(mozilla::Move(m));
+  return true;
+}
+
+// Copy |message| into a new shared memory segment, and return a small
+// SHMEM_MESSAGE_TYPE message to send in its place. Returns null if the
+// segment couldn't be created, in which case |message| is written to the pipe
+// as usual.
+Message* Channel::ChannelImpl::MoveToSharedMemory(const Message& message) {
+  uint32_t size = message.size();
+
+  base::SharedMemory shmem;
+  if (!shmem.Create("", /* read_only = */ false, /* open_existing = */ false,
+                    size) ||
+      !shmem.Map(size)) {
+    return nullptr;
+  }
+
+  Pickle::BufferList::IterImpl iter(message.Buffers());
+  if (!message.Buffers().ReadBytes(iter, static_cast<char*>(shmem.memory()),
+                                   size)) {
+    return nullptr;
+  }
+
+  base::SharedMemoryHandle handle;
+  if (!shmem.GiveToProcess(base::GetCurrentProcId(), &handle)) {
+    return nullptr;
+  }
+
+  Message* wrapper = new Message(MSG_ROUTING_NONE, SHMEM_MESSAGE_TYPE);
+  wrapper->WriteUInt32(size);
+  wrapper->WriteFileDescriptor(handle);
+  return wrapper;
+}
+
 bool Channel::ChannelImpl::ProcessOutgoingMessages() {
   DCHECK(!waiting_connect_);  // Why are we trying to send messages if there's
                               // no connection?
@@ -768,6 +852,20 @@ bool Channel::ChannelImpl::Send(Message* message) {
     return false;
   }
 
+#if defined(OS_LINUX) && !defined(ANDROID)
+  // Large messages would otherwise go through the pipe in small chunks, and
+  // be reassembled on the other side. This is limited to platforms where
+  // shared memory is backed by /dev/shm; if a segment can't be created there,
+  // e.g. because of sandboxing, the message goes through the pipe. Messages
+  // that already carry descriptors are left alone.
+  if (message->size() >= kShmemMessageThreshold && message->num_fds() == 0) {
+    if (Message* wrapper = MoveToSharedMemory(*message)) {
+      delete message;
+      message = wrapper;
+    }
+  }
+#endif
+
   OutputQueuePush(message);
   if (!waiting_connect_) {
     if (!is_blocked_on_write_) {
@@ -64,6 +64,9 @@ class Channel::ChannelImpl : public MessageLoopForIO::Watcher {
   bool ProcessIncomingMessages();
   bool ProcessOutgoingMessages();
 
+  Message* MoveToSharedMemory(const Message& message);
+  bool ReceiveSharedMemoryMessage(const Message& wrapper);
+
   // MessageLoopForIO::Watcher implementation.
   virtual void OnFileCanReadWithoutBlocking(int fd);
   virtual void OnFileCanWriteWithoutBlocking(int fd);
@@ -0,0 +1,109 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef mozilla_ipc_IPCBuffer_h
+#define mozilla_ipc_IPCBuffer_h
+
+#include "mozilla/Assertions.h"
+#include "mozilla/BufferList.h"
+#include "mozilla/mozalloc.h"
+#include "mozilla/Move.h"
+
+namespace IPC {
+template<typename T> struct ParamTraits;
+}
+
+namespace mozilla {
+namespace ipc {
+
+// A read-only byte buffer for large payloads sent over IPC.
+//
+// nsTArray<uint8_t> is copied out of the message into a fresh allocation when
+// it is read. An IPCBuffer instead takes the message's own buffer segments
+// holding the data, so only the partial segments at either end are copied.
+// The bytes are therefore not contiguous; use Buffers() to iterate over
+// them, or CopyTo() to flatten them.
+//
+//   // in ipdl file
+//   using mozilla::ipc::IPCBuffer from "mozilla/ipc/IPCBuffer.h";
+//   async Data(IPCBuffer aData);
+class IPCBuffer final
+{
+public:
+  typedef BufferList<InfallibleAllocPolicy> BufferListType;
+
+  IPCBuffer()
+    : mBuffers(0, 0, kSegmentCapacity)
+    , mLength(0)
+  {}
+
+  // Copies aLength bytes from aData.
+  IPCBuffer(const char* aData, size_t aLength)
+    : mBuffers(0, 0, kSegmentCapacity)
+    , mLength(aLength)
+  {
+    static const char kPadding[kAlignment] = {};
+    MOZ_ALWAYS_TRUE(mBuffers.WriteBytes(aData, aLength));
+    MOZ_ALWAYS_TRUE(mBuffers.WriteBytes(kPadding, PaddedLength(aLength) - aLength));
+  }
+
+  IPCBuffer(IPCBuffer&& aOther)
+    : mBuffers(Move(aOther.mBuffers))
+    , mLength(aOther.mLength)
+  {
+    aOther.mLength = 0;
+  }
+
+  IPCBuffer& operator=(IPCBuffer&& aOther)
+  {
+    mBuffers = Move(aOther.mBuffers);
+    mLength = aOther.mLength;
+    aOther.mLength = 0;
+    return *this;
+  }
+
+  IPCBuffer(const IPCBuffer&) = delete;
+  IPCBuffer& operator=(const IPCBuffer&) = delete;
+
+  size_t Length() const { return mLength; }
+
+  // The data followed by up to kAlignment - 1 bytes of padding, which
+  // callers iterating over the segments need to stop short of.
+  const BufferListType& Buffers() const { return mBuffers; }
+
+  // Copies the Length() bytes of data to aDest.
+  void CopyTo(char* aDest) const
+  {
+    BufferListType::IterImpl iter(mBuffers);
+    MOZ_ALWAYS_TRUE(mBuffers.ReadBytes(iter, aDest, mLength));
+  }
+
+private:
+  friend struct IPC::ParamTraits<IPCBuffer>;
+
+  // Segments are written to and extracted from messages with 8-byte
+  // alignment, so they all need to be a multiple of it in size.
+  static const size_t kAlignment = sizeof(uint64_t);
+  static const size_t kSegmentCapacity = 4096;
+
+  static size_t PaddedLength(size_t aLength)
+  {
+    return (aLength + kAlignment - 1) & ~(kAlignment - 1);
+  }
+
+  IPCBuffer(BufferListType&& aBuffers, size_t aLength)
+    : mBuffers(Move(aBuffers))
+    , mLength(aLength)
+  {}
+
+  BufferListType mBuffers;
+  size_t mLength;
+};
+
+} // namespace ipc
+} // namespace mozilla
+
+#endif // mozilla_ipc_IPCBuffer_h
@@ -13,6 +13,7 @@
 #include "mozilla/ArrayUtils.h"
 #include "mozilla/Attributes.h"
 #include "mozilla/DebugOnly.h"
+#include "mozilla/ipc/IPCBuffer.h"
 #include "mozilla/dom/ipc/StructuredCloneData.h"
 #include "mozilla/Maybe.h"
 #include "mozilla/net/WebSocketFrame.h"
@@ -862,6 +863,56 @@ struct ParamTraits<mozilla::SerializedStructuredCloneBuffer>
   }
 };
 
+template <>
+struct ParamTraits<mozilla::ipc::IPCBuffer>
+{
+  typedef mozilla::ipc::IPCBuffer paramType;
+
+  static void Write(Message* aMsg, const paramType& aParam)
+  {
+    MOZ_RELEASE_ASSERT(aParam.Length() == uint32_t(aParam.Length()));
+    WriteParam(aMsg, uint32_t(aParam.Length()));
+    const paramType::BufferListType& buffers = aParam.Buffers();
+    auto iter = buffers.Iter();
+    while (!iter.Done()) {
+      MOZ_ASSERT(!(iter.RemainingInSegment() % paramType::kAlignment));
+      aMsg->WriteBytes(iter.Data(), iter.RemainingInSegment(),
+                       paramType::kAlignment);
+      iter.Advance(buffers, iter.RemainingInSegment());
+    }
+  }
+
+  static bool Read(const Message* aMsg, PickleIterator* aIter, paramType* aResult)
+  {
+    uint32_t length;
+    if (!ReadParam(aMsg, aIter, &length)) {
+      return false;
+    }
+
+    size_t paddedLength = paramType::PaddedLength(length);
+    if (paddedLength < length) {
+      return false;
+    }
+
+    // Unlike JSStructuredCloneData, the data is moved rather than borrowed
+    // out of the message, so it can outlive it.
+    paramType::BufferListType buffers(0, 0, paramType::kSegmentCapacity);
+    if (paddedLength &&
+        !aMsg->ExtractBuffers(aIter, paddedLength, &buffers,
+                              paramType::kAlignment)) {
+      return false;
+    }
+
+    *aResult = paramType(mozilla::Move(buffers), length);
+    return true;
+  }
+
+  static void Log(const paramType& aParam, std::wstring* aLog)
+  {
+    LogParam(aParam.Length(), aLog);
+  }
+};
+
 template <>
 struct ParamTraits<nsIWidget::TouchPointerState>
   : public BitFlagsEnumSerializer<nsIWidget::TouchPointerState,
@@ -0,0 +1,151 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "gtest/gtest.h"
+#include "gtest/MozGTestBench.h" // For MOZ_GTEST_BENCH
+
+#include "ipc/IPCMessageUtils.h"
+#include "mozilla/ipc/IPCBuffer.h"
+#include "mozilla/UniquePtr.h"
+
+using namespace mozilla;
+using mozilla::ipc::IPCBuffer;
+
+static void
+FillBytes(char* aData, size_t aLength)
+{
+  for (size_t i = 0; i < aLength; i++) {
+    aData[i] = char(i * 7 + aLength);
+  }
+}
+
+static IPCBuffer
+MakeBuffer(size_t aLength)
+{
+  UniquePtr<char[]> data(new char[aLength + 1]);
+  FillBytes(data.get(), aLength);
+  return IPCBuffer(data.get(), aLength);
+}
+
+static void
+CheckBuffer(const IPCBuffer& aBuffer, size_t aLength)
+{
+  ASSERT_EQ(aLength, aBuffer.Length());
+  UniquePtr<char[]> expected(new char[aLength + 1]);
+  UniquePtr<char[]> actual(new char[aLength + 1]);
+  FillBytes(expected.get(), aLength);
+  aBuffer.CopyTo(actual.get());
+  ASSERT_EQ(0, memcmp(expected.get(), actual.get(), aLength));
+}
+
+TEST(IPCSerialization, IPCBuffer)
+{
+  static const size_t kLengths[] = {
+    0, 1, 7, 8, 9, 4095, 4096, 4097, 100003, 1024 * 1024
+  };
+
+  for (size_t length : kLengths) {
+    // Put an int before and after the buffer so that it's not aligned on
+    // a segment, and so that reading past it can be checked.
+    IPC::Message msg(MSG_ROUTING_NONE, 0);
+    IPC::WriteParam(&msg, uint32_t(1));
+    IPC::WriteParam(&msg, MakeBuffer(length));
+    IPC::WriteParam(&msg, MakeBuffer(length / 2));
+    IPC::WriteParam(&msg, uint32_t(2));
+
+    PickleIterator iter(msg);
+    uint32_t before = 0, after = 0;
+    IPCBuffer buffer, buffer2;
+    ASSERT_TRUE(IPC::ReadParam(&msg, &iter, &before));
+    ASSERT_TRUE(IPC::ReadParam(&msg, &iter, &buffer));
+    ASSERT_TRUE(IPC::ReadParam(&msg, &iter, &buffer2));
+    ASSERT_TRUE(IPC::ReadParam(&msg, &iter, &after));
+    ASSERT_EQ(1u, before);
+    ASSERT_EQ(2u, after);
+    CheckBuffer(buffer, length);
+    CheckBuffer(buffer2, length / 2);
+  }
+}
+
+TEST(IPCSerialization, Arrays)
+{
+  IPC::Message msg(MSG_ROUTING_NONE, 0);
+
+  nsTArray<uint32_t> ints;
+  for (uint32_t i = 0; i < 1000; i++) {
+    ints.AppendElement(i * i);
+  }
+  nsTArray<nsCString> strings;
+  for (uint32_t i = 0; i < 100; i++) {
+    strings.AppendElement()->AppendInt(i);
+  }
+  nsString string(NS_LITERAL_STRING("wide string"));
+  IPC::WriteParam(&msg, ints);
+  IPC::WriteParam(&msg, strings);
+  IPC::WriteParam(&msg, string);
+
+  PickleIterator iter(msg);
+  nsTArray<uint32_t> readInts;
+  nsTArray<nsCString> readStrings;
+  nsString readString;
+  ASSERT_TRUE(IPC::ReadParam(&msg, &iter, &readInts));
+  ASSERT_TRUE(IPC::ReadParam(&msg, &iter, &readStrings));
+  ASSERT_TRUE(IPC::ReadParam(&msg, &iter, &readString));
+  ASSERT_EQ(ints, readInts);
+  ASSERT_EQ(strings, readStrings);
+  ASSERT_TRUE(string.Equals(readString));
+}
+
+static const size_t kBenchLength = 4 * 1024 * 1024;
+
+MOZ_GTEST_BENCH(IPCSerialization, ByteArray4MB, [] {
+  nsTArray<uint8_t> data;
+  data.SetLength(kBenchLength);
+  FillBytes(reinterpret_cast<char*>(data.Elements()), kBenchLength);
+  for (int i = 0; i < 10; i++) {
+    IPC::Message msg(MSG_ROUTING_NONE, 0);
+    IPC::WriteParam(&msg, data);
+    PickleIterator iter(msg);
+    nsTArray<uint8_t> result;
+    ASSERT_TRUE(IPC::ReadParam(&msg, &iter, &result));
+  }
+});
+
+MOZ_GTEST_BENCH(IPCSerialization, IPCBuffer4MB, [] {
+  IPCBuffer data = MakeBuffer(kBenchLength);
+  for (int i = 0; i < 10; i++) {
+    IPC::Message msg(MSG_ROUTING_NONE, 0);
+    IPC::WriteParam(&msg, data);
+    PickleIterator iter(msg);
+    IPCBuffer result;
+    ASSERT_TRUE(IPC::ReadParam(&msg, &iter, &result));
+  }
+});
+
+MOZ_GTEST_BENCH(IPCSerialization, String4MB, [] {
+  nsCString data;
+  data.SetLength(kBenchLength);
+  FillBytes(data.BeginWriting(), kBenchLength);
+  for (int i = 0; i < 10; i++) {
+    IPC::Message msg(MSG_ROUTING_NONE, 0);
+    IPC::WriteParam(&msg, data);
+    PickleIterator iter(msg);
+    nsCString result;
+    ASSERT_TRUE(IPC::ReadParam(&msg, &iter, &result));
+  }
+});
+
+MOZ_GTEST_BENCH(IPCSerialization, StringArray, [] {
+  nsTArray<nsCString> data;
+  for (uint32_t i = 0; i < 100000; i++) {
+    data.AppendElement()->AppendInt(i);
+  }
+  IPC::Message msg(MSG_ROUTING_NONE, 0);
+  IPC::WriteParam(&msg, data);
+  PickleIterator iter(msg);
+  nsTArray<nsCString> result;
+  ASSERT_TRUE(IPC::ReadParam(&msg, &iter, &result));
+});
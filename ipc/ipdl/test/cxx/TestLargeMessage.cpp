@@ -0,0 +1,113 @@
+#include "TestLargeMessage.h"
+
+#include "IPDLUnitTests.h"      // fail etc.
+#include "chrome/common/ipc_channel.h"
+#include "mozilla/ArrayUtils.h"
+
+namespace mozilla {
+namespace _ipdltest {
+
+// Sizes around IPC::Channel::kShmemMessageThreshold, so that messages are
+// sent both through the pipe and through shared memory where supported.
+static const size_t kSizes[] = {
+    IPC::Channel::kShmemMessageThreshold - 1024,
+    IPC::Channel::kShmemMessageThreshold,
+    4 * 1024 * 1024 + 3,
+};
+
+static void
+Fill(nsCString& aData, size_t aSize)
+{
+    aData.SetLength(aSize);
+    char* data = aData.BeginWriting();
+    for (size_t i = 0; i < aSize; i++) {
+        data[i] = char(i * 7 + aSize);
+    }
+}
+
+static bool
+Check(const nsCString& aData, size_t aSize)
+{
+    if (aData.Length() != aSize) {
+        return false;
+    }
+    const char* data = aData.BeginReading();
+    for (size_t i = 0; i < aSize; i++) {
+        if (data[i] != char(i * 7 + aSize)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+// parent
+
+TestLargeMessageParent::TestLargeMessageParent()
+  : mIndex(0)
+{
+    MOZ_COUNT_CTOR(TestLargeMessageParent);
+}
+
+TestLargeMessageParent::~TestLargeMessageParent()
+{
+    MOZ_COUNT_DTOR(TestLargeMessageParent);
+}
+
+void
+TestLargeMessageParent::Main()
+{
+    if (!SendNext())
+        fail("sending Data");
+}
+
+bool
+TestLargeMessageParent::SendNext()
+{
+    nsCString data;
+    Fill(data, kSizes[mIndex]);
+    return SendData(data);
+}
+
+mozilla::ipc::IPCResult
+TestLargeMessageParent::RecvDataBack(const nsCString& data)
+{
+    if (!Check(data, kSizes[mIndex]))
+        fail("invalid data of length %u", unsigned(data.Length()));
+
+    if (++mIndex < ArrayLength(kSizes)) {
+        if (!SendNext())
+            fail("sending Data");
+        return IPC_OK();
+    }
+
+    Close();
+
+    return IPC_OK();
+}
+
+
+//-----------------------------------------------------------------------------
+// child
+
+TestLargeMessageChild::TestLargeMessageChild()
+{
+    MOZ_COUNT_CTOR(TestLargeMessageChild);
+}
+
+TestLargeMessageChild::~TestLargeMessageChild()
+{
+    MOZ_COUNT_DTOR(TestLargeMessageChild);
+}
+
+mozilla::ipc::IPCResult
+TestLargeMessageChild::RecvData(const nsCString& data)
+{
+    if (!SendDataBack(data))
+        fail("sending DataBack");
+    return IPC_OK();
+}
+
+
+} // namespace _ipdltest
+} // namespace mozilla
@@ -0,0 +1,66 @@
+#ifndef mozilla__ipdltest_TestLargeMessage_h
+#define mozilla__ipdltest_TestLargeMessage_h 1
+
+#include "mozilla/_ipdltest/IPDLUnitTests.h"
+
+#include "mozilla/_ipdltest/PTestLargeMessageParent.h"
+#include "mozilla/_ipdltest/PTestLargeMessageChild.h"
+
+namespace mozilla {
+namespace _ipdltest {
+
+
+class TestLargeMessageParent :
+    public PTestLargeMessageParent
+{
+public:
+    TestLargeMessageParent();
+    virtual ~TestLargeMessageParent();
+
+    static bool RunTestInProcesses() { return true; }
+    static bool RunTestInThreads() { return true; }
+
+    void Main();
+
+protected:
+    virtual mozilla::ipc::IPCResult RecvDataBack(const nsCString& data) override;
+
+    virtual void ActorDestroy(ActorDestroyReason why) override
+    {
+        if (NormalShutdown != why)
+            fail("unexpected destruction!");
+        passed("ok");
+        QuitParent();
+    }
+
+private:
+    bool SendNext();
+
+    size_t mIndex;
+};
+
+
+class TestLargeMessageChild :
+    public PTestLargeMessageChild
+{
+public:
+    TestLargeMessageChild();
+    virtual ~TestLargeMessageChild();
+
+protected:
+    virtual mozilla::ipc::IPCResult RecvData(const nsCString& data) override;
+
+    virtual void ActorDestroy(ActorDestroyReason why) override
+    {
+        if (NormalShutdown != why)
+            fail("unexpected destruction!");
+        QuitChild();
+    }
+};
+
+
+} // namespace _ipdltest
+} // namespace mozilla
+
+
+#endif // ifndef mozilla__ipdltest_TestLargeMessage_h
@@ -510,12 +510,14 @@ struct RuntimeSizes
     macro(_, MallocHeap, atomsMarkBitmaps) \
     macro(_, MallocHeap, contexts) \
     macro(_, MallocHeap, temporary) \
+    macro(_, MallocHeap, lifoChunkPool) \
     macro(_, MallocHeap, interpreterStack) \
     macro(_, MallocHeap, mathCache) \
     macro(_, MallocHeap, sharedImmutableStringsCache) \
     macro(_, MallocHeap, sharedIntlData) \
     macro(_, MallocHeap, uncompressedSourceCache) \
     macro(_, MallocHeap, scriptData) \
+    macro(_, MallocHeap, regExpCodeCache) \
     macro(_, MallocHeap, tracelogger)
 
     RuntimeSizes()
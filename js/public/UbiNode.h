@@ -1001,6 +1001,39 @@ class MOZ_STACK_CLASS JS_PUBLIC_API(RootList) {
 };
 
 
+/*** Progress of Long-Running Analyses ************************************************************/
+
+// Analyses of large heap graphs, such as a census or the computation of a
+// dominator tree, can run for a long time. Embedders running them against an
+// offline graph on a background thread can pass a ProgressCallback to be told
+// how far along the analysis is, and to abandon it.
+//
+// The analysis calls |report| every |interval| units of work. |phase| is a
+// static string naming the current phase of the analysis, |done| is the work
+// done so far in that phase and |total| is the total work of the phase, or 0
+// if it is not known up front. If |report| returns false, the analysis stops
+// and fails as it would on OOM; the callback should remember that it asked
+// for cancellation if the caller needs to tell the two apart.
+class ProgressCallback {
+  public:
+    const uint64_t interval;
+
+    explicit ProgressCallback(uint64_t interval = 1 << 16)
+      : interval(interval)
+    {
+        MOZ_ASSERT(interval > 0);
+    }
+    virtual ~ProgressCallback() { }
+
+    virtual MOZ_MUST_USE bool report(const char* phase, uint64_t done, uint64_t total) = 0;
+
+    // Call |report| if |done| is a multiple of |interval|.
+    MOZ_MUST_USE bool maybeReport(const char* phase, uint64_t done, uint64_t total) {
+        return done % interval != 0 || report(phase, done, total);
+    }
+};
+
+
 /*** Concrete classes for ubi::Node referent types ************************************************/
 
 template<>
@@ -84,7 +84,7 @@ struct BreadthFirst {
     // We do nothing with noGC, other than require it to exist, with a lifetime
     // that encloses our own.
     BreadthFirst(JSContext* cx, Handler& handler, const JS::AutoCheckCannotGC& noGC)
-      : wantNames(true), cx(cx), visited(), handler(handler), pending(),
+      : wantNames(true), progress(nullptr), cx(cx), visited(), handler(handler), pending(),
         traversalBegun(false), stopRequested(false), abandonRequested(false)
     { }
 
@@ -108,6 +108,10 @@ struct BreadthFirst {
     // expensive in time and memory. True by default.
     bool wantNames;
 
+    // If non-null, told about the number of nodes reached so far. If it asks
+    // to cancel the traversal, |traverse| returns false.
+    ProgressCallback* progress;
+
     // Traverse the graph in breadth-first order, starting at the given
     // start nodes, applying |handler::operator()| for each edge traversed
     // as described above.
@@ -143,6 +147,9 @@ struct BreadthFirst {
                     // Mark it as visited.
                     if (!visited.add(a, edge.referent, typename Handler::NodeData()))
                         return false;
+
+                    if (progress && !progress->maybeReport("traversal", visited.count(), 0))
+                        return false;
                 }
 
                 MOZ_ASSERT(a);
@@ -325,7 +325,8 @@ class JS_PUBLIC_API(DominatorTree)
     // predecessor sets.
     static MOZ_MUST_USE bool doTraversal(JSContext* cx, AutoCheckCannotGC& noGC, const Node& root,
                                          JS::ubi::Vector<Node>& postOrder,
-                                         PredecessorSets& predecessorSets) {
+                                         PredecessorSets& predecessorSets,
+                                         ProgressCallback* progress) {
         uint32_t nodeCount = 0;
         auto onNode = [&](const Node& node) {
             nodeCount++;
@@ -349,7 +350,7 @@ class JS_PUBLIC_API(DominatorTree)
             return p->value()->put(origin);
         };
 
-        PostOrder traversal(cx, noGC);
+        PostOrder traversal(cx, noGC, progress);
         return traversal.init() &&
                traversal.addStart(root) &&
                traversal.traverse(onNode, onEdge);
@@ -509,15 +510,23 @@ class JS_PUBLIC_API(DominatorTree)
      * that embedders with knowledge of the graph's implementation will do the
      * Right Thing.
      *
-     * Returns `mozilla::Nothing()` on OOM failure. It is the caller's
-     * responsibility to handle and report the OOM.
+     * If `progress` is non-null, it is told about the progress of the
+     * "traversal" of the graph and of each pass of the "dominators" fixed
+     * point computation, over the nodes in post order.
+     *
+     * Returns `mozilla::Nothing()` on OOM failure, or if `progress` asked to
+     * cancel. It is the caller's responsibility to handle and report the OOM.
      */
     static mozilla::Maybe<DominatorTree>
-    Create(JSContext* cx, AutoCheckCannotGC& noGC, const Node& root) {
+    Create(JSContext* cx, AutoCheckCannotGC& noGC, const Node& root,
+           ProgressCallback* progress = nullptr) {
         JS::ubi::Vector<Node> postOrder;
         PredecessorSets predecessorSets;
-        if (!predecessorSets.init() || !doTraversal(cx, noGC, root, postOrder, predecessorSets))
+        if (!predecessorSets.init() ||
+            !doTraversal(cx, noGC, root, postOrder, predecessorSets, progress))
+        {
             return mozilla::Nothing();
+        }
 
         MOZ_ASSERT(postOrder.length() < UINT32_MAX);
         uint32_t length = postOrder.length();
@@ -550,6 +559,9 @@ class JS_PUBLIC_API(DominatorTree)
             for (uint32_t indexPlusOne = length - 1; indexPlusOne > 0; indexPlusOne--) {
                 MOZ_ASSERT(postOrder[indexPlusOne - 1] != root);
 
+                if (progress && !progress->maybeReport("dominators", length - indexPlusOne, length))
+                    return mozilla::Nothing();
+
                 // Take the intersection of every predecessor's dominator set;
                 // that is the current best guess at the immediate dominator for
                 // this node.
@@ -86,6 +86,7 @@ struct PostOrder {
     JSContext*               cx;
     Set                      seen;
     Stack                    stack;
+    ProgressCallback*        progress;
 #ifdef DEBUG
     bool                     traversed;
 #endif
@@ -115,10 +116,14 @@ struct PostOrder {
     // The traversal asserts that no GC happens in its runtime during its
     // lifetime via the `AutoCheckCannotGC&` parameter. We do nothing with it,
     // other than require it to exist with a lifetime that encloses our own.
-    PostOrder(JSContext* cx, AutoCheckCannotGC&)
+    //
+    // If `progress` is non-null, it is told about the number of nodes seen so
+    // far. If it asks to cancel the traversal, `traverse` returns false.
+    PostOrder(JSContext* cx, AutoCheckCannotGC&, ProgressCallback* progress = nullptr)
       : cx(cx)
       , seen()
       , stack()
+      , progress(progress)
 #ifdef DEBUG
       , traversed(false)
 #endif
@@ -179,6 +184,9 @@ struct PostOrder {
             {
                 return false;
             }
+
+            if (progress && !progress->maybeReport("traversal", seen.count(), 0))
+                return false;
         }
 
         return true;
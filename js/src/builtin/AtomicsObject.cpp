@@ -49,6 +49,7 @@
 
 #include "mozilla/Atomics.h"
 #include "mozilla/FloatingPoint.h"
+#include "mozilla/HashFunctions.h"
 #include "mozilla/Maybe.h"
 #include "mozilla/ScopeExit.h"
 #include "mozilla/Unused.h"
@@ -697,34 +698,52 @@ namespace js {
 
 // Represents one waiting worker.
 //
-// The type is declared opaque in SharedArrayObject.h.  Instances of
-// js::FutexWaiter are stack-allocated and linked onto a list across a
-// call to FutexThread::wait().
+// Instances of js::FutexWaiter are stack-allocated and linked onto a list
+// across a call to FutexThread::wait().
 //
-// The 'waiters' field of the SharedArrayRawBuffer points to the highest
-// priority waiter in the list, and lower priority nodes are linked through
-// the 'lower_pri' field.  The 'back' field goes the other direction.
-// The list is circular, so the 'lower_pri' field of the lowest priority
-// node points to the first node in the list.  The list has no dedicated
-// header node.
+// Waiters are not kept per buffer but in a fixed table of buckets, hashed
+// by the address they wait on, so that Atomics.wake only visits the
+// waiters that may be waiting on its address.  Distinct raw buffers never
+// overlap and a waiter keeps its buffer alive, so the address identifies
+// the location.
+//
+// Each bucket points to the highest priority (oldest) waiter in its list,
+// and lower priority nodes are linked through the 'lower_pri' field.  The
+// 'back' field goes the other direction.  The list is circular, so the
+// 'lower_pri' field of the lowest priority node points to the first node
+// in the list.  The list has no dedicated header node.
+//
+// The table is protected by FutexThread::lock_, like the state of the
+// waiting threads themselves.
 
 class FutexWaiter
 {
   public:
-    FutexWaiter(uint32_t offset, JSContext* cx)
-      : offset(offset),
+    FutexWaiter(void* address, JSContext* cx)
+      : address(address),
         cx(cx),
         lower_pri(nullptr),
         back(nullptr)
     {
     }
 
-    uint32_t    offset;                 // int32 element index within the SharedArrayBuffer
+    void*       address;                // The int32 element waited on
     JSContext* cx;                      // The waiting thread
     FutexWaiter* lower_pri;             // Lower priority nodes in circular doubly-linked list of waiters
     FutexWaiter* back;                  // Other direction
 };
 
+// Must be a power of two.
+static const size_t FutexWaiterBucketCount = 256;
+
+static FutexWaiter* FutexWaiterBuckets[FutexWaiterBucketCount];
+
+static FutexWaiter*&
+FutexWaiterBucket(void* address)
+{
+    return FutexWaiterBuckets[mozilla::HashGeneric(address) & (FutexWaiterBucketCount - 1)];
+}
+
 class AutoLockFutexAPI
 {
     // We have to wrap this in a Maybe because of the way loading
@@ -783,8 +802,8 @@ js::atomics_wait(JSContext* cx, unsigned argc, Value* vp)
     if (!cx->fx.canWait())
         return ReportCannotWait(cx);
 
-    // This lock also protects the "waiters" field on SharedArrayRawBuffer,
-    // and it provides the necessary memory fence.
+    // This lock also protects the waiter lists, and it provides the
+    // necessary memory fence.
     AutoLockFutexAPI lock;
 
     SharedMem<int32_t*>(addr) = view->viewDataShared().cast<int32_t*>() + offset;
@@ -793,18 +812,19 @@ js::atomics_wait(JSContext* cx, unsigned argc, Value* vp)
         return true;
     }
 
+    // Keep the buffer, and so the address, alive while waiting.
     Rooted<SharedArrayBufferObject*> sab(cx, view->bufferShared());
-    SharedArrayRawBuffer* sarb = sab->rawBufferObject();
 
-    FutexWaiter w(offset, cx);
-    if (FutexWaiter* waiters = sarb->waiters()) {
+    FutexWaiter w(addr.unwrap(), cx);
+    FutexWaiter*& waiters = FutexWaiterBucket(w.address);
+    if (waiters) {
         w.lower_pri = waiters;
         w.back = waiters->back;
         waiters->back->lower_pri = &w;
         waiters->back = &w;
     } else {
         w.lower_pri = w.back = &w;
-        sarb->setWaiters(&w);
+        waiters = &w;
     }
 
     FutexThread::WaitResult result = FutexThread::FutexOK;
@@ -821,12 +841,12 @@ js::atomics_wait(JSContext* cx, unsigned argc, Value* vp)
     }
 
     if (w.lower_pri == &w) {
-        sarb->setWaiters(nullptr);
+        waiters = nullptr;
     } else {
         w.lower_pri->back = w.back;
         w.back->lower_pri = w.lower_pri;
-        if (sarb->waiters() == &w)
-            sarb->setWaiters(w.lower_pri);
+        if (waiters == &w)
+            waiters = w.lower_pri;
     }
     return retval;
 }
@@ -858,19 +878,19 @@ js::atomics_wake(JSContext* cx, unsigned argc, Value* vp)
             count = 0.0;
     }
 
+    void* address = (view->viewDataShared().cast<int32_t*>() + offset).unwrap();
+
     AutoLockFutexAPI lock;
 
-    Rooted<SharedArrayBufferObject*> sab(cx, view->bufferShared());
-    SharedArrayRawBuffer* sarb = sab->rawBufferObject();
     int32_t woken = 0;
 
-    FutexWaiter* waiters = sarb->waiters();
+    FutexWaiter* waiters = FutexWaiterBucket(address);
     if (waiters && count > 0) {
         FutexWaiter* iter = waiters;
         do {
             FutexWaiter* c = iter;
             iter = iter->lower_pri;
-            if (c->offset != offset || !c->cx->fx.isWaiting())
+            if (c->address != address || !c->cx->fx.isWaiting())
                 continue;
             c->cx->fx.wake(FutexThread::WakeExplicit);
             ++woken;
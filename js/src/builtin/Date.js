@@ -5,71 +5,41 @@
 /*global intl_DateTimeFormat: false, */
 
 
-// This cache, once primed, has these properties:
-//
-//   runtimeDefaultLocale:
-//     Locale information provided by the embedding, guiding SpiderMonkey's
-//     selection of a default locale.  See RuntimeDefaultLocale(), whose
-//     value controls the value returned by DefaultLocale() that's what's
-//     *actually* used.
-//   icuDefaultTimeZone:
-//     Time zone information provided by ICU. See intl_defaultTimeZone(),
-//     whose value controls the value returned by DefaultTimeZone() that's
-//     what's *actually* used.
-//   formatters:
-//     A Record storing formatters consistent with the above
-//     runtimeDefaultLocale/localTZA values, for use with the appropriate
-//     ES6 toLocale*String Date method when called with its first two
-//     arguments having the value |undefined|.
-//
-// The "formatters" Record has (some subset of) these properties, as determined
-// by all values of the first argument passed to |GetCachedFormat|:
+// Caches of DateTimeFormat formatters for Date's toLocale*String methods,
+// managed by GetCachedIntlObject.  Each is used for the method named below:
 //
 //   dateTimeFormat: for Date's toLocaleString operation
 //   dateFormat: for Date's toLocaleDateString operation
 //   timeFormat: for Date's toLocaleTimeString operation
-//
-// Using this cache, then, requires
-// 1) verifying the current runtimeDefaultLocale/icuDefaultTimeZone are
-//    consistent with cached values, then
-// 2) seeing if the desired formatter is cached and returning it if so, or else
-// 3) create the desired formatter and store and return it.
-var dateTimeFormatCache = new Record();
+var dateTimeFormatCache = {
+    dateTimeFormat: new Record(),
+    dateFormat: new Record(),
+    timeFormat: new Record(),
+};
 
 
 /**
  * Get a cached DateTimeFormat formatter object, created like so:
  *
  *   var opts = ToDateTimeOptions(undefined, required, defaults);
- *   return new Intl.DateTimeFormat(undefined, opts);
+ *   return new Intl.DateTimeFormat(locales, opts);
  *
- * |format| must be a key from the "formatters" Record described above.
+ * |format| must be a key of dateTimeFormatCache, and |locales| must be
+ * undefined or a string.
  */
-function GetCachedFormat(format, required, defaults) {
+function GetCachedFormat(format, locales, required, defaults) {
     assert(format === "dateTimeFormat" ||
            format === "dateFormat" ||
            format === "timeFormat",
            "unexpected format key: please update the comment by " +
            "dateTimeFormatCache");
 
-    var runtimeDefaultLocale = RuntimeDefaultLocale();
-    var icuDefaultTimeZone = intl_defaultTimeZone();
-
-    var formatters;
-    if (dateTimeFormatCache.runtimeDefaultLocale !== runtimeDefaultLocale ||
-        dateTimeFormatCache.icuDefaultTimeZone !== icuDefaultTimeZone)
-    {
-        formatters = dateTimeFormatCache.formatters = new Record();
-        dateTimeFormatCache.runtimeDefaultLocale = runtimeDefaultLocale;
-        dateTimeFormatCache.icuDefaultTimeZone = icuDefaultTimeZone;
-    } else {
-        formatters = dateTimeFormatCache.formatters;
-    }
-
-    var fmt = formatters[format];
+    var cache = dateTimeFormatCache[format];
+    var fmt = GetCachedIntlObject(cache, locales, true);
     if (fmt === undefined) {
         var options = ToDateTimeOptions(undefined, required, defaults);
-        fmt = formatters[format] = intl_DateTimeFormat(undefined, options);
+        fmt = intl_DateTimeFormat(locales, options);
+        SetCachedIntlObject(cache, locales, fmt);
     }
 
     return fmt;
@@ -94,10 +64,10 @@ function Date_toLocaleString() {
 
     // Step 5-6.
     var dateTimeFormat;
-    if (locales === undefined && options === undefined) {
-        // This cache only optimizes for the old ES5 toLocaleString without
-        // locales and options.
-        dateTimeFormat = GetCachedFormat("dateTimeFormat", "any", "all");
+    if (options === undefined && (locales === undefined || typeof locales === "string")) {
+        // This cache only optimizes for calls without options and with at
+        // most a single locale; see GetCachedIntlObject.
+        dateTimeFormat = GetCachedFormat("dateTimeFormat", locales, "any", "all");
     } else {
         options = ToDateTimeOptions(options, "any", "all");
         dateTimeFormat = intl_DateTimeFormat(locales, options);
@@ -127,10 +97,10 @@ function Date_toLocaleDateString() {
 
     // Step 5-6.
     var dateTimeFormat;
-    if (locales === undefined && options === undefined) {
-        // This cache only optimizes for the old ES5 toLocaleDateString without
-        // locales and options.
-        dateTimeFormat = GetCachedFormat("dateFormat", "date", "date");
+    if (options === undefined && (locales === undefined || typeof locales === "string")) {
+        // This cache only optimizes for calls without options and with at
+        // most a single locale; see GetCachedIntlObject.
+        dateTimeFormat = GetCachedFormat("dateFormat", locales, "date", "date");
     } else {
         options = ToDateTimeOptions(options, "date", "date");
         dateTimeFormat = intl_DateTimeFormat(locales, options);
@@ -160,10 +130,10 @@ function Date_toLocaleTimeString() {
 
     // Step 5-6.
     var dateTimeFormat;
-    if (locales === undefined && options === undefined) {
-        // This cache only optimizes for the old ES5 toLocaleTimeString without
-        // locales and options.
-        dateTimeFormat = GetCachedFormat("timeFormat", "time", "time");
+    if (options === undefined && (locales === undefined || typeof locales === "string")) {
+        // This cache only optimizes for calls without options and with at
+        // most a single locale; see GetCachedIntlObject.
+        dateTimeFormat = GetCachedFormat("timeFormat", locales, "time", "time");
     } else {
         options = ToDateTimeOptions(options, "time", "time");
         dateTimeFormat = intl_DateTimeFormat(locales, options);
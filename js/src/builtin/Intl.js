@@ -693,6 +693,74 @@ function DefaultLocale() {
 }
 
 
+/**
+ * Get the Intl object cached in |cache| for |locale|, for use by the
+ * toLocale*String and localeCompare methods.  These methods create a new
+ * Intl object, and with it a new ICU object, every time they're called, so
+ * they cache them when called without options and either without locales
+ * (|locale| is undefined) or with a single locale string.  Objects created
+ * from any other arguments can't be reused, since inspecting the arguments
+ * can run user code.
+ *
+ * |cache| is a Record with these properties, managed by this function and
+ * SetCachedIntlObject:
+ *
+ *   runtimeDefaultLocale, icuDefaultTimeZone:
+ *     The values the cached objects were created with.  Locale negotiation
+ *     can fall back on the default locale, and date formatting depends on
+ *     the default time zone, so the cache is emptied when either changes.
+ *     The time zone is only checked if |dependsOnTimeZone| is true.
+ *   defaultObject:
+ *     The object created without locales.
+ *   objects, count:
+ *     A Record of the objects created for each locale string, and its size.
+ *
+ * Returns undefined if no object is cached; the caller then creates one and
+ * passes it to SetCachedIntlObject.
+ */
+function GetCachedIntlObject(cache, locale, dependsOnTimeZone) {
+    assert(locale === undefined || typeof locale === "string",
+           "only objects for no locales or a single locale can be cached");
+
+    var runtimeDefaultLocale = RuntimeDefaultLocale();
+    var icuDefaultTimeZone = dependsOnTimeZone ? intl_defaultTimeZone() : undefined;
+    if (cache.runtimeDefaultLocale !== runtimeDefaultLocale ||
+        cache.icuDefaultTimeZone !== icuDefaultTimeZone)
+    {
+        cache.runtimeDefaultLocale = runtimeDefaultLocale;
+        cache.icuDefaultTimeZone = icuDefaultTimeZone;
+        cache.defaultObject = undefined;
+        cache.objects = new Record();
+        cache.count = 0;
+        return undefined;
+    }
+
+    if (locale === undefined)
+        return cache.defaultObject;
+    return cache.objects[locale];
+}
+
+
+/**
+ * Cache |obj| in |cache| for |locale|; see GetCachedIntlObject.
+ */
+function SetCachedIntlObject(cache, locale, obj) {
+    if (locale === undefined) {
+        cache.defaultObject = obj;
+        return;
+    }
+
+    // Pages that format for many locales don't get to grow the cache without
+    // bound; start again once it holds 32 of them.
+    if (cache.count >= 32) {
+        cache.objects = new Record();
+        cache.count = 0;
+    }
+    cache.objects[locale] = obj;
+    cache.count++;
+}
+
+
 /**
  * Verifies that the given string is a well-formed ISO 4217 currency code.
  *
@@ -25,12 +25,14 @@ function Number_toLocaleString() {
 
     // Step 4.
     var numberFormat;
-    if (locales === undefined && options === undefined) {
-        // This cache only optimizes for the old ES5 toLocaleString without
-        // locales and options.
-        if (numberFormatCache.numberFormat === undefined)
-            numberFormatCache.numberFormat = intl_NumberFormat(locales, options);
-        numberFormat = numberFormatCache.numberFormat;
+    if (options === undefined && (locales === undefined || typeof locales === "string")) {
+        // This cache only optimizes for calls without options and with at
+        // most a single locale; see GetCachedIntlObject.
+        numberFormat = GetCachedIntlObject(numberFormatCache, locales, false);
+        if (numberFormat === undefined) {
+            numberFormat = intl_NumberFormat(locales, options);
+            SetCachedIntlObject(numberFormatCache, locales, numberFormat);
+        }
     } else {
         numberFormat = intl_NumberFormat(locales, options);
     }
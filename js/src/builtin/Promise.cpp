@@ -282,9 +282,25 @@ class PromiseReactionRecord : public NativeObject
     }
 };
 
+static bool PromiseReactionRecordCall(JSContext* cx, unsigned argc, Value* vp);
+
+static const ClassOps PromiseReactionRecordClassOps = {
+    nullptr, /* addProperty */
+    nullptr, /* delProperty */
+    nullptr, /* getProperty */
+    nullptr, /* setProperty */
+    nullptr, /* enumerate */
+    nullptr, /* newEnumerate */
+    nullptr, /* resolve */
+    nullptr, /* mayResolve */
+    nullptr, /* finalize */
+    PromiseReactionRecordCall
+};
+
 const Class PromiseReactionRecord::class_ = {
     "PromiseReactionRecord",
-    JSCLASS_HAS_RESERVED_SLOTS(ReactionRecordSlots)
+    JSCLASS_HAS_RESERVED_SLOTS(ReactionRecordSlots),
+    &PromiseReactionRecordClassOps
 };
 
 static void
@@ -550,15 +566,25 @@ EnqueuePromiseReactionJob(JSContext* cx, HandleObject reactionObj,
             return false;
     }
 
-    // Create the JS function to call when the job is triggered.
-    RootedAtom funName(cx, cx->names().empty);
-    RootedFunction job(cx, NewNativeFunction(cx, PromiseReactionJob, 0, funName,
-                                             gc::AllocKind::FUNCTION_EXTENDED, GenericObject));
-    if (!job)
-        return false;
+    // A reaction is only triggered once, so if it lives in the compartment
+    // the job has to be created in, it can be the job itself: reaction
+    // records are callable, see PromiseReactionRecordCall. Otherwise create
+    // a JS function holding a wrapper of the reaction.
+    RootedObject job(cx);
+    if (reaction->compartment() == cx->compartment()) {
+        job = reaction.get();
+    } else {
+        RootedAtom funName(cx, cx->names().empty);
+        RootedFunction jobFun(cx, NewNativeFunction(cx, PromiseReactionJob, 0, funName,
+                                                    gc::AllocKind::FUNCTION_EXTENDED,
+                                                    GenericObject));
+        if (!jobFun)
+            return false;
 
-    // Store the reaction on the reaction job.
-    job->setExtendedSlot(ReactionJobSlot_ReactionRecord, reactionVal);
+        // Store the reaction on the reaction job.
+        jobFun->setExtendedSlot(ReactionJobSlot_ReactionRecord, reactionVal);
+        job = jobFun;
+    }
 
     // When using JS::AddPromiseReactions, no actual promise is created, so we
     // might not have one here.
@@ -955,18 +981,17 @@ AsyncGeneratorPromiseReactionJob(JSContext* cx, Handle<PromiseReactionRecord*> r
  *
  * See http://www.ecma-international.org/ecma-262/7.0/index.html#sec-jobs-and-job-queues
  *
- * A PromiseReactionJob is set as the native function of an extended
- * JSFunction object, with all information required for the job's
- * execution stored in in a reaction record in its first extended slot.
+ * The job is either the reaction record itself, see PromiseReactionRecordCall,
+ * or, if the reaction record comes from another compartment than the handler
+ * function, an extended JSFunction with PromiseReactionJob as its native and
+ * a wrapper of the reaction record in its first extended slot.
  */
 static bool
-PromiseReactionJob(JSContext* cx, unsigned argc, Value* vp)
+RunPromiseReactionJob(JSContext* cx, HandleObject job, MutableHandleValue rval)
 {
-    CallArgs args = CallArgsFromVp(argc, vp);
-
-    RootedFunction job(cx, &args.callee().as<JSFunction>());
-
-    RootedObject reactionObj(cx, &job->getExtendedSlot(ReactionJobSlot_ReactionRecord).toObject());
+    RootedObject reactionObj(cx, job);
+    if (job->is<JSFunction>())
+        reactionObj = &job->as<JSFunction>().getExtendedSlot(ReactionJobSlot_ReactionRecord).toObject();
 
     // To ensure that the embedding ends up with the right entry global, we're
     // guaranteeing that the reaction job function gets created in the same
@@ -991,9 +1016,9 @@ PromiseReactionJob(JSContext* cx, unsigned argc, Value* vp)
     // Steps 1-2.
     Rooted<PromiseReactionRecord*> reaction(cx, &reactionObj->as<PromiseReactionRecord>());
     if (reaction->isAsyncFunction())
-        return AsyncFunctionPromiseReactionJob(cx, reaction, args.rval());
+        return AsyncFunctionPromiseReactionJob(cx, reaction, rval);
     if (reaction->isAsyncGenerator())
-        return AsyncGeneratorPromiseReactionJob(cx, reaction, args.rval());
+        return AsyncGeneratorPromiseReactionJob(cx, reaction, rval);
 
     // Step 3.
     RootedValue handlerVal(cx, reaction->handler());
@@ -1046,10 +1071,30 @@ PromiseReactionJob(JSContext* cx, unsigned argc, Value* vp)
     if (!RunResolutionFunction(cx, callee, handlerResult, resolutionMode, promiseObj))
         return false;
 
-    args.rval().setUndefined();
+    rval.setUndefined();
     return true;
 }
 
+static bool
+PromiseReactionJob(JSContext* cx, unsigned argc, Value* vp)
+{
+    CallArgs args = CallArgsFromVp(argc, vp);
+    RootedObject job(cx, &args.callee());
+    return RunPromiseReactionJob(cx, job, args.rval());
+}
+
+// Reaction records in the same compartment as their handler function are
+// enqueued as the job directly, saving the allocation of a job function per
+// reaction.
+static bool
+PromiseReactionRecordCall(JSContext* cx, unsigned argc, Value* vp)
+{
+    CallArgs args = CallArgsFromVp(argc, vp);
+    RootedObject job(cx, &args.callee());
+    MOZ_RELEASE_ASSERT(job->is<PromiseReactionRecord>());
+    return RunPromiseReactionJob(cx, job, args.rval());
+}
+
 // ES2016, 25.4.2.2.
 /**
  * Callback for resolving a thenable, to be invoked by the embedding during
@@ -6,187 +6,6 @@
 // consolidated here to avoid confusion and re-implementation of existing
 // algorithms.
 
-// For sorting values with limited range; uint8 and int8.
-function CountingSort(array, len, signed, comparefn) {
-    // Determined by performance testing.
-    if (len < 128) {
-        QuickSort(array, len, comparefn);
-        return array;
-    }
-
-    // Map int8 values onto the uint8 range when storing in buffer.
-    var min = 0;
-    if (signed) {
-        min = -128;
-    }
-
-    /* eslint-disable comma-spacing */
-    // 32 * 8 = 256 entries.
-    var buffer = [
-        0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-        0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-        0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-        0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-        0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-        0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-        0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-        0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-    ];
-    /* eslint-enable comma-spacing */
-
-    // Populate the buffer
-    for (var i = 0; i < len; i++) {
-        var val = array[i];
-        buffer[val - min]++;
-    }
-
-    // Traverse the buffer in order and write back elements to array
-    var val = -1;
-    for (var i = 0; i < len;) {
-        // Invariant: sum(buffer[val:]) == len-i
-        var j;
-        do {
-            j = buffer[++val];
-        } while (j === 0);
-
-        for (; j > 0; j--)
-            array[i++] = val + min;
-    }
-    return array;
-}
-
-// Helper for RadixSort
-function ByteAtCol(x, pos) {
-    return (x >> (pos * 8)) & 0xFF;
-}
-
-function SortByColumn(array, len, aux, col, counts) {
-    const R = 256;
-
-    // |counts| is used to compute the starting index position for each key.
-    // Letting counts[0] always be 0, simplifies the transform step below.
-    // Example:
-    //
-    // Computing frequency counts for the input [1 2 1] gives:
-    //      0 1 2 3 ... (keys)
-    //      0 0 2 1     (frequencies)
-    //
-    // Transforming frequencies to indexes gives:
-    //      0 1 2 3 ... (keys)
-    //      0 0 2 3     (indexes)
-    assert(counts.length === R + 1, "counts has |R| + 1 entries");
-
-    // Initialize all entries to zero.
-    for (let r = 0; r < R + 1; r++) {
-        counts[r] = 0;
-    }
-
-    // Compute frequency counts
-    for (let i = 0; i < len; i++) {
-        let val = array[i];
-        let b = ByteAtCol(val, col);
-        counts[b + 1]++;
-    }
-
-    // Transform counts to indices.
-    for (let r = 0; r < R; r++) {
-        counts[r + 1] += counts[r];
-    }
-
-    // Distribute
-    for (let i = 0; i < len; i++) {
-        let val = array[i];
-        let b = ByteAtCol(val, col);
-        aux[counts[b]++] = val;
-    }
-
-    // Copy back
-    for (let i = 0; i < len; i++) {
-        array[i] = aux[i];
-    }
-}
-
-// Sorts integers and float32. |signed| is true for int16 and int32, |floating|
-// is true for float32.
-function RadixSort(array, len, buffer, nbytes, signed, floating, comparefn) {
-    // Determined by performance testing.
-    if (len < 512) {
-        QuickSort(array, len, comparefn);
-        return array;
-    }
-
-    let aux = [];
-    for (let i = 0; i < len; i++)
-        _DefineDataProperty(aux, i, 0);
-
-    let view = array;
-    let signMask = 1 << nbytes * 8 - 1;
-
-    // Preprocess
-    if (floating) {
-        // Acquire a buffer if the array was previously using inline storage.
-        if (buffer === null) {
-            buffer = callFunction(std_TypedArray_buffer, array);
-
-            assert(buffer !== null, "Attached data buffer should be reified");
-        }
-
-        view = new Int32Array(buffer);
-
-        // Flip sign bit for positive numbers; flip all bits for negative
-        // numbers
-        for (let i = 0; i < len; i++) {
-            if (view[i] & signMask) {
-                view[i] ^= 0xFFFFFFFF;
-            } else {
-                view[i] ^= signMask
-            }
-        }
-    } else if (signed) {
-        // Flip sign bit
-        for (let i = 0; i < len; i++) {
-            view[i] ^= signMask
-        }
-    }
-
-    /* eslint-disable comma-spacing */
-    // 32 * 8 + 1 = 256 + 1 entries.
-    let counts = [
-        0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-        0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-        0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-        0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-        0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-        0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-        0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-        0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-        0,
-    ];
-    /* eslint-enable comma-spacing */
-
-    // Sort
-    for (let col = 0; col < nbytes; col++) {
-        SortByColumn(view, len, aux, col, counts);
-    }
-
-    // Restore original bit representation
-    if (floating) {
-        for (let i = 0; i < len; i++) {
-            if (view[i] & signMask) {
-                view[i] ^= signMask;
-            } else {
-                view[i] ^= 0xFFFFFFFF;
-            }
-        }
-    } else if (signed) {
-        for (let i = 0; i < len; i++) {
-            view[i] ^= signMask
-        }
-    }
-    return array;
-}
-
-
 // For sorting small arrays.
 function InsertionSort(array, from, to, comparefn) {
     let item, swap, i, j;
@@ -590,12 +590,14 @@ function String_localeCompare(that) {
 
     // Step 6.
     var collator;
-    if (locales === undefined && options === undefined) {
-        // This cache only optimizes for the old ES5 localeCompare without
-        // locales and options.
-        if (collatorCache.collator === undefined)
-            collatorCache.collator = intl_Collator(locales, options);
-        collator = collatorCache.collator;
+    if (options === undefined && (locales === undefined || typeof locales === "string")) {
+        // This cache only optimizes for calls without options and with at
+        // most a single locale; see GetCachedIntlObject.
+        collator = GetCachedIntlObject(collatorCache, locales, false);
+        if (collator === undefined) {
+            collator = intl_Collator(locales, options);
+            SetCachedIntlObject(collatorCache, locales, collator);
+        }
     } else {
         collator = intl_Collator(locales, options);
     }
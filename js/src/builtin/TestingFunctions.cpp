@@ -49,6 +49,7 @@
 #include "vm/TraceLogging.h"
 #include "wasm/AsmJS.h"
 #include "wasm/WasmBinaryToText.h"
+#include "wasm/WasmCompile.h"
 #include "wasm/WasmJS.h"
 #include "wasm/WasmModule.h"
 #include "wasm/WasmSignalHandlers.h"
@@ -659,6 +660,107 @@ WasmExtractCode(JSContext* cx, unsigned argc, Value* vp)
     return true;
 }
 
+static bool
+WasmStreamingCompile(JSContext* cx, unsigned argc, Value* vp)
+{
+    if (!cx->options().wasm()) {
+        JS_ReportErrorASCII(cx, "wasm support unavailable");
+        return false;
+    }
+
+    CallArgs args = CallArgsFromVp(argc, vp);
+    if (!args.requireAtLeast(cx, "wasmStreamingCompile", 2))
+        return false;
+
+    if (!args[0].isObject() || !JS_IsArrayBufferViewObject(&args[0].toObject())) {
+        JS_ReportErrorASCII(cx, "first argument must be a typed array");
+        return false;
+    }
+
+    int32_t chunkSize;
+    if (!ToInt32(cx, args[1], &chunkSize))
+        return false;
+    if (chunkSize <= 0) {
+        JS_ReportErrorASCII(cx, "chunk size must be positive");
+        return false;
+    }
+
+    wasm::Bytes bytes;
+    {
+        JS::AutoCheckCannotGC nogc;
+        JSObject* view = &args[0].toObject();
+        bool isShared;
+        uint8_t* data = static_cast<uint8_t*>(JS_GetArrayBufferViewData(view, &isShared, nogc));
+        if (!bytes.append(data, JS_GetArrayBufferViewByteLength(view))) {
+            ReportOutOfMemory(cx);
+            return false;
+        }
+    }
+
+    wasm::ScriptedCaller scriptedCaller;
+    scriptedCaller.line = 0;
+    scriptedCaller.column = 0;
+
+    wasm::CompileArgs compileArgs;
+    if (!compileArgs.initFromContext(cx, Move(scriptedCaller)))
+        return false;
+
+    UniqueChars error;
+    wasm::StreamingCompiler compiler(compileArgs, &error);
+    bool ok = compiler.init();
+    for (size_t i = 0; ok && i < bytes.length(); i += chunkSize) {
+        size_t length = Min(bytes.length() - i, size_t(chunkSize));
+        ok = compiler.addBytes(bytes.begin() + i, length);
+    }
+
+    wasm::SharedModule module = ok ? compiler.finish() : nullptr;
+    if (!module) {
+        if (error) {
+            JS_ReportErrorNumberASCII(cx, GetErrorMessage, nullptr, JSMSG_WASM_COMPILE_ERROR,
+                                      error.get());
+            return false;
+        }
+        ReportOutOfMemory(cx);
+        return false;
+    }
+
+    if (!GlobalObject::ensureConstructor(cx, cx->global(), JSProto_WebAssembly))
+        return false;
+
+    RootedObject proto(cx, &cx->global()->getPrototype(JSProto_WasmModule).toObject());
+    RootedObject moduleObj(cx, WasmModuleObject::create(cx, *module, proto));
+    if (!moduleObj)
+        return false;
+
+    args.rval().setObject(*moduleObj);
+    return true;
+}
+
+static bool
+WasmCompiledTier(JSContext* cx, unsigned argc, Value* vp)
+{
+    CallArgs args = CallArgsFromVp(argc, vp);
+
+    if (!args.get(0).isObject()) {
+        JS_ReportErrorASCII(cx, "argument is not an object");
+        return false;
+    }
+
+    JSObject* unwrapped = CheckedUnwrap(&args.get(0).toObject());
+    if (!unwrapped || !unwrapped->is<WasmModuleObject>()) {
+        JS_ReportErrorASCII(cx, "argument is not a WebAssembly.Module");
+        return false;
+    }
+
+    wasm::Tier tier = unwrapped->as<WasmModuleObject>().module().code().anyTier();
+    JSString* result = JS_NewStringCopyZ(cx, tier == wasm::Tier::Baseline ? "baseline" : "ion");
+    if (!result)
+        return false;
+
+    args.rval().setString(result);
+    return true;
+}
+
 static bool
 IsLazyFunction(JSContext* cx, unsigned argc, Value* vp)
 {
@@ -2662,6 +2764,49 @@ HelperThreadCount(JSContext* cx, unsigned argc, Value* vp)
     return true;
 }
 
+static bool
+HelperThreadQueueLatencies(JSContext* cx, unsigned argc, Value* vp)
+{
+    CallArgs args = CallArgsFromVp(argc, vp);
+
+    RootedObject result(cx, JS_NewPlainObject(cx));
+    if (!result)
+        return false;
+
+    static const struct {
+        const char* name;
+        HelperTaskKind kind;
+    } kinds[] = {
+        { "ion", HelperTaskKind::Ion },
+        { "wasm", HelperTaskKind::Wasm },
+        { "parse", HelperTaskKind::Parse }
+    };
+
+    for (const auto& entry : kinds) {
+        uint32_t counts[QueueLatencyHistogram::NumBuckets];
+        {
+            AutoLockHelperThreadState lock;
+            const QueueLatencyHistogram& histogram =
+                HelperThreadState().queueLatency(entry.kind, lock);
+            mozilla::PodArrayCopy(counts, histogram.counts);
+        }
+
+        RootedArrayObject array(cx, NewDenseFullyAllocatedArray(cx, QueueLatencyHistogram::NumBuckets));
+        if (!array)
+            return false;
+
+        array->setDenseInitializedLength(QueueLatencyHistogram::NumBuckets);
+        for (size_t i = 0; i < QueueLatencyHistogram::NumBuckets; i++)
+            array->initDenseElement(i, NumberValue(counts[i]));
+
+        if (!JS_DefineProperty(cx, result, entry.name, array, JSPROP_ENUMERATE))
+            return false;
+    }
+
+    args.rval().setObject(*result);
+    return true;
+}
+
 #ifdef JS_TRACE_LOGGING
 static bool
 EnableTraceLogger(JSContext* cx, unsigned argc, Value* vp)
@@ -4683,6 +4828,16 @@ gc::ZealModeHelpText),
 "wasmExtractCode(module)",
 "  Extracts generated machine code from WebAssembly.Module."),
 
+    JS_FN_HELP("wasmStreamingCompile", WasmStreamingCompile, 2, 0,
+"wasmStreamingCompile(bytes, chunkSize)",
+"  Compiles the wasm module in the typed array |bytes| by feeding it to the\n"
+"  streaming compiler |chunkSize| bytes at a time, and returns the\n"
+"  WebAssembly.Module."),
+
+    JS_FN_HELP("wasmCompiledTier", WasmCompiledTier, 1, 0,
+"wasmCompiledTier(module)",
+"  Returns \"baseline\" or \"ion\", the tier the WebAssembly.Module was compiled with."),
+
     JS_FN_HELP("isLazyFunction", IsLazyFunction, 1, 0,
 "isLazyFunction(fun)",
 "  True if fun is a lazy JSFunction."),
@@ -4766,6 +4921,12 @@ gc::ZealModeHelpText),
 "helperThreadCount()",
 "  Returns the number of helper threads available for off-thread tasks."),
 
+    JS_FN_HELP("helperThreadQueueLatencies", HelperThreadQueueLatencies, 0, 0,
+"helperThreadQueueLatencies()",
+"  Returns an object with 'ion', 'wasm' and 'parse' arrays counting how long\n"
+"  started helper thread tasks of each kind waited in their worklist. Bucket 0\n"
+"  counts waits under 1us and bucket i waits in [2^(i-1), 2^i) us."),
+
 #ifdef JS_TRACE_LOGGING
     JS_FN_HELP("startTraceLogger", EnableTraceLogger, 0, 0,
 "startTraceLogger()",
@@ -1134,27 +1134,6 @@ function TypedArrayCompare(x, y) {
     return Number_isNaN(y) ? -1 : 0;
 }
 
-// TypedArray SortCompare specialization for integer values.
-function TypedArrayCompareInt(x, y) {
-    // Step 1.
-    assert(typeof x === "number" && typeof y === "number",
-           "x and y are not numbers.");
-    assert((x === (x | 0) || x === (x >>> 0)) && (y === (y | 0) || y === (y >>> 0)),
-           "x and y are not int32/uint32 numbers.");
-
-    // Step 2 (Implemented in TypedArraySort).
-
-    // Steps 6-7.
-    var diff = x - y;
-    if (diff)
-        return diff;
-
-    // Steps 3-5, 8-9 (Not applicable when sorting integer values).
-
-    // Step 10.
-    return 0;
-}
-
 // ES2018 draft rev 3bbc87cd1b9d3bf64c3e68ca2fe9c5a3f2c304c0
 // 22.2.3.26 %TypedArray%.prototype.sort ( comparefn )
 function TypedArraySort(comparefn) {
@@ -1192,21 +1171,10 @@ function TypedArraySort(comparefn) {
         return obj;
 
     if (comparefn === undefined) {
-        if (IsUint8TypedArray(obj)) {
-            return CountingSort(obj, len, false /* signed */, TypedArrayCompareInt);
-        } else if (IsInt8TypedArray(obj)) {
-            return CountingSort(obj, len, true /* signed */, TypedArrayCompareInt);
-        } else if (IsUint16TypedArray(obj)) {
-            return RadixSort(obj, len, buffer, 2 /* nbytes */, false /* signed */, false /* floating */, TypedArrayCompareInt);
-        } else if (IsInt16TypedArray(obj)) {
-            return RadixSort(obj, len, buffer, 2 /* nbytes */, true /* signed */, false /* floating */, TypedArrayCompareInt);
-        } else if (IsUint32TypedArray(obj)) {
-            return RadixSort(obj, len, buffer, 4 /* nbytes */, false /* signed */, false /* floating */, TypedArrayCompareInt);
-        } else if (IsInt32TypedArray(obj)) {
-            return RadixSort(obj, len, buffer, 4 /* nbytes */, true /* signed */, false /* floating */, TypedArrayCompareInt);
-        } else if (IsFloat32TypedArray(obj)) {
-            return RadixSort(obj, len, buffer, 4 /* nbytes */, true /* signed */, true /* floating */, TypedArrayCompare);
-        }
+        // Sort same-compartment arrays natively, see TypedArrayCompare for
+        // the order.
+        if (isTypedArray)
+            return TypedArrayNativeSort(obj);
         return QuickSort(obj, len, TypedArrayCompare);
     }
 
@@ -164,6 +164,13 @@ Array<Array<uint64_t, MaxLifetimeBins>, FinalizerKinds> heapObjectCountByFinaliz
 Array<Array<uint64_t, MaxLifetimeBins>, MaxClasses> finalizedHeapObjectCountByClassAndLifetime;
 std::vector<Array<Array<uint64_t, MaxLifetimeBins>, HeapKinds> > objectCountByTypeHeapAndLifetime;
 
+// Background finalization by helper task, task 0 being the thread that
+// started the others.
+const unsigned MaxFinalizeTasks = 256;
+Array<uint64_t, MaxFinalizeTasks> finalizeRunsByTask(EmptyArrayTag{});
+Array<uint64_t, MaxFinalizeTasks> finalizedArenasByTask(EmptyArrayTag{});
+Array<uint64_t, MaxFinalizeTasks> finalizeMicrosecondsByTask(EmptyArrayTag{});
+
 static void
 MOZ_FORMAT_PRINTF(1, 2)
 die(const char* format, ...)
@@ -304,6 +311,21 @@ outputGcBytesUsed(FILE* file)
     }
 }
 
+static void
+outputBackgroundFinalize(FILE* file)
+{
+    fprintf(file, "# Background finalization throughput by helper task\n");
+    fprintf(file, "Task, Runs, Arenas, Microseconds, ArenasPerMs\n");
+    for (unsigned i = 0; i < MaxFinalizeTasks; ++i) {
+        if (!finalizeRunsByTask[i])
+            continue;
+        uint64_t micros = finalizeMicrosecondsByTask[i];
+        double rate = micros ? finalizedArenasByTask[i] * 1000.0 / micros : 0.0;
+        fprintf(file, "%4u, %8" PRIu64 ", %10" PRIu64 ", %12" PRIu64 ", %10.1f\n", i,
+                finalizeRunsByTask[i], finalizedArenasByTask[i], micros, rate);
+    }
+}
+
 static void
 outputThingCounts(FILE* file)
 {
@@ -809,6 +831,14 @@ processTraceFile(const char* filename)
           assert(state == StateMajorGC);
           state = StateMutator;
           break;
+      case TraceEventBackgroundFinalize: {
+          // Background finalization can overlap with any state.
+          uint8_t task = getTraceExtra(trace);
+          ++finalizeRunsByTask[task];
+          finalizedArenasByTask[task] += getTracePayload(trace);
+          finalizeMicrosecondsByTask[task] += expectDataInt(file);
+          break;
+      }
       default:
           assert(false);
           die("Unexpected trace event %d", event);
@@ -855,6 +885,7 @@ main(int argc, const char* argv[])
     withOutputFile(outputBase, "bytesAllocatedBySlice", outputGcBytesAllocated);
     withOutputFile(outputBase, "bytesUsedBySlice", outputGcBytesUsed);
     withOutputFile(outputBase, "thingCounts", outputThingCounts);
+    withOutputFile(outputBase, "backgroundFinalize", outputBackgroundFinalize);
     withOutputFile(outputBase, "objectCounts", outputObjectCounts);
     withOutputFile(outputBase, "lifetimeByClassForNursery",
                    std::bind(outputLifetimeByClass, _1, Nursery));
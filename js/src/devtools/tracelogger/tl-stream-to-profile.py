@@ -0,0 +1,184 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+#
+# This Source Code Form is subject to the terms of the Mozilla Public
+# License, v. 2.0. If a copy of the MPL was not distributed with this
+# file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+""" Usage:
+    tl-stream-to-profile.py output.json tl-stream.<pid>.<id>.bin [...]
+
+    Convert the files written by TraceLogger with TLOPTIONS=EnableStream to a
+    profile in the Gecko profiler's JSON format, with one thread per file.
+    Tree events become tracing markers and timestamp events become markers
+    without duration.
+
+    The file format is described in js/src/vm/TraceLoggingStream.h.
+"""
+
+from __future__ import print_function
+
+import json
+import struct
+import sys
+
+MAGIC = b'TLSTREAM'
+VERSION = 1
+
+RECORD_EVENT = 0
+RECORD_TEXT = 1
+RECORD_LOST = 2
+RECORD_CLOCK = 3
+
+# Text ids of the log items that have no duration, see TraceLoggingTypes.h.
+TIMESTAMP_ITEMS = set(['Bailout', 'Invalidation', 'Disable', 'Enable'])
+
+
+class Stream(object):
+    def __init__(self, path):
+        with open(path, 'rb') as f:
+            data = f.read()
+
+        if data[:8] != MAGIC:
+            raise Exception('%s: not a TraceLogger stream' % path)
+        version, self.pid, self.logger_id = struct.unpack_from('<III', data, 8)
+        if version != VERSION:
+            raise Exception('%s: unsupported version %d' % (path, version))
+
+        self.texts = {}
+        self.events = []
+        self.clocks = []
+        self.lost = 0
+
+        pos = 20
+        while pos < len(data):
+            kind = struct.unpack_from('<B', data, pos)[0]
+            pos += 1
+            if kind == RECORD_EVENT:
+                self.events.append(struct.unpack_from('<QI', data, pos))
+                pos += 12
+            elif kind == RECORD_TEXT:
+                text_id, length = struct.unpack_from('<II', data, pos)
+                pos += 8
+                self.texts[text_id] = data[pos:pos + length].decode('utf-8', 'replace')
+                pos += length
+            elif kind == RECORD_LOST:
+                self.lost += struct.unpack_from('<Q', data, pos)[0]
+                pos += 8
+            elif kind == RECORD_CLOCK:
+                self.clocks.append(struct.unpack_from('<Qq', data, pos))
+                pos += 16
+            else:
+                raise Exception('%s: bad record kind %d at %d' % (path, kind, pos - 1))
+
+
+def clock_conversion(streams):
+    # Fit timestamps to wall clock time using the first and last clock
+    # records of all streams, which share the same timestamp origin.
+    clocks = sorted(c for s in streams for c in s.clocks)
+    if len(clocks) < 2 or clocks[-1][0] == clocks[0][0]:
+        print('warning: not enough clock records, assuming nanosecond timestamps',
+              file=sys.stderr)
+        start_us = clocks[0][1] - clocks[0][0] / 1000.0 if clocks else 0
+        return start_us / 1000.0, 1e-6
+
+    (t0, us0), (t1, us1) = clocks[0], clocks[-1]
+    ms_per_tick = (us1 - us0) / 1000.0 / (t1 - t0)
+    start_ms = us0 / 1000.0 - t0 * ms_per_tick
+    return start_ms, ms_per_tick
+
+
+def convert_thread(stream, ms_per_tick):
+    strings = []
+    string_indexes = {}
+
+    def string_index(text):
+        if text not in string_indexes:
+            string_indexes[text] = len(strings)
+            strings.append(text)
+        return string_indexes[text]
+
+    markers = []
+    stack = []
+    stop_id = None
+    for text_id, text in stream.texts.items():
+        if text == 'Stop':
+            stop_id = text_id
+
+    for time, text_id in stream.events:
+        ms = time * ms_per_tick
+        if text_id == stop_id:
+            if stack:
+                name = stack.pop()
+                markers.append([name, ms, {'type': 'tracing', 'category': 'TraceLogger',
+                                           'interval': 'end'}])
+            continue
+
+        text = stream.texts.get(text_id, 'textId %d' % text_id)
+        name = string_index(text)
+        if text in TIMESTAMP_ITEMS:
+            markers.append([name, ms, None])
+        else:
+            stack.append(name)
+            markers.append([name, ms, {'type': 'tracing', 'category': 'TraceLogger',
+                                       'interval': 'start'}])
+
+    if stream.lost:
+        print('warning: logger %d dropped %d events' % (stream.logger_id, stream.lost),
+              file=sys.stderr)
+
+    return {
+        'name': 'TraceLogger %d' % stream.logger_id,
+        'processType': 'default',
+        'pid': stream.pid,
+        'tid': stream.logger_id,
+        'samples': {
+            'schema': {'stack': 0, 'time': 1, 'responsiveness': 2},
+            'data': [],
+        },
+        'markers': {
+            'schema': {'name': 0, 'time': 1, 'data': 2},
+            'data': markers,
+        },
+        'stackTable': {
+            'schema': {'prefix': 0, 'frame': 1},
+            'data': [],
+        },
+        'frameTable': {
+            'schema': {'location': 0, 'implementation': 1, 'optimizations': 2,
+                       'line': 3, 'category': 4},
+            'data': [],
+        },
+        'stringTable': strings,
+    }
+
+
+def main(args):
+    if len(args) < 2:
+        print(__doc__, file=sys.stderr)
+        return 1
+
+    streams = [Stream(path) for path in args[1:]]
+    start_ms, ms_per_tick = clock_conversion(streams)
+
+    profile = {
+        'meta': {
+            'version': 5,
+            'interval': 1,
+            'startTime': start_ms,
+            'processType': 0,
+            'product': 'SpiderMonkey TraceLogger',
+            'stackwalk': 0,
+        },
+        'libs': [],
+        'threads': [convert_thread(s, ms_per_tick) for s in streams],
+        'processes': [],
+    }
+
+    with open(args[0], 'w') as f:
+        json.dump(profile, f)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv[1:]))
@@ -7,12 +7,135 @@
 #include "ds/LifoAlloc.h"
 
 #include "mozilla/MathAlgorithms.h"
+#include "mozilla/ThreadLocal.h"
 
 using namespace js;
 
+using mozilla::FloorLog2;
 using mozilla::RoundUpPow2;
 using mozilla::tl::BitSize;
 
+static MOZ_THREAD_LOCAL(LifoChunkPool*) TlsLifoChunkPool;
+
+/* static */ mozilla::Atomic<uint32_t, mozilla::ReleaseAcquire>
+LifoChunkPool::purgeAllGeneration(0);
+
+LifoChunkPool::LifoChunkPool()
+  : cachedBytes_(0),
+    purgeGeneration_(purgeAllGeneration)
+{
+    mozilla::PodArrayZero(freeLists_);
+}
+
+/* static */ bool
+LifoChunkPool::Init()
+{
+    return TlsLifoChunkPool.init();
+}
+
+/* static */ LifoChunkPool*
+LifoChunkPool::current()
+{
+    return TlsLifoChunkPool.get();
+}
+
+/* static */ void
+LifoChunkPool::setCurrent(LifoChunkPool* pool)
+{
+    TlsLifoChunkPool.set(pool);
+}
+
+/* static */ bool
+LifoChunkPool::sizeClass(size_t chunkSize, size_t* index)
+{
+    size_t log2 = FloorLog2(chunkSize);
+    if (log2 < MinChunkSizeLog2 || log2 > MaxChunkSizeLog2)
+        return false;
+    MOZ_ASSERT(size_t(1) << log2 == chunkSize);
+    *index = log2 - MinChunkSizeLog2;
+    return true;
+}
+
+void
+LifoChunkPool::maybePurgeForOtherThread()
+{
+    uint32_t generation = purgeAllGeneration;
+    if (MOZ_LIKELY(generation == purgeGeneration_))
+        return;
+    purge();
+    purgeGeneration_ = generation;
+}
+
+void*
+LifoChunkPool::take(size_t chunkSize)
+{
+    maybePurgeForOtherThread();
+
+    size_t index;
+    if (!sizeClass(chunkSize, &index))
+        return nullptr;
+
+    FreeChunk* chunk = freeLists_[index];
+    if (!chunk)
+        return nullptr;
+
+    MOZ_MAKE_MEM_DEFINED(chunk, sizeof(FreeChunk));
+    freeLists_[index] = chunk->next;
+    MOZ_ASSERT(cachedBytes_ >= chunkSize);
+    cachedBytes_ -= chunkSize;
+    MOZ_MAKE_MEM_UNDEFINED(chunk, chunkSize);
+    return chunk;
+}
+
+bool
+LifoChunkPool::put(void* mem, size_t chunkSize)
+{
+    maybePurgeForOtherThread();
+
+    size_t index;
+    if (!sizeClass(chunkSize, &index) || cachedBytes_ + chunkSize > MaxCachedBytes)
+        return false;
+
+    FreeChunk* chunk = static_cast<FreeChunk*>(mem);
+    chunk->next = freeLists_[index];
+    freeLists_[index] = chunk;
+    cachedBytes_ += chunkSize;
+    MOZ_MAKE_MEM_NOACCESS(chunk, chunkSize);
+    return true;
+}
+
+void
+LifoChunkPool::purge()
+{
+    for (size_t i = 0; i < NumSizeClasses; i++) {
+        FreeChunk* chunk = freeLists_[i];
+        while (chunk) {
+            MOZ_MAKE_MEM_DEFINED(chunk, sizeof(FreeChunk));
+            FreeChunk* next = chunk->next;
+            js_free(chunk);
+            chunk = next;
+        }
+        freeLists_[i] = nullptr;
+    }
+    cachedBytes_ = 0;
+}
+
+size_t
+LifoChunkPool::sizeOfExcludingThis(mozilla::MallocSizeOf mallocSizeOf) const
+{
+    size_t n = 0;
+    for (size_t i = 0; i < NumSizeClasses; i++) {
+        for (FreeChunk* chunk = freeLists_[i]; chunk; ) {
+            n += mallocSizeOf(chunk);
+            MOZ_MAKE_MEM_DEFINED(chunk, sizeof(FreeChunk));
+            FreeChunk* next = chunk->next;
+            MOZ_MAKE_MEM_NOACCESS(chunk, sizeof(FreeChunk));
+            chunk = next;
+        }
+    }
+    return n;
+}
+
 namespace js {
 namespace detail {
 
@@ -20,7 +143,11 @@ BumpChunk*
 BumpChunk::new_(size_t chunkSize)
 {
     MOZ_ASSERT(RoundUpPow2(chunkSize) == chunkSize);
-    void* mem = js_malloc(chunkSize);
+    void* mem = nullptr;
+    if (LifoChunkPool* pool = LifoChunkPool::current())
+        mem = pool->take(chunkSize);
+    if (!mem)
+        mem = js_malloc(chunkSize);
     if (!mem)
         return nullptr;
     BumpChunk* result = new (mem) BumpChunk(chunkSize - sizeof(BumpChunk));
@@ -35,13 +162,17 @@ BumpChunk::new_(size_t chunkSize)
 void
 BumpChunk::delete_(BumpChunk* chunk)
 {
+    size_t size = chunk->computedSizeOfIncludingThis();
 #ifdef DEBUG
     // Part of the chunk may have been marked as poisoned/noaccess.  Undo that
     // before writing the 0xcd bytes.
-    size_t size = sizeof(*chunk) + chunk->bumpSpaceSize;
     MOZ_MAKE_MEM_UNDEFINED(chunk, size);
     memset(chunk, 0xcd, size);
 #endif
+    if (LifoChunkPool* pool = LifoChunkPool::current()) {
+        if (pool->put(chunk, size))
+            return;
+    }
     js_free(chunk);
 }
 
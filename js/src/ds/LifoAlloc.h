@@ -7,6 +7,7 @@
 #ifndef ds_LifoAlloc_h
 #define ds_LifoAlloc_h
 
+#include "mozilla/Atomics.h"
 #include "mozilla/Attributes.h"
 #include "mozilla/MathAlgorithms.h"
 #include "mozilla/MemoryChecking.h"
@@ -18,7 +19,8 @@
 // This data structure supports stacky LIFO allocation (mark/release and
 // LifoAllocScope). It does not maintain one contiguous segment; instead, it
 // maintains a bunch of linked memory segments. In order to prevent malloc/free
-// thrashing, unused segments are deallocated when garbage collection occurs.
+// thrashing, unused segments are deallocated when garbage collection occurs,
+// and freed segments are recycled through the thread's LifoChunkPool.
 
 #include "jsutil.h"
 
@@ -147,6 +149,61 @@ class BumpChunk
 
 } // namespace detail
 
+// Bounded cache of unused chunks for the LifoAllocs of a single thread, so that
+// short-lived LifoAllocs (e.g. one per compilation) do not go through malloc
+// and free for every chunk. Each JSContext owns the pool of its thread, and
+// chunks are taken from and returned to the pool of the thread that allocates
+// or frees them. Only the common power-of-two chunk sizes are cached, and at
+// most MaxCachedBytes per thread.
+//
+// Pools are purged on GC. Shrinking GCs also ask the pools of all other
+// threads to purge themselves, which they do the next time they are used.
+class LifoChunkPool
+{
+    static const size_t MinChunkSizeLog2 = 12;
+    static const size_t MaxChunkSizeLog2 = 16;
+    static const size_t NumSizeClasses = MaxChunkSizeLog2 - MinChunkSizeLog2 + 1;
+    static const size_t MaxCachedBytes = 512 * 1024;
+
+    struct FreeChunk
+    {
+        FreeChunk* next;
+    };
+
+    FreeChunk* freeLists_[NumSizeClasses];
+    size_t cachedBytes_;
+    uint32_t purgeGeneration_;
+
+    static mozilla::Atomic<uint32_t, mozilla::ReleaseAcquire> purgeAllGeneration;
+
+    static bool sizeClass(size_t chunkSize, size_t* index);
+    void maybePurgeForOtherThread();
+
+  public:
+    LifoChunkPool();
+    ~LifoChunkPool() { purge(); }
+
+    static MOZ_MUST_USE bool Init();
+
+    // The pool used by chunks allocated or freed on this thread, or nullptr.
+    static LifoChunkPool* current();
+    static void setCurrent(LifoChunkPool* pool);
+
+    // Return an unused chunk of |chunkSize| bytes, or nullptr.
+    void* take(size_t chunkSize);
+
+    // Cache an unused chunk of |chunkSize| bytes. Returns false if the caller
+    // has to free the chunk instead.
+    bool put(void* mem, size_t chunkSize);
+
+    void purge();
+
+    // Ask the pools of all threads to purge themselves.
+    static void purgeAll() { purgeAllGeneration++; }
+
+    size_t sizeOfExcludingThis(mozilla::MallocSizeOf mallocSizeOf) const;
+};
+
 // LIFO bump allocator: used for phase-oriented and fast LIFO allocations.
 //
 // Note: |latest| is not necessary "last". We leave BumpChunks latent in the
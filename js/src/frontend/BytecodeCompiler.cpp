@@ -657,7 +657,7 @@ frontend::CompileLazyFunction(JSContext* cx, Handle<LazyScript*> lazy, const cha
     // lazified. Note that we are interested in the delta between end of
     // syntax parsing and start of full parsing, so we do this now rather than
     // after parsing below.
-    if (!lazy->scriptSource()->parseEnded().IsNull()) {
+    if (!cx->helperThread() && !lazy->scriptSource()->parseEnded().IsNull()) {
         const mozilla::TimeDuration delta = mozilla::TimeStamp::Now() -
             lazy->scriptSource()->parseEnded();
 
@@ -1430,8 +1430,10 @@ TokenStream::getTokenInternal(TokenKind* ttp, Modifier modifier)
 
     // Skip over non-EOL whitespace chars.
     //
-    if (c1kind == Space)
+    if (c1kind == Space) {
+        userbuf.skipAsciiSpace();
         goto retry;
+    }
 
     // Look for an identifier.
     //
@@ -1442,6 +1444,7 @@ TokenStream::getTokenInternal(TokenKind* ttp, Modifier modifier)
 
       identifier:
         for (;;) {
+            userbuf.skipAsciiIdentifierPart();
             c = getCharIgnoreEOL();
             if (c == EOF)
                 break;
@@ -1804,6 +1807,7 @@ TokenStream::getTokenInternal(TokenKind* ttp, Modifier modifier)
 
         skipline:
             do {
+                userbuf.skipToEOL();
                 if (!getChar(&c))
                     goto error;
             } while (c != EOF && c != '\n');
@@ -1818,6 +1822,7 @@ TokenStream::getTokenInternal(TokenKind* ttp, Modifier modifier)
             unsigned linenoBefore = lineno;
 
             do {
+                userbuf.skipMultiLineCommentChars();
                 if (!getChar(&c))
                     return false;
 
@@ -1985,8 +1990,19 @@ TokenStream::getStringOrTemplateToken(int untilChar, Token** tp)
 
     // We need to detect any of these chars:  " or ', \n (or its
     // equivalents), \\, EOF.  Because we detect EOL sequences here and
-    // put them back immediately, we can use getCharIgnoreEOL().
-    while ((c = getCharIgnoreEOL()) != untilChar) {
+    // put them back immediately, we can use getCharIgnoreEOL().  Runs of
+    // other chars are copied to tokenbuf at once.
+    while (true) {
+        const CharT* run = userbuf.addressOfNextRawChar();
+        userbuf.skipStringChars(untilChar);
+        if (!tokenbuf.append(run, userbuf.addressOfNextRawChar())) {
+            ReportOutOfMemory(cx);
+            return false;
+        }
+
+        if ((c = getCharIgnoreEOL()) == untilChar)
+            break;
+
         if (c == EOF) {
             ungetCharIgnoreEOL(c);
             error(JSMSG_UNTERMINATED_STRING);
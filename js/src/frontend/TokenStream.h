@@ -1030,6 +1030,56 @@ class MOZ_STACK_CLASS TokenStream final : public TokenStreamAnyChars
         // have been scanned (*including* the char at startOffset_).
         size_t findEOLMax(size_t start, size_t max);
 
+        // The following functions skip a run of raw chars which TokenStream
+        // would otherwise consume one at a time.  They never skip an EOL
+        // char, so the line-related state does not need to be updated.
+
+        // Skip ASCII chars which are part of an identifier.  Non-ASCII chars
+        // and escapes end the run and have to be handled by the caller.
+        void skipAsciiIdentifierPart() {
+            const CharT* p = ptr;
+            while (p < limit_ && *p < 128 && js_isident[*p])
+                p++;
+            ptr = p;
+        }
+
+        // Skip ' ' and '\t', the usual indentation chars.
+        void skipAsciiSpace() {
+            const CharT* p = ptr;
+            while (p < limit_ && (*p == ' ' || *p == '\t'))
+                p++;
+            ptr = p;
+        }
+
+        // Skip everything up to the next EOL char.
+        void skipToEOL() {
+            const CharT* p = ptr;
+            while (p < limit_ && !isRawEOLChar(*p))
+                p++;
+            ptr = p;
+        }
+
+        // Skip the body of a multi-line comment, stopping before any char
+        // which might end it or start a directive.
+        void skipMultiLineCommentChars() {
+            const CharT* p = ptr;
+            while (p < limit_ && *p != '*' && *p != '@' && *p != '#' && !isRawEOLChar(*p))
+                p++;
+            ptr = p;
+        }
+
+        // Skip the chars of a string or template literal which stand for
+        // themselves, stopping before |untilChar|, escapes, '$' and EOL chars.
+        void skipStringChars(CharT untilChar) {
+            const CharT* p = ptr;
+            while (p < limit_ && *p != untilChar && *p != '\\' && *p != '$' &&
+                   !isRawEOLChar(*p))
+            {
+                p++;
+            }
+            ptr = p;
+        }
+
       private:
         const CharT* base_;          // base of buffer
         uint32_t startOffset_;          // offset of base_[0]
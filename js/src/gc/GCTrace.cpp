@@ -240,4 +240,22 @@ js::gc::TraceMajorGCEnd()
     TraceEvent(TraceEventMajorGCEnd);
 }
 
+void
+js::gc::TraceBackgroundFinalize(unsigned task, size_t arenas, uint64_t microseconds)
+{
+    if (!gcTraceFile)
+        return;
+
+    // Background finalization runs on several threads at once, so write the
+    // event and its data with a single call to keep them together.
+    MOZ_ASSERT(task <= UINT8_MAX);
+    MOZ_ASSERT((uint64_t(arenas) >> TracePayloadBits) == 0);
+    uint64_t words[2] = {
+        (uint64_t(TraceEventBackgroundFinalize) << TraceEventShift) |
+        (uint64_t(task) << TraceExtraShift) | uint64_t(arenas),
+        (uint64_t(TraceDataInt) << TraceEventShift) | uint64_t(uint32_t(microseconds))
+    };
+    fwrite(words, sizeof(words), 1, gcTraceFile);
+}
+
 #endif
@@ -29,6 +29,7 @@ extern void TraceMinorGCEnd();
 extern void TraceMajorGCStart();
 extern void TraceTenuredFinalize(Cell* thing);
 extern void TraceMajorGCEnd();
+extern void TraceBackgroundFinalize(unsigned task, size_t arenas, uint64_t microseconds);
 extern void TraceTypeNewScript(js::ObjectGroup* group);
 
 #else
@@ -45,6 +46,7 @@ inline void TraceMinorGCEnd() {}
 inline void TraceMajorGCStart() {}
 inline void TraceTenuredFinalize(Cell* thing) {}
 inline void TraceMajorGCEnd() {}
+inline void TraceBackgroundFinalize(unsigned task, size_t arenas, uint64_t microseconds) {}
 inline void TraceTypeNewScript(js::ObjectGroup* group) {}
 
 #endif
@@ -32,15 +32,16 @@ enum GCTraceEvent {
     TraceEventMajorGCStart,
     TraceEventTenuredFinalize,
     TraceEventMajorGCEnd,
+    TraceEventBackgroundFinalize,
 
     TraceDataAddress,  // following TraceEventPromote
-    TraceDataInt,      // following TraceEventClassInfo
+    TraceDataInt,      // following TraceEventClassInfo and TraceEventBackgroundFinalize
     TraceDataString,   // following TraceEventClassInfo
 
     GCTraceEventCount
 };
 
-const unsigned TraceFormatVersion = 1;
+const unsigned TraceFormatVersion = 2;
 
 const unsigned TracePayloadBits = 48;
 
@@ -149,6 +149,7 @@ PhaseKindGraphRoots = [
         PhaseKind("COMPACT_UPDATE", "Compact Update", 42, [
             MarkRootsPhaseKind,
             PhaseKind("COMPACT_UPDATE_CELLS", "Compact Update Cells", 43),
+            PhaseKind("COMPACT_UPDATE_WEAK", "Compact Update Weak Pointers", 71),
             JoinParallelTasksPhaseKind
         ]),
     ]),
@@ -19,6 +19,7 @@
 #include "gc/GCInternals.h"
 #include "gc/Policy.h"
 #include "jit/IonCode.h"
+#include "jit/JitCompartment.h"
 #include "js/SliceBudget.h"
 #include "vm/ArgumentsObject.h"
 #include "vm/ArrayObject.h"
@@ -2774,6 +2775,10 @@ TraceBufferedCells(TenuringTracer& mover, Arena* arena, ArenaCellSet* cells)
 void
 js::gc::StoreBuffer::traceWholeCells(TenuringTracer& mover)
 {
+    // Tracing JitCode updates the nursery pointers embedded in it. Only
+    // reprotect each page of code once.
+    jit::AutoWritableJitCodeBatch batch(TlsContext.get());
+
     for (ArenaCellSet* cells = bufferWholeCell; cells; cells = cells->next) {
         Arena* arena = cells->arena;
 
@@ -493,6 +493,7 @@ js::Nursery::renderProfileJSON(JSONPrinter& json) const
     json.floatProperty("promotion_rate",
                        100.0 * previousGC.tenuredBytes / double(previousGC.nurseryUsedBytes), 2);
     json.property("nursery_bytes", previousGC.nurseryUsedBytes);
+    json.property("groups_pretenured", previousGC.groupsPretenured);
     json.property("new_nursery_bytes", numChunks() * ChunkSize);
 
     json.beginObjectProperty("timings");
@@ -633,11 +634,13 @@ js::Nursery::collect(JS::gcreason::Reason reason)
                 if (group->canPreTenure()) {
                     AutoCompartment ac(cx, group);
                     group->setShouldPreTenure(cx);
+                    rt->gc.stats().count(gcstats::STAT_OBJECT_GROUP_PRETENURED);
                     pretenureCount++;
                 }
             }
         }
     }
+    previousGC.groupsPretenured = pretenureCount;
     endProfile(ProfileKey::Pretenure);
 
     // We ignore gcMaxBytes when allocating for minor collection. However, if we
@@ -357,6 +357,7 @@ class Nursery
         JS::gcreason::Reason reason;
         uint64_t nurseryUsedBytes;
         uint64_t tenuredBytes;
+        uint32_t groupsPretenured;
     } previousGC;
 
     /*
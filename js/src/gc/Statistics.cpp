@@ -411,6 +411,8 @@ Statistics::formatDetailedDescription() const
   Compartments Collected: %d of %d (-%d)\n\
   MinorGCs since last GC: %d\n\
   Store Buffer Overflows: %d\n\
+  Store Buffer Compactions: %d\n\
+  Object Groups Pretenured: %d\n\
   MMU 20ms:%.1f%%; 50ms:%.1f%%\n\
   SCC Sweep Total (MaxPause): %.3fms (%.3fms)\n\
   HeapSize: %.3f MiB\n\
@@ -428,6 +430,8 @@ Statistics::formatDetailedDescription() const
                    zoneStats.sweptCompartmentCount,
                    getCount(STAT_MINOR_GC),
                    getCount(STAT_STOREBUFFER_OVERFLOW),
+                   getCount(STAT_STOREBUFFER_COMPACTION),
+                   getCount(STAT_OBJECT_GROUP_PRETENURED),
                    mmu20 * 100., mmu50 * 100.,
                    t(sccTotal), t(sccLongest),
                    double(preBytes) / bytesPerMiB,
@@ -596,6 +600,7 @@ Statistics::formatJsonDescription(uint64_t timestamp, JSONPrinter& json) const
     json.property("total_compartments", zoneStats.compartmentCount);
     json.property("minor_gcs", counts[STAT_MINOR_GC]);
     json.property("store_buffer_overflows", counts[STAT_STOREBUFFER_OVERFLOW]);
+    json.property("groups_pretenured", counts[STAT_OBJECT_GROUP_PRETENURED]);
     json.property("slices", slices_.length());
 
     const double mmu20 = computeMMU(TimeDuration::FromMilliseconds(20));
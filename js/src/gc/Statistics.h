@@ -44,9 +44,16 @@ enum Stat {
     // compaction
     STAT_STOREBUFFER_OVERFLOW,
 
+    // Number of times an overflowing slots storebuffer was compacted enough
+    // to avoid a minor GC.
+    STAT_STOREBUFFER_COMPACTION,
+
     // Number of arenas relocated by compacting GC.
     STAT_ARENA_RELOCATED,
 
+    // Number of object groups switched to tenured allocation after a minor GC.
+    STAT_OBJECT_GROUP_PRETENURED,
+
     STAT_LIMIT
 };
 
@@ -147,6 +147,59 @@ js::gc::AllocateWholeCellSet(Arena* arena)
     return cells;
 }
 
+template <typename T>
+bool
+StoreBuffer::MonoTypeBuffer<T>::compact(StoreBuffer* owner)
+{
+    // The set already holds every edge only once.
+    return false;
+}
+
+template <>
+bool
+StoreBuffer::MonoTypeBuffer<StoreBuffer::SlotsEdge>::compact(StoreBuffer* owner)
+{
+    // Loops writing to the slots of several objects in turn defeat the
+    // coalescing in putSlot and fill the buffer with many small ranges for the
+    // same objects. Sort the edges and merge the ranges of each object that
+    // are at most MaxGap slots apart. Tracing the slots in the gaps is
+    // harmless: they are traced like any other slot of a tenured object.
+    static const int32_t MaxGap = 32;
+
+    Vector<SlotsEdge, 0, SystemAllocPolicy> edges;
+    if (!edges.reserve(stores_.count()))
+        return false;
+    for (typename StoreSet::Range r = stores_.all(); !r.empty(); r.popFront())
+        edges.infallibleAppend(r.front());
+    std::sort(edges.begin(), edges.end());
+
+    stores_.clear();
+
+    AutoEnterOOMUnsafeRegion oomUnsafe;
+    SlotsEdge current = edges[0];
+    for (size_t i = 1; i < edges.length(); i++) {
+        const SlotsEdge& edge = edges[i];
+        int32_t currentEnd = current.start_ + current.count_;
+        if (edge.objectAndKind_ == current.objectAndKind_ && edge.start_ <= currentEnd + MaxGap) {
+            current.count_ = Max(currentEnd, edge.start_ + edge.count_) - current.start_;
+            continue;
+        }
+        if (!stores_.put(current))
+            oomUnsafe.crash("Failed to allocate for MonoTypeBuffer::compact.");
+        current = edge;
+    }
+    if (!stores_.put(current))
+        oomUnsafe.crash("Failed to allocate for MonoTypeBuffer::compact.");
+
+    // Only report success if there is enough room left to make the next
+    // compaction worthwhile.
+    if (stores_.count() > MaxEntries / 2)
+        return false;
+
+    owner->runtime_->gc.stats().count(gcstats::STAT_STOREBUFFER_COMPACTION);
+    return true;
+}
+
 template struct StoreBuffer::MonoTypeBuffer<StoreBuffer::ValueEdge>;
 template struct StoreBuffer::MonoTypeBuffer<StoreBuffer::CellPtrEdge>;
 template struct StoreBuffer::MonoTypeBuffer<StoreBuffer::SlotsEdge>;
@@ -121,10 +121,18 @@ class StoreBuffer
             }
             last_ = T();
 
-            if (MOZ_UNLIKELY(stores_.count() > MaxEntries))
-                owner->setAboutToOverflow(T::FullBufferReason);
+            if (MOZ_UNLIKELY(stores_.count() > MaxEntries)) {
+                if (owner->isAboutToOverflow() || !compact(owner))
+                    owner->setAboutToOverflow(T::FullBufferReason);
+            }
         }
 
+        /*
+         * Called when the buffer overflows. Returns true if entries could be
+         * coalesced to leave enough room to delay the minor GC.
+         */
+        bool compact(StoreBuffer* owner);
+
         bool has(StoreBuffer* owner, const T& v) {
             sinkStore(owner);
             return stores_.has(v);
@@ -347,6 +355,13 @@ class StoreBuffer
         } Hasher;
 
         static const auto FullBufferReason = JS::gcreason::FULL_SLOT_BUFFER;
+
+        // Order edges by object and kind, then by start.
+        bool operator<(const SlotsEdge& other) const {
+            if (objectAndKind_ != other.objectAndKind_)
+                return objectAndKind_ < other.objectAndKind_;
+            return start_ < other.start_;
+        }
     };
 
     template <typename Buffer, typename Edge>
@@ -447,6 +462,12 @@ class StoreBuffer
     void addSizeOfExcludingThis(mozilla::MallocSizeOf mallocSizeOf, JS::GCSizes* sizes);
 };
 
+// Slot edges of the same object can be merged into a single range, see
+// StoreBuffer.cpp.
+template <>
+bool
+StoreBuffer::MonoTypeBuffer<StoreBuffer::SlotsEdge>::compact(StoreBuffer* owner);
+
 // A set of cells in an arena used to implement the whole cell store buffer.
 class ArenaCellSet
 {
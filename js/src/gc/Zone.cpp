@@ -53,6 +53,7 @@ JS::Zone::Zone(JSRuntime* rt, ZoneGroup* group)
     nurseryShapes_(group),
     data(group, nullptr),
     isSystem(group, false),
+    isBackground(false),
 #ifdef DEBUG
     gcLastSweepGroupIndex(group, 0),
 #endif
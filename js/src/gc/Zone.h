@@ -532,6 +532,11 @@ struct Zone : public JS::shadow::Zone,
 
     js::ZoneGroupData<bool> isSystem;
 
+    // Set by the embedder for zones which are not visible to the user, e.g.
+    // those of background tabs. Helper threads give lower priority to work
+    // for such zones, so this is read without holding any lock.
+    mozilla::Atomic<bool> isBackground;
+
     bool usedByHelperThread() {
         return !isAtomsZone() && group()->usedByHelperThread;
     }
@@ -10,6 +10,7 @@
 
 #include "jit/IonBuilder.h"
 #include "jit/JitCompartment.h"
+#include "vm/RegExpShared.h"
 
 using namespace js;
 
@@ -25,6 +26,7 @@ ZoneGroup::ZoneGroup(JSRuntime* runtime)
     ionBailAfter_(this, 0),
 #endif
     jitZoneGroup(this, nullptr),
+    regExpCodeCache(this, nullptr),
     debuggerList_(this),
     numFinishedBuilders(0),
     ionLazyLinkListSize_(0)
@@ -39,6 +41,10 @@ ZoneGroup::init()
     if (!jitZoneGroup)
         return false;
 
+    regExpCodeCache = js_new<RegExpCodeCache>();
+    if (!regExpCodeCache || !regExpCodeCache->init())
+        return false;
+
     return true;
 }
 
@@ -53,6 +59,7 @@ ZoneGroup::~ZoneGroup()
 #endif
 
     js_delete(jitZoneGroup.ref());
+    js_delete(regExpCodeCache.ref());
 
     if (this == runtime->gc.systemZoneGroup)
         runtime->gc.systemZoneGroup = nullptr;
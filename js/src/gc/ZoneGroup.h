@@ -18,6 +18,7 @@ namespace js {
 namespace jit { class JitZoneGroup; }
 
 class AutoKeepAtoms;
+class RegExpCodeCache;
 
 typedef Vector<JS::Zone*, 4, SystemAllocPolicy> ZoneVector;
 
@@ -97,6 +98,9 @@ class ZoneGroup
 
     ZoneGroupData<jit::JitZoneGroup*> jitZoneGroup;
 
+    // Native RegExp code shared by all zones in the group.
+    ZoneGroupData<RegExpCodeCache*> regExpCodeCache;
+
   private:
     /* Linked list of all Debugger objects in the group. */
     ZoneGroupData<mozilla::LinkedList<js::Debugger>> debuggerList_;
@@ -30,6 +30,8 @@
 
 #include "irregexp/NativeRegExpMacroAssembler.h"
 
+#include "jscompartment.h"
+
 #include "irregexp/RegExpStack.h"
 #include "jit/Linker.h"
 #ifdef JS_ION_PERF
@@ -38,6 +40,8 @@
 #include "vm/MatchPairs.h"
 #include "vtune/VTuneWrapper.h"
 
+#include "jscompartmentinlines.h"
+
 #include "jit/MacroAssembler-inl.h"
 
 using namespace js;
@@ -67,9 +71,10 @@ using namespace js::jit;
 
 NativeRegExpMacroAssembler::NativeRegExpMacroAssembler(JSContext* cx, LifoAlloc* alloc,
                                                        Mode mode, int registers_to_save,
-                                                       RegExpShared::JitCodeTables& tables)
+                                                       RegExpShared::JitCodeTables& tables,
+                                                       bool shareCode)
   : RegExpMacroAssembler(cx, *alloc, registers_to_save),
-    tables(tables), cx(cx), mode_(mode)
+    tables(tables), cx(cx), mode_(mode), shareCode_(shareCode)
 {
     // Find physical registers for each compiler register.
     AllocatableGeneralRegisterSet regs(GeneralRegisterSet::All());
@@ -491,7 +496,16 @@ NativeRegExpMacroAssembler::GenerateCode(JSContext* cx, bool match_only)
 
     Linker linker(masm);
     AutoFlushICache afc("RegExp");
-    JitCode* code = linker.newCode<NoGC>(cx, REGEXP_CODE);
+    JitCode* code;
+    if (shareCode_) {
+        // Everything else, including the owner context address, comes from
+        // the current zone group.
+        AutoLockForExclusiveAccess lock(cx);
+        AutoAtomsCompartment ac(cx, lock);
+        code = linker.newCode<NoGC>(cx, REGEXP_CODE);
+    } else {
+        code = linker.newCode<NoGC>(cx, REGEXP_CODE);
+    }
     if (!code) {
         ReportOutOfMemory(cx);
         return RegExpCode();
@@ -88,8 +88,10 @@ class MOZ_STACK_CLASS NativeRegExpMacroAssembler final : public RegExpMacroAssem
     // Type of input string to generate code for.
     enum Mode { LATIN1 = 1, CHAR16 = 2 };
 
+    // If |shareCode| is set, the code is allocated in the atoms zone so that
+    // it can be used by all zones in the zone group, see RegExpCodeCache.
     NativeRegExpMacroAssembler(JSContext* cx, LifoAlloc* alloc, Mode mode, int registers_to_save,
-                               RegExpShared::JitCodeTables& tables);
+                               RegExpShared::JitCodeTables& tables, bool shareCode);
 
     // Inherited virtual methods.
     RegExpCode GenerateCode(JSContext* cx, bool match_only);
@@ -177,6 +179,7 @@ class MOZ_STACK_CLASS NativeRegExpMacroAssembler final : public RegExpMacroAssem
 
     JSContext* cx;
     Mode mode_;
+    bool shareCode_;
     jit::Label entry_label_;
     jit::Label start_label_;
     jit::Label backtrack_label_;
@@ -1732,7 +1732,7 @@ RegExpCode
 irregexp::CompilePattern(JSContext* cx, HandleRegExpShared shared, RegExpCompileData* data,
                          HandleLinearString sample, bool is_global, bool ignore_case,
                          bool is_latin1, bool match_only, bool force_bytecode, bool sticky,
-                         bool unicode, RegExpShared::JitCodeTables& tables)
+                         bool unicode, bool share_code, RegExpShared::JitCodeTables& tables)
 {
     if ((data->capture_count + 1) * 2 - 1 > RegExpMacroAssembler::kMaxRegister) {
         JS_ReportErrorASCII(cx, "regexp too big");
@@ -1827,7 +1827,8 @@ irregexp::CompilePattern(JSContext* cx, HandleRegExpShared shared, RegExpCompile
                       : NativeRegExpMacroAssembler::CHAR16;
 
         ctx.emplace(cx, (jit::TempAllocator*) nullptr);
-        native_assembler.emplace(cx, &alloc, mode, (data->capture_count + 1) * 2, tables);
+        native_assembler.emplace(cx, &alloc, mode, (data->capture_count + 1) * 2, tables,
+                                 share_code);
         assembler = native_assembler.ptr();
     } else {
         interpreted_assembler.emplace(cx, &alloc, (data->capture_count + 1) * 2);
@@ -1158,7 +1158,7 @@ BacktrackingAllocator::mergeAndQueueRegisters()
                     return false;
                 bundle->setSpillSet(spill);
 
-                size_t priority = computePriority(bundle);
+                size_t priority = computeQueuePriority(bundle);
                 if (!allocationQueue.insert(QueueItem(bundle, priority)))
                     return false;
             }
@@ -1300,7 +1300,12 @@ BacktrackingAllocator::processBundle(MIRGenerator* mir, LiveBundle* bundle)
 
             // If that didn't work, but we have one or more non-fixed bundles
             // known to be conflicting, maybe we can evict them and try again.
-            if ((attempt < MAX_ATTEMPTS || minimalBundle(bundle)) &&
+            // In linear scan mode, only minimal bundles, which cannot be split
+            // any further, evict other bundles.
+            bool mayEvict = linearScan
+                            ? minimalBundle(bundle)
+                            : attempt < MAX_ATTEMPTS || minimalBundle(bundle);
+            if (mayEvict &&
                 !fixed &&
                 !conflicting.empty() &&
                 maximumSpillWeight(conflicting) < computeSpillWeight(bundle))
@@ -1497,7 +1502,7 @@ BacktrackingAllocator::evictBundle(LiveBundle* bundle)
 
     bundle->setAllocation(LAllocation());
 
-    size_t priority = computePriority(bundle);
+    size_t priority = computeQueuePriority(bundle);
     return allocationQueue.insert(QueueItem(bundle, priority));
 }
 
@@ -1529,7 +1534,7 @@ BacktrackingAllocator::splitAndRequeueBundles(LiveBundle* bundle,
     // Queue the new bundles for register assignment.
     for (size_t i = 0; i < newBundles.length(); i++) {
         LiveBundle* newBundle = newBundles[i];
-        size_t priority = computePriority(newBundle);
+        size_t priority = computeQueuePriority(newBundle);
         if (!allocationQueue.insert(QueueItem(newBundle, priority)))
             return false;
     }
@@ -2446,6 +2451,16 @@ BacktrackingAllocator::computePriority(LiveBundle* bundle)
     return lifetimeTotal;
 }
 
+size_t
+BacktrackingAllocator::computeQueuePriority(LiveBundle* bundle)
+{
+    // In linear scan mode, bundles which start earlier are processed first.
+    if (linearScan)
+        return UINT32_MAX - bundle->firstRange()->from().bits();
+
+    return computePriority(bundle);
+}
+
 bool
 BacktrackingAllocator::minimalDef(LiveRange* range, LNode* ins)
 {
@@ -3130,6 +3145,16 @@ BacktrackingAllocator::splitAcrossCalls(LiveBundle* bundle)
 bool
 BacktrackingAllocator::chooseBundleSplit(LiveBundle* bundle, bool fixed, LiveBundle* conflict)
 {
+    if (linearScan) {
+        // Don't search for a good split: the spill bundle covers the whole
+        // bundle and each register use gets a minimal bundle.
+        if (fixed)
+            return splitAcrossCalls(bundle);
+
+        SplitPositionVector emptyPositions;
+        return splitAt(bundle, emptyPositions);
+    }
+
     bool success = false;
 
     if (!trySplitAcrossHotcode(bundle, &success))
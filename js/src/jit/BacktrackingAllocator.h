@@ -594,6 +594,13 @@ class BacktrackingAllocator : protected RegisterAllocator
     // This flag is set when testing new allocator modifications.
     bool testbed;
 
+    // This flag is set to trade code quality for allocation speed on very
+    // large graphs. Bundles are then processed in order of their start
+    // position, as in a linear scan allocator, and a bundle which cannot be
+    // allocated is split around all its register uses right away instead of
+    // trying the splitting heuristics and evicting other bundles.
+    bool linearScan;
+
     BitSet* liveIn;
     FixedList<VirtualRegister> vregs;
 
@@ -675,9 +682,11 @@ class BacktrackingAllocator : protected RegisterAllocator
     Vector<LiveBundle*, 4, SystemAllocPolicy> spilledBundles;
 
   public:
-    BacktrackingAllocator(MIRGenerator* mir, LIRGenerator* lir, LIRGraph& graph, bool testbed)
+    BacktrackingAllocator(MIRGenerator* mir, LIRGenerator* lir, LIRGraph& graph, bool testbed,
+                          bool linearScan = false)
       : RegisterAllocator(mir, lir, graph),
         testbed(testbed),
+        linearScan(linearScan),
         liveIn(nullptr),
         callRanges(nullptr)
     { }
@@ -792,6 +801,7 @@ class BacktrackingAllocator : protected RegisterAllocator
     // Heuristic methods.
 
     size_t computePriority(LiveBundle* bundle);
+    size_t computeQueuePriority(LiveBundle* bundle);
     size_t computeSpillWeight(LiveBundle* bundle);
 
     size_t maximumSpillWeight(const LiveBundleVector& bundles);
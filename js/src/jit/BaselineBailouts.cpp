@@ -1572,8 +1572,10 @@ jit::BailoutIonToBaseline(JSContext* cx, JitActivation* activation, JitFrameIter
     JitSpew(JitSpew_BaselineBailouts, "  Reading from snapshot offset %u size %zu",
             iter.snapshotOffset(), iter.ionScript()->snapshotsListSize());
 
-    if (!excInfo)
+    if (!excInfo) {
         iter.ionScript()->incNumBailouts();
+        NoteIonBailout(iter.script());
+    }
     iter.script()->updateBaselineOrIonRaw(cx->runtime());
 
     // Allocate buffer to hold stack replacement data.
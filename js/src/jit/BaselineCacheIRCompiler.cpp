@@ -2251,6 +2251,27 @@ BaselineCacheIRCompiler::init(CacheKind kind)
 
 static const size_t MaxOptimizedCacheIRStubs = 16;
 
+static JitCode*
+CompileBaselineCacheIRStubCode(JSContext* cx, const CacheIRWriter& writer, CacheKind kind,
+                               ICStubEngine engine, uint32_t stubDataOffset,
+                               CacheIRStubInfo** stubInfo)
+{
+    JitContext jctx(cx, nullptr);
+    BaselineCacheIRCompiler comp(cx, writer, engine, stubDataOffset);
+    if (!comp.init(kind))
+        return nullptr;
+
+    JitCode* code = comp.compile();
+    if (!code)
+        return nullptr;
+
+    *stubInfo = CacheIRStubInfo::New(kind, engine, comp.makesGCCalls(), stubDataOffset, writer);
+    if (!*stubInfo)
+        return nullptr;
+
+    return code;
+}
+
 ICStub*
 js::jit::AttachBaselineCacheIRStub(JSContext* cx, const CacheIRWriter& writer,
                                    CacheKind kind, BaselineCacheIRStubKind stubKind,
@@ -2284,31 +2305,41 @@ js::jit::AttachBaselineCacheIRStub(JSContext* cx, const CacheIRWriter& writer,
     }
 
     JitZone* jitZone = cx->zone()->jitZone();
+    JitRuntime* jitRuntime = cx->runtime()->jitRuntime();
 
-    // Check if we already have JitCode for this stub.
+    // Check if we already have JitCode for this stub, either in this zone or
+    // shared by all zones.
     CacheIRStubInfo* stubInfo;
     CacheIRStubKey::Lookup lookup(kind, engine, writer.codeStart(), writer.codeLength());
     JitCode* code = jitZone->getBaselineCacheIRStubCode(lookup, &stubInfo);
     if (!code) {
-        // We have to generate stub code.
-        JitContext jctx(cx, nullptr);
-        BaselineCacheIRCompiler comp(cx, writer, engine, stubDataOffset);
-        if (!comp.init(kind))
-            return nullptr;
-
-        code = comp.compile();
+        AutoLockForExclusiveAccess lock(cx);
+        code = jitRuntime->getSharedBaselineCacheIRStubCode(lookup, &stubInfo, lock);
+        if (!code && jitRuntime->canShareBaselineCacheIRStubCode(lock)) {
+            // Generate the stub code in the atoms zone so that other zones
+            // can use it too. Note that the putSharedBaselineCacheIRStubCode
+            // call below will transfer ownership of the CacheIRStubInfo to the
+            // stub code HashMap, so we don't have to worry about freeing it.
+            AutoAtomsCompartment ac(cx, lock);
+            code = CompileBaselineCacheIRStubCode(cx, writer, kind, engine, stubDataOffset,
+                                                  &stubInfo);
+            if (!code)
+                return nullptr;
+
+            CacheIRStubKey key(stubInfo);
+            if (!jitRuntime->putSharedBaselineCacheIRStubCode(lookup, key, code, lock))
+                return nullptr;
+        }
+    }
+    if (!code) {
+        // The shared stub code has reached its size limit: generate stub code
+        // for this zone only. As above, putBaselineCacheIRStubCode takes
+        // ownership of the CacheIRStubInfo.
+        code = CompileBaselineCacheIRStubCode(cx, writer, kind, engine, stubDataOffset,
+                                              &stubInfo);
         if (!code)
             return nullptr;
 
-        // Allocate the shared CacheIRStubInfo. Note that the
-        // putBaselineCacheIRStubCode call below will transfer ownership
-        // to the stub code HashMap, so we don't have to worry about freeing
-        // it below.
-        MOZ_ASSERT(!stubInfo);
-        stubInfo = CacheIRStubInfo::New(kind, engine, comp.makesGCCalls(), stubDataOffset, writer);
-        if (!stubInfo)
-            return nullptr;
-
         CacheIRStubKey key(stubInfo);
         if (!jitZone->putBaselineCacheIRStubCode(lookup, key, code))
             return nullptr;
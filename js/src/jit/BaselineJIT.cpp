@@ -81,9 +81,36 @@ BaselineScript::BaselineScript(uint32_t prologueOffset, uint32_t epilogueOffset,
     inlinedBytecodeLength_(0),
     maxInliningDepth_(UINT8_MAX),
     pendingBuilder_(nullptr),
+    ionCompileHistory_(),
     controlFlowGraph_(nullptr)
 { }
 
+void
+IonCompileHistory::noteCancelled(uint64_t compileMicroseconds)
+{
+    cancels++;
+    consecutiveCancels++;
+    wastedMicroseconds += compileMicroseconds;
+
+    // A single cancellation is usually a GC which happened to start during
+    // the compilation. Back off exponentially once they repeat.
+    static const uint32_t BackoffWarmUps = 1000;
+    static const uint32_t MaxBackoffShift = 6;
+    if (consecutiveCancels >= 2)
+        backoffWarmUps = BackoffWarmUps << Min(consecutiveCancels - 2, MaxBackoffShift);
+}
+
+bool
+IonCompileHistory::deferCompile(uint32_t warmUpCount)
+{
+    if (warmUpCount >= backoffWarmUps) {
+        backoffWarmUps = 0;
+        return false;
+    }
+    backoffWarmUps -= warmUpCount;
+    return true;
+}
+
 static const unsigned BASELINE_MAX_ARGS_LENGTH = 20000;
 
 static bool
@@ -1190,6 +1217,8 @@ jit::ToggleBaselineProfiling(JSRuntime* runtime, bool enable)
     if (!jrt)
         return;
 
+    AutoWritableJitCodeBatch batch(TlsContext.get());
+
     for (ZonesIter zone(runtime, SkipAtoms); !zone.done(); zone.next()) {
         for (auto script = zone->cellIter<JSScript>(); !script.done(); script.next()) {
             if (!script->hasBaselineScript())
@@ -1204,6 +1233,8 @@ jit::ToggleBaselineProfiling(JSRuntime* runtime, bool enable)
 void
 jit::ToggleBaselineTraceLoggerScripts(JSRuntime* runtime, bool enable)
 {
+    AutoWritableJitCodeBatch batch(TlsContext.get());
+
     for (ZonesIter zone(runtime, SkipAtoms); !zone.done(); zone.next()) {
         for (auto script = zone->cellIter<JSScript>(); !script.done(); script.next()) {
             if (!script->hasBaselineScript())
@@ -1216,6 +1247,8 @@ jit::ToggleBaselineTraceLoggerScripts(JSRuntime* runtime, bool enable)
 void
 jit::ToggleBaselineTraceLoggerEngine(JSRuntime* runtime, bool enable)
 {
+    AutoWritableJitCodeBatch batch(TlsContext.get());
+
     for (ZonesIter zone(runtime, SkipAtoms); !zone.done(); zone.next()) {
         for (auto script = zone->cellIter<JSScript>(); !script.done(); script.next()) {
             if (!script->hasBaselineScript())
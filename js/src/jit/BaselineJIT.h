@@ -108,6 +108,50 @@ struct DependentWasmImport
     { }
 };
 
+// Outcome of the Ion compilations of a script. Off thread compilations are
+// cancelled whenever a GC or an invalidation needs their zone, which throws
+// away the work done so far. Scripts whose compilations keep being cancelled
+// have to warm up for longer before being compiled again.
+struct IonCompileHistory
+{
+    // Number of compilations linked, cancelled and bailed out of.
+    uint32_t compiles;
+    uint32_t cancels;
+    uint32_t bailouts;
+
+    // Number of compilations cancelled since the last linked one.
+    uint32_t consecutiveCancels;
+
+    // Number of warm-ups to wait for before compiling the script again.
+    uint32_t backoffWarmUps;
+
+    // Helper thread time spent on cancelled compilations.
+    uint64_t wastedMicroseconds;
+
+    IonCompileHistory()
+      : compiles(0),
+        cancels(0),
+        bailouts(0),
+        consecutiveCancels(0),
+        backoffWarmUps(0),
+        wastedMicroseconds(0)
+    { }
+
+    void noteCompiled() {
+        compiles++;
+        consecutiveCancels = 0;
+        backoffWarmUps = 0;
+    }
+    void noteCancelled(uint64_t compileMicroseconds);
+    void noteBailout() {
+        bailouts++;
+    }
+
+    // Account for |warmUpCount| warm-ups of the script, and return whether
+    // compiling it must still be deferred.
+    bool deferCompile(uint32_t warmUpCount);
+};
+
 struct BaselineScript
 {
   public:
@@ -245,6 +289,8 @@ struct BaselineScript
     // An ion compilation that is ready, but isn't linked yet.
     IonBuilder *pendingBuilder_;
 
+    IonCompileHistory ionCompileHistory_;
+
     ControlFlowGraph* controlFlowGraph_;
 
   public:
@@ -528,6 +574,10 @@ struct BaselineScript
             script->setIonScript(nullptr, nullptr);
     }
 
+    IonCompileHistory& ionCompileHistory() {
+        return ionCompileHistory_;
+    }
+
     const ControlFlowGraph* controlFlowGraph() const {
         return controlFlowGraph_;
     }
@@ -10,11 +10,14 @@
 #include "mozilla/MemoryReporting.h"
 #include "mozilla/ThreadLocal.h"
 
+#include <algorithm>
+
 #include "jscompartment.h"
 #include "jsgc.h"
 #include "jsprf.h"
 
 #include "gc/Marking.h"
+#include "gc/Memory.h"
 #include "jit/AliasAnalysis.h"
 #include "jit/AlignmentMaskAnalysis.h"
 #include "jit/BacktrackingAllocator.h"
@@ -50,6 +53,7 @@
 #include "jit/WasmBCE.h"
 #include "vm/Debugger.h"
 #include "vm/HelperThreads.h"
+#include "vm/RegExpShared.h"
 #include "vm/TraceLogging.h"
 #include "vtune/VTuneWrapper.h"
 
@@ -205,7 +209,9 @@ JitRuntime::JitRuntime(JSRuntime* rt)
     baselineDebugModeOSRHandler_(nullptr),
     functionWrappers_(nullptr),
     preventBackedgePatching_(false),
-    jitcodeGlobalTable_(nullptr)
+    jitcodeGlobalTable_(nullptr),
+    sharedBaselineCacheIRStubCodeBytes_(0),
+    reprotectCallsSaved_(0)
 {
 }
 
@@ -232,6 +238,11 @@ JitRuntime::initialize(JSContext* cx, AutoLockForExclusiveAccess& lock)
     if (!functionWrappers_ || !functionWrappers_->init())
         return false;
 
+    if (!sharedBaselineCacheIRStubCodes_.ref().init()) {
+        ReportOutOfMemory(cx);
+        return false;
+    }
+
     JitSpew(JitSpew_Codegen, "# Emitting profiler exit frame tail stub");
     profilerExitFrameTail_ = generateProfilerExitFrameTailStub(cx);
     if (!profilerExitFrameTail_)
@@ -484,6 +495,47 @@ jit::FreeIonBuilder(IonBuilder* builder)
     js_delete(builder->alloc().lifoAlloc());
 }
 
+static void
+SpewIonCompileHistory(JSScript* script, const char* event)
+{
+#ifdef JS_JITSPEW
+    if (!JitSpewEnabled(JitSpew_IonCompileStats))
+        return;
+
+    const IonCompileHistory& history = script->baselineScript()->ionCompileHistory();
+    JitSpewPrinter().printf("{\"event\":\"%s\",\"script\":\"%s:%zu\",\"compiles\":%u"
+                            ",\"cancels\":%u,\"consecutiveCancels\":%u,\"bailouts\":%u"
+                            ",\"wastedUs\":%" PRIu64 ",\"backoffWarmUps\":%u}\n",
+                            event, script->filename(), script->lineno(), history.compiles,
+                            history.cancels, history.consecutiveCancels, history.bailouts,
+                            history.wastedMicroseconds, history.backoffWarmUps);
+#endif
+}
+
+void
+jit::NoteIonCompileCancelled(IonBuilder* builder)
+{
+    JSScript* script = builder->script();
+    IonCompileHistory& history = script->baselineScript()->ionCompileHistory();
+    history.noteCancelled(uint64_t(builder->backgroundCompileTime().ToMicroseconds()));
+
+    // Count the backoff from now on, not from the warm-ups which triggered
+    // the cancelled compilation.
+    if (history.backoffWarmUps)
+        script->resetWarmUpCounter();
+
+    SpewIonCompileHistory(script, "cancel");
+}
+
+void
+jit::NoteIonBailout(JSScript* script)
+{
+    if (!script->hasBaselineScript())
+        return;
+    script->baselineScript()->ionCompileHistory().noteBailout();
+    SpewIonCompileHistory(script, "bailout");
+}
+
 void
 jit::FinishOffThreadBuilder(JSRuntime* runtime, IonBuilder* builder,
                             const AutoLockHelperThreadState& locked)
@@ -530,6 +582,8 @@ LinkCodeGen(JSContext* cx, IonBuilder* builder, CodeGenerator *codegen)
     if (!codegen->link(cx, builder->constraints()))
         return false;
 
+    script->baselineScript()->ionCompileHistory().noteCompiled();
+    SpewIonCompileHistory(script, "compile");
     return true;
 }
 
@@ -603,6 +657,25 @@ jit::LazyLinkTopActivation()
     return calleeScript->baselineOrIonRawPointer();
 }
 
+bool
+JitRuntime::putSharedBaselineCacheIRStubCode(const CacheIRStubKey::Lookup& lookup,
+                                             CacheIRStubKey& key, JitCode* stubCode,
+                                             AutoLockForExclusiveAccess& lock)
+{
+    // Shared stub code is kept alive by JitRuntime::Trace, like the other
+    // code in the atoms zone.
+    MOZ_ASSERT(stubCode->zone()->isAtomsZone());
+
+    SharedCacheIRStubCodeMap& stubCodes = sharedBaselineCacheIRStubCodes_.ref();
+    auto p = stubCodes.lookupForAdd(lookup);
+    MOZ_ASSERT(!p);
+    if (!stubCodes.add(p, Move(key), stubCode))
+        return false;
+
+    sharedBaselineCacheIRStubCodeBytes_.ref() += stubCode->instructionsSize();
+    return true;
+}
+
 /* static */ void
 JitRuntime::Trace(JSTracer* trc, AutoLockForExclusiveAccess& lock)
 {
@@ -613,11 +686,18 @@ JitRuntime::Trace(JSTracer* trc, AutoLockForExclusiveAccess& lock)
     if (trc->runtime()->atomsAreFinished())
         return;
 
+    // RegExp code in the atoms zone is owned by the zone groups' RegExp code
+    // caches, which trace it for as long as it may be used.
     Zone* zone = trc->runtime()->atomsCompartment(lock)->zone();
     for (auto i = zone->cellIter<JitCode>(); !i.done(); i.next()) {
         JitCode* code = i;
+        if (code->kind() == REGEXP_CODE)
+            continue;
         TraceRoot(trc, &code, "wrapper");
     }
+
+    for (ZoneGroupsIter group(trc->runtime()); !group.done(); group.next())
+        group->regExpCodeCache.ref()->trace(trc);
 }
 
 /* static */ void
@@ -1886,9 +1966,26 @@ GenerateLIR(MIRGenerator* mir)
 
         IonRegisterAllocator allocator = mir->optimizationInfo().registerAllocator();
 
+        // Backtracking allocation time grows much faster than linearly with
+        // the size of the function, so huge functions (e.g. in emscripten
+        // output) are allocated in linear scan mode unless the allocator has
+        // been forced.
+        if (allocator == RegisterAllocator_Backtracking &&
+            JitOptions.forcedRegisterAllocator.isNothing() &&
+            lir->numVirtualRegisters() >= JitOptions.linearScanAllocatorThreshold)
+        {
+            allocator = RegisterAllocator_LinearScan;
+        }
+
         switch (allocator) {
           case RegisterAllocator_Backtracking:
-          case RegisterAllocator_Testbed: {
+          case RegisterAllocator_Testbed:
+          case RegisterAllocator_LinearScan: {
+            bool linearScan = allocator == RegisterAllocator_LinearScan;
+            AutoTraceLog logAllocator(logger, linearScan
+                                              ? TraceLogger_LinearScanAllocation
+                                              : TraceLogger_BacktrackingAllocation);
+
 #ifdef DEBUG
             if (JitOptions.fullDebugChecks) {
                 if (!integrity.record())
@@ -1897,7 +1994,8 @@ GenerateLIR(MIRGenerator* mir)
 #endif
 
             BacktrackingAllocator regalloc(mir, &lirgen, *lir,
-                                           allocator == RegisterAllocator_Testbed);
+                                           allocator == RegisterAllocator_Testbed,
+                                           linearScan);
             if (!regalloc.go())
                 return nullptr;
 
@@ -1908,11 +2006,15 @@ GenerateLIR(MIRGenerator* mir)
             }
 #endif
 
-            gs.spewPass("Allocate Registers [Backtracking]");
+            gs.spewPass(linearScan
+                        ? "Allocate Registers [LinearScan]"
+                        : "Allocate Registers [Backtracking]");
             break;
           }
 
           case RegisterAllocator_Stupid: {
+            AutoTraceLog logAllocator(logger, TraceLogger_StupidAllocation);
+
             // Use the integrity checker to populate safepoint information, so
             // run it in all builds.
             if (!integrity.record())
@@ -2417,6 +2519,16 @@ Compile(JSContext* cx, HandleScript script, BaselineFrame* osrFrame, jsbytecode*
         return Method_Skipped;
     }
 
+    // Wait for the script to warm up again if its last compilations were
+    // cancelled.
+    IonCompileHistory& history = script->baselineScript()->ionCompileHistory();
+    if (!forceRecompile && history.deferCompile(script->getWarmUpCount())) {
+        JitSpew(JitSpew_IonAbort, "Deferred compilation of %s:%zu, %u warm-ups left",
+                script->filename(), script->lineno(), history.backoffWarmUps);
+        script->resetWarmUpCounter();
+        return Method_Skipped;
+    }
+
     if (script->hasIonScript()) {
         IonScript* scriptIon = script->ionScript();
         if (!scriptIon->method())
@@ -3122,6 +3234,7 @@ jit::InvalidateAll(FreeOp* fop, Zone* zone)
     if (zone->isAtomsZone())
         return;
     JSContext* cx = TlsContext.get();
+    AutoWritableJitCodeBatch batch(cx);
     for (const CooperatingContext& target : cx->runtime()->cooperatingContexts()) {
         for (JitActivationIterator iter(cx, target); !iter.done(); ++iter) {
             if (iter->compartment()->zone() == zone) {
@@ -3178,9 +3291,12 @@ jit::Invalidate(TypeZone& types, FreeOp* fop,
     JSRuntime::AutoProhibitActiveContextChange apacc(fop->runtime());
 
     JSContext* cx = TlsContext.get();
-    for (const CooperatingContext& target : cx->runtime()->cooperatingContexts()) {
-        for (JitActivationIterator iter(cx, target); !iter.done(); ++iter)
-            InvalidateActivation(fop, iter, false);
+    {
+        AutoWritableJitCodeBatch batch(cx);
+        for (const CooperatingContext& target : cx->runtime()->cooperatingContexts()) {
+            for (JitActivationIterator iter(cx, target); !iter.done(); ++iter)
+                InvalidateActivation(fop, iter, false);
+        }
     }
 
     // Drop the references added above. If a script was never active, its
@@ -3451,6 +3567,77 @@ AutoFlushICache::~AutoFlushICache()
 #endif
 }
 
+AutoWritableJitCodeBatch::AutoWritableJitCodeBatch(JSContext* cx)
+  : preventPatching_(cx->runtime()),
+    cx_(cx),
+    active_(!cx->autoWritableJitCodeBatch),
+    scopes_(0),
+    reprotectCalls_(0)
+{
+    if (active_)
+        cx_->autoWritableJitCodeBatch = this;
+}
+
+AutoWritableJitCodeBatch::~AutoWritableJitCodeBatch()
+{
+    if (!active_)
+        return;
+
+    MOZ_ASSERT(cx_->autoWritableJitCodeBatch == this);
+    cx_->autoWritableJitCodeBatch = nullptr;
+
+    // Restore the protection of adjacent ranges together.
+    std::sort(ranges_.begin(), ranges_.end(),
+              [](const Range& a, const Range& b) { return a.start < b.start; });
+    size_t i = 0;
+    while (i < ranges_.length()) {
+        uintptr_t start = ranges_[i].start;
+        uintptr_t end = ranges_[i].end;
+        for (i++; i < ranges_.length() && ranges_[i].start <= end; i++)
+            end = Max(end, ranges_[i].end);
+
+        if (!ExecutableAllocator::makeExecutable((void*)start, end - start))
+            MOZ_CRASH();
+        reprotectCalls_++;
+    }
+
+    // Without the batch, every scope would have reprotected its code twice.
+    MOZ_ASSERT(reprotectCalls_ <= 2 * scopes_);
+    if (JitRuntime* jrt = cx_->runtime()->jitRuntime())
+        jrt->addReprotectCallsSaved(2 * scopes_ - reprotectCalls_);
+}
+
+void
+AutoWritableJitCodeBatch::makeWritable(void* addr, size_t size)
+{
+    MOZ_ASSERT(active_);
+
+    size_t pageSize = gc::SystemPageSize();
+    uintptr_t start = uintptr_t(addr) & ~(pageSize - 1);
+    uintptr_t end = (uintptr_t(addr) + size + pageSize - 1) & ~(pageSize - 1);
+
+    // Consecutive patches usually hit the same code, so look at the last
+    // ranges first.
+    for (size_t i = ranges_.length(); i > 0; i--) {
+        const Range& range = ranges_[i - 1];
+        if (range.start <= start && end <= range.end) {
+            scopes_++;
+            return;
+        }
+    }
+
+    // Reprotecting the range at the end of its own scope could make pages
+    // shared with other ranges of the batch executable too early.
+    AutoEnterOOMUnsafeRegion oomUnsafe;
+    if (!ranges_.append(Range{start, end}))
+        oomUnsafe.crash("AutoWritableJitCodeBatch::makeWritable");
+
+    if (!ExecutableAllocator::makeWritable((void*)start, end - start))
+        MOZ_CRASH();
+    scopes_++;
+    reprotectCalls_++;
+}
+
 size_t
 jit::SizeOfIonData(JSScript* script, mozilla::MallocSizeOf mallocSizeOf)
 {
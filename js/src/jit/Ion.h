@@ -158,6 +158,11 @@ void FinishOffThreadBuilder(JSRuntime* runtime, IonBuilder* builder,
                             const AutoLockHelperThreadState& lock);
 void FreeIonBuilder(IonBuilder* builder);
 
+// Record in the script's IonCompileHistory that an off thread compilation was
+// thrown away before being linked.
+void NoteIonCompileCancelled(IonBuilder* builder);
+void NoteIonBailout(JSScript* script);
+
 void LinkIonScript(JSContext* cx, HandleScript calleescript);
 uint8_t* LazyLinkTopActivation();
 
@@ -11,6 +11,7 @@
 // JSScript.
 
 #include "mozilla/LinkedList.h"
+#include "mozilla/TimeStamp.h"
 
 #include "jit/BaselineInspector.h"
 #include "jit/BytecodeAnalysis.h"
@@ -924,6 +925,12 @@ class IonBuilder
     // performed by FinishOffThreadBuilder().
     CodeGenerator* backgroundCodegen_;
 
+    // When the builder was added to the helper thread worklist.
+    mozilla::TimeStamp queuedTime_;
+
+    // Time the helper thread spent in CompileBackEnd.
+    mozilla::TimeDuration backgroundCompileTime_;
+
     // Some aborts are actionable (e.g., using an unsupported bytecode). When
     // optimization tracking is enabled, the location and message of the abort
     // are recorded here so they may be propagated to the script's
@@ -948,6 +955,11 @@ class IonBuilder
     CodeGenerator* backgroundCodegen() const { return backgroundCodegen_; }
     void setBackgroundCodegen(CodeGenerator* codegen) { backgroundCodegen_ = codegen; }
 
+    mozilla::TimeStamp queuedTime() const { return queuedTime_; }
+    void setQueuedTime(mozilla::TimeStamp time) { queuedTime_ = time; }
+    mozilla::TimeDuration backgroundCompileTime() const { return backgroundCompileTime_; }
+    void setBackgroundCompileTime(mozilla::TimeDuration time) { backgroundCompileTime_ = time; }
+
     CompilerConstraintList* constraints() {
         return constraints_;
     }
@@ -102,6 +102,9 @@ class JitCode : public gc::TenuredCell
     size_t headerSize() const {
         return headerSize_;
     }
+    CodeKind kind() const {
+        return CodeKind(kind_);
+    }
 
     void traceChildren(JSTracer* trc);
     void finalize(FreeOp* fop);
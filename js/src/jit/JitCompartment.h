@@ -80,6 +80,45 @@ class PatchableBackedge : public InlineListNode<PatchableBackedge>
     {}
 };
 
+enum class CacheKind : uint8_t;
+class CacheIRStubInfo;
+
+enum class ICStubEngine : uint8_t {
+    // Baseline IC, see SharedIC.h and BaselineIC.h.
+    Baseline = 0,
+
+    // Ion IC that reuses Baseline IC code, see SharedIC.h.
+    IonSharedIC,
+
+    // Ion IC, see IonIC.h.
+    IonIC
+};
+
+struct CacheIRStubKey : public DefaultHasher<CacheIRStubKey> {
+    struct Lookup {
+        CacheKind kind;
+        ICStubEngine engine;
+        const uint8_t* code;
+        uint32_t length;
+
+        Lookup(CacheKind kind, ICStubEngine engine, const uint8_t* code, uint32_t length)
+          : kind(kind), engine(engine), code(code), length(length)
+        {}
+    };
+
+    static HashNumber hash(const Lookup& l);
+    static bool match(const CacheIRStubKey& entry, const Lookup& l);
+
+    UniquePtr<CacheIRStubInfo, JS::FreePolicy> stubInfo;
+
+    explicit CacheIRStubKey(CacheIRStubInfo* info) : stubInfo(info) {}
+    CacheIRStubKey(CacheIRStubKey&& other) : stubInfo(Move(other.stubInfo)) { }
+
+    void operator=(CacheIRStubKey&& other) {
+        stubInfo = Move(other.stubInfo);
+    }
+};
+
 class JitRuntime
 {
   private:
@@ -154,6 +193,21 @@ class JitRuntime
     // Global table of jitcode native address => bytecode address mappings.
     UnprotectedData<JitcodeGlobalTable*> jitcodeGlobalTable_;
 
+    // Baseline CacheIR stub code does not depend on the zone it is attached
+    // in: all GC things it uses are loaded from the stub data. Stub code is
+    // therefore shared by all zones of the runtime. The shared code lives in
+    // the atoms zone, where it is never collected, so the amount of it is
+    // capped; past the cap, stub code is cached per zone (see JitZone).
+    using SharedCacheIRStubCodeMap = HashMap<CacheIRStubKey,
+                                             JitCode*,
+                                             CacheIRStubKey,
+                                             SystemAllocPolicy>;
+    ExclusiveAccessLockData<SharedCacheIRStubCodeMap> sharedBaselineCacheIRStubCodes_;
+    ExclusiveAccessLockData<size_t> sharedBaselineCacheIRStubCodeBytes_;
+
+    // Number of mprotect calls avoided by AutoWritableJitCodeBatch.
+    mozilla::Atomic<size_t, mozilla::Relaxed> reprotectCallsSaved_;
+
   private:
     JitCode* generateLazyLinkStub(JSContext* cx);
     JitCode* generateProfilerExitFrameTailStub(JSContext* cx);
@@ -232,7 +286,37 @@ class JitRuntime
         return preventBackedgePatching_;
     }
 
+    size_t reprotectCallsSaved() const {
+        return reprotectCallsSaved_;
+    }
+    void addReprotectCallsSaved(size_t n) {
+        reprotectCallsSaved_ += n;
+    }
+
     JitCode* getVMWrapper(const VMFunction& f) const;
+
+    static const size_t MaxSharedBaselineCacheIRStubCodeBytes = 2 * 1024 * 1024;
+
+    JitCode* getSharedBaselineCacheIRStubCode(const CacheIRStubKey::Lookup& key,
+                                              CacheIRStubInfo** stubInfo,
+                                              AutoLockForExclusiveAccess& lock)
+    {
+        auto p = sharedBaselineCacheIRStubCodes_.ref().lookup(key);
+        if (p) {
+            *stubInfo = p->key().stubInfo.get();
+            return p->value();
+        }
+        *stubInfo = nullptr;
+        return nullptr;
+    }
+    bool canShareBaselineCacheIRStubCode(AutoLockForExclusiveAccess& lock) const {
+        return sharedBaselineCacheIRStubCodeBytes_.ref() < MaxSharedBaselineCacheIRStubCodeBytes;
+    }
+    MOZ_MUST_USE bool putSharedBaselineCacheIRStubCode(const CacheIRStubKey::Lookup& lookup,
+                                                       CacheIRStubKey& key,
+                                                       JitCode* stubCode,
+                                                       AutoLockForExclusiveAccess& lock);
+
     JitCode* debugTrapHandler(JSContext* cx);
     JitCode* getBaselineDebugModeOSRHandler(JSContext* cx);
     void* getBaselineDebugModeOSRHandlerAddress(JSContext* cx, bool popFrameReg);
@@ -354,45 +438,6 @@ class JitZoneGroup
     void patchIonBackedges(JSContext* cx, BackedgeTarget target);
 };
 
-enum class CacheKind : uint8_t;
-class CacheIRStubInfo;
-
-enum class ICStubEngine : uint8_t {
-    // Baseline IC, see SharedIC.h and BaselineIC.h.
-    Baseline = 0,
-
-    // Ion IC that reuses Baseline IC code, see SharedIC.h.
-    IonSharedIC,
-
-    // Ion IC, see IonIC.h.
-    IonIC
-};
-
-struct CacheIRStubKey : public DefaultHasher<CacheIRStubKey> {
-    struct Lookup {
-        CacheKind kind;
-        ICStubEngine engine;
-        const uint8_t* code;
-        uint32_t length;
-
-        Lookup(CacheKind kind, ICStubEngine engine, const uint8_t* code, uint32_t length)
-          : kind(kind), engine(engine), code(code), length(length)
-        {}
-    };
-
-    static HashNumber hash(const Lookup& l);
-    static bool match(const CacheIRStubKey& entry, const Lookup& l);
-
-    UniquePtr<CacheIRStubInfo, JS::FreePolicy> stubInfo;
-
-    explicit CacheIRStubKey(CacheIRStubInfo* info) : stubInfo(info) {}
-    CacheIRStubKey(CacheIRStubKey&& other) : stubInfo(Move(other.stubInfo)) { }
-
-    void operator=(CacheIRStubKey&& other) {
-        stubInfo = Move(other.stubInfo);
-    }
-};
-
 template<typename Key>
 struct IcStubCodeMapGCPolicy
 {
@@ -636,6 +681,38 @@ void FinishInvalidation(FreeOp* fop, JSScript* script);
 const unsigned WINDOWS_BIG_FRAME_TOUCH_INCREMENT = 4096 - 1;
 #endif
 
+// Keep the code made writable by AutoWritableJitCode in its scope writable
+// until the end of the batch, so that patching many pieces of code only
+// changes the protection of each page twice. Code must not run while a batch
+// is active. Nested batches are folded into the outermost one.
+class MOZ_STACK_CLASS AutoWritableJitCodeBatch
+{
+    struct Range
+    {
+        uintptr_t start;
+        uintptr_t end;
+    };
+
+    // Backedge patching from the signal handler will change memory protection
+    // flags, so don't allow it while pages are kept writable.
+    JitRuntime::AutoPreventBackedgePatching preventPatching_;
+    JSContext* cx_;
+    bool active_;
+
+    // Page aligned ranges made writable, the number of AutoWritableJitCode
+    // scopes they served and the number of mprotect calls made.
+    Vector<Range, 8, SystemAllocPolicy> ranges_;
+    size_t scopes_;
+    size_t reprotectCalls_;
+
+  public:
+    explicit AutoWritableJitCodeBatch(JSContext* cx);
+    ~AutoWritableJitCodeBatch();
+
+    // Make [addr, addr + size) writable for the rest of the batch.
+    void makeWritable(void* addr, size_t size);
+};
+
 // If NON_WRITABLE_JIT_CODE is enabled, this class will ensure
 // JIT code is writable (has RW permissions) in its scope.
 // Otherwise it's a no-op.
@@ -647,12 +724,19 @@ class MOZ_STACK_CLASS AutoWritableJitCode
     JSRuntime* rt_;
     void* addr_;
     size_t size_;
+    bool batched_;
 
   public:
     AutoWritableJitCode(JSRuntime* rt, void* addr, size_t size)
-      : preventPatching_(rt), rt_(rt), addr_(addr), size_(size)
+      : preventPatching_(rt), rt_(rt), addr_(addr), size_(size), batched_(false)
     {
         rt_->toggleAutoWritableJitCodeActive(true);
+        JSContext* cx = TlsContext.get();
+        if (AutoWritableJitCodeBatch* batch = cx ? cx->autoWritableJitCodeBatch.ref() : nullptr) {
+            batch->makeWritable(addr_, size_);
+            batched_ = true;
+            return;
+        }
         if (!ExecutableAllocator::makeWritable(addr_, size_))
             MOZ_CRASH();
     }
@@ -663,7 +747,7 @@ class MOZ_STACK_CLASS AutoWritableJitCode
       : AutoWritableJitCode(code->runtimeFromActiveCooperatingThread(), code->raw(), code->bufferSize())
     {}
     ~AutoWritableJitCode() {
-        if (!ExecutableAllocator::makeExecutable(addr_, size_))
+        if (!batched_ && !ExecutableAllocator::makeExecutable(addr_, size_))
             MOZ_CRASH();
         rt_->toggleAutoWritableJitCodeActive(false);
     }
@@ -223,6 +223,11 @@ DefaultJitOptions::DefaultJitOptions()
             Warn(forcedDefaultIonSmallFunctionWarmUpThresholdEnv, env);
     }
 
+    // The number of virtual registers above which the backtracking register
+    // allocator is run in linear scan mode, which is much faster on very large
+    // functions at the expense of code quality.
+    SET_DEFAULT(linearScanAllocatorThreshold, 50000);
+
     // Force the used register allocator instead of letting the optimization
     // pass decide.
     const char* forcedRegisterAllocatorEnv = "JIT_OPTION_forcedRegisterAllocator";
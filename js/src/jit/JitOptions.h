@@ -24,6 +24,7 @@ static const uint32_t MAX_ACTIVE_THREAD_LOCALS_AND_ARGS = 256;
 enum IonRegisterAllocator {
     RegisterAllocator_Backtracking,
     RegisterAllocator_Testbed,
+    RegisterAllocator_LinearScan,
     RegisterAllocator_Stupid
 };
 
@@ -34,6 +35,8 @@ LookupRegisterAllocator(const char* name)
         return mozilla::Some(RegisterAllocator_Backtracking);
     if (!strcmp(name, "testbed"))
         return mozilla::Some(RegisterAllocator_Testbed);
+    if (!strcmp(name, "linearscan"))
+        return mozilla::Some(RegisterAllocator_LinearScan);
     if (!strcmp(name, "stupid"))
         return mozilla::Some(RegisterAllocator_Stupid);
     return mozilla::Nothing();
@@ -90,6 +93,7 @@ struct DefaultJitOptions
     uint32_t branchPruningBlockSpanFactor;
     uint32_t branchPruningEffectfulInstFactor;
     uint32_t branchPruningThreshold;
+    uint32_t linearScanAllocatorThreshold;
     uint32_t wasmBatchIonThreshold;
     uint32_t wasmBatchBaselineThreshold;
     mozilla::Maybe<uint32_t> forcedDefaultIonWarmUpThreshold;
@@ -433,6 +433,7 @@ jit::CheckLogging()
             "  bailouts      Bailouts\n"
             "  caches        Inline caches\n"
             "  osi           Invalidation\n"
+            "  compile-stats Per-script compile, cancel and bailout counts, one JSON object per line\n"
             "  safepoints    Safepoints\n"
             "  pools         Literal Pools (ARM only for now)\n"
             "  cacheflush    Instruction Cache flushes (ARM only for now)\n"
@@ -506,6 +507,8 @@ jit::CheckLogging()
         EnableChannel(JitSpew_IonInvalidate);
     if (ContainsFlag(env, "caches"))
         EnableChannel(JitSpew_IonIC);
+    if (ContainsFlag(env, "compile-stats"))
+        EnableChannel(JitSpew_IonCompileStats);
     if (ContainsFlag(env, "safepoints"))
         EnableChannel(JitSpew_Safepoints);
     if (ContainsFlag(env, "pools"))
@@ -106,7 +106,9 @@ namespace jit {
     /* Debug info about snapshots */        \
     _(IonSnapshots)                         \
     /* Generated inline cache stubs */      \
-    _(IonIC)
+    _(IonIC)                                \
+    /* Per-script compile history, as JSON */\
+    _(IonCompileStats)
 
 enum JitSpewChannel {
 #define JITSPEW_CHANNEL(name) JitSpew_##name,
@@ -7,6 +7,7 @@
 #include "jit/JitcodeMap.h"
 
 #include "mozilla/DebugOnly.h"
+#include "mozilla/HashFunctions.h"
 #include "mozilla/MathAlgorithms.h"
 #include "mozilla/Maybe.h"
 #include "mozilla/Sprintf.h"
@@ -458,6 +459,22 @@ JitcodeGlobalTable::lookupForSamplerInfallible(void* ptr, JSRuntime* rt, uint32_
 
 JitcodeGlobalEntry*
 JitcodeGlobalTable::lookupInternal(void* ptr)
+{
+    static_assert(mozilla::IsPowerOfTwo(LOOKUP_CACHE_SIZE),
+                  "LOOKUP_CACHE_SIZE must be a power of two");
+
+    JitcodeGlobalEntry*& cached = lookupCache_[mozilla::HashGeneric(ptr) & (LOOKUP_CACHE_SIZE - 1)];
+    if (cached && cached->isValid() && cached->containsPointer(ptr))
+        return cached;
+
+    JitcodeGlobalEntry* entry = searchEntry(ptr);
+    if (entry)
+        cached = entry;
+    return entry;
+}
+
+JitcodeGlobalEntry*
+JitcodeGlobalTable::searchEntry(void* ptr)
 {
     JitcodeGlobalEntry query = JitcodeGlobalEntry::MakeQuery(ptr);
     JitcodeGlobalEntry* searchTower[JitcodeSkiplistTower::MAX_HEIGHT];
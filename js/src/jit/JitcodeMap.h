@@ -1026,6 +1026,17 @@ class JitcodeGlobalTable
     JitcodeGlobalEntry* startTower_[JitcodeSkiplistTower::MAX_HEIGHT];
     JitcodeSkiplistTower* freeTowers_[JitcodeSkiplistTower::MAX_HEIGHT];
 
+    // Direct mapped cache of the entry last found for a code address. The
+    // profiler looks up the same return addresses sample after sample, with
+    // the sampled thread suspended, and walking the skiplist for each frame
+    // touches a cache line per level.
+    //
+    // Entries are never freed while the table is alive, and removed entries
+    // become invalid before being reused, so a cached entry only needs to
+    // be checked against the address: no entry overlaps another one.
+    static const size_t LOOKUP_CACHE_SIZE = 256;
+    JitcodeGlobalEntry* lookupCache_[LOOKUP_CACHE_SIZE];
+
   public:
     JitcodeGlobalTable()
       : alloc_(LIFO_CHUNK_SIZE), freeEntries_(nullptr), rand_(0), skiplistSize_(0),
@@ -1035,6 +1046,8 @@ class JitcodeGlobalTable
             startTower_[i] = nullptr;
         for (unsigned i = 0; i < JitcodeSkiplistTower::MAX_HEIGHT; i++)
             freeTowers_[i] = nullptr;
+        for (unsigned i = 0; i < LOOKUP_CACHE_SIZE; i++)
+            lookupCache_[i] = nullptr;
     }
     ~JitcodeGlobalTable() {}
 
@@ -1080,6 +1093,7 @@ class JitcodeGlobalTable
     MOZ_MUST_USE bool addEntry(const JitcodeGlobalEntry& entry, JSRuntime* rt);
 
     JitcodeGlobalEntry* lookupInternal(void* ptr);
+    JitcodeGlobalEntry* searchEntry(void* ptr);
 
     // Initialize towerOut such that towerOut[i] (for i in [0, MAX_HEIGHT-1])
     // is a JitcodeGlobalEntry that is sorted to be <query, whose successor at
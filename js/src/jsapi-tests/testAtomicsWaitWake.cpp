@@ -0,0 +1,163 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+ * vim: set ts=8 sts=4 et sw=4 tw=99:
+ */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "jsapi-tests/tests.h"
+#include "threading/Thread.h"
+#include "vm/SharedArrayObject.h"
+
+// Stress Atomics.wait and Atomics.wake from several worker contexts sharing
+// one buffer, under different contention patterns.
+
+static const size_t WorkerCount = 8;
+static const uint32_t BufferLength = 4096;
+
+// Every worker takes turns on a slot with the other workers using it:
+// worker |id| waits until the slot holds the value of its next turn, then
+// advances the slot and wakes everyone waiting on it.
+static const char WorkerPrelude[] =
+    "var ia = new Int32Array(sab);\n"
+    "function turn(slot, want) {\n"
+    "    for (var v; (v = Atomics.load(ia, slot)) !== want; )\n"
+    "        Atomics.wait(ia, slot, v);\n"
+    "    Atomics.store(ia, slot, want + 1);\n"
+    "    Atomics.wake(ia, slot);\n"
+    "}\n";
+
+struct AtomicsWorker
+{
+    JSRuntime* parentRuntime;
+    js::SharedArrayRawBuffer* rawBuffer;
+    const char* script;
+    int32_t id;
+    bool ok;
+};
+
+static bool
+RunAtomicsWorker(JSContext* cx, AtomicsWorker* worker)
+{
+    JS::CompartmentOptions options;
+    options.creationOptions().setSharedMemoryAndAtomicsEnabled(true);
+    options.behaviors().setVersion(JSVERSION_LATEST);
+    JS::RootedObject global(cx, JS_NewGlobalObject(cx, JSAPITest::basicGlobalClass(), nullptr,
+                                                   JS::FireOnNewGlobalHook, options));
+    if (!global)
+        return false;
+
+    JSAutoCompartment ac(cx, global);
+    if (!JS_InitStandardClasses(cx, global))
+        return false;
+
+    if (!worker->rawBuffer->addReference())
+        return false;
+    JS::RootedObject sab(cx, js::SharedArrayBufferObject::New(cx, worker->rawBuffer));
+    if (!sab) {
+        worker->rawBuffer->dropReference();
+        return false;
+    }
+
+    if (!JS_DefineProperty(cx, global, "sab", sab, 0) ||
+        !JS_DefineProperty(cx, global, "id", worker->id, 0))
+    {
+        return false;
+    }
+
+    JS::CompileOptions opts(cx);
+    opts.setFileAndLine(__FILE__, __LINE__);
+    JS::RootedValue rval(cx);
+    if (!JS::Evaluate(cx, opts, WorkerPrelude, strlen(WorkerPrelude), &rval) ||
+        !JS::Evaluate(cx, opts, worker->script, strlen(worker->script), &rval))
+    {
+        return false;
+    }
+    return rval.isTrue();
+}
+
+static void
+AtomicsWorkerMain(AtomicsWorker* worker)
+{
+    JSContext* cx = JS_NewContext(8L * 1024 * 1024, JS::DefaultNurseryBytes,
+                                  worker->parentRuntime);
+    if (!cx)
+        return;
+
+    JS_SetFutexCanWait(cx);
+    if (JS::InitSelfHostedCode(cx)) {
+        JSAutoRequest ar(cx);
+        worker->ok = RunAtomicsWorker(cx, worker);
+    }
+
+    JS_DestroyContext(cx);
+}
+
+BEGIN_TEST(testAtomicsWaitWake_stress)
+{
+    js::SharedArrayRawBuffer* rawBuffer = js::SharedArrayRawBuffer::New(cx, BufferLength);
+    CHECK(rawBuffer);
+    int32_t* slots = rawBuffer->dataPointerShared().cast<int32_t*>().unwrap();
+
+    // Pairs of workers ping-pong on their own slot: many addresses with few
+    // waiters each.
+    CHECK(runWorkers(rawBuffer,
+                     "for (var k = 0; k < 1000; k++)\n"
+                     "    turn(id >> 1, 2 * k + (id & 1));\n"
+                     "true"));
+    for (size_t i = 0; i < WorkerCount / 2; i++)
+        CHECK_EQUAL(slots[i], 2000);
+
+    // All workers take turns on one slot: one address with many waiters,
+    // every wake waking all of them.
+    CHECK(runWorkers(rawBuffer,
+                     "for (var k = 0; k < 200; k++)\n"
+                     "    turn(64, k * 8 + id);\n"
+                     "true"));
+    CHECK_EQUAL(slots[64], int32_t(200 * WorkerCount));
+
+    // Workers spread their turns over many slots, so that waiters on
+    // different addresses share buckets.
+    CHECK(runWorkers(rawBuffer,
+                     "for (var k = 0; k < 200; k++) {\n"
+                     "    for (var s = 0; s < 16; s++)\n"
+                     "        turn(128 + s * 32, k * 8 + (id + s) % 8);\n"
+                     "}\n"
+                     "true"));
+    for (size_t s = 0; s < 16; s++)
+        CHECK_EQUAL(slots[128 + s * 32], int32_t(200 * WorkerCount));
+
+    rawBuffer->dropReference();
+    return true;
+}
+
+bool
+runWorkers(js::SharedArrayRawBuffer* rawBuffer, const char* script)
+{
+    AtomicsWorker workers[WorkerCount];
+    js::Thread threads[WorkerCount];
+    size_t started = 0;
+    for (; started < WorkerCount; started++) {
+        AtomicsWorker& worker = workers[started];
+        worker.parentRuntime = JS_GetRuntime(cx);
+        worker.rawBuffer = rawBuffer;
+        worker.script = script;
+        worker.id = int32_t(started);
+        worker.ok = false;
+        if (!threads[started].init(AtomicsWorkerMain, &worker))
+            break;
+    }
+
+    // A worker that failed to start leaves the others waiting for its turns
+    // forever, so it is only safe to join them all when every one started.
+    MOZ_RELEASE_ASSERT(started == WorkerCount);
+
+    bool ok = true;
+    for (size_t i = 0; i < WorkerCount; i++) {
+        threads[i].join();
+        ok = ok && workers[i].ok;
+    }
+    CHECK(ok);
+    return true;
+}
+END_TEST(testAtomicsWaitWake_stress)
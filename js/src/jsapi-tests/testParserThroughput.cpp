@@ -0,0 +1,99 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+ * vim: set ts=8 sts=4 et sw=4 tw=99:
+ */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "mozilla/TimeStamp.h"
+
+#include "js/Vector.h"
+#include "jsapi-tests/tests.h"
+
+// Check that the runs of identifier, whitespace, comment and string chars
+// which the tokenizer skips in bulk are still handled like single chars, and
+// report how fast a large script made of them is compiled.
+
+static bool
+AppendASCII(js::Vector<char, 0, js::SystemAllocPolicy>& buf, const char* str)
+{
+    return buf.append(str, strlen(str));
+}
+
+BEGIN_TEST(testParserThroughput_runs)
+{
+    JS::RootedValue v(cx);
+
+    EVAL("var longIdentifier_$0123456789abcdefghijklmnopqrstuvwxyz = 1;\n"
+         "longIdentifier_$0123456789abcdefghijklmnopqrstuvwxyz", &v);
+    CHECK(v.isInt32(1));
+
+    EVAL("var \\u0061bc\\u{64}ef = 2; abcdef", &v);
+    CHECK(v.isInt32(2));
+
+    EVAL("var \xE9t\xE9 = 3; \xE9t\xE9", &v);
+    CHECK(v.isInt32(3));
+
+    EVAL("  \t  \t  // line comment with \"quotes\" and /* */\n"
+         "  /* multi-line comment ** with * stars\n  and lines */ 4", &v);
+    CHECK(v.isInt32(4));
+
+    EVAL("'plain chars, \"other quotes\" and \\x41\\u0042\\n\\\\'", &v);
+    JSString* str = v.toString();
+    bool match;
+    CHECK(JS_StringEqualsAscii(cx, str, "plain chars, \"other quotes\" and AB\n\\", &match));
+    CHECK(match);
+
+    EVAL("var x = 5; `dollar $ then ${x}, then ${'\\u0041'}$`", &v);
+    CHECK(JS_StringEqualsAscii(cx, v.toString(), "dollar $ then 5, then A$", &match));
+    CHECK(match);
+
+    EVAL("`line\r\nbreaks\rare\nnormalized`", &v);
+    CHECK(JS_StringEqualsAscii(cx, v.toString(), "line\nbreaks\nare\nnormalized", &match));
+    CHECK(match);
+
+    return true;
+}
+END_TEST(testParserThroughput_runs)
+
+BEGIN_TEST(testParserThroughput_bulk)
+{
+    static const size_t Lines = 20000;
+    static const size_t Iterations = 5;
+
+    js::Vector<char, 0, js::SystemAllocPolicy> src;
+    CHECK(AppendASCII(src, "var total = 0;\n"));
+    for (size_t i = 0; i < Lines; i++) {
+        char line[256];
+        snprintf(line, sizeof(line),
+                 "    /* entry %u */ var someLongIdentifierName%u = 'a string literal body %u';"
+                 " // trailing comment\n"
+                 "    total += someLongIdentifierName%u.length;\n",
+                 unsigned(i), unsigned(i), unsigned(i), unsigned(i));
+        CHECK(AppendASCII(src, line));
+    }
+    CHECK(AppendASCII(src, "total;\n"));
+
+    JS::CompileOptions options(cx);
+    options.setFileAndLine(__FILE__, __LINE__);
+
+    mozilla::TimeStamp start = mozilla::TimeStamp::Now();
+    JS::RootedScript script(cx);
+    for (size_t i = 0; i < Iterations; i++)
+        CHECK(JS::Compile(cx, options, src.begin(), src.length(), &script));
+    double seconds = (mozilla::TimeStamp::Now() - start).ToSeconds();
+
+    if (seconds > 0) {
+        double megabytes = double(src.length() * Iterations) / (1024 * 1024);
+        fprintf(stderr, "testParserThroughput_bulk: %.1f MB/s\n", megabytes / seconds);
+    }
+
+    // Make sure the last compiled script saw every declaration.
+    JS::RootedValue v(cx);
+    CHECK(JS_ExecuteScript(cx, script, &v));
+    CHECK(v.isInt32());
+    CHECK(v.toInt32() > int32_t(Lines * strlen("a string literal body ")));
+
+    return true;
+}
+END_TEST(testParserThroughput_bulk)
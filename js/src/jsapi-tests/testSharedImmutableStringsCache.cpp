@@ -6,6 +6,8 @@
 
 #include "mozilla/IntegerRange.h"
 
+#include "jsfriendapi.h"
+
 #include "js/Vector.h"
 #include "jsapi-tests/tests.h"
 #include "threading/Thread.h"
@@ -78,3 +80,68 @@ BEGIN_TEST(testSharedImmutableStringsCache)
     return true;
 }
 END_TEST(testSharedImmutableStringsCache)
+
+// A store keeping a single string on the heap, to check that the cache hands
+// large strings over to it and gives them back.
+class TestSharedStringStore : public js::SharedStringStore
+{
+  public:
+    char* chars = nullptr;
+    size_t acquired = 0;
+    size_t released = 0;
+
+    const char* acquire(const char* src, size_t length) override {
+        if (chars)
+            return nullptr;
+        chars = js_pod_malloc<char>(length);
+        MOZ_RELEASE_ASSERT(chars);
+        memcpy(chars, src, length);
+        acquired++;
+        return chars;
+    }
+
+    void release(const char* src, size_t length) override {
+        MOZ_RELEASE_ASSERT(src == chars);
+        js_free(chars);
+        chars = nullptr;
+        released++;
+    }
+};
+
+BEGIN_TEST(testSharedImmutableStringsCache_store)
+{
+    auto maybeCache = js::SharedImmutableStringsCache::Create();
+    CHECK(maybeCache.isSome());
+    auto& cache = *maybeCache;
+
+    TestSharedStringStore store;
+    js::SetSharedStringStore(&store);
+
+    const size_t length = js::SharedStringStoreMinLength;
+    char* chars = js_pod_malloc<char>(length);
+    CHECK(chars);
+    memset(chars, 'a', length);
+
+    {
+        // Short strings stay on the heap.
+        auto shortString = cache.getOrCreate(chars, length - 1);
+        CHECK(shortString.isSome());
+        CHECK(store.acquired == 0);
+
+        auto first = cache.getOrCreate(chars, length);
+        CHECK(first.isSome());
+        CHECK(store.acquired == 1);
+        CHECK(first->chars() == store.chars);
+
+        auto second = cache.getOrCreate(chars, length);
+        CHECK(second.isSome());
+        CHECK(second->chars() == first->chars());
+        CHECK(store.acquired == 1);
+    }
+    CHECK(store.released == 1);
+
+    js::SetSharedStringStore(nullptr);
+    js_free(chars);
+    return true;
+}
+END_TEST(testSharedImmutableStringsCache_store)
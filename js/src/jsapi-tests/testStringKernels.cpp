@@ -0,0 +1,91 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+ * vim: set ts=8 sts=4 et sw=4 tw=99:
+ */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "jsapi-tests/tests.h"
+#include "vm/StringKernels.h"
+
+using JS::Latin1Char;
+
+// Lengths around the vector widths, and offsets to exercise unaligned loads.
+static const size_t MaxLength = 70;
+static const size_t MaxOffset = 3;
+
+BEGIN_TEST(testStringKernels_inflate)
+{
+    Latin1Char src[MaxLength + MaxOffset];
+    for (size_t i = 0; i < mozilla::ArrayLength(src); i++)
+        src[i] = Latin1Char(0xf0 + i);
+
+    char16_t dst[MaxLength + 1];
+    for (size_t offset = 0; offset <= MaxOffset; offset++) {
+        for (size_t len = 0; len <= MaxLength; len++) {
+            dst[len] = 0xdead;
+            js::VectorInflateChars(dst, src + offset, len);
+            for (size_t i = 0; i < len; i++)
+                CHECK_EQUAL(dst[i], char16_t(src[offset + i]));
+            CHECK_EQUAL(dst[len], char16_t(0xdead));
+        }
+    }
+    return true;
+}
+END_TEST(testStringKernels_inflate)
+
+BEGIN_TEST(testStringKernels_mismatch)
+{
+    Latin1Char latin1[MaxLength + MaxOffset];
+    char16_t twoByte[MaxLength + MaxOffset];
+    for (size_t i = 0; i < mozilla::ArrayLength(latin1); i++) {
+        latin1[i] = Latin1Char(0x80 + i);
+        twoByte[i] = char16_t(0x80 + i);
+    }
+    Latin1Char latin1Copy[MaxLength];
+    char16_t twoByteCopy[MaxLength];
+
+    for (size_t offset = 0; offset <= MaxOffset; offset++) {
+        for (size_t len = 0; len <= MaxLength; len++) {
+            mozilla::PodCopy(latin1Copy, latin1 + offset, len);
+            mozilla::PodCopy(twoByteCopy, twoByte + offset, len);
+            CHECK_EQUAL(js::VectorMismatch(latin1 + offset, latin1Copy, len), len);
+            CHECK_EQUAL(js::VectorMismatch(twoByte + offset, twoByteCopy, len), len);
+            CHECK_EQUAL(js::VectorMismatch(latin1 + offset, twoByteCopy, len), len);
+            CHECK_EQUAL(js::VectorMismatch(twoByteCopy, latin1 + offset, len), len);
+
+            for (size_t i = 0; i < len; i++) {
+                latin1Copy[i]++;
+                twoByteCopy[i] += 0x100;
+                CHECK_EQUAL(js::VectorMismatch(latin1 + offset, latin1Copy, len), i);
+                CHECK_EQUAL(js::VectorMismatch(twoByte + offset, twoByteCopy, len), i);
+                CHECK_EQUAL(js::VectorMismatch(latin1 + offset, twoByteCopy, len), i);
+                latin1Copy[i]--;
+                twoByteCopy[i] -= 0x100;
+            }
+        }
+    }
+    return true;
+}
+END_TEST(testStringKernels_mismatch)
+
+BEGIN_TEST(testStringKernels_findChar)
+{
+    char16_t text[MaxLength + MaxOffset];
+    for (size_t i = 0; i < mozilla::ArrayLength(text); i++)
+        text[i] = char16_t('a');
+
+    for (size_t offset = 0; offset <= MaxOffset; offset++) {
+        const char16_t* s = text + offset;
+        for (size_t len = 0; len <= MaxLength; len++) {
+            CHECK(!js::VectorFindChar(s, len, char16_t(0x161)));
+            for (size_t i = 0; i < len; i++) {
+                text[offset + i] = char16_t(0x161);
+                CHECK(js::VectorFindChar(s, len, char16_t(0x161)) == s + i);
+                text[offset + i] = char16_t('a');
+            }
+        }
+    }
+    return true;
+}
+END_TEST(testStringKernels_findChar)
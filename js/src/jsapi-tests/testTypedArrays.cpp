@@ -234,3 +234,33 @@ TestArrayFromBuffer(JSContext* cx)
 }
 
 END_TEST(testTypedArrays)
+
+BEGIN_TEST(testTypedArraySort)
+{
+    JS::RootedValue v(cx);
+
+    EVAL("var ok = true;\n"
+         "function check(ta, expected) {\n"
+         "    ta.sort();\n"
+         "    for (var i = 0; i < expected.length; i++) {\n"
+         "        if (!Object.is(ta[i], expected[i]))\n"
+         "            ok = false;\n"
+         "    }\n"
+         "}\n"
+         "check(new Int8Array([3, -128, 127, 0, -1]), [-128, -1, 0, 3, 127]);\n"
+         "check(new Uint8ClampedArray([255, 0, 7, 7]), [0, 7, 7, 255]);\n"
+         "check(new Int16Array([300, -300, 1, -32768]), [-32768, -300, 1, 300]);\n"
+         "check(new Uint16Array([65535, 256, 1]), [1, 256, 65535]);\n"
+         "check(new Int32Array([1 << 30, -(1 << 31), 0, 512, -512]),\n"
+         "      [-(1 << 31), -512, 0, 512, 1 << 30]);\n"
+         "check(new Uint32Array([0xffffffff, 0x100, 0x10000, 0]), [0, 0x100, 0x10000, 0xffffffff]);\n"
+         "check(new Float32Array([NaN, 1.5, -0, 0, -Infinity, -1.5, Infinity]),\n"
+         "      [-Infinity, -1.5, -0, 0, 1.5, Infinity, NaN]);\n"
+         "check(new Float64Array([0, NaN, -0, -1e300, 1e-300, -NaN]),\n"
+         "      [-1e300, -0, 0, 1e-300, NaN, NaN]);\n"
+         "ok", &v);
+    CHECK(v.isTrue());
+
+    return true;
+}
+END_TEST(testTypedArraySort)
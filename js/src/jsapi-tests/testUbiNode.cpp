@@ -626,6 +626,83 @@ BEGIN_TEST(test_JS_ubi_DominatorTree)
 }
 END_TEST(test_JS_ubi_DominatorTree)
 
+// A ProgressCallback that records the reports it gets, and asks to cancel after
+// a given number of them.
+struct TestProgressCallback : public JS::ubi::ProgressCallback
+{
+    size_t traversalReports;
+    size_t dominatorsReports;
+    size_t cancelAfter;
+
+    explicit TestProgressCallback(size_t cancelAfter = SIZE_MAX)
+      : ProgressCallback(1),
+        traversalReports(0),
+        dominatorsReports(0),
+        cancelAfter(cancelAfter)
+    { }
+
+    bool report(const char* phase, uint64_t done, uint64_t total) override {
+        if (strcmp(phase, "traversal") == 0) {
+            traversalReports++;
+        } else {
+            MOZ_RELEASE_ASSERT(strcmp(phase, "dominators") == 0);
+            MOZ_RELEASE_ASSERT(done <= total);
+            dominatorsReports++;
+        }
+        return traversalReports + dominatorsReports < cancelAfter;
+    }
+};
+
+BEGIN_TEST(test_JS_ubi_DominatorTree_progress)
+{
+    // Construct the following graph:
+    //
+    //     r --> a --> b
+    //     |           ^
+    //     '-----------'
+
+    FakeNode r('r');
+    FakeNode a('a');
+    FakeNode b('b');
+
+    CHECK(r.addEdgeTo(a));
+    CHECK(r.addEdgeTo(b));
+    CHECK(a.addEdgeTo(b));
+
+    {
+        TestProgressCallback progress;
+        mozilla::Maybe<JS::ubi::DominatorTree> maybeTree;
+        {
+            JS::AutoCheckCannotGC noGC(cx);
+            maybeTree = JS::ubi::DominatorTree::Create(cx, noGC, &r, &progress);
+        }
+
+        CHECK(maybeTree.isSome());
+        CHECK(maybeTree->getImmediateDominator(&b) == JS::ubi::Node(&r));
+
+        // Every node but the root is reported once by the traversal, and once
+        // per pass of the dominators computation.
+        CHECK(progress.traversalReports == 2);
+        CHECK(progress.dominatorsReports >= 2);
+    }
+
+    {
+        TestProgressCallback progress(1);
+        mozilla::Maybe<JS::ubi::DominatorTree> maybeTree;
+        {
+            JS::AutoCheckCannotGC noGC(cx);
+            maybeTree = JS::ubi::DominatorTree::Create(cx, noGC, &r, &progress);
+        }
+
+        CHECK(maybeTree.isNothing());
+        CHECK(progress.traversalReports == 1);
+        CHECK(progress.dominatorsReports == 0);
+    }
+
+    return true;
+}
+END_TEST(test_JS_ubi_DominatorTree_progress)
+
 BEGIN_TEST(test_JS_ubi_Node_scriptFilename)
 {
     JS::RootedValue val(cx);
@@ -637,6 +637,12 @@ JS::ContextOptionsRef(JSContext* cx)
 
 JS_PUBLIC_API(bool)
 JS::InitSelfHostedCode(JSContext* cx)
+{
+    return InitSelfHostedCode(cx, TranscodeRange(), nullptr);
+}
+
+JS_PUBLIC_API(bool)
+JS::InitSelfHostedCode(JSContext* cx, const TranscodeRange& xdrIn, TranscodeBuffer* xdrOut)
 {
     MOZ_RELEASE_ASSERT(!cx->runtime()->hasInitializedSelfHosting(),
                        "JS::InitSelfHostedCode() called more than once");
@@ -649,7 +655,7 @@ JS::InitSelfHostedCode(JSContext* cx)
     if (!rt->initializeAtoms(cx))
         return false;
 
-    if (!rt->initSelfHosting(cx))
+    if (!rt->initSelfHosting(cx, xdrIn, xdrOut))
         return false;
 
     if (!rt->parentRuntime && !rt->transformToPermanentAtoms(cx))
@@ -3940,6 +3946,7 @@ JS::ReadOnlyCompileOptions::copyPODOptions(const ReadOnlyCompileOptions& rhs)
     scriptSourceOffset = rhs.scriptSourceOffset;
     isRunOnce = rhs.isRunOnce;
     noScriptRval = rhs.noScriptRval;
+    delazifyInnerFunctions = rhs.delazifyInnerFunctions;
 }
 
 JS::OwningCompileOptions::OwningCompileOptions(JSContext* cx)
@@ -7573,6 +7580,12 @@ JS::SetAsmJSCacheOps(JSContext* cx, const JS::AsmJSCacheOps* ops)
     cx->runtime()->asmJSCacheOps = *ops;
 }
 
+JS_PUBLIC_API(void)
+JS::SetWasmCacheOps(JSContext* cx, const JS::WasmCacheOps* ops)
+{
+    cx->runtime()->wasmCacheOps = *ops;
+}
+
 bool
 JS::IsWasmModuleObject(HandleObject obj)
 {
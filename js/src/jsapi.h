@@ -3994,7 +3994,8 @@ class JS_FRIEND_API(ReadOnlyCompileOptions) : public TransitiveCompileOptions
         column(0),
         scriptSourceOffset(0),
         isRunOnce(false),
-        noScriptRval(false)
+        noScriptRval(false),
+        delazifyInnerFunctions(false)
     { }
 
     // Set all POD options (those not requiring reference counts, copies,
@@ -4030,6 +4031,9 @@ class JS_FRIEND_API(ReadOnlyCompileOptions) : public TransitiveCompileOptions
     // isRunOnce only applies to non-function scripts.
     bool isRunOnce;
     bool noScriptRval;
+    // When compiling off thread, also compile the lazy inner functions of the
+    // script so that calling them does not require parsing on the main thread.
+    bool delazifyInnerFunctions;
 
   private:
     void operator=(const ReadOnlyCompileOptions&) = delete;
@@ -4103,6 +4107,7 @@ class JS_FRIEND_API(OwningCompileOptions) : public ReadOnlyCompileOptions
     OwningCompileOptions& setScriptSourceOffset(unsigned o) { scriptSourceOffset = o; return *this; }
     OwningCompileOptions& setIsRunOnce(bool once) { isRunOnce = once; return *this; }
     OwningCompileOptions& setNoScriptRval(bool nsr) { noScriptRval = nsr; return *this; }
+    OwningCompileOptions& setDelazifyInnerFunctions(bool d) { delazifyInnerFunctions = d; return *this; }
     OwningCompileOptions& setSelfHostingMode(bool shm) { selfHostingMode = shm; return *this; }
     OwningCompileOptions& setCanLazilyParse(bool clp) { canLazilyParse = clp; return *this; }
     OwningCompileOptions& setSourceIsLazy(bool l) { sourceIsLazy = l; return *this; }
@@ -4200,6 +4205,7 @@ class MOZ_STACK_CLASS JS_FRIEND_API(CompileOptions) final : public ReadOnlyCompi
     CompileOptions& setScriptSourceOffset(unsigned o) { scriptSourceOffset = o; return *this; }
     CompileOptions& setIsRunOnce(bool once) { isRunOnce = once; return *this; }
     CompileOptions& setNoScriptRval(bool nsr) { noScriptRval = nsr; return *this; }
+    CompileOptions& setDelazifyInnerFunctions(bool d) { delazifyInnerFunctions = d; return *this; }
     CompileOptions& setSelfHostingMode(bool shm) { selfHostingMode = shm; return *this; }
     CompileOptions& setCanLazilyParse(bool clp) { canLazilyParse = clp; return *this; }
     CompileOptions& setSourceIsLazy(bool l) { sourceIsLazy = l; return *this; }
@@ -6249,6 +6255,7 @@ enum TranscodeResult
     TranscodeResult_Failure_UnknownClassKind =    TranscodeResult_Failure | 0x4,
     TranscodeResult_Failure_WrongCompileOption =  TranscodeResult_Failure | 0x5,
     TranscodeResult_Failure_NotInterpretedFun =   TranscodeResult_Failure | 0x6,
+    TranscodeResult_Failure_BadDecode =           TranscodeResult_Failure | 0x7,
 
     // There is a pending exception on the context.
     TranscodeResult_Throw = 0x200
@@ -6267,6 +6274,21 @@ DecodeScript(JSContext* cx, TranscodeBuffer& buffer, JS::MutableHandleScript scr
 extern JS_PUBLIC_API(TranscodeResult)
 DecodeScript(JSContext* cx, const TranscodeRange& range, JS::MutableHandleScript scriptp);
 
+/**
+ * Like InitSelfHostedCode, but decode the self-hosted code from |xdrIn|
+ * instead of parsing and compiling it, if |xdrIn| holds an encoding produced
+ * through |xdrOut| by a build with the same build id. When |xdrIn| points to
+ * a mapped file, e.g. one generated at build time, this only costs page
+ * faults, and the pages are shared by all the processes mapping the file.
+ *
+ * If |xdrIn| is empty or cannot be decoded, the self-hosted code is compiled
+ * from source and, if |xdrOut| is non-null, its encoding is appended to
+ * |xdrOut| so that the embedding can store it for later runs. |xdrOut| is
+ * left empty if the encoding failed.
+ */
+extern JS_PUBLIC_API(bool)
+InitSelfHostedCode(JSContext* cx, const TranscodeRange& xdrIn, TranscodeBuffer* xdrOut);
+
 extern JS_PUBLIC_API(TranscodeResult)
 DecodeInterpretedFunction(JSContext* cx, TranscodeBuffer& buffer, JS::MutableHandleFunction funp,
                           size_t cursorIndex = 0);
@@ -6451,6 +6473,53 @@ extern JS_PUBLIC_API(RefPtr<WasmModule>)
 DeserializeWasmModule(PRFileDesc* bytecode, PRFileDesc* maybeCompiled, BuildIdCharVector&& buildId,
                       JS::UniqueChars filename, unsigned line, unsigned column);
 
+/**
+ * The WasmCache callbacks let the embedding persist the compiled code of
+ * WebAssembly modules (e.g., in the alt-data stream of the HTTP cache entry
+ * of the .wasm resource) so that a later compilation of the same bytecode can
+ * skip compilation entirely.
+ *
+ * Entries are identified by a WasmCacheKeyLength-byte key which is a hash of
+ * the module bytecode together with the build-id and the cpu features the code
+ * was compiled for. Thus, after a browser update or on a different cpu, the
+ * key of a given module changes and old entries are never looked up again; the
+ * embedding is free to evict them at its leisure. The contents of an entry are
+ * additionally validated by the engine before use, so a stale or corrupt entry
+ * is simply ignored and overwritten by the freshly compiled module.
+ *
+ * The read callback shall return 'true' if an entry exists for the key, along
+ * with its size, base address and an opaque handle. The write callback shall
+ * return 'true' if an entry of the given size could be created, along with its
+ * base address and an opaque handle. In both cases, the JS engine guarantees a
+ * matching call of the corresponding close callback, passing the same size,
+ * base address and handle. The callbacks are only called on the JSRuntime's
+ * thread.
+ */
+
+static const size_t WasmCacheKeyLength = 20;
+
+typedef bool
+(* OpenWasmCacheEntryForReadOp)(HandleObject global, const uint8_t* key,
+                                size_t* size, const uint8_t** memory, intptr_t* handle);
+typedef void
+(* CloseWasmCacheEntryForReadOp)(size_t size, const uint8_t* memory, intptr_t handle);
+typedef bool
+(* OpenWasmCacheEntryForWriteOp)(HandleObject global, const uint8_t* key, size_t size,
+                                 uint8_t** memory, intptr_t* handle);
+typedef void
+(* CloseWasmCacheEntryForWriteOp)(size_t size, uint8_t* memory, intptr_t handle);
+
+struct WasmCacheOps
+{
+    OpenWasmCacheEntryForReadOp openEntryForRead;
+    CloseWasmCacheEntryForReadOp closeEntryForRead;
+    OpenWasmCacheEntryForWriteOp openEntryForWrite;
+    CloseWasmCacheEntryForWriteOp closeEntryForWrite;
+};
+
+extern JS_PUBLIC_API(void)
+SetWasmCacheOps(JSContext* cx, const WasmCacheOps* callbacks);
+
 /**
  * Convenience class for imitating a JS level for-of loop. Typical usage:
  *
@@ -6853,6 +6922,11 @@ struct JS_PUBLIC_API(PerformanceGroup) {
     uint64_t recentCPOW(uint64_t iteration) const;
     void addRecentCPOW(uint64_t iteration, uint64_t CPOW);
 
+    // Add one tick and `cycles` cycles to this group for a sample taken
+    // during the given iteration, dropping any data of older iterations.
+    // Used instead of `acquire` when jank is measured by sampling.
+    void addRecentSample(uint64_t iteration, uint64_t cycles);
+
     // Get rid of any data that pretends to be recent.
     void resetRecentData();
 
@@ -6947,6 +7021,19 @@ SetStopwatchIsMonitoringJank(JSContext*, bool);
 extern JS_PUBLIC_API(bool)
 GetStopwatchIsMonitoringJank(JSContext*);
 
+/**
+ * Measure jank by sampling the running compartment every `intervalMs`
+ * milliseconds instead of timing every compartment transition, which
+ * is much cheaper but only statistically accurate. An interval of 0
+ * goes back to stopwatch-based measurement.
+ *
+ * May return `false` if the sampling thread could not be started.
+ */
+extern JS_PUBLIC_API(bool)
+SetStopwatchSamplingInterval(JSContext*, uint32_t intervalMs);
+extern JS_PUBLIC_API(uint32_t)
+GetStopwatchSamplingInterval(JSContext*);
+
 // Extract the CPU rescheduling data.
 extern JS_PUBLIC_API(void)
 GetPerfMonitoringTestCpuRescheduling(JSContext*, uint64_t* stayed, uint64_t* moved);
@@ -85,6 +85,10 @@ JSRuntime::initializeAtoms(JSContext* cx)
     if (!atoms_ || !atoms_->init(JS_STRING_HASH_COUNT))
         return false;
 
+    concurrentAtomCache_ = cx->new_<ConcurrentAtomCache>();
+    if (!concurrentAtomCache_)
+        return false;
+
     // |permanentAtoms| hasn't been created yet.
     MOZ_ASSERT(!permanentAtoms);
 
@@ -154,6 +158,7 @@ void
 JSRuntime::finishAtoms()
 {
     js_delete(atoms_.ref());
+    js_delete(concurrentAtomCache_.ref());
 
     if (!parentRuntime) {
         js_delete(staticStrings.ref());
@@ -163,6 +168,7 @@ JSRuntime::finishAtoms()
     }
 
     atoms_ = nullptr;
+    concurrentAtomCache_ = nullptr;
     staticStrings = nullptr;
     commonNames = nullptr;
     permanentAtoms = nullptr;
@@ -257,6 +263,15 @@ JSRuntime::transformToPermanentAtoms(JSContext* cx)
     return true;
 }
 
+MOZ_ALWAYS_INLINE JSAtom*
+ConcurrentAtomCache::lookup(const AtomHasher::Lookup& lookup) const
+{
+    JSAtom* atom = entries_[index(lookup.hash)];
+    if (atom && AtomHasher::match(AtomStateEntry(atom, false), lookup))
+        return atom;
+    return nullptr;
+}
+
 static inline AtomSet::Ptr
 LookupAtomState(JSRuntime* rt, const AtomHasher::Lookup& lookup)
 {
@@ -356,6 +371,18 @@ AtomizeAndCopyChars(JSContext* cx, const CharT* tbchars, size_t length, PinningB
         }
     }
 
+    // Off thread parsing can find atoms created by other threads without
+    // taking the exclusive access lock. See ConcurrentAtomCache.
+    JSRuntime* rt = cx->runtime();
+    if (cx->helperThread() && zone && zone->usedByHelperThread() && pin == DoNotPinAtom) {
+        if (JSAtom* atom = rt->concurrentAtomCache().lookup(lookup)) {
+            cx->atomMarking().inlinedMarkAtom(cx, atom);
+            if (zonePtr)
+                mozilla::Unused << zone->atomCache().add(*zonePtr, AtomStateEntry(atom, false));
+            return atom;
+        }
+    }
+
     // Validate the length before taking the exclusive access lock, as throwing
     // an exception here may reenter this code.
     if (MOZ_UNLIKELY(!JSString::validateLength(cx, length)))
@@ -363,7 +390,6 @@ AtomizeAndCopyChars(JSContext* cx, const CharT* tbchars, size_t length, PinningB
 
     AutoLockForExclusiveAccess lock(cx);
 
-    JSRuntime* rt = cx->runtime();
     AtomSet& atoms = rt->atoms(lock);
     AtomSet* atomsAddedWhileSweeping = rt->atomsAddedWhileSweeping();
     AtomSet::AddPtr p;
@@ -390,6 +416,7 @@ AtomizeAndCopyChars(JSContext* cx, const CharT* tbchars, size_t length, PinningB
     if (p) {
         JSAtom* atom = p->asPtr(cx);
         p->setPinned(bool(pin));
+        rt->concurrentAtomCache().put(atom, lookup.hash, lock);
         cx->atomMarking().inlinedMarkAtom(cx, atom);
         if (zonePtr)
             mozilla::Unused << zone->atomCache().add(*zonePtr, AtomStateEntry(atom, false));
@@ -423,6 +450,8 @@ AtomizeAndCopyChars(JSContext* cx, const CharT* tbchars, size_t length, PinningB
             ReportOutOfMemory(cx); /* SystemAllocPolicy does not report OOM. */
             return nullptr;
         }
+
+        rt->concurrentAtomCache().put(atom, lookup.hash, lock);
     }
 
     cx->atomMarking().inlinedMarkAtom(cx, atom);
@@ -7,8 +7,11 @@
 #ifndef jsatom_h
 #define jsatom_h
 
+#include "mozilla/Array.h"
+#include "mozilla/Atomics.h"
 #include "mozilla/HashFunctions.h"
 #include "mozilla/Maybe.h"
+#include "mozilla/TemplateLib.h"
 
 #include "jsalloc.h"
 
@@ -24,6 +27,8 @@ class JSAutoByteString;
 
 namespace js {
 
+class AutoLockForExclusiveAccess;
+
 /*
  * Return a printable, lossless char[] representation of a string-type atom.
  * The lifetime of the result matches the lifetime of bytes.
@@ -126,6 +131,41 @@ public:
     AtomSet::Range all() const { return mSet->all(); }
 };
 
+// A small direct mapped cache of atoms recently found in or added to the
+// atoms table, which helper threads can search without taking the exclusive
+// access lock. Entries are only written with that lock held.
+//
+// Atoms in the cache are not traced. This is safe because only threads
+// parsing off thread search the cache, off thread parsing waits for GCs of
+// the atoms zone to finish, and the cache is cleared before the atoms table
+// is swept.
+class ConcurrentAtomCache
+{
+    static const size_t NumEntriesLog2 = 12;
+    static const size_t NumEntries = size_t(1) << NumEntriesLog2;
+
+    mozilla::Array<mozilla::Atomic<JSAtom*, mozilla::ReleaseAcquire>, NumEntries> entries_;
+
+    static size_t index(HashNumber hash) {
+        return mozilla::ScrambleHashCode(hash) >> (mozilla::tl::BitSize<HashNumber>::value -
+                                                   NumEntriesLog2);
+    }
+
+  public:
+    ConcurrentAtomCache() { clear(); }
+
+    MOZ_ALWAYS_INLINE JSAtom* lookup(const AtomHasher::Lookup& lookup) const;
+
+    void put(JSAtom* atom, HashNumber hash, const AutoLockForExclusiveAccess& lock) {
+        entries_[index(hash)] = atom;
+    }
+
+    void clear() {
+        for (size_t i = 0; i < NumEntries; i++)
+            entries_[i] = nullptr;
+    }
+};
+
 class PropertyName;
 
 }  /* namespace js */
@@ -157,8 +197,6 @@ extern const char js_setter_str[];
 
 namespace js {
 
-class AutoLockForExclusiveAccess;
-
 /*
  * Atom tracing and garbage collection hooks.
  */
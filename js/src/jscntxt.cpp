@@ -1344,6 +1344,7 @@ JSContext::JSContext(JSRuntime* runtime, const JS::ContextOptions& options)
     traceLogger(nullptr),
 #endif
     autoFlushICache_(nullptr),
+    autoWritableJitCodeBatch(nullptr),
     dtoaState(nullptr),
     heapState(JS::HeapState::Idle),
     suppressGC(0),
@@ -1409,6 +1410,7 @@ JSContext::JSContext(JSRuntime* runtime, const JS::ContextOptions& options)
 
     MOZ_ASSERT(!TlsContext.get());
     TlsContext.set(this);
+    LifoChunkPool::setCurrent(&lifoChunkPool());
 
     for (size_t i = 0; i < mozilla::ArrayLength(nativeStackQuota); i++)
         nativeStackQuota[i] = 0;
@@ -1445,6 +1447,11 @@ JSContext::~JSContext()
         DestroyTraceLogger(traceLogger);
 #endif
 
+    // Chunks of LifoAllocs freed after this point go straight back to the
+    // system.
+    if (LifoChunkPool::current() == &lifoChunkPool())
+        LifoChunkPool::setCurrent(nullptr);
+
     MOZ_ASSERT(TlsContext.get() == this);
     TlsContext.set(nullptr);
 }
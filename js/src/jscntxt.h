@@ -177,6 +177,7 @@ struct JSContext : public JS::RootingContext,
     js::WellKnownSymbols& wellKnownSymbols() { return *runtime_->wellKnownSymbols; }
     JS::BuildIdOp buildIdOp() { return runtime_->buildIdOp; }
     const JS::AsmJSCacheOps& asmJSCacheOps() { return runtime_->asmJSCacheOps; }
+    const JS::WasmCacheOps& wasmCacheOps() { return runtime_->wasmCacheOps; }
     js::PropertyName* emptyString() { return runtime_->emptyString; }
     js::FreeOp* defaultFreeOp() { return runtime_->defaultFreeOp(); }
     void* stackLimitAddress(JS::StackKind kind) { return &nativeStackLimit[kind]; }
@@ -456,6 +457,9 @@ struct JSContext : public JS::RootingContext,
     js::jit::AutoFlushICache* autoFlushICache() const;
     void setAutoFlushICache(js::jit::AutoFlushICache* afc);
 
+    /* Pointer to the outermost AutoWritableJitCodeBatch. */
+    js::ThreadLocalData<js::jit::AutoWritableJitCodeBatch*> autoWritableJitCodeBatch;
+
     /* State used by jsdtoa.cpp. */
     js::ThreadLocalData<DtoaState*> dtoaState;
 
@@ -580,6 +584,13 @@ struct JSContext : public JS::RootingContext,
         return frontendCollectionPool_.ref();
     }
 
+  private:
+    // Unused LifoAlloc chunks freed on this thread, see LifoChunkPool.
+    js::ThreadLocalData<js::LifoChunkPool> lifoChunkPool_;
+  public:
+
+    js::LifoChunkPool& lifoChunkPool() { return lifoChunkPool_.ref(); }
+
     void verifyIsSafeToGC() {
         MOZ_DIAGNOSTIC_ASSERT(!inUnsafeRegion,
                               "[AutoAssertNoGC] possible GC in GC-unsafe region");
@@ -938,7 +949,7 @@ struct JSContext : public JS::RootingContext,
     js::ThreadLocalData<void*> promiseRejectionTrackerCallbackData;
 
     JSObject* getIncumbentGlobal(JSContext* cx);
-    bool enqueuePromiseJob(JSContext* cx, js::HandleFunction job, js::HandleObject promise,
+    bool enqueuePromiseJob(JSContext* cx, js::HandleObject job, js::HandleObject promise,
                            js::HandleObject incumbentGlobal);
     void addUnhandledRejectedPromise(JSContext* cx, js::HandleObject promise);
     void removeUnhandledRejectedPromise(JSContext* cx, js::HandleObject promise);
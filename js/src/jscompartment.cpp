@@ -1357,15 +1357,6 @@ JSCompartment::clearScriptNames()
     scriptNameMap = nullptr;
 }
 
-void
-JSCompartment::clearBreakpointsIn(FreeOp* fop, js::Debugger* dbg, HandleObject handler)
-{
-    for (auto script = zone()->cellIter<JSScript>(); !script.done(); script.next()) {
-        if (script->compartment() == this && script->hasAnyBreakpointsOrStepMode())
-            script->clearBreakpointsIn(fop, dbg, handler);
-    }
-}
-
 void
 JSCompartment::addSizeOfIncludingThis(mozilla::MallocSizeOf mallocSizeOf,
                                       size_t* tiAllocationSiteTables,
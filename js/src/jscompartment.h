@@ -1137,8 +1137,6 @@ struct JSCompartment
      */
     bool ensureDelazifyScriptsForDebugger(JSContext* cx);
 
-    void clearBreakpointsIn(js::FreeOp* fop, js::Debugger* dbg, JS::HandleObject handler);
-
   private:
     void sweepBreakpoints(js::FreeOp* fop);
 
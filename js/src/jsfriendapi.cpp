@@ -341,6 +341,18 @@ js::IsSystemZone(Zone* zone)
     return zone->isSystem;
 }
 
+JS_FRIEND_API(void)
+js::SetZoneIsBackground(Zone* zone, bool isBackground)
+{
+    zone->isBackground = isBackground;
+}
+
+JS_FRIEND_API(void)
+js::SetZoneReleaseColdTypesAfter(Zone* zone, uint32_t gcCount)
+{
+    zone->types.releaseColdTypesAfter = gcCount;
+}
+
 JS_FRIEND_API(bool)
 js::IsAtomsCompartment(JSCompartment* comp)
 {
@@ -463,6 +463,23 @@ IsSystemCompartment(JSCompartment* comp);
 extern JS_FRIEND_API(bool)
 IsSystemZone(JS::Zone* zone);
 
+/*
+ * Mark the zone as belonging to content which is not visible to the user, e.g.
+ * a background tab. Off-thread work for background zones is scheduled after
+ * latency-sensitive work for other zones.
+ */
+extern JS_FRIEND_API(void)
+SetZoneIsBackground(JS::Zone* zone, bool isBackground);
+
+/*
+ * Release the type information of scripts in the zone that have not run for
+ * |gcCount| consecutive GCs, even while the zone is preserving JIT code. This
+ * bounds the memory used by type inference in long lived zones. Zero, the
+ * default, disables this.
+ */
+extern JS_FRIEND_API(void)
+SetZoneReleaseColdTypesAfter(JS::Zone* zone, uint32_t gcCount);
+
 extern JS_FRIEND_API(bool)
 IsAtomsCompartment(JSCompartment* comp);
 
@@ -3059,6 +3076,40 @@ SetCooperativeYieldCallback(JSContext* cx, YieldCallback callback);
 extern JS_FRIEND_API(bool)
 SystemZoneAvailable(JSContext* cx);
 
+/*
+ * An embedding-provided store for the large immutable strings of the
+ * SharedImmutableStringsCache -- mostly script source text, compressed or not
+ * -- that can share them with other processes, for example by keeping them in
+ * shared memory keyed by a hash of their contents.
+ *
+ * Both methods may be called on any thread, with the cache's lock held.
+ */
+class SharedStringStore
+{
+  public:
+    // Return a pointer to a copy of the |length| bytes at |chars| that stays
+    // valid until the matching release() call, or nullptr to keep the string
+    // in the process's own heap. The copy must be aligned for char16_t.
+    virtual const char* acquire(const char* chars, size_t length) = 0;
+
+    // Drop a reference to a string returned by acquire().
+    virtual void release(const char* chars, size_t length) = 0;
+
+  protected:
+    virtual ~SharedStringStore() {}
+};
+
+// Strings shorter than this are not worth sharing with other processes.
+static const size_t SharedStringStoreMinLength = 16 * 1024;
+
+/*
+ * Set the process-wide store for large shared immutable strings, or clear it
+ * with nullptr. Strings added to the cache before the call stay in the heap.
+ * The store must outlive all the strings it returned.
+ */
+extern JS_FRIEND_API(void)
+SetSharedStringStore(SharedStringStore* store);
+
 } /* namespace js */
 
 #endif /* jsfriendapi_h */
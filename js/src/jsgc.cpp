@@ -2145,7 +2145,7 @@ void
 GCRuntime::sweepTypesAfterCompacting(Zone* zone)
 {
     FreeOp* fop = rt->defaultFreeOp();
-    zone->beginSweepTypes(fop, rt->gc.releaseObservedTypes && !zone->isPreservingCode());
+    zone->beginSweepTypes(fop, rt->gc.releaseObservedTypes);
 
     AutoClearTypeInferenceStateOnOOM oom(zone);
 
@@ -2420,11 +2420,14 @@ GCRuntime::updateCellPointers(MovingTracer* trc, Zone* zone, AllocKinds kinds, s
         for (size_t i = 0; i < bgTaskCount && !bgArenas.done(); i++) {
             bgTasks[i].emplace(rt, &bgArenas, lock);
             startTask(*bgTasks[i], gcstats::PhaseKind::COMPACT_UPDATE_CELLS, lock);
-            tasksStarted = i;
+            tasksStarted++;
         }
     }
 
-    fgTask->runFromActiveCooperatingThread(rt);
+    {
+        gcstats::AutoPhase ap(stats(), gcstats::PhaseKind::COMPACT_UPDATE_CELLS);
+        fgTask->runFromActiveCooperatingThread(rt);
+    }
 
     {
         AutoLockHelperThreadState lock;
@@ -2543,7 +2546,10 @@ GCRuntime::updateZonePointersToRelocatedCells(Zone* zone, AutoLockForExclusiveAc
     }
 
     // Sweep everything to fix up weak pointers.
-    rt->gc.sweepZoneAfterCompacting(zone);
+    {
+        gcstats::AutoPhase ap(stats(), gcstats::PhaseKind::COMPACT_UPDATE_WEAK);
+        rt->gc.sweepZoneAfterCompacting(zone);
+    }
 
     // Call callbacks to get the rest of the system to fixup other untraced pointers.
     for (CompartmentsInZoneIter comp(zone); !comp.done(); comp.next())
@@ -2580,11 +2586,14 @@ GCRuntime::updateRuntimePointersToRelocatedCells(AutoLockForExclusiveAccess& loc
     }
 
     // Sweep everything to fix up weak pointers.
-    WatchpointMap::sweepAll(rt);
-    Debugger::sweepAll(rt->defaultFreeOp());
-    jit::JitRuntime::SweepJitcodeGlobalTable(rt);
-    for (JS::detail::WeakCacheBase* cache : rt->weakCaches())
-        cache->sweep();
+    {
+        gcstats::AutoPhase ap2(stats(), gcstats::PhaseKind::COMPACT_UPDATE_WEAK);
+        WatchpointMap::sweepAll(rt);
+        Debugger::sweepAll(rt->defaultFreeOp());
+        jit::JitRuntime::SweepJitcodeGlobalTable(rt);
+        for (JS::detail::WeakCacheBase* cache : rt->weakCaches())
+            cache->sweep();
+    }
 
     // Type inference may put more blocks here to free.
     blocksToFreeAfterSweeping.ref().freeAll();
@@ -3164,6 +3173,95 @@ js::gc::BackgroundDecommitTask::run()
     }
 }
 
+static const size_t MaxBackgroundFinalizeTasks = 4;
+
+static size_t
+BackgroundFinalizeTaskCount(const ZoneList& zones)
+{
+    if (!CanUseExtraThreads())
+        return 0;
+
+    size_t zoneCount = 0;
+    for (Zone* zone = zones.front(); zone; zone = zone->nextZone())
+        zoneCount++;
+
+    // The thread calling sweepBackgroundThings may itself be a helper thread,
+    // so leave one helper thread out or the tasks might never get to run.
+    size_t targetTaskCount = Min(HelperThreadState().cpuCount / 2,
+                                 HelperThreadState().threadCount - 1);
+    return Min(Min(targetTaskCount, zoneCount - 1), MaxBackgroundFinalizeTasks);
+}
+
+// Finalizes the arenas queued for background sweeping, taking zones from a
+// list shared with the other tasks. The GC things of a zone must be finalized
+// in the order given by BackgroundFinalizePhases, so a zone is always
+// finalized by a single task. Each task collects the arenas that became
+// empty, for the caller to release once all tasks are done.
+class BackgroundFinalizeTask : public GCParallelTask
+{
+    ZoneList* zones_;
+    unsigned id_;
+    Arena* emptyArenas_;
+
+  public:
+    BackgroundFinalizeTask(JSRuntime* rt, ZoneList* zones, unsigned id)
+      : GCParallelTask(rt), zones_(zones), id_(id), emptyArenas_(nullptr)
+    {}
+
+    ~BackgroundFinalizeTask() override { join(); }
+
+    Arena* emptyArenas() const { return emptyArenas_; }
+
+    void finalizeZones();
+
+  private:
+    Zone* takeZone();
+
+    void run() override {
+        AutoSetThreadIsSweeping threadIsSweeping;
+        finalizeZones();
+    }
+};
+
+Zone*
+BackgroundFinalizeTask::takeZone()
+{
+    AutoLockHelperThreadState lock;
+    if (zones_->isEmpty())
+        return nullptr;
+
+    Zone* zone = zones_->front();
+    zones_->removeFront();
+    return zone;
+}
+
+void
+BackgroundFinalizeTask::finalizeZones()
+{
+    TimeStamp start = TimeStamp::Now();
+    size_t arenaCount = 0;
+
+    FreeOp fop(nullptr);
+    while (Zone* zone = takeZone()) {
+        for (unsigned phase = 0 ; phase < ArrayLength(BackgroundFinalizePhases) ; ++phase) {
+            for (auto kind : BackgroundFinalizePhases[phase].kinds) {
+                Arena* arenas = zone->arenas.arenaListsToSweep(kind);
+                MOZ_RELEASE_ASSERT(uintptr_t(arenas) != uintptr_t(-1));
+                if (arenas) {
+                    if (TraceEnabled()) {
+                        for (Arena* arena = arenas; arena; arena = arena->next)
+                            arenaCount++;
+                    }
+                    ArenaLists::backgroundFinalize(&fop, arenas, &emptyArenas_);
+                }
+            }
+        }
+    }
+
+    if (TraceEnabled())
+        TraceBackgroundFinalize(id_, arenaCount, (TimeStamp::Now() - start).ToMicroseconds());
+}
+
 void
 GCRuntime::sweepBackgroundThings(ZoneList& zones, LifoAlloc& freeBlocks)
 {
@@ -3172,39 +3270,54 @@ GCRuntime::sweepBackgroundThings(ZoneList& zones, LifoAlloc& freeBlocks)
     if (zones.isEmpty())
         return;
 
-    // We must finalize thing kinds in the order specified by BackgroundFinalizePhases.
-    Arena* emptyArenas = nullptr;
-    FreeOp fop(nullptr);
-    for (unsigned phase = 0 ; phase < ArrayLength(BackgroundFinalizePhases) ; ++phase) {
-        for (Zone* zone = zones.front(); zone; zone = zone->nextZone()) {
-            for (auto kind : BackgroundFinalizePhases[phase].kinds) {
-                Arena* arenas = zone->arenas.arenaListsToSweep(kind);
-                MOZ_RELEASE_ASSERT(uintptr_t(arenas) != uintptr_t(-1));
-                if (arenas)
-                    ArenaLists::backgroundFinalize(&fop, arenas, &emptyArenas);
+    // Zones are finalized in parallel by the current thread and up to
+    // MaxBackgroundFinalizeTasks helper threads.
+    size_t taskCount = BackgroundFinalizeTaskCount(zones);
+    BackgroundFinalizeTask fgTask(rt, &zones, 0);
+    Maybe<BackgroundFinalizeTask> bgTasks[MaxBackgroundFinalizeTasks];
+
+    size_t tasksStarted = 0;
+    {
+        AutoLockHelperThreadState lock;
+        for (size_t i = 0; i < taskCount; i++) {
+            bgTasks[i].emplace(rt, &zones, i + 1);
+            if (!bgTasks[i]->startWithLockHeld(lock)) {
+                bgTasks[i].reset();
+                break;
             }
+            tasksStarted++;
         }
     }
 
+    fgTask.finalizeZones();
+
+    {
+        AutoLockHelperThreadState lock;
+        for (size_t i = 0; i < tasksStarted; i++)
+            bgTasks[i]->joinWithLockHeld(lock);
+    }
+
+    MOZ_ASSERT(zones.isEmpty());
+
     AutoLockGC lock(rt);
 
     // Release swept arenas, dropping and reaquiring the lock every so often to
     // avoid blocking the active thread from allocating chunks.
     static const size_t LockReleasePeriod = 32;
     size_t releaseCount = 0;
-    Arena* next;
-    for (Arena* arena = emptyArenas; arena; arena = next) {
-        next = arena->next;
-        rt->gc.releaseArena(arena, lock);
-        releaseCount++;
-        if (releaseCount % LockReleasePeriod == 0) {
-            lock.unlock();
-            lock.lock();
+    for (size_t i = 0; i <= tasksStarted; i++) {
+        Arena* emptyArenas = i == 0 ? fgTask.emptyArenas() : bgTasks[i - 1]->emptyArenas();
+        Arena* next;
+        for (Arena* arena = emptyArenas; arena; arena = next) {
+            next = arena->next;
+            rt->gc.releaseArena(arena, lock);
+            releaseCount++;
+            if (releaseCount % LockReleasePeriod == 0) {
+                lock.unlock();
+                lock.lock();
+            }
         }
     }
-
-    while (!zones.isEmpty())
-        zones.removeFront();
 }
 
 void
@@ -3652,8 +3765,13 @@ GCRuntime::purgeRuntime(AutoLockForExclusiveAccess& lock)
         freeUnusedLifoBlocksAfterSweeping(&target.context()->tempLifoAlloc());
         target.context()->interpreterStack().purge(rt);
         target.context()->frontendCollectionPool().purge();
+        target.context()->lifoChunkPool().purge();
     }
 
+    // Helper threads purge their chunk pools the next time they use them.
+    if (invocationKind == GC_SHRINK)
+        LifoChunkPool::purgeAll();
+
     rt->caches().gsnCache.purge();
     rt->caches().envCoordinateNameCache.purge();
     rt->caches().newObjectCache.purge();
@@ -3935,14 +4053,140 @@ PurgeShapeTablesForShrinkingGC(JSRuntime* rt)
     }
 }
 
-static void
-UnmarkCollectedZones(JSRuntime* rt)
+namespace js {
+namespace gc {
+
+// Hands out segments of the arena lists of all zones being collected so that
+// clearing their mark bits can be shared between several tasks.
+class ArenasToUnmark
 {
-    for (GCZonesIter zone(rt); !zone.done(); zone.next()) {
-        /* Unmark everything in the zones being collected. */
-        zone->arenas.unmarkAll();
+    GCZonesIter zone;
+    AllocKind kind;
+    Arena* arena;
+
+  public:
+    explicit ArenasToUnmark(JSRuntime* rt)
+      : zone(rt), kind(AllocKind::FIRST), arena(nullptr)
+    {}
+
+    ArenaListSegment getArenasToUnmark(AutoLockHelperThreadState& lock, unsigned maxLength);
+};
+
+ArenaListSegment
+ArenasToUnmark::getArenasToUnmark(AutoLockHelperThreadState& lock, unsigned maxLength)
+{
+    while (!zone.done()) {
+        while (kind < AllocKind::LIMIT) {
+            /* The background finalization must have stopped at this point. */
+            MOZ_ASSERT(zone->arenas.doneBackgroundFinalize(kind));
+
+            Arena* begin = arena ? arena->next : zone->arenas.getFirstArena(kind);
+            if (!begin) {
+                kind = AllocKind(uint8_t(kind) + 1);
+                arena = nullptr;
+                continue;
+            }
+
+            Arena* last = begin;
+            unsigned count = 1;
+            while (last->next && count < maxLength) {
+                last = last->next;
+                count++;
+            }
+
+            arena = last;
+            return { begin, last->next };
+        }
+
+        zone.next();
+        kind = AllocKind::FIRST;
+        arena = nullptr;
+    }
+
+    return { nullptr, nullptr };
+}
+
+struct UnmarkArenasTask : public GCParallelTask
+{
+    // Maximum number of arenas to unmark in one block.
+#ifdef DEBUG
+    static const unsigned MaxArenasToProcess = 16;
+#else
+    static const unsigned MaxArenasToProcess = 256;
+#endif
+
+    UnmarkArenasTask(JSRuntime* rt, ArenasToUnmark* source)
+      : GCParallelTask(rt), source_(source)
+    {}
+
+  private:
+    ArenasToUnmark* source_;
+
+    virtual void run() override;
+};
+
+/* virtual */ void
+UnmarkArenasTask::run()
+{
+    for (;;) {
+        ArenaListSegment arenas;
+        {
+            AutoLockHelperThreadState lock;
+            arenas = source_->getArenasToUnmark(lock, MaxArenasToProcess);
+        }
+        if (!arenas.begin)
+            break;
+
+        for (Arena* arena = arenas.begin; arena != arenas.end; arena = arena->next)
+            arena->unmarkAll();
     }
+}
+
+static const size_t MaxUnmarkBackgroundTasks = 8;
 
+static size_t
+UnmarkBackgroundTaskCount()
+{
+    if (!CanUseExtraThreads())
+        return 1;
+
+    // Clearing mark bits is bound by memory bandwidth, so there is little to
+    // be gained from using every core.
+    size_t targetTaskCount = HelperThreadState().cpuCount / 2;
+    return Min(Max(targetTaskCount, size_t(1)), MaxUnmarkBackgroundTasks);
+}
+
+// Run a set of UnmarkArenasTasks for the duration of a scope.
+class MOZ_RAII AutoUnmarkCollectedZones
+{
+    JSRuntime* runtime_;
+    ArenasToUnmark arenas_;
+    Maybe<UnmarkArenasTask> tasks_[MaxUnmarkBackgroundTasks];
+    size_t taskCount_;
+    AutoLockHelperThreadState& lock_;
+
+  public:
+    AutoUnmarkCollectedZones(JSRuntime* rt, AutoLockHelperThreadState& lock)
+      : runtime_(rt), arenas_(rt), taskCount_(UnmarkBackgroundTaskCount()), lock_(lock)
+    {
+        for (size_t i = 0; i < taskCount_; i++) {
+            tasks_[i].emplace(rt, &arenas_);
+            runtime_->gc.startTask(*tasks_[i], gcstats::PhaseKind::UNMARK, lock_);
+        }
+    }
+
+    ~AutoUnmarkCollectedZones() {
+        for (size_t i = 0; i < taskCount_; i++)
+            runtime_->gc.joinTask(*tasks_[i], gcstats::PhaseKind::UNMARK, lock_);
+    }
+};
+
+} // namespace gc
+} // namespace js
+
+static void
+UnmarkWeakMaps(JSRuntime* rt)
+{
     for (GCZonesIter zone(rt); !zone.done(); zone.next()) {
         /* Unmark all weak maps in the zones being collected. */
         WeakMapBase::unmarkZone(zone);
@@ -3985,10 +4229,12 @@ GCRuntime::beginMarkPhase(JS::gcreason::Reason reason, AutoLockForExclusiveAcces
         /*
          * Clear all mark state for the zones we are collecting. This is linear
          * in the size of the heap we are collecting and so can be slow. Do this
-         * in parallel with the rest of this block.
+         * in parallel with the rest of this block, split across several helper
+         * threads by zone and alloc kind.
          */
+        AutoUnmarkCollectedZones unmarkCollectedZones(rt, helperLock);
         AutoRunParallelTask
-            unmarkCollectedZones(rt, UnmarkCollectedZones, gcstats::PhaseKind::UNMARK, helperLock);
+            unmarkWeakMaps(rt, UnmarkWeakMaps, gcstats::PhaseKind::UNMARK, helperLock);
 
         /*
          * Buffer gray roots for incremental collections. This is linear in the
@@ -5176,7 +5422,7 @@ GCRuntime::sweepJitDataOnMainThread(FreeOp* fop)
         gcstats::AutoPhase ap1(stats(), gcstats::PhaseKind::SWEEP_TYPES);
         gcstats::AutoPhase ap2(stats(), gcstats::PhaseKind::SWEEP_TYPES_BEGIN);
         for (GCSweepGroupIter zone(rt); !zone.done(); zone.next())
-            zone->beginSweepTypes(fop, releaseObservedTypes && !zone->isPreservingCode());
+            zone->beginSweepTypes(fop, releaseObservedTypes);
     }
 }
 
@@ -5556,6 +5802,11 @@ GCRuntime::startSweepingAtomsTable()
     if (!atomsTable)
         return;
 
+    // The cache may hold atoms which are about to be finalized. Helper threads
+    // cannot be searching it: off thread parsing waits for GCs of the atoms
+    // zone to finish.
+    rt->concurrentAtomCache().clear();
+
     // Create a secondary table to hold new atoms added while we're sweeping
     // the main table incrementally.
     if (!rt->createAtomsAddedWhileSweepingTable()) {
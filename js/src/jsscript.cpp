@@ -1997,8 +1997,11 @@ SourceCompressionTask::work()
         return;
 
     const char16_t* chars = source->data.as<ScriptSource::Uncompressed>().string.chars();
+    // Sources are decompressed on the main thread whenever a lazy function is
+    // delazified or Function.prototype.toString is called, so favor the
+    // codec which decompresses fastest.
     Compressor comp(reinterpret_cast<const unsigned char*>(chars),
-                    inputBytes);
+                    inputBytes, CompressionCodec::LZ4);
     if (!comp.init())
         return;
 
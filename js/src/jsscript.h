@@ -1713,6 +1713,12 @@ class JSScript : public js::gc::TenuredCell
 
     void maybeSweepTypes(js::AutoClearTypeInferenceStateOnOOM* oom);
 
+  private:
+    /* Destroy the TypeScript while sweeping. */
+    void releaseTypes();
+
+  public:
+
     inline js::GlobalObject& global() const;
     js::GlobalObject& uninlinedGlobal() const;
 
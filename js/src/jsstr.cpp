@@ -1748,6 +1748,14 @@ FirstCharMatcher8bit(const char* text, uint32_t n, const char pat)
     return reinterpret_cast<const char*>(memchr(text, pat, n));
 }
 
+static const char16_t*
+FirstCharMatcher16bit(const char16_t* text, uint32_t n, const char16_t pat)
+{
+    if (n >= VectorCharsMinLength)
+        return VectorFindChar(text, n, pat);
+    return FirstCharMatcherUnrolled(text, n, pat);
+}
+
 template <class InnerMatch, typename TextChar, typename PatChar>
 static int
 Matcher(const TextChar* text, uint32_t textlen, const PatChar* pat, uint32_t patlen)
@@ -1768,7 +1776,8 @@ Matcher(const TextChar* text, uint32_t textlen, const PatChar* pat, uint32_t pat
             MOZ_ASSERT(pat[0] <= 0xff);
             pos = (TextChar*) FirstCharMatcher8bit((char*) text + i, n - i, pat[0]);
         } else {
-            pos = FirstCharMatcherUnrolled(text + i, n - i, char16_t(pat[0]));
+            pos = (TextChar*) FirstCharMatcher16bit((char16_t*) text + i, n - i,
+                                                    char16_t(pat[0]));
         }
 
         if (pos == nullptr)
@@ -19,6 +19,7 @@
 #include "js/RootingAPI.h"
 #include "js/UniquePtr.h"
 #include "vm/Printer.h"
+#include "vm/StringKernels.h"
 #include "vm/Unicode.h"
 
 class JSAutoByteString;
@@ -54,9 +55,15 @@ inline int32_t
 CompareChars(const Char1* s1, size_t len1, const Char2* s2, size_t len2)
 {
     size_t n = Min(len1, len2);
-    for (size_t i = 0; i < n; i++) {
-        if (int32_t cmp = s1[i] - s2[i])
-            return cmp;
+    if (n >= VectorCharsMinLength) {
+        size_t i = VectorMismatch(s1, s2, n);
+        if (i < n)
+            return int32_t(s1[i] - s2[i]);
+    } else {
+        for (size_t i = 0; i < n; i++) {
+            if (int32_t cmp = s1[i] - s2[i])
+                return cmp;
+        }
     }
 
     return int32_t(len1 - len2);
@@ -267,6 +274,20 @@ EqualChars(const Char1* s1, const Char2* s2, size_t len)
     return true;
 }
 
+inline bool
+EqualChars(const Latin1Char* s1, const char16_t* s2, size_t len)
+{
+    if (len >= VectorCharsMinLength)
+        return VectorMismatch(s1, s2, len) == len;
+    return EqualChars<Latin1Char, char16_t>(s1, s2, len);
+}
+
+inline bool
+EqualChars(const char16_t* s1, const Latin1Char* s2, size_t len)
+{
+    return EqualChars(s2, s1, len);
+}
+
 /*
  * Computes |str|'s substring for the range [beginInt, beginInt + lengthInt).
  * Negative, overlarge, swapped, etc. |beginInt| and |lengthInt| are forbidden
@@ -289,17 +310,20 @@ InflateString(JSContext* cx, const char* bytes, size_t* length);
  * enough for 'srclen' char16_t code units. The buffer is NOT null-terminated.
  */
 inline void
-CopyAndInflateChars(char16_t* dst, const char* src, size_t srclen)
+CopyAndInflateChars(char16_t* dst, const JS::Latin1Char* src, size_t srclen)
 {
+    if (srclen >= VectorCharsMinLength) {
+        VectorInflateChars(dst, src, srclen);
+        return;
+    }
     for (size_t i = 0; i < srclen; i++)
-        dst[i] = (unsigned char) src[i];
+        dst[i] = src[i];
 }
 
 inline void
-CopyAndInflateChars(char16_t* dst, const JS::Latin1Char* src, size_t srclen)
+CopyAndInflateChars(char16_t* dst, const char* src, size_t srclen)
 {
-    for (size_t i = 0; i < srclen; i++)
-        dst[i] = src[i];
+    CopyAndInflateChars(dst, reinterpret_cast<const JS::Latin1Char*>(src), srclen);
 }
 
 /*
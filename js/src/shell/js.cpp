@@ -1260,6 +1260,11 @@ ParseCompileOptions(JSContext* cx, CompileOptions& options, HandleObject opts,
     if (!v.isUndefined())
         options.setNoScriptRval(ToBoolean(v));
 
+    if (!JS_GetProperty(cx, opts, "delazifyInnerFunctions", &v))
+        return false;
+    if (!v.isUndefined())
+        options.setDelazifyInnerFunctions(ToBoolean(v));
+
     if (!JS_GetProperty(cx, opts, "fileName", &v))
         return false;
     if (v.isNull()) {
@@ -1437,6 +1442,10 @@ ConvertTranscodeResultToJSException(JSContext* cx, JS::TranscodeResult rv)
         MOZ_ASSERT(!cx->isExceptionPending());
         JS_ReportErrorASCII(cx, "Only interepreted functions are supported by XDR");
         return false;
+      case JS::TranscodeResult_Failure_BadDecode:
+        MOZ_ASSERT(!cx->isExceptionPending());
+        JS_ReportErrorASCII(cx, "XDR data is truncated or malformed");
+        return false;
 
       case JS::TranscodeResult_Throw:
         MOZ_ASSERT(cx->isExceptionPending());
@@ -6402,6 +6411,8 @@ static const JSFunctionSpecWithHelp shell_functions[] = {
 "  and run the code, call |runOffThreadScript|. If present, |options| may\n"
 "  have properties saying how the code should be compiled:\n"
 "      noScriptRval: use the no-script-rval compiler option (default: false)\n"
+"      delazifyInnerFunctions: also compile lazy inner functions on the\n"
+"         helper thread (default: false)\n"
 "      fileName: filename for error messages and debug info\n"
 "      lineNumber: starting line number for error messages and debug info\n"
 "      columnNumber: starting column number for error messages and debug info\n"
@@ -7433,6 +7444,21 @@ ShellCloseAsmJSCacheEntryForRead(size_t serializedSize, const uint8_t* memory, i
     close(handle);
 }
 
+static bool
+EnsureJSCacheDir()
+{
+    // Create the cache directory if it doesn't already exist.
+    struct stat dirStat;
+    if (stat(jsCacheDir, &dirStat) == 0)
+        return !!(dirStat.st_mode & S_IFDIR);
+
+#ifdef XP_WIN
+    return mkdir(jsCacheDir) == 0;
+#else
+    return mkdir(jsCacheDir, 0777) == 0;
+#endif
+}
+
 static JS::AsmJSCacheResult
 ShellOpenAsmJSCacheEntryForWrite(HandleObject global, const char16_t* begin,
                                  const char16_t* end, size_t serializedSize,
@@ -7441,20 +7467,8 @@ ShellOpenAsmJSCacheEntryForWrite(HandleObject global, const char16_t* begin,
     if (!jsCachingEnabled || !jsCacheAsmJSPath)
         return JS::AsmJSCache_Disabled_ShellFlags;
 
-    // Create the cache directory if it doesn't already exist.
-    struct stat dirStat;
-    if (stat(jsCacheDir, &dirStat) == 0) {
-        if (!(dirStat.st_mode & S_IFDIR))
-            return JS::AsmJSCache_InternalError;
-    } else {
-#ifdef XP_WIN
-        if (mkdir(jsCacheDir) != 0)
-            return JS::AsmJSCache_InternalError;
-#else
-        if (mkdir(jsCacheDir, 0777) != 0)
-            return JS::AsmJSCache_InternalError;
-#endif
-    }
+    if (!EnsureJSCacheDir())
+        return JS::AsmJSCache_InternalError;
 
     ScopedFileDesc fd(open(jsCacheAsmJSPath, O_CREAT|O_RDWR, 0660), ScopedFileDesc::WRITE_LOCK);
     if (fd == -1)
@@ -7535,6 +7549,117 @@ ShellCloseAsmJSCacheEntryForWrite(size_t serializedSize, uint8_t* memory, intptr
     close(handle);
 }
 
+// Each wasm cache entry is a file in the cache directory named after its key.
+// Entries are small enough compared to the compilation they save that they are
+// simply read into and written from a heap buffer.
+
+static UniqueChars
+ShellWasmCacheEntryPath(const uint8_t* key)
+{
+    char hex[2 * JS::WasmCacheKeyLength + 1];
+    for (size_t i = 0; i < JS::WasmCacheKeyLength; i++)
+        snprintf(hex + 2 * i, 3, "%02x", key[i]);
+
+    return JS_smprintf("%s/wasm-%s.cache", jsCacheDir, hex);
+}
+
+static bool
+ShellOpenWasmCacheEntryForRead(HandleObject global, const uint8_t* key, size_t* sizeOut,
+                               const uint8_t** memoryOut, intptr_t* handleOut)
+{
+    if (!jsCachingEnabled || !jsCacheDir)
+        return false;
+
+    UniqueChars path = ShellWasmCacheEntryPath(key);
+    if (!path)
+        return false;
+
+    FILE* file = fopen(path.get(), "rb");
+    if (!file)
+        return false;
+
+    AutoCloseFile autoClose(file);
+
+    if (fseek(file, 0, SEEK_END) != 0)
+        return false;
+
+    long size = ftell(file);
+    if (size <= 0 || fseek(file, 0, SEEK_SET) != 0)
+        return false;
+
+    UniquePtr<uint8_t[], JS::FreePolicy> memory(js_pod_malloc<uint8_t>(size));
+    if (!memory)
+        return false;
+
+    if (fread(memory.get(), 1, size, file) != size_t(size))
+        return false;
+
+    *sizeOut = size;
+    *memoryOut = memory.release();
+    *handleOut = 0;
+    return true;
+}
+
+static void
+ShellCloseWasmCacheEntryForRead(size_t size, const uint8_t* memory, intptr_t handle)
+{
+    js_free(const_cast<uint8_t*>(memory));
+}
+
+static bool
+ShellOpenWasmCacheEntryForWrite(HandleObject global, const uint8_t* key, size_t size,
+                                uint8_t** memoryOut, intptr_t* handleOut)
+{
+    if (!jsCachingEnabled || !jsCacheDir)
+        return false;
+
+    if (!EnsureJSCacheDir())
+        return false;
+
+    UniqueChars path = ShellWasmCacheEntryPath(key);
+    if (!path)
+        return false;
+
+    uint8_t* memory = js_pod_malloc<uint8_t>(size);
+    if (!memory)
+        return false;
+
+    // The path is passed to the close callback, which writes out the entry.
+    *memoryOut = memory;
+    *handleOut = intptr_t(path.release());
+    return true;
+}
+
+static void
+ShellCloseWasmCacheEntryForWrite(size_t size, uint8_t* memory, intptr_t handle)
+{
+    UniquePtr<uint8_t[], JS::FreePolicy> autoFreeMemory(memory);
+    UniqueChars path(reinterpret_cast<char*>(handle));
+
+    // Write to a temporary file first so that a concurrent reader never sees
+    // a partially written entry.
+    UniqueChars tempPath = JS_smprintf("%s.%u", path.get(), (unsigned)getpid());
+    if (!tempPath)
+        return;
+
+    FILE* file = fopen(tempPath.get(), "wb");
+    if (!file)
+        return;
+
+    bool ok = fwrite(memory, 1, size, file) == size;
+    ok = fclose(file) == 0 && ok;
+
+    if (!ok || rename(tempPath.get(), path.get()) != 0)
+        remove(tempPath.get());
+}
+
+static const JS::WasmCacheOps wasmCacheOps = {
+    ShellOpenWasmCacheEntryForRead,
+    ShellCloseWasmCacheEntryForRead,
+    ShellOpenWasmCacheEntryForWrite,
+    ShellCloseWasmCacheEntryForWrite
+};
+
 static bool
 ShellBuildId(JS::BuildIdCharVector* buildId)
 {
@@ -8216,6 +8341,44 @@ SetOutputFile(const char* const envVar,
     *outFileP = outFile;
 }
 
+// Initialize the self-hosted code from the XDR file at |xdrPath| if it is
+// usable, and (re)write the file otherwise.
+static bool
+InitSelfHostedCodeWithXDR(JSContext* cx, const char* xdrPath)
+{
+    JS::TranscodeBuffer xdrIn;
+    if (FILE* file = fopen(xdrPath, "rb")) {
+        AutoCloseFile autoClose(file);
+        if (fseek(file, 0, SEEK_END) == 0) {
+            long len = ftell(file);
+            if (len > 0 && fseek(file, 0, SEEK_SET) == 0) {
+                if (!xdrIn.resize(len))
+                    return false;
+                if (fread(xdrIn.begin(), 1, len, file) != size_t(len))
+                    xdrIn.clear();
+            }
+        }
+    }
+
+    JS::TranscodeBuffer xdrOut;
+    JS::TranscodeRange range(xdrIn.begin(), xdrIn.length());
+    if (!JS::InitSelfHostedCode(cx, range, &xdrOut))
+        return false;
+
+    if (xdrOut.empty())
+        return true;
+
+    FILE* file = fopen(xdrPath, "wb");
+    if (!file) {
+        fprintf(stderr, "Warning: can't open %s to write the self-hosted code\n", xdrPath);
+        return true;
+    }
+    AutoCloseFile autoClose(file);
+    if (fwrite(xdrOut.begin(), 1, xdrOut.length(), file) != xdrOut.length())
+        fprintf(stderr, "Warning: can't write the self-hosted code to %s\n", xdrPath);
+    return true;
+}
+
 static void
 PreInit()
 {
@@ -8286,6 +8449,10 @@ main(int argc, char** argv, char** envp)
                                "when the js shell exits. This is useful for running tests in"
                                "parallel.")
         || !op.addBoolOption('\0', "code-coverage", "Enable code coverage instrumentation.")
+        || !op.addStringOption('\0', "selfhosted-xdr-path", "[filename]",
+                               "Decode the self-hosted code from this XDR file instead of "
+                               "compiling it. The file is (re)written if it is missing or was "
+                               "produced by another build.")
 #ifdef DEBUG
         || !op.addBoolOption('O', "print-alloc", "Print the number of allocations at exit")
 #endif
@@ -8368,6 +8535,8 @@ main(int argc, char** argv, char** envp)
                                "Specify Ion register allocation:\n"
                                "  backtracking: Priority based backtracking register allocation (default)\n"
                                "  testbed: Backtracking allocator with experimental features\n"
+                               "  linearscan: Backtracking allocator in linear scan order, without\n"
+                               "              backtracking (used for very large functions)\n"
                                "  stupid: Simple block local register allocation")
         || !op.addBoolOption('\0', "ion-eager", "Always ion-compile methods (implies --baseline-eager)")
         || !op.addStringOption('\0', "ion-offthread-compile", "on/off",
@@ -8520,6 +8689,7 @@ main(int argc, char** argv, char** envp)
     JS_AddInterruptCallback(cx, ShellInterruptCallback);
     JS::SetBuildIdOp(cx, ShellBuildId);
     JS::SetAsmJSCacheOps(cx, &asmJSCacheOps);
+    JS::SetWasmCacheOps(cx, &wasmCacheOps);
 
     JS_SetNativeStackQuota(cx, gMaxStackSize);
 
@@ -8527,8 +8697,13 @@ main(int argc, char** argv, char** envp)
 
     js::UseInternalJobQueues(cx);
 
-    if (!JS::InitSelfHostedCode(cx))
-        return 1;
+    if (const char* xdrPath = op.getStringOption("selfhosted-xdr-path")) {
+        if (!InitSelfHostedCodeWithXDR(cx, xdrPath))
+            return 1;
+    } else {
+        if (!JS::InitSelfHostedCode(cx))
+            return 1;
+    }
 
     EnvironmentPreparer environmentPreparer(cx);
 
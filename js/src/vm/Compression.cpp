@@ -6,6 +6,7 @@
 
 #include "vm/Compression.h"
 
+#include "mozilla/Compression.h"
 #include "mozilla/DebugOnly.h"
 #include "mozilla/MemoryChecking.h"
 #include "mozilla/PodOperations.h"
@@ -29,9 +30,12 @@ zlib_free(void* cx, void* addr)
     js_free(addr);
 }
 
-Compressor::Compressor(const unsigned char* inp, size_t inplen)
-    : inp(inp),
+Compressor::Compressor(const unsigned char* inp, size_t inplen, CompressionCodec codec)
+    : codec(codec),
+      inp(inp),
       inplen(inplen),
+      out(nullptr),
+      outlen(0),
       initialized(false),
       finished(false),
       currentChunkSize(0),
@@ -72,6 +76,8 @@ Compressor::init()
 {
     if (inplen >= UINT32_MAX)
         return false;
+    if (codec == CompressionCodec::LZ4)
+        return true;
     // zlib is slow and we'd rather be done compression sooner
     // even if it means decompression is slower which penalizes
     // Function.toString()
@@ -88,12 +94,45 @@ void
 Compressor::setOutput(unsigned char* out, size_t outlen)
 {
     MOZ_ASSERT(outlen > outbytes);
+    this->out = out;
+    this->outlen = outlen;
     zs.next_out = out + outbytes;
     zs.avail_out = outlen - outbytes;
 }
 
 Compressor::Status
 Compressor::compressMore()
+{
+    if (codec == CompressionCodec::LZ4)
+        return compressMoreLZ4();
+    return compressMoreZlib();
+}
+
+Compressor::Status
+Compressor::compressMoreLZ4()
+{
+    // Chunks are compressed independently, one chunk per call.
+    MOZ_ASSERT(out);
+    size_t chunk = chunkOffsets.length();
+    size_t chunkBytes = chunkSize(inplen, chunk);
+    const char* chunkStart = reinterpret_cast<const char*>(inp + chunk * CHUNK_SIZE);
+
+    size_t written = mozilla::Compression::LZ4::compressLimitedOutput(
+        chunkStart, chunkBytes, reinterpret_cast<char*>(out + outbytes), outlen - outbytes);
+    if (!written)
+        return MOREOUTPUT;
+
+    outbytes += written;
+    if (!chunkOffsets.append(outbytes))
+        return OOM;
+
+    bool done = chunk * CHUNK_SIZE + chunkBytes == inplen;
+    MOZ_ASSERT_IF(done, chunkOffsets.length() == (inplen - 1) / CHUNK_SIZE + 1);
+    return done ? DONE : CONTINUE;
+}
+
+Compressor::Status
+Compressor::compressMoreZlib()
 {
     MOZ_ASSERT(zs.next_out);
     uInt left = inplen - (zs.next_in - inp);
@@ -161,6 +200,7 @@ Compressor::finish(char* dest, size_t destBytes)
 
     CompressedDataHeader* compressedHeader = reinterpret_cast<CompressedDataHeader*>(dest);
     compressedHeader->compressedBytes = outbytes;
+    compressedHeader->codec = codec;
 
     size_t outbytesAligned = AlignBytes(outbytes, sizeof(uint32_t));
 
@@ -226,6 +266,17 @@ js::DecompressStringChunk(const unsigned char* inp, size_t chunk,
 
     bool lastChunk = compressedEnd == compressedBytes;
 
+    if (header->codec == CompressionCodec::LZ4) {
+        size_t decompressed;
+        bool ok = mozilla::Compression::LZ4::decompress(
+            reinterpret_cast<const char*>(inp + compressedStart), compressedEnd - compressedStart,
+            reinterpret_cast<char*>(out), outlen, &decompressed);
+        MOZ_RELEASE_ASSERT(ok && decompressed == outlen);
+        return true;
+    }
+
+    MOZ_ASSERT(header->codec == CompressionCodec::Zlib);
+
     // Mark the memory we pass to zlib as initialized for MSan.
     MOZ_MAKE_MEM_DEFINED(out, outlen);
 
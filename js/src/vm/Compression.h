@@ -16,9 +16,18 @@
 
 namespace js {
 
+// The codec used to compress each chunk. zlib has the better compression
+// ratio, LZ4 compresses and decompresses several times faster.
+enum class CompressionCodec : uint32_t
+{
+    Zlib,
+    LZ4
+};
+
 struct CompressedDataHeader
 {
     uint32_t compressedBytes;
+    CompressionCodec codec;
 };
 
 class Compressor
@@ -32,9 +41,12 @@ class Compressor
     // Number of bytes we should hand to zlib each compressMore() call.
     static const size_t MAX_INPUT_SIZE = 2 * 1024;
 
+    CompressionCodec codec;
     z_stream zs;
     const unsigned char* inp;
     size_t inplen;
+    unsigned char* out;
+    size_t outlen;
     size_t outbytes;
     bool initialized;
     bool finished;
@@ -55,12 +67,19 @@ class Compressor
         OOM
     };
 
-    Compressor(const unsigned char* inp, size_t inplen);
+    Compressor(const unsigned char* inp, size_t inplen,
+               CompressionCodec codec = CompressionCodec::Zlib);
     ~Compressor();
     bool init();
     void setOutput(unsigned char* out, size_t outlen);
     /* Compress some of the input. Return true if it should be called again. */
     Status compressMore();
+
+  private:
+    Status compressMoreZlib();
+    Status compressMoreLZ4();
+
+  public:
     size_t sizeOfChunkOffsets() const { return chunkOffsets.length() * sizeof(chunkOffsets[0]); }
 
     // Returns the number of bytes needed to store the data currently written +
@@ -92,7 +111,8 @@ bool DecompressString(const unsigned char* inp, size_t inplen,
                       unsigned char* out, size_t outlen);
 
 /*
- * Decompress a single chunk of at most Compressor::CHUNK_SIZE bytes.
+ * Decompress a single chunk of at most Compressor::CHUNK_SIZE bytes, using the
+ * codec recorded in the CompressedDataHeader.
  * |chunk| is the chunk index. The caller must know the length of the output
  * (the uncompressed chunk) and allocate |out| to a string of that length.
  */
@@ -2731,6 +2731,59 @@ Debugger::ensureExecutionObservabilityOfScript(JSContext* cx, JSScript* script)
     return updateExecutionObservability(cx, obs, Observing);
 }
 
+static bool
+ScriptHasJitFramesOnStack(JSContext* cx, JSScript* script)
+{
+    using namespace js::jit;
+
+    for (const CooperatingContext& target : cx->runtime()->cooperatingContexts()) {
+        for (JitActivationIterator actIter(cx, target); !actIter.done(); ++actIter) {
+            if (actIter->compartment() != script->compartment())
+                continue;
+
+            for (JitFrameIterator iter(actIter); !iter.done(); ++iter) {
+                switch (iter.type()) {
+                  case JitFrame_BaselineJS:
+                    if (iter.script() == script)
+                        return true;
+                    break;
+                  case JitFrame_IonJS:
+                    // Invalidated Ion frames bail out into the Baseline code
+                    // of the scripts they inlined.
+                    for (InlineFrameIterator inlineIter(cx, &iter); inlineIter.more(); ++inlineIter) {
+                        if (inlineIter.script() == script)
+                            return true;
+                    }
+                    break;
+                  default:;
+                }
+            }
+        }
+    }
+
+    return false;
+}
+
+/* static */ void
+Debugger::dropExecutionObservabilityOfScript(JSContext* cx, JSScript* script)
+{
+    // Observing a script only recompiles that script with debug
+    // instrumentation. Once nothing observes it anymore, discard that code so
+    // that the script warms back up into optimized code, instead of running
+    // instrumented code until the next GC discards it. Scripts with JIT frames
+    // on the stack keep their code.
+    if (script->isDebuggee() ||
+        !script->hasBaselineScript() ||
+        !script->baselineScript()->hasDebugInstrumentation() ||
+        script->hasIonScript() ||
+        ScriptHasJitFramesOnStack(cx, script))
+    {
+        return;
+    }
+
+    jit::FinishDiscardBaselineScript(cx->runtime()->defaultFreeOp(), script);
+}
+
 /* static */ bool
 Debugger::ensureExecutionObservabilityOfOsrFrame(JSContext* cx, InterpreterFrame* frame)
 {
@@ -3911,9 +3964,16 @@ Debugger::getNewestFrame(JSContext* cx, unsigned argc, Value* vp)
 Debugger::clearAllBreakpoints(JSContext* cx, unsigned argc, Value* vp)
 {
     THIS_DEBUGGER(cx, argc, vp, "clearAllBreakpoints", args, dbg);
-    for (WeakGlobalObjectSet::Range r = dbg->debuggees.all(); !r.empty(); r.popFront())
-        r.front()->compartment()->clearBreakpointsIn(cx->runtime()->defaultFreeOp(),
-                                                     dbg, nullptr);
+    FreeOp* fop = cx->runtime()->defaultFreeOp();
+    for (WeakGlobalObjectSet::Range r = dbg->debuggees.all(); !r.empty(); r.popFront()) {
+        JSCompartment* comp = r.front()->compartment();
+        for (auto script = comp->zone()->cellIter<JSScript>(); !script.done(); script.next()) {
+            if (script->compartment() == comp && script->hasAnyBreakpointsOrStepMode()) {
+                script->clearBreakpointsIn(fop, dbg, nullptr);
+                dropExecutionObservabilityOfScript(cx, script);
+            }
+        }
+    }
     return true;
 }
 
@@ -6941,6 +7001,7 @@ class DebuggerScriptClearBreakpointMatcher
 
     ReturnType match(HandleScript script) {
         script->clearBreakpointsIn(cx_->runtime()->defaultFreeOp(), dbg_, handler_);
+        Debugger::dropExecutionObservabilityOfScript(cx_, script);
         return true;
     }
 
@@ -8119,6 +8180,7 @@ DebuggerFrame::setOnStepHandler(JSContext* cx, HandleDebuggerFrame frame, OnStep
         } else if (!handler && prior) {
             // Single stepping toggled on->off.
             referent.script()->decrementStepModeCount(cx->runtime()->defaultFreeOp());
+            Debugger::dropExecutionObservabilityOfScript(cx, referent.script());
         }
     }
 
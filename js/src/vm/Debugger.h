@@ -705,6 +705,10 @@ class Debugger : private mozilla::LinkedListElement<Debugger>
     // Public for DebuggerScript_setBreakpoint.
     static MOZ_MUST_USE bool ensureExecutionObservabilityOfScript(JSContext* cx, JSScript* script);
 
+    // Public for DebuggerScript_clearBreakpoint. Called when a script may
+    // have lost its last breakpoint or stepping frame.
+    static void dropExecutionObservabilityOfScript(JSContext* cx, JSScript* script);
+
     // Whether the Debugger instance needs to observe all non-AOT JS
     // execution of its debugees.
     IsObserving observesAllExecution() const;
@@ -93,6 +93,7 @@ js::StartOffThreadWasmCompile(wasm::CompileTask* task)
 {
     AutoLockHelperThreadState lock;
 
+    task->setQueuedTime(TimeStamp::Now());
     if (!HelperThreadState().wasmWorklist(lock).append(task))
         return false;
 
@@ -105,6 +106,7 @@ js::StartOffThreadIonCompile(JSContext* cx, jit::IonBuilder* builder)
 {
     AutoLockHelperThreadState lock;
 
+    builder->setQueuedTime(TimeStamp::Now());
     if (!HelperThreadState().ionWorklist(lock).append(builder))
         return false;
 
@@ -244,6 +246,7 @@ js::CancelOffThreadIonCompile(const CompilationSelector& selector, bool discardL
         jit::IonBuilder* builder = finished[i];
         if (IonBuilderMatches(selector, builder)) {
             builder->script()->zone()->group()->numFinishedBuilders--;
+            jit::NoteIonCompileCancelled(builder);
             jit::FinishOffThreadBuilder(nullptr, builder, lock);
             HelperThreadState().remove(finished, &i);
         }
@@ -257,8 +260,10 @@ js::CancelOffThreadIonCompile(const CompilationSelector& selector, bool discardL
             jit::IonBuilder* builder = group->ionLazyLinkList().getFirst();
             while (builder) {
                 jit::IonBuilder* next = builder->getNext();
-                if (IonBuilderMatches(selector, builder))
+                if (IonBuilderMatches(selector, builder)) {
+                    jit::NoteIonCompileCancelled(builder);
                     jit::FinishOffThreadBuilder(runtime, builder, lock);
+                }
                 builder = next;
             }
         }
@@ -417,6 +422,67 @@ ScriptParseTask::ScriptParseTask(JSContext* cx, JSObject* parseGlobal,
 {
 }
 
+// Compile the lazy inner functions of |script|, recursively, so that the
+// main thread finds bytecode for them when they are first called. |chars|
+// holds the source text starting at offset |sourceOffset|.
+static bool
+DelazifyInnerFunctions(JSContext* cx, HandleScript script, const char16_t* chars,
+                       size_t sourceOffset)
+{
+    if (!CheckRecursionLimit(cx))
+        return false;
+
+    if (!script->hasObjects())
+        return true;
+
+    RootedFunction fun(cx);
+    Rooted<LazyScript*> lazy(cx);
+    RootedScript innerScript(cx);
+
+    ObjectArray* objects = script->objects();
+    for (size_t i = 0; i < objects->length; i++) {
+        JSObject* obj = objects->vector[i];
+        if (!obj->is<JSFunction>())
+            continue;
+
+        fun = &obj->as<JSFunction>();
+        if (fun->isInterpretedLazy()) {
+            lazy = fun->lazyScriptOrNull();
+            if (!lazy || lazy->maybeScript() || fun != lazy->functionNonDelazifying())
+                continue;
+
+            MOZ_ASSERT(lazy->begin() >= sourceOffset);
+            size_t lazyLength = lazy->end() - lazy->begin();
+            if (!frontend::CompileLazyFunction(cx, lazy, chars + (lazy->begin() - sourceOffset),
+                                               lazyLength))
+            {
+                // See JSFunction::createScriptForLazilyInterpretedFunction.
+                fun->initLazyScript(lazy);
+                if (lazy->hasScript())
+                    lazy->resetScript();
+                return false;
+            }
+
+            innerScript = fun->nonLazyScript();
+            if (!lazy->maybeScript())
+                lazy->initScript(innerScript);
+
+            // Only leaf functions can be relazified.
+            if (!lazy->numInnerFunctions() && !lazy->hasDirectEval())
+                innerScript->setLazyScript(lazy);
+        }
+
+        if (!fun->hasScript())
+            continue;
+
+        innerScript = fun->nonLazyScript();
+        if (!DelazifyInnerFunctions(cx, innerScript, chars, sourceOffset))
+            return false;
+    }
+
+    return true;
+}
+
 void
 ScriptParseTask::parse(JSContext* cx)
 {
@@ -424,9 +490,13 @@ ScriptParseTask::parse(JSContext* cx)
     SourceBufferHolder srcBuf(range.begin().get(), range.length(), SourceBufferHolder::NoOwnership);
     Rooted<ScriptSourceObject*> sourceObject(cx);
 
-    JSScript* script = frontend::CompileGlobalScript(cx, alloc, ScopeKind::Global,
-                                                     options, srcBuf,
-                                                     /* sourceObjectOut = */ &sourceObject.get());
+    RootedScript script(cx, frontend::CompileGlobalScript(cx, alloc, ScopeKind::Global,
+                                                          options, srcBuf,
+                                                          /* sourceObjectOut = */ &sourceObject.get()));
+    if (script && options.delazifyInnerFunctions) {
+        if (!DelazifyInnerFunctions(cx, script, range.begin().get(), options.scriptSourceOffset))
+            script = nullptr;
+    }
     if (script)
         scripts.infallibleAppend(script);
     if (sourceObject)
@@ -667,6 +737,9 @@ CreateGlobalForOffThreadParse(JSContext* cx, ParseTaskKind kind, const gc::AutoS
 static bool
 QueueOffThreadParseTask(JSContext* cx, ParseTask* task)
 {
+    // Time spent waiting for a GC counts towards the queue latency.
+    task->queuedTime = TimeStamp::Now();
+
     if (OffThreadParsingMustWaitForGC(cx->runtime())) {
         AutoLockHelperThreadState lock;
         if (!HelperThreadState().parseWaitingOnGC(lock).append(task)) {
@@ -1084,12 +1157,47 @@ GlobalHelperThreadState::canStartPromiseTask(const AutoLockHelperThreadState& lo
     return !promiseTasks(lock).empty();
 }
 
+bool
+GlobalHelperThreadState::wasmCompileIsStarved(const AutoLockHelperThreadState& lock)
+{
+    return canStartWasmCompile(lock) && checkTaskThreadLimit<wasm::CompileTask*>(1);
+}
+
+// Ion compilations for background zones which have waited this long in the
+// worklist are scheduled like any other, so that they cannot be starved.
+static const uint32_t BackgroundIonCompileDeadlineMs = 500;
+
+static bool
+IonBuilderIsDeferrable(jit::IonBuilder* builder)
+{
+    if (!builder->script()->zoneFromAnyThread()->isBackground)
+        return false;
+
+    TimeDuration waited = TimeStamp::Now() - builder->queuedTime();
+    return waited.ToMilliseconds() < BackgroundIonCompileDeadlineMs;
+}
+
+static bool
+IonCompileIsRunningForZone(Zone* zone, const AutoLockHelperThreadState& lock)
+{
+    for (auto& thread : *HelperThreadState().threads) {
+        if (thread.ionBuilder() && thread.ionBuilder()->script()->zoneFromAnyThread() == zone)
+            return true;
+    }
+    return false;
+}
+
 static bool
 IonBuilderHasHigherPriority(jit::IonBuilder* first, jit::IonBuilder* second)
 {
     // This method can return whatever it wants, though it really ought to be a
     // total order. The ordering is allowed to race (change on the fly), however.
 
+    // Compilations which must not be deferred come first.
+    bool firstIsDeferrable = IonBuilderIsDeferrable(first);
+    if (firstIsDeferrable != IonBuilderIsDeferrable(second))
+        return !firstIsDeferrable;
+
     // A lower optimization level indicates a higher priority.
     if (first->optimizationInfo().level() != second->optimizationInfo().level())
         return first->optimizationInfo().level() < second->optimizationInfo().level();
@@ -1126,10 +1234,28 @@ GlobalHelperThreadState::highestPriorityPendingIonCompile(const AutoLockHelperTh
         return nullptr;
     }
 
-    // Get the highest priority IonBuilder which has not started compilation yet.
+    // Get the highest priority IonBuilder which has not started compilation
+    // yet. Among builders which are equally urgent, prefer those for zones
+    // without a compilation running already, so that a single zone cannot
+    // occupy all the helper threads.
+    auto hasHigherPriority = [&](jit::IonBuilder* first, jit::IonBuilder* second) {
+        bool firstIsDeferrable = IonBuilderIsDeferrable(first);
+        if (firstIsDeferrable != IonBuilderIsDeferrable(second))
+            return !firstIsDeferrable;
+
+        bool firstZoneIsBusy =
+            IonCompileIsRunningForZone(first->script()->zoneFromAnyThread(), lock);
+        bool secondZoneIsBusy =
+            IonCompileIsRunningForZone(second->script()->zoneFromAnyThread(), lock);
+        if (firstZoneIsBusy != secondZoneIsBusy)
+            return !firstZoneIsBusy;
+
+        return IonBuilderHasHigherPriority(first, second);
+    };
+
     size_t index = 0;
     for (size_t i = 1; i < worklist.length(); i++) {
-        if (IonBuilderHasHigherPriority(worklist[i], worklist[index]))
+        if (hasHigherPriority(worklist[i], worklist[index]))
             index = i;
     }
     jit::IonBuilder* builder = worklist[index];
@@ -1210,6 +1336,13 @@ GlobalHelperThreadState::pendingIonCompileHasSufficientPriority(
     return false;
 }
 
+bool
+GlobalHelperThreadState::pendingIonCompileIsDeferrable(const AutoLockHelperThreadState& lock)
+{
+    jit::IonBuilder* builder = highestPriorityPendingIonCompile(lock);
+    return builder && IonBuilderIsDeferrable(builder);
+}
+
 bool
 GlobalHelperThreadState::canStartParseTask(const AutoLockHelperThreadState& lock)
 {
@@ -1334,6 +1467,24 @@ TimeSince(TimeStamp prev)
     return now - prev;
 }
 
+void
+QueueLatencyHistogram::add(TimeDuration latency)
+{
+    double micros = latency.ToMicroseconds();
+    size_t bucket = 0;
+    while (bucket < NumBuckets - 1 && micros >= double(uint64_t(1) << bucket))
+        bucket++;
+    counts[bucket]++;
+}
+
+void
+GlobalHelperThreadState::noteTaskStarted(HelperTaskKind kind, TimeStamp queuedTime,
+                                         const AutoLockHelperThreadState& lock)
+{
+    if (!queuedTime.IsNull())
+        queueLatencies_[kind].add(TimeSince(queuedTime));
+}
+
 void
 js::GCParallelTask::runFromActiveCooperatingThread(JSRuntime* rt)
 {
@@ -1690,6 +1841,7 @@ HelperThread::handleWasmWorkload(AutoLockHelperThreadState& locked)
     MOZ_ASSERT(idle());
 
     currentTask.emplace(HelperThreadState().wasmWorklist(locked).popCopy());
+    HelperThreadState().noteTaskStarted(HelperTaskKind::Wasm, wasmTask()->queuedTime(), locked);
     bool success = false;
     UniqueChars error;
 
@@ -1753,6 +1905,7 @@ HelperThread::handleIonWorkload(AutoLockHelperThreadState& locked)
     // remove it from the worklist.
     jit::IonBuilder* builder =
         HelperThreadState().highestPriorityPendingIonCompile(locked, /* remove = */ true);
+    HelperThreadState().noteTaskStarted(HelperTaskKind::Ion, builder->queuedTime(), locked);
 
     // If there are now too many threads with active IonBuilders, indicate to
     // the one with the lowest priority that it should pause. Note that due to
@@ -1782,7 +1935,9 @@ HelperThread::handleIonWorkload(AutoLockHelperThreadState& locked)
         jit::JitContext jctx(jit::CompileRuntime::get(rt),
                              jit::CompileCompartment::get(builder->script()->compartment()),
                              &builder->alloc());
+        TimeStamp start = TimeStamp::Now();
         builder->setBackgroundCodegen(jit::CompileBackEnd(builder));
+        builder->setBackgroundCompileTime(TimeSince(start));
     }
 
     FinishOffThreadIonCompile(builder, locked);
@@ -1909,6 +2064,7 @@ HelperThread::handleParseWorkload(AutoLockHelperThreadState& locked)
 
     currentTask.emplace(HelperThreadState().parseWorklist(locked).popCopy());
     ParseTask* task = parseTask();
+    HelperThreadState().noteTaskStarted(HelperTaskKind::Parse, task->queuedTime, locked);
 
     {
         AutoUnlockHelperThreadState unlock(locked);
@@ -2163,13 +2319,26 @@ HelperThread::threadLoop()
             HelperThreadState().wait(lock, GlobalHelperThreadState::PRODUCER);
         }
 
-        if (HelperThreadState().canStartGCParallelTask(lock)) {
+        // GC tasks usually have the active thread waiting on them and come
+        // first, except that they must not keep every thread away from pending
+        // wasm compilation. Ion compilations for background zones yield to
+        // the other compilation and parsing tasks until their deadline.
+        bool deferIonCompile = ionCompile &&
+                               HelperThreadState().pendingIonCompileIsDeferrable(lock) &&
+                               (HelperThreadState().canStartWasmCompile(lock) ||
+                                HelperThreadState().canStartPromiseTask(lock) ||
+                                HelperThreadState().canStartParseTask(lock));
+
+        if (HelperThreadState().wasmCompileIsStarved(lock)) {
+            js::oom::SetThreadType(js::oom::THREAD_TYPE_WASM);
+            handleWasmWorkload(lock);
+        } else if (HelperThreadState().canStartGCParallelTask(lock)) {
             js::oom::SetThreadType(js::oom::THREAD_TYPE_GCPARALLEL);
             handleGCParallelWorkload(lock);
         } else if (HelperThreadState().canStartGCHelperTask(lock)) {
             js::oom::SetThreadType(js::oom::THREAD_TYPE_GCHELPER);
             handleGCHelperWorkload(lock);
-        } else if (ionCompile) {
+        } else if (ionCompile && !deferIonCompile) {
             js::oom::SetThreadType(js::oom::THREAD_TYPE_ION);
             handleIonWorkload(lock);
         } else if (HelperThreadState().canStartWasmCompile(lock)) {
@@ -2181,6 +2350,9 @@ HelperThread::threadLoop()
         } else if (HelperThreadState().canStartParseTask(lock)) {
             js::oom::SetThreadType(js::oom::THREAD_TYPE_PARSE);
             handleParseWorkload(lock);
+        } else if (ionCompile) {
+            js::oom::SetThreadType(js::oom::THREAD_TYPE_ION);
+            handleIonWorkload(lock);
         } else if (HelperThreadState().canStartCompressionTask(lock)) {
             js::oom::SetThreadType(js::oom::THREAD_TYPE_COMPRESS);
             handleCompressionWorkload(lock);
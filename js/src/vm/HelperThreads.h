@@ -14,6 +14,7 @@
 #define vm_HelperThreads_h
 
 #include "mozilla/Attributes.h"
+#include "mozilla/EnumeratedArray.h"
 #include "mozilla/GuardObjects.h"
 #include "mozilla/PodOperations.h"
 #include "mozilla/TimeStamp.h"
@@ -57,6 +58,30 @@ enum class ParseTaskKind
     MultiScriptsDecode
 };
 
+// Helper thread tasks whose time spent waiting in a worklist is recorded.
+enum class HelperTaskKind
+{
+    Ion,
+    Wasm,
+    Parse,
+    Limit
+};
+
+// Histogram of the time tasks spend in a worklist before a helper thread
+// starts running them. Bucket |i| counts the tasks which waited less than
+// 2^i microseconds, except for the last bucket which counts all the others.
+struct QueueLatencyHistogram
+{
+    static const size_t NumBuckets = 24;
+    uint32_t counts[NumBuckets];
+
+    QueueLatencyHistogram() {
+        mozilla::PodArrayZero(counts);
+    }
+
+    void add(mozilla::TimeDuration latency);
+};
+
 // Per-process state for off thread work items.
 class GlobalHelperThreadState
 {
@@ -122,6 +147,10 @@ class GlobalHelperThreadState
     // GC tasks needing to be done in parallel.
     GCParallelTaskVector gcParallelWorklist_;
 
+    // Queue latencies of the tasks started so far.
+    mozilla::EnumeratedArray<HelperTaskKind, HelperTaskKind::Limit,
+                             QueueLatencyHistogram> queueLatencies_;
+
     ParseTask* removeFinishedParseTask(ParseTaskKind kind, void* token);
 
   public:
@@ -224,6 +253,13 @@ class GlobalHelperThreadState
         return gcParallelWorklist_;
     }
 
+    void noteTaskStarted(HelperTaskKind kind, mozilla::TimeStamp queuedTime,
+                         const AutoLockHelperThreadState&);
+    const QueueLatencyHistogram& queueLatency(HelperTaskKind kind,
+                                              const AutoLockHelperThreadState&) const {
+        return queueLatencies_[kind];
+    }
+
     bool canStartWasmCompile(const AutoLockHelperThreadState& lock);
     bool canStartPromiseTask(const AutoLockHelperThreadState& lock);
     bool canStartIonCompile(const AutoLockHelperThreadState& lock);
@@ -241,6 +277,15 @@ class GlobalHelperThreadState
     // over time, even if the helper thread state lock is held throughout.
     bool pendingIonCompileHasSufficientPriority(const AutoLockHelperThreadState& lock);
 
+    // Whether the highest priority pending Ion compilation is for a background
+    // zone and has not yet waited past BackgroundIonCompileDeadline. Such
+    // compilations yield to other latency-sensitive work.
+    bool pendingIonCompileIsDeferrable(const AutoLockHelperThreadState& lock);
+
+    // Whether no helper thread is compiling wasm while wasm work is pending,
+    // in which case the wasm work takes precedence over GC tasks.
+    bool wasmCompileIsStarved(const AutoLockHelperThreadState& lock);
+
     jit::IonBuilder* highestPriorityPendingIonCompile(const AutoLockHelperThreadState& lock,
                                                       bool remove = false);
     HelperThread* lowestPriorityUnpausedIonCompileAtThreshold(
@@ -662,6 +707,9 @@ struct ParseTask
     bool overRecursed;
     bool outOfMemory;
 
+    // When the task was queued for a helper thread.
+    mozilla::TimeStamp queuedTime;
+
     ParseTask(ParseTaskKind kind, JSContext* cx, JSObject* parseGlobal,
               const char16_t* chars, size_t length,
               JS::OffThreadCompileCallback callback, void* callbackData);
@@ -15,6 +15,7 @@
 #include "jstypes.h"
 
 #include "builtin/AtomicsObject.h"
+#include "ds/LifoAlloc.h"
 #include "ds/MemoryProtectionExceptionHandler.h"
 #include "gc/Statistics.h"
 #include "jit/ExecutableAllocator.h"
@@ -95,6 +96,7 @@ JS::detail::InitWithFailureDiagnostic(bool isDebugBuild)
 #endif
 
     RETURN_IF_FAIL(js::TlsContext.init());
+    RETURN_IF_FAIL(js::LifoChunkPool::Init());
 
 #if defined(DEBUG) || defined(JS_OOM_BREAKPOINT)
     RETURN_IF_FAIL(js::oom::InitThreadType());
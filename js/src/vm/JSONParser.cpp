@@ -16,6 +16,7 @@
 #include "jscompartment.h"
 #include "jsnum.h"
 #include "jsprf.h"
+#include "jsstr.h"
 
 #include "vm/StringBuffer.h"
 
@@ -57,6 +58,9 @@ JSONParserBase::trace(JSTracer* trc)
             }
         }
     }
+
+    for (size_t i = 0; i < PropertyNameCacheSize; i++)
+        TraceNullableRoot(trc, &propertyNameCache[i], "JSONParser property name cache");
 }
 
 template <typename CharT>
@@ -106,6 +110,33 @@ JSONParserBase::errorReturn()
     return errorHandling == NoError;
 }
 
+template <typename CharT>
+JSAtom*
+JSONParser<CharT>::atomizePropertyName(const CharT* chars, size_t length)
+{
+    // Index the cache with cheap properties of the name rather than its hash,
+    // which AtomizeChars would compute anyway on a miss.
+    size_t index = length;
+    if (length > 0)
+        index ^= (size_t(chars[0]) << 1) ^ (size_t(chars[length - 1]) << 3);
+    index %= PropertyNameCacheSize;
+
+    JSAtom* atom = propertyNameCache[index];
+    if (atom && atom->length() == length) {
+        JS::AutoCheckCannotGC nogc;
+        bool match = atom->hasLatin1Chars()
+                     ? EqualChars(atom->latin1Chars(nogc), chars, length)
+                     : EqualChars(atom->twoByteChars(nogc), chars, length);
+        if (match)
+            return atom;
+    }
+
+    atom = AtomizeChars(cx, chars, length);
+    if (atom)
+        propertyNameCache[index] = atom;
+    return atom;
+}
+
 template <typename CharT>
 template <JSONParserBase::StringType ST>
 JSONParserBase::Token
@@ -134,7 +165,7 @@ JSONParser<CharT>::readString()
             size_t length = current - start;
             current++;
             JSFlatString* str = (ST == JSONParser::PropertyName)
-                                ? AtomizeChars(cx, start.get(), length)
+                                ? atomizePropertyName(start.get(), length)
                                 : NewStringCopyN<CanGC>(cx, start.get(), length);
             if (!str)
                 return token(OOM);
@@ -8,6 +8,7 @@
 #define vm_JSONParser_h
 
 #include "mozilla/Attributes.h"
+#include "mozilla/PodOperations.h"
 #include "mozilla/Range.h"
 
 #include "jspubtd.h"
@@ -103,6 +104,12 @@ class MOZ_STACK_CLASS JSONParserBase
     Vector<ElementVector*, 5> freeElements;
     Vector<PropertyVector*, 5> freeProperties;
 
+    // The records in a JSON array usually have the same property names, so
+    // the atoms for recently seen names are cached to avoid looking them up
+    // in the atoms table again.
+    static const size_t PropertyNameCacheSize = 64;
+    JSAtom* propertyNameCache[PropertyNameCacheSize];
+
 #ifdef DEBUG
     Token lastToken;
 #endif
@@ -116,7 +123,9 @@ class MOZ_STACK_CLASS JSONParserBase
 #ifdef DEBUG
       , lastToken(Error)
 #endif
-    {}
+    {
+        mozilla::PodArrayZero(propertyNameCache);
+    }
     ~JSONParserBase();
 
     // Allow move construction for use with Rooted.
@@ -130,7 +139,9 @@ class MOZ_STACK_CLASS JSONParserBase
 #ifdef DEBUG
       , lastToken(mozilla::Move(other.lastToken))
 #endif
-    {}
+    {
+        mozilla::PodArrayCopy(propertyNameCache, other.propertyNameCache);
+    }
 
 
     Value numberValue() const {
@@ -237,6 +248,7 @@ class MOZ_STACK_CLASS JSONParser : public JSONParserBase
 
   private:
     template<StringType ST> Token readString();
+    JSAtom* atomizePropertyName(const CharT* chars, size_t length);
 
     Token readNumber();
 
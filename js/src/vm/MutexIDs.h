@@ -27,6 +27,7 @@
   _(GCLock,                      400) \
                                       \
   _(WasmInitBuiltinThunks,       450) \
+  _(TraceLoggerStreamState,      450) \
                                       \
   _(SharedImmutableStringsCache, 500) \
   _(FutexThread,                 500) \
@@ -43,6 +44,7 @@
   _(TraceLoggerThreadState,      500) \
   _(DateTimeInfoMutex,           500) \
   _(IcuTimeZoneStateMutex,       500) \
+  _(PerfMonitoringSampler,       500) \
                                       \
   /* ProcessExecutableRegion > PromiseTaskPtrVector */ \
   /* WasmCodeProfilingLabels > PromiseTaskPtrVector */ \
@@ -880,6 +880,12 @@ ObjectGroup::newArrayObject(JSContext* cx,
         return nullptr;
     if (group->maybePreliminaryObjects())
         group->maybePreliminaryObjects()->maybeAnalyze(cx, group);
+
+    // Arrays created through this table (e.g. by JSON.parse) share a group
+    // per element type, so honor the nursery's pretenuring decision for it.
+    if (newKind == GenericObject && group->shouldPreTenure())
+        newKind = TenuredObject;
+
     if (group->maybeUnboxedLayout()) {
         switch (group->unboxedLayout().elementType()) {
           case JSVAL_TYPE_BOOLEAN:
@@ -1330,6 +1336,11 @@ ObjectGroup::newPlainObject(JSContext* cx, IdValuePair* properties, size_t nprop
 
     RootedObjectGroup group(cx, p->value().group);
 
+    // Objects with the same property names (e.g. records from JSON.parse)
+    // share this group; honor the nursery's pretenuring decision for it.
+    if (newKind == GenericObject && group->shouldPreTenure())
+        newKind = TenuredObject;
+
     // Watch for existing groups which now use an unboxed layout.
     if (group->maybeUnboxedLayout()) {
         MOZ_ASSERT(group->unboxedLayout().properties().length() == nproperties);
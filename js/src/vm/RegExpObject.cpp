@@ -956,8 +956,13 @@ RegExpShared::traceChildren(JSTracer* trc)
 void
 RegExpShared::discardJitCode()
 {
-    for (auto& comp : compilationArray)
+    for (auto& comp : compilationArray) {
         comp.jitCode = nullptr;
+        if (comp.sharedCode) {
+            comp.sharedCode->release();
+            comp.sharedCode = nullptr;
+        }
+    }
 
     // We can also purge the tables used by JIT code.
     tables.clearAndFree();
@@ -966,8 +971,11 @@ RegExpShared::discardJitCode()
 void
 RegExpShared::finalize(FreeOp* fop)
 {
-    for (auto& comp : compilationArray)
+    for (auto& comp : compilationArray) {
         js_free(comp.byteCode);
+        if (comp.sharedCode)
+            comp.sharedCode->release();
+    }
     tables.~JitCodeTables();
 }
 
@@ -989,6 +997,24 @@ RegExpShared::compile(JSContext* cx, MutableHandleRegExpShared re, HandleAtom pa
     if (!re->ignoreCase() && !StringHasRegExpMetaChars(pattern))
         re->canStringMatch = true;
 
+    bool latin1 = input->hasLatin1Chars();
+
+    // Reuse native code compiled for another zone of the group. Such code
+    // was compiled from a pattern which parsed successfully, so we don't
+    // need to parse it again.
+    RegExpCodeCache* codeCache = cx->zone()->group()->regExpCodeCache;
+    if (force == DontForceByteCode) {
+        RegExpCodeCacheEntry* entry =
+            codeCache->lookup(pattern, re->getFlags(), latin1, mode == MatchOnly);
+        if (entry) {
+            RegExpCompilation& compilation = re->compilation(mode, latin1);
+            re->parenCount = entry->getParenCount();
+            compilation.jitCode = entry->getCode();
+            compilation.sharedCode = entry;
+            return true;
+        }
+    }
+
     CompileOptions options(cx);
     frontend::TokenStream dummyTokenStream(cx, options, nullptr, 0, nullptr);
 
@@ -1005,15 +1031,18 @@ RegExpShared::compile(JSContext* cx, MutableHandleRegExpShared re, HandleAtom pa
 
     re->parenCount = data.capture_count;
 
+    bool shareCode = force == DontForceByteCode && codeCache->makeRoom();
+
     JitCodeTables tables;
     irregexp::RegExpCode code = irregexp::CompilePattern(cx, re, &data, input,
                                                          false /* global() */,
                                                          re->ignoreCase(),
-                                                         input->hasLatin1Chars(),
+                                                         latin1,
                                                          mode == MatchOnly,
                                                          force == ForceByteCode,
                                                          re->sticky(),
                                                          re->unicode(),
+                                                         shareCode,
                                                          tables);
     if (code.empty())
         return false;
@@ -1021,8 +1050,17 @@ RegExpShared::compile(JSContext* cx, MutableHandleRegExpShared re, HandleAtom pa
     MOZ_ASSERT(!code.jitCode || !code.byteCode);
     MOZ_ASSERT_IF(force == ForceByteCode, code.byteCode);
 
-    RegExpCompilation& compilation = re->compilation(mode, input->hasLatin1Chars());
-    if (code.jitCode) {
+    RegExpCompilation& compilation = re->compilation(mode, latin1);
+    if (code.jitCode && shareCode) {
+        // The cache owns the code and its tables.
+        RegExpCodeCacheEntry* entry =
+            codeCache->add(cx, pattern, re->getFlags(), latin1, mode == MatchOnly,
+                           re->parenCount, code.jitCode, Move(tables));
+        if (!entry)
+            return false;
+        compilation.jitCode = code.jitCode;
+        compilation.sharedCode = entry;
+    } else if (code.jitCode) {
         // First copy the tables. GC can purge the tables if the RegExpShared
         // has no JIT code, so it's important to do this right before setting
         // compilation.jitCode (to ensure no purging happens between adding the
@@ -1327,6 +1365,113 @@ RegExpZone::RegExpZone(Zone* zone)
   : set_(zone, zone->runtimeFromActiveCooperatingThread())
 {}
 
+/* RegExpCodeCache */
+
+size_t
+RegExpCodeCacheEntry::sizeOfIncludingThis(mozilla::MallocSizeOf mallocSizeOf) const
+{
+    size_t n = mallocSizeOf(this) + tables.sizeOfExcludingThis(mallocSizeOf);
+    for (size_t i = 0; i < tables.length(); i++)
+        n += mallocSizeOf(tables[i].get());
+    return n;
+}
+
+RegExpCodeCache::~RegExpCodeCache()
+{
+    // The zone group's zones have all been destroyed, along with the
+    // RegExpShareds using the code.
+    while (RegExpCodeCacheEntry* entry = lru_.popFirst()) {
+        MOZ_ASSERT(entry->users == 0);
+        js_delete(entry);
+    }
+}
+
+RegExpCodeCacheEntry*
+RegExpCodeCache::lookup(JSAtom* source, RegExpFlag flags, bool latin1, bool matchOnly)
+{
+    Set::Ptr p = set_.lookup(Lookup(source, flags, latin1, matchOnly));
+    if (!p)
+        return nullptr;
+
+    RegExpCodeCacheEntry* entry = *p;
+    entry->remove();
+    lru_.insertBack(entry);
+    entry->users++;
+    return entry;
+}
+
+void
+RegExpCodeCache::remove(RegExpCodeCacheEntry* entry)
+{
+    MOZ_ASSERT(entry->users == 0);
+
+    set_.remove(Lookup(entry->source, entry->flags, entry->latin1, entry->matchOnly));
+    entry->remove();
+    bytes_ -= entry->code->instructionsSize();
+
+    // The code is no longer traced and will be collected with the atoms.
+    js_delete(entry);
+}
+
+bool
+RegExpCodeCache::makeRoom()
+{
+    RegExpCodeCacheEntry* entry = lru_.getFirst();
+    while (bytes_ >= MaxBytes && entry) {
+        RegExpCodeCacheEntry* next = entry->getNext();
+        if (entry->users == 0)
+            remove(entry);
+        entry = next;
+    }
+    return bytes_ < MaxBytes;
+}
+
+RegExpCodeCacheEntry*
+RegExpCodeCache::add(JSContext* cx, JSAtom* source, RegExpFlag flags, bool latin1,
+                     bool matchOnly, size_t parenCount, jit::JitCode* code,
+                     RegExpShared::JitCodeTables&& tables)
+{
+    MOZ_ASSERT(code->zone()->isAtomsZone());
+
+    Lookup lookup(source, flags, latin1, matchOnly);
+    Set::AddPtr p = set_.lookupForAdd(lookup);
+    MOZ_ASSERT(!p);
+
+    RegExpCodeCacheEntry* entry = cx->new_<RegExpCodeCacheEntry>(source, flags, latin1, matchOnly,
+                                                                 parenCount, code, Move(tables));
+    if (!entry)
+        return nullptr;
+
+    if (!set_.add(p, entry)) {
+        js_delete(entry);
+        ReportOutOfMemory(cx);
+        return nullptr;
+    }
+
+    lru_.insertBack(entry);
+    bytes_ += code->instructionsSize();
+    entry->users++;
+    return entry;
+}
+
+void
+RegExpCodeCache::trace(JSTracer* trc)
+{
+    for (RegExpCodeCacheEntry* entry : lru_) {
+        TraceRoot(trc, &entry->source, "RegExpCodeCache source");
+        TraceRoot(trc, &entry->code, "RegExpCodeCache code");
+    }
+}
+
+size_t
+RegExpCodeCache::sizeOfIncludingThis(mozilla::MallocSizeOf mallocSizeOf) const
+{
+    size_t n = mallocSizeOf(this) + set_.sizeOfExcludingThis(mallocSizeOf);
+    for (const RegExpCodeCacheEntry* entry = lru_.getFirst(); entry; entry = entry->getNext())
+        n += entry->sizeOfIncludingThis(mallocSizeOf);
+    return n;
+}
+
 /* Functions */
 
 JSObject*
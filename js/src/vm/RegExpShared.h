@@ -13,6 +13,8 @@
 #define vm_RegExpShared_h
 
 #include "mozilla/Assertions.h"
+#include "mozilla/Atomics.h"
+#include "mozilla/LinkedList.h"
 #include "mozilla/MemoryReporting.h"
 
 #include "jsalloc.h"
@@ -32,6 +34,7 @@ namespace js {
 
 class ArrayObject;
 class MatchPairs;
+class RegExpCodeCacheEntry;
 class RegExpCompartment;
 class RegExpShared;
 class RegExpStatics;
@@ -108,7 +111,11 @@ class RegExpShared : public gc::TenuredCell
         ReadBarriered<jit::JitCode*> jitCode;
         uint8_t* byteCode;
 
-        RegExpCompilation() : byteCode(nullptr) {}
+        // If jitCode is owned by the zone group's RegExpCodeCache, the cache
+        // entry holding it.
+        RegExpCodeCacheEntry* sharedCode;
+
+        RegExpCompilation() : byteCode(nullptr), sharedCode(nullptr) {}
 
         bool compiled(ForceByteCodeEnum force = DontForceByteCode) const {
             return byteCode || (force == DontForceByteCode && jitCode);
@@ -282,6 +289,118 @@ class RegExpZone
     size_t sizeOfExcludingThis(mozilla::MallocSizeOf mallocSizeOf);
 };
 
+/*
+ * Native RegExp code does not depend on the zone it is used in: it only
+ * embeds the runtime, the address of the zone group's owner context and its
+ * data tables. A RegExpCodeCache holds the code compiled for all zones of a
+ * zone group, so that a RegExp used in several globals, such as a library
+ * loaded in many frames, is compiled once per group.
+ *
+ * The cached code is allocated in the atoms zone so that RegExpShareds in any
+ * zone can point to it. It is kept alive by the cache, which is traced with
+ * the atoms. Entries are evicted in least recently used order once the cached
+ * code exceeds MaxBytes, but only after all RegExpShareds using them have
+ * discarded their code or died: the atoms zone can be collected without the
+ * zones pointing to the code.
+ */
+class RegExpCodeCacheEntry : public mozilla::LinkedListElement<RegExpCodeCacheEntry>
+{
+    friend class RegExpCodeCache;
+
+    JSAtom* source;
+    RegExpFlag flags;
+    bool latin1;
+    bool matchOnly;
+    size_t parenCount;
+    jit::JitCode* code;
+    RegExpShared::JitCodeTables tables;
+
+    // Number of RegExpShareds using the code. Decremented when RegExpShareds
+    // are finalized, which may happen off thread.
+    mozilla::Atomic<uint32_t> users;
+
+  public:
+    RegExpCodeCacheEntry(JSAtom* source, RegExpFlag flags, bool latin1, bool matchOnly,
+                         size_t parenCount, jit::JitCode* code,
+                         RegExpShared::JitCodeTables&& tables)
+      : source(source), flags(flags), latin1(latin1), matchOnly(matchOnly),
+        parenCount(parenCount), code(code), tables(Move(tables)), users(0)
+    {}
+
+    size_t getParenCount() const { return parenCount; }
+    jit::JitCode* getCode() const { return code; }
+
+    void release() {
+        MOZ_ASSERT(users > 0);
+        users--;
+    }
+
+    size_t sizeOfIncludingThis(mozilla::MallocSizeOf mallocSizeOf) const;
+};
+
+class RegExpCodeCache
+{
+    struct Lookup {
+        JSAtom* source;
+        RegExpFlag flags;
+        bool latin1;
+        bool matchOnly;
+
+        Lookup(JSAtom* source, RegExpFlag flags, bool latin1, bool matchOnly)
+          : source(source), flags(flags), latin1(latin1), matchOnly(matchOnly)
+        {}
+    };
+
+    struct Hasher {
+        typedef Lookup Lookup;
+        static HashNumber hash(const Lookup& l) {
+            HashNumber hash = DefaultHasher<JSAtom*>::hash(l.source);
+            return mozilla::AddToHash(hash, l.flags, l.latin1, l.matchOnly);
+        }
+        static bool match(RegExpCodeCacheEntry* entry, const Lookup& l) {
+            return entry->source == l.source && entry->flags == l.flags &&
+                   entry->latin1 == l.latin1 && entry->matchOnly == l.matchOnly;
+        }
+    };
+
+    using Set = HashSet<RegExpCodeCacheEntry*, Hasher, SystemAllocPolicy>;
+    Set set_;
+
+    // All entries, least recently used first.
+    mozilla::LinkedList<RegExpCodeCacheEntry> lru_;
+
+    // Instruction bytes of the cached code.
+    size_t bytes_;
+
+    void remove(RegExpCodeCacheEntry* entry);
+
+  public:
+    static const size_t MaxBytes = 1024 * 1024;
+
+    RegExpCodeCache() : bytes_(0) {}
+    ~RegExpCodeCache();
+
+    MOZ_MUST_USE bool init() { return set_.init(); }
+
+    // Find code compiled for the source, flags, input encoding and
+    // compilation mode and register a new user of it.
+    RegExpCodeCacheEntry* lookup(JSAtom* source, RegExpFlag flags, bool latin1,
+                                 bool matchOnly);
+
+    // Evict unused entries until there is room for new code; returns false if
+    // the cache is full of code in use.
+    bool makeRoom();
+
+    // Add code compiled in the atoms zone, and register its first user.
+    RegExpCodeCacheEntry* add(JSContext* cx, JSAtom* source, RegExpFlag flags, bool latin1,
+                              bool matchOnly, size_t parenCount, jit::JitCode* code,
+                              RegExpShared::JitCodeTables&& tables);
+
+    void trace(JSTracer* trc);
+
+    size_t sizeOfIncludingThis(mozilla::MallocSizeOf mallocSizeOf) const;
+};
+
 class RegExpCompartment
 {
     /*
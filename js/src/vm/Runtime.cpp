@@ -169,6 +169,7 @@ JSRuntime::JSRuntime(JSRuntime* parentRuntime)
     staticStrings(nullptr),
     commonNames(nullptr),
     permanentAtoms(nullptr),
+    concurrentAtomCache_(nullptr),
     wellKnownSymbols(nullptr),
     jitSupportsFloatingPoint(false),
     jitSupportsUnalignedAccesses(false),
@@ -188,6 +189,7 @@ JSRuntime::JSRuntime(JSRuntime* parentRuntime)
     /* Initialize infallibly first, so we can goto bad and JS_DestroyRuntime. */
 
     PodZero(&asmJSCacheOps);
+    PodZero(&wasmCacheOps);
     lcovOutput().init();
 }
 
@@ -467,6 +469,7 @@ JSRuntime::addSizeOfIncludingThis(mozilla::MallocSizeOf mallocSizeOf, JS::Runtim
         rtSizes->contexts += mallocSizeOf(cx);
         rtSizes->contexts += cx->sizeOfExcludingThis(mallocSizeOf);
         rtSizes->temporary += cx->tempLifoAlloc().sizeOfExcludingThis(mallocSizeOf);
+        rtSizes->lifoChunkPool += cx->lifoChunkPool().sizeOfExcludingThis(mallocSizeOf);
         rtSizes->interpreterStack += cx->interpreterStack().sizeOfExcludingThis(mallocSizeOf);
 #ifdef JS_TRACE_LOGGING
         if (cx->traceLogger)
@@ -495,6 +498,9 @@ JSRuntime::addSizeOfIncludingThis(mozilla::MallocSizeOf mallocSizeOf, JS::Runtim
     for (ScriptDataTable::Range r = scriptDataTable(lock).all(); !r.empty(); r.popFront())
         rtSizes->scriptData += mallocSizeOf(r.front());
 
+    for (ZoneGroupsIter group(this); !group.done(); group.next())
+        rtSizes->regExpCodeCache += group->regExpCodeCache.ref()->sizeOfIncludingThis(mallocSizeOf);
+
     if (jitRuntime_) {
         jitRuntime_->execAlloc().addSizeOfCode(&rtSizes->code);
         jitRuntime_->backedgeExecAlloc().addSizeOfCode(&rtSizes->code);
@@ -602,6 +608,7 @@ JSContext::handleInterrupt()
         interrupt_ = false;
         interruptRegExpJit_ = false;
         resetJitStackLimit();
+        runtime()->performanceMonitoring().maybeTakeSample(this);
         return InvokeInterruptCallback(this);
     }
     return true;
@@ -714,7 +721,7 @@ JSRuntime::getIncumbentGlobal(JSContext* cx)
 }
 
 bool
-JSRuntime::enqueuePromiseJob(JSContext* cx, HandleFunction job, HandleObject promise,
+JSRuntime::enqueuePromiseJob(JSContext* cx, HandleObject job, HandleObject promise,
                              HandleObject incumbentGlobal)
 {
     MOZ_ASSERT(cx->enqueuePromiseJobCallback,
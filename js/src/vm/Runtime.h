@@ -105,6 +105,7 @@ class JitRuntime;
 class JitActivation;
 struct PcScriptCache;
 struct AutoFlushICache;
+class AutoWritableJitCodeBatch;
 class CompileRuntime;
 
 #ifdef JS_SIMULATOR_ARM64
@@ -471,7 +472,7 @@ struct JSRuntime : public js::MallocProvider<JSRuntime>
     js::ExclusiveData<js::PromiseTaskPtrVector> promiseTasksToDestroy;
 
     JSObject* getIncumbentGlobal(JSContext* cx);
-    bool enqueuePromiseJob(JSContext* cx, js::HandleFunction job, js::HandleObject promise,
+    bool enqueuePromiseJob(JSContext* cx, js::HandleObject job, js::HandleObject promise,
                            js::HandleObject incumbentGlobal);
     void addUnhandledRejectedPromise(JSContext* cx, js::HandleObject promise);
     void removeUnhandledRejectedPromise(JSContext* cx, js::HandleObject promise);
@@ -541,6 +542,9 @@ struct JSRuntime : public js::MallocProvider<JSRuntime>
     /* AsmJSCache callbacks are runtime-wide. */
     js::UnprotectedData<JS::AsmJSCacheOps> asmJSCacheOps;
 
+    /* WasmCache callbacks are runtime-wide. */
+    js::UnprotectedData<JS::WasmCacheOps> wasmCacheOps;
+
   private:
     js::UnprotectedData<const JSPrincipals*> trustedPrincipals_;
   public:
@@ -708,7 +712,8 @@ struct JSRuntime : public js::MallocProvider<JSRuntime>
         return selfHostingGlobal_;
     }
 
-    bool initSelfHosting(JSContext* cx);
+    bool initSelfHosting(JSContext* cx, const JS::TranscodeRange& xdrIn = JS::TranscodeRange(),
+                         JS::TranscodeBuffer* xdrOut = nullptr);
     void finishSelfHosting();
     void traceSelfHostingGlobal(JSTracer* trc);
     bool isSelfHostingGlobal(JSObject* global) {
@@ -913,6 +918,15 @@ struct JSRuntime : public js::MallocProvider<JSRuntime>
 
     bool transformToPermanentAtoms(JSContext* cx);
 
+    // Lock free cache in front of |atoms_| for off thread parsing. Unlike the
+    // permanent atoms, this is not shared with the parentRuntime.
+    js::WriteOnceData<js::ConcurrentAtomCache*> concurrentAtomCache_;
+
+    js::ConcurrentAtomCache& concurrentAtomCache() {
+        MOZ_ASSERT(concurrentAtomCache_);
+        return *concurrentAtomCache_;
+    }
+
     // Cached well-known symbols (ES6 rev 24 6.1.5.1). Like permanent atoms,
     // these are shared with the parentRuntime, if any.
     js::WriteOnceData<js::WellKnownSymbols*> wellKnownSymbols;
@@ -9,6 +9,9 @@
 #include "mozilla/ArrayUtils.h"
 #include "mozilla/Casting.h"
 #include "mozilla/DebugOnly.h"
+#include "mozilla/EndianUtils.h"
+#include "mozilla/FloatingPoint.h"
+#include "mozilla/HashFunctions.h"
 #include "mozilla/Maybe.h"
 
 #include "jsarray.h"
@@ -50,6 +53,7 @@
 #include "vm/StringBuffer.h"
 #include "vm/TypedArrayObject.h"
 #include "vm/WrapperObject.h"
+#include "vm/Xdr.h"
 
 #include "jsatominlines.h"
 #include "jsfuninlines.h"
@@ -940,64 +944,6 @@ intrinsic_SharedArrayBuffersMemorySame(JSContext* cx, unsigned argc, Value* vp)
     return true;
 }
 
-static bool
-intrinsic_IsSpecificTypedArray(JSContext* cx, unsigned argc, Value* vp, Scalar::Type type)
-{
-    CallArgs args = CallArgsFromVp(argc, vp);
-    MOZ_ASSERT(args.length() == 1);
-    MOZ_ASSERT(args[0].isObject());
-
-    JSObject* obj = &args[0].toObject();
-
-    bool isArray = JS_GetArrayBufferViewType(obj) == type;
-
-    args.rval().setBoolean(isArray);
-    return true;
-}
-
-static bool
-intrinsic_IsUint8TypedArray(JSContext* cx, unsigned argc, Value* vp)
-{
-    return intrinsic_IsSpecificTypedArray(cx, argc, vp, Scalar::Uint8) ||
-           intrinsic_IsSpecificTypedArray(cx, argc, vp, Scalar::Uint8Clamped);
-}
-
-static bool
-intrinsic_IsInt8TypedArray(JSContext* cx, unsigned argc, Value* vp)
-{
-    return intrinsic_IsSpecificTypedArray(cx, argc, vp, Scalar::Int8);
-}
-
-static bool
-intrinsic_IsUint16TypedArray(JSContext* cx, unsigned argc, Value* vp)
-{
-    return intrinsic_IsSpecificTypedArray(cx, argc, vp, Scalar::Uint16);
-}
-
-static bool
-intrinsic_IsInt16TypedArray(JSContext* cx, unsigned argc, Value* vp)
-{
-    return intrinsic_IsSpecificTypedArray(cx, argc, vp, Scalar::Int16);
-}
-
-static bool
-intrinsic_IsUint32TypedArray(JSContext* cx, unsigned argc, Value* vp)
-{
-    return intrinsic_IsSpecificTypedArray(cx, argc, vp, Scalar::Uint32);
-}
-
-static bool
-intrinsic_IsInt32TypedArray(JSContext* cx, unsigned argc, Value* vp)
-{
-    return intrinsic_IsSpecificTypedArray(cx, argc, vp, Scalar::Int32);
-}
-
-static bool
-intrinsic_IsFloat32TypedArray(JSContext* cx, unsigned argc, Value* vp)
-{
-    return intrinsic_IsSpecificTypedArray(cx, argc, vp, Scalar::Float32);
-}
-
 static bool
 intrinsic_IsPossiblyWrappedTypedArray(JSContext* cx, unsigned argc, Value* vp)
 {
@@ -1161,6 +1107,173 @@ intrinsic_MoveTypedArrayElements(JSContext* cx, unsigned argc, Value* vp)
     return true;
 }
 
+// The default TypedArray sort order maps onto the order of unsigned integers:
+// signed integers get their sign bit flipped, and negative floats get all
+// their bits flipped so that they sort below positive floats and -0 sorts
+// below +0.  NaNs are canonicalized to the largest key to sort last.
+template <typename T, typename Key>
+struct SignedSortKey
+{
+    static const Key SignBit = Key(1) << (sizeof(Key) * 8 - 1);
+    static Key toKey(T v) { return Key(v) ^ SignBit; }
+    static T fromKey(Key k) { return T(k ^ SignBit); }
+};
+
+template <typename T, typename Key>
+struct UnsignedSortKey
+{
+    static Key toKey(T v) { return Key(v); }
+    static T fromKey(Key k) { return T(k); }
+};
+
+template <typename T, typename Key>
+struct FloatSortKey
+{
+    static const Key SignBit = Key(1) << (sizeof(Key) * 8 - 1);
+    static Key toKey(T v) {
+        if (mozilla::IsNaN(v))
+            return Key(-1);
+        Key bits = mozilla::BitwiseCast<Key>(v);
+        Key mask = Key(0) - (bits >> (sizeof(Key) * 8 - 1));
+        return bits ^ (mask | SignBit);
+    }
+    static T fromKey(Key k) {
+        Key mask = (k & SignBit) ? SignBit : Key(-1);
+        return mozilla::BitwiseCast<T>(Key(k ^ mask));
+    }
+};
+
+// Sort |keys| with a least significant digit radix sort, one byte per pass.
+// Passes in which every key has the same digit are skipped.
+template <typename Key>
+static void
+RadixSortKeys(Key* keys, Key* scratch, size_t len)
+{
+    Key* src = keys;
+    Key* dst = scratch;
+    for (size_t shift = 0; shift < sizeof(Key) * 8; shift += 8) {
+        size_t counts[257] = {};
+        for (size_t i = 0; i < len; i++)
+            counts[((src[i] >> shift) & 0xff) + 1]++;
+
+        bool trivial = false;
+        for (size_t d = 1; d <= 256; d++) {
+            if (counts[d] == len) {
+                trivial = true;
+                break;
+            }
+        }
+        if (trivial)
+            continue;
+
+        for (size_t d = 1; d <= 256; d++)
+            counts[d] += counts[d - 1];
+        for (size_t i = 0; i < len; i++)
+            dst[counts[(src[i] >> shift) & 0xff]++] = src[i];
+
+        mozilla::Swap(src, dst);
+    }
+
+    if (src != keys)
+        mozilla::PodCopy(keys, src, len);
+}
+
+template <typename T, typename Key, typename SortKey>
+static bool
+SortTypedArrayElements(JSContext* cx, TypedArrayObject* tarray, uint32_t len)
+{
+    static_assert(sizeof(T) == sizeof(Key), "keys are sorted in place of the elements");
+
+    // Shared memory may be modified concurrently, so sort a private copy and
+    // write it back afterwards.
+    UniquePtr<Key[], JS::FreePolicy> keys(cx->pod_malloc<Key>(size_t(len) * 2));
+    if (!keys)
+        return false;
+    Key* scratch = keys.get() + len;
+
+    SharedMem<T*> data = tarray->viewDataEither().cast<T*>();
+    jit::AtomicOperations::memcpySafeWhenRacy(scratch, data.template cast<Key*>(),
+                                              len * sizeof(T));
+
+    for (uint32_t i = 0; i < len; i++)
+        keys[i] = SortKey::toKey(mozilla::BitwiseCast<T>(scratch[i]));
+
+    if (sizeof(Key) == 1) {
+        // Counting sort.
+        size_t counts[256] = {};
+        for (uint32_t i = 0; i < len; i++)
+            counts[keys[i]]++;
+        uint32_t i = 0;
+        for (size_t k = 0; k < 256; k++) {
+            for (size_t n = counts[k]; n; n--)
+                keys[i++] = Key(k);
+        }
+    } else {
+        RadixSortKeys(keys.get(), scratch, len);
+    }
+
+    for (uint32_t i = 0; i < len; i++)
+        scratch[i] = mozilla::BitwiseCast<Key>(SortKey::fromKey(keys[i]));
+
+    jit::AtomicOperations::memcpySafeWhenRacy(data.template cast<Key*>(), scratch,
+                                              len * sizeof(T));
+    return true;
+}
+
+// Sort the elements of a TypedArray in the default order of
+// %TypedArray%.prototype.sort, that is as if by TypedArrayCompare.
+static bool
+intrinsic_TypedArrayNativeSort(JSContext* cx, unsigned argc, Value* vp)
+{
+    CallArgs args = CallArgsFromVp(argc, vp);
+    MOZ_ASSERT(args.length() == 1);
+
+    Rooted<TypedArrayObject*> tarray(cx, &args[0].toObject().as<TypedArrayObject>());
+    if (tarray->hasDetachedBuffer()) {
+        JS_ReportErrorNumberASCII(cx, GetErrorMessage, nullptr, JSMSG_TYPED_ARRAY_DETACHED);
+        return false;
+    }
+
+    uint32_t len = tarray->length();
+    bool ok = true;
+    if (len > 1) {
+        switch (tarray->type()) {
+          case Scalar::Int8:
+            ok = SortTypedArrayElements<int8_t, uint8_t, SignedSortKey<int8_t, uint8_t>>(cx, tarray, len);
+            break;
+          case Scalar::Uint8:
+          case Scalar::Uint8Clamped:
+            ok = SortTypedArrayElements<uint8_t, uint8_t, UnsignedSortKey<uint8_t, uint8_t>>(cx, tarray, len);
+            break;
+          case Scalar::Int16:
+            ok = SortTypedArrayElements<int16_t, uint16_t, SignedSortKey<int16_t, uint16_t>>(cx, tarray, len);
+            break;
+          case Scalar::Uint16:
+            ok = SortTypedArrayElements<uint16_t, uint16_t, UnsignedSortKey<uint16_t, uint16_t>>(cx, tarray, len);
+            break;
+          case Scalar::Int32:
+            ok = SortTypedArrayElements<int32_t, uint32_t, SignedSortKey<int32_t, uint32_t>>(cx, tarray, len);
+            break;
+          case Scalar::Uint32:
+            ok = SortTypedArrayElements<uint32_t, uint32_t, UnsignedSortKey<uint32_t, uint32_t>>(cx, tarray, len);
+            break;
+          case Scalar::Float32:
+            ok = SortTypedArrayElements<float, uint32_t, FloatSortKey<float, uint32_t>>(cx, tarray, len);
+            break;
+          case Scalar::Float64:
+            ok = SortTypedArrayElements<double, uint64_t, FloatSortKey<double, uint64_t>>(cx, tarray, len);
+            break;
+          default:
+            MOZ_CRASH("Unexpected TypedArray type");
+        }
+    }
+    if (!ok)
+        return false;
+
+    args.rval().setObject(*tarray);
+    return true;
+}
+
 // Extract the TypedArrayObject* underlying |obj| and return it.  This method,
 // in a TOTALLY UNSAFE manner, completely violates the normal compartment
 // boundaries, returning an object not necessarily in the current compartment
@@ -2374,13 +2487,6 @@ static const JSFunctionSpec intrinsic_functions[] = {
     JS_FN("SharedArrayBuffersMemorySame",
           intrinsic_SharedArrayBuffersMemorySame,                       2,0),
 
-    JS_FN("IsUint8TypedArray",        intrinsic_IsUint8TypedArray,      1,0),
-    JS_FN("IsInt8TypedArray",         intrinsic_IsInt8TypedArray,       1,0),
-    JS_FN("IsUint16TypedArray",       intrinsic_IsUint16TypedArray,     1,0),
-    JS_FN("IsInt16TypedArray",        intrinsic_IsInt16TypedArray,      1,0),
-    JS_FN("IsUint32TypedArray",       intrinsic_IsUint32TypedArray,     1,0),
-    JS_FN("IsInt32TypedArray",        intrinsic_IsInt32TypedArray,      1,0),
-    JS_FN("IsFloat32TypedArray",      intrinsic_IsFloat32TypedArray,    1,0),
     JS_INLINABLE_FN("IsTypedArray",
                     intrinsic_IsInstanceOfBuiltin<TypedArrayObject>,    1,0,
                     IntrinsicIsTypedArray),
@@ -2399,6 +2505,7 @@ static const JSFunctionSpec intrinsic_functions[] = {
           intrinsic_PossiblyWrappedTypedArrayHasDetachedBuffer, 1, 0),
 
     JS_FN("MoveTypedArrayElements",  intrinsic_MoveTypedArrayElements,  4,0),
+    JS_FN("TypedArrayNativeSort",    intrinsic_TypedArrayNativeSort,    1,0),
     JS_FN("SetFromTypedArrayApproach",intrinsic_SetFromTypedArrayApproach, 4, 0),
     JS_FN("SetOverlappingTypedElements",intrinsic_SetOverlappingTypedElements,3,0),
 
@@ -2746,8 +2853,94 @@ VerifyGlobalNames(JSContext* cx, Handle<GlobalObject*> shg)
     return true;
 }
 
+namespace {
+
+// Decodes the self-hosted script with the options it was compiled with, so
+// that its source gets the same filename and introduction type.
+class SelfHostingXDRDecoder : public XDRDecoder
+{
+    const ReadOnlyCompileOptions& options_;
+
+  public:
+    SelfHostingXDRDecoder(JSContext* cx, const ReadOnlyCompileOptions& options,
+                          const JS::TranscodeRange& range)
+      : XDRDecoder(cx, range),
+        options_(options)
+    { }
+
+    bool hasOptions() const override { return true; }
+    const ReadOnlyCompileOptions& options() override { return options_; }
+};
+
+} /* anonymous namespace */
+
+static bool
+CompileSelfHostingScript(JSContext* cx, const ReadOnlyCompileOptions& options,
+                         MutableHandleScript script)
+{
+    uint32_t srcLen = GetRawScriptsSize();
+
+    const unsigned char* compressed = compressedSources;
+    uint32_t compressedLen = GetCompressedSize();
+    ScopedJSFreePtr<char> src(cx->zone()->pod_malloc<char>(srcLen));
+    if (!src || !DecompressString(compressed, compressedLen,
+                                  reinterpret_cast<unsigned char*>(src.get()), srcLen))
+    {
+        return false;
+    }
+
+    return JS::Compile(cx, options, src, srcLen, script);
+}
+
+// Encodings of the self-hosted code start with a hash of its sources, as
+// shell builds use a constant build id.
+static const size_t SelfHostingXDRHeaderLength = sizeof(uint32_t);
+
+static uint32_t
+SelfHostingSourcesHash()
+{
+    return mozilla::HashBytes(compressedSources, GetCompressedSize());
+}
+
+static bool
+DecodeSelfHostingScript(JSContext* cx, const ReadOnlyCompileOptions& options,
+                        const JS::TranscodeRange& xdr, MutableHandleScript script)
+{
+    if (xdr.length() <= SelfHostingXDRHeaderLength)
+        return true;
+    uint8_t* begin = xdr.begin().get();
+    if (mozilla::LittleEndian::readUint32(begin) != SelfHostingSourcesHash())
+        return true;
+
+    // An encoding from a different build, or a truncated one, is not fatal:
+    // the caller compiles from source instead.
+    JS::TranscodeRange range(begin + SelfHostingXDRHeaderLength,
+                             xdr.length() - SelfHostingXDRHeaderLength);
+    SelfHostingXDRDecoder decoder(cx, options, range);
+    if (!decoder.codeScript(script)) {
+        script.set(nullptr);
+        return decoder.resultCode() != JS::TranscodeResult_Throw;
+    }
+    return true;
+}
+
+static bool
+EncodeSelfHostingScript(JSContext* cx, HandleScript script, JS::TranscodeBuffer& xdr)
+{
+    uint8_t header[SelfHostingXDRHeaderLength];
+    mozilla::LittleEndian::writeUint32(header, SelfHostingSourcesHash());
+    if (!xdr.append(header, sizeof(header))) {
+        ReportOutOfMemory(cx);
+        return false;
+    }
+
+    // On failure, EncodeScript leaves |xdr| empty.
+    return JS::EncodeScript(cx, xdr, script) != JS::TranscodeResult_Throw;
+}
+
 bool
-JSRuntime::initSelfHosting(JSContext* cx)
+JSRuntime::initSelfHosting(JSContext* cx, const JS::TranscodeRange& xdrIn,
+                           JS::TranscodeBuffer* xdrOut)
 {
     MOZ_ASSERT(!selfHostingGlobal_);
 
@@ -2781,20 +2974,21 @@ JSRuntime::initSelfHosting(JSContext* cx)
     CompileOptions options(cx);
     FillSelfHostingCompileOptions(options);
 
-    RootedValue rv(cx);
+    RootedScript script(cx);
+    if (!DecodeSelfHostingScript(cx, options, xdrIn, &script))
+        return false;
 
-    uint32_t srcLen = GetRawScriptsSize();
+    if (!script) {
+        if (!CompileSelfHostingScript(cx, options, &script))
+            return false;
 
-    const unsigned char* compressed = compressedSources;
-    uint32_t compressedLen = GetCompressedSize();
-    ScopedJSFreePtr<char> src(selfHostingGlobal_->zone()->pod_malloc<char>(srcLen));
-    if (!src || !DecompressString(compressed, compressedLen,
-                                  reinterpret_cast<unsigned char*>(src.get()), srcLen))
-    {
-        return false;
+        // Encode before running the script, which may alter it.
+        if (xdrOut && !EncodeSelfHostingScript(cx, script, *xdrOut))
+            return false;
     }
 
-    if (!Evaluate(cx, options, src, srcLen, &rv))
+    RootedValue rv(cx);
+    if (!JS_ExecuteScript(cx, script, &rv))
         return false;
 
     if (!VerifyGlobalNames(cx, shg))
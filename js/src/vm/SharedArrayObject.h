@@ -20,8 +20,6 @@ typedef struct JSProperty JSProperty;
 
 namespace js {
 
-class FutexWaiter;
-
 /*
  * SharedArrayRawBuffer
  *
@@ -48,16 +46,11 @@ class SharedArrayRawBuffer
     uint32_t length;
     bool preparedForAsmJS;
 
-    // A list of structures representing tasks waiting on some
-    // location within this buffer.
-    FutexWaiter* waiters_;
-
   protected:
     SharedArrayRawBuffer(uint8_t* buffer, uint32_t length, bool preparedForAsmJS)
       : refcount_(1),
         length(length),
-        preparedForAsmJS(preparedForAsmJS),
-        waiters_(nullptr)
+        preparedForAsmJS(preparedForAsmJS)
     {
         MOZ_ASSERT(buffer == dataPointerShared());
     }
@@ -65,18 +58,6 @@ class SharedArrayRawBuffer
   public:
     static SharedArrayRawBuffer* New(JSContext* cx, uint32_t length);
 
-    // This may be called from multiple threads.  The caller must take
-    // care of mutual exclusion.
-    FutexWaiter* waiters() const {
-        return waiters_;
-    }
-
-    // This may be called from multiple threads.  The caller must take
-    // care of mutual exclusion.
-    void setWaiters(FutexWaiter* waiters) {
-        waiters_ = waiters;
-    }
-
     SharedMem<uint8_t*> dataPointerShared() const {
         uint8_t* ptr = reinterpret_cast<uint8_t*>(const_cast<SharedArrayRawBuffer*>(this));
         return SharedMem<uint8_t*>::shared(ptr + sizeof(SharedArrayRawBuffer));
@@ -6,10 +6,55 @@
 
 #include "vm/SharedImmutableStringsCache-inl.h"
 
+#include "mozilla/Atomics.h"
+
+#include "jsfriendapi.h"
 #include "jsstr.h"
 
 namespace js {
 
+static mozilla::Atomic<SharedStringStore*> sharedStringStore;
+
+JS_FRIEND_API(void)
+SetSharedStringStore(SharedStringStore* store)
+{
+    sharedStringStore = store;
+}
+
+void
+SharedImmutableStringsCache::StringBox::maybeMoveToStore()
+{
+    MOZ_ASSERT(chars_ && !store_);
+
+    if (length_ < SharedStringStoreMinLength)
+        return;
+
+    SharedStringStore* store = sharedStringStore;
+    if (!store)
+        return;
+
+    const char* storeChars = store->acquire(chars_.get(), length_);
+    if (!storeChars)
+        return;
+
+    store_ = store;
+    storeChars_ = storeChars;
+    chars_.reset(nullptr);
+}
+
+void
+SharedImmutableStringsCache::StringBox::clear()
+{
+    MOZ_ASSERT(refcount == 0);
+
+    if (store_) {
+        store_->release(storeChars_, length_);
+        storeChars_ = nullptr;
+    } else {
+        chars_.reset(nullptr);
+    }
+}
+
 SharedImmutableString::SharedImmutableString(
     ExclusiveData<SharedImmutableStringsCache::Inner>::Guard& locked,
     SharedImmutableStringsCache::StringBox* box)
@@ -74,7 +119,7 @@ SharedImmutableString::~SharedImmutableString() {
 
     box_->refcount--;
     if (box_->refcount == 0)
-        box_->chars_.reset(nullptr);
+        box_->clear();
 }
 
 SharedImmutableString
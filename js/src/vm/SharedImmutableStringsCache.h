@@ -26,6 +26,7 @@ namespace js {
 
 class SharedImmutableString;
 class SharedImmutableTwoByteString;
+class SharedStringStore;
 
 /**
  * The `SharedImmutableStringsCache` allows for safely sharing and deduplicating
@@ -144,10 +145,11 @@ class SharedImmutableStringsCache
         // Size of the table.
         n += locked->set.sizeOfExcludingThis(mallocSizeOf);
 
-        // Sizes of the strings and their boxes.
+        // Sizes of the strings and their boxes. Strings held by the
+        // SharedStringStore are the embedding's to report.
         for (auto r = locked->set.all(); !r.empty(); r.popFront()) {
             n += mallocSizeOf(r.front().get());
-            if (const char* chars = r.front()->chars())
+            if (const char* chars = r.front()->heapChars())
                 n += mallocSizeOf(chars);
         }
 
@@ -236,6 +238,13 @@ class SharedImmutableStringsCache
         OwnedChars chars_;
         size_t length_;
 
+        // If non-null, the chars are held by this store instead of chars_.
+        SharedStringStore* store_;
+        const char* storeChars_;
+
+        // Hand large strings over to the SharedStringStore, if there is one.
+        void maybeMoveToStore();
+
       public:
         mutable size_t refcount;
 
@@ -244,13 +253,18 @@ class SharedImmutableStringsCache
         StringBox(OwnedChars&& chars, size_t length)
           : chars_(mozilla::Move(chars))
           , length_(length)
+          , store_(nullptr)
+          , storeChars_(nullptr)
           , refcount(0)
         {
             MOZ_ASSERT(chars_);
         }
 
         static Ptr Create(OwnedChars&& chars, size_t length) {
-            return Ptr(js_new<StringBox>(mozilla::Move(chars), length));
+            Ptr box(js_new<StringBox>(mozilla::Move(chars), length));
+            if (box)
+                box->maybeMoveToStore();
+            return box;
         }
 
         StringBox(const StringBox&) = delete;
@@ -263,8 +277,12 @@ class SharedImmutableStringsCache
                                "`~SharedImmutableString` destructor!");
         }
 
-        const char* chars() const { return chars_.get(); }
+        const char* chars() const { return store_ ? storeChars_ : chars_.get(); }
+        const char* heapChars() const { return chars_.get(); }
         size_t length() const { return length_; }
+
+        // Free the chars once the last reference is gone.
+        void clear();
     };
 
     struct Hasher
@@ -8,6 +8,7 @@
 
 #include "mozilla/ArrayUtils.h"
 #include "mozilla/IntegerTypeTraits.h"
+#include "mozilla/TimeStamp.h"
 #include "mozilla/Unused.h"
 
 #if defined(XP_WIN)
@@ -18,6 +19,7 @@
 #include "jswin.h"
 
 #include "gc/Zone.h"
+#include "threading/LockGuard.h"
 #include "vm/Runtime.h"
 
 
@@ -33,6 +35,11 @@ PerformanceMonitoring::addRecentGroup(PerformanceGroup* group)
     return recentGroups_.append(group);
 }
 
+PerformanceMonitoring::~PerformanceMonitoring()
+{
+    stopSampler();
+}
+
 void
 PerformanceMonitoring::reset()
 {
@@ -49,6 +56,10 @@ PerformanceMonitoring::reset()
     // valid sets of measures just because we are on a CPU that has a
     // lower RDTSC.
     highestTimestampCounter_ = 0;
+
+    // A sample requested between two events would be charged to the
+    // first compartment of the next event.
+    sampleRequested_ = false;
 }
 
 void
@@ -142,7 +153,8 @@ PerformanceMonitoring::commit()
 
 #if !defined(MOZ_HAVE_RDTSC)
     // The AutoStopwatch is only executed if `MOZ_HAVE_RDTSC`.
-    return false;
+    if (!isSampling())
+        return false;
 #endif // !defined(MOZ_HAVE_RDTSC)
 
     if (!isMonitoringJank_) {
@@ -192,9 +204,120 @@ PerformanceMonitoring::monotonicReadTimestampCounter()
 #endif // defined(MOZ_HAVE_RDTSC)
 }
 
+bool
+PerformanceMonitoring::setSamplingInterval(JSContext* cx, uint32_t intervalMs)
+{
+    if (intervalMs == samplingIntervalMs_)
+        return true;
+
+    reset();
+
+    if (!intervalMs) {
+        stopSampler();
+        return true;
+    }
+
+    {
+        LockGuard<Mutex> guard(samplerLock_);
+        samplingIntervalMs_ = intervalMs;
+        samplerContext_ = cx;
+        if (sampler_) {
+            samplerWakeup_.notify_all();
+            return true;
+        }
+    }
+
+    sampler_.emplace();
+    if (!sampler_->init(SamplerMain, this)) {
+        sampler_.reset();
+        LockGuard<Mutex> guard(samplerLock_);
+        samplingIntervalMs_ = 0;
+        return false;
+    }
+    return true;
+}
+
+void
+PerformanceMonitoring::stopSampler()
+{
+    if (!sampler_)
+        return;
+
+    {
+        LockGuard<Mutex> guard(samplerLock_);
+        samplerTerminate_ = true;
+        samplerWakeup_.notify_all();
+    }
+    sampler_->join();
+    sampler_.reset();
+
+    samplerTerminate_ = false;
+    samplingIntervalMs_ = 0;
+    samplerContext_ = nullptr;
+    sampleRequested_ = false;
+}
+
+/* static */ void
+PerformanceMonitoring::SamplerMain(void* arg)
+{
+    ThisThread::SetName("JS Perf Sampler");
+    static_cast<PerformanceMonitoring*>(arg)->samplerLoop();
+}
+
+void
+PerformanceMonitoring::samplerLoop()
+{
+    UniqueLock<Mutex> guard(samplerLock_);
+    while (!samplerTerminate_) {
+        samplerWakeup_.wait_for(guard, mozilla::TimeDuration::FromMilliseconds(samplingIntervalMs_));
+        if (samplerTerminate_)
+            break;
+
+        // Requesting an interrupt is cheap for the JS thread: it is
+        // only noticed at the next interrupt check, which JIT code
+        // folds into its stack limit check.
+        sampleRequested_ = true;
+        samplerContext_->requestInterrupt(JSContext::RequestInterruptCanWait);
+    }
+}
+
+void
+PerformanceMonitoring::takeSample(JSContext* cx)
+{
+    sampleRequested_ = false;
+
+    if (!isMonitoringJank_ || !isSampling())
+        return;
+
+    JSCompartment* compartment = cx->compartment();
+    if (!compartment || compartment->isAtomsCompartment() || compartment->scheduledForDestruction)
+        return;
+
+    const PerformanceGroupVector* groups = compartment->performanceMonitoring.getGroups(cx);
+    if (!groups)
+        return;
+
+    start();
+
+    // Only the proportion of the cycles of each group to the cycles of
+    // the top group matters, so weigh every sample by the interval.
+    const uint64_t cycles = uint64_t(samplingIntervalMs_) * 1000;
+    for (auto group = groups->begin(); group < groups->end(); group++) {
+        if (!(*group)->isActive())
+            continue;
+
+        // Sample first: it clears stale data, including the flag
+        // checked by `addRecentGroup`.
+        (*group)->addRecentSample(iteration_, cycles);
+        if (!addRecentGroup(*group))
+            return; // Out of memory, we will miss this sample.
+    }
+}
+
 void
 PerformanceMonitoring::dispose(JSRuntime* rt)
 {
+    stopSampler();
     reset();
     for (CompartmentsIter c(rt, SkipAtoms); !c.done(); c.next()) {
         c->performanceMonitoring.unlink();
@@ -244,6 +367,14 @@ AutoStopwatch::AutoStopwatch(JSContext* cx MOZ_GUARD_OBJECT_NOTIFIER_PARAM_IN_IM
         return;
 
     JSRuntime* runtime = cx_->runtime();
+
+    // When sampling, stopwatches are only needed to measure CPOW.
+    if (runtime->performanceMonitoring().isSampling() &&
+        !runtime->performanceMonitoring().isMonitoringCPOW())
+    {
+        return;
+    }
+
     iteration_ = runtime->performanceMonitoring().iteration();
 
     const PerformanceGroupVector* groups = compartment->performanceMonitoring.getGroups(cx);
@@ -305,7 +436,9 @@ AutoStopwatch::enter()
         isMonitoringCPOW_ = true;
     }
 
-    if (runtime->performanceMonitoring().isMonitoringJank()) {
+    if (runtime->performanceMonitoring().isMonitoringJank() &&
+        !runtime->performanceMonitoring().isSampling())
+    {
         cyclesStart_ = this->getCycles(runtime);
         cpuStart_ = this->getCPU();
         isMonitoringJank_ = true;
@@ -500,6 +633,17 @@ PerformanceGroup::release(uint64_t it, const AutoStopwatch* owner)
     owner_ = nullptr;
 }
 
+void
+PerformanceGroup::addRecentSample(uint64_t iteration, uint64_t cycles)
+{
+    if (iteration_ != iteration) {
+        resetRecentData();
+        iteration_ = iteration;
+    }
+    recentTicks_ += 1;
+    recentCycles_ += cycles;
+}
+
 void
 PerformanceGroup::resetRecentData()
 {
@@ -642,6 +786,17 @@ GetStopwatchIsMonitoringJank(JSContext* cx)
     return cx->runtime()->performanceMonitoring().isMonitoringJank();
 }
 
+JS_PUBLIC_API(bool)
+SetStopwatchSamplingInterval(JSContext* cx, uint32_t intervalMs)
+{
+    return cx->runtime()->performanceMonitoring().setSamplingInterval(cx, intervalMs);
+}
+JS_PUBLIC_API(uint32_t)
+GetStopwatchSamplingInterval(JSContext* cx)
+{
+    return cx->runtime()->performanceMonitoring().samplingInterval();
+}
+
 JS_PUBLIC_API(bool)
 SetStopwatchIsMonitoringCPOW(JSContext* cx, bool value)
 {
@@ -7,11 +7,17 @@
 #ifndef vm_Stopwatch_h
 #define vm_Stopwatch_h
 
+#include "mozilla/Atomics.h"
+#include "mozilla/Maybe.h"
 #include "mozilla/RefPtr.h"
 #include "mozilla/Vector.h"
 
 #include "jsapi.h"
 
+#include "threading/ConditionVariable.h"
+#include "threading/Thread.h"
+#include "vm/MutexIDs.h"
+
 /*
   An API for following in real-time the amount of CPU spent executing
   webpages, add-ons, etc.
@@ -84,7 +90,13 @@ struct PerformanceMonitoring {
       , iteration_(0)
       , startedAtIteration_(0)
       , highestTimestampCounter_(0)
+      , samplingIntervalMs_(0)
+      , sampleRequested_(false)
+      , samplerContext_(nullptr)
+      , samplerTerminate_(false)
+      , samplerLock_(js::mutexid::PerfMonitoringSampler)
     { }
+    ~PerformanceMonitoring();
 
     /**
      * Reset the stopwatch.
@@ -168,6 +180,37 @@ struct PerformanceMonitoring {
         return isMonitoringCPOW_;
     }
 
+    /**
+     * Measure jank by sampling instead of reading the timestamp
+     * counter at each compartment transition.
+     *
+     * Every `intervalMs` milliseconds, a background thread requests
+     * an interrupt of `cx`. When handling it, the thread charges one
+     * sample to the groups of the compartment it is running in. A
+     * sample requested while no event is being processed is dropped
+     * by `reset()`. An `intervalMs` of 0 goes back to the stopwatch.
+     *
+     * Any pending measurements are dropped.
+     *
+     * May return `false` if the sampling thread cannot be started.
+     */
+    bool setSamplingInterval(JSContext* cx, uint32_t intervalMs);
+    uint32_t samplingInterval() const {
+        return samplingIntervalMs_;
+    }
+    bool isSampling() const {
+        return samplingIntervalMs_ != 0;
+    }
+
+    /**
+     * Called when `cx` handles an interrupt, to take the sample
+     * requested by the sampling thread, if any.
+     */
+    void maybeTakeSample(JSContext* cx) {
+        if (MOZ_UNLIKELY(sampleRequested_))
+            takeSample(cx);
+    }
+
     /**
      * Callbacks called when we start executing an event/when we have
      * run to completion (including enqueued microtasks).
@@ -248,6 +291,12 @@ struct PerformanceMonitoring {
     PerformanceMonitoring(const PerformanceMonitoring&) = delete;
     PerformanceMonitoring& operator=(const PerformanceMonitoring&) = delete;
 
+  private:
+    void takeSample(JSContext* cx);
+    void stopSampler();
+    static void SamplerMain(void* arg);
+    void samplerLoop();
+
   private:
     friend struct PerformanceGroupHolder;
     js::StopwatchStartCallback stopwatchStartCallback;
@@ -297,6 +346,28 @@ struct PerformanceMonitoring {
      * during this iteration.
      */
     uint64_t highestTimestampCounter_;
+
+    /**
+     * The sampling interval, in milliseconds, or 0 if jank is measured
+     * with stopwatches. Only written with `samplerLock_` held.
+     */
+    uint32_t samplingIntervalMs_;
+
+    /**
+     * Set by the sampling thread, cleared by the thread taking the
+     * sample.
+     */
+    mozilla::Atomic<bool, mozilla::ReleaseAcquire> sampleRequested_;
+
+    /**
+     * The sampling thread and its state. `samplerContext_` is the
+     * context interrupted by the thread.
+     */
+    JSContext* samplerContext_;
+    mozilla::Maybe<js::Thread> sampler_;
+    bool samplerTerminate_;
+    js::Mutex samplerLock_;
+    js::ConditionVariable samplerWakeup_;
 };
 
 // Temporary disable untested code path.
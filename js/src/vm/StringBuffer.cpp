@@ -65,7 +65,9 @@ StringBuffer::inflateChars()
     if (!twoByte.reserve(capacity))
         return false;
 
-    twoByte.infallibleAppend(latin1Chars().begin(), latin1Chars().length());
+    size_t len = latin1Chars().length();
+    twoByte.infallibleGrowByUninitialized(len);
+    CopyAndInflateChars(twoByte.begin(), latin1Chars().begin(), len);
 
     cb.destroy();
     cb.construct<TwoByteCharBuffer>(Move(twoByte));
@@ -11,6 +11,7 @@
 #include "mozilla/MaybeOneOf.h"
 
 #include "jscntxt.h"
+#include "jsstr.h"
 
 #include "js/Vector.h"
 
@@ -142,7 +143,15 @@ class StringBuffer
     }
 
     MOZ_MUST_USE bool append(const Latin1Char* begin, const Latin1Char* end) {
-        return isLatin1() ? latin1Chars().append(begin, end) : twoByteChars().append(begin, end);
+        if (isLatin1())
+            return latin1Chars().append(begin, end);
+
+        size_t len = end - begin;
+        TwoByteCharBuffer& buf = twoByteChars();
+        if (!buf.growByUninitialized(len))
+            return false;
+        CopyAndInflateChars(buf.end() - len, begin, len);
+        return true;
     }
     MOZ_MUST_USE bool append(const Latin1Char* chars, size_t len) {
         return append(chars, chars + len);
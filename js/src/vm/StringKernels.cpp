@@ -0,0 +1,177 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+ * vim: set ts=8 sts=4 et sw=4 tw=99:
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "vm/StringKernels.h"
+
+#include "mozilla/Attributes.h"
+#include "mozilla/MathAlgorithms.h"
+
+#if defined(JS_STRING_KERNELS_SSE2)
+# include <emmintrin.h>
+#elif defined(JS_STRING_KERNELS_NEON)
+# include <arm_neon.h>
+#endif
+
+using namespace js;
+
+using JS::Latin1Char;
+using mozilla::CountTrailingZeroes32;
+
+#if defined(JS_STRING_KERNELS_SSE2)
+
+static MOZ_ALWAYS_INLINE __m128i
+Load(const void* p)
+{
+    return _mm_loadu_si128(static_cast<const __m128i*>(p));
+}
+
+static MOZ_ALWAYS_INLINE void
+Store(void* p, __m128i v)
+{
+    _mm_storeu_si128(static_cast<__m128i*>(p), v);
+}
+
+#endif
+
+void
+js::VectorInflateChars(char16_t* dst, const Latin1Char* src, size_t len)
+{
+    size_t i = 0;
+
+#if defined(JS_STRING_KERNELS_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= len; i += 16) {
+        __m128i chars = Load(src + i);
+        Store(dst + i, _mm_unpacklo_epi8(chars, zero));
+        Store(dst + i + 8, _mm_unpackhi_epi8(chars, zero));
+    }
+#elif defined(JS_STRING_KERNELS_NEON)
+    for (; i + 16 <= len; i += 16) {
+        uint8x16_t chars = vld1q_u8(src + i);
+        vst1q_u16(reinterpret_cast<uint16_t*>(dst + i), vmovl_u8(vget_low_u8(chars)));
+        vst1q_u16(reinterpret_cast<uint16_t*>(dst + i + 8), vmovl_u8(vget_high_u8(chars)));
+    }
+#endif
+
+    for (; i < len; i++)
+        dst[i] = src[i];
+}
+
+size_t
+js::VectorMismatch(const Latin1Char* s1, const Latin1Char* s2, size_t len)
+{
+    size_t i = 0;
+
+#if defined(JS_STRING_KERNELS_SSE2)
+    for (; i + 16 <= len; i += 16) {
+        uint32_t mask = _mm_movemask_epi8(_mm_cmpeq_epi8(Load(s1 + i), Load(s2 + i)));
+        if (mask != 0xffff)
+            return i + CountTrailingZeroes32(~mask & 0xffff);
+    }
+#elif defined(JS_STRING_KERNELS_NEON)
+    for (; i + 16 <= len; i += 16) {
+        if (vminvq_u8(vceqq_u8(vld1q_u8(s1 + i), vld1q_u8(s2 + i))) != 0xff)
+            break;
+    }
+#endif
+
+    for (; i < len; i++) {
+        if (s1[i] != s2[i])
+            return i;
+    }
+    return len;
+}
+
+size_t
+js::VectorMismatch(const char16_t* s1, const char16_t* s2, size_t len)
+{
+    size_t i = 0;
+
+#if defined(JS_STRING_KERNELS_SSE2)
+    // Each character sets two bits in the mask.
+    for (; i + 8 <= len; i += 8) {
+        uint32_t mask = _mm_movemask_epi8(_mm_cmpeq_epi16(Load(s1 + i), Load(s2 + i)));
+        if (mask != 0xffff)
+            return i + CountTrailingZeroes32(~mask & 0xffff) / 2;
+    }
+#elif defined(JS_STRING_KERNELS_NEON)
+    for (; i + 8 <= len; i += 8) {
+        uint16x8_t chars1 = vld1q_u16(reinterpret_cast<const uint16_t*>(s1 + i));
+        uint16x8_t chars2 = vld1q_u16(reinterpret_cast<const uint16_t*>(s2 + i));
+        if (vminvq_u16(vceqq_u16(chars1, chars2)) != 0xffff)
+            break;
+    }
+#endif
+
+    for (; i < len; i++) {
+        if (s1[i] != s2[i])
+            return i;
+    }
+    return len;
+}
+
+size_t
+js::VectorMismatch(const Latin1Char* s1, const char16_t* s2, size_t len)
+{
+    size_t i = 0;
+
+#if defined(JS_STRING_KERNELS_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= len; i += 16) {
+        __m128i chars1 = Load(s1 + i);
+        __m128i eqLow = _mm_cmpeq_epi16(_mm_unpacklo_epi8(chars1, zero), Load(s2 + i));
+        __m128i eqHigh = _mm_cmpeq_epi16(_mm_unpackhi_epi8(chars1, zero), Load(s2 + i + 8));
+
+        // Narrow the 16-bit results to one bit per character.
+        uint32_t mask = _mm_movemask_epi8(_mm_packs_epi16(eqLow, eqHigh));
+        if (mask != 0xffff)
+            return i + CountTrailingZeroes32(~mask & 0xffff);
+    }
+#elif defined(JS_STRING_KERNELS_NEON)
+    for (; i + 16 <= len; i += 16) {
+        uint8x16_t chars1 = vld1q_u8(s1 + i);
+        const uint16_t* chars2 = reinterpret_cast<const uint16_t*>(s2 + i);
+        uint16x8_t eqLow = vceqq_u16(vmovl_u8(vget_low_u8(chars1)), vld1q_u16(chars2));
+        uint16x8_t eqHigh = vceqq_u16(vmovl_u8(vget_high_u8(chars1)), vld1q_u16(chars2 + 8));
+        if (vminvq_u16(vandq_u16(eqLow, eqHigh)) != 0xffff)
+            break;
+    }
+#endif
+
+    for (; i < len; i++) {
+        if (s1[i] != s2[i])
+            return i;
+    }
+    return len;
+}
+
+const char16_t*
+js::VectorFindChar(const char16_t* s, size_t len, char16_t c)
+{
+    size_t i = 0;
+
+#if defined(JS_STRING_KERNELS_SSE2)
+    const __m128i pattern = _mm_set1_epi16(int16_t(c));
+    for (; i + 8 <= len; i += 8) {
+        uint32_t mask = _mm_movemask_epi8(_mm_cmpeq_epi16(Load(s + i), pattern));
+        if (mask)
+            return s + i + CountTrailingZeroes32(mask) / 2;
+    }
+#elif defined(JS_STRING_KERNELS_NEON)
+    const uint16x8_t pattern = vdupq_n_u16(c);
+    for (; i + 8 <= len; i += 8) {
+        uint16x8_t chars = vld1q_u16(reinterpret_cast<const uint16_t*>(s + i));
+        if (vmaxvq_u16(vceqq_u16(chars, pattern)))
+            break;
+    }
+#endif
+
+    for (; i < len; i++) {
+        if (s[i] == c)
+            return s + i;
+    }
+    return nullptr;
+}
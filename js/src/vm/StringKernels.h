@@ -0,0 +1,68 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+ * vim: set ts=8 sts=4 et sw=4 tw=99:
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef vm_StringKernels_h
+#define vm_StringKernels_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "js/TypeDecls.h"
+
+/*
+ * Vectorized loops over the characters of strings, used by the string
+ * comparison, search and inflation functions in jsstr.h for inputs of at
+ * least VectorCharsMinLength characters.
+ *
+ * The instruction set is chosen at compile time: SSE2 is part of the x64 ABI
+ * and required for x86 builds with -msse2, and NEON is always available on
+ * AArch64. On other targets the kernels are plain loops and
+ * VectorCharsMinLength is SIZE_MAX so the callers never use them.
+ */
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+# define JS_STRING_KERNELS_SSE2 1
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+# define JS_STRING_KERNELS_NEON 1
+#endif
+
+namespace js {
+
+#if defined(JS_STRING_KERNELS_SSE2) || defined(JS_STRING_KERNELS_NEON)
+static const size_t VectorCharsMinLength = 16;
+#else
+static const size_t VectorCharsMinLength = SIZE_MAX;
+#endif
+
+// Widen |len| Latin1 characters from |src| to |dst|.
+extern void
+VectorInflateChars(char16_t* dst, const JS::Latin1Char* src, size_t len);
+
+// Return the index of the first character that differs between |s1| and |s2|,
+// or |len| if they are equal.
+extern size_t
+VectorMismatch(const JS::Latin1Char* s1, const JS::Latin1Char* s2, size_t len);
+
+extern size_t
+VectorMismatch(const char16_t* s1, const char16_t* s2, size_t len);
+
+extern size_t
+VectorMismatch(const JS::Latin1Char* s1, const char16_t* s2, size_t len);
+
+inline size_t
+VectorMismatch(const char16_t* s1, const JS::Latin1Char* s2, size_t len)
+{
+    return VectorMismatch(s2, s1, len);
+}
+
+// Return a pointer to the first occurrence of |c| in the |len| characters at
+// |s|, or nullptr.
+extern const char16_t*
+VectorFindChar(const char16_t* s, size_t len, char16_t c);
+
+} /* namespace js */
+
+#endif /* vm_StringKernels_h */
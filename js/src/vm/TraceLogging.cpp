@@ -10,6 +10,7 @@
 #include "mozilla/MemoryReporting.h"
 #include "mozilla/ScopeExit.h"
 
+#include <stdlib.h>
 #include <string.h>
 
 #include "jsapi.h"
@@ -22,6 +23,7 @@
 #include "vm/Runtime.h"
 #include "vm/Time.h"
 #include "vm/TraceLoggingGraph.h"
+#include "vm/TraceLoggingStream.h"
 
 #include "jit/JitFrames-inl.h"
 
@@ -119,6 +121,13 @@ js::DestroyTraceLoggerThreadState()
     }
 }
 
+uint64_t
+js::TraceLoggerTimestamp()
+{
+    MOZ_ASSERT(traceLoggerState);
+    return rdtsc() - traceLoggerState->startupTime;
+}
+
 #ifdef DEBUG
 bool
 js::CurrentThreadOwnsTraceLoggerThreadStateLock()
@@ -179,8 +188,33 @@ TraceLoggerThread::initGraph()
     }
 }
 
+void
+TraceLoggerThread::initStream(TraceLoggerStreamState* state)
+{
+    MOZ_ASSERT(!CurrentThreadOwnsTraceLoggerThreadStateLock());
+
+    // Without a stream the events are kept in memory as usual.
+    stream = state->createStream();
+    if (stream)
+        streamState = state;
+}
+
+void
+TraceLoggerThread::finishStream()
+{
+    MOZ_ASSERT(!CurrentThreadOwnsTraceLoggerThreadStateLock());
+
+    if (stream) {
+        streamState->destroyStream(stream);
+        stream = nullptr;
+        streamState = nullptr;
+    }
+}
+
 TraceLoggerThread::~TraceLoggerThread()
 {
+    MOZ_ASSERT(!stream);
+
     if (graph.get()) {
         if (!failed)
             graph->log(events);
@@ -231,6 +265,7 @@ TraceLoggerThread::sizeOfExcludingThis(mozilla::MallocSizeOf mallocSizeOf) const
     size += graphStack.sizeOfExcludingThis(mallocSizeOf);
 #endif
     size += events.sizeOfExcludingThis(mallocSizeOf);
+    // Streams are counted by the TraceLoggerStreamState.
     if (graph.get())
         size += graph->sizeOfIncludingThis(mallocSizeOf);
     return size;
@@ -341,11 +376,15 @@ TraceLoggerThreadState::maybeEventText(uint32_t id)
 size_t
 TraceLoggerThreadState::sizeOfExcludingThis(mozilla::MallocSizeOf mallocSizeOf)
 {
+    // The stream state lock is ordered before ours.
+    size_t size = 0;
+    if (streamState)
+        size += streamState->sizeOfIncludingThis(mallocSizeOf);
+
     LockGuard<Mutex> guard(lock);
 
     // Do not count threadLoggers since they are counted by JSContext::traceLogger.
 
-    size_t size = 0;
     size += pointerMap.sizeOfExcludingThis(mallocSizeOf);
     if (textIdPayloads.initialized()) {
         size += textIdPayloads.sizeOfExcludingThis(mallocSizeOf);
@@ -641,6 +680,44 @@ TraceLoggerThread::logTimestamp(uint32_t id)
     log(id);
 }
 
+bool
+TraceLoggerThread::sampleEvent(uint32_t id, uint32_t rate)
+{
+    static const uint32_t MaxSampleDepth = 64;
+
+    if (id == TraceLogger_Stop) {
+        if (sampleDepth == 0)
+            return true;
+        sampleDepth--;
+        if (sampleDepth >= MaxSampleDepth)
+            return true;
+        return !(sampleSkippedMask & (uint64_t(1) << sampleDepth));
+    }
+
+    if (id == TraceLogger_Enable || id == TraceLogger_Disable) {
+        sampleDepth = 0;
+        sampleSkippedMask = 0;
+        return true;
+    }
+
+    uint32_t counter = id < TraceLogger_Last ? id : TraceLogger_Last;
+    bool record = id == TraceLogger_Error || sampleCounters[counter]++ % rate == 0;
+
+    if (TLTextIdIsTreeEvent(id) || id == TraceLogger_Error) {
+        if (sampleDepth >= MaxSampleDepth) {
+            // Too deep to remember, so always log the start and stop.
+            record = true;
+        } else if (record) {
+            sampleSkippedMask &= ~(uint64_t(1) << sampleDepth);
+        } else {
+            sampleSkippedMask |= uint64_t(1) << sampleDepth;
+        }
+        sampleDepth++;
+    }
+
+    return record;
+}
+
 void
 TraceLoggerThread::log(uint32_t id)
 {
@@ -654,6 +731,15 @@ TraceLoggerThread::log(uint32_t id)
 
     MOZ_ASSERT(traceLoggerState);
 
+    uint32_t rate = traceLoggerState->sampleRate();
+    if (rate > 1 && !sampleEvent(id, rate))
+        return;
+
+    if (stream) {
+        stream->push(rdtsc() - traceLoggerState->startupTime, id);
+        return;
+    }
+
     // We request for 3 items to add, since if we don't have enough room
     // we record the time it took to make more space. To log this information
     // we need 2 extra free entries.
@@ -695,11 +781,16 @@ TraceLoggerThread::log(uint32_t id)
 
 TraceLoggerThreadState::~TraceLoggerThreadState()
 {
-    while (TraceLoggerThread* logger = threadLoggers.popFirst())
+    while (TraceLoggerThread* logger = threadLoggers.popFirst()) {
+        logger->finishStream();
         js_delete(logger);
+    }
 
     threadLoggers.clear();
 
+    // Stop the flush thread before the payloads it reads are freed.
+    streamState = nullptr;
+
     if (textIdPayloads.initialized()) {
         for (TextIdHashMap::Range r = textIdPayloads.all(); !r.empty(); r.popFront())
             js_delete(r.front().value());
@@ -753,6 +844,7 @@ TraceLoggerThreadState::init()
             "                 AlignmentMaskAnalysis, EliminateDeadCode, ReorderInstructions, \n"
             "                 EdgeCaseAnalysis, EliminateRedundantChecks, \n"
             "                 AddKeepAliveInstructions, GenerateLIR, RegisterAllocation, \n"
+            "                 BacktrackingAllocation, LinearScanAllocation, StupidAllocation, \n"
             "                 GenerateCode, Scripts, IonBuilderRestartLoop\n"
             "\n"
             "  VMSpecific     Output the specific name of the VM call\n"
@@ -835,6 +927,9 @@ TraceLoggerThreadState::init()
         enabledTextIds[TraceLogger_AddKeepAliveInstructions] = true;
         enabledTextIds[TraceLogger_GenerateLIR] = true;
         enabledTextIds[TraceLogger_RegisterAllocation] = true;
+        enabledTextIds[TraceLogger_BacktrackingAllocation] = true;
+        enabledTextIds[TraceLogger_LinearScanAllocation] = true;
+        enabledTextIds[TraceLogger_StupidAllocation] = true;
         enabledTextIds[TraceLogger_GenerateCode] = true;
         enabledTextIds[TraceLogger_Scripts] = true;
         enabledTextIds[TraceLogger_IonBuilderRestartLoop] = true;
@@ -855,6 +950,9 @@ TraceLoggerThreadState::init()
 
     enabledTextIds[TraceLogger_Error] = true;
 
+    uint32_t streamBufferSize = 64 * 1024;
+    uint32_t streamFlushIntervalMs = 100;
+
     const char* options = getenv("TLOPTIONS");
     if (options) {
         if (strstr(options, "help")) {
@@ -866,6 +964,15 @@ TraceLoggerThreadState::init()
                 "  EnableActiveThread      Start logging cooperating threads immediately.\n"
                 "  EnableOffThread         Start logging helper threads immediately.\n"
                 "  EnableGraph             Enable spewing the tracelogging graph to a file.\n"
+                "  EnableStream            Stream events to a compact binary file per thread\n"
+                "                          through a fixed size buffer, instead of keeping\n"
+                "                          them in memory. Overrides EnableGraph.\n"
+                "  StreamBufferSize=N      Number of events buffered per thread when\n"
+                "                          streaming (default 65536). Events logged while the\n"
+                "                          buffer is full are dropped and counted.\n"
+                "  StreamFlushInterval=N   Milliseconds between flushes of the stream buffers\n"
+                "                          (default 100).\n"
+                "  SampleRate=N            Only log every Nth event of each kind.\n"
                 "  Errors                  Report errors during tracing to stderr.\n"
             );
             printf("\n");
@@ -879,8 +986,25 @@ TraceLoggerThreadState::init()
             helperThreadEnabled = true;
         if (strstr(options, "EnableGraph"))
             graphSpewingEnabled = true;
+        if (strstr(options, "EnableStream"))
+            streamingEnabled = true;
         if (strstr(options, "Errors"))
             spewErrors = true;
+        if (const char* rate = strstr(options, "SampleRate=")) {
+            int n = atoi(rate + strlen("SampleRate="));
+            if (n > 1)
+                sampleRate_ = uint32_t(n);
+        }
+        if (const char* size = strstr(options, "StreamBufferSize=")) {
+            int n = atoi(size + strlen("StreamBufferSize="));
+            if (n > 0)
+                streamBufferSize = uint32_t(n);
+        }
+        if (const char* interval = strstr(options, "StreamFlushInterval=")) {
+            int n = atoi(interval + strlen("StreamFlushInterval="));
+            if (n > 0)
+                streamFlushIntervalMs = uint32_t(n);
+        }
     }
 
     if (!pointerMap.init())
@@ -890,6 +1014,15 @@ TraceLoggerThreadState::init()
 
     startupTime = rdtsc();
 
+    if (streamingEnabled) {
+        streamState.reset(js_new<TraceLoggerStreamState>());
+        if (!streamState ||
+            !streamState->init(this, streamBufferSize, streamFlushIntervalMs))
+        {
+            return false;
+        }
+    }
+
 #ifdef DEBUG
     initialized = true;
 #endif
@@ -962,8 +1095,6 @@ TraceLoggerThreadState::forCurrentThread(JSContext* maybecx)
         return nullptr;
 
     if (!cx->traceLogger) {
-        LockGuard<Mutex> guard(lock);
-
         TraceLoggerThread* logger = js_new<TraceLoggerThread>();
         if (!logger)
             return nullptr;
@@ -973,10 +1104,16 @@ TraceLoggerThreadState::forCurrentThread(JSContext* maybecx)
             return nullptr;
         }
 
+        // The stream state lock is ordered before ours.
+        if (streamState)
+            logger->initStream(streamState.get());
+
+        LockGuard<Mutex> guard(lock);
+
         threadLoggers.insertFront(logger);
         cx->traceLogger = logger;
 
-        if (graphSpewingEnabled)
+        if (graphSpewingEnabled && !logger->streaming())
             logger->initGraph();
 
         if (CurrentHelperThread() ? helperThreadEnabled : cooperatingThreadEnabled)
@@ -991,6 +1128,10 @@ TraceLoggerThreadState::destroyLogger(TraceLoggerThread* logger)
 {
     MOZ_ASSERT(initialized);
     MOZ_ASSERT(logger);
+
+    // The stream state lock is ordered before ours.
+    logger->finishStream();
+
     LockGuard<Mutex> guard(lock);
 
     logger->remove();
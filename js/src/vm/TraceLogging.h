@@ -10,6 +10,7 @@
 #include "mozilla/GuardObjects.h"
 #include "mozilla/LinkedList.h"
 #include "mozilla/MemoryReporting.h"
+#include "mozilla/PodOperations.h"
 
 #include "jsalloc.h"
 
@@ -18,6 +19,7 @@
 #include "js/Vector.h"
 #include "vm/MutexIDs.h"
 #include "vm/TraceLoggingGraph.h"
+#include "vm/TraceLoggingStream.h"
 #include "vm/TraceLoggingTypes.h"
 
 struct JSRuntime;
@@ -247,8 +249,21 @@ class TraceLoggerThread : public mozilla::LinkedListElement<TraceLoggerThread>
 
     UniquePtr<TraceLoggerGraph> graph;
 
+    // When streaming, events go to the stream instead of |events|.
+    TraceLoggerStream* stream;
+    TraceLoggerStreamState* streamState;
+
     ContinuousSpace<EventEntry> events;
 
+    // When sampling, the number of events seen so far per predefined textId,
+    // with all other textIds sharing the last counter.
+    uint32_t sampleCounters[TraceLogger_Last + 1];
+
+    // Whether the started tree events at the first 64 depths were skipped
+    // by sampling, so their stop events are skipped as well.
+    uint64_t sampleSkippedMask;
+    uint32_t sampleDepth;
+
     // Every time the events get flushed, this count is increased by one.
     // Together with events.lastEntryId(), this gives an unique id for every
     // event.
@@ -266,9 +281,15 @@ class TraceLoggerThread : public mozilla::LinkedListElement<TraceLoggerThread>
       : enabled_(0),
         failed(false),
         graph(),
+        stream(nullptr),
+        streamState(nullptr),
+        sampleSkippedMask(0),
+        sampleDepth(0),
         iteration_(0),
         top(nullptr)
-    { }
+    {
+        mozilla::PodArrayZero(sampleCounters);
+    }
 
     bool init();
     ~TraceLoggerThread();
@@ -276,6 +297,11 @@ class TraceLoggerThread : public mozilla::LinkedListElement<TraceLoggerThread>
     bool init(uint32_t loggerId);
     void initGraph();
 
+    // Must be called without holding the TraceLoggerThreadState lock.
+    void initStream(TraceLoggerStreamState* state);
+    void finishStream();
+    bool streaming() const { return !!stream; }
+
     bool enable();
     bool enable(JSContext* cx);
     bool disable(bool force = false, const char* = "");
@@ -362,6 +388,7 @@ class TraceLoggerThread : public mozilla::LinkedListElement<TraceLoggerThread>
     void stopEvent(uint32_t id);
   private:
     void stopEvent();
+    bool sampleEvent(uint32_t id, uint32_t rate);
     void log(uint32_t id);
 
   public:
@@ -383,8 +410,11 @@ class TraceLoggerThreadState
     bool cooperatingThreadEnabled;
     bool helperThreadEnabled;
     bool graphSpewingEnabled;
+    bool streamingEnabled;
     bool spewErrors;
+    uint32_t sampleRate_;
     mozilla::LinkedList<TraceLoggerThread> threadLoggers;
+    UniquePtr<TraceLoggerStreamState> streamState;
 
     typedef HashMap<const void*,
                     TraceLoggerEventPayload*,
@@ -410,7 +440,9 @@ class TraceLoggerThreadState
         cooperatingThreadEnabled(false),
         helperThreadEnabled(false),
         graphSpewingEnabled(false),
+        streamingEnabled(false),
         spewErrors(false),
+        sampleRate_(1),
         nextTextId(TraceLogger_Last),
         startupTime(0),
         lock(js::mutexid::TraceLoggerThreadState)
@@ -429,6 +461,10 @@ class TraceLoggerThreadState
     }
     void enableTextId(JSContext* cx, uint32_t textId);
     void disableTextId(JSContext* cx, uint32_t textId);
+
+    // Only every Nth event of each textId is logged.
+    uint32_t sampleRate() const { return sampleRate_; }
+
     void maybeSpewError(const char* text) {
         if (spewErrors)
             fprintf(stderr, "%s\n", text);
@@ -459,6 +495,10 @@ void DestroyTraceLoggerThreadState();
 void DestroyTraceLogger(TraceLoggerThread* logger);
 
 TraceLoggerThread* TraceLoggerForCurrentThread(JSContext* cx = nullptr);
+
+// The current time, in the unit and relative to the origin used for logged
+// events.
+uint64_t TraceLoggerTimestamp();
 #else
 inline TraceLoggerThread* TraceLoggerForCurrentThread(JSContext* cx = nullptr) {
     return nullptr;
@@ -0,0 +1,265 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+ * vim: set ts=8 sts=4 et sw=4 tw=99:
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "vm/TraceLoggingStream.h"
+
+#ifdef XP_WIN
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#endif
+
+#include "mozilla/EndianUtils.h"
+#include "mozilla/MathAlgorithms.h"
+#include "mozilla/TimeStamp.h"
+
+#include <string.h>
+
+#include "jsprf.h"
+
+#include "threading/LockGuard.h"
+#include "vm/Time.h"
+#include "vm/TraceLogging.h"
+
+#ifndef DEFAULT_TRACE_LOG_DIR
+# if defined(_WIN32)
+#  define DEFAULT_TRACE_LOG_DIR "."
+# else
+#  define DEFAULT_TRACE_LOG_DIR "/tmp/"
+# endif
+#endif
+
+using namespace js;
+
+using mozilla::LittleEndian;
+using mozilla::TimeDuration;
+
+static const char StreamMagic[] = "TLSTREAM";
+static const uint32_t StreamVersion = 1;
+
+TraceLoggerStream::~TraceLoggerStream()
+{
+    if (out_)
+        fclose(out_);
+    js_free(entries_);
+}
+
+bool
+TraceLoggerStream::init(uint32_t capacity, uint32_t loggerId, uint32_t pid)
+{
+    MOZ_ASSERT(mozilla::IsPowerOfTwo(capacity));
+
+    entries_ = js_pod_malloc<EventEntry>(capacity);
+    if (!entries_)
+        return false;
+    capacityMask_ = capacity - 1;
+    loggerId_ = loggerId;
+
+    if (!writtenTextIds_.init())
+        return false;
+
+    const char* outdir = getenv("TLDIR") ? getenv("TLDIR") : DEFAULT_TRACE_LOG_DIR;
+    UniqueChars filename = JS_smprintf("%s/tl-stream.%u.%u.bin", outdir, pid, loggerId);
+    if (!filename)
+        return false;
+
+    out_ = fopen(filename.get(), "wb");
+    if (!out_) {
+        fprintf(stderr, "warning: failed to create TraceLogger stream file %s\n", filename.get());
+        return false;
+    }
+
+    uint8_t header[sizeof(StreamMagic) - 1 + 3 * sizeof(uint32_t)];
+    memcpy(header, StreamMagic, sizeof(StreamMagic) - 1);
+    LittleEndian::writeUint32(header + 8, StreamVersion);
+    LittleEndian::writeUint32(header + 12, pid);
+    LittleEndian::writeUint32(header + 16, loggerId);
+    if (fwrite(header, sizeof(header), 1, out_) != 1)
+        failed_ = true;
+
+    return true;
+}
+
+void
+TraceLoggerStream::writeRecord(TraceLoggerStreamRecord kind, const void* data, size_t length)
+{
+    if (failed_)
+        return;
+
+    uint8_t tag = uint8_t(kind);
+    if (fwrite(&tag, 1, 1, out_) != 1 || fwrite(data, length, 1, out_) != 1)
+        failed_ = true;
+}
+
+void
+TraceLoggerStream::writeText(TraceLoggerThreadState* tlState, uint32_t textId)
+{
+    TextIdSet::AddPtr p = writtenTextIds_.lookupForAdd(textId);
+    if (p)
+        return;
+
+    // Forgetting that the text has been written only costs a duplicate record.
+    (void) writtenTextIds_.add(p, textId);
+
+    const char* text;
+    if (textId < TraceLogger_Last)
+        text = TLTextIdString(TraceLoggerTextId(textId));
+    else
+        text = tlState->maybeEventText(textId);
+
+    // The payload may already have been purged if the event was released
+    // before the stream was drained.
+    if (!text)
+        text = "<unknown>";
+
+    uint8_t buf[2 * sizeof(uint32_t)];
+    size_t length = strlen(text);
+    LittleEndian::writeUint32(buf, textId);
+    LittleEndian::writeUint32(buf + 4, uint32_t(length));
+    writeRecord(TraceLoggerStreamRecord::Text, buf, sizeof(buf));
+    if (!failed_ && length && fwrite(text, length, 1, out_) != 1)
+        failed_ = true;
+}
+
+void
+TraceLoggerStream::drain(TraceLoggerThreadState* tlState, uint64_t now, int64_t nowUs)
+{
+    uint8_t buf[2 * sizeof(uint64_t)];
+
+    uint64_t read = readPos_;
+    uint64_t write = writePos_;
+    for (; read != write; read++) {
+        const EventEntry& entry = entries_[read & capacityMask_];
+        writeText(tlState, entry.textId);
+
+        LittleEndian::writeUint64(buf, entry.time);
+        LittleEndian::writeUint32(buf + 8, entry.textId);
+        writeRecord(TraceLoggerStreamRecord::Event, buf, sizeof(uint64_t) + sizeof(uint32_t));
+    }
+    readPos_ = read;
+
+    uint64_t lost = lostEvents_.exchange(0);
+    if (lost) {
+        LittleEndian::writeUint64(buf, lost);
+        writeRecord(TraceLoggerStreamRecord::Lost, buf, sizeof(uint64_t));
+    }
+
+    LittleEndian::writeUint64(buf, now);
+    LittleEndian::writeUint64(buf + 8, uint64_t(nowUs));
+    writeRecord(TraceLoggerStreamRecord::Clock, buf, sizeof(buf));
+
+    if (!failed_ && fflush(out_) != 0)
+        failed_ = true;
+}
+
+size_t
+TraceLoggerStream::sizeOfExcludingThis(mozilla::MallocSizeOf mallocSizeOf) const
+{
+    return mallocSizeOf(entries_) + writtenTextIds_.sizeOfExcludingThis(mallocSizeOf);
+}
+
+TraceLoggerStreamState::~TraceLoggerStreamState()
+{
+    if (thread_) {
+        {
+            LockGuard<Mutex> guard(lock);
+            terminate_ = true;
+            wakeup_.notify_all();
+        }
+        thread_->join();
+    }
+
+    MOZ_ASSERT(streams_.isEmpty());
+}
+
+bool
+TraceLoggerStreamState::init(TraceLoggerThreadState* tlState, uint32_t bufferCapacity,
+                             uint32_t flushIntervalMs)
+{
+    tlState_ = tlState;
+    bufferCapacity_ = mozilla::RoundUpPow2(bufferCapacity);
+    flushIntervalMs_ = flushIntervalMs;
+    pid_ = (uint32_t) getpid();
+
+    thread_.emplace();
+    if (!thread_->init(ThreadMain, this)) {
+        thread_.reset();
+        return false;
+    }
+
+    return true;
+}
+
+/* static */ void
+TraceLoggerStreamState::ThreadMain(void* arg)
+{
+    ThisThread::SetName("TraceLogger Flush");
+    static_cast<TraceLoggerStreamState*>(arg)->threadLoop();
+}
+
+void
+TraceLoggerStreamState::threadLoop()
+{
+    UniqueLock<Mutex> guard(lock);
+    while (!terminate_) {
+        wakeup_.wait_for(guard, TimeDuration::FromMilliseconds(flushIntervalMs_));
+        flushAll(guard);
+
+        // Events stream out by text id, so unused payloads can be released as
+        // soon as the events have been drained. Nothing else purges payloads
+        // when streaming.
+        tlState_->purgeUnusedPayloads();
+    }
+}
+
+void
+TraceLoggerStreamState::flushAll(const LockGuard<Mutex>& lock)
+{
+    uint64_t now = TraceLoggerTimestamp();
+    int64_t nowUs = PRMJ_Now();
+    for (TraceLoggerStream* stream : streams_)
+        stream->drain(tlState_, now, nowUs);
+}
+
+TraceLoggerStream*
+TraceLoggerStreamState::createStream()
+{
+    LockGuard<Mutex> guard(lock);
+
+    TraceLoggerStream* stream = js_new<TraceLoggerStream>();
+    if (!stream)
+        return nullptr;
+
+    if (!stream->init(bufferCapacity_, nextLoggerId_++, pid_)) {
+        js_delete(stream);
+        return nullptr;
+    }
+
+    streams_.insertBack(stream);
+    return stream;
+}
+
+void
+TraceLoggerStreamState::destroyStream(TraceLoggerStream* stream)
+{
+    LockGuard<Mutex> guard(lock);
+
+    stream->drain(tlState_, TraceLoggerTimestamp(), PRMJ_Now());
+    stream->remove();
+    js_delete(stream);
+}
+
+size_t
+TraceLoggerStreamState::sizeOfExcludingThis(mozilla::MallocSizeOf mallocSizeOf)
+{
+    LockGuard<Mutex> guard(lock);
+
+    size_t size = 0;
+    for (TraceLoggerStream* stream : streams_)
+        size += mallocSizeOf(stream) + stream->sizeOfExcludingThis(mallocSizeOf);
+    return size;
+}
@@ -0,0 +1,172 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+ * vim: set ts=8 sts=4 et sw=4 tw=99:
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef TraceLoggingStream_h
+#define TraceLoggingStream_h
+
+#include "mozilla/Atomics.h"
+#include "mozilla/LinkedList.h"
+#include "mozilla/Maybe.h"
+#include "mozilla/MemoryReporting.h"
+
+#include <stdio.h>
+
+#include "js/HashTable.h"
+#include "threading/ConditionVariable.h"
+#include "threading/Thread.h"
+#include "vm/MutexIDs.h"
+#include "vm/TraceLoggingTypes.h"
+
+/*
+ * Streaming output of tracelogging, enabled with TLOPTIONS=EnableStream.
+ *
+ * Instead of building a tree in memory, every logger (=thread) pushes its
+ * events into a fixed size ring buffer. A single background thread
+ * periodically drains all ring buffers to one file per logger, named
+ * tl-stream.<pid>.<loggerId>.bin. The logging thread never blocks and never
+ * allocates: when the ring buffer is full the event is dropped and counted.
+ *
+ * The file starts with the header
+ *  - magic:    8 bytes "TLSTREAM"
+ *  - version:  32 bits
+ *  - pid:      32 bits
+ *  - loggerId: 32 bits
+ * followed by records, each starting with a 8 bit record kind:
+ *  - Event: 64 bits timestamp, 32 bits textId. TraceLogger_Stop ends the last
+ *           started tree event.
+ *  - Text:  32 bits textId, 32 bits length, followed by the text (no NUL).
+ *           Written before the first event using the textId.
+ *  - Lost:  64 bits number of events dropped since the last Lost record.
+ *  - Clock: 64 bits timestamp, 64 bits microseconds since the epoch. Used to
+ *           convert timestamps to wall clock time.
+ * All integers are little endian. Timestamps are in the same unit as the
+ * ones of the graph output.
+ *
+ * js/src/devtools/tracelogger/tl-stream-to-profile.py converts these files
+ * to the Gecko profiler's JSON format.
+ */
+
+namespace js {
+
+class TraceLoggerThreadState;
+
+enum class TraceLoggerStreamRecord : uint8_t
+{
+    Event = 0,
+    Text = 1,
+    Lost = 2,
+    Clock = 3
+};
+
+// Single producer, single consumer ring buffer of events. The logging thread
+// pushes, the flush thread drains.
+class TraceLoggerStream : public mozilla::LinkedListElement<TraceLoggerStream>
+{
+    EventEntry* entries_;
+    uint32_t capacityMask_;
+
+    mozilla::Atomic<uint64_t, mozilla::ReleaseAcquire> writePos_;
+    mozilla::Atomic<uint64_t, mozilla::ReleaseAcquire> readPos_;
+    mozilla::Atomic<uint64_t, mozilla::Relaxed> lostEvents_;
+
+    // Only used by the thread draining the stream, with the stream state lock
+    // held.
+    FILE* out_;
+    uint32_t loggerId_;
+    typedef HashSet<uint32_t, DefaultHasher<uint32_t>, SystemAllocPolicy> TextIdSet;
+    TextIdSet writtenTextIds_;
+    bool failed_;
+
+    void writeRecord(TraceLoggerStreamRecord kind, const void* data, size_t length);
+    void writeText(TraceLoggerThreadState* tlState, uint32_t textId);
+
+  public:
+    TraceLoggerStream()
+      : entries_(nullptr),
+        capacityMask_(0),
+        writePos_(0),
+        readPos_(0),
+        lostEvents_(0),
+        out_(nullptr),
+        loggerId_(0),
+        failed_(false)
+    { }
+    ~TraceLoggerStream();
+
+    // |capacity| must be a power of two.
+    MOZ_MUST_USE bool init(uint32_t capacity, uint32_t loggerId, uint32_t pid);
+
+    // Called by the logging thread.
+    void push(uint64_t time, uint32_t textId) {
+        uint64_t write = writePos_;
+        if (write - readPos_ > capacityMask_) {
+            lostEvents_++;
+            return;
+        }
+
+        EventEntry& entry = entries_[write & capacityMask_];
+        entry.time = time;
+        entry.textId = textId;
+        writePos_ = write + 1;
+    }
+
+    // Called by the flush thread.
+    void drain(TraceLoggerThreadState* tlState, uint64_t now, int64_t nowUs);
+
+    size_t sizeOfExcludingThis(mozilla::MallocSizeOf mallocSizeOf) const;
+};
+
+// Process wide state of the streaming output: the registered streams and the
+// thread flushing them.
+class TraceLoggerStreamState
+{
+    TraceLoggerThreadState* tlState_;
+    uint32_t bufferCapacity_;
+    uint32_t flushIntervalMs_;
+    uint32_t pid_;
+    uint32_t nextLoggerId_;
+
+    mozilla::LinkedList<TraceLoggerStream> streams_;
+    mozilla::Maybe<Thread> thread_;
+    ConditionVariable wakeup_;
+    bool terminate_;
+
+    static void ThreadMain(void* arg);
+    void threadLoop();
+    void flushAll(const LockGuard<Mutex>& lock);
+
+  public:
+    Mutex lock;
+
+    TraceLoggerStreamState()
+      : tlState_(nullptr),
+        bufferCapacity_(0),
+        flushIntervalMs_(0),
+        pid_(0),
+        nextLoggerId_(0),
+        terminate_(false),
+        lock(js::mutexid::TraceLoggerStreamState)
+    { }
+    ~TraceLoggerStreamState();
+
+    MOZ_MUST_USE bool init(TraceLoggerThreadState* tlState, uint32_t bufferCapacity,
+                           uint32_t flushIntervalMs);
+
+    // Create and register a new stream, or return nullptr on failure.
+    TraceLoggerStream* createStream();
+
+    // Flush the remaining events of the stream and destroy it.
+    void destroyStream(TraceLoggerStream* stream);
+
+    size_t sizeOfExcludingThis(mozilla::MallocSizeOf mallocSizeOf);
+    size_t sizeOfIncludingThis(mozilla::MallocSizeOf mallocSizeOf) {
+        return mallocSizeOf(this) + sizeOfExcludingThis(mallocSizeOf);
+    }
+};
+
+} // namespace js
+
+#endif /* TraceLoggingStream_h */
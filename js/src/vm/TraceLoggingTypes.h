@@ -75,6 +75,9 @@
     _(AddKeepAliveInstructions)                       \
     _(GenerateLIR)                                    \
     _(RegisterAllocation)                             \
+    _(BacktrackingAllocation)                         \
+    _(LinearScanAllocation)                           \
+    _(StupidAllocation)                               \
     _(GenerateCode)                                   \
     _(IonBuilderRestartLoop)                          \
     _(VMSpecific)
@@ -4370,7 +4370,9 @@ ObjectGroup::sweep(AutoClearTypeInferenceStateOnOOM* oom)
             if (prop) {
                 oldPropertiesFound++;
                 prop->types.checkMagic();
-                if (singleton() && !prop->types.constraintList() && !zone()->isPreservingCode()) {
+                if (singleton() && !prop->types.constraintList() &&
+                    zone()->types.sweepReleaseSingletonTypes)
+                {
                     /*
                      * Don't copy over properties of singleton objects when their
                      * presence will not be required by jitcode or type constraints
@@ -4402,7 +4404,9 @@ ObjectGroup::sweep(AutoClearTypeInferenceStateOnOOM* oom)
     } else if (propertyCount == 1) {
         Property* prop = (Property*) propertySet;
         prop->types.checkMagic();
-        if (singleton() && !prop->types.constraintList() && !zone()->isPreservingCode()) {
+        if (singleton() && !prop->types.constraintList() &&
+            zone()->types.sweepReleaseSingletonTypes)
+        {
             // Skip, as above.
             clearProperties();
         } else {
@@ -4457,16 +4461,20 @@ JSScript::maybeSweepTypes(AutoClearTypeInferenceStateOnOOM* oom)
         !hasBaselineScript() &&
         !hasIonScript())
     {
-        types_->destroy();
-        types_ = nullptr;
-
-        // Freeze constraints on stack type sets need to be regenerated the
-        // next time the script is analyzed.
-        hasFreezeConstraints_ = false;
-
+        releaseTypes();
         return;
     }
 
+    // Track how many sweeps the script has not run for. Zones which are not
+    // preserving code reset warm-up counts when discarding it, and rely on
+    // sweepReleaseTypes instead.
+    if (!zone()->isPreservingCode() || getWarmUpCount() != types_->sweepWarmUpCount_) {
+        types_->sweepWarmUpCount_ = getWarmUpCount();
+        types_->coldSweeps_ = 0;
+    } else if (types_->coldSweeps_ < UINT32_MAX) {
+        types_->coldSweeps_++;
+    }
+
     unsigned num = TypeScript::NumTypeSets(this);
     StackTypeSet* typeArray = types_->typeArray();
 
@@ -4480,11 +4488,40 @@ JSScript::maybeSweepTypes(AutoClearTypeInferenceStateOnOOM* oom)
         hasFreezeConstraints_ = false;
     }
 
+    // Destroy the type information of a cold script if the zone asks for it.
+    // Compilations of other scripts may still depend on it, so this waits
+    // until the constraints of all invalidated compilations are gone.
+    if (types.releaseColdTypesAfter &&
+        types_->coldSweeps_ >= types.releaseColdTypesAfter &&
+        !hasBaselineScript() &&
+        !hasIonScript() &&
+        types_->inlinedCompilations().empty())
+    {
+        bool hasConstraints = false;
+        for (unsigned i = 0; i < num && !hasConstraints; i++)
+            hasConstraints = !!typeArray[i].constraintList();
+        if (!hasConstraints) {
+            releaseTypes();
+            return;
+        }
+    }
+
     // Update the recompile indexes in any IonScripts still on the script.
     if (hasIonScript())
         ionScript()->recompileInfoRef().shouldSweep(types);
 }
 
+void
+JSScript::releaseTypes()
+{
+    types_->destroy();
+    types_ = nullptr;
+
+    // Freeze constraints on stack type sets need to be regenerated the
+    // next time the script is analyzed.
+    hasFreezeConstraints_ = false;
+}
+
 void
 TypeScript::destroy()
 {
@@ -4520,6 +4557,8 @@ TypeZone::TypeZone(Zone* zone)
     sweepTypeLifoAlloc(zone->group(), (size_t) TYPE_LIFO_ALLOC_PRIMARY_CHUNK_SIZE),
     sweepCompilerOutputs(zone->group(), nullptr),
     sweepReleaseTypes(zone->group(), false),
+    sweepReleaseSingletonTypes(zone->group(), false),
+    releaseColdTypesAfter(zone->group(), 0),
     sweepingTypes(zone->group(), false),
     activeAnalysis(zone->group(), nullptr)
 {
@@ -4538,8 +4577,13 @@ TypeZone::beginSweep(FreeOp* fop, bool releaseTypes, AutoClearTypeInferenceState
     MOZ_ASSERT(zone()->isGCSweepingOrCompacting());
     MOZ_ASSERT(!sweepCompilerOutputs);
     MOZ_ASSERT(!sweepReleaseTypes);
+    MOZ_ASSERT(!sweepReleaseSingletonTypes);
 
-    sweepReleaseTypes = releaseTypes;
+    // Observed types are only released with the JIT code that depends on
+    // them, unless the zone trims its cold type information.
+    sweepReleaseTypes = releaseTypes && !zone()->isPreservingCode();
+    sweepReleaseSingletonTypes = !zone()->isPreservingCode() ||
+                                 (releaseTypes && releaseColdTypesAfter);
 
     // Clear the analysis pool, but don't release its data yet. While sweeping
     // types any live data will be allocated into the pool.
@@ -4590,6 +4634,7 @@ TypeZone::endSweep(JSRuntime* rt)
     sweepCompilerOutputs = nullptr;
 
     sweepReleaseTypes = false;
+    sweepReleaseSingletonTypes = false;
 
     rt->gc.freeAllLifoBlocksAfterSweeping(&sweepTypeLifoAlloc.ref());
 }
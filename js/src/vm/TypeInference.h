@@ -1192,6 +1192,12 @@ class TypeScript
     // them as well.
     RecompileInfoVector inlinedCompilations_;
 
+    // The script's warm-up count when the types were last swept, and the
+    // number of consecutive sweeps since then it has stayed unchanged. See
+    // TypeZone::releaseColdTypesAfter.
+    uint32_t sweepWarmUpCount_;
+    uint32_t coldSweeps_;
+
     // Variable-size array
     StackTypeSet typeArray_[1];
 
@@ -1384,6 +1390,17 @@ class TypeZone
     // information attached to scripts.
     ZoneGroupData<bool> sweepReleaseTypes;
 
+    // During incremental sweeping, whether to drop the property types of
+    // singleton objects that have no constraints.
+    ZoneGroupData<bool> sweepReleaseSingletonTypes;
+
+    // If non-zero, destroy the type information attached to scripts that
+    // have not run for this many GCs in a row, and periodically drop unused
+    // singleton property types, even while the zone is preserving JIT code.
+    // This keeps type information from accumulating in long lived zones
+    // which are never collected with their code discarded.
+    ZoneGroupData<uint32_t> releaseColdTypesAfter;
+
     ZoneGroupData<bool> sweepingTypes;
 
     // The topmost AutoEnterAnalysis on the stack, if there is one.
@@ -118,6 +118,31 @@ VersionCheck(XDRState<mode>* xdr)
     return true;
 }
 
+// Encode an empty function index, or skip over the index when decoding. See
+// XDRFunctionIndexEntry.
+template<XDRMode mode>
+static bool
+XDRFunctionIndex(XDRState<mode>* xdr)
+{
+    if (mode == XDR_DECODE && xdr->buf.remaining() < sizeof(uint32_t))
+        return xdr->fail(JS::TranscodeResult_Failure_BadDecode);
+
+    uint32_t entryCount = 0;
+    if (!xdr->codeUint32(&entryCount))
+        return false;
+
+    if (mode == XDR_DECODE) {
+        // The index precedes the build id, so it has to be validated before
+        // we know that the buffer was produced by this build.
+        if (entryCount >= xdr->buf.remaining() / XDRFunctionIndexEntry::EncodedSize)
+            return xdr->fail(JS::TranscodeResult_Failure_BadDecode);
+        if (entryCount)
+            xdr->buf.read(entryCount * XDRFunctionIndexEntry::EncodedSize);
+    }
+
+    return true;
+}
+
 template<XDRMode mode>
 bool
 XDRState<mode>::codeFunction(MutableHandleFunction funp, HandleScriptSource sourceObject)
@@ -162,13 +187,20 @@ XDRState<mode>::codeScript(MutableHandleScript scriptp)
         mode == XDR_DECODE ? TraceLogger_DecodeScript : TraceLogger_EncodeScript;
     AutoTraceLog tl(logger, event);
 
-    AutoXDRTree scriptTree(this, getTopLevelTreeKey());
-
     if (mode == XDR_DECODE)
         scriptp.set(nullptr);
     else
         MOZ_ASSERT(!scriptp->enclosingScope());
 
+    // Code the function index outside of the top-level tree. The incremental
+    // encoder drops these bytes and computes the index when linearizing.
+    if (!XDRFunctionIndex(this)) {
+        postProcessContextErrors(cx());
+        return false;
+    }
+
+    AutoXDRTree scriptTree(this, getTopLevelTreeKey());
+
     if (!VersionCheck(this)) {
         postProcessContextErrors(cx());
         return false;
@@ -322,44 +354,50 @@ XDRIncrementalEncoder::endSubTree()
 }
 
 bool
-XDRIncrementalEncoder::linearize(JS::TranscodeBuffer& buffer)
+XDRIncrementalEncoder::visitSlices(FunctionIndex* index, JS::TranscodeBuffer* buffer)
 {
-    if (oom_) {
-        ReportOutOfMemory(cx());
-        return fail(JS::TranscodeResult_Throw);
-    }
-
-    // Do not linearize while we are currently adding bytes.
-    MOZ_ASSERT(scope_ == nullptr);
-
-    // Visit the tree parts in a depth first order, to linearize the bits.
-    Vector<SlicesNode::ConstRange> depthFirst(cx());
+    // Visit the tree parts in a depth first order, to linearize the bits. As
+    // each function sub-tree is visited without interruption, its bytes are
+    // contiguous in the linearized content.
+    struct Part {
+        SlicesNode::ConstRange iter;
+        size_t indexEntry;
+    };
+    static const size_t NoIndexEntry = size_t(-1);
+    Vector<Part> depthFirst(cx());
+    size_t offset = 0;
 
     SlicesTree::Ptr p = tree_.lookup(AutoXDRTree::topLevel);
     MOZ_ASSERT(p);
 
-    if (!depthFirst.append(((const SlicesNode&) p->value()).all())) {
+    if (!depthFirst.append(Part { ((const SlicesNode&) p->value()).all(), NoIndexEntry })) {
         ReportOutOfMemory(cx());
         return fail(JS::TranscodeResult_Throw);
     }
 
     while (!depthFirst.empty()) {
-        SlicesNode::ConstRange& iter = depthFirst.back();
-        Slice slice = iter.popCopyFront();
+        Part& part = depthFirst.back();
+        Slice slice = part.iter.popCopyFront();
         // These fields have different meaning, but they should be correlated if
         // the tree is well formatted.
-        MOZ_ASSERT_IF(slice.child == AutoXDRTree::noSubTree, iter.empty());
-        if (iter.empty())
+        MOZ_ASSERT_IF(slice.child == AutoXDRTree::noSubTree, part.iter.empty());
+        if (part.iter.empty()) {
+            if (index && part.indexEntry != NoIndexEntry) {
+                XDRFunctionIndexEntry& entry = (*index)[part.indexEntry];
+                entry.length = offset + slice.sliceLength - entry.offset;
+            }
             depthFirst.popBack();
+        }
 
         // Copy the bytes associated with the current slice to the transcode
         // buffer which would be serialized.
         MOZ_ASSERT(slice.sliceBegin <= slices_.length());
         MOZ_ASSERT(slice.sliceBegin + slice.sliceLength <= slices_.length());
-        if (!buffer.append(slices_.begin() + slice.sliceBegin, slice.sliceLength)) {
+        if (buffer && !buffer->append(slices_.begin() + slice.sliceBegin, slice.sliceLength)) {
             ReportOutOfMemory(cx());
             return fail(JS::TranscodeResult_Throw);
         }
+        offset += slice.sliceLength;
 
         // If we are at the end, go to back to the parent script.
         if (slice.child == AutoXDRTree::noSubTree)
@@ -368,12 +406,65 @@ XDRIncrementalEncoder::linearize(JS::TranscodeBuffer& buffer)
         // Visit the sub-parts before visiting the rest of the current slice.
         SlicesTree::Ptr p = tree_.lookup(slice.child);
         MOZ_ASSERT(p);
-        if (!depthFirst.append(((const SlicesNode&) p->value()).all())) {
+
+        size_t indexEntry = NoIndexEntry;
+        if (index) {
+            if (offset > UINT32_MAX) {
+                ReportAllocationOverflow(cx());
+                return fail(JS::TranscodeResult_Throw);
+            }
+            indexEntry = index->length();
+            if (!index->append(XDRFunctionIndexEntry { slice.child, uint32_t(offset), 0 })) {
+                ReportOutOfMemory(cx());
+                return fail(JS::TranscodeResult_Throw);
+            }
+        }
+
+        if (!depthFirst.append(Part { ((const SlicesNode&) p->value()).all(), indexEntry })) {
             ReportOutOfMemory(cx());
             return fail(JS::TranscodeResult_Throw);
         }
     }
 
+    return true;
+}
+
+bool
+XDRIncrementalEncoder::linearize(JS::TranscodeBuffer& buffer)
+{
+    if (oom_) {
+        ReportOutOfMemory(cx());
+        return fail(JS::TranscodeResult_Throw);
+    }
+
+    // Do not linearize while we are currently adding bytes.
+    MOZ_ASSERT(scope_ == nullptr);
+
+    FunctionIndex index;
+    if (!visitSlices(&index, nullptr))
+        return false;
+
+    size_t indexSize = sizeof(uint32_t) + index.length() * XDRFunctionIndexEntry::EncodedSize;
+    size_t cursor = buffer.length();
+    if (!buffer.growByUninitialized(indexSize)) {
+        ReportOutOfMemory(cx());
+        return fail(JS::TranscodeResult_Throw);
+    }
+
+    uint8_t* ptr = buffer.begin() + cursor;
+    mozilla::LittleEndian::writeUint32(ptr, uint32_t(index.length()));
+    ptr += sizeof(uint32_t);
+    for (const XDRFunctionIndexEntry& entry : index) {
+        mozilla::LittleEndian::writeUint64(ptr, entry.key);
+        mozilla::LittleEndian::writeUint32(ptr + sizeof(uint64_t), entry.offset);
+        mozilla::LittleEndian::writeUint32(ptr + sizeof(uint64_t) + sizeof(uint32_t), entry.length);
+        ptr += XDRFunctionIndexEntry::EncodedSize;
+    }
+    MOZ_ASSERT(ptr == buffer.end());
+
+    if (!visitSlices(nullptr, &buffer))
+        return false;
+
     tree_.finish();
     slices_.clearAndFree();
     return true;
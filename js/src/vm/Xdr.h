@@ -98,6 +98,11 @@ class XDRBuffer<XDR_DECODE> : public XDRBufferBase
         return ptr;
     }
 
+    size_t remaining() const {
+        MOZ_ASSERT(cursor_ <= buffer_.length());
+        return buffer_.length() - cursor_;
+    }
+
     uint8_t* write(size_t n) {
         MOZ_CRASH("Should never write in decode mode");
         return nullptr;
@@ -110,6 +115,29 @@ class XDRBuffer<XDR_DECODE> : public XDRBufferBase
 class XDRCoderBase;
 class XDRIncrementalEncoder;
 
+// Scripts encoded with XDRState::codeScript start with an index of the
+// functions whose bytecode is part of the encoding, so that a consumer can
+// find the bytes of a single function without decoding the whole tree:
+//
+//   uint32_t entryCount;
+//   struct {
+//       uint64_t key;     // AutoXDRTree key of the function.
+//       uint32_t offset;  // Offset of the function's bytes, relative to the
+//                         // end of the index.
+//       uint32_t length;  // Length of the function's bytes.
+//   } entries[entryCount];
+//
+// Only XDRIncrementalEncoder fills in the index; other encoders write an
+// empty one.
+struct XDRFunctionIndexEntry
+{
+    uint64_t key;
+    uint32_t offset;
+    uint32_t length;
+
+    static const size_t EncodedSize = sizeof(uint64_t) + 2 * sizeof(uint32_t);
+};
+
 // An AutoXDRTree is used to identify section encoded by an XDRIncrementalEncoder.
 //
 // Its primary goal is to identify functions, such that we can first encode them
@@ -470,8 +498,16 @@ class XDRIncrementalEncoder : public XDREncoder
     void endSubTree() override;
 
     // Append the content collected during the incremental encoding into the
-    // buffer given as argument.
+    // buffer given as argument, preceded by its function index.
     MOZ_MUST_USE bool linearize(JS::TranscodeBuffer& buffer);
+
+  private:
+    using FunctionIndex = Vector<XDRFunctionIndexEntry, 0, SystemAllocPolicy>;
+
+    // Visit the slices in the order in which they are linearized. If |index|
+    // is non-null, it is filled with the location of every function sub-tree.
+    // If |buffer| is non-null, the bytes of the slices are appended to it.
+    MOZ_MUST_USE bool visitSlices(FunctionIndex* index, JS::TranscodeBuffer* buffer);
 };
 
 } /* namespace js */
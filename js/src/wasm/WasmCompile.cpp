@@ -20,6 +20,8 @@
 
 #include "jsprf.h"
 
+#include "vm/HelperThreads.h"
+#include "wasm/WasmBaselineCompile.h"
 #include "wasm/WasmBinaryIterator.h"
 #include "wasm/WasmGenerator.h"
 #include "wasm/WasmSignalHandlers.h"
@@ -105,6 +107,316 @@ CompileArgs::initFromContext(JSContext* cx, ScriptedCaller&& scriptedCaller)
     return assumptions.initBuildIdFromContext(cx);
 }
 
+StreamingCompiler::StreamingCompiler(const CompileArgs& args, UniqueChars* error)
+  : args_(args),
+    error_(error),
+    state_(State::Environment),
+    position_(0),
+    hasCodeSection_(false),
+    codeSectionEnd_(0),
+    numFuncDefs_(0),
+    funcDefIndex_(0)
+{}
+
+StreamingCompiler::~StreamingCompiler()
+{}
+
+bool
+StreamingCompiler::init()
+{
+    MOZ_RELEASE_ASSERT(wasm::HaveSignalHandlers());
+
+    bytecode_ = js_new<ShareableBytes>();
+    return !!bytecode_;
+}
+
+bool
+StreamingCompiler::fail(size_t offset, const char* msg)
+{
+    state_ = State::Failed;
+    Decoder d(bytecode_->begin(), bytecode_->end(), 0, error_);
+    return d.fail(offset, msg);
+}
+
+// A varU32 takes at most five bytes, so a varU32 which cannot be read from
+// fewer bytes may just be incomplete.
+StreamingCompiler::Result
+StreamingCompiler::readVarU32(Decoder& d, bool atEnd, uint32_t* value)
+{
+    size_t available = d.bytesRemain();
+    if (d.readVarU32(value))
+        return Result::Ok;
+    return (!atEnd && available < 5) ? Result::NeedMoreBytes : Result::Fail;
+}
+
+bool
+StreamingCompiler::startCodeSection(size_t envEnd, uint32_t codeSectionSize)
+{
+    auto env = js::MakeUnique<ModuleEnvironment>();
+    if (!env)
+        return false;
+
+    Decoder d(bytecode_->begin(), bytecode_->begin() + envEnd, 0, error_);
+    if (!DecodeModuleEnvironment(d, env.get()))
+        return false;
+    if (!d.done())
+        return d.fail("unexpected section before the code section");
+
+    mg_ = js::MakeUnique<ModuleGenerator>(error_);
+    if (!mg_)
+        return false;
+
+    Tier tier = SelectCompileTier(args_, codeSectionSize);
+    if (!mg_->init(Move(env), args_, tier))
+        return false;
+
+    return mg_->startFuncDefs();
+}
+
+// Find the end of the sections which make up the module environment; for this
+// to work, all of them must have been received.
+StreamingCompiler::Result
+StreamingCompiler::scanEnvironment(bool atEnd)
+{
+    const uint8_t* begin = bytecode_->begin();
+    const uint8_t* end = bytecode_->end();
+
+    // The preamble is a fixed 8 bytes, checked by DecodeModuleEnvironment.
+    size_t pos = Max(position_, size_t(8));
+    if (size_t(end - begin) < pos) {
+        if (!atEnd)
+            return Result::NeedMoreBytes;
+
+        // Let DecodeModuleEnvironment report the truncated preamble.
+        MOZ_ALWAYS_FALSE(startCodeSection(end - begin, 0));
+        return Result::Fail;
+    }
+
+    while (true) {
+        Decoder d(begin + pos, end, pos, error_);
+        if (d.done()) {
+            if (!atEnd)
+                return Result::NeedMoreBytes;
+
+            // A module without code or data sections.
+            if (!startCodeSection(pos, 0))
+                return Result::Fail;
+            position_ = pos;
+            state_ = State::CodeSectionHeader;
+            return Result::Ok;
+        }
+
+        uint32_t id, size;
+        Result r = readVarU32(d, atEnd, &id);
+        if (r == Result::Ok)
+            r = readVarU32(d, atEnd, &size);
+        if (r != Result::Ok) {
+            if (r == Result::Fail)
+                fail(pos, "expected section header");
+            return r;
+        }
+
+        if (id != uint32_t(SectionId::Custom) && id >= uint32_t(SectionId::Code)) {
+            // The environment is complete; the payload of the code section
+            // starts right after its header.
+            if (!startCodeSection(pos, id == uint32_t(SectionId::Code) ? size : 0))
+                return Result::Fail;
+
+            if (id == uint32_t(SectionId::Code)) {
+                hasCodeSection_ = true;
+                position_ = d.currentOffset();
+                codeSectionEnd_ = position_ + size;
+            } else {
+                position_ = pos;
+            }
+            state_ = State::CodeSectionHeader;
+            return Result::Ok;
+        }
+
+        if (d.bytesRemain() < size) {
+            if (atEnd) {
+                fail(pos, "section too big");
+                return Result::Fail;
+            }
+            position_ = pos;
+            return Result::NeedMoreBytes;
+        }
+        pos = d.currentOffset() + size;
+    }
+}
+
+StreamingCompiler::Result
+StreamingCompiler::decodeCodeSectionHeader(bool atEnd)
+{
+    if (!hasCodeSection_) {
+        if (mg_->env().numFuncDefs() != 0) {
+            fail(position_, "expected function bodies");
+            return Result::Fail;
+        }
+        if (!mg_->finishFuncDefs())
+            return Result::Fail;
+        state_ = State::Tail;
+        return Result::Ok;
+    }
+
+    const uint8_t* begin = bytecode_->begin();
+    Decoder d(begin + position_, bytecode_->end(), position_, error_);
+    Result r = readVarU32(d, atEnd, &numFuncDefs_);
+    if (r != Result::Ok) {
+        if (r == Result::Fail)
+            fail(position_, "expected function body count");
+        return r;
+    }
+
+    if (numFuncDefs_ != mg_->env().numFuncDefs()) {
+        fail(position_, "function body count does not match function signature count");
+        return Result::Fail;
+    }
+
+    position_ = d.currentOffset();
+    state_ = State::FunctionBodies;
+    return Result::Ok;
+}
+
+StreamingCompiler::Result
+StreamingCompiler::decodeFunctionBodies(bool atEnd)
+{
+    const uint8_t* begin = bytecode_->begin();
+    size_t received = bytecode_->length();
+    bool sectionComplete = received >= codeSectionEnd_;
+    const uint8_t* limit = begin + Min(received, codeSectionEnd_);
+
+    while (funcDefIndex_ < numFuncDefs_) {
+        Decoder d(begin + position_, limit, position_, error_);
+
+        uint32_t bodySize;
+        Result r = readVarU32(d, atEnd || sectionComplete, &bodySize);
+        if (r != Result::Ok) {
+            if (r == Result::Fail)
+                fail(position_, "expected number of function body bytes");
+            return r;
+        }
+
+        if (d.bytesRemain() < bodySize) {
+            if (atEnd || sectionComplete) {
+                fail(position_, "function body length too big");
+                return Result::Fail;
+            }
+            return Result::NeedMoreBytes;
+        }
+
+        // The whole body is here, decode it for real.
+        d.rollbackPosition(begin + position_);
+        if (!DecodeFunctionBody(d, *mg_, mg_->env().numFuncImports() + funcDefIndex_)) {
+            state_ = State::Failed;
+            return Result::Fail;
+        }
+
+        position_ = d.currentOffset();
+        funcDefIndex_++;
+    }
+
+    if (position_ != codeSectionEnd_) {
+        if (!sectionComplete && !atEnd)
+            return Result::NeedMoreBytes;
+        fail(position_, "byte size mismatch in code section");
+        return Result::Fail;
+    }
+
+    if (!mg_->finishFuncDefs())
+        return Result::Fail;
+
+    state_ = State::Tail;
+    return Result::Ok;
+}
+
+bool
+StreamingCompiler::process(bool atEnd)
+{
+    while (true) {
+        Result r;
+        switch (state_) {
+          case State::Environment:
+            r = scanEnvironment(atEnd);
+            break;
+          case State::CodeSectionHeader:
+            r = decodeCodeSectionHeader(atEnd);
+            break;
+          case State::FunctionBodies:
+            r = decodeFunctionBodies(atEnd);
+            break;
+          case State::Tail:
+            // The tail sections are only decoded once the module is complete.
+            return true;
+          case State::Failed:
+            return false;
+          default:
+            MOZ_CRASH("unexpected state");
+        }
+
+        if (r == Result::Fail) {
+            state_ = State::Failed;
+            return false;
+        }
+        if (r == Result::NeedMoreBytes) {
+            MOZ_ASSERT(!atEnd);
+            return true;
+        }
+    }
+}
+
+bool
+StreamingCompiler::addBytes(const uint8_t* bytes, size_t length)
+{
+    MOZ_ASSERT(state_ != State::Failed);
+
+    if (!bytecode_->append(bytes, length)) {
+        state_ = State::Failed;
+        return false;
+    }
+
+    return process(/* atEnd = */ false);
+}
+
+SharedModule
+StreamingCompiler::finish()
+{
+    if (!process(/* atEnd = */ true))
+        return nullptr;
+
+    MOZ_ASSERT(state_ == State::Tail);
+
+    Decoder d(bytecode_->begin() + position_, bytecode_->end(), position_, error_);
+    if (!DecodeModuleTail(d, &mg_->mutableEnv()))
+        return nullptr;
+
+    MOZ_ASSERT(!*error_, "unreported error in decoding");
+
+    return mg_->finish(*bytecode_);
+}
+
+// Rough Ion throughput on x64, in bytecode bytes per millisecond and compilation
+// thread.
+static const double IonBytecodesPerMs = 2100;
+
+// Modules for which Ion is expected to take longer than this are compiled with
+// the baseline compiler, which is about five times faster.
+static const double IonCompileTimeCutoffMs = 1000;
+
+Tier
+wasm::SelectCompileTier(const CompileArgs& args, size_t codeBytes)
+{
+    if (!BaselineCanCompile())
+        return Tier::Ion;
+
+    if (args.alwaysBaseline || args.debugEnabled)
+        return Tier::Baseline;
+
+    size_t threads = CanUseExtraThreads() ? HelperThreadState().cpuCount : 1;
+    double ionCompileTimeMs = double(codeBytes) / (IonBytecodesPerMs * threads);
+    return ionCompileTimeMs > IonCompileTimeCutoffMs ? Tier::Baseline : Tier::Ion;
+}
+
 SharedModule
 wasm::Compile(const ShareableBytes& bytecode, const CompileArgs& args, UniqueChars* error)
 {
@@ -119,8 +431,12 @@ wasm::Compile(const ShareableBytes& bytecode, const CompileArgs& args, UniqueCha
     if (!DecodeModuleEnvironment(d, env.get()))
         return nullptr;
 
+    // Everything after the module environment is the code section and the
+    // data and name sections, which is close enough to the amount of code.
+    Tier tier = SelectCompileTier(args, d.bytesRemain());
+
     ModuleGenerator mg(error);
-    if (!mg.init(Move(env), args))
+    if (!mg.init(Move(env), args, tier))
         return nullptr;
 
     if (!DecodeCodeSection(d, mg))
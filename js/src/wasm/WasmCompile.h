@@ -64,6 +64,65 @@ struct CompileArgs
 SharedModule
 Compile(const ShareableBytes& bytecode, const CompileArgs& args, UniqueChars* error);
 
+// Compile a module whose bytecode arrives in pieces, e.g. from the network.
+// Sections before the code section are decoded once they have been received
+// in full; function bodies are then handed to the ModuleGenerator as soon as
+// each one is complete, so that they are compiled on helper threads while the
+// rest of the module is still arriving. The CompileArgs must outlive the
+// StreamingCompiler. Errors are reported the same way as for Compile().
+
+class ModuleGenerator;
+
+class StreamingCompiler
+{
+    enum class State { Environment, CodeSectionHeader, FunctionBodies, Tail, Failed };
+    enum class Result { Ok, NeedMoreBytes, Fail };
+
+    const CompileArgs&          args_;
+    UniqueChars*                error_;
+    MutableBytes                bytecode_;
+    UniquePtr<ModuleGenerator>  mg_;
+    State                       state_;
+
+    // Offset of the first byte which has not been decoded yet.
+    size_t                      position_;
+
+    // The code section header, once it has been found.
+    bool                        hasCodeSection_;
+    size_t                      codeSectionEnd_;
+    uint32_t                    numFuncDefs_;
+    uint32_t                    funcDefIndex_;
+
+    Result readVarU32(Decoder& d, bool atEnd, uint32_t* value);
+    Result scanEnvironment(bool atEnd);
+    Result decodeCodeSectionHeader(bool atEnd);
+    Result decodeFunctionBodies(bool atEnd);
+    bool startCodeSection(size_t envEnd, uint32_t codeSectionSize);
+    bool process(bool atEnd);
+    bool fail(size_t offset, const char* msg);
+
+  public:
+    StreamingCompiler(const CompileArgs& args, UniqueChars* error);
+    ~StreamingCompiler();
+
+    MOZ_MUST_USE bool init();
+
+    // Append the next |length| bytes of the module and compile whatever has
+    // become complete. Returns false on a decoding error or OOM.
+    MOZ_MUST_USE bool addBytes(const uint8_t* bytes, size_t length);
+
+    // Signal that all bytes have been received and finish the module.
+    SharedModule finish();
+};
+
+// Select the tier a wasm module is compiled with. Baseline is used when it is
+// required for debugging or forced by the options, and also for modules whose
+// |codeBytes| of bytecode would keep Ion busy for so long that the module is
+// better off starting to run with baseline code.
+
+Tier
+SelectCompileTier(const CompileArgs& args, size_t codeBytes);
+
 }  // namespace wasm
 }  // namespace js
 
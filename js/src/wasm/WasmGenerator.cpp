@@ -137,15 +137,13 @@ ModuleGenerator::initAsmJS(Metadata* asmJSMetadata)
 }
 
 bool
-ModuleGenerator::initWasm(const CompileArgs& args)
+ModuleGenerator::initWasm(const CompileArgs& args, Tier tier)
 {
     MOZ_ASSERT(!env_->isAsmJS());
+    MOZ_ASSERT_IF(tier == Tier::Baseline, BaselineCanCompile());
 
-    bool canBaseline = BaselineCanCompile();
-    bool debugEnabled = args.debugEnabled && canBaseline;
-    tier_ = ((args.alwaysBaseline || debugEnabled) && canBaseline)
-            ? Tier::Baseline
-            : Tier::Ion;
+    bool debugEnabled = args.debugEnabled && tier == Tier::Baseline;
+    tier_ = tier;
 
     if (!linkData_.initTier(tier_))
         return false;
@@ -238,7 +236,7 @@ ModuleGenerator::initWasm(const CompileArgs& args)
 }
 
 bool
-ModuleGenerator::init(UniqueModuleEnvironment env, const CompileArgs& args,
+ModuleGenerator::init(UniqueModuleEnvironment env, const CompileArgs& args, Tier tier,
                       Metadata* maybeAsmJSMetadata)
 {
     env_ = Move(env);
@@ -252,7 +250,8 @@ ModuleGenerator::init(UniqueModuleEnvironment env, const CompileArgs& args,
     if (!exportedFuncs_.init())
         return false;
 
-    if (env_->isAsmJS() ? !initAsmJS(maybeAsmJSMetadata) : !initWasm(args))
+    MOZ_ASSERT_IF(env_->isAsmJS(), tier == Tier::Ion);
+    if (env_->isAsmJS() ? !initAsmJS(maybeAsmJSMetadata) : !initWasm(args, tier))
         return false;
 
     if (args.scriptedCaller.filename) {
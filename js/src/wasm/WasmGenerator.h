@@ -19,6 +19,8 @@
 #ifndef wasm_generator_h
 #define wasm_generator_h
 
+#include "mozilla/TimeStamp.h"
+
 #include "jit/MacroAssembler.h"
 #include "wasm/WasmModule.h"
 #include "wasm/WasmValidate.h"
@@ -137,6 +139,7 @@ class CompileTask
     Maybe<jit::MacroAssembler> masm_;
     FuncCompileUnitVector      units_;
     bool                       debugEnabled_;
+    mozilla::TimeStamp         queuedTime_;
 
     CompileTask(const CompileTask&) = delete;
     CompileTask& operator=(const CompileTask&) = delete;
@@ -180,6 +183,12 @@ class CompileTask
     void setDebugEnabled(bool enabled) {
         debugEnabled_ = enabled;
     }
+    mozilla::TimeStamp queuedTime() const {
+        return queuedTime_;
+    }
+    void setQueuedTime(mozilla::TimeStamp time) {
+        queuedTime_ = time;
+    }
     bool reset(UniqueFuncBytesVector* freeFuncBytes) {
         for (FuncCompileUnit& unit : units_) {
             if (!freeFuncBytes->emplaceBack(Move(unit.recycle())))
@@ -269,13 +278,15 @@ class MOZ_STACK_CLASS ModuleGenerator
     MOZ_MUST_USE bool launchBatchCompile();
 
     MOZ_MUST_USE bool initAsmJS(Metadata* asmJSMetadata);
-    MOZ_MUST_USE bool initWasm(const CompileArgs& args);
+    MOZ_MUST_USE bool initWasm(const CompileArgs& args, Tier tier);
 
   public:
     explicit ModuleGenerator(UniqueChars* error);
     ~ModuleGenerator();
 
-    MOZ_MUST_USE bool init(UniqueModuleEnvironment env, const CompileArgs& args,
+    // For wasm, |tier| is the result of SelectCompileTier. asm.js is always
+    // compiled with Ion.
+    MOZ_MUST_USE bool init(UniqueModuleEnvironment env, const CompileArgs& args, Tier tier,
                            Metadata* maybeAsmJSMetadata = nullptr);
 
     const ModuleEnvironment& env() const { return *env_; }
@@ -21,6 +21,7 @@
 #include "mozilla/CheckedInt.h"
 #include "mozilla/Maybe.h"
 #include "mozilla/RangedPtr.h"
+#include "mozilla/SHA1.h"
 
 #include "jsprf.h"
 
@@ -49,6 +50,7 @@ using mozilla::IsNaN;
 using mozilla::IsSame;
 using mozilla::Nothing;
 using mozilla::RangedPtr;
+using mozilla::SHA1Sum;
 
 bool
 wasm::HasCompilerSupport(JSContext* cx)
@@ -365,6 +367,104 @@ DescribeScriptedCaller(JSContext* cx, ScriptedCaller* scriptedCaller)
     return true;
 }
 
+// Modules are looked up in the embedding's code cache (see JS::WasmCacheOps)
+// by a hash of their bytecode and of the assumptions their code is compiled
+// under, so that entries written by another build or for another cpu are never
+// hit. Compiled code can only be deserialized at the Ion tier and debug code is
+// never serialized, so only such modules are stored.
+
+typedef uint8_t CacheKey[JS::WasmCacheKeyLength];
+
+static_assert(JS::WasmCacheKeyLength == SHA1Sum::kHashSize,
+              "The wasm cache key is a SHA1 hash");
+
+static bool
+UseCodeCache(JSContext* cx, const CompileArgs& compileArgs)
+{
+    const JS::WasmCacheOps& ops = cx->wasmCacheOps();
+    return ops.openEntryForRead && ops.openEntryForWrite && !compileArgs.debugEnabled;
+}
+
+static void
+ComputeCacheKey(const ShareableBytes& bytecode, const Assumptions& assumptions, CacheKey* key)
+{
+    SHA1Sum sha1;
+    sha1.update(&assumptions.cpuId, sizeof(assumptions.cpuId));
+    sha1.update(assumptions.buildId.begin(), assumptions.buildId.length());
+
+    const uint8_t* cursor = bytecode.begin();
+    while (cursor != bytecode.end()) {
+        uint32_t length = uint32_t(Min(size_t(bytecode.end() - cursor), size_t(UINT32_MAX)));
+        sha1.update(cursor, length);
+        cursor += length;
+    }
+
+    sha1.finish(*key);
+}
+
+static SharedModule
+LookupCachedModule(JSContext* cx, const ShareableBytes& bytecode, const CompileArgs& compileArgs,
+                   const CacheKey& key)
+{
+    const JS::WasmCacheOps& ops = cx->wasmCacheOps();
+
+    size_t size;
+    const uint8_t* memory;
+    intptr_t handle;
+    if (!ops.openEntryForRead(cx->global(), key, &size, &memory, &handle))
+        return nullptr;
+
+    // A mismatch means the entry is stale or corrupt; the caller recompiles
+    // and overwrites it.
+    SharedModule module;
+    if (Module::assumptionsMatch(compileArgs.assumptions, memory, size))
+        module = Module::deserialize(bytecode.begin(), bytecode.length(), memory, size);
+
+    ops.closeEntryForRead(size, memory, handle);
+    return module;
+}
+
+static void
+StoreCachedModule(JSContext* cx, const Module& module, const CacheKey& key)
+{
+    if (module.code().anyTier() != Tier::Ion)
+        return;
+
+    size_t size = module.compiledSerializedSize();
+    if (!size)
+        return;
+
+    const JS::WasmCacheOps& ops = cx->wasmCacheOps();
+
+    uint8_t* memory;
+    intptr_t handle;
+    if (!ops.openEntryForWrite(cx->global(), key, size, &memory, &handle))
+        return;
+
+    module.compiledSerialize(memory, size);
+    ops.closeEntryForWrite(size, memory, handle);
+}
+
+static SharedModule
+CompileWithCodeCache(JSContext* cx, const ShareableBytes& bytecode, const CompileArgs& compileArgs,
+                     UniqueChars* error)
+{
+    if (!UseCodeCache(cx, compileArgs))
+        return Compile(bytecode, compileArgs, error);
+
+    CacheKey key;
+    ComputeCacheKey(bytecode, compileArgs.assumptions, &key);
+
+    if (SharedModule module = LookupCachedModule(cx, bytecode, compileArgs, key))
+        return module;
+
+    SharedModule module = Compile(bytecode, compileArgs, error);
+    if (module)
+        StoreCachedModule(cx, *module, key);
+
+    return module;
+}
+
 bool
 wasm::Eval(JSContext* cx, Handle<TypedArrayObject*> code, HandleObject importObj,
            MutableHandleWasmInstanceObject instanceObj)
@@ -390,7 +490,7 @@ wasm::Eval(JSContext* cx, Handle<TypedArrayObject*> code, HandleObject importObj
         return false;
 
     UniqueChars error;
-    SharedModule module = Compile(*bytecode, compileArgs, &error);
+    SharedModule module = CompileWithCodeCache(cx, *bytecode, compileArgs, &error);
     if (!module) {
         if (error) {
             JS_ReportErrorNumberASCII(cx, GetErrorMessage, nullptr, JSMSG_WASM_COMPILE_ERROR,
@@ -892,7 +992,7 @@ WasmModuleObject::construct(JSContext* cx, unsigned argc, Value* vp)
         return false;
 
     UniqueChars error;
-    SharedModule module = Compile(*bytecode, compileArgs, &error);
+    SharedModule module = CompileWithCodeCache(cx, *bytecode, compileArgs, &error);
     if (!module) {
         if (error) {
             JS_ReportErrorNumberASCII(cx, GetErrorMessage, nullptr, JSMSG_WASM_COMPILE_ERROR,
@@ -1916,16 +2016,38 @@ struct CompilePromiseTask : PromiseTask
     CompileArgs  compileArgs;
     UniqueChars  error;
     SharedModule module;
+    bool         storeInCache;
+    CacheKey     cacheKey;
 
     CompilePromiseTask(JSContext* cx, Handle<PromiseObject*> promise)
-      : PromiseTask(cx, promise)
+      : PromiseTask(cx, promise),
+        storeInCache(false)
     {}
 
+    // The code cache callbacks may only be called on the JSRuntime's thread,
+    // so the lookup happens before the task is started and the store when the
+    // promise is settled.
+    void lookupInCache(JSContext* cx) {
+        if (!UseCodeCache(cx, compileArgs))
+            return;
+
+        ComputeCacheKey(*bytecode, compileArgs.assumptions, &cacheKey);
+        module = LookupCachedModule(cx, *bytecode, compileArgs, cacheKey);
+        storeInCache = !module;
+    }
+
     void execute() override {
-        module = Compile(*bytecode, compileArgs, &error);
+        if (!module)
+            module = Compile(*bytecode, compileArgs, &error);
+    }
+
+    void maybeStoreInCache(JSContext* cx) {
+        if (module && storeInCache)
+            StoreCachedModule(cx, *module, cacheKey);
     }
 
     bool finishPromise(JSContext* cx, Handle<PromiseObject*> promise) override {
+        maybeStoreInCache(cx);
         return module
                ? ResolveCompilation(cx, *module, promise)
                : Reject(cx, compileArgs, Move(error), promise);
@@ -1993,6 +2115,8 @@ WebAssembly_compile(JSContext* cx, unsigned argc, Value* vp)
     if (!InitCompileArgs(cx, &task->compileArgs))
         return false;
 
+    task->lookupInCache(cx);
+
     if (!StartPromiseTask(cx, Move(task)))
         return false;
 
@@ -2039,6 +2163,7 @@ struct InstantiatePromiseTask : CompilePromiseTask
     {}
 
     bool finishPromise(JSContext* cx, Handle<PromiseObject*> promise) override {
+        maybeStoreInCache(cx);
         return module
                ? ResolveInstantiation(cx, *module, importObj, promise)
                : Reject(cx, compileArgs, Move(error), promise);
@@ -2101,6 +2226,8 @@ WebAssembly_instantiate(JSContext* cx, unsigned argc, Value* vp)
         if (!InitCompileArgs(cx, &task->compileArgs))
             return false;
 
+        task->lookupInCache(cx);
+
         if (!StartPromiseTask(cx, Move(task)))
             return false;
     }
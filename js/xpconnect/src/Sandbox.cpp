@@ -546,12 +546,46 @@ sandbox_addProperty(JSContext* cx, HandleObject obj, HandleId id, HandleValue v)
     return true;
 }
 
+static bool
+sandbox_enumerate(JSContext* cx, JS::HandleObject obj, JS::AutoIdVector& properties,
+                  bool enumerableOnly)
+{
+    if (!JS_NewEnumerateStandardClasses(cx, obj, properties, enumerableOnly))
+        return false;
+
+    // Interface objects aren't enumerable.
+    CompartmentPrivate* priv = CompartmentPrivate::Get(obj);
+    if (enumerableOnly || !priv)
+        return true;
+    return priv->lazyGlobalProperties.EnumerateInSandbox(cx, properties);
+}
+
+static bool
+sandbox_resolve(JSContext* cx, JS::HandleObject obj, JS::HandleId id, bool* resolvedp)
+{
+    if (!JS_ResolveStandardClass(cx, obj, id, resolvedp))
+        return false;
+    // The compartment private doesn't exist yet while the global is being
+    // created.
+    CompartmentPrivate* priv = CompartmentPrivate::Get(obj);
+    if (*resolvedp || !priv)
+        return true;
+    return priv->lazyGlobalProperties.ResolveInSandbox(cx, obj, id, resolvedp);
+}
+
+static bool
+sandbox_mayResolve(const JSAtomState& names, jsid id, JSObject* maybeObj)
+{
+    return JS_MayResolveStandardClass(names, id, maybeObj) ||
+           xpc::GlobalProperties::MayResolveInSandbox(id);
+}
+
 #define XPCONNECT_SANDBOX_CLASS_METADATA_SLOT (XPCONNECT_GLOBAL_EXTRA_SLOT_OFFSET)
 
 static const js::ClassOps SandboxClassOps = {
     nullptr, nullptr, nullptr, nullptr,
-    nullptr, JS_NewEnumerateStandardClasses, JS_ResolveStandardClass,
-    JS_MayResolveStandardClass,
+    nullptr, sandbox_enumerate, sandbox_resolve,
+    sandbox_mayResolve,
     sandbox_finalize,
     nullptr, nullptr, nullptr, JS_GlobalObjectTraceHook,
 };
@@ -1045,9 +1079,106 @@ xpc::GlobalProperties::DefineInSandbox(JSContext* cx, JS::HandleObject obj)
           IndexedDatabaseManager::DefineIndexedDB(cx, obj)))
         return false;
 
+    // Mirroring properties onto the prototype relies on them all being
+    // defined up front.
+    CompartmentPrivate* priv = CompartmentPrivate::Get(obj);
+    if (!priv->writeToGlobalPrototype)
+        priv->lazyGlobalProperties = TakeInterfaceObjects();
+
     return Define(cx, obj);
 }
 
+// The interface objects that sandboxes define lazily, as the GlobalProperties
+// flag that asks for them, their name and their binding.
+#define FOR_EACH_LAZY_SANDBOX_INTERFACE(MACRO)                                \
+    MACRO(CSS, "CSS", CSSBinding)                                             \
+    MACRO(XMLHttpRequest, "XMLHttpRequest", XMLHttpRequestBinding)            \
+    MACRO(TextEncoder, "TextEncoder", TextEncoderBinding)                     \
+    MACRO(TextDecoder, "TextDecoder", TextDecoderBinding)                     \
+    MACRO(URL, "URL", URLBinding)                                             \
+    MACRO(URLSearchParams, "URLSearchParams", URLSearchParamsBinding)         \
+    MACRO(Blob, "Blob", BlobBinding)                                          \
+    MACRO(Directory, "Directory", DirectoryBinding)                           \
+    MACRO(File, "File", FileBinding)                                          \
+    MACRO(fileReader, "FileReader", FileReaderBinding)                        \
+    MACRO(messageChannel, "MessageChannel", MessageChannelBinding)            \
+    MACRO(messageChannel, "MessagePort", MessagePortBinding)
+
+xpc::GlobalProperties
+xpc::GlobalProperties::TakeInterfaceObjects()
+{
+    GlobalProperties taken;
+#define TAKE_INTERFACE(flag_, name_, binding_)                                \
+    taken.flag_ = flag_;
+    FOR_EACH_LAZY_SANDBOX_INTERFACE(TAKE_INTERFACE)
+#undef TAKE_INTERFACE
+#define CLEAR_INTERFACE(flag_, name_, binding_)                               \
+    flag_ = false;
+    FOR_EACH_LAZY_SANDBOX_INTERFACE(CLEAR_INTERFACE)
+#undef CLEAR_INTERFACE
+    return taken;
+}
+
+bool
+xpc::GlobalProperties::ResolveInSandbox(JSContext* cx, JS::HandleObject obj,
+                                        JS::HandleId id, bool* resolvedp)
+{
+    *resolvedp = false;
+    if (!JSID_IS_STRING(id))
+        return true;
+
+    JSFlatString* name = JSID_TO_FLAT_STRING(id);
+    JSObject* (*getConstructor)(JSContext*) = nullptr;
+#define RESOLVE_INTERFACE(flag_, name_, binding_)                             \
+    if (flag_ && JS_FlatStringEqualsAscii(name, name_))                       \
+        getConstructor = dom::binding_::GetConstructorObject;
+    FOR_EACH_LAZY_SANDBOX_INTERFACE(RESOLVE_INTERFACE)
+#undef RESOLVE_INTERFACE
+    if (!getConstructor)
+        return true;
+
+    // This defines the property on the global, unless the interface object
+    // already exists because the property was defined and then deleted, in
+    // which case it stays deleted.
+    if (!getConstructor(cx))
+        return false;
+    return JS_AlreadyHasOwnPropertyById(cx, obj, id, resolvedp);
+}
+
+/* static */ bool
+xpc::GlobalProperties::MayResolveInSandbox(jsid id)
+{
+    if (!JSID_IS_STRING(id))
+        return false;
+
+    JSFlatString* name = JSID_TO_FLAT_STRING(id);
+#define MAY_RESOLVE_INTERFACE(flag_, name_, binding_)                         \
+    if (JS_FlatStringEqualsAscii(name, name_))                                \
+        return true;
+    FOR_EACH_LAZY_SANDBOX_INTERFACE(MAY_RESOLVE_INTERFACE)
+#undef MAY_RESOLVE_INTERFACE
+    return false;
+}
+
+bool
+xpc::GlobalProperties::EnumerateInSandbox(JSContext* cx,
+                                          JS::AutoIdVector& properties) const
+{
+    // Properties that have already been resolved are filtered out by the
+    // enumeration code.
+#define ENUMERATE_INTERFACE(flag_, name_, binding_)                           \
+    if (flag_) {                                                              \
+        JSString* str = JS_AtomizeAndPinString(cx, name_);                    \
+        if (!str || !properties.append(INTERNED_STRING_TO_JSID(cx, str)))     \
+            return false;                                                     \
+    }
+    FOR_EACH_LAZY_SANDBOX_INTERFACE(ENUMERATE_INTERFACE)
+#undef ENUMERATE_INTERFACE
+    return true;
+}
+
+#undef FOR_EACH_LAZY_SANDBOX_INTERFACE
+
 nsresult
 xpc::CreateSandboxObject(JSContext* cx, MutableHandleValue vp, nsISupports* prinOrSop,
                          SandboxOptions& options)
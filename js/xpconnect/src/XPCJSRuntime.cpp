@@ -1907,6 +1907,10 @@ ReportJSRuntimeExplicitTreeStats(const JS::RuntimeStats& rtStats,
         "Transient data (mostly parse nodes) held by the JSRuntime during "
         "compilation.");
 
+    RREPORT_BYTES(rtPath + NS_LITERAL_CSTRING("runtime/lifo-chunk-pool"),
+        KIND_HEAP, rtStats.runtime.lifoChunkPool,
+        "Unused LifoAlloc chunks kept for reuse by the JSRuntime's threads.");
+
     RREPORT_BYTES(rtPath + NS_LITERAL_CSTRING("runtime/interpreter-stack"),
         KIND_HEAP, rtStats.runtime.interpreterStack,
         "JS interpreter frames.");
@@ -1931,6 +1935,10 @@ ReportJSRuntimeExplicitTreeStats(const JS::RuntimeStats& rtStats,
         KIND_HEAP, rtStats.runtime.scriptData,
         "The table holding script data shared in the runtime.");
 
+    RREPORT_BYTES(rtPath + NS_LITERAL_CSTRING("runtime/regexp-code-cache"),
+        KIND_HEAP, rtStats.runtime.regExpCodeCache,
+        "The tables used by native regexp code shared across zones.");
+
     nsCString nonNotablePath =
         rtPath + nsPrintfCString("runtime/script-sources/source(scripts=%d, <non-notable files>)/",
                                  rtStats.runtime.scriptSourceInfo.numScripts);
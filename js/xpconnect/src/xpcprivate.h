@@ -2718,6 +2718,17 @@ struct GlobalProperties {
     bool Parse(JSContext* cx, JS::HandleObject obj);
     bool DefineInXPCComponents(JSContext* cx, JS::HandleObject obj);
     bool DefineInSandbox(JSContext* cx, JS::HandleObject obj);
+
+    // Sandboxes that don't mirror their properties onto their prototype only
+    // define the interface objects they ask for when those are first looked
+    // up, since creating them and their prototype chains is most of the cost
+    // of creating such a sandbox. These are used by the sandbox class hooks
+    // on the properties that are still to be defined.
+    bool ResolveInSandbox(JSContext* cx, JS::HandleObject obj, JS::HandleId id,
+                          bool* resolvedp);
+    static bool MayResolveInSandbox(jsid id);
+    bool EnumerateInSandbox(JSContext* cx, JS::AutoIdVector& properties) const;
+
     bool CSS : 1;
     bool indexedDB : 1;
     bool XMLHttpRequest : 1;
@@ -2738,6 +2749,7 @@ struct GlobalProperties {
     bool messageChannel: 1;
 private:
     bool Define(JSContext* cx, JS::HandleObject obj);
+    GlobalProperties TakeInterfaceObjects();
 };
 
 // Infallible.
@@ -3068,6 +3080,10 @@ public:
     // this compartment.
     bool waiveInterposition;
 
+    // For sandboxes, the properties asked for in wantGlobalProperties that
+    // haven't been defined yet. See GlobalProperties::ResolveInSandbox.
+    GlobalProperties lazyGlobalProperties;
+
     // If this flag is set, we intercept function calls on vanilla JS function
     // objects from this compartment if the caller compartment has the
     // hasInterposition flag set.
@@ -9724,6 +9724,7 @@ PresShell::Observe(nsISupports* aSubject,
     if (!AssumeAllFramesVisible() && mPresContext->IsRootContentDocument()) {
       DoUpdateApproximateFrameVisibility(/* aRemoveOnly = */ true);
     }
+    mFrameArena.Trim();
     return NS_OK;
   }
 
@@ -18,6 +18,8 @@
 #include "RestyleTrackerInlines.h"
 #include "nsTransitionManager.h"
 #include "mozilla/AutoRestyleTimelineMarker.h"
+#include "mozilla/Logging.h"
+#include "nsStyleSet.h"
 
 namespace mozilla {
 
@@ -103,6 +105,8 @@ RestyleTracker::ProcessOneRestyle(Element* aElement,
   }
 }
 
+static LazyLogModule sStyleSharingLog("StyleSharing");
+
 void
 RestyleTracker::DoProcessRestyles()
 {
@@ -122,6 +126,13 @@ RestyleTracker::DoProcessRestyles()
   RestyleManager::AnimationsWithDestroyedFrame
     animationsWithDestroyedFrame(mRestyleManager);
 
+  // For reporting how well the style contexts resolved by this restyle
+  // were shared among siblings.
+  nsStyleSet* styleSet = mRestyleManager->PresContext()->StyleSet()->AsGecko();
+  uint32_t restyleCount = mPendingRestyles.Count();
+  uint32_t sharedCount = styleSet->SharedStyleContextCount();
+  uint32_t createdCount = styleSet->CreatedStyleContextCount();
+
   // Create a ReframingStyleContexts struct on the stack and put it in our
   // mReframingStyleContexts for almost all of the remaining scope of
   // this function.
@@ -370,6 +381,18 @@ RestyleTracker::DoProcessRestyles()
   mHaveSelectors = false;
 
   mRestyleManager->EndProcessingRestyles();
+
+  if (MOZ_LOG_TEST(sStyleSharingLog, LogLevel::Debug)) {
+    uint32_t shared = styleSet->SharedStyleContextCount() - sharedCount;
+    uint32_t created = styleSet->CreatedStyleContextCount() - createdCount;
+    uint32_t total = shared + created;
+    nsIURI* uri = Document()->GetDocumentURI();
+    MOZ_LOG(sStyleSharingLog, LogLevel::Debug,
+            ("restyle of %u elements resolved %u style contexts, "
+             "%u shared (%u%%), for %s",
+             restyleCount, total, shared, total ? shared * 100 / total : 0,
+             uri ? uri->GetSpecOrDefault().get() : "N/A"));
+  }
 }
 
 bool
@@ -12,6 +12,7 @@
 #include "nsCSSFrameConstructor.h"
 
 #include "mozilla/AutoRestore.h"
+#include "GeckoProfiler.h"
 #include "mozilla/DebugOnly.h"
 #include "mozilla/ErrorResult.h"
 #include "mozilla/dom/HTMLDetailsElement.h"
@@ -7423,6 +7424,8 @@ nsCSSFrameConstructor::CreateNeededFrames()
   NS_ASSERTION(!rootElement || !rootElement->HasFlag(NODE_NEEDS_FRAME),
     "root element should not have frame created lazily");
   if (rootElement && rootElement->HasFlag(NODE_DESCENDANTS_NEED_FRAMES)) {
+    AUTO_PROFILER_LABEL("nsCSSFrameConstructor::CreateNeededFrames", CSS);
+    AutoProfilerTracing tracing("Paint", "CreateNeededFrames");
     BeginUpdate();
     TreeMatchContext treeMatchContext(
         mDocument, TreeMatchContext::ForFrameConstruction);
@@ -7609,6 +7612,7 @@ nsCSSFrameConstructor::ContentAppended(nsIContent* aContainer,
   MOZ_ASSERT(!aProvidedTreeMatchContext || !aAllowLazyConstruction);
   MOZ_ASSERT(!aAllowLazyConstruction || !RestyleManager()->IsInStyleRefresh());
 
+  AUTO_PROFILER_LABEL("nsCSSFrameConstructor::ContentAppended", CSS);
   AUTO_LAYOUT_PHASE_ENTRY_POINT(mPresShell->GetPresContext(), FrameC);
   NS_PRECONDITION(mUpdateCount != 0,
                   "Should be in an update while creating frames");
@@ -8027,6 +8031,7 @@ nsCSSFrameConstructor::ContentRangeInserted(nsIContent* aContainer,
   MOZ_ASSERT(!aProvidedTreeMatchContext || !aAllowLazyConstruction);
   MOZ_ASSERT(!aAllowLazyConstruction || !RestyleManager()->IsInStyleRefresh());
 
+  AUTO_PROFILER_LABEL("nsCSSFrameConstructor::ContentRangeInserted", CSS);
   AUTO_LAYOUT_PHASE_ENTRY_POINT(mPresShell->GetPresContext(), FrameC);
   NS_PRECONDITION(mUpdateCount != 0,
                   "Should be in an update while creating frames");
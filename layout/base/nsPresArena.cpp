@@ -9,6 +9,7 @@
 
 #include "nsPresArena.h"
 
+#include "mozilla/mozalloc.h"
 #include "mozilla/Poison.h"
 #include "nsDebug.h"
 #include "nsPrintfCString.h"
@@ -19,11 +20,16 @@
 #include "nsStyleContextInlines.h"
 #include "nsWindowSizes.h"
 
+#include <algorithm>
 #include <inttypes.h>
 
 using namespace mozilla;
 
 nsPresArena::nsPresArena()
+  : mChunks(nullptr)
+  , mCurrentChunk(nullptr)
+  , mCurrentPos(nullptr)
+  , mCurrentEnd(nullptr)
 {
 }
 
@@ -41,6 +47,98 @@ nsPresArena::~nsPresArena()
     }
   }
 #endif
+
+  while (mChunks) {
+    Chunk* chunk = mChunks;
+    mChunks = chunk->mNext;
+    FreeChunk(chunk);
+  }
+}
+
+/* static */ void
+nsPresArena::FreeChunk(Chunk* aChunk)
+{
+  MOZ_MAKE_MEM_UNDEFINED(aChunk, aChunk->mSize);
+  free(aChunk);
+}
+
+void*
+nsPresArena::AllocateFromChunk(size_t aSize)
+{
+  // The chunk header is followed by the objects.
+  static const size_t kChunkHeaderSize = AlignedSize(sizeof(Chunk));
+
+  Chunk* chunk;
+  char* result;
+  if (mCurrentChunk && aSize <= size_t(mCurrentEnd - mCurrentPos)) {
+    chunk = mCurrentChunk;
+    result = mCurrentPos;
+    mCurrentPos += aSize;
+  } else {
+    // Objects too large for a chunk get one of their own; it still starts
+    // within the first kChunkSize bytes so ChunkFor works for it.
+    size_t chunkSize = std::max(kChunkSize, kChunkHeaderSize + aSize);
+    chunk = static_cast<Chunk*>(moz_xmemalign(kChunkSize, chunkSize));
+    chunk->mNext = mChunks;
+    chunk->mSize = chunkSize;
+    chunk->mUsedCount = 0;
+    mChunks = chunk;
+
+    result = reinterpret_cast<char*>(chunk) + kChunkHeaderSize;
+    if (chunkSize == kChunkSize) {
+      mCurrentChunk = chunk;
+      mCurrentPos = result + aSize;
+      mCurrentEnd = reinterpret_cast<char*>(chunk) + kChunkSize;
+      MOZ_MAKE_MEM_NOACCESS(mCurrentPos, mCurrentEnd - mCurrentPos);
+    }
+  }
+
+  chunk->mUsedCount++;
+  MOZ_MAKE_MEM_UNDEFINED(result, aSize);
+  return result;
+}
+
+void
+nsPresArena::Trim()
+{
+  auto isUnused = [this](Chunk* aChunk) {
+    return !aChunk->mUsedCount && aChunk != mCurrentChunk;
+  };
+
+  bool haveUnusedChunks = false;
+  for (Chunk* chunk = mChunks; chunk; chunk = chunk->mNext) {
+    if (isUnused(chunk)) {
+      haveUnusedChunks = true;
+      break;
+    }
+  }
+  if (!haveUnusedChunks) {
+    return;
+  }
+
+  for (FreeList* entry = mFreeLists; entry != ArrayEnd(mFreeLists); ++entry) {
+    nsTArray<void*>& entries = entry->mEntries;
+    nsTArray<void*>::index_type kept = 0;
+    for (void* ptr : entries) {
+      if (!isUnused(ChunkFor(ptr))) {
+        entries[kept++] = ptr;
+      }
+    }
+    entry->mEntriesEverAllocated -= entries.Length() - kept;
+    entries.TruncateLength(kept);
+    entries.Compact();
+  }
+
+  Chunk** link = &mChunks;
+  while (*link) {
+    Chunk* chunk = *link;
+    if (isUnused(chunk)) {
+      *link = chunk->mNext;
+      FreeChunk(chunk);
+    } else {
+      link = &chunk->mNext;
+    }
+  }
 }
 
 /* inline */ void
@@ -91,7 +189,7 @@ nsPresArena::Allocate(uint32_t aCode, size_t aSize)
   MOZ_ASSERT(aCode < ArrayLength(mFreeLists));
 
   // We only hand out aligned sizes
-  aSize = mPool.AlignedSize(aSize);
+  aSize = AlignedSize(aSize);
 
   FreeList* list = &mFreeLists[aCode];
 
@@ -140,12 +238,13 @@ nsPresArena::Allocate(uint32_t aCode, size_t aSize)
     }
 #endif
     MOZ_MAKE_MEM_UNDEFINED(result, list->mEntrySize);
+    ChunkFor(result)->mUsedCount++;
     return result;
   }
 
   // Allocate a new chunk from the arena
   list->mEntriesEverAllocated++;
-  return mPool.Allocate(aSize);
+  return AllocateFromChunk(aSize);
 }
 
 void
@@ -161,6 +260,10 @@ nsPresArena::Free(uint32_t aCode, void* aPtr)
 
   MOZ_MAKE_MEM_NOACCESS(aPtr, list->mEntrySize);
   list->mEntries.AppendElement(aPtr);
+
+  Chunk* chunk = ChunkFor(aPtr);
+  MOZ_ASSERT(chunk->mUsedCount > 0, "freeing an object twice?");
+  chunk->mUsedCount--;
 }
 
 void
@@ -177,7 +280,10 @@ nsPresArena::AddSizeOfExcludingThis(nsWindowSizes& aSizes) const
   // slop in the arena itself as well as the size of objects that
   // we've not measured explicitly.
 
-  size_t mallocSize = mPool.SizeOfExcludingThis(aSizes.mState.mMallocSizeOf);
+  size_t mallocSize = 0;
+  for (Chunk* chunk = mChunks; chunk; chunk = chunk->mNext) {
+    mallocSize += aSizes.mState.mMallocSizeOf(chunk);
+  }
 
   size_t totalSizeInFreeLists = 0;
   for (const FreeList* entry = mFreeLists;
@@ -189,8 +295,10 @@ nsPresArena::AddSizeOfExcludingThis(nsWindowSizes& aSizes) const
     // list here.  The free list knows how many objects we've allocated
     // ever (which includes any objects that may be on the FreeList's
     // |mEntries| at this point) and we're using that to determine the
-    // total size of objects allocated with a given ID.
+    // total size of objects allocated with a given ID.  The ones on the
+    // free list are reported apart from those in use.
     size_t totalSize = entry->mEntrySize * entry->mEntriesEverAllocated;
+    size_t freeSize = entry->mEntrySize * entry->mEntries.Length();
     size_t* p;
 
     switch (entry - mFreeLists) {
@@ -221,7 +329,8 @@ nsPresArena::AddSizeOfExcludingThis(nsWindowSizes& aSizes) const
         continue;
     }
 
-    *p += totalSize;
+    *p += totalSize - freeSize;
+    aSizes.mArenaSizes.mFreeObjects += freeSize;
     totalSizeInFreeLists += totalSize;
   }
 
@@ -10,7 +10,6 @@
 #ifndef nsPresArena_h___
 #define nsPresArena_h___
 
-#include "mozilla/ArenaAllocator.h"
 #include "mozilla/ArenaObjectID.h"
 #include "mozilla/ArenaRefPtr.h"
 #include "mozilla/MemoryChecking.h" // Note: Do not remove this, needed for MOZ_HAVE_MEM_CHECKS below
@@ -100,10 +99,44 @@ public:
    */
   void AddSizeOfExcludingThis(nsWindowSizes& aWindowSizes) const;
 
+  /**
+   * Release the chunks of the arena none of whose objects are in use, after
+   * dropping the freed objects in them from the recycler lists.  Objects in
+   * use are never moved.
+   */
+  void Trim();
+
 private:
   void* Allocate(uint32_t aCode, size_t aSize);
   void Free(uint32_t aCode, void* aPtr);
 
+  // The objects are carved out of chunks aligned to kChunkSize, so the chunk
+  // of an object can be found from its address.  Each chunk counts how many
+  // of its objects are in use, whatever their type.
+  struct Chunk
+  {
+    Chunk* mNext;
+    size_t mSize;
+    size_t mUsedCount;
+  };
+
+  static const size_t kChunkSize = 8192;
+  static const size_t kAlignment = 8;
+
+  static constexpr size_t AlignedSize(size_t aSize)
+  {
+    return (aSize + (kAlignment - 1)) & ~(kAlignment - 1);
+  }
+
+  static Chunk* ChunkFor(void* aPtr)
+  {
+    return reinterpret_cast<Chunk*>(uintptr_t(aPtr) & ~(kChunkSize - 1));
+  }
+
+  // Allocate a new object of aSize bytes from the chunks.
+  void* AllocateFromChunk(size_t aSize);
+  static void FreeChunk(Chunk* aChunk);
+
   inline void ClearArenaRefPtrWithoutDeregistering(
       void* aPtr,
       mozilla::ArenaObjectID aObjectID);
@@ -125,7 +158,13 @@ private:
   };
 
   FreeList mFreeLists[mozilla::eArenaObjectID_COUNT];
-  mozilla::ArenaAllocator<8192, 8> mPool;
+
+  Chunk* mChunks;
+  // New objects are allocated from the end of this chunk, between
+  // mCurrentPos and mCurrentEnd.
+  Chunk* mCurrentChunk;
+  char* mCurrentPos;
+  char* mCurrentEnd;
   nsDataHashtable<nsPtrHashKey<void>, mozilla::ArenaObjectID> mArenaRefPtrs;
 };
 
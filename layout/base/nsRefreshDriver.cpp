@@ -284,12 +284,14 @@ protected:
     Tick(jsnow, now);
   }
 
-  void TickRefreshDrivers(int64_t aJsNow, TimeStamp aNow, nsTArray<RefPtr<nsRefreshDriver>>& aDrivers)
+  // Returns the number of drivers ticked.
+  uint32_t TickRefreshDrivers(int64_t aJsNow, TimeStamp aNow, nsTArray<RefPtr<nsRefreshDriver>>& aDrivers)
   {
     if (aDrivers.IsEmpty()) {
-      return;
+      return 0;
     }
 
+    uint32_t ticked = 0;
     nsTArray<RefPtr<nsRefreshDriver> > drivers(aDrivers);
     for (nsRefreshDriver* driver : drivers) {
       // don't poke this driver if it's in test mode
@@ -298,9 +300,11 @@ protected:
       }
 
       TickDriver(driver, aJsNow, aNow);
+      ++ticked;
 
       mLastFireSkipped = mLastFireSkipped || driver->mSkippedPaints;
     }
+    return ticked;
   }
 
   /*
@@ -318,8 +322,18 @@ protected:
     // RD is short for RefreshDriver
     AutoProfilerTracing tracing("Paint", "RefreshDriverTick");
 
-    TickRefreshDrivers(jsnow, now, mContentRefreshDrivers);
-    TickRefreshDrivers(jsnow, now, mRootRefreshDrivers);
+    // All the drivers of the process on this timer share this one tick, so
+    // record what it costs as a whole.  |now| may be the time of the vsync,
+    // which can be a while ago.
+    TimeStamp tickStart = TimeStamp::Now();
+    uint32_t ticked = TickRefreshDrivers(jsnow, now, mContentRefreshDrivers);
+    ticked += TickRefreshDrivers(jsnow, now, mRootRefreshDrivers);
+    if (ticked) {
+      Telemetry::Accumulate(Telemetry::REFRESH_DRIVER_TIMER_TICK_DRIVERS,
+                            ticked);
+      Telemetry::AccumulateTimeDelta(Telemetry::REFRESH_DRIVER_TIMER_TICK,
+                                     tickStart);
+    }
 
     LOG("[%p] done.", this);
   }
@@ -327,7 +341,10 @@ protected:
   static void TickDriver(nsRefreshDriver* driver, int64_t jsnow, TimeStamp now)
   {
     LOG(">> TickDriver: %p (jsnow: %" PRId64 ")", driver, jsnow);
+    TimeStamp start = TimeStamp::Now();
     driver->Tick(jsnow, now);
+    LOG("<< TickDriver: %p took %.3fms", driver,
+        (TimeStamp::Now() - start).ToMilliseconds());
   }
 
   int64_t mLastFireEpoch;
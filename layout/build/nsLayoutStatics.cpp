@@ -16,6 +16,7 @@
 #include "nsContentUtils.h"
 #include "nsCSSAnonBoxes.h"
 #include "mozilla/css/ErrorReporter.h"
+#include "mozilla/css/Loader.h"
 #include "nsCSSKeywords.h"
 #include "nsCSSParser.h"
 #include "nsCSSProps.h"
@@ -325,6 +326,9 @@ nsLayoutStatics::Shutdown()
   // Don't need to shutdown nsWindowMemoryReporter, that will be done by the
   // memory reporter manager.
 
+  // The shared sheets may be Servo ones.
+  css::Loader::Shutdown();
+
 #ifdef MOZ_STYLO
   ShutdownServo();
   URLExtraData::ReleaseDummy();
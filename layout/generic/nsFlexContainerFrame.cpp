@@ -1591,13 +1591,14 @@ nsFlexContainerFrame::
 /**
  * A cached result for a measuring reflow.
  *
- * Right now we only need to cache the available size and the computed height
- * for checking that the reflow input is valid, and the height and the ascent
- * to be used. This can be extended later if needed.
+ * Right now we only need to cache the available size and the computed width
+ * and height for checking that the reflow input is valid, and the height and
+ * the ascent to be used. This can be extended later if needed.
  *
  * The assumption here is that a given flex item measurement won't change until
- * either the available size or computed height changes, or the flex container
- * intrinsic size is marked as dirty (due to a style or DOM change).
+ * either the available size or computed size changes, the flex container
+ * intrinsic size is marked as dirty (due to a style or DOM change), or
+ * something in the item's subtree needs reflow.
  *
  * In particular the computed height may change between measuring reflows due to
  * how the mIsFlexContainerMeasuringReflow flag affects size computation (see
@@ -1612,6 +1613,7 @@ class nsFlexContainerFrame::CachedMeasuringReflowResult
 {
   // Members that are part of the cache key:
   const LogicalSize mAvailableSize;
+  const nscoord mComputedWidth;
   const nscoord mComputedHeight;
 
   // Members that are part of the cache value:
@@ -1622,13 +1624,16 @@ public:
   CachedMeasuringReflowResult(const ReflowInput& aReflowInput,
                               const ReflowOutput& aDesiredSize)
     : mAvailableSize(aReflowInput.AvailableSize())
+    , mComputedWidth(aReflowInput.ComputedWidth())
     , mComputedHeight(aReflowInput.ComputedHeight())
     , mHeight(aDesiredSize.Height())
     , mAscent(aDesiredSize.BlockStartAscent())
   {}
 
   bool IsValidFor(const ReflowInput& aReflowInput) const {
-    return mAvailableSize == aReflowInput.AvailableSize() &&
+    return !NS_SUBTREE_DIRTY(aReflowInput.mFrame) &&
+      mAvailableSize == aReflowInput.AvailableSize() &&
+      mComputedWidth == aReflowInput.ComputedWidth() &&
       mComputedHeight == aReflowInput.ComputedHeight();
   }
 
@@ -1646,13 +1651,28 @@ nsFlexContainerFrame::MeasureAscentAndHeightForFlexItem(
   nsPresContext* aPresContext,
   ReflowInput& aChildReflowInput)
 {
+  // How many measuring reflows were needed and how many were avoided, to
+  // check the effect of the cache on nested flex containers.
+  static uint32_t sMeasuringReflows = 0;
+  static uint32_t sCachedMeasuringReflows = 0;
+
   if (const auto* cachedResult =
         aItem.Frame()->GetProperty(CachedFlexMeasuringReflow())) {
     if (cachedResult->IsValidFor(aChildReflowInput)) {
+      ++sCachedMeasuringReflows;
+      MOZ_LOG(gFlexContainerLog, LogLevel::Verbose,
+              ("Cached measuring reflow of flex item %p "
+               "(%u done, %u cached)\n",
+               aItem.Frame(), sMeasuringReflows, sCachedMeasuringReflows));
       return *cachedResult;
     }
   }
 
+  ++sMeasuringReflows;
+  MOZ_LOG(gFlexContainerLog, LogLevel::Verbose,
+          ("Measuring reflow of flex item %p (%u done, %u cached)\n",
+           aItem.Frame(), sMeasuringReflows, sCachedMeasuringReflows));
+
   ReflowOutput childDesiredSize(aChildReflowInput);
   nsReflowStatus childReflowStatus;
 
@@ -12,6 +12,7 @@
 #include <functional>
 #include <limits>
 #include "gfxContext.h"
+#include "GeckoProfiler.h"
 #include "mozilla/CSSAlignUtils.h"
 #include "mozilla/CSSOrderAwareFrameIterator.h"
 #include "mozilla/dom/GridBinding.h"
@@ -3440,6 +3441,56 @@ nsGridContainerFrame::Tracks::Initialize(
   mContentBoxSize = aContentBoxSize;
 }
 
+/**
+ * The result of a MeasuringReflow of a grid item, stored on the item so that
+ * measuring it again with the same constraints doesn't reflow it.  This
+ * happens a lot in incremental reflows, e.g. when the grid container is
+ * resized but most of its tracks keep their sizes.  It stays valid as long
+ * as the item's subtree isn't dirty.
+ */
+class CachedBAxisMeasurement
+{
+public:
+  NS_DECLARE_FRAME_PROPERTY_DELETABLE(Prop, CachedBAxisMeasurement)
+
+  CachedBAxisMeasurement(bool                aHasReflowInput,
+                         const LogicalSize&  aAvailableSize,
+                         const LogicalSize&  aCBSize,
+                         nscoord             aIMinSizeClamp,
+                         nscoord             aBMinSizeClamp,
+                         nscoord             aBSize)
+    : mHasReflowInput(aHasReflowInput)
+    , mAvailableSize(aAvailableSize)
+    , mCBSize(aCBSize)
+    , mIMinSizeClamp(aIMinSizeClamp)
+    , mBMinSizeClamp(aBMinSizeClamp)
+    , mBSize(aBSize)
+  {}
+
+  bool Matches(bool                aHasReflowInput,
+               const LogicalSize&  aAvailableSize,
+               const LogicalSize&  aCBSize,
+               nscoord             aIMinSizeClamp,
+               nscoord             aBMinSizeClamp) const
+  {
+    return mHasReflowInput == aHasReflowInput &&
+           mAvailableSize == aAvailableSize &&
+           mCBSize == aCBSize &&
+           mIMinSizeClamp == aIMinSizeClamp &&
+           mBMinSizeClamp == aBMinSizeClamp;
+  }
+
+  nscoord BSize() const { return mBSize; }
+
+private:
+  bool mHasReflowInput;
+  LogicalSize mAvailableSize;
+  LogicalSize mCBSize;
+  nscoord mIMinSizeClamp;
+  nscoord mBMinSizeClamp;
+  nscoord mBSize;
+};
+
 /**
  * Reflow aChild in the given aAvailableSize.
  */
@@ -3452,6 +3503,15 @@ MeasuringReflow(nsIFrame*           aChild,
                 nscoord             aIMinSizeClamp = NS_MAXSIZE,
                 nscoord             aBMinSizeClamp = NS_MAXSIZE)
 {
+  const bool hasReflowInput = !!aReflowInput;
+  if (!NS_SUBTREE_DIRTY(aChild)) {
+    auto* cached = aChild->GetProperty(CachedBAxisMeasurement::Prop());
+    if (cached && cached->Matches(hasReflowInput, aAvailableSize, aCBSize,
+                                  aIMinSizeClamp, aBMinSizeClamp)) {
+      return cached->BSize();
+    }
+  }
+
   nsContainerFrame* parent = aChild->GetParent();
   nsPresContext* pc = aChild->PresContext();
   Maybe<ReflowInput> dummyParentState;
@@ -3505,7 +3565,13 @@ MeasuringReflow(nsIFrame*           aChild,
 #ifdef DEBUG
     parent->DeleteProperty(nsContainerFrame::DebugReflowingWithInfiniteISize());
 #endif
-  return childSize.BSize(wm);
+  nscoord bSize = childSize.BSize(wm);
+  aChild->SetProperty(CachedBAxisMeasurement::Prop(),
+                      new CachedBAxisMeasurement(hasReflowInput,
+                                                 aAvailableSize, aCBSize,
+                                                 aIMinSizeClamp,
+                                                 aBMinSizeClamp, bSize));
+  return bSize;
 }
 
 /**
@@ -3722,6 +3788,8 @@ nsGridContainerFrame::Tracks::CalculateSizes(
   LineRange GridArea::*       aRange,
   SizingConstraint            aConstraint)
 {
+  AUTO_PROFILER_LABEL("nsGridContainerFrame::Tracks::CalculateSizes",
+                      GRAPHICS);
   nscoord percentageBasis = aContentBoxSize;
   if (percentageBasis == NS_UNCONSTRAINEDSIZE) {
     percentageBasis = 0;
@@ -5758,6 +5826,8 @@ nsGridContainerFrame::Reflow(nsPresContext*           aPresContext,
   MarkInReflow();
   DO_GLOBAL_REFLOW_COUNT("nsGridContainerFrame");
   DISPLAY_REFLOW(aPresContext, this, aReflowInput, aDesiredSize, aStatus);
+  AUTO_PROFILER_LABEL("nsGridContainerFrame::Reflow", GRAPHICS);
+  AutoProfilerTracing tracing("Reflow", "Grid");
 
   if (IsFrameTreeTooDeep(aReflowInput, aDesiredSize, aStatus)) {
     return;
@@ -6308,6 +6378,7 @@ nscoord
 nsGridContainerFrame::IntrinsicISize(gfxContext* aRenderingContext,
                                      IntrinsicISizeType  aType)
 {
+  AUTO_PROFILER_LABEL("nsGridContainerFrame::IntrinsicISize", GRAPHICS);
   RenumberList();
 
   // Calculate the sum of column sizes under intrinsic sizing.
@@ -741,7 +741,12 @@ public:
   void SetLayerTreeCompressionMode() { mInLayerTreeCompressionMode = true; }
   bool CheckInLayerTreeCompressionMode();
 
-  void ComputeGeometryChangeForItem(DisplayItemData* aData);
+  // Returns false if the item needs no invalidation.
+  bool ComputeGeometryChangeForItem(DisplayItemData* aData);
+
+  // Called when a painted item is assigned a different layer from the one
+  // it was in at the last paint.
+  void NoteItemChangedLayer() { ++mItemsChangedLayerCount; }
 
 protected:
   /**
@@ -802,6 +807,8 @@ protected:
 
   uint32_t                            mContainerLayerGeneration;
   uint32_t                            mMaxContainerLayerGeneration;
+
+  uint32_t                            mItemsChangedLayerCount;
 };
 
 } // namespace mozilla
@@ -437,6 +437,7 @@ void nsCSSRendering::Shutdown()
 {
   delete gInlineBGData;
   gInlineBGData = nullptr;
+  nsCSSBorderRenderer::Shutdown();
 }
 
 /**
@@ -11,6 +11,9 @@
 #include "mozilla/gfx/2D.h"
 #include "mozilla/gfx/Helpers.h"
 #include "mozilla/gfx/PathHelpers.h"
+#include "mozilla/HashFunctions.h"
+#include "mozilla/PodOperations.h"
+#include "mozilla/SystemGroup.h"
 #include "BorderConsts.h"
 #include "DashedCornerFinder.h"
 #include "DottedCornerFinder.h"
@@ -169,6 +172,150 @@ typedef enum {
   CORNER_DOT
 } CornerStyle;
 
+// Corners bigger than this in either dimension aren't cached; they are rare,
+// and the surfaces would take up a lot of memory.
+static const int32_t kMaxCachedBorderCornerSize = 64;
+
+/**
+ * Key for a surface holding the four rasterized corners of a solid rounded
+ * border of a single color. The surface is the border of the smallest box
+ * that fits all four corners, so it is the same for every box with the same
+ * widths, radii and color, whatever its size.
+ */
+struct BorderCornerCacheKey : public PLDHashEntryHdr {
+  typedef const BorderCornerCacheKey& KeyType;
+  typedef const BorderCornerCacheKey* KeyTypePointer;
+  enum { ALLOW_MEMMOVE = true };
+
+  IntSize mMinSize;
+  RectCornerRadii mRadii;
+  Float mWidths[4];
+  nscolor mColor;
+  BackendType mBackend;
+
+  BorderCornerCacheKey(const IntSize& aMinSize,
+                       const RectCornerRadii& aRadii,
+                       const Float* aWidths,
+                       nscolor aColor,
+                       BackendType aBackend)
+    : mMinSize(aMinSize)
+    , mRadii(aRadii)
+    , mColor(aColor)
+    , mBackend(aBackend)
+  {
+    PodCopy(mWidths, aWidths, 4);
+  }
+
+  explicit BorderCornerCacheKey(const BorderCornerCacheKey* aOther)
+    : BorderCornerCacheKey(aOther->mMinSize, aOther->mRadii, aOther->mWidths,
+                           aOther->mColor, aOther->mBackend)
+  {}
+
+  static PLDHashNumber
+  HashKey(const KeyTypePointer aKey)
+  {
+    PLDHashNumber hash = HashGeneric(aKey->mMinSize.width,
+                                     aKey->mMinSize.height,
+                                     aKey->mColor,
+                                     uint32_t(aKey->mBackend));
+    hash = AddToHash(hash, HashBytes(aKey->mWidths, sizeof(aKey->mWidths)));
+    NS_FOR_CSS_FULL_CORNERS(i) {
+      hash = AddToHash(hash, HashBytes(&aKey->mRadii[i], sizeof(Size)));
+    }
+    return hash;
+  }
+
+  bool
+  KeyEquals(KeyTypePointer aKey) const
+  {
+    return aKey->mMinSize == mMinSize &&
+           aKey->mRadii == mRadii &&
+           PodEqual(aKey->mWidths, mWidths, 4) &&
+           aKey->mColor == mColor &&
+           aKey->mBackend == mBackend;
+  }
+
+  static KeyTypePointer
+  KeyToPointer(KeyType aKey)
+  {
+    return &aKey;
+  }
+};
+
+struct BorderCornerCacheData {
+  BorderCornerCacheData(SourceSurface* aSurface,
+                        const BorderCornerCacheKey& aKey)
+    : mSurface(aSurface)
+    , mKey(aKey)
+  {}
+
+  nsExpirationState* GetExpirationState() {
+    return &mExpirationState;
+  }
+
+  nsExpirationState mExpirationState;
+  RefPtr<SourceSurface> mSurface;
+  BorderCornerCacheKey mKey;
+};
+
+/**
+ * A cache of rasterized border corners, shared by every border on every page
+ * so that repeated identically-styled boxes don't each rebuild and fill the
+ * same curved paths. An entry stays in the cache as long as it is used often.
+ */
+class BorderCornerCache final
+  : public nsExpirationTracker<BorderCornerCacheData, 4>
+{
+public:
+  BorderCornerCache()
+    : nsExpirationTracker<BorderCornerCacheData, 4>(
+        GENERATION_MS, "BorderCornerCache",
+        SystemGroup::EventTargetFor(TaskCategory::Other))
+  {}
+
+  virtual void NotifyExpired(BorderCornerCacheData* aObject) override
+  {
+    RemoveObject(aObject);
+    mHashEntries.Remove(aObject->mKey);
+  }
+
+  SourceSurface* Lookup(const BorderCornerCacheKey& aKey)
+  {
+    BorderCornerCacheData* data = mHashEntries.Get(aKey);
+    if (!data) {
+      return nullptr;
+    }
+    MarkUsed(data);
+    return data->mSurface;
+  }
+
+  void Register(const BorderCornerCacheKey& aKey, SourceSurface* aSurface)
+  {
+    BorderCornerCacheData* data = new BorderCornerCacheData(aSurface, aKey);
+    // If we can't track the entry, don't keep it in the table either, as
+    // nothing would ever remove it.
+    if (NS_FAILED(AddObject(data))) {
+      delete data;
+      return;
+    }
+    mHashEntries.Put(aKey, data);
+  }
+
+private:
+  static const uint32_t GENERATION_MS = 1000;
+
+  nsClassHashtable<BorderCornerCacheKey, BorderCornerCacheData> mHashEntries;
+};
+
+static BorderCornerCache* gBorderCornerCache = nullptr;
+
+/* static */ void
+nsCSSBorderRenderer::Shutdown()
+{
+  delete gBorderCornerCache;
+  gBorderCornerCache = nullptr;
+}
+
 nsCSSBorderRenderer::nsCSSBorderRenderer(nsPresContext* aPresContext,
                                          const nsIDocument* aDocument,
                                          DrawTarget* aDrawTarget,
@@ -3190,6 +3337,126 @@ nsCSSBorderRenderer::DrawRectangularCompositeColors()
   }
 }
 
+bool
+nsCSSBorderRenderer::DrawSolidBorderWithCachedCorners()
+{
+  // We can only reuse rasterized corners if they are drawn at the same
+  // subpixel offset every time, and if the draw target doesn't just record
+  // the commands for replaying somewhere else.
+  if (mDrawTarget->IsRecording() ||
+      mOuterRect.X() != floor(mOuterRect.X()) ||
+      mOuterRect.Y() != floor(mOuterRect.Y()) ||
+      mOuterRect.Width() != floor(mOuterRect.Width()) ||
+      mOuterRect.Height() != floor(mOuterRect.Height())) {
+    return false;
+  }
+
+  // The box at each corner that holds everything that isn't a straight band
+  // of one of the two adjacent sides.
+  IntSize cornerSizes[4];
+  NS_FOR_CSS_FULL_CORNERS(i) {
+    cornerSizes[i] = IntSize::Ceil(
+      std::max(mBorderRadii[i].width, mBorderWidths[GetVerticalSide(i)]),
+      std::max(mBorderRadii[i].height, mBorderWidths[GetHorizontalSide(i)]));
+    if (cornerSizes[i].width > kMaxCachedBorderCornerSize ||
+        cornerSizes[i].height > kMaxCachedBorderCornerSize) {
+      return false;
+    }
+  }
+
+  IntSize minSize(
+    std::max(cornerSizes[C_TL].width, cornerSizes[C_BL].width) +
+      std::max(cornerSizes[C_TR].width, cornerSizes[C_BR].width),
+    std::max(cornerSizes[C_TL].height, cornerSizes[C_TR].height) +
+      std::max(cornerSizes[C_BL].height, cornerSizes[C_BR].height));
+  // If the corners meet or overlap there is nothing to save, and the straight
+  // bands drawn below would have negative lengths.
+  if (minSize.width >= mOuterRect.Width() ||
+      minSize.height >= mOuterRect.Height()) {
+    return false;
+  }
+
+  if (!gBorderCornerCache) {
+    gBorderCornerCache = new BorderCornerCache();
+  }
+
+  nscolor borderColor = mBorderColors[eSideTop];
+  BorderCornerCacheKey key(minSize, mBorderRadii, mBorderWidths, borderColor,
+                           mDrawTarget->GetBackendType());
+  RefPtr<SourceSurface> corners = gBorderCornerCache->Lookup(key);
+  if (!corners) {
+    RefPtr<DrawTarget> dt =
+      mDrawTarget->CreateSimilarDrawTarget(minSize, SurfaceFormat::B8G8R8A8);
+    if (!dt || !dt->IsValid()) {
+      return false;
+    }
+
+    Rect outerRect(Point(0, 0), Size(minSize));
+    Rect innerRect(outerRect);
+    innerRect.Deflate(Margin(mBorderWidths[eSideTop],
+                             mBorderWidths[eSideRight],
+                             mBorderWidths[eSideBottom],
+                             mBorderWidths[eSideLeft]));
+    RectCornerRadii innerRadii;
+    ComputeInnerRadii(mBorderRadii, mBorderWidths, &innerRadii);
+
+    RefPtr<PathBuilder> builder = dt->CreatePathBuilder();
+    AppendRoundedRectToPath(builder, outerRect, mBorderRadii, true);
+    AppendRoundedRectToPath(builder, innerRect, innerRadii, false);
+    RefPtr<Path> path = builder->Finish();
+    dt->Fill(path, ColorPattern(ToDeviceColor(borderColor)));
+
+    corners = dt->Snapshot();
+    if (!corners) {
+      return false;
+    }
+    if (RefPtr<SourceSurface> opt = mDrawTarget->OptimizeSourceSurface(corners)) {
+      corners = opt;
+    }
+    gBorderCornerCache->Register(key, corners);
+  }
+
+  // Copy each corner from the corresponding corner of the cached surface.
+  Rect srcRect(Point(0, 0), Size(minSize));
+  DrawSurfaceOptions surfaceOptions(SamplingFilter::POINT);
+  NS_FOR_CSS_FULL_CORNERS(i) {
+    Size size(cornerSizes[i]);
+    Point srcOrigin(i == C_TL || i == C_BL ? 0 : srcRect.XMost() - size.width,
+                    i == C_TL || i == C_TR ? 0 : srcRect.YMost() - size.height);
+    Point destOrigin(
+      i == C_TL || i == C_BL ? mOuterRect.X() : mOuterRect.XMost() - size.width,
+      i == C_TL || i == C_TR ? mOuterRect.Y() : mOuterRect.YMost() - size.height);
+    mDrawTarget->DrawSurface(corners, Rect(destOrigin, size),
+                             Rect(srcOrigin, size), surfaceOptions);
+  }
+
+  // And fill the straight bands of the sides in between.
+  ColorPattern color(ToDeviceColor(borderColor));
+  Float top = mOuterRect.Y();
+  Float right = mOuterRect.XMost();
+  Float bottom = mOuterRect.YMost();
+  Float left = mOuterRect.X();
+  mDrawTarget->FillRect(
+    Rect(left + cornerSizes[C_TL].width, top,
+         mOuterRect.Width() - cornerSizes[C_TL].width - cornerSizes[C_TR].width,
+         mBorderWidths[eSideTop]), color);
+  mDrawTarget->FillRect(
+    Rect(right - mBorderWidths[eSideRight], top + cornerSizes[C_TR].height,
+         mBorderWidths[eSideRight],
+         mOuterRect.Height() - cornerSizes[C_TR].height - cornerSizes[C_BR].height),
+    color);
+  mDrawTarget->FillRect(
+    Rect(left + cornerSizes[C_BL].width, bottom - mBorderWidths[eSideBottom],
+         mOuterRect.Width() - cornerSizes[C_BL].width - cornerSizes[C_BR].width,
+         mBorderWidths[eSideBottom]), color);
+  mDrawTarget->FillRect(
+    Rect(left, top + cornerSizes[C_TL].height,
+         mBorderWidths[eSideLeft],
+         mOuterRect.Height() - cornerSizes[C_TL].height - cornerSizes[C_BL].height),
+    color);
+  return true;
+}
+
 void
 nsCSSBorderRenderer::DrawBorders()
 {
@@ -3282,6 +3549,10 @@ nsCSSBorderRenderer::DrawBorders()
       !mNoBorderRadius)
   {
     // Relatively simple case.
+    if (!mat.HasNonTranslation() && DrawSolidBorderWithCachedCorners()) {
+      return;
+    }
+
     gfxRect outerRect = ThebesRect(mOuterRect);
     RoundedRect borderInnerRect(outerRect, mBorderRadii);
     borderInnerRect.Deflate(mBorderWidths[eSideTop],
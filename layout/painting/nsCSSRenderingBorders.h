@@ -125,6 +125,9 @@ public:
 
   static bool AllCornersZeroSize(const RectCornerRadii& corners);
 
+  // Releases the cache of rasterized border corners.
+  static void Shutdown();
+
 private:
 
   RectCornerRadii mBorderCornerDimensions;
@@ -259,6 +262,12 @@ private:
   void DrawFallbackSolidCorner(mozilla::Side aSide,
                                mozilla::Corner aCorner);
 
+  // Draw a solid rounded border of a single color by copying its corners
+  // from a cached surface and filling the straight parts of the sides.
+  // Returns false, having drawn nothing, if the border can't be drawn this
+  // way; it must be pixel-aligned and have small enough corners.
+  bool DrawSolidBorderWithCachedCorners();
+
   // Analyze if all border sides have the same width.
   bool AllBordersSameWidth();
 
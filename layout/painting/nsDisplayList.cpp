@@ -60,6 +60,7 @@
 #include "mozilla/LookAndFeel.h"
 #include "mozilla/OperatorNewExtensions.h"
 #include "mozilla/PendingAnimationTracker.h"
+#include "mozilla/PodOperations.h"
 #include "mozilla/Preferences.h"
 #include "mozilla/StyleAnimationValue.h"
 #include "mozilla/ServoBindings.h"
@@ -938,6 +939,7 @@ nsDisplayListBuilder::nsDisplayListBuilder(nsIFrame* aReferenceFrame,
       mHitTestShouldStopAtFirstOpaque(false)
 {
   MOZ_COUNT_CTOR(nsDisplayListBuilder);
+  PodArrayZero(mFreeLists);
 
   nsPresContext* pc = aReferenceFrame->PresContext();
   nsIPresShell *shell = pc->PresShell();
@@ -1343,15 +1345,50 @@ nsDisplayListBuilder::MarkPreserve3DFramesForDisplayList(nsIFrame* aDirtyFrame)
   }
 }
 
+static size_t&
+AllocationSize(void* aPtr, size_t aHeaderSize)
+{
+  return *reinterpret_cast<size_t*>(static_cast<char*>(aPtr) - aHeaderSize);
+}
+
 void*
 nsDisplayListBuilder::Allocate(size_t aSize, DisplayItemType aType)
 {
-  return mPool.Allocate(aSize);
+  static_assert(sizeof(size_t) <= kArenaAlignment,
+                "The allocation header must fit in the arena's alignment");
+  uint32_t index = static_cast<uint32_t>(aType);
+  MOZ_ASSERT(index < ArrayLength(mFreeLists));
+
+  // Items of a type nearly always have the same size, so only the most
+  // recently destroyed one is considered.
+  void* freed = mFreeLists[index];
+  if (freed && AllocationSize(freed, kArenaAlignment) >= aSize) {
+    mFreeLists[index] = *static_cast<void**>(freed);
+    return freed;
+  }
+
+  char* p = static_cast<char*>(mPool.Allocate(kArenaAlignment + aSize));
+  p += kArenaAlignment;
+  AllocationSize(p, kArenaAlignment) = aSize;
+  return p;
 }
 
 void
 nsDisplayListBuilder::Destroy(DisplayItemType aType, void* aPtr)
 {
+  uint32_t index = static_cast<uint32_t>(aType);
+  MOZ_ASSERT(index < ArrayLength(mFreeLists));
+  size_t size = AllocationSize(aPtr, kArenaAlignment);
+  if (size < sizeof(void*)) {
+    return;
+  }
+
+#ifdef DEBUG
+  // Make use of a destroyed item more likely to crash.
+  memset(aPtr, 0xE5, size);
+#endif
+  *static_cast<void**>(aPtr) = mFreeLists[index];
+  mFreeLists[index] = aPtr;
 }
 
 ActiveScrolledRoot*
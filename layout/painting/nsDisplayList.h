@@ -747,9 +747,14 @@ public:
    * Allocate memory in our arena. It will only be freed when this display list
    * builder is destroyed. This memory holds nsDisplayItems. nsDisplayItem
    * destructors are called as soon as the item is no longer used.
+   * Memory returned by Destroy is reused for items of the same type.
    */
   void* Allocate(size_t aSize, DisplayItemType aType);
 
+  /**
+   * Return the memory of an item that has been destructed, so that it can be
+   * reused by the next item of the same type that fits in it.
+   */
   void Destroy(DisplayItemType aType, void* aPtr);
 
   /**
@@ -1487,6 +1492,10 @@ private:
   static const size_t kArenaAlignment =
       mozilla::tl::Max<NS_ALIGNMENT_OF(void*), NS_ALIGNMENT_OF(double)>::value;
   mozilla::ArenaAllocator<4096, kArenaAlignment> mPool;
+  // Destroyed items, by type. Every allocation is preceded by a header of
+  // kArenaAlignment bytes holding its size, and the first word of a freed
+  // block links to the next one.
+  void* mFreeLists[static_cast<uint32_t>(DisplayItemType::TYPE_MAX)];
 
   nsCOMPtr<nsISelection>         mBoundingSelection;
   AutoTArray<PresShellState,8> mPresShellStates;
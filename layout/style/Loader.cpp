@@ -62,6 +62,9 @@
 #include "mozilla/StyleSheetInlines.h"
 #include "mozilla/ConsoleReportCollector.h"
 #include "mozilla/ServoUtils.h"
+#include "mozilla/StaticPtr.h"
+#include "nsClassHashtable.h"
+#include "nsICacheInfoChannel.h"
 
 #ifdef MOZ_XUL
 #include "nsXULPrototypeCache.h"
@@ -194,6 +197,10 @@ public:
   // Number of sheets we @import-ed that are still loading
   uint32_t                   mPendingChildren;
 
+  // Until when, in seconds since the epoch, the response may be used
+  // without revalidating it.  0 if it can't be shared with other documents.
+  uint32_t                   mExpirationTime;
+
   // mSyncLoad is true when the load needs to be synchronous -- right
   // now only for LoadSheetSync and children of sync loads.
   bool                       mSyncLoad : 1;
@@ -295,6 +302,106 @@ static const char* const gStateStrings[] = {
   "eSheetComplete"
 };
 
+/*************************************
+ * Sheets shared between documents   *
+ *************************************/
+
+// Complete sheets loaded by documents, kept so that the other documents of
+// the process loading the same URI with the same principal, CORS mode and
+// referrer policy can clone them instead of parsing them again.  The clones
+// share their rules until they are modified through CSSOM.
+struct SharedSheet
+{
+  RefPtr<StyleSheet> mSheet;
+  // Quirks mode changes how a sheet is parsed.
+  nsCompatibility    mCompatMode;
+  uint32_t           mExpirationTime;
+  uint32_t           mLastUse;
+};
+
+typedef nsClassHashtable<URIPrincipalReferrerPolicyAndCORSModeHashKey,
+                         SharedSheet> SharedSheetTable;
+
+static StaticAutoPtr<SharedSheetTable> sSharedSheets;
+static uint32_t sSharedSheetUses = 0;
+
+// The least recently used sheet is dropped when adding one more.
+static const uint32_t kMaxSharedSheets = 64;
+
+static uint32_t
+CurrentTimeInSeconds()
+{
+  return uint32_t(PR_Now() / PR_USEC_PER_SEC);
+}
+
+static StyleSheet*
+GetSharedSheet(URIPrincipalReferrerPolicyAndCORSModeHashKey* aKey,
+               StyleBackendType aType,
+               nsCompatibility aCompatMode)
+{
+  if (!sSharedSheets) {
+    return nullptr;
+  }
+  SharedSheet* shared = sSharedSheets->Get(aKey);
+  if (!shared) {
+    return nullptr;
+  }
+  if (shared->mExpirationTime <= CurrentTimeInSeconds()) {
+    sSharedSheets->Remove(aKey);
+    return nullptr;
+  }
+  if (shared->mSheet->IsServo() != (aType == StyleBackendType::Servo) ||
+      shared->mCompatMode != aCompatMode) {
+    return nullptr;
+  }
+  shared->mLastUse = ++sSharedSheetUses;
+  return shared->mSheet;
+}
+
+static void
+PutSharedSheet(URIPrincipalReferrerPolicyAndCORSModeHashKey* aKey,
+               StyleSheet* aSheet,
+               nsCompatibility aCompatMode,
+               uint32_t aExpirationTime)
+{
+  // Keep a clone, which doesn't know about the document of aSheet.
+  RefPtr<StyleSheet> clone = aSheet->Clone(nullptr, nullptr, nullptr, nullptr);
+  if (!clone) {
+    return;
+  }
+
+  if (!sSharedSheets) {
+    sSharedSheets = new SharedSheetTable();
+  }
+  if (!sSharedSheets->Contains(aKey) &&
+      sSharedSheets->Count() >= kMaxSharedSheets) {
+    uint32_t oldestUse = UINT32_MAX;
+    for (auto iter = sSharedSheets->Iter(); !iter.Done(); iter.Next()) {
+      if (iter.Data()->mLastUse < oldestUse) {
+        oldestUse = iter.Data()->mLastUse;
+      }
+    }
+    for (auto iter = sSharedSheets->Iter(); !iter.Done(); iter.Next()) {
+      if (iter.Data()->mLastUse == oldestUse) {
+        iter.Remove();
+        break;
+      }
+    }
+  }
+
+  SharedSheet* shared = sSharedSheets->LookupOrAdd(aKey);
+  shared->mSheet = clone.forget();
+  shared->mCompatMode = aCompatMode;
+  shared->mExpirationTime = aExpirationTime;
+  shared->mLastUse = ++sSharedSheetUses;
+}
+
+/* static */ void
+Loader::Shutdown()
+{
+  sSharedSheets = nullptr;
+}
+
 /********************************
  * SheetLoadData implementation *
  ********************************/
@@ -317,6 +424,7 @@ SheetLoadData::SheetLoadData(Loader* aLoader,
     mSheet(aSheet),
     mNext(nullptr),
     mPendingChildren(0),
+    mExpirationTime(0),
     mSyncLoad(false),
     mIsNonDocumentSheet(false),
     mIsLoading(false),
@@ -347,6 +455,7 @@ SheetLoadData::SheetLoadData(Loader* aLoader,
     mNext(nullptr),
     mParentData(aParentData),
     mPendingChildren(0),
+    mExpirationTime(0),
     mSyncLoad(false),
     mIsNonDocumentSheet(false),
     mIsLoading(false),
@@ -387,6 +496,7 @@ SheetLoadData::SheetLoadData(Loader* aLoader,
     mSheet(aSheet),
     mNext(nullptr),
     mPendingChildren(0),
+    mExpirationTime(0),
     mSyncLoad(aSyncLoad),
     mIsNonDocumentSheet(true),
     mIsLoading(false),
@@ -896,6 +1006,20 @@ SheetLoadData::OnStreamComplete(nsIUnicharStreamLoader* aLoader,
     if (nsContentUtils::GetSourceMapURL(httpChannel, sourceMapURL)) {
       mSheet->SetSourceMapURL(NS_ConvertUTF8toUTF16(sourceMapURL));
     }
+
+    // Other documents may reuse the parsed sheet for as long as the HTTP
+    // cache would have let them reuse the response, unless we were
+    // redirected.
+    nsCOMPtr<nsICacheInfoChannel> cacheInfo(do_QueryInterface(channel));
+    bool noStore = false, noCache = false, sameURI = false;
+    httpChannel->IsNoStoreResponse(&noStore);
+    httpChannel->IsNoCacheResponse(&noCache);
+    uint32_t expirationTime;
+    if (cacheInfo && !noStore && !noCache &&
+        NS_SUCCEEDED(channelURI->Equals(mURI, &sameURI)) && sameURI &&
+        NS_SUCCEEDED(cacheInfo->GetCacheTokenExpirationTime(&expirationTime))) {
+      mExpirationTime = expirationTime;
+    }
   }
 
   nsAutoCString contentType;
@@ -1139,6 +1263,7 @@ Loader::CreateSheet(nsIURI* aURI,
 #endif
 
     bool fromCompleteSheets = false;
+    bool fromSharedSheets = false;
     if (!sheet) {
       // Then our per-document complete sheets.
       URIPrincipalReferrerPolicyAndCORSModeHashKey key(aURI, aLoaderPrincipal, aCORSMode, aReferrerPolicy);
@@ -1149,6 +1274,15 @@ Loader::CreateSheet(nsIURI* aURI,
       LOG(("  From completed: %p", sheet.get()));
 
       fromCompleteSheets = !!sheet;
+
+      // Then the ones completed by other documents.  A sheet whose
+      // integrity must be checked is always fetched.
+      if (!sheet && mDocument && aLoaderPrincipal && aIntegrity.IsEmpty()) {
+        sheet = GetSharedSheet(&key, GetStyleBackendType(), mCompatMode);
+        LOG(("  From shared: %p", sheet.get()));
+
+        fromSharedSheets = !!sheet;
+      }
     }
 
     if (sheet) {
@@ -1163,6 +1297,7 @@ Loader::CreateSheet(nsIURI* aURI,
              sheet.get()));
         sheet = nullptr;
         fromCompleteSheets = false;
+        fromSharedSheets = false;
       }
     }
 
@@ -1232,6 +1367,10 @@ Loader::CreateSheet(nsIURI* aURI,
         NS_ASSERTION((*aSheet)->IsComplete(),
                      "Should only be caching complete sheets");
         mSheets->mCompleteSheets.Put(&key, *aSheet);
+      } else if (*aSheet && fromSharedSheets) {
+        // Later loads by this document can use its own copy.
+        URIPrincipalReferrerPolicyAndCORSModeHashKey key(aURI, aLoaderPrincipal, aCORSMode, aReferrerPolicy);
+        mSheets->mCompleteSheets.Put(&key, *aSheet);
       }
     }
   }
@@ -1972,6 +2111,11 @@ Loader::DoSheetComplete(SheetLoadData* aLoadData, nsresult aStatus,
       NS_ASSERTION(sheet->IsComplete(),
                    "Should only be caching complete sheets");
       mSheets->mCompleteSheets.Put(&key, sheet);
+      if (mDocument && !aLoadData->mIsNonDocumentSheet &&
+          aLoadData->mLoaderPrincipal && !sheet->IsModified() &&
+          aLoadData->mExpirationTime > CurrentTimeInSeconds()) {
+        PutSharedSheet(&key, sheet, mCompatMode, aLoadData->mExpirationTime);
+      }
 #ifdef MOZ_XUL
     }
 #endif
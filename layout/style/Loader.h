@@ -208,6 +208,10 @@ public:
 
   void DropDocumentReference(); // notification that doc is going away
 
+  // Release the complete sheets shared between the documents of this
+  // process.  Called at layout shutdown.
+  static void Shutdown();
+
   void SetCompatibilityMode(nsCompatibility aCompatMode)
   { mCompatMode = aCompatMode; }
   nsCompatibility GetCompatibilityMode() { return mCompatMode; }
@@ -11,6 +11,7 @@
 
 #include "nsCSSRuleProcessor.h"
 
+#include "mozilla/ArenaAllocator.h"
 #include "nsAutoPtr.h"
 #include "nsRuleProcessorData.h"
 #include <algorithm>
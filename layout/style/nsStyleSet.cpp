@@ -225,7 +225,9 @@ nsStyleSet::nsStyleSet()
 #ifdef DEBUG
     mOldRootNode(nullptr),
 #endif
-    mUnusedRuleNodeCount(0)
+    mUnusedRuleNodeCount(0),
+    mSharedStyleContextCount(0),
+    mCreatedStyleContextCount(0)
 {
 }
 
@@ -925,6 +927,8 @@ nsStyleSet::GetContext(GeckoStyleContext* aParentContext,
                                                 relevantLinkVisited);
 
   if (!result) {
+    ++mCreatedStyleContextCount;
+
     // |aVisitedRuleNode| may have a ref-count of zero since we are yet
     // to create the style context that will hold an owning reference to it.
     // As a result, we need to make sure it stays alive until that point
@@ -949,6 +953,7 @@ nsStyleSet::GetContext(GeckoStyleContext* aParentContext,
     }
   }
   else {
+    ++mSharedStyleContextCount;
     NS_ASSERTION(result->GetPseudoType() == aPseudoType, "Unexpected type");
     NS_ASSERTION(result->GetPseudo() == aPseudoTag, "Unexpected pseudo");
   }
@@ -503,6 +503,14 @@ class nsStyleSet final
     mUsesViewportUnits = aValue;
   }
 
+  // How many resolved style contexts were shared with an existing child of
+  // their parent context, and how many had to be created, since the style
+  // set was initialized.
+  uint32_t SharedStyleContextCount() const { return mSharedStyleContextCount; }
+  uint32_t CreatedStyleContextCount() const {
+    return mCreatedStyleContextCount;
+  }
+
 private:
   nsStyleSet(const nsStyleSet& aCopy) = delete;
   nsStyleSet& operator=(const nsStyleSet& aCopy) = delete;
@@ -666,6 +674,9 @@ private:
   mozilla::LinkedList<nsRuleNode> mUnusedRuleNodeList;
   uint32_t mUnusedRuleNodeCount;
 
+  uint32_t mSharedStyleContextCount;
+  uint32_t mCreatedStyleContextCount;
+
   // Empty style rules to force things that restrict which properties
   // apply into different branches of the rule tree.
   RefPtr<nsEmptyStyleRule> mFirstLineRule, mFirstLetterRule, mPlaceholderRule;
@@ -13,6 +13,7 @@
  *   - jemalloc_purge_freed_pages
  *   - jemalloc_free_dirty_pages
  *   - jemalloc_thread_local_arena
+ *   - moz_create_arena and the moz_arena_* functions
  */
 
 #ifndef MOZ_MEMORY
@@ -87,4 +88,31 @@ MOZ_JEMALLOC_API void jemalloc_free_dirty_pages();
 
 MOZ_JEMALLOC_API void jemalloc_thread_local_arena(jemalloc_bool enabled);
 
+/*
+ * Create a new arena, for a subsystem to allocate from with the moz_arena_*
+ * functions below.  Memory it frees is only reused for allocations from that
+ * arena, so its fragmentation doesn't keep other arenas from purging their
+ * dirty pages, and vice versa.
+ *
+ * The arena is purged when it has more than |max_dirty_pages| unused dirty
+ * pages; 0 means the same limit as the default arenas.  Arenas are never
+ * destroyed.
+ */
+MOZ_JEMALLOC_API arena_id_t moz_create_arena(size_t max_dirty_pages);
+
+/*
+ * Like malloc, calloc, realloc, free and memalign, but for the given arena.
+ * Huge allocations (bigger than a chunk) are not arena specific.  A pointer
+ * given to moz_arena_realloc or moz_arena_free must have been allocated from
+ * the same arena.
+ */
+MOZ_JEMALLOC_API void* moz_arena_malloc(arena_id_t arena, size_t size);
+MOZ_JEMALLOC_API void* moz_arena_calloc(arena_id_t arena, size_t num,
+                                        size_t size);
+MOZ_JEMALLOC_API void* moz_arena_realloc(arena_id_t arena, void* ptr,
+                                         size_t size);
+MOZ_JEMALLOC_API void moz_arena_free(arena_id_t arena, void* ptr);
+MOZ_JEMALLOC_API void* moz_arena_memalign(arena_id_t arena, size_t alignment,
+                                          size_t size);
+
 #endif /* mozmemory_h */
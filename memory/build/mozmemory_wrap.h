@@ -37,6 +37,7 @@
  *   - jemalloc_purge_freed_pages
  *   - jemalloc_free_dirty_pages
  *   - jemalloc_thread_local_arena
+ *   - moz_create_arena and the moz_arena_* functions
  *   (these functions are native to mozjemalloc)
  *
  * These functions are all exported as part of libmozglue (see
@@ -207,5 +208,11 @@
 #define jemalloc_free_dirty_pages_impl   mozmem_jemalloc_impl(jemalloc_free_dirty_pages)
 #define jemalloc_thread_local_arena_impl \
           mozmem_jemalloc_impl(jemalloc_thread_local_arena)
+#define moz_create_arena_impl            mozmem_jemalloc_impl(moz_create_arena)
+#define moz_arena_malloc_impl            mozmem_jemalloc_impl(moz_arena_malloc)
+#define moz_arena_calloc_impl            mozmem_jemalloc_impl(moz_arena_calloc)
+#define moz_arena_realloc_impl           mozmem_jemalloc_impl(moz_arena_realloc)
+#define moz_arena_free_impl              mozmem_jemalloc_impl(moz_arena_free)
+#define moz_arena_memalign_impl          mozmem_jemalloc_impl(moz_arena_memalign)
 
 #endif /* mozmemory_wrap_h */
@@ -49,3 +49,44 @@ TEST(Jemalloc, UsableSizeInAdvance)
   for (size_t n = 1 M; n < 8 M; n += 128 K)
     ASSERT_NO_FATAL_FAILURE(TestThree(n));
 }
+
+TEST(Jemalloc, Arenas)
+{
+  jemalloc_stats_t stats;
+  jemalloc_stats(&stats);
+  size_t narenas = stats.narenas;
+
+  arena_id_t arena = moz_create_arena(0);
+  ASSERT_TRUE(arena != 0);
+  jemalloc_stats(&stats);
+  // Other threads may be creating thread-local arenas concurrently.
+  EXPECT_GE(stats.narenas, narenas + 1);
+
+  // Small, large and huge allocations.
+  size_t sizes[] = { 1, 48, 1 K, 64 K, 2 M };
+  for (size_t size : sizes) {
+    char* p = (char*)moz_arena_malloc(arena, size);
+    ASSERT_TRUE(p != nullptr);
+    EXPECT_EQ(malloc_good_size(size), moz_malloc_usable_size(p));
+    memset(p, 42, size);
+
+    p = (char*)moz_arena_realloc(arena, p, size * 2);
+    ASSERT_TRUE(p != nullptr);
+    for (size_t i = 0; i < size; i++) {
+      ASSERT_EQ(42, p[i]);
+    }
+    moz_arena_free(arena, p);
+  }
+
+  char* p = (char*)moz_arena_calloc(arena, 16, 16);
+  ASSERT_TRUE(p != nullptr);
+  for (size_t i = 0; i < 16 * 16; i++) {
+    ASSERT_EQ(0, p[i]);
+  }
+  moz_arena_free(arena, p);
+
+  p = (char*)moz_arena_memalign(arena, 256, 100);
+  ASSERT_TRUE(p != nullptr);
+  EXPECT_EQ(0u, (uintptr_t)p % 256);
+  moz_arena_free(arena, p);
+}
@@ -731,6 +731,13 @@ struct arena_s {
 	 */
 	size_t			ndirty;
 
+	/*
+	 * Number of dirty pages above which the arena is purged.  This is
+	 * opt_dirty_max, except for arenas created through moz_create_arena
+	 * with their own limit.
+	 */
+	size_t			dirty_max;
+
 	/*
 	 * Size/address-ordered tree of this arena's available runs.  This tree
 	 * is used for first-best-fit run allocation.
@@ -2775,7 +2782,7 @@ arena_purge(arena_t *arena, bool all)
 	arena_chunk_t *chunk;
 	size_t i, npages;
 	/* If all is set purge all dirty pages. */
-	size_t dirty_max = all ? 1 : opt_dirty_max;
+	size_t dirty_max = all ? 1 : arena->dirty_max;
 #ifdef MOZ_DEBUG
 	size_t ndirty = 0;
 	rb_foreach_begin(arena_chunk_t, link_dirty, &arena->chunks_dirty,
@@ -2784,7 +2791,7 @@ arena_purge(arena_t *arena, bool all)
 	} rb_foreach_end(arena_chunk_t, link_dirty, &arena->chunks_dirty, chunk)
 	MOZ_ASSERT(ndirty == arena->ndirty);
 #endif
-	MOZ_DIAGNOSTIC_ASSERT(all || (arena->ndirty > opt_dirty_max));
+	MOZ_DIAGNOSTIC_ASSERT(all || (arena->ndirty > arena->dirty_max));
 
 	/*
 	 * Iterate downward through chunks until enough dirty memory has been
@@ -2962,8 +2969,8 @@ arena_run_dalloc(arena_t *arena, arena_run_t *run, bool dirty)
 	    CHUNK_MAP_ALLOCATED)) == arena_maxclass)
 		arena_chunk_dealloc(arena, chunk);
 
-	/* Enforce opt_dirty_max. */
-	if (arena->ndirty > opt_dirty_max)
+	/* Enforce the arena's dirty page limit. */
+	if (arena->ndirty > arena->dirty_max)
 		arena_purge(arena, false);
 }
 
@@ -3273,24 +3280,30 @@ arena_malloc(arena_t *arena, size_t size, bool zero)
 		return (arena_malloc_large(arena, size, zero));
 }
 
+/*
+ * The i*alloc functions take the arena to allocate from, or nullptr to use
+ * the one choose_arena() picks for the current thread.
+ */
 static inline void *
-imalloc(size_t size)
+imalloc(size_t size, arena_t *arena)
 {
 
 	MOZ_ASSERT(size != 0);
 
 	if (size <= arena_maxclass)
-		return (arena_malloc(choose_arena(), size, false));
+		return (arena_malloc(arena ? arena : choose_arena(), size,
+		    false));
 	else
 		return (huge_malloc(size, false));
 }
 
 static inline void *
-icalloc(size_t size)
+icalloc(size_t size, arena_t *arena)
 {
 
 	if (size <= arena_maxclass)
-		return (arena_malloc(choose_arena(), size, true));
+		return (arena_malloc(arena ? arena : choose_arena(), size,
+		    true));
 	else
 		return (huge_malloc(size, true));
 }
@@ -3350,7 +3363,7 @@ arena_palloc(arena_t *arena, size_t alignment, size_t size, size_t alloc_size)
 }
 
 static inline void *
-ipalloc(size_t alignment, size_t size)
+ipalloc(size_t alignment, size_t size, arena_t *arena)
 {
 	void *ret;
 	size_t ceil_size;
@@ -3385,7 +3398,8 @@ ipalloc(size_t alignment, size_t size)
 
 	if (ceil_size <= pagesize || (alignment <= pagesize
 	    && ceil_size <= arena_maxclass))
-		ret = arena_malloc(choose_arena(), ceil_size, false);
+		ret = arena_malloc(arena ? arena : choose_arena(), ceil_size,
+		    false);
 	else {
 		size_t run_size;
 
@@ -3432,8 +3446,8 @@ ipalloc(size_t alignment, size_t size)
 		}
 
 		if (run_size <= arena_maxclass) {
-			ret = arena_palloc(choose_arena(), alignment, ceil_size,
-			    run_size);
+			ret = arena_palloc(arena ? arena : choose_arena(),
+			    alignment, ceil_size, run_size);
 		} else if (alignment <= chunksize)
 			ret = huge_malloc(ceil_size, false);
 		else
@@ -3559,8 +3573,6 @@ arena_dalloc_small(arena_t *arena, arena_chunk_t *chunk, void *ptr,
 	bin = run->bin;
 	size = bin->reg_size;
 
-	memset(ptr, kAllocPoison, size);
-
 	arena_run_reg_dalloc(run, bin, ptr, size);
 	run->nfree++;
 
@@ -3633,7 +3645,6 @@ arena_dalloc_large(arena_t *arena, arena_chunk_t *chunk, void *ptr)
 	    pagesize_2pow;
 	size_t size = chunk->map[pageind].bits & ~pagesize_mask;
 
-	memset(ptr, kAllocPoison, size);
 	arena->stats.allocated_large -= size;
 
 	arena_run_dalloc(arena, (arena_run_t *)ptr, true);
@@ -3656,10 +3667,26 @@ arena_dalloc(void *ptr, size_t offset)
 	MOZ_ASSERT(arena);
 	MOZ_DIAGNOSTIC_ASSERT(arena->magic == ARENA_MAGIC);
 
-	malloc_spin_lock(&arena->lock);
 	pageind = offset >> pagesize_2pow;
 	mapelm = &chunk->map[pageind];
 	MOZ_DIAGNOSTIC_ASSERT((mapelm->bits & CHUNK_MAP_ALLOCATED) != 0);
+
+	/*
+	 * Poison the region before taking the arena lock.  Until it is
+	 * deallocated, neither its map element nor the run it belongs to can
+	 * change, so the size can be read without the lock.  Filling large
+	 * regions under the lock made every other thread allocating from the
+	 * arena wait for the memset.
+	 */
+	if ((mapelm->bits & CHUNK_MAP_LARGE) == 0) {
+		arena_run_t *run = (arena_run_t *)(mapelm->bits &
+		    ~pagesize_mask);
+		MOZ_DIAGNOSTIC_ASSERT(run->magic == ARENA_RUN_MAGIC);
+		memset(ptr, kAllocPoison, run->bin->reg_size);
+	} else
+		memset(ptr, kAllocPoison, mapelm->bits & ~pagesize_mask);
+
+	malloc_spin_lock(&arena->lock);
 	if ((mapelm->bits & CHUNK_MAP_LARGE) == 0) {
 		/* Small allocation. */
 		arena_dalloc_small(arena, chunk, ptr, mapelm);
@@ -3785,7 +3812,7 @@ arena_ralloc_large(void *ptr, size_t size, size_t oldsize)
 }
 
 static void *
-arena_ralloc(void *ptr, size_t size, size_t oldsize)
+arena_ralloc(void *ptr, size_t size, size_t oldsize, arena_t *arena)
 {
 	void *ret;
 	size_t copysize;
@@ -3816,7 +3843,7 @@ arena_ralloc(void *ptr, size_t size, size_t oldsize)
 	 * need to move the object.  In that case, fall back to allocating new
 	 * space and copying.
 	 */
-	ret = arena_malloc(choose_arena(), size, false);
+	ret = arena_malloc(arena ? arena : choose_arena(), size, false);
 	if (!ret)
 		return nullptr;
 
@@ -3839,7 +3866,7 @@ IN_PLACE:
 }
 
 static inline void *
-iralloc(void *ptr, size_t size)
+iralloc(void *ptr, size_t size, arena_t *arena)
 {
 	size_t oldsize;
 
@@ -3849,7 +3876,7 @@ iralloc(void *ptr, size_t size)
 	oldsize = isalloc(ptr);
 
 	if (size <= arena_maxclass)
-		return (arena_ralloc(ptr, size, oldsize));
+		return (arena_ralloc(ptr, size, oldsize, arena));
 	else
 		return (huge_ralloc(ptr, size, oldsize));
 }
@@ -3874,6 +3901,7 @@ arena_new(arena_t *arena)
 	arena->spare = nullptr;
 
 	arena->ndirty = 0;
+	arena->dirty_max = opt_dirty_max;
 
 	arena_avail_tree_new(&arena->runs_avail);
 
@@ -4506,8 +4534,12 @@ MALLOC_OUT:
  * Begin malloc(3)-compatible functions.
  */
 
-MOZ_MEMORY_API void *
-malloc_impl(size_t size)
+/*
+ * The do_* functions implement both the malloc(3)-compatible functions, with
+ * a nullptr arena, and their moz_arena_* counterparts.
+ */
+static inline void *
+do_malloc(arena_t *arena, size_t size)
 {
 	void *ret;
 
@@ -4520,7 +4552,7 @@ malloc_impl(size_t size)
 		size = 1;
 	}
 
-	ret = imalloc(size);
+	ret = imalloc(size, arena);
 
 RETURN:
 	if (!ret) {
@@ -4530,32 +4562,8 @@ RETURN:
 	return (ret);
 }
 
-/*
- * In ELF systems the default visibility allows symbols to be preempted at
- * runtime. This in turn prevents the uses of memalign in this file from being
- * optimized. What we do in here is define two aliasing symbols (they point to
- * the same code): memalign and memalign_internal. The internal version has
- * hidden visibility and is used in every reference from this file.
- *
- * For more information on this technique, see section 2.2.7 (Avoid Using
- * Exported Symbols) in http://www.akkadia.org/drepper/dsohowto.pdf.
- */
-
-#ifndef MOZ_REPLACE_MALLOC
-#if defined(__GNUC__) && !defined(MOZ_MEMORY_DARWIN)
-#define MOZ_MEMORY_ELF
-#endif
-#endif /* MOZ_REPLACE_MALLOC */
-
-#ifdef MOZ_MEMORY_ELF
-#define MEMALIGN memalign_internal
-extern "C"
-#else
-#define MEMALIGN memalign_impl
-MOZ_MEMORY_API
-#endif
-void *
-MEMALIGN(size_t alignment, size_t size)
+static inline void *
+do_memalign(arena_t *arena, size_t alignment, size_t size)
 {
 	void *ret;
 
@@ -4571,55 +4579,14 @@ MEMALIGN(size_t alignment, size_t size)
 	}
 
 	alignment = alignment < sizeof(void*) ? sizeof(void*) : alignment;
-	ret = ipalloc(alignment, size);
+	ret = ipalloc(alignment, size, arena);
 
 RETURN:
 	return (ret);
 }
 
-#ifdef MOZ_MEMORY_ELF
-extern void *
-memalign_impl(size_t alignment, size_t size) __attribute__((alias ("memalign_internal"), visibility ("default")));
-#endif
-
-MOZ_MEMORY_API int
-posix_memalign_impl(void **memptr, size_t alignment, size_t size)
-{
-	void *result;
-
-	/* Make sure that alignment is a large enough power of 2. */
-	if (((alignment - 1) & alignment) != 0 || alignment < sizeof(void *)) {
-		return (EINVAL);
-	}
-
-	/* The 0-->1 size promotion is done in the memalign() call below */
-
-	result = MEMALIGN(alignment, size);
-
-	if (!result)
-		return (ENOMEM);
-
-	*memptr = result;
-	return (0);
-}
-
-MOZ_MEMORY_API void *
-aligned_alloc_impl(size_t alignment, size_t size)
-{
-	if (size % alignment) {
-		return nullptr;
-	}
-	return MEMALIGN(alignment, size);
-}
-
-MOZ_MEMORY_API void *
-valloc_impl(size_t size)
-{
-	return (MEMALIGN(pagesize, size));
-}
-
-MOZ_MEMORY_API void *
-calloc_impl(size_t num, size_t size)
+static inline void *
+do_calloc(arena_t *arena, size_t num, size_t size)
 {
 	void *ret;
 	size_t num_size;
@@ -4645,7 +4612,7 @@ calloc_impl(size_t num, size_t size)
 		goto RETURN;
 	}
 
-	ret = icalloc(num_size);
+	ret = icalloc(num_size, arena);
 
 RETURN:
 	if (!ret) {
@@ -4655,8 +4622,8 @@ RETURN:
 	return (ret);
 }
 
-MOZ_MEMORY_API void *
-realloc_impl(void *ptr, size_t size)
+static inline void *
+do_realloc(arena_t *arena, void *ptr, size_t size)
 {
 	void *ret;
 
@@ -4667,7 +4634,7 @@ realloc_impl(void *ptr, size_t size)
 	if (ptr) {
 		MOZ_ASSERT(malloc_initialized);
 
-		ret = iralloc(ptr, size);
+		ret = iralloc(ptr, size, arena);
 
 		if (!ret) {
 			errno = ENOMEM;
@@ -4676,7 +4643,7 @@ realloc_impl(void *ptr, size_t size)
 		if (malloc_init())
 			ret = nullptr;
 		else
-			ret = imalloc(size);
+			ret = imalloc(size, arena);
 
 		if (!ret) {
 			errno = ENOMEM;
@@ -4686,6 +4653,95 @@ realloc_impl(void *ptr, size_t size)
 	return (ret);
 }
 
+MOZ_MEMORY_API void *
+malloc_impl(size_t size)
+{
+	return do_malloc(nullptr, size);
+}
+
+/*
+ * In ELF systems the default visibility allows symbols to be preempted at
+ * runtime. This in turn prevents the uses of memalign in this file from being
+ * optimized. What we do in here is define two aliasing symbols (they point to
+ * the same code): memalign and memalign_internal. The internal version has
+ * hidden visibility and is used in every reference from this file.
+ *
+ * For more information on this technique, see section 2.2.7 (Avoid Using
+ * Exported Symbols) in http://www.akkadia.org/drepper/dsohowto.pdf.
+ */
+
+#ifndef MOZ_REPLACE_MALLOC
+#if defined(__GNUC__) && !defined(MOZ_MEMORY_DARWIN)
+#define MOZ_MEMORY_ELF
+#endif
+#endif /* MOZ_REPLACE_MALLOC */
+
+#ifdef MOZ_MEMORY_ELF
+#define MEMALIGN memalign_internal
+extern "C"
+#else
+#define MEMALIGN memalign_impl
+MOZ_MEMORY_API
+#endif
+void *
+MEMALIGN(size_t alignment, size_t size)
+{
+	return do_memalign(nullptr, alignment, size);
+}
+
+#ifdef MOZ_MEMORY_ELF
+extern void *
+memalign_impl(size_t alignment, size_t size) __attribute__((alias ("memalign_internal"), visibility ("default")));
+#endif
+
+MOZ_MEMORY_API int
+posix_memalign_impl(void **memptr, size_t alignment, size_t size)
+{
+	void *result;
+
+	/* Make sure that alignment is a large enough power of 2. */
+	if (((alignment - 1) & alignment) != 0 || alignment < sizeof(void *)) {
+		return (EINVAL);
+	}
+
+	/* The 0-->1 size promotion is done in the memalign() call below */
+
+	result = MEMALIGN(alignment, size);
+
+	if (!result)
+		return (ENOMEM);
+
+	*memptr = result;
+	return (0);
+}
+
+MOZ_MEMORY_API void *
+aligned_alloc_impl(size_t alignment, size_t size)
+{
+	if (size % alignment) {
+		return nullptr;
+	}
+	return MEMALIGN(alignment, size);
+}
+
+MOZ_MEMORY_API void *
+valloc_impl(size_t size)
+{
+	return (MEMALIGN(pagesize, size));
+}
+
+MOZ_MEMORY_API void *
+calloc_impl(size_t num, size_t size)
+{
+	return do_calloc(nullptr, num, size);
+}
+
+MOZ_MEMORY_API void *
+realloc_impl(void *ptr, size_t size)
+{
+	return do_realloc(nullptr, ptr, size);
+}
+
 MOZ_MEMORY_API void
 free_impl(void *ptr)
 {
@@ -5012,6 +5068,74 @@ jemalloc_free_dirty_pages_impl(void)
 	malloc_spin_unlock(&arenas_lock);
 }
 
+/*
+ * Arena ids are the arena_t pointers themselves, so that allocating from a
+ * given arena doesn't need a lookup.  0 stands for the default arena choice.
+ */
+static inline arena_t *
+arena_from_id(arena_id_t id)
+{
+	arena_t *arena = (arena_t *)id;
+
+	MOZ_DIAGNOSTIC_ASSERT(!arena || arena->magic == ARENA_MAGIC);
+	return arena;
+}
+
+MOZ_JEMALLOC_API arena_id_t
+moz_create_arena_impl(size_t max_dirty_pages)
+{
+	arena_t *arena;
+
+	if (malloc_init())
+		return 0;
+
+	arena = arenas_extend();
+	/*
+	 * arenas_extend() falls back to arenas[0] when it can't create a new
+	 * arena; leave the default arena's limit alone in that case.
+	 */
+	if (max_dirty_pages != 0 && arena != arenas[0])
+		arena->dirty_max = max_dirty_pages;
+	return (arena_id_t)arena;
+}
+
+MOZ_JEMALLOC_API void *
+moz_arena_malloc_impl(arena_id_t arena, size_t size)
+{
+	return do_malloc(arena_from_id(arena), size);
+}
+
+MOZ_JEMALLOC_API void *
+moz_arena_calloc_impl(arena_id_t arena, size_t num, size_t size)
+{
+	return do_calloc(arena_from_id(arena), num, size);
+}
+
+MOZ_JEMALLOC_API void *
+moz_arena_realloc_impl(arena_id_t arena, void *ptr, size_t size)
+{
+	return do_realloc(arena_from_id(arena), ptr, size);
+}
+
+MOZ_JEMALLOC_API void
+moz_arena_free_impl(arena_id_t arena, void *ptr)
+{
+	if (!ptr)
+		return;
+
+	/* Huge allocations don't belong to any arena. */
+	MOZ_DIAGNOSTIC_ASSERT(!arena || CHUNK_ADDR2OFFSET(ptr) == 0 ||
+	    ((arena_chunk_t *)CHUNK_ADDR2BASE(ptr))->arena ==
+	    arena_from_id(arena));
+	idalloc(ptr);
+}
+
+MOZ_JEMALLOC_API void *
+moz_arena_memalign_impl(arena_id_t arena, size_t alignment, size_t size)
+{
+	return do_memalign(arena_from_id(arena), alignment, size);
+}
+
 /*
  * End non-standard functions.
  */
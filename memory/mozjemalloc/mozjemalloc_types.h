@@ -45,6 +45,12 @@ extern "C" {
 
 typedef unsigned char jemalloc_bool;
 
+/*
+ * Identifies an arena created with moz_create_arena().  0 is never a valid
+ * arena id; the moz_arena_* functions treat it as "the default arena".
+ */
+typedef size_t arena_id_t;
+
 /*
  * jemalloc_stats() is not a stable interface.  When using jemalloc_stats_t, be
  * sure that the compiled results of jemalloc.c are in sync with this header
@@ -0,0 +1,504 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/* A sampling heap profiler, as a replace-malloc library.
+ *
+ * Allocations are sampled by bytes: every allocated byte is a Bernoulli trial
+ * with probability 1/interval, and an allocation is sampled when any of its
+ * bytes is. This is the same scheme as mozilla::FastBernoulliTrial::trial(n),
+ * but with the skip count kept per thread, so that the common case of an
+ * unsampled allocation is a thread-local subtraction and doesn't take any
+ * lock. Only sampled allocations have their stack walked and are recorded.
+ *
+ * Frees are filtered through a small table of counters indexed by pointer
+ * hash, so that freeing a pointer that was never sampled doesn't take any
+ * lock either.
+ *
+ * See the README file for the output format. */
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <new>
+#include <stdint.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <io.h>
+#include <process.h>
+#else
+#include <unistd.h>
+#include <pthread.h>
+#include <time.h>
+#endif
+
+#include "replace_malloc.h"
+#include "FdPrintf.h"
+
+#include "mozilla/Atomics.h"
+#include "mozilla/HashFunctions.h"
+#include "mozilla/StackWalk.h"
+#include "mozilla/ThreadLocal.h"
+#include "mozilla/XorShift128PlusRNG.h"
+
+#include "base/lock.h"
+
+static const malloc_table_t* sFuncs = nullptr;
+static intptr_t sFd = 0;
+static bool sStdoutOrStderr = false;
+
+// Protects everything below that isn't thread-local or atomic.
+static Lock sLock;
+
+// Average number of bytes between two samples.
+static const size_t kDefaultInterval = 512 * 1024;
+static size_t sInterval = kDefaultInterval;
+// log(1 - 1/sInterval), used to draw skip counts.
+static double sLogNotProbability = 0;
+static mozilla::non_crypto::XorShift128PlusRNG* sRNG = nullptr;
+
+// Number of bytes the current thread can still allocate before its next
+// sampled allocation. 0 until the first allocation on the thread.
+static MOZ_THREAD_LOCAL(size_t) tlsBytesUntilSample;
+
+// Set while the current thread is recording a sample, so that allocations
+// made by the stack walker or by the live table aren't sampled themselves.
+static MOZ_THREAD_LOCAL(bool) tlsInSampler;
+
+// Maximum number of frames recorded for each sample.
+static const uint32_t kMaxFrames = 24;
+
+// Number of live samples per pointer hash bucket. A free for a pointer
+// whose bucket is empty can't be a sampled one.
+static const size_t kFilterSize = 4096;
+static mozilla::Atomic<uint32_t, mozilla::Relaxed> sFilter[kFilterSize];
+
+// Open-addressed, linear probing set of live sampled allocations.
+static void** sLive = nullptr;
+static size_t sLiveCapacity = 0;
+static size_t sLiveCount = 0;
+
+static void
+prefork() {
+  sLock.Acquire();
+}
+
+static void
+postfork() {
+  sLock.Release();
+}
+
+static size_t
+GetPid()
+{
+  return size_t(getpid());
+}
+
+static size_t
+GetTid()
+{
+#if defined(_WIN32)
+  return size_t(GetCurrentThreadId());
+#else
+  return size_t(pthread_self());
+#endif
+}
+
+// Milliseconds from an arbitrary point in time, on a monotonic clock.
+static size_t
+GetTimeMs()
+{
+#if defined(_WIN32)
+  return size_t(GetTickCount64());
+#else
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return size_t(ts.tv_sec) * 1000 + size_t(ts.tv_nsec) / 1000000;
+#endif
+}
+
+static uint32_t
+FilterIndex(void* aPtr)
+{
+  return mozilla::HashGeneric(aPtr) & (kFilterSize - 1);
+}
+
+static size_t
+LiveIndex(void* aPtr)
+{
+  return mozilla::HashGeneric(aPtr) & (sLiveCapacity - 1);
+}
+
+#ifdef ANDROID
+/* See mozglue/android/APKOpen.cpp */
+extern "C" MOZ_EXPORT __attribute__((weak))
+void* __dso_handle;
+
+/* Android doesn't have pthread_atfork defined in pthread.h */
+extern "C" MOZ_EXPORT
+int pthread_atfork(void (*)(void), void (*)(void), void (*)(void));
+#endif
+
+class HeapSamplerBridge : public ReplaceMallocBridge
+{
+  virtual void InitDebugFd(mozilla::DebugFdRegistry& aRegistry) override {
+    if (!sStdoutOrStderr) {
+      aRegistry.RegisterHandle(sFd);
+    }
+  }
+};
+
+void
+replace_init(const malloc_table_t* aTable)
+{
+  sFuncs = aTable;
+
+  if (!tlsBytesUntilSample.init() || !tlsInSampler.init()) {
+    return;
+  }
+
+#ifndef _WIN32
+  /* See the comment in LogAlloc.cpp's replace_init. */
+  sFuncs->malloc(-1);
+  pthread_atfork(prefork, postfork, postfork);
+#endif
+
+  char* interval = getenv("MALLOC_SAMPLE_INTERVAL");
+  if (interval && *interval) {
+    size_t value = strtoul(interval, nullptr, 10);
+    if (value > 1) {
+      sInterval = value;
+    }
+  }
+  sLogNotProbability = std::log(1.0 - 1.0 / double(sInterval));
+
+  void* rng = sFuncs->malloc(sizeof(mozilla::non_crypto::XorShift128PlusRNG));
+  if (!rng) {
+    return;
+  }
+  // The seeds only need to differ between runs and processes.
+  uint64_t seed = (uint64_t(GetPid()) << 32) ^ GetTimeMs() ^ uintptr_t(rng);
+  sRNG = new (rng) mozilla::non_crypto::XorShift128PlusRNG(
+    seed | 1, mozilla::HashGeneric(seed));
+
+  /* Initialize output file descriptor from the MALLOC_SAMPLE_LOG environment
+   * variable, like logalloc does from MALLOC_LOG. Numbers up to 9999 are
+   * considered as a preopened file descriptor number. Other values are
+   * considered as a file name. */
+  char* log = getenv("MALLOC_SAMPLE_LOG");
+  if (log && *log) {
+    int fd = 0;
+    const char *fd_num = log;
+    while (*fd_num) {
+      /* Reject non digits. */
+      if (*fd_num < '0' || *fd_num > '9') {
+        fd = -1;
+        break;
+      }
+      fd = fd * 10 + (*fd_num - '0');
+      /* Reject values >= 10000. */
+      if (fd >= 10000) {
+        fd = -1;
+        break;
+      }
+      fd_num++;
+    }
+    if (fd == 1 || fd == 2) {
+      sStdoutOrStderr = true;
+    }
+#ifdef _WIN32
+    // See comment in FdPrintf.h as to why CreateFile is used.
+    HANDLE handle;
+    if (fd > 0) {
+      handle = reinterpret_cast<HANDLE>(_get_osfhandle(fd));
+    } else {
+      handle = CreateFileA(log, FILE_APPEND_DATA, FILE_SHARE_READ |
+                           FILE_SHARE_WRITE, nullptr, OPEN_ALWAYS,
+                           FILE_ATTRIBUTE_NORMAL, nullptr);
+    }
+    if (handle != INVALID_HANDLE_VALUE) {
+      sFd = reinterpret_cast<intptr_t>(handle);
+    }
+#else
+    if (fd == -1) {
+      fd = open(log, O_WRONLY | O_CREAT | O_APPEND, 0644);
+    }
+    if (fd > 0) {
+      sFd = fd;
+    }
+#endif
+  }
+}
+
+ReplaceMallocBridge*
+replace_get_bridge()
+{
+  static HeapSamplerBridge bridge;
+  return &bridge;
+}
+
+// Draw the number of bytes up to and including the next sampled one, which
+// follows a geometric distribution. Must be called with sLock held.
+static size_t
+DrawBytesUntilSample()
+{
+  // Same computation as FastBernoulliTrial::chooseSkipCount.
+  double skip = std::floor(std::log(1.0 - sRNG->nextDouble()) /
+                           sLogNotProbability);
+  if (skip >= double(SIZE_MAX - 1)) {
+    return SIZE_MAX;
+  }
+  return size_t(skip) + 1;
+}
+
+// Fast path, deciding whether an allocation of aSize bytes may need to be
+// sampled.
+static inline bool
+MaybeSample(size_t aSize)
+{
+  size_t left = tlsBytesUntilSample.get();
+  if (MOZ_LIKELY(aSize < left)) {
+    tlsBytesUntilSample.set(left - aSize);
+    return false;
+  }
+  return sRNG && !tlsInSampler.get();
+}
+
+static bool
+GrowLiveTable()
+{
+  size_t capacity = sLiveCapacity ? sLiveCapacity * 2 : 1024;
+  void** live = static_cast<void**>(sFuncs->calloc(capacity, sizeof(void*)));
+  if (!live) {
+    return false;
+  }
+  void** old = sLive;
+  size_t oldCapacity = sLiveCapacity;
+  sLive = live;
+  sLiveCapacity = capacity;
+  for (size_t i = 0; i < oldCapacity; i++) {
+    if (old[i]) {
+      size_t index = LiveIndex(old[i]);
+      while (sLive[index]) {
+        index = (index + 1) & (sLiveCapacity - 1);
+      }
+      sLive[index] = old[i];
+    }
+  }
+  sFuncs->free(old);
+  return true;
+}
+
+// Must be called with sLock held.
+static bool
+AddLiveSample(void* aPtr)
+{
+  if ((sLiveCount + 1) * 2 > sLiveCapacity && !GrowLiveTable()) {
+    return false;
+  }
+  size_t index = LiveIndex(aPtr);
+  while (sLive[index]) {
+    index = (index + 1) & (sLiveCapacity - 1);
+  }
+  sLive[index] = aPtr;
+  sLiveCount++;
+  sFilter[FilterIndex(aPtr)]++;
+  return true;
+}
+
+// Must be called with sLock held. Returns whether aPtr was a live sample.
+static bool
+RemoveLiveSample(void* aPtr)
+{
+  if (!sLiveCapacity) {
+    return false;
+  }
+  size_t mask = sLiveCapacity - 1;
+  size_t index = LiveIndex(aPtr);
+  while (sLive[index] != aPtr) {
+    if (!sLive[index]) {
+      return false;
+    }
+    index = (index + 1) & mask;
+  }
+  sLiveCount--;
+  sFilter[FilterIndex(aPtr)]--;
+
+  // Shift back the following entries of the cluster that would become
+  // unreachable with a hole at index.
+  size_t hole = index;
+  for (size_t i = (hole + 1) & mask; sLive[i]; i = (i + 1) & mask) {
+    size_t home = LiveIndex(sLive[i]);
+    if (((i - home) & mask) >= ((i - hole) & mask)) {
+      sLive[hole] = sLive[i];
+      hole = i;
+    }
+  }
+  sLive[hole] = nullptr;
+  return true;
+}
+
+struct StackTrace
+{
+  void* mPcs[kMaxFrames];
+  uint32_t mLength;
+};
+
+static void
+StackWalkCallback(uint32_t aFrameNumber, void* aPc, void* aSp,
+                  void* aClosure)
+{
+  StackTrace* stack = static_cast<StackTrace*>(aClosure);
+  if (stack->mLength < kMaxFrames) {
+    stack->mPcs[stack->mLength++] = aPc;
+  }
+}
+
+// Must be called with sLock held.
+static void
+PrintStack(void* aPtr, const StackTrace& aStack)
+{
+  // FdPrintf has a fixed-size buffer, so print frames four at a time.
+  size_t pid = GetPid(), tid = GetTid();
+  void* const* pcs = aStack.mPcs;
+  for (uint32_t i = 0; i < aStack.mLength; i += 4, pcs += 4) {
+    switch (aStack.mLength - i) {
+      case 1:
+        FdPrintf(sFd, "%zu %zu stack(%p) %p\n", pid, tid, aPtr, pcs[0]);
+        break;
+      case 2:
+        FdPrintf(sFd, "%zu %zu stack(%p) %p %p\n", pid, tid, aPtr, pcs[0],
+                 pcs[1]);
+        break;
+      case 3:
+        FdPrintf(sFd, "%zu %zu stack(%p) %p %p %p\n", pid, tid, aPtr, pcs[0],
+                 pcs[1], pcs[2]);
+        break;
+      default:
+        FdPrintf(sFd, "%zu %zu stack(%p) %p %p %p %p\n", pid, tid, aPtr,
+                 pcs[0], pcs[1], pcs[2], pcs[3]);
+        break;
+    }
+  }
+}
+
+// Slow path for allocations MaybeSample returned true for.
+static MOZ_NEVER_INLINE void
+SampleAllocation(void* aPtr, size_t aSize)
+{
+  tlsInSampler.set(true);
+
+  StackTrace stack;
+  stack.mLength = 0;
+  bool sampled = false;
+  {
+    AutoLock lock(sLock);
+    size_t left = tlsBytesUntilSample.get();
+    if (left == 0) {
+      // First allocation on this thread.
+      left = DrawBytesUntilSample();
+    }
+    if (aSize < left) {
+      tlsBytesUntilSample.set(left - aSize);
+    } else {
+      tlsBytesUntilSample.set(DrawBytesUntilSample());
+      sampled = true;
+    }
+  }
+
+  if (sampled) {
+    // Walk the stack without holding the lock: on some platforms, this
+    // allocates.
+    MozStackWalk(StackWalkCallback, /* aSkipFrames = */ 2, kMaxFrames,
+                 &stack);
+
+    // An allocation of aSize bytes stands for aSize / p bytes on average,
+    // where p is the probability that any of its bytes is sampled.
+    double p = 1.0 - std::exp(double(aSize) * sLogNotProbability);
+    size_t weight = p > 0 ? size_t(double(aSize) / p) : sInterval;
+
+    AutoLock lock(sLock);
+    if (AddLiveSample(aPtr)) {
+      FdPrintf(sFd, "%zu %zu %zu sample(%zu,%zu)=%p\n", GetPid(), GetTid(),
+               GetTimeMs(), aSize, weight, aPtr);
+      PrintStack(aPtr, stack);
+    }
+  }
+
+  tlsInSampler.set(false);
+}
+
+// Called before aPtr is freed or reallocated.
+static inline void
+MaybeUnsample(void* aPtr)
+{
+  if (MOZ_LIKELY(!aPtr || sFilter[FilterIndex(aPtr)] == 0)) {
+    return;
+  }
+  if (tlsInSampler.get()) {
+    // The stack walker can't free a pointer it didn't allocate, and nothing
+    // it allocates is sampled.
+    return;
+  }
+  AutoLock lock(sLock);
+  if (RemoveLiveSample(aPtr)) {
+    FdPrintf(sFd, "%zu %zu %zu free(%p)\n", GetPid(), GetTid(), GetTimeMs(),
+             aPtr);
+  }
+}
+
+void*
+replace_malloc(size_t aSize)
+{
+  void* ptr = sFuncs->malloc(aSize);
+  if (ptr && MaybeSample(aSize)) {
+    SampleAllocation(ptr, aSize);
+  }
+  return ptr;
+}
+
+void*
+replace_calloc(size_t aNum, size_t aSize)
+{
+  void* ptr = sFuncs->calloc(aNum, aSize);
+  // The multiplication can't overflow when calloc succeeded.
+  if (ptr && MaybeSample(aNum * aSize)) {
+    SampleAllocation(ptr, aNum * aSize);
+  }
+  return ptr;
+}
+
+void*
+replace_realloc(void* aPtr, size_t aSize)
+{
+  // The old allocation needs to be removed before it's freed and its address
+  // possibly reused by another thread. If realloc fails, the old allocation
+  // stays live but unsampled, which is a small bias we accept.
+  MaybeUnsample(aPtr);
+  void* ptr = sFuncs->realloc(aPtr, aSize);
+  if (ptr && MaybeSample(aSize)) {
+    SampleAllocation(ptr, aSize);
+  }
+  return ptr;
+}
+
+void
+replace_free(void* aPtr)
+{
+  MaybeUnsample(aPtr);
+  sFuncs->free(aPtr);
+}
+
+void*
+replace_memalign(size_t aAlignment, size_t aSize)
+{
+  void* ptr = sFuncs->memalign(aAlignment, aSize);
+  if (ptr && MaybeSample(aSize)) {
+    SampleAllocation(ptr, aSize);
+  }
+  return ptr;
+}
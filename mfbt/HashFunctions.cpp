@@ -7,33 +7,84 @@
 /* Implementations of hash functions. */
 
 #include "mozilla/HashFunctions.h"
+#include "mozilla/MathAlgorithms.h"
 #include "mozilla/Types.h"
 
 #include <string.h>
 
 namespace mozilla {
 
+namespace detail {
+
+// A 64-bit multiplier with no simple structure (2^64 divided by the golden
+// ratio), used to spread each word across the high bits of the state.
+static const uint64_t kHashBytesMultiplier = 0x9E3779B97F4A7C15ULL;
+
+static MOZ_ALWAYS_INLINE uint64_t
+ReadWord(const unsigned char* aBytes)
+{
+  /* Do an explicitly unaligned load of the data. */
+  uint64_t word;
+  memcpy(&word, aBytes, sizeof(word));
+  return word;
+}
+
+static MOZ_ALWAYS_INLINE uint64_t
+MixWord(uint64_t aState, uint64_t aWord)
+{
+  uint64_t x = (aState ^ aWord) * kHashBytesMultiplier;
+  return x ^ (x >> 32);
+}
+
+// The finalizer from MurmurHash3, so that every input bit affects every
+// output bit, including the low bits used to pick hash table buckets.
+static MOZ_ALWAYS_INLINE uint64_t
+Avalanche(uint64_t aState)
+{
+  aState ^= aState >> 33;
+  aState *= 0xFF51AFD7ED558CCDULL;
+  aState ^= aState >> 33;
+  aState *= 0xC4CEB9FE1A85EC53ULL;
+  aState ^= aState >> 33;
+  return aState;
+}
+
+} /* namespace detail */
+
 uint32_t
 HashBytes(const void* aBytes, size_t aLength)
 {
-  uint32_t hash = 0;
-  const char* b = reinterpret_cast<const char*>(aBytes);
+  using namespace detail;
 
-  /* Walk word by word. */
-  size_t i = 0;
-  for (; i < aLength - (aLength % sizeof(size_t)); i += sizeof(size_t)) {
-    /* Do an explicitly unaligned load of the data. */
-    size_t data;
-    memcpy(&data, b + i, sizeof(size_t));
+  const unsigned char* b = reinterpret_cast<const unsigned char*>(aBytes);
 
-    hash = AddToHash(hash, data, sizeof(data));
+  /*
+   * Walk 64 bits at a time. Two independent lanes let the multiplies of
+   * consecutive words overlap; seeding them differently (and with the length)
+   * keeps swapped words and trailing zero bytes from colliding.
+   */
+  uint64_t h1 = uint64_t(aLength) * kHashBytesMultiplier;
+  uint64_t h2 = ~h1;
+
+  size_t i = 0;
+  for (; i + 2 * sizeof(uint64_t) <= aLength; i += 2 * sizeof(uint64_t)) {
+    h1 = MixWord(h1, ReadWord(b + i));
+    h2 = MixWord(h2, ReadWord(b + i + sizeof(uint64_t)));
+  }
+  if (i + sizeof(uint64_t) <= aLength) {
+    h1 = MixWord(h1, ReadWord(b + i));
+    i += sizeof(uint64_t);
   }
 
   /* Get the remaining bytes. */
-  for (; i < aLength; i++) {
-    hash = AddToHash(hash, b[i]);
+  if (i < aLength) {
+    uint64_t tail = 0;
+    memcpy(&tail, b + i, aLength - i);
+    h2 = MixWord(h2, tail);
   }
-  return hash;
+
+  uint64_t hash = Avalanche(h1 ^ RotateLeft(h2, 31));
+  return uint32_t(hash) ^ uint32_t(hash >> 32);
 }
 
 } /* namespace mozilla */
@@ -288,8 +288,11 @@ HashString(const wchar_t* aStr, size_t aLength)
 /**
  * Hash some number of bytes.
  *
- * This hash walks word-by-word, rather than byte-by-byte, so you won't get the
- * same result out of HashBytes as you would out of HashString.
+ * This hash walks the data 64 bits at a time with a multiplicative mix and a
+ * final avalanche step, rather than byte-by-byte, so you won't get the same
+ * result out of HashBytes as you would out of HashString. It is much faster
+ * than HashString for long keys; prefer it for byte strings that never need
+ * to hash equal to their char16_t equivalents.
  */
 MOZ_MUST_USE extern MFBT_API uint32_t
 HashBytes(const void* bytes, size_t aLength);
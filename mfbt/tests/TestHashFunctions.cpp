@@ -0,0 +1,108 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "mozilla/Assertions.h"
+#include "mozilla/HashFunctions.h"
+#include "mozilla/MathAlgorithms.h"
+
+#include <stdio.h>
+#include <string.h>
+
+using mozilla::CountPopulation32;
+using mozilla::HashBytes;
+
+static void
+TestHashBytesLengths()
+{
+  // Every length up to a few 16-byte blocks, to cover all the tail sizes.
+  // Inputs that differ only in trailing zeroes must not collide.
+  unsigned char zeroes[64] = {};
+  uint32_t hashes[64];
+  for (size_t length = 0; length < 64; length++) {
+    hashes[length] = HashBytes(zeroes, length);
+    for (size_t i = 0; i < length; i++) {
+      MOZ_RELEASE_ASSERT(hashes[i] != hashes[length]);
+    }
+  }
+
+  // The hash only depends on the bytes, not on their alignment.
+  unsigned char buffer[80];
+  for (size_t i = 0; i < sizeof(buffer); i++) {
+    buffer[i] = (unsigned char)(i * 37 + 11);
+  }
+  for (size_t offset = 1; offset < 8; offset++) {
+    unsigned char copy[80];
+    memcpy(copy + offset, buffer, 64);
+    MOZ_RELEASE_ASSERT(HashBytes(buffer, 64) == HashBytes(copy + offset, 64));
+  }
+}
+
+static void
+TestHashBytesSwappedWords()
+{
+  uint64_t words[2] = { 0x0123456789ABCDEFULL, 0xFEDCBA9876543210ULL };
+  uint64_t swapped[2] = { words[1], words[0] };
+  MOZ_RELEASE_ASSERT(HashBytes(words, sizeof(words)) !=
+                     HashBytes(swapped, sizeof(swapped)));
+}
+
+static void
+TestHashBytesAvalanche()
+{
+  // Flipping any single input bit should flip about half of the output bits.
+  // Check the average over many inputs and bits, with generous bounds.
+  unsigned char key[24];
+  uint64_t totalFlipped = 0;
+  uint32_t trials = 0;
+  for (uint32_t seed = 0; seed < 64; seed++) {
+    for (size_t i = 0; i < sizeof(key); i++) {
+      key[i] = (unsigned char)(seed * 131 + i * 17);
+    }
+    uint32_t hash = HashBytes(key, sizeof(key));
+    for (size_t bit = 0; bit < sizeof(key) * 8; bit++) {
+      key[bit / 8] ^= 1 << (bit % 8);
+      totalFlipped += CountPopulation32(hash ^ HashBytes(key, sizeof(key)));
+      key[bit / 8] ^= 1 << (bit % 8);
+      trials++;
+    }
+  }
+  double average = double(totalFlipped) / trials;
+  MOZ_RELEASE_ASSERT(average > 15.0 && average < 17.0);
+}
+
+static void
+TestHashBytesBuckets()
+{
+  // Sequential, URL-like keys should spread evenly over the buckets of a
+  // power-of-two sized table, using either the low or the high bits of the
+  // hash. Each of the 256 buckets expects 64 keys; allow for a lot of noise.
+  static const uint32_t kBuckets = 256;
+  static const uint32_t kKeys = kBuckets * 64;
+  uint32_t low[kBuckets] = {};
+  uint32_t high[kBuckets] = {};
+  char key[64];
+  for (uint32_t i = 0; i < kKeys; i++) {
+    int length = snprintf(key, sizeof(key),
+                          "https://example.com/path/to/resource/%u", i);
+    uint32_t hash = HashBytes(key, size_t(length));
+    low[hash % kBuckets]++;
+    high[hash >> 24]++;
+  }
+  for (uint32_t i = 0; i < kBuckets; i++) {
+    MOZ_RELEASE_ASSERT(low[i] > 32 && low[i] < 96);
+    MOZ_RELEASE_ASSERT(high[i] > 32 && high[i] < 96);
+  }
+}
+
+int
+main()
+{
+  TestHashBytesLengths();
+  TestHashBytesSwappedWords();
+  TestHashBytesAvalanche();
+  TestHashBytesBuckets();
+  return 0;
+}
@@ -19,6 +19,7 @@
 #include "prio.h"
 #include "plstr.h"
 #include "mozilla/Logging.h"
+#include "mozilla/MathAlgorithms.h"
 #include "mozilla/UniquePtrExtensions.h"
 #include "stdlib.h"
 #include "nsWildCard.h"
@@ -29,6 +30,8 @@
 #include <windows.h>
 #endif
 
+#include <algorithm>
+
 // For placement new used for arena allocations of zip file list
 #include <new>
 #define ZIP_ARENABLOCKSIZE (1*1024)
@@ -432,8 +435,10 @@ nsresult nsZipArchive::CloseArchive()
   // Hence, destroying the Arena is like destroying all the memory
   // for all the nsZipItem in one shot. But if the ~nsZipItem is doing
   // anything more than cleaning up memory, we should start calling it.
-  // Let us also cleanup the mFiles table for re-use on the next 'open' call
-  memset(mFiles, 0, sizeof(mFiles));
+  // Let us also drop the mFiles table, which lived in the arena too, so the
+  // next 'open' call builds a new one
+  mFiles = nullptr;
+  mTableSize = 0;
   mBuiltSynthetics = false;
   return NS_OK;
 }
@@ -453,8 +458,10 @@ nsZipItem*  nsZipArchive::GetItem(const char * aEntryName)
                 return 0;
         }
     }
+    if (!mFiles)
+      return nullptr;
 MOZ_WIN_MEM_TRY_BEGIN
-    nsZipItem* item = mFiles[ HashName(aEntryName, len) ];
+    nsZipItem* item = mFiles[ TableSlot(aEntryName, len) ];
     while (item) {
       if ((len == item->nameLength) &&
           (!memcmp(aEntryName, item->Name(), len))) {
@@ -597,7 +604,7 @@ nsresult nsZipFind::FindNext(const char ** aResult, uint16_t *aNameLen)
   *aNameLen = 0;
 MOZ_WIN_MEM_TRY_BEGIN
   // we start from last match, look for next
-  while (mSlot < ZIP_TABSIZE)
+  while (mSlot < mArchive->mTableSize)
   {
     // move to next in current chain, or move to new slot
     mItem = mItem ? mItem->next : mArchive->mFiles[mSlot];
@@ -717,7 +724,11 @@ MOZ_WIN_MEM_TRY_BEGIN
     return NS_ERROR_FILE_CORRUPTED;
   }
 
-  //-- Read the central directory headers
+  //-- Read the central directory headers. Items are chained through their
+  //-- |next| pointer until we know how many there are and can size the table.
+  nsZipItem* items = nullptr;
+  nsZipItem** lastNext = &items;
+  uint32_t itemCount = 0;
   uint32_t sig = 0;
   while ((buf + int32_t(sizeof(uint32_t)) > buf) &&
          (buf + int32_t(sizeof(uint32_t)) <= endp) &&
@@ -760,10 +771,10 @@ MOZ_WIN_MEM_TRY_BEGIN
     item->nameLength = namelen;
     item->isSynthetic = false;
 
-    // Add item to file table
-    uint32_t hash = HashName(item->Name(), namelen);
-    item->next = mFiles[hash];
-    mFiles[hash] = item;
+    item->next = nullptr;
+    *lastNext = item;
+    lastNext = &item->next;
+    itemCount++;
 
     sig = 0;
   } /* while reading central directory records */
@@ -773,6 +784,27 @@ MOZ_WIN_MEM_TRY_BEGIN
     return NS_ERROR_FILE_CORRUPTED;
   }
 
+  // Size the table to the number of entries so that chains stay short for
+  // large archives such as omni.ja, which has thousands of them.
+  mTableSize = std::max(uint32_t(ZIP_TABSIZE), mozilla::RoundUpPow2(itemCount));
+  mFiles = static_cast<nsZipItem**>(
+    mArena.Allocate(mTableSize * sizeof(nsZipItem*), mozilla::fallible));
+  if (!mFiles) {
+    mTableSize = 0;
+    return NS_ERROR_OUT_OF_MEMORY;
+  }
+  memset(mFiles, 0, mTableSize * sizeof(nsZipItem*));
+
+  // Add items to the file table. Later entries end up first in their chain,
+  // so GetItem finds the last of several entries with the same name.
+  while (items) {
+    nsZipItem* item = items;
+    items = item->next;
+    uint32_t slot = TableSlot(item->Name(), item->nameLength);
+    item->next = mFiles[slot];
+    mFiles[slot] = item;
+  }
+
   // Make the comment available for consumers.
   if ((endp >= buf) && (endp - buf >= ZIPEND_SIZE)) {
     ZipEnd *zipend = (ZipEnd *)buf;
@@ -801,9 +833,9 @@ nsresult nsZipArchive::BuildSynthetics()
 MOZ_WIN_MEM_TRY_BEGIN
   // Create synthetic entries for any missing directories.
   // Do this when all ziptable has scanned to prevent double entries.
-  for (auto* item : mFiles)
+  for (uint32_t slot = 0; slot < mTableSize; slot++)
   {
-    for (; item != nullptr; item = item->next)
+    for (nsZipItem* item = mFiles[slot]; item != nullptr; item = item->next)
     {
       if (item->isSynthetic)
         continue;
@@ -828,7 +860,7 @@ MOZ_WIN_MEM_TRY_BEGIN
           continue;
 
         // Is the directory already in the file table?
-        uint32_t hash = HashName(item->Name(), dirlen);
+        uint32_t hash = TableSlot(item->Name(), dirlen);
         bool found = false;
         for (nsZipItem* zi = mFiles[hash]; zi != nullptr; zi = zi->next)
         {
@@ -947,14 +979,13 @@ int64_t nsZipArchive::SizeOfMapping()
 
 nsZipArchive::nsZipArchive()
   : mRefCnt(0)
+  , mFiles(nullptr)
+  , mTableSize(0)
   , mCommentPtr(nullptr)
   , mCommentLen(0)
   , mBuiltSynthetics(false)
 {
   zipLog.AddRef();
-
-  // initialize the table to nullptr
-  memset(mFiles, 0, sizeof(mFiles));
 }
 
 NS_IMPL_ADDREF(nsZipArchive)
@@ -1009,7 +1040,18 @@ static uint32_t HashName(const char* aName, uint16_t len)
     val = val*37 + *p++;
   }
 
-  return (val % ZIP_TABSIZE);
+  return val;
+}
+
+/*
+ * nsZipArchive::TableSlot
+ *
+ * returns the slot of the item table the entry name belongs to
+ */
+uint32_t nsZipArchive::TableSlot(const char* aName, uint16_t aNameLen)
+{
+  MOZ_ASSERT(mozilla::IsPowerOfTwo(mTableSize));
+  return HashName(aName, aNameLen) & (mTableSize - 1);
 }
 
 /*
@@ -8,7 +8,7 @@
 
 #include "mozilla/Attributes.h"
 
-#define ZIP_TABSIZE   256
+#define ZIP_TABSIZE   256           /* Minimum number of slots in the item table */
 #define ZIP_BUFLEN    (4*1024)      /* Used as output buffer when deflating items to a file */
 
 #include "zlib.h"
@@ -219,7 +219,10 @@ private:
   mozilla::ThreadSafeAutoRefCnt mRefCnt; /* ref count */
   NS_DECL_OWNINGTHREAD
 
-  nsZipItem*    mFiles[ZIP_TABSIZE];
+  // Item table, arena allocated by BuildFileList with a power-of-two number
+  // of slots sized to the number of central directory entries.
+  nsZipItem**   mFiles;
+  uint32_t      mTableSize;
   mozilla::ArenaAllocator<1024, sizeof(void*)> mArena;
 
   const char*   mCommentPtr;
@@ -239,6 +242,7 @@ private:
   nsZipItem*        CreateZipItem();
   nsresult          BuildFileList(PRFileDesc *aFd = nullptr);
   nsresult          BuildSynthetics();
+  uint32_t          TableSlot(const char* aName, uint16_t aNameLen);
 
   nsZipArchive& operator=(const nsZipArchive& rhs) = delete;
   nsZipArchive(const nsZipArchive& rhs) = delete;
@@ -261,7 +265,7 @@ private:
   RefPtr<nsZipArchive> mArchive;
   char*         mPattern;
   nsZipItem*    mItem;
-  uint16_t      mSlot;
+  uint32_t      mSlot;
   bool          mRegExp;
 
   nsZipFind& operator=(const nsZipFind& rhs) = delete;
@@ -0,0 +1,305 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim:set ts=2 sw=2 sts=2 et cindent: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "nsSocketTransportService2.h"
+#include "NativeSocketPoller.h"
+#include "mozilla/Assertions.h"
+#include "prerror.h"
+#include "private/pprio.h"
+
+#include <errno.h>
+
+#if defined(XP_LINUX)
+#include <sys/epoll.h>
+#include <unistd.h>
+#define USE_EPOLL 1
+#elif defined(XP_DARWIN)
+#include <sys/types.h>
+#include <sys/event.h>
+#include <sys/time.h>
+#include <unistd.h>
+#define USE_KQUEUE 1
+#endif
+
+namespace mozilla {
+namespace net {
+
+// The most ready sockets fetched by one Collect.  With level triggered
+// registrations any others are simply reported by the next one.
+static const int kMaxReadyFDs = 128;
+
+/* static */ UniquePtr<NativeSocketPoller>
+NativeSocketPoller::Create()
+{
+#if defined(USE_EPOLL) || defined(USE_KQUEUE)
+#if defined(USE_EPOLL)
+  int pollFD = epoll_create1(EPOLL_CLOEXEC);
+#else
+  int pollFD = kqueue();
+#endif
+  if (pollFD < 0) {
+    SOCKET_LOG(("NativeSocketPoller::Create failed [errno=%d]\n", errno));
+    return nullptr;
+  }
+
+  PRFileDesc *pollableFD = PR_CreateSocketPollFd(pollFD);
+  if (!pollableFD) {
+    close(pollFD);
+    return nullptr;
+  }
+
+  return UniquePtr<NativeSocketPoller>(
+    new NativeSocketPoller(pollFD, pollableFD));
+#else
+  return nullptr;
+#endif
+}
+
+NativeSocketPoller::NativeSocketPoller(int aPollFD, PRFileDesc *aPollableFD)
+  : mPollFD(aPollFD)
+  , mPollableFD(aPollableFD)
+{
+  MOZ_ASSERT(OnSocketThread(), "not on socket thread");
+}
+
+NativeSocketPoller::~NativeSocketPoller()
+{
+  MOZ_ASSERT(OnSocketThread(), "not on socket thread");
+#if defined(USE_EPOLL) || defined(USE_KQUEUE)
+  PR_DestroySocketPollFd(mPollableFD);
+  close(mPollFD);
+#endif
+}
+
+/* static */ bool
+NativeSocketPoller::CanPoll(PRFileDesc *aFD)
+{
+#if defined(USE_EPOLL) || defined(USE_KQUEUE)
+  if (PR_GetLayersIdentity(aFD) != PR_NSPR_IO_LAYER) {
+    return false;
+  }
+  PRDescType type = PR_GetDescType(aFD);
+  return type == PR_DESC_SOCKET_TCP || type == PR_DESC_SOCKET_UDP;
+#else
+  return false;
+#endif
+}
+
+#if defined(USE_EPOLL)
+
+static uint32_t
+EpollEventsFor(uint16_t aFlags)
+{
+  uint32_t events = 0;
+  if (aFlags & PR_POLL_READ) {
+    events |= EPOLLIN;
+  }
+  if (aFlags & PR_POLL_WRITE) {
+    events |= EPOLLOUT;
+  }
+  if (aFlags & PR_POLL_EXCEPT) {
+    events |= EPOLLPRI;
+  }
+  return events;
+}
+
+static bool
+EpollControl(int aPollFD, int aOp, PRFileDesc *aFD, uint16_t aFlags)
+{
+  struct epoll_event event;
+  event.events = EpollEventsFor(aFlags);
+  event.data.ptr = aFD;
+  return epoll_ctl(aPollFD, aOp, PR_FileDesc2NativeHandle(aFD), &event) == 0;
+}
+
+bool
+NativeSocketPoller::Add(PRFileDesc *aFD, uint16_t aFlags)
+{
+  return EpollControl(mPollFD, EPOLL_CTL_ADD, aFD, aFlags);
+}
+
+bool
+NativeSocketPoller::Modify(PRFileDesc *aFD, uint16_t aOldFlags,
+                           uint16_t aFlags)
+{
+  return EpollControl(mPollFD, EPOLL_CTL_MOD, aFD, aFlags);
+}
+
+void
+NativeSocketPoller::Remove(PRFileDesc *aFD, uint16_t aFlags)
+{
+  EpollControl(mPollFD, EPOLL_CTL_DEL, aFD, aFlags);
+}
+
+void
+NativeSocketPoller::Collect()
+{
+  mReady.Clear();
+
+  struct epoll_event events[kMaxReadyFDs];
+  int n = epoll_wait(mPollFD, events, kMaxReadyFDs, 0);
+  for (int i = 0; i < n; ++i) {
+    uint16_t outFlags = 0;
+    if (events[i].events & EPOLLIN) {
+      outFlags |= PR_POLL_READ;
+    }
+    if (events[i].events & EPOLLOUT) {
+      outFlags |= PR_POLL_WRITE;
+    }
+    if (events[i].events & EPOLLPRI) {
+      outFlags |= PR_POLL_EXCEPT;
+    }
+    if (events[i].events & EPOLLERR) {
+      outFlags |= PR_POLL_ERR;
+    }
+    if (events[i].events & EPOLLHUP) {
+      outFlags |= PR_POLL_HUP;
+    }
+    ReadyFD *ready = mReady.AppendElement();
+    ready->mFD = static_cast<PRFileDesc*>(events[i].data.ptr);
+    ready->mOutFlags = outFlags;
+  }
+
+  // every socket is reported at most once.
+  mReady.Sort();
+}
+
+#elif defined(USE_KQUEUE)
+
+// Appends the changes turning the filters of |aOldFlags| into those of
+// |aFlags| and returns how many there are.
+static int
+KqueueChangesFor(struct kevent *aChanges, PRFileDesc *aFD,
+                 uint16_t aOldFlags, uint16_t aFlags)
+{
+  int fd = PR_FileDesc2NativeHandle(aFD);
+  int count = 0;
+  static const struct {
+    uint16_t mFlag;
+    int16_t  mFilter;
+  } kFilters[] = {
+    { PR_POLL_READ, EVFILT_READ },
+    { PR_POLL_WRITE, EVFILT_WRITE },
+  };
+  for (const auto& filter : kFilters) {
+    bool before = aOldFlags & filter.mFlag;
+    bool after = aFlags & filter.mFlag;
+    if (before != after) {
+      EV_SET(&aChanges[count++], fd, filter.mFilter,
+             after ? EV_ADD : EV_DELETE, 0, 0, aFD);
+    }
+  }
+  return count;
+}
+
+static bool
+KqueueControl(int aPollFD, PRFileDesc *aFD, uint16_t aOldFlags,
+              uint16_t aFlags)
+{
+  struct kevent changes[2];
+  int count = KqueueChangesFor(changes, aFD, aOldFlags, aFlags);
+  return !count || kevent(aPollFD, changes, count, nullptr, 0, nullptr) == 0;
+}
+
+bool
+NativeSocketPoller::Add(PRFileDesc *aFD, uint16_t aFlags)
+{
+  return KqueueControl(mPollFD, aFD, 0, aFlags);
+}
+
+bool
+NativeSocketPoller::Modify(PRFileDesc *aFD, uint16_t aOldFlags,
+                           uint16_t aFlags)
+{
+  return KqueueControl(mPollFD, aFD, aOldFlags, aFlags);
+}
+
+void
+NativeSocketPoller::Remove(PRFileDesc *aFD, uint16_t aFlags)
+{
+  KqueueControl(mPollFD, aFD, aFlags, 0);
+}
+
+void
+NativeSocketPoller::Collect()
+{
+  mReady.Clear();
+
+  struct kevent events[kMaxReadyFDs];
+  struct timespec timeout = { 0, 0 };
+  int n = kevent(mPollFD, nullptr, 0, events, kMaxReadyFDs, &timeout);
+  for (int i = 0; i < n; ++i) {
+    uint16_t outFlags = 0;
+    if (events[i].flags & EV_ERROR) {
+      outFlags |= PR_POLL_ERR;
+    } else {
+      if (events[i].filter == EVFILT_READ) {
+        outFlags |= PR_POLL_READ;
+      } else if (events[i].filter == EVFILT_WRITE) {
+        outFlags |= PR_POLL_WRITE;
+      }
+      // a pending socket error is reported as EOF with the error in fflags.
+      if ((events[i].flags & EV_EOF) && events[i].fflags) {
+        outFlags |= PR_POLL_ERR;
+      }
+    }
+    ReadyFD *ready = mReady.AppendElement();
+    ready->mFD = static_cast<PRFileDesc*>(events[i].udata);
+    ready->mOutFlags = outFlags;
+  }
+
+  // a socket watched for reading and writing can be reported by both filters,
+  // so merge its entries.
+  mReady.Sort();
+  uint32_t merged = 0;
+  for (uint32_t i = 0; i < mReady.Length(); ++i) {
+    if (merged && mReady[merged - 1] == mReady[i]) {
+      mReady[merged - 1].mOutFlags |= mReady[i].mOutFlags;
+    } else {
+      mReady[merged++] = mReady[i];
+    }
+  }
+  mReady.TruncateLength(merged);
+}
+
+#else
+
+bool
+NativeSocketPoller::Add(PRFileDesc *aFD, uint16_t aFlags)
+{
+  return false;
+}
+
+bool
+NativeSocketPoller::Modify(PRFileDesc *aFD, uint16_t aOldFlags,
+                           uint16_t aFlags)
+{
+  return false;
+}
+
+void
+NativeSocketPoller::Remove(PRFileDesc *aFD, uint16_t aFlags)
+{
+}
+
+void
+NativeSocketPoller::Collect()
+{
+}
+
+#endif
+
+uint16_t
+NativeSocketPoller::OutFlagsFor(PRFileDesc *aFD) const
+{
+  ReadyFD key;
+  key.mFD = aFD;
+  size_t index = mReady.BinaryIndexOf(key);
+  return index == mReady.NoIndex ? 0 : mReady[index].mOutFlags;
+}
+
+} // namespace net
+} // namespace mozilla
@@ -0,0 +1,77 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim:set ts=2 sw=2 sts=2 et cindent: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef NativeSocketPoller_h__
+#define NativeSocketPoller_h__
+
+#include "mozilla/UniquePtr.h"
+#include "nsTArray.h"
+#include "prio.h"
+
+namespace mozilla {
+namespace net {
+
+// Watches plain NSPR sockets with the kernel's readiness interface (epoll on
+// Linux and Android, kqueue on macOS), so that the socket thread only has to
+// hand PR_Poll the single descriptor of the poller for them.
+//
+// Registrations are level triggered and keyed by PRFileDesc: after PollableFD
+// is reported readable, Collect gathers the ready sockets and OutFlagsFor
+// returns the PR_Poll style out_flags of each of them.
+//
+// Socket thread only.
+class NativeSocketPoller
+{
+public:
+  // Returns nullptr if there is no native poller on this platform or it
+  // cannot be created.
+  static UniquePtr<NativeSocketPoller> Create();
+
+  ~NativeSocketPoller();
+
+  // Whether |aFD| can be watched here, i.e. it is a TCP or UDP socket without
+  // any layers whose poll methods must be called by PR_Poll.
+  static bool CanPoll(PRFileDesc *aFD);
+
+  PRFileDesc *PollableFD() { return mPollableFD; }
+
+  // Start, update or stop watching |aFD| for the PR_POLL_* flags given.
+  // These return false if the kernel refused the change.
+  bool Add(PRFileDesc *aFD, uint16_t aFlags);
+  bool Modify(PRFileDesc *aFD, uint16_t aOldFlags, uint16_t aFlags);
+  void Remove(PRFileDesc *aFD, uint16_t aFlags);
+
+  // Fetch the ready sockets without blocking.  Call when PollableFD is
+  // readable, and before OutFlagsFor.
+  void Collect();
+
+  // Forget the sockets of the last Collect, when PollableFD was not readable.
+  void ClearReady() { mReady.Clear(); }
+
+  // The out_flags of |aFD| as of the last Collect, or 0 if it was not ready.
+  uint16_t OutFlagsFor(PRFileDesc *aFD) const;
+
+private:
+  NativeSocketPoller(int aPollFD, PRFileDesc *aPollableFD);
+
+  struct ReadyFD
+  {
+    PRFileDesc *mFD;
+    uint16_t    mOutFlags;
+
+    bool operator<(const ReadyFD& aOther) const { return mFD < aOther.mFD; }
+    bool operator==(const ReadyFD& aOther) const { return mFD == aOther.mFD; }
+  };
+
+  int                 mPollFD;
+  PRFileDesc         *mPollableFD;
+  nsTArray<ReadyFD>   mReady;        // sorted by mFD
+};
+
+} // namespace net
+} // namespace mozilla
+
+#endif
@@ -141,6 +141,24 @@ static const char PREDICTOR_DOING_TESTS_PREF[] = "network.predictor.doing-tests"
 
 static const char PREDICTOR_CLEANED_UP_PREF[] = "network.predictor.cleaned-up";
 
+static const char PREDICTOR_STARTUP_COUNT_PREF[] =
+  "network.predictor.startup-count";
+static const char PREDICTOR_LAST_STARTUP_PREF[] =
+  "network.predictor.last-startup";
+
+static const char PREDICTOR_STARTUP_PRECONNECT_PREF[] =
+  "network.predictor.enable-startup-preconnect";
+// How long to leave the network to the restored windows, in ms.
+static const char PREDICTOR_STARTUP_PRECONNECT_DELAY_PREF[] =
+  "network.predictor.startup-preconnect-delay";
+static const uint32_t STARTUP_PRECONNECT_DELAY_DEFAULT = 2000;
+// The most origins preconnected at startup. The others are only preresolved.
+static const char PREDICTOR_STARTUP_PRECONNECT_MAX_PREF[] =
+  "network.predictor.startup-preconnect-max";
+static const uint32_t STARTUP_PRECONNECT_MAX_DEFAULT = 6;
+
+static const char SESSION_RESTORED_TOPIC[] = "sessionstore-windows-restored";
+
 // All these time values are in sec
 static const uint32_t ONE_DAY = 86400U;
 static const uint32_t ONE_WEEK = 7U * ONE_DAY;
@@ -353,6 +371,10 @@ Predictor::Predictor()
   ,mStartupCount(1)
   ,mMaxURILength(PREDICTOR_MAX_URI_LENGTH_DEFAULT)
   ,mDoingTests(false)
+  ,mEnableStartupPreconnect(true)
+  ,mStartupPreconnectDelay(STARTUP_PRECONNECT_DELAY_DEFAULT)
+  ,mStartupPreconnectMax(STARTUP_PRECONNECT_MAX_DEFAULT)
+  ,mStartupPreconnecting(false)
 {
   MOZ_ASSERT(!sSelf, "multiple Predictor instances!");
   sSelf = this;
@@ -383,6 +405,9 @@ Predictor::InstallObserver()
   rv = obs->AddObserver(this, NS_XPCOM_SHUTDOWN_OBSERVER_ID, false);
   NS_ENSURE_SUCCESS(rv, rv);
 
+  rv = obs->AddObserver(this, SESSION_RESTORED_TOPIC, false);
+  NS_ENSURE_SUCCESS(rv, rv);
+
   Preferences::AddBoolVarCache(&mEnabled, PREDICTOR_ENABLED_PREF, true);
   Preferences::AddBoolVarCache(&mEnableHoverOnSSL,
                                PREDICTOR_SSL_HOVER_PREF, false);
@@ -450,6 +475,15 @@ Predictor::InstallObserver()
 
   Preferences::AddBoolVarCache(&mDoingTests, PREDICTOR_DOING_TESTS_PREF, false);
 
+  Preferences::AddBoolVarCache(&mEnableStartupPreconnect,
+                               PREDICTOR_STARTUP_PRECONNECT_PREF, true);
+  Preferences::AddUintVarCache(&mStartupPreconnectDelay,
+                               PREDICTOR_STARTUP_PRECONNECT_DELAY_PREF,
+                               STARTUP_PRECONNECT_DELAY_DEFAULT);
+  Preferences::AddUintVarCache(&mStartupPreconnectMax,
+                               PREDICTOR_STARTUP_PRECONNECT_MAX_PREF,
+                               STARTUP_PRECONNECT_MAX_DEFAULT);
+
   if (!mCleanedUp) {
     mCleanupTimer = do_CreateInstance("@mozilla.org/timer;1");
     mCleanupTimer->Init(this, 60 * 1000, nsITimer::TYPE_ONE_SHOT);
@@ -467,12 +501,18 @@ Predictor::RemoveObserver()
     mozilla::services::GetObserverService();
   if (obs) {
     obs->RemoveObserver(this, NS_XPCOM_SHUTDOWN_OBSERVER_ID);
+    obs->RemoveObserver(this, SESSION_RESTORED_TOPIC);
   }
 
   if (mCleanupTimer) {
     mCleanupTimer->Cancel();
     mCleanupTimer = nullptr;
   }
+
+  if (mStartupTimer) {
+    mStartupTimer->Cancel();
+    mStartupTimer = nullptr;
+  }
 }
 
 NS_IMETHODIMP
@@ -485,9 +525,27 @@ Predictor::Observe(nsISupports *subject, const char *topic,
 
   if (!strcmp(NS_XPCOM_SHUTDOWN_OBSERVER_ID, topic)) {
     Shutdown();
+  } else if (!strcmp(SESSION_RESTORED_TOPIC, topic)) {
+    if (mEnabled && mEnableStartupPreconnect && mStartupPreconnectMax &&
+        !mStartupTimer) {
+      mStartupTimer = do_CreateInstance("@mozilla.org/timer;1");
+      if (mStartupTimer) {
+        mStartupTimer->Init(this, mStartupPreconnectDelay,
+                            nsITimer::TYPE_ONE_SHOT);
+      }
+    }
   } else if (!strcmp("timer-callback", topic)) {
-    MaybeCleanupOldDBFiles();
-    mCleanupTimer = nullptr;
+    nsCOMPtr<nsITimer> timer = do_QueryInterface(subject);
+    if (timer && timer == mStartupTimer) {
+      if (!mStartupPreconnecting) {
+        StartupPreconnect();
+      } else {
+        ReportStartupPreconnects();
+      }
+    } else {
+      MaybeCleanupOldDBFiles();
+      mCleanupTimer = nullptr;
+    }
   }
 
   return rv;
@@ -583,7 +641,13 @@ Predictor::Init()
   rv = InstallObserver();
   NS_ENSURE_SUCCESS(rv, rv);
 
-  mLastStartupTime = mStartupTime = NOW_IN_SECONDS();
+  // Startup predictions are weighed against the startups before this one.
+  mStartupTime = NOW_IN_SECONDS();
+  mLastStartupTime =
+    Preferences::GetUint(PREDICTOR_LAST_STARTUP_PREF, mStartupTime);
+  mStartupCount = Preferences::GetInt(PREDICTOR_STARTUP_COUNT_PREF, 0) + 1;
+  Preferences::SetUint(PREDICTOR_LAST_STARTUP_PREF, mStartupTime);
+  Preferences::SetInt(PREDICTOR_STARTUP_COUNT_PREF, mStartupCount);
 
   if (!mDNSListener) {
     mDNSListener = new DNSListener();
@@ -766,6 +830,63 @@ Predictor::MaybeCleanupOldDBFiles()
   ioThread->Dispatch(runner, NS_DISPATCH_NORMAL);
 }
 
+void
+Predictor::StartupPreconnect()
+{
+  MOZ_ASSERT(NS_IsMainThread());
+
+  if (!mInitialized || !mEnabled) {
+    mStartupTimer = nullptr;
+    return;
+  }
+
+  PREDICTOR_LOG(("Predictor::StartupPreconnect"));
+  mStartupPreconnecting = true;
+  PredictNative(nullptr, nullptr, nsINetworkPredictor::PREDICT_STARTUP,
+                OriginAttributes(), nullptr);
+
+  // Pages loaded until the end of the startup window are what we predicted
+  // for, but give them at least a minute.
+  uint32_t elapsed = NOW_IN_SECONDS() - mStartupTime;
+  uint32_t remaining = elapsed < STARTUP_WINDOW ? STARTUP_WINDOW - elapsed : 0;
+  remaining = std::max(remaining, 60U);
+  mStartupTimer->Init(this, remaining * 1000, nsITimer::TYPE_ONE_SHOT);
+}
+
+void
+Predictor::ReportStartupPreconnects()
+{
+  MOZ_ASSERT(NS_IsMainThread());
+
+  PREDICTOR_LOG(("Predictor::ReportStartupPreconnects count=%u",
+                 mStartupPreconnects.Count()));
+  for (auto iter = mStartupPreconnects.Iter(); !iter.Done(); iter.Next()) {
+    Telemetry::Accumulate(Telemetry::PREDICTOR_STARTUP_PRECONNECT_USED,
+                          iter.Data());
+  }
+  mStartupPreconnects.Clear();
+  mStartupPreconnecting = false;
+  mStartupTimer = nullptr;
+}
+
+void
+Predictor::NoteStartupPreconnectUse(nsIURI *uri)
+{
+  MOZ_ASSERT(NS_IsMainThread());
+
+  if (!mStartupPreconnects.Count()) {
+    return;
+  }
+
+  nsAutoCString origin;
+  if (NS_FAILED(nsContentUtils::GetASCIIOrigin(uri, origin))) {
+    return;
+  }
+  if (auto entry = mStartupPreconnects.Lookup(origin)) {
+    entry.Data() = true;
+  }
+}
+
 void
 Predictor::Shutdown()
 {
@@ -908,6 +1029,7 @@ Predictor::PredictNative(nsIURI *targetURI, nsIURI *sourceURI,
         PREDICTOR_LOG(("    load invalid URI state"));
         return NS_ERROR_INVALID_ARG;
       }
+      NoteStartupPreconnectUse(targetURI);
       break;
     case nsINetworkPredictor::PREDICT_STARTUP:
       if (targetURI || sourceURI) {
@@ -1141,6 +1263,27 @@ Predictor::PredictForStartup(nsICacheEntry *entry, bool fullUri,
   int32_t globalDegradation = CalculateGlobalDegradation(mLastStartupTime);
   CalculatePredictions(entry, nullptr, mLastStartupTime, mStartupCount,
                        globalDegradation, fullUri);
+
+  if (mStartupPreconnecting) {
+    // Connect to each origin once, and to no more than the budget allows so
+    // that the restored windows keep most of the network.
+    nsTArray<nsCOMPtr<nsIURI>> preconnects;
+    preconnects.SwapElements(mPreconnects);
+    for (nsIURI *uri : preconnects) {
+      nsAutoCString origin;
+      if (NS_FAILED(nsContentUtils::GetASCIIOrigin(uri, origin)) ||
+          mStartupPreconnects.Contains(origin)) {
+        continue;
+      }
+      if (mStartupPreconnects.Count() >= mStartupPreconnectMax) {
+        mPreresolves.AppendElement(uri);
+        continue;
+      }
+      mStartupPreconnects.Put(origin, false);
+      mPreconnects.AppendElement(uri);
+    }
+  }
+
   return RunPredictions(nullptr, *lci->OriginAttributesPtr(), verifier);
 }
 
@@ -1618,6 +1761,7 @@ Predictor::LearnNative(nsIURI *targetURI, nsIURI *sourceURI,
     NS_ENSURE_SUCCESS(rv, rv);
     uriKey = sourceURI;
     originKey = sourceOrigin;
+    NoteStartupPreconnectUse(targetURI);
     break;
   default:
     PREDICTOR_LOG(("    invalid reason"));
@@ -1951,8 +2095,17 @@ Predictor::MaybeLearnForStartup(nsIURI *uri, bool fullUri,
 {
   MOZ_ASSERT(NS_IsMainThread());
 
-  // TODO - not doing startup for first go around
   PREDICTOR_LOG(("Predictor::MaybeLearnForStartup"));
+
+  // Both entries of the page get here, the startup entry only needs it once.
+  if (!fullUri) {
+    return;
+  }
+
+  if ((NOW_IN_SECONDS() - mStartupTime) < STARTUP_WINDOW) {
+    LearnNative(uri, nullptr, nsINetworkPredictor::LEARN_STARTUP,
+                originAttributes);
+  }
 }
 
 // Add information about a top-level load to our list of startup pages
@@ -20,6 +20,7 @@
 #include "nsISpeculativeConnect.h"
 #include "nsIStreamListener.h"
 #include "mozilla/RefPtr.h"
+#include "nsDataHashtable.h"
 #include "nsString.h"
 #include "nsTArray.h"
 
@@ -233,6 +234,15 @@ private:
   // Service startup utilities
   void MaybeCleanupOldDBFiles();
 
+  // Preconnects to the pages of previous startups once the session's windows
+  // are restored, and reports how many of those connections were used when
+  // the startup window closes.
+  void StartupPreconnect();
+  void ReportStartupPreconnects();
+
+  // Marks the startup preconnect to the origin of |uri|, if any, as used.
+  void NoteStartupPreconnectUse(nsIURI *uri);
+
   // The guts of prediction
 
   // This is the top-level driver for doing any prediction that needs
@@ -459,6 +469,15 @@ private:
   bool mCleanedUp;
   nsCOMPtr<nsITimer> mCleanupTimer;
 
+  bool mEnableStartupPreconnect;
+  uint32_t mStartupPreconnectDelay;
+  uint32_t mStartupPreconnectMax;
+  nsCOMPtr<nsITimer> mStartupTimer;
+  // True from the startup preconnects until they are reported.
+  bool mStartupPreconnecting;
+  // Origins preconnected at startup, and whether they were used since.
+  nsDataHashtable<nsCStringHashKey, bool> mStartupPreconnects;
+
   nsTArray<nsCString> mKeysToOperateOn;
   nsTArray<nsCString> mValuesToOperateOn;
 
@@ -4,8 +4,7 @@
 
 #include "nsBase64Encoder.h"
 
-#include "plbase64.h"
-#include "prmem.h"
+#include "mozilla/Base64.h"
 
 NS_IMPL_ISUPPORTS(nsBase64Encoder, nsIOutputStream)
 
@@ -24,8 +23,34 @@ nsBase64Encoder::Flush()
 NS_IMETHODIMP
 nsBase64Encoder::Write(const char* aBuf, uint32_t aCount, uint32_t* _retval)
 {
-  mData.Append(aBuf, aCount);
   *_retval = aCount;
+
+  // Complete the triplet left over from the last write first.
+  if (mPendingLength) {
+    while (mPendingLength < sizeof(mPending) && aCount) {
+      mPending[mPendingLength++] = *aBuf++;
+      aCount--;
+    }
+    if (mPendingLength < sizeof(mPending)) {
+      return NS_OK;
+    }
+    nsresult rv = mozilla::Base64EncodeAppend(mPending, mPendingLength, mData);
+    if (NS_FAILED(rv)) {
+      return rv;
+    }
+    mPendingLength = 0;
+  }
+
+  // Encode the complete triplets right away, and keep the one or two bytes
+  // that remain until the next write.
+  uint32_t encodeLength = aCount - aCount % 3;
+  nsresult rv = mozilla::Base64EncodeAppend(aBuf, encodeLength, mData);
+  if (NS_FAILED(rv)) {
+    return rv;
+  }
+
+  mPendingLength = aCount - encodeLength;
+  memcpy(mPending, aBuf + encodeLength, mPendingLength);
   return NS_OK;
 }
 
@@ -55,13 +80,13 @@ nsBase64Encoder::IsNonBlocking(bool* aNonBlocking)
 nsresult
 nsBase64Encoder::Finish(nsACString& result)
 {
-  char* b64 = PL_Base64Encode(mData.get(), mData.Length(), nullptr);
-  if (!b64)
-    return NS_ERROR_OUT_OF_MEMORY;
+  nsresult rv = mozilla::Base64EncodeAppend(mPending, mPendingLength, mData);
+  if (NS_FAILED(rv))
+    return rv;
 
-  result.Assign(b64);
-  PR_Free(b64); // PL_Base64Encode() uses PR_MALLOC().
+  result.Assign(mData);
   // Free unneeded memory and allow reusing the object
   mData.Truncate();
+  mPendingLength = 0;
   return NS_OK;
 }
@@ -15,7 +15,7 @@
  */
 class nsBase64Encoder final : public nsIOutputStream {
   public:
-    nsBase64Encoder() {}
+    nsBase64Encoder() : mPendingLength(0) {}
 
     NS_DECL_ISUPPORTS
     NS_DECL_NSIOUTPUTSTREAM
@@ -24,9 +24,12 @@ class nsBase64Encoder final : public nsIOutputStream {
   private:
     ~nsBase64Encoder() {}
 
-    /// The data written to this stream. nsCString can deal fine with
-    /// binary data.
+    /// The encoded data written to this stream so far.
     nsCString mData;
+    /// The bytes written after the last complete triplet, which can only be
+    /// encoded once the next write or Finish() comes in.
+    char mPending[3];
+    uint32_t mPendingLength;
 };
 
 #endif
@@ -5,6 +5,7 @@
 
 #include "nsSocketTransportService2.h"
 #include "nsSocketTransport2.h"
+#include "NativeSocketPoller.h"
 #include "NetworkActivityMonitor.h"
 #include "mozilla/IntegerPrintfMacros.h"
 #include "mozilla/Preferences.h"
@@ -54,6 +55,7 @@ static Atomic<PRThread*, Relaxed> gSocketThread;
 #define MAX_TIME_BETWEEN_TWO_POLLS "network.sts.max_time_for_events_between_two_polls"
 #define TELEMETRY_PREF "toolkit.telemetry.enabled"
 #define MAX_TIME_FOR_PR_CLOSE_DURING_SHUTDOWN "network.sts.max_time_for_pr_close_during_shutdown"
+#define NATIVE_POLL_PREF "network.sts.native_poll"
 
 #define REPAIR_POLLABLE_EVENT_TIME 10
 
@@ -84,6 +86,7 @@ nsSocketTransportService::nsSocketTransportService()
     , mIdleCount(0)
     , mSentBytesCount(0)
     , mReceivedBytesCount(0)
+    , mNativePollPref(false)
     , mSendBufferSize(0)
     , mKeepaliveIdleTimeS(600)
     , mKeepaliveRetryIntervalS(1)
@@ -112,7 +115,7 @@ nsSocketTransportService::nsSocketTransportService()
     mIdleList = (SocketContext *)
         moz_xmalloc(sizeof(SocketContext) * mIdleListSize);
     mPollList = (PRPollDesc *)
-        moz_xmalloc(sizeof(PRPollDesc) * (mActiveListSize + 1));
+        moz_xmalloc(sizeof(PRPollDesc) * (mActiveListSize + 2));
 
     NS_ASSERTION(!gSocketTransportService, "must not instantiate twice");
     gSocketTransportService = this;
@@ -226,6 +229,8 @@ nsSocketTransportService::AttachSocket(PRFileDesc *fd, nsASocketHandler *handler
     sock.mFD = fd;
     sock.mHandler = handler;
     sock.mElapsedTime = 0;
+    sock.mNativePoll = false;
+    sock.mNativePollFlags = 0;
 
     nsresult rv = AddToIdleList(&sock);
     if (NS_SUCCEEDED(rv))
@@ -263,6 +268,10 @@ nsSocketTransportService::DetachSocket(SocketContext *listHead, SocketContext *s
     MOZ_ASSERT((listHead == mActiveList) || (listHead == mIdleList),
                "DetachSocket invalid head");
 
+    // the handler may close the socket, so stop watching it first
+    if (listHead == mActiveList)
+        RemoveFromNativePoller(sock);
+
     {
 #ifdef MOZ_TASK_TRACER
 	tasktracer::AutoSourceEvent taskTracerEvent(tasktracer::SourceEventType::SocketIO);
@@ -327,10 +336,20 @@ nsSocketTransportService::AddToPollList(SocketContext *sock)
     mActiveList[newSocketIndex] = *sock;
     mActiveCount++;
 
-    mPollList[newSocketIndex + 1].fd = sock->mFD;
-    mPollList[newSocketIndex + 1].in_flags = sock->mHandler->mPollFlags;
+    SocketContext &s = mActiveList[newSocketIndex];
+    uint16_t in_flags = s.mHandler->mPollFlags;
+    if (mNativePoller && NativeSocketPoller::CanPoll(s.mFD) &&
+        mNativePoller->Add(s.mFD, in_flags)) {
+        s.mNativePoll = true;
+        s.mNativePollFlags = in_flags;
+    }
+
+    mPollList[newSocketIndex + 1].fd = s.mFD;
+    mPollList[newSocketIndex + 1].in_flags = s.mNativePoll ? 0 : in_flags;
     mPollList[newSocketIndex + 1].out_flags = 0;
 
+    SOCKET_LOG(("  native poll=%d\n", s.mNativePoll));
+
     SOCKET_LOG(("  active=%u idle=%u\n", mActiveCount, mIdleCount));
     return NS_OK;
 }
@@ -345,6 +364,8 @@ nsSocketTransportService::RemoveFromPollList(SocketContext *sock)
 
     SOCKET_LOG(("  index=%u mActiveCount=%u\n", index, mActiveCount));
 
+    RemoveFromNativePoller(sock);
+
     if (index != mActiveCount-1) {
         mActiveList[index] = mActiveList[mActiveCount-1];
         mPollList[index+1] = mPollList[mActiveCount];
@@ -391,9 +412,22 @@ nsSocketTransportService::RemoveFromIdleList(SocketContext *sock)
     SOCKET_LOG(("  active=%u idle=%u\n", mActiveCount, mIdleCount));
 }
 
+void
+nsSocketTransportService::RemoveFromNativePoller(SocketContext *sock)
+{
+    if (sock->mNativePoll) {
+        mNativePoller->Remove(sock->mFD, sock->mNativePollFlags);
+        sock->mNativePoll = false;
+        sock->mNativePollFlags = 0;
+    }
+}
+
 void
 nsSocketTransportService::MoveToIdleList(SocketContext *sock)
 {
+    // idle sockets are not polled at all
+    RemoveFromNativePoller(sock);
+
     nsresult rv = AddToIdleList(sock);
     if (NS_FAILED(rv))
         DetachSocket(mActiveList, sock);
@@ -426,7 +460,7 @@ nsSocketTransportService::GrowActiveList()
     mActiveList = (SocketContext *)
         moz_xrealloc(mActiveList, sizeof(SocketContext) * mActiveListSize);
     mPollList = (PRPollDesc *)
-        moz_xrealloc(mPollList, sizeof(PRPollDesc) * (mActiveListSize + 1));
+        moz_xrealloc(mPollList, sizeof(PRPollDesc) * (mActiveListSize + 2));
     return true;
 }
 
@@ -488,15 +522,22 @@ nsSocketTransportService::Poll(uint32_t *interval,
     bool pendingEvents = false;
     mRawThread->HasPendingEvents(&pendingEvents);
 
+    // the native poller follows the active sockets
+    PRPollDesc &nativeDesc = mPollList[mActiveCount + 1];
+    nativeDesc.fd = mNativePoller ? mNativePoller->PollableFD() : nullptr;
+    nativeDesc.in_flags = PR_POLL_READ;
+    nativeDesc.out_flags = 0;
+    uint32_t nativeCount = mNativePoller ? 1 : 0;
+
     if (mPollList[0].fd) {
         mPollList[0].out_flags = 0;
         pollList = mPollList;
-        pollCount = mActiveCount + 1;
+        pollCount = mActiveCount + 1 + nativeCount;
         pollTimeout = pendingEvents ? PR_INTERVAL_NO_WAIT : PollTimeout();
     }
     else {
         // no pollable event, so busy wait...
-        pollCount = mActiveCount;
+        pollCount = mActiveCount + nativeCount;
         if (pollCount)
             pollList = &mPollList[1];
         else
@@ -556,6 +597,9 @@ nsSocketTransportService::Init()
     if (mShuttingDown)
         return NS_ERROR_UNEXPECTED;
 
+    // read before the socket thread starts using it
+    mNativePollPref = Preferences::GetBool(NATIVE_POLL_PREF, true);
+
     nsCOMPtr<nsIThread> thread;
     nsresult rv = NS_NewNamedThread("Socket Thread", getter_AddRefs(thread), this);
     if (NS_FAILED(rv)) return rv;
@@ -898,6 +942,11 @@ nsSocketTransportService::Run()
         mPollList[0].out_flags = 0;
     }
 
+    if (mNativePollPref) {
+        mNativePoller = NativeSocketPoller::Create();
+        SOCKET_LOG(("STS native poller %p\n", mNativePoller.get()));
+    }
+
     mRawThread = NS_GetCurrentThread();
 
     // hook ourselves up to observe event processing for this thread
@@ -1045,6 +1094,7 @@ nsSocketTransportService::Run()
 
     // detach all sockets, including locals
     Reset(false);
+    mNativePoller = nullptr;
 
     // Final pass over the event queue. This makes sure that events posted by
     // socket detach handlers get processed.
@@ -1130,7 +1180,17 @@ nsSocketTransportService::DoPollIteration(TimeDuration *pollDuration)
                 MoveToIdleList(&mActiveList[i]);
             else {
                 // update poll flags
-                mPollList[i+1].in_flags = in_flags;
+                SocketContext &s = mActiveList[i];
+                if (s.mNativePoll && in_flags != s.mNativePollFlags) {
+                    if (mNativePoller->Modify(s.mFD, s.mNativePollFlags,
+                                              in_flags)) {
+                        s.mNativePollFlags = in_flags;
+                    } else {
+                        // leave this socket to PR_Poll
+                        RemoveFromNativePoller(&s);
+                    }
+                }
+                mPollList[i+1].in_flags = s.mNativePoll ? 0 : in_flags;
                 mPollList[i+1].out_flags = 0;
             }
         }
@@ -1178,6 +1238,13 @@ nsSocketTransportService::DoPollIteration(TimeDuration *pollDuration)
                     PR_GetOSError()));
     }
     else {
+        if (mNativePoller) {
+            if (n > 0 && (mPollList[mActiveCount + 1].out_flags & PR_POLL_READ))
+                mNativePoller->Collect();
+            else
+                mNativePoller->ClearReady();
+        }
+
         //
         // service "active" sockets...
         //
@@ -1185,12 +1252,14 @@ nsSocketTransportService::DoPollIteration(TimeDuration *pollDuration)
         for (i=0; i<int32_t(mActiveCount); ++i) {
             PRPollDesc &desc = mPollList[i+1];
             SocketContext &s = mActiveList[i];
-            if (n > 0 && desc.out_flags != 0) {
+            int16_t outFlags = s.mNativePoll ? mNativePoller->OutFlagsFor(s.mFD)
+                                             : desc.out_flags;
+            if (n > 0 && outFlags != 0) {
 #ifdef MOZ_TASK_TRACER
 		tasktracer::AutoSourceEvent taskTracerEvent(tasktracer::SourceEventType::SocketIO);
 #endif
                 s.mElapsedTime = 0;
-                s.mHandler->OnSocketReady(desc.fd, desc.out_flags);
+                s.mHandler->OnSocketReady(desc.fd, outFlags);
                 numberOfOnSocketReadyCalls++;
             }
             // check for timeout errors unless disabled...
@@ -39,6 +39,8 @@ class nsIPrefBranch;
 namespace mozilla {
 namespace net {
 
+class NativeSocketPoller;
+
 //
 // set MOZ_LOG=nsSocketTransport:5
 //
@@ -174,6 +176,9 @@ private:
     //   mActiveList[k].mFD == mPollList[k+1].fd
     //
     // where k=0,1,2,...
+    //
+    // active sockets watched by mNativePoller keep their poll list entry, but
+    // with in_flags of 0 so that PR_Poll skips it.
     //-------------------------------------------------------------------------
 
     struct SocketContext
@@ -181,6 +186,8 @@ private:
         PRFileDesc       *mFD;
         nsASocketHandler *mHandler;
         uint16_t          mElapsedTime;  // time elapsed w/o activity
+        bool              mNativePoll;   // watched by mNativePoller
+        uint16_t          mNativePollFlags; // flags mNativePoller watches for
     };
 
     SocketContext *mActiveList;                   /* mListSize entries */
@@ -199,6 +206,7 @@ private:
     void RemoveFromPollList(SocketContext *);
     void MoveToIdleList(SocketContext *sock);
     void MoveToPollList(SocketContext *sock);
+    void RemoveFromNativePoller(SocketContext *sock);
 
     bool GrowActiveList();
     bool GrowIdleList();
@@ -211,10 +219,17 @@ private:
     // poll list (socket thread only)
     //
     // first element of the poll list is mPollableEvent (or null if the pollable
-    // event cannot be created).
+    // event cannot be created), and the one after the active sockets is the
+    // descriptor of mNativePoller (or null if there is none).
     //-------------------------------------------------------------------------
 
-    PRPollDesc *mPollList;                        /* mListSize + 1 entries */
+    PRPollDesc *mPollList;                        /* mListSize + 2 entries */
+
+    // watches the plain sockets of the active list, so that PR_Poll only
+    // needs to poll the sockets with NSPR layers.  only used on the socket
+    // thread, and only if mNativePollPref is set.
+    UniquePtr<NativeSocketPoller> mNativePoller;
+    bool mNativePollPref;
 
     PRIntervalTime PollTimeout();            // computes ideal poll timeout
     nsresult       DoPollIteration(TimeDuration *pollDuration);
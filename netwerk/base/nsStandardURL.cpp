@@ -171,6 +171,38 @@ constexpr bool TestForInvalidHostCharacters(char c)
 }
 constexpr ASCIIMaskArray sInvalidHostChars = CreateASCIIMask(TestForInvalidHostCharacters);
 
+// Characters of hosts that need neither unescaping nor IDN normalization,
+// other than lowercasing.
+constexpr bool TestForSimpleHostCharacters(char c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+           (c >= '0' && c <= '9') || c == '-' || c == '.' || c == '_';
+}
+constexpr ASCIIMaskArray sSimpleHostChars = CreateASCIIMask(TestForSimpleHostCharacters);
+
+// Most hosts are plain ASCII names or IPv4 addresses, for which unescaping
+// and NormalizeIDN only copy the host and lowercase it.  This tells if |host|
+// is one of them: only simple characters, and no ACE label to be shown in
+// Unicode.
+static bool
+IsSimpleHost(const char *host, uint32_t length)
+{
+    bool labelStart = true;
+    for (uint32_t i = 0; i < length; ++i) {
+        char c = host[i];
+        if (!ASCIIMask::IsMasked(sSimpleHostChars, c)) {
+            return false;
+        }
+        if (labelStart && (c == 'x' || c == 'X') && i + 4 <= length &&
+            (host[i + 1] == 'n' || host[i + 1] == 'N') &&
+            host[i + 2] == '-' && host[i + 3] == '-') {
+            return false;
+        }
+        labelStart = c == '.';
+    }
+    return true;
+}
+
 //----------------------------------------------------------------------------
 
 #define ENSURE_MUTABLE() \
@@ -855,15 +887,23 @@ nsStandardURL::BuildNormalizedSpec(const char *spec,
     // However, perform Unicode normalization on it, as IDN does.
     // Note that we don't disallow URLs without a host - file:, etc
     if (mHost.mLen > 0) {
-        nsAutoCString tempHost;
-        NS_UnescapeURL(spec + mHost.mPos, mHost.mLen, esc_AlwaysCopy | esc_Host, tempHost);
-        if (tempHost.Contains('\0'))
-            return NS_ERROR_MALFORMED_URI;  // null embedded in hostname
-        if (tempHost.Contains(' '))
-            return NS_ERROR_MALFORMED_URI;  // don't allow spaces in the hostname
-        nsresult rv = NormalizeIDN(tempHost, encHost);
-        if (NS_FAILED(rv)) {
-            return rv;
+        nsresult rv;
+        if (IsSimpleHost(spec + mHost.mPos, mHost.mLen)) {
+            // The host is lowercased when it is written out below.
+            encHost.Assign(spec + mHost.mPos, mHost.mLen);
+            mCheckedIfHostA = true;
+            mDisplayHost.Truncate();
+        } else {
+            nsAutoCString tempHost;
+            NS_UnescapeURL(spec + mHost.mPos, mHost.mLen, esc_AlwaysCopy | esc_Host, tempHost);
+            if (tempHost.Contains('\0'))
+                return NS_ERROR_MALFORMED_URI;  // null embedded in hostname
+            if (tempHost.Contains(' '))
+                return NS_ERROR_MALFORMED_URI;  // don't allow spaces in the hostname
+            rv = NormalizeIDN(tempHost, encHost);
+            if (NS_FAILED(rv)) {
+                return rv;
+            }
         }
         if (!SegmentIs(spec, mScheme, "resource") &&
             !SegmentIs(spec, mScheme, "chrome")) {
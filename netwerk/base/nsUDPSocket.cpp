@@ -31,12 +31,29 @@
 #include "nsIDNSService.h"
 #include "nsICancelable.h"
 #include "nsWrapperCacheInlines.h"
+#include "private/pprio.h"
+
+#if defined(XP_LINUX) && !defined(ANDROID)
+#include <errno.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#define USE_RECVMMSG 1
+#endif
 
 namespace mozilla {
 namespace net {
 
 static const uint32_t UDP_PACKET_CHUNK_SIZE = 1400;
 
+// Bug 1252755 - use 9216 bytes to allign with nICEr and transportlayer to
+// support the maximum size of jumbo frames
+static const uint32_t kMaxDatagramSize = 9216;
+
+// The most datagrams read per poll wakeup.  A busy socket is drained in
+// batches rather than being polled again for every datagram, while still
+// letting the other sockets of the socket thread have their turn.
+static const uint32_t kMaxDatagramsPerWakeup = 16;
+
 //-----------------------------------------------------------------------------
 
 typedef void (nsUDPSocket:: *nsUDPSocketFunc)(void);
@@ -467,18 +484,77 @@ nsUDPSocket::OnSocketReady(PRFileDesc *fd, int16_t outFlags)
     return;
   }
 
+#if defined(USE_RECVMMSG)
+  if (!mRecvBuffers) {
+    mRecvBuffers =
+      MakeUniqueFallible<char[]>(kMaxDatagramsPerWakeup * kMaxDatagramSize);
+  }
+  if (mRecvBuffers) {
+    // PRNetAddr has the layout of the native socket addresses here, which is
+    // how NSPR itself passes it to recvfrom.
+    PRNetAddr prClientAddrs[kMaxDatagramsPerWakeup];
+    struct iovec iovs[kMaxDatagramsPerWakeup];
+    struct mmsghdr msgs[kMaxDatagramsPerWakeup];
+    memset(msgs, 0, sizeof(msgs));
+    for (uint32_t i = 0; i < kMaxDatagramsPerWakeup; ++i) {
+      iovs[i].iov_base = mRecvBuffers.get() + i * kMaxDatagramSize;
+      iovs[i].iov_len = kMaxDatagramSize;
+      msgs[i].msg_hdr.msg_name = &prClientAddrs[i];
+      msgs[i].msg_hdr.msg_namelen = sizeof(PRNetAddr);
+      msgs[i].msg_hdr.msg_iov = &iovs[i];
+      msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    int received;
+    do {
+      received = recvmmsg(PR_FileDesc2NativeHandle(mFD), msgs,
+                          kMaxDatagramsPerWakeup, MSG_DONTWAIT, nullptr);
+    } while (received < 0 && errno == EINTR);
+
+    if (received < 0) {
+      if (errno != EAGAIN && errno != EWOULDBLOCK) {
+        mCondition = NS_ERROR_UNEXPECTED;
+      }
+      return;
+    }
+
+    for (int i = 0; i < received; ++i) {
+      if (!OnDatagramReceived(static_cast<char*>(iovs[i].iov_base),
+                              msgs[i].msg_len, prClientAddrs[i])) {
+        return;
+      }
+    }
+    return;
+  }
+#endif
+
   PRNetAddr prClientAddr;
-  uint32_t count;
-  // Bug 1252755 - use 9216 bytes to allign with nICEr and transportlayer to
-  // support the maximum size of jumbo frames
-  char buff[9216];
-  count = PR_RecvFrom(mFD, buff, sizeof(buff), 0, &prClientAddr, PR_INTERVAL_NO_WAIT);
-  mByteReadCount += count;
+  char buff[kMaxDatagramSize];
+  for (uint32_t i = 0; i < kMaxDatagramsPerWakeup; ++i) {
+    int32_t count = PR_RecvFrom(mFD, buff, sizeof(buff), 0, &prClientAddr,
+                                PR_INTERVAL_NO_WAIT);
+    if (count < 0) {
+      if (PR_GetError() != PR_WOULD_BLOCK_ERROR) {
+        mCondition = NS_ERROR_UNEXPECTED;
+      }
+      return;
+    }
+    if (!OnDatagramReceived(buff, count, prClientAddr)) {
+      return;
+    }
+  }
+}
+
+bool
+nsUDPSocket::OnDatagramReceived(const char* aData, uint32_t aCount,
+                                PRNetAddr& aPrClientAddr)
+{
+  mByteReadCount += aCount;
 
   FallibleTArray<uint8_t> data;
-  if (!data.AppendElements(buff, count, fallible)) {
+  if (!data.AppendElements(aData, aCount, fallible)) {
     mCondition = NS_ERROR_UNEXPECTED;
-    return;
+    return false;
   }
 
   nsCOMPtr<nsIAsyncInputStream> pipeIn;
@@ -491,21 +567,22 @@ nsUDPSocket::OnSocketReady(PRFileDesc *fd, int16_t outFlags)
                 true, true, segsize, segcount);
 
   if (NS_FAILED(rv)) {
-    return;
+    return false;
   }
 
-  RefPtr<nsUDPOutputStream> os = new nsUDPOutputStream(this, mFD, prClientAddr);
+  RefPtr<nsUDPOutputStream> os = new nsUDPOutputStream(this, mFD, aPrClientAddr);
   rv = NS_AsyncCopy(pipeIn, os, mSts,
                     NS_ASYNCCOPY_VIA_READSEGMENTS, UDP_PACKET_CHUNK_SIZE);
 
   if (NS_FAILED(rv)) {
-    return;
+    return false;
   }
 
   NetAddr netAddr;
-  PRNetAddrToNetAddr(&prClientAddr, &netAddr);
+  PRNetAddrToNetAddr(&aPrClientAddr, &netAddr);
   nsCOMPtr<nsIUDPMessage> message = new UDPMessageProxy(&netAddr, pipeOut, data);
   mListener->OnPacketReceived(this, message);
+  return NS_SUCCEEDED(mCondition);
 }
 
 void
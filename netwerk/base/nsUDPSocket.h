@@ -8,6 +8,7 @@
 
 #include "nsIUDPSocket.h"
 #include "mozilla/Mutex.h"
+#include "mozilla/UniquePtr.h"
 #include "nsIOutputStream.h"
 #include "nsAutoPtr.h"
 #include "nsCycleCollectionParticipant.h"
@@ -55,6 +56,11 @@ private:
 
   void CloseSocket();
 
+  // wraps one datagram read off mFD and hands it to mListener.  returns false
+  // if the socket failed and no more should be read.
+  bool OnDatagramReceived(const char* aData, uint32_t aCount,
+                          PRNetAddr& aPrClientAddr);
+
   // lock protects access to mListener;
   // so mListener is not cleared while being used/locked.
   Mutex                                mLock;
@@ -68,6 +74,9 @@ private:
 
   uint64_t   mByteReadCount;
   uint64_t   mByteWriteCount;
+
+  // the datagrams of one batched read, allocated on the first one.
+  UniquePtr<char[]> mRecvBuffers;
 };
 
 //-----------------------------------------------------------------------------
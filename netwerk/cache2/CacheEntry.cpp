@@ -1837,6 +1837,8 @@ void CacheEntry::BackgroundOp(uint32_t aOperations, bool aForceAsync)
     if (aOperations & Ops::FRECENCYUPDATE) {
       ++mUseCount;
 
+      CacheStorageService::Self()->RecordEntryUse(this);
+
       #ifndef M_LN2
       #define M_LN2 0.69314718055994530942
       #endif
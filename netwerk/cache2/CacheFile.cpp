@@ -15,6 +15,7 @@
 #include "nsComponentManagerUtils.h"
 #include "nsProxyRelease.h"
 #include "mozilla/Telemetry.h"
+#include "nsCharSeparatedTokenizer.h"
 
 // When CACHE_CHUNKS is defined we always cache unused chunks in mCacheChunks.
 // When it is not defined, we always release the chunks ASAP, i.e. we cache
@@ -187,6 +188,7 @@ CacheFile::CacheFile()
   , mDataIsDirty(false)
   , mWritingMetadata(false)
   , mPreloadWithoutInputStreams(true)
+  , mStoredChunkSizesLoaded(false)
   , mPreloadChunkCount(0)
   , mStatus(NS_OK)
   , mDataSize(-1)
@@ -394,8 +396,9 @@ CacheFile::OnChunkWritten(nsresult aResult, CacheFileChunk *aChunk)
   }
 
   if (NS_SUCCEEDED(aResult) && !aChunk->IsDirty()) {
-    // update hash value in metadata
+    // update hash value and stored size in metadata
     mMetadata->SetHash(aChunk->Index(), aChunk->Hash());
+    SetStoredChunkSize(aChunk->Index(), aChunk->StoredSize());
   }
 
   // notify listeners if there is any
@@ -1159,6 +1162,12 @@ CacheFile::SetElement(const char *aKey, const char *aValue)
     return NS_ERROR_FAILURE;
   }
 
+  if (!strcmp(aKey, CacheFileUtils::kCompressedChunksKey)) {
+    NS_ERROR("compressed-chunks element is reserved for internal use and must "
+             "not be changed via CacheFile::SetElement()");
+    return NS_ERROR_FAILURE;
+  }
+
   PostWriteTimer();
   return mMetadata->SetElement(aKey, aValue);
 }
@@ -1529,7 +1538,7 @@ CacheFile::GetChunkLocked(uint32_t aIndex, ECallerType aCaller,
     // Read the chunk from the disk
     rv = chunk->Read(mHandle, std::min(static_cast<uint32_t>(mDataSize - off),
                      static_cast<uint32_t>(kChunkSize)),
-                     mMetadata->GetHash(aIndex), this);
+                     StoredChunkSize(aIndex), mMetadata->GetHash(aIndex), this);
     if (NS_WARN_IF(NS_FAILED(rv))) {
       RemoveChunkInternal(chunk, false);
       return rv;
@@ -1669,6 +1678,118 @@ CacheFile::PreloadChunks(uint32_t aIndex)
   }
 }
 
+bool
+CacheFile::ShouldCompressChunk(CacheFileChunk *aChunk)
+{
+  AssertOwnsLock();
+
+  if (mMemoryOnly || !CacheObserver::ChunkCompression()) {
+    return false;
+  }
+
+  if (!mMetadata->GetElement(CacheFileUtils::kChunkCompressionKey)) {
+    return false;
+  }
+
+  // The data is truncated only at the beginning of the alternative data, so
+  // chunks that end before it can never be cut in the middle of the compressed
+  // data.
+  if (mAltDataOffset != -1 &&
+      static_cast<int64_t>(aChunk->Index()) * kChunkSize + aChunk->DataSize() >
+      mAltDataOffset) {
+    return false;
+  }
+
+  return true;
+}
+
+void
+CacheFile::LoadStoredChunkSizes()
+{
+  AssertOwnsLock();
+
+  if (mStoredChunkSizesLoaded) {
+    return;
+  }
+
+  mStoredChunkSizesLoaded = true;
+
+  const char *sizes = mMetadata->GetElement(CacheFileUtils::kCompressedChunksKey);
+  if (!sizes) {
+    return;
+  }
+
+  nsCCharSeparatedTokenizer tokenizer(nsDependentCString(sizes), ',');
+  while (tokenizer.hasMoreTokens()) {
+    nsresult rv;
+    uint32_t size = tokenizer.nextToken().ToInteger(&rv);
+    if (NS_FAILED(rv) || size >= kChunkSize) {
+      // Reading the chunk as uncompressed will fail the hash check.
+      LOG(("CacheFile::LoadStoredChunkSizes() - Invalid size of chunk %u. "
+           "[this=%p]", mStoredChunkSizes.Length(), this));
+      size = 0;
+    }
+    mStoredChunkSizes.AppendElement(size);
+  }
+}
+
+uint32_t
+CacheFile::StoredChunkSize(uint32_t aIndex)
+{
+  AssertOwnsLock();
+
+  LoadStoredChunkSizes();
+
+  if (aIndex >= mStoredChunkSizes.Length()) {
+    return 0;
+  }
+
+  return mStoredChunkSizes[aIndex];
+}
+
+void
+CacheFile::SetStoredChunkSize(uint32_t aIndex, uint32_t aSize)
+{
+  AssertOwnsLock();
+
+  LoadStoredChunkSizes();
+
+  if (aIndex >= mStoredChunkSizes.Length()) {
+    if (!aSize) {
+      return;
+    }
+    mStoredChunkSizes.InsertElementsAt(mStoredChunkSizes.Length(),
+                                       aIndex + 1 - mStoredChunkSizes.Length(),
+                                       0);
+  } else if (mStoredChunkSizes[aIndex] == aSize) {
+    return;
+  }
+
+  mStoredChunkSizes[aIndex] = aSize;
+
+  // Uncompressed chunks at the end of the data don't need to be listed.
+  uint32_t len = mStoredChunkSizes.Length();
+  while (len && !mStoredChunkSizes[len - 1]) {
+    --len;
+  }
+  mStoredChunkSizes.TruncateLength(len);
+
+  if (!len) {
+    mMetadata->SetElement(CacheFileUtils::kCompressedChunksKey, nullptr);
+    return;
+  }
+
+  nsAutoCString sizes;
+  for (uint32_t i = 0; i < len; ++i) {
+    if (i) {
+      sizes.Append(',');
+    }
+    sizes.AppendInt(mStoredChunkSizes[i]);
+  }
+
+  mMetadata->SetElement(CacheFileUtils::kCompressedChunksKey, sizes.get());
+}
+
 bool
 CacheFile::ShouldCacheChunk(uint32_t aIndex)
 {
@@ -1806,7 +1927,7 @@ CacheFile::DeactivateChunk(CacheFileChunk *aChunk)
 
       mDataIsDirty = true;
 
-      rv = chunk->Write(mHandle, this);
+      rv = chunk->Write(mHandle, ShouldCompressChunk(chunk), this);
       if (NS_FAILED(rv)) {
         LOG(("CacheFile::DeactivateChunk() - CacheFileChunk::Write() failed "
              "synchronously. Removing it. [this=%p, chunk=%p, rv=0x%08" PRIx32 "]",
@@ -2024,9 +2145,10 @@ CacheFile::Truncate(int64_t aOffset)
     }
   }
 
-  // Remove hashes of all removed chunks from the metadata
+  // Remove hashes and stored sizes of all removed chunks from the metadata
   for (uint32_t i = lastChunk; i > newLastChunk; --i) {
     mMetadata->RemoveHash(i);
+    SetStoredChunkSize(i, 0);
   }
 
   // Truncate new last chunk
@@ -154,6 +154,15 @@ private:
   bool     ShouldCacheChunk(uint32_t aIndex);
   bool     MustKeepCachedChunk(uint32_t aIndex);
 
+  // Whether the chunk should be stored compressed. Only chunks of entries that
+  // asked for it via kChunkCompressionKey and that don't contain any
+  // alternative data are compressed.
+  bool     ShouldCompressChunk(CacheFileChunk *aChunk);
+  // Size of the chunk on the disk when it's stored compressed, 0 otherwise.
+  uint32_t StoredChunkSize(uint32_t aIndex);
+  void     SetStoredChunkSize(uint32_t aIndex, uint32_t aSize);
+  void     LoadStoredChunkSizes();
+
   nsresult DeactivateChunk(CacheFileChunk *aChunk);
   void     RemoveChunkInternal(CacheFileChunk *aChunk, bool aCacheChunk);
 
@@ -205,6 +214,7 @@ private:
   bool           mDataIsDirty;
   bool           mWritingMetadata;
   bool           mPreloadWithoutInputStreams;
+  bool           mStoredChunkSizesLoaded;
   uint32_t       mPreloadChunkCount;
   nsresult       mStatus;
   int64_t        mDataSize; // Size of the whole data including eventual
@@ -233,6 +243,10 @@ private:
   // and mark it as discarded.
   nsTArray<RefPtr<CacheFileChunk> > mDiscardedChunks;
 
+  // Mirrors kCompressedChunksKey element of the metadata. Loaded lazily, see
+  // LoadStoredChunkSizes().
+  nsTArray<uint32_t> mStoredChunkSizes;
+
   nsTArray<CacheFileInputStream*> mInputs;
   CacheFileOutputStream          *mOutput;
 
@@ -8,7 +8,9 @@
 #include "CacheFile.h"
 #include "nsThreadUtils.h"
 
+#include "mozilla/Compression.h"
 #include "mozilla/IntegerPrintfMacros.h"
+#include "mozilla/Telemetry.h"
 
 namespace mozilla {
 namespace net {
@@ -345,6 +347,7 @@ CacheFileChunk::CacheFileChunk(CacheFile *aFile, uint32_t aIndex,
   , mLimitAllocation(!aFile->mOpenAsMemoryOnly && aInitByWriter)
   , mIsPriority(aFile->mPriority)
   , mExpectedHash(0)
+  , mStoredSize(0)
   , mFile(aFile)
 {
   LOG(("CacheFileChunk::CacheFileChunk() [this=%p, index=%u, initByWriter=%d]",
@@ -383,13 +386,13 @@ CacheFileChunk::InitNew()
 
 nsresult
 CacheFileChunk::Read(CacheFileHandle *aHandle, uint32_t aLen,
-                     CacheHash::Hash16_t aHash,
+                     uint32_t aStoredLen, CacheHash::Hash16_t aHash,
                      CacheFileChunkListener *aCallback)
 {
   AssertOwnsLock();
 
-  LOG(("CacheFileChunk::Read() [this=%p, handle=%p, len=%d, listener=%p]",
-       this, aHandle, aLen, aCallback));
+  LOG(("CacheFileChunk::Read() [this=%p, handle=%p, len=%d, storedLen=%d, "
+       "listener=%p]", this, aHandle, aLen, aStoredLen, aCallback));
 
   MOZ_ASSERT(mState == INITIAL);
   MOZ_ASSERT(NS_SUCCEEDED(mStatus));
@@ -397,6 +400,7 @@ CacheFileChunk::Read(CacheFileHandle *aHandle, uint32_t aLen,
   MOZ_ASSERT(!mWritingStateHandle);
   MOZ_ASSERT(!mReadingStateBuf);
   MOZ_ASSERT(aLen);
+  MOZ_ASSERT(!mStoredBuf);
 
   nsresult rv;
 
@@ -410,10 +414,22 @@ CacheFileChunk::Read(CacheFileHandle *aHandle, uint32_t aLen,
   }
   tmpBuf->SetDataSize(aLen);
 
-  rv = CacheFileIOManager::Read(aHandle, mIndex * kChunkSize,
-                                tmpBuf->Buf(), aLen,
-                                this);
+  if (aStoredLen) {
+    // The compressed data is read into a separate buffer and decompressed into
+    // tmpBuf in OnDataRead().
+    mStoredBuf = MakeUnique<char[]>(aStoredLen);
+    mStoredSize = aStoredLen;
+
+    rv = CacheFileIOManager::Read(aHandle, mIndex * kChunkSize,
+                                  mStoredBuf.get(), aStoredLen,
+                                  this);
+  } else {
+    rv = CacheFileIOManager::Read(aHandle, mIndex * kChunkSize,
+                                  tmpBuf->Buf(), aLen,
+                                  this);
+  }
   if (NS_WARN_IF(NS_FAILED(rv))) {
+    mStoredBuf = nullptr;
     rv = mIndex ? NS_ERROR_FILE_CORRUPTED : NS_ERROR_FILE_NOT_FOUND;
     SetError(rv);
   } else {
@@ -432,13 +448,13 @@ CacheFileChunk::Read(CacheFileHandle *aHandle, uint32_t aLen,
 }
 
 nsresult
-CacheFileChunk::Write(CacheFileHandle *aHandle,
+CacheFileChunk::Write(CacheFileHandle *aHandle, bool aCompress,
                       CacheFileChunkListener *aCallback)
 {
   AssertOwnsLock();
 
-  LOG(("CacheFileChunk::Write() [this=%p, handle=%p, listener=%p]",
-       this, aHandle, aCallback));
+  LOG(("CacheFileChunk::Write() [this=%p, handle=%p, compress=%d, "
+       "listener=%p]", this, aHandle, aCompress, aCallback));
 
   MOZ_ASSERT(mState == READY);
   MOZ_ASSERT(NS_SUCCEEDED(mStatus));
@@ -446,18 +462,44 @@ CacheFileChunk::Write(CacheFileHandle *aHandle,
   MOZ_ASSERT(mBuf->DataSize()); // Don't write chunk when it is empty
   MOZ_ASSERT(mBuf->ReadHandlesCount() == 0);
   MOZ_ASSERT(!mBuf->WriteHandleExists());
+  MOZ_ASSERT(!mStoredBuf);
 
   nsresult rv;
 
   mState = WRITING;
   mWritingStateHandle = new CacheFileChunkReadHandle(mBuf);
+  mStoredSize = 0;
+
+  const char *buf = mWritingStateHandle->Buf();
+  uint32_t len = mWritingStateHandle->DataSize();
+
+  if (aCompress) {
+    // Store the chunk compressed only when it saves at least 1/8 of the space,
+    // otherwise decompressing it on every read isn't worth it.
+    uint32_t maxSize = len - len / 8;
+    if (maxSize) {
+      mStoredBuf = MakeUnique<char[]>(maxSize);
+      size_t compressed = Compression::LZ4::compressLimitedOutput(
+        buf, len, mStoredBuf.get(), maxSize);
+      if (compressed) {
+        mStoredSize = compressed;
+        buf = mStoredBuf.get();
+        len = mStoredSize;
+      } else {
+        mStoredBuf = nullptr;
+      }
+    }
+
+    Telemetry::Accumulate(Telemetry::HTTP_CACHE_CHUNK_COMPRESSION_RATIO,
+      mStoredSize ? mStoredSize * 100 / mWritingStateHandle->DataSize() : 100);
+  }
 
-  rv = CacheFileIOManager::Write(aHandle, mIndex * kChunkSize,
-                                 mWritingStateHandle->Buf(),
-                                 mWritingStateHandle->DataSize(),
+  rv = CacheFileIOManager::Write(aHandle, mIndex * kChunkSize, buf, len,
                                  false, false, this);
   if (NS_WARN_IF(NS_FAILED(rv))) {
     mWritingStateHandle = nullptr;
+    mStoredBuf = nullptr;
+    mStoredSize = 0;
     SetError(rv);
   } else {
     mListener = aCallback;
@@ -658,6 +700,7 @@ CacheFileChunk::OnDataWritten(CacheFileHandle *aHandle, const char *aBuf,
     MOZ_ASSERT(mListener);
 
     mWritingStateHandle = nullptr;
+    mStoredBuf = nullptr;
 
     if (NS_WARN_IF(NS_FAILED(aResult))) {
       SetError(aResult);
@@ -693,6 +736,24 @@ CacheFileChunk::OnDataRead(CacheFileHandle *aHandle, char *aBuf,
     RefPtr<CacheFileChunkBuffer> tmpBuf;
     tmpBuf.swap(mReadingStateBuf);
 
+    if (mStoredBuf) {
+      if (NS_SUCCEEDED(aResult)) {
+        size_t outSize;
+        if (!Compression::LZ4::decompress(mStoredBuf.get(), mStoredSize,
+                                          tmpBuf->Buf(), tmpBuf->DataSize(),
+                                          &outSize) ||
+            outSize != tmpBuf->DataSize()) {
+          LOG(("CacheFileChunk::OnDataRead() - Cannot decompress the data. "
+               "[this=%p, idx=%d]", this, mIndex));
+          aResult = NS_ERROR_FILE_CORRUPTED;
+        }
+      }
+
+      Telemetry::Accumulate(Telemetry::HTTP_CACHE_COMPRESSED_CHUNK_READ,
+                            NS_SUCCEEDED(aResult));
+      mStoredBuf = nullptr;
+    }
+
     if (NS_SUCCEEDED(aResult)) {
       CacheHash::Hash16_t hash = CacheHash::Hash16(tmpBuf->Buf(),
                                                    tmpBuf->DataSize());
@@ -869,6 +930,8 @@ CacheFileChunk::SizeOfExcludingThis(mozilla::MallocSizeOf mallocSizeOf) const
     n += mReadingStateBuf->SizeOfIncludingThis(mallocSizeOf);
   }
 
+  n += mallocSizeOf(mStoredBuf.get());
+
   for (uint32_t i = 0; i < mOldBufs.Length(); ++i) {
     n += mOldBufs[i]->SizeOfIncludingThis(mallocSizeOf);
   }
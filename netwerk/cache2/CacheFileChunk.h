@@ -11,6 +11,7 @@
 #include "CacheFileUtils.h"
 #include "nsAutoPtr.h"
 #include "mozilla/Mutex.h"
+#include "mozilla/UniquePtr.h"
 
 namespace mozilla {
 namespace net {
@@ -144,10 +145,13 @@ public:
   CacheFileChunk(CacheFile *aFile, uint32_t aIndex, bool aInitByWriter);
 
   void     InitNew();
-  nsresult Read(CacheFileHandle *aHandle, uint32_t aLen,
+  // aStoredLen is the size of the chunk on the disk when it was stored
+  // compressed, 0 otherwise.
+  nsresult Read(CacheFileHandle *aHandle, uint32_t aLen, uint32_t aStoredLen,
                 CacheHash::Hash16_t aHash,
                 CacheFileChunkListener *aCallback);
-  nsresult Write(CacheFileHandle *aHandle, CacheFileChunkListener *aCallback);
+  nsresult Write(CacheFileHandle *aHandle, bool aCompress,
+                 CacheFileChunkListener *aCallback);
   void     WaitForUpdate(CacheFileChunkListener *aCallback);
   nsresult CancelWait(CacheFileChunkListener *aCallback);
   nsresult NotifyUpdateListeners();
@@ -155,6 +159,9 @@ public:
   uint32_t            Index() const;
   CacheHash::Hash16_t Hash() const;
   uint32_t            DataSize() const;
+  // Size of the compressed data written by the last Write(), or 0 when the
+  // chunk was written uncompressed.
+  uint32_t            StoredSize() const { return mStoredSize; }
 
   NS_IMETHOD OnFileOpened(CacheFileHandle *aHandle, nsresult aResult) override;
   NS_IMETHOD OnDataWritten(CacheFileHandle *aHandle, const char *aBuf,
@@ -238,6 +245,11 @@ private:
   RefPtr<CacheFileChunkBuffer> mReadingStateBuf;
   CacheHash::Hash16_t          mExpectedHash;
 
+  // Compressed data of the chunk while it is being read from or written to the
+  // disk. The chunk is always kept uncompressed in mBuf.
+  UniquePtr<char[]> mStoredBuf;
+  uint32_t          mStoredSize;
+
   RefPtr<CacheFile>                mFile; // is null if chunk is cached to
                                           // prevent reference cycles
   nsCOMPtr<CacheFileChunkListener> mListener;
@@ -24,6 +24,7 @@
 #include "mozilla/Telemetry.h"
 #include "mozilla/DebugOnly.h"
 #include "mozilla/Services.h"
+#include "mozilla/StaticMutex.h"
 #include "nsDirectoryServiceUtils.h"
 #include "nsAppDirectoryServiceDefs.h"
 #include "private/pprio.h"
@@ -34,6 +35,8 @@
 // include files for ftruncate (or equivalent)
 #if defined(XP_UNIX)
 #include <unistd.h>
+#include <errno.h>
+#include <sys/uio.h>
 #elif defined(XP_WIN)
 #include <windows.h>
 #undef CreateFile
@@ -48,8 +51,13 @@ namespace net {
 
 #define kOpenHandlesLimit        128
 #define kMetadataWriteDelay      5000
+// Limits of writes to adjacent ranges of a file merged into one
+#define kMaxWriteBatchBuffers    16
+#define kMaxWriteBatchSize       (1024 * 1024)
 #define kRemoveTrashStartDelay   60000 // in milliseconds
 #define kSmartSizeUpdateInterval 60000 // in milliseconds
+// Over limit eviction re-reads the free disk space after this many entries
+#define kEvictionsPerFreeSpaceCheck 64
 
 #ifdef ANDROID
 const uint32_t kMaxCacheSizeKB = 200*1024; // 200 MB
@@ -124,6 +132,7 @@ CacheFileHandle::CacheFileHandle(const SHA1Sum::Hash *aHash, bool aPriority, Pin
   , mPinning(aPinning)
   , mFileSize(-1)
   , mFD(nullptr)
+  , mPendingWrite(nullptr)
 {
   // If we initialize mDoomed in the initialization list, that initialization is
   // not guaranteeded to be atomic.  Whereas this assignment here is guaranteed
@@ -149,6 +158,7 @@ CacheFileHandle::CacheFileHandle(const nsACString &aKey, bool aPriority, Pinning
   , mFileSize(-1)
   , mFD(nullptr)
   , mKey(aKey)
+  , mPendingWrite(nullptr)
 {
   // See comment above about the initialization of mIsDoomed.
   mIsDoomed = false;
@@ -627,6 +637,21 @@ public:
     bool shortOnly = eventCounter - mEventCounter < 5 ? false : true;
 
     CacheFileUtils::CachePerfStats::AddValue(mType, duration, shortOnly);
+
+    // The duration includes the time spent in the queue, so report it also
+    // per level to see how long the operations wait on each of them.
+    static const char* const kLevelNames[] = {
+      "OPEN_PRIORITY", "READ_PRIORITY", "MANAGEMENT", "OPEN", "READ",
+      "WRITE_PRIORITY", "WRITE", "INDEX", "EVICT"
+    };
+    static_assert(ArrayLength(kLevelNames) == CacheIOThread::LAST_LEVEL,
+                  "Every level of CacheIOThread needs a name");
+
+    uint32_t level = aIOThread->CurrentLevel();
+    if (level < CacheIOThread::LAST_LEVEL) {
+      Telemetry::Accumulate(Telemetry::HTTP_CACHE_IO_TIME_PER_LEVEL,
+                            nsDependentCString(kLevelNames[level]), duration);
+    }
   }
 
 protected:
@@ -752,6 +777,10 @@ protected:
   nsCOMPtr<CacheFileIOListener> mCallback;
 };
 
+// Protects CacheFileHandle::mPendingWrite and the buffers of WriteEvents
+// that didn't start running yet.
+static StaticMutex sWriteBatchLock;
+
 class WriteEvent : public Runnable
                  , public IOPerfReportEvent {
 public:
@@ -762,67 +791,178 @@ public:
     , IOPerfReportEvent(CacheFileUtils::CachePerfStats::IO_WRITE)
     , mHandle(aHandle)
     , mOffset(aOffset)
-    , mBuf(aBuf)
     , mCount(aCount)
     , mValidate(aValidate)
     , mTruncate(aTruncate)
-    , mCallback(aCallback)
+    , mStarted(false)
   {
+    Buffer *buf = mBuffers.AppendElement();
+    buf->mBuf = aBuf;
+    buf->mCount = aCount;
+    buf->mCallback = aCallback;
+
     if (!mHandle->IsSpecialFile()) {
       Start(CacheFileIOManager::gInstance->mIOThread);
     }
   }
 
+  // Merges a write of the range that follows the data of this event into it,
+  // if this event didn't start running yet.  The write is then done by this
+  // event with a single system call and the callback is notified as if it was
+  // dispatched on its own.  Must be called with sWriteBatchLock held.
+  bool Append(int64_t aOffset, const char *aBuf, int32_t aCount,
+              bool aValidate, bool aTruncate, CacheFileIOListener *aCallback)
+  {
+    sWriteBatchLock.AssertCurrentThreadOwns();
+
+    if (mStarted || mTruncate || aTruncate ||
+        aOffset != mOffset + mCount ||
+        mBuffers.Length() >= kMaxWriteBatchBuffers ||
+        mCount + static_cast<int64_t>(aCount) > kMaxWriteBatchSize) {
+      return false;
+    }
+
+    Buffer *buf = mBuffers.AppendElement();
+    buf->mBuf = aBuf;
+    buf->mCount = aCount;
+    buf->mCallback = aCallback;
+
+    mCount += aCount;
+    // Each write invalidates the entry unless it validates it, so the batch
+    // validates the entry only if the last write does.
+    mValidate = aValidate;
+    return true;
+  }
+
 protected:
   ~WriteEvent()
   {
-    if (!mCallback && mBuf) {
-      free(const_cast<char *>(mBuf));
+    {
+      StaticMutexAutoLock lock(sWriteBatchLock);
+      if (mHandle->mPendingWrite == this) {
+        mHandle->mPendingWrite = nullptr;
+      }
+    }
+
+    for (uint32_t i = 0; i < mBuffers.Length(); ++i) {
+      if (!mBuffers[i].mCallback && mBuffers[i].mBuf) {
+        free(const_cast<char *>(mBuffers[i].mBuf));
+      }
     }
   }
 
 public:
   NS_IMETHOD Run() override
   {
-    nsresult rv;
-
-    if (mHandle->IsClosed() || (mCallback && mCallback->IsKilled())) {
-      // We usually get here only after the internal shutdown
-      // (i.e. mShuttingDown == true).  Pretend write has succeeded
-      // to avoid any past-shutdown file dooming.
-      rv = (CacheObserver::IsPastShutdownIOLag() ||
-            CacheFileIOManager::gInstance->mShuttingDown)
-        ? NS_OK
-        : NS_ERROR_NOT_INITIALIZED;
-    } else {
-      rv = CacheFileIOManager::gInstance->WriteInternal(
-          mHandle, mOffset, mBuf, mCount, mValidate, mTruncate);
-      if (NS_SUCCEEDED(rv)) {
-        Report(CacheFileIOManager::gInstance->mIOThread);
+    {
+      StaticMutexAutoLock lock(sWriteBatchLock);
+      mStarted = true;
+      if (mHandle->mPendingWrite == this) {
+        mHandle->mPendingWrite = nullptr;
       }
-      if (NS_FAILED(rv) && !mCallback) {
-        // No listener is going to handle the error, doom the file
-        CacheFileIOManager::gInstance->DoomFileInternal(mHandle);
+    }
+
+    bool killed = false;
+    for (uint32_t i = 0; i < mBuffers.Length(); ++i) {
+      if (mBuffers[i].mCallback && mBuffers[i].mCallback->IsKilled()) {
+        killed = true;
       }
     }
-    if (mCallback) {
-      mCallback->OnDataWritten(mHandle, mBuf, rv);
+
+    if (mHandle->IsClosed()) {
+      nsresult rv = KilledResult();
+      for (uint32_t i = 0; i < mBuffers.Length(); ++i) {
+        Notify(mBuffers[i], rv);
+      }
+    } else if (!killed) {
+      nsresult rv = WriteRange(mOffset, 0, mBuffers.Length(), mValidate);
+      for (uint32_t i = 0; i < mBuffers.Length(); ++i) {
+        Notify(mBuffers[i], rv);
+      }
     } else {
-      free(const_cast<char *>(mBuf));
-      mBuf = nullptr;
+      // Some of the writes are no longer wanted, do the others one by one.
+      int64_t offset = mOffset;
+      for (uint32_t i = 0; i < mBuffers.Length(); ++i) {
+        nsresult rv;
+        if (mBuffers[i].mCallback && mBuffers[i].mCallback->IsKilled()) {
+          rv = KilledResult();
+        } else {
+          // Only the last write can validate the entry.
+          bool validate = mValidate && i == mBuffers.Length() - 1;
+          rv = WriteRange(offset, i, 1, validate);
+        }
+        offset += mBuffers[i].mCount;
+        Notify(mBuffers[i], rv);
+      }
     }
 
     return NS_OK;
   }
 
 protected:
+  struct Buffer {
+    const char                   *mBuf;
+    int32_t                       mCount;
+    nsCOMPtr<CacheFileIOListener> mCallback;
+  };
+
+  static nsresult KilledResult()
+  {
+    // We usually get here only after the internal shutdown
+    // (i.e. mShuttingDown == true).  Pretend write has succeeded
+    // to avoid any past-shutdown file dooming.
+    return (CacheObserver::IsPastShutdownIOLag() ||
+            CacheFileIOManager::gInstance->mShuttingDown)
+      ? NS_OK
+      : NS_ERROR_NOT_INITIALIZED;
+  }
+
+  nsresult WriteRange(int64_t aOffset, uint32_t aFirst, uint32_t aLength,
+                      bool aValidate)
+  {
+    AutoTArray<CacheFileIOManager::WriteBuffer, kMaxWriteBatchBuffers> buffers;
+    bool hasCallback = true;
+    for (uint32_t i = aFirst; i < aFirst + aLength; ++i) {
+      CacheFileIOManager::WriteBuffer *buf = buffers.AppendElement();
+      buf->mBuf = mBuffers[i].mBuf;
+      buf->mCount = mBuffers[i].mCount;
+      if (!mBuffers[i].mCallback) {
+        hasCallback = false;
+      }
+    }
+
+    nsresult rv = CacheFileIOManager::gInstance->WriteInternal(
+        mHandle, aOffset, buffers.Elements(), buffers.Length(), aValidate,
+        mTruncate && aFirst + aLength == mBuffers.Length());
+    if (NS_SUCCEEDED(rv)) {
+      Report(CacheFileIOManager::gInstance->mIOThread);
+    }
+    if (NS_FAILED(rv) && !hasCallback) {
+      // No listener is going to handle the error, doom the file
+      CacheFileIOManager::gInstance->DoomFileInternal(mHandle);
+    }
+    return rv;
+  }
+
+  void Notify(Buffer &aBuffer, nsresult aResult)
+  {
+    if (aBuffer.mCallback) {
+      aBuffer.mCallback->OnDataWritten(mHandle, aBuffer.mBuf, aResult);
+    } else {
+      free(const_cast<char *>(aBuffer.mBuf));
+      aBuffer.mBuf = nullptr;
+    }
+  }
+
   RefPtr<CacheFileHandle>       mHandle;
   int64_t                       mOffset;
-  const char                   *mBuf;
-  int32_t                       mCount;
+  // Total size of the buffers
+  int64_t                       mCount;
+  AutoTArray<Buffer, 1>         mBuffers;
   bool                          mValidate : 1;
   bool                          mTruncate : 1;
-  nsCOMPtr<CacheFileIOListener> mCallback;
+  // Protected by sWriteBatchLock
+  bool                          mStarted : 1;
 };
 
 class DoomFileEvent : public Runnable {
@@ -1961,6 +2101,38 @@ CacheFileIOManager::Read(CacheFileHandle *aHandle, int64_t aOffset,
   return NS_OK;
 }
 
+// Reads from aOffset in one system call where possible, positional reads
+// don't need the file pointer to be moved first.
+static int32_t
+ReadAt(PRFileDesc *aFD, int64_t aOffset, char *aBuf, int32_t aCount)
+{
+#if defined(XP_UNIX)
+  int fd = PR_FileDesc2NativeHandle(aFD);
+  int32_t bytesRead = 0;
+  while (bytesRead < aCount) {
+    ssize_t n = pread(fd, aBuf + bytesRead, aCount - bytesRead,
+                      aOffset + bytesRead);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return -1;
+    }
+    if (n == 0) {
+      break;
+    }
+    bytesRead += n;
+  }
+  return bytesRead;
+#else
+  int64_t offset = PR_Seek64(aFD, aOffset, PR_SEEK_SET);
+  if (offset == -1) {
+    return -1;
+  }
+  return PR_Read(aFD, aBuf, aCount);
+#endif
+}
+
 nsresult
 CacheFileIOManager::ReadInternal(CacheFileHandle *aHandle, int64_t aOffset,
                                  char *aBuf, int32_t aCount)
@@ -1995,12 +2167,7 @@ CacheFileIOManager::ReadInternal(CacheFileHandle *aHandle, int64_t aOffset,
     return NS_ERROR_NOT_AVAILABLE;
   }
 
-  int64_t offset = PR_Seek64(aHandle->mFD, aOffset, PR_SEEK_SET);
-  if (offset == -1) {
-    return NS_ERROR_FAILURE;
-  }
-
-  int32_t bytesRead = PR_Read(aHandle->mFD, aBuf, aCount);
+  int32_t bytesRead = ReadAt(aHandle->mFD, aOffset, aBuf, aCount);
   if (bytesRead != aCount) {
     return NS_ERROR_FAILURE;
   }
@@ -2030,6 +2197,17 @@ CacheFileIOManager::Write(CacheFileHandle *aHandle, int64_t aOffset,
     return NS_ERROR_NOT_INITIALIZED;
   }
 
+  {
+    StaticMutexAutoLock lock(sWriteBatchLock);
+    if (aHandle->mPendingWrite &&
+        aHandle->mPendingWrite->Append(aOffset, aBuf, aCount, aValidate,
+                                       aTruncate, aCallback)) {
+      LOG(("  appended to pending write [event=%p]",
+           aHandle->mPendingWrite));
+      return NS_OK;
+    }
+  }
+
   RefPtr<WriteEvent> ev = new WriteEvent(aHandle, aOffset, aBuf, aCount,
                                            aValidate, aTruncate, aCallback);
   rv = ioMan->mIOThread->Dispatch(ev, aHandle->mPriority
@@ -2037,9 +2215,25 @@ CacheFileIOManager::Write(CacheFileHandle *aHandle, int64_t aOffset,
                                   : CacheIOThread::WRITE);
   NS_ENSURE_SUCCESS(rv, rv);
 
+  // Let the following writes join this one until it starts running.  This is
+  // done only after the event was dispatched successfully, since appended
+  // writes are never reported as failed to their callers.
+  {
+    StaticMutexAutoLock lock(sWriteBatchLock);
+    aHandle->mPendingWrite = ev;
+  }
+
   return NS_OK;
 }
 
+// static
+void
+CacheFileIOManager::EndWriteBatch(CacheFileHandle *aHandle)
+{
+  StaticMutexAutoLock lock(sWriteBatchLock);
+  aHandle->mPendingWrite = nullptr;
+}
+
 static nsresult
 TruncFile(PRFileDesc *aFD, int64_t aEOF)
 {
@@ -2065,14 +2259,106 @@ TruncFile(PRFileDesc *aFD, int64_t aEOF)
   return NS_OK;
 }
 
+// Writes the buffers to consecutive ranges starting at aOffset and returns the
+// number of bytes written, or -1 if nothing could be written.  On Linux all
+// the buffers are usually written by a single pwritev() call.
+static int64_t
+WriteAt(PRFileDesc *aFD, int64_t aOffset,
+        const CacheFileIOManager::WriteBuffer *aBuffers, uint32_t aBufferCount)
+{
+  int64_t bytesWritten = 0;
+
+#if defined(XP_LINUX) && !defined(ANDROID)
+  int fd = PR_FileDesc2NativeHandle(aFD);
+  struct iovec iov[kMaxWriteBatchBuffers];
+  MOZ_ASSERT(aBufferCount <= kMaxWriteBatchBuffers);
+
+  uint32_t first = 0;
+  int32_t skip = 0; // already written part of aBuffers[first]
+  while (first < aBufferCount) {
+    uint32_t cnt = 0;
+    for (uint32_t i = first; i < aBufferCount; ++i, ++cnt) {
+      iov[cnt].iov_base = const_cast<char *>(aBuffers[i].mBuf) +
+                          (i == first ? skip : 0);
+      iov[cnt].iov_len = aBuffers[i].mCount - (i == first ? skip : 0);
+    }
+
+    ssize_t n = pwritev(fd, iov, cnt, aOffset + bytesWritten);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return bytesWritten ? bytesWritten : -1;
+    }
+    if (n == 0) {
+      break;
+    }
+
+    bytesWritten += n;
+    // Skip the buffers written completely.
+    n += skip;
+    while (first < aBufferCount && n >= aBuffers[first].mCount) {
+      n -= aBuffers[first].mCount;
+      ++first;
+    }
+    skip = n;
+  }
+#elif defined(XP_UNIX)
+  int fd = PR_FileDesc2NativeHandle(aFD);
+  for (uint32_t i = 0; i < aBufferCount; ++i) {
+    int32_t done = 0;
+    while (done < aBuffers[i].mCount) {
+      ssize_t n = pwrite(fd, aBuffers[i].mBuf + done,
+                         aBuffers[i].mCount - done,
+                         aOffset + bytesWritten);
+      if (n < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        return bytesWritten ? bytesWritten : -1;
+      }
+      if (n == 0) {
+        return bytesWritten;
+      }
+      done += n;
+      bytesWritten += n;
+    }
+  }
+#else
+  int64_t offset = PR_Seek64(aFD, aOffset, PR_SEEK_SET);
+  if (offset == -1) {
+    return -1;
+  }
+
+  for (uint32_t i = 0; i < aBufferCount; ++i) {
+    int32_t n = PR_Write(aFD, aBuffers[i].mBuf, aBuffers[i].mCount);
+    if (n == -1) {
+      return bytesWritten ? bytesWritten : -1;
+    }
+    bytesWritten += n;
+    if (n != aBuffers[i].mCount) {
+      break;
+    }
+  }
+#endif
+
+  return bytesWritten;
+}
+
 nsresult
 CacheFileIOManager::WriteInternal(CacheFileHandle *aHandle, int64_t aOffset,
-                                  const char *aBuf, int32_t aCount,
-                                  bool aValidate, bool aTruncate)
+                                  const WriteBuffer *aBuffers,
+                                  uint32_t aBufferCount, bool aValidate,
+                                  bool aTruncate)
 {
-  LOG(("CacheFileIOManager::WriteInternal() [handle=%p, offset=%" PRId64 ", count=%d, "
-       "validate=%d, truncate=%d]", aHandle, aOffset, aCount, aValidate,
-       aTruncate));
+  int64_t count = 0;
+  for (uint32_t i = 0; i < aBufferCount; ++i) {
+    count += aBuffers[i].mCount;
+  }
+
+  LOG(("CacheFileIOManager::WriteInternal() [handle=%p, offset=%" PRId64 ", count=%"
+       PRId64 ", buffers=%u, validate=%d, truncate=%d]", aHandle, aOffset,
+       count, aBufferCount, aValidate, aTruncate));
 
   nsresult rv;
 
@@ -2115,7 +2401,7 @@ CacheFileIOManager::WriteInternal(CacheFileHandle *aHandle, int64_t aOffset,
 
   // When this operation would increase cache size, check whether the cache size
   // reached the hard limit and whether it would cause critical low disk space.
-  if (aHandle->mFileSize < aOffset + aCount) {
+  if (aHandle->mFileSize < aOffset + count) {
     if (mOverLimitEvicting && mCacheSizeOnHardLimit) {
       LOG(("CacheFileIOManager::WriteInternal() - failing because cache size "
            "reached hard limit!"));
@@ -2129,7 +2415,7 @@ CacheFileIOManager::WriteInternal(CacheFileHandle *aHandle, int64_t aOffset,
            "failed! [rv=0x%08" PRIx32 "]", static_cast<uint32_t>(rv)));
     } else {
       uint32_t limit = CacheObserver::DiskFreeSpaceHardLimit();
-      if (freeSpace - aOffset - aCount + aHandle->mFileSize < limit) {
+      if (freeSpace - aOffset - count + aHandle->mFileSize < limit) {
         LOG(("CacheFileIOManager::WriteInternal() - Low free space, refusing "
              "to write! [freeSpace=%" PRId64 ", limit=%u]", freeSpace, limit));
         return NS_ERROR_FILE_DISK_FULL;
@@ -2140,12 +2426,7 @@ CacheFileIOManager::WriteInternal(CacheFileHandle *aHandle, int64_t aOffset,
   // Write invalidates the entry by default
   aHandle->mInvalid = true;
 
-  int64_t offset = PR_Seek64(aHandle->mFD, aOffset, PR_SEEK_SET);
-  if (offset == -1) {
-    return NS_ERROR_FAILURE;
-  }
-
-  int32_t bytesWritten = PR_Write(aHandle->mFD, aBuf, aCount);
+  int64_t bytesWritten = WriteAt(aHandle->mFD, aOffset, aBuffers, aBufferCount);
 
   if (bytesWritten != -1) {
     uint32_t oldSizeInK = aHandle->FileSizeInK();
@@ -2175,7 +2456,7 @@ CacheFileIOManager::WriteInternal(CacheFileHandle *aHandle, int64_t aOffset,
     }
   }
 
-  if (bytesWritten != aCount) {
+  if (bytesWritten != count) {
     return NS_ERROR_FAILURE;
   }
 
@@ -2403,6 +2684,8 @@ CacheFileIOManager::ReleaseNSPRHandle(CacheFileHandle *aHandle)
     return NS_ERROR_NOT_INITIALIZED;
   }
 
+  EndWriteBatch(aHandle);
+
   RefPtr<ReleaseNSPRHandleEvent> ev = new ReleaseNSPRHandleEvent(aHandle);
   rv = ioMan->mIOThread->Dispatch(ev, aHandle->mPriority
                                   ? CacheIOThread::WRITE_PRIORITY
@@ -2485,6 +2768,8 @@ CacheFileIOManager::TruncateSeekSetEOF(CacheFileHandle *aHandle,
     return NS_ERROR_NOT_INITIALIZED;
   }
 
+  EndWriteBatch(aHandle);
+
   RefPtr<TruncateSeekSetEOFEvent> ev = new TruncateSeekSetEOFEvent(
                                            aHandle, aTruncatePos, aEOFPos,
                                            aCallback);
@@ -2727,6 +3012,8 @@ CacheFileIOManager::RenameFile(CacheFileHandle *aHandle,
     return NS_ERROR_UNEXPECTED;
   }
 
+  EndWriteBatch(aHandle);
+
   RefPtr<RenameFileEvent> ev = new RenameFileEvent(aHandle, aNewName,
                                                      aCallback);
   rv = ioMan->mIOThread->Dispatch(ev, aHandle->mPriority
@@ -2907,22 +3194,35 @@ CacheFileIOManager::OverLimitEvictionInternal()
     return NS_ERROR_NOT_INITIALIZED;
   }
 
-  while (true) {
-    int64_t freeSpace = -1;
-    rv = mCacheDirectory->GetDiskSpaceAvailable(&freeSpace);
-    if (NS_WARN_IF(NS_FAILED(rv))) {
-      // Do not change smart size.
-      LOG(("CacheFileIOManager::EvictIfOverLimitInternal() - "
-           "GetDiskSpaceAvailable() failed! [rv=0x%08" PRIx32 "]",
-           static_cast<uint32_t>(rv)));
-    } else {
-      UpdateSmartCacheSize(freeSpace);
-    }
+  // Asking for the free disk space costs a statfs(), which used to be done for
+  // every single evicted entry.  Do it only every kEvictionsPerFreeSpaceCheck
+  // evictions and in between credit the space the index says was freed.
+  int64_t freeSpace = -1;
+  uint32_t lastCacheUsage = 0;
+  uint32_t evictionsSinceCheck = kEvictionsPerFreeSpaceCheck;
 
+  while (true) {
     uint32_t cacheUsage;
     rv = CacheIndex::GetCacheSize(&cacheUsage);
     NS_ENSURE_SUCCESS(rv, rv);
 
+    if (evictionsSinceCheck >= kEvictionsPerFreeSpaceCheck) {
+      evictionsSinceCheck = 0;
+      freeSpace = -1;
+      rv = mCacheDirectory->GetDiskSpaceAvailable(&freeSpace);
+      if (NS_WARN_IF(NS_FAILED(rv))) {
+        // Do not change smart size.
+        LOG(("CacheFileIOManager::EvictIfOverLimitInternal() - "
+             "GetDiskSpaceAvailable() failed! [rv=0x%08" PRIx32 "]",
+             static_cast<uint32_t>(rv)));
+      } else {
+        UpdateSmartCacheSize(freeSpace);
+      }
+    } else if (freeSpace != -1 && lastCacheUsage > cacheUsage) {
+      freeSpace += static_cast<int64_t>(lastCacheUsage - cacheUsage) << 10;
+    }
+    lastCacheUsage = cacheUsage;
+
     uint32_t cacheLimit = CacheObserver::DiskCacheCapacity() >> 10;
     uint32_t freeSpaceLimit = CacheObserver::DiskFreeSpaceSoftLimit();
 
@@ -2970,6 +3270,7 @@ CacheFileIOManager::OverLimitEvictionInternal()
     rv = CacheIndex::GetEntryForEviction(false, &hash, &cnt);
     NS_ENSURE_SUCCESS(rv, rv);
 
+    ++evictionsSinceCheck;
     rv = DoomFileByKeyInternal(&hash);
     if (NS_SUCCEEDED(rv)) {
       consecutiveFailures = 0;
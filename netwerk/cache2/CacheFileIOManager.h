@@ -33,6 +33,7 @@ namespace net {
 
 class CacheFile;
 class CacheFileIOListener;
+class WriteEvent;
 
 #ifdef DEBUG_HANDLES
 class CacheFileHandlesEntry;
@@ -80,6 +81,7 @@ private:
   friend class CacheFileIOManager;
   friend class CacheFileHandles;
   friend class ReleaseNSPRHandleEvent;
+  friend class WriteEvent;
 
   virtual ~CacheFileHandle();
 
@@ -127,6 +129,11 @@ private:
   int64_t              mFileSize;
   PRFileDesc          *mFD;  // if null then the file doesn't exists on the disk
   nsCString            mKey;
+  // The last write dispatched for this handle if it didn't start running yet.
+  // Adjacent writes are appended to it instead of being dispatched on their
+  // own.  Not an owning reference, the event clears it when it runs or dies.
+  // Protected by the write batch lock in CacheFileIOManager.cpp.
+  WriteEvent          *mPendingWrite;
 };
 
 class CacheFileHandles {
@@ -296,11 +303,21 @@ public:
   // Shuts the scheduling off and flushes all pending metadata writes.
   static nsresult ShutdownMetadataWriteScheduling();
 
+  // A buffer of a (possibly batched) write.  The buffers of one write are
+  // written to consecutive ranges of the file starting at its offset.
+  struct WriteBuffer {
+    const char *mBuf;
+    int32_t     mCount;
+  };
+
   static nsresult OpenFile(const nsACString &aKey,
                            uint32_t aFlags, CacheFileIOListener *aCallback);
   static nsresult Read(CacheFileHandle *aHandle, int64_t aOffset,
                        char *aBuf, int32_t aCount,
                        CacheFileIOListener *aCallback);
+  // Writes to adjacent ranges of a file dispatched before the first of them
+  // starts executing are merged and written with a single system call where
+  // possible.  Each callback is still notified separately.
   static nsresult Write(CacheFileHandle *aHandle, int64_t aOffset,
                         const char *aBuf, int32_t aCount, bool aValidate,
                         bool aTruncate, CacheFileIOListener *aCallback);
@@ -401,8 +418,12 @@ private:
   nsresult ReadInternal(CacheFileHandle *aHandle, int64_t aOffset,
                         char *aBuf, int32_t aCount);
   nsresult WriteInternal(CacheFileHandle *aHandle, int64_t aOffset,
-                         const char *aBuf, int32_t aCount, bool aValidate,
-                         bool aTruncate);
+                         const WriteBuffer *aBuffers, uint32_t aBufferCount,
+                         bool aValidate, bool aTruncate);
+  // Makes sure that no further write is appended to the write pending for
+  // the handle.  Must be called before dispatching any other event that
+  // touches the file to the WRITE or WRITE_PRIORITY level.
+  static void EndWriteBatch(CacheFileHandle *aHandle);
   nsresult DoomFileInternal(CacheFileHandle *aHandle,
                             PinningDoomRestriction aPinningStatusRestriction = NO_RESTRICTION);
   nsresult DoomFileByKeyInternal(const SHA1Sum::Hash *aHash);
@@ -91,16 +91,78 @@ CacheFileOutputStream::Write(const char * aBuf, uint32_t aCount,
 
   LOG(("CacheFileOutputStream::Write() [this=%p, count=%d]", this, aCount));
 
+  nsresult rv = CheckWriteLocked(aCount);
+  if (NS_FAILED(rv)) {
+    return rv;
+  }
+
+  rv = WriteSegmentsLocked(NS_CopySegmentToBuffer, const_cast<char*>(aBuf),
+                           aCount, _retval);
+  if (NS_FAILED(rv)) {
+    return rv;
+  }
+
+  MOZ_ASSERT(*_retval == aCount);
+
+  LOG(("CacheFileOutputStream::Write() - Wrote %d bytes [this=%p]",
+       *_retval, this));
+
+  return NS_OK;
+}
+
+static nsresult
+ReadFromInputStream(nsIOutputStream *aOutStream, void *aClosure,
+                    char *aToRawSegment, uint32_t aOffset, uint32_t aCount,
+                    uint32_t *aReadCount)
+{
+  nsIInputStream *fromStream = static_cast<nsIInputStream*>(aClosure);
+  return fromStream->Read(aToRawSegment, aCount, aReadCount);
+}
+
+NS_IMETHODIMP
+CacheFileOutputStream::WriteFrom(nsIInputStream *aFromStream, uint32_t aCount,
+                                 uint32_t *_retval)
+{
+  LOG(("CacheFileOutputStream::WriteFrom() [this=%p, from=%p, count=%d]",
+       this, aFromStream, aCount));
+
+  return WriteSegments(ReadFromInputStream, aFromStream, aCount, _retval);
+}
+
+NS_IMETHODIMP
+CacheFileOutputStream::WriteSegments(nsReadSegmentFun aReader, void *aClosure,
+                                     uint32_t aCount, uint32_t *_retval)
+{
+  CacheFileAutoLock lock(mFile);
+
+  LOG(("CacheFileOutputStream::WriteSegments() [this=%p, count=%d]", this,
+       aCount));
+
+  nsresult rv = WriteSegmentsLocked(aReader, aClosure, aCount, _retval);
+  if (NS_FAILED(rv)) {
+    return rv;
+  }
+
+  LOG(("CacheFileOutputStream::WriteSegments() - Wrote %d bytes [this=%p]",
+       *_retval, this));
+
+  return NS_OK;
+}
+
+nsresult
+CacheFileOutputStream::CheckWriteLocked(uint32_t aCount)
+{
   if (mClosed) {
-    LOG(("CacheFileOutputStream::Write() - Stream is closed. [this=%p, "
-         "status=0x%08" PRIx32"]", this, static_cast<uint32_t>(mStatus)));
+    LOG(("CacheFileOutputStream::CheckWriteLocked() - Stream is closed. "
+         "[this=%p, status=0x%08" PRIx32"]", this,
+         static_cast<uint32_t>(mStatus)));
 
     return NS_FAILED(mStatus) ? mStatus : NS_BASE_STREAM_CLOSED;
   }
 
   if (!mFile->mSkipSizeCheck && CacheObserver::EntryIsTooBig(mPos + aCount, !mFile->mMemoryOnly)) {
-    LOG(("CacheFileOutputStream::Write() - Entry is too big, failing and "
-         "dooming the entry. [this=%p]", this));
+    LOG(("CacheFileOutputStream::CheckWriteLocked() - Entry is too big, "
+         "failing and dooming the entry. [this=%p]", this));
 
     mFile->DoomLocked(nullptr);
     CloseWithStatusLocked(NS_ERROR_FILE_TOO_BIG);
@@ -110,18 +172,38 @@ CacheFileOutputStream::Write(const char * aBuf, uint32_t aCount,
   // We use 64-bit offset when accessing the file, unfortunately we use 32-bit
   // metadata offset, so we cannot handle data bigger than 4GB.
   if (mPos + aCount > PR_UINT32_MAX) {
-    LOG(("CacheFileOutputStream::Write() - Entry's size exceeds 4GB while it "
-         "isn't too big according to CacheObserver::EntryIsTooBig(). Failing "
-         "and dooming the entry. [this=%p]", this));
+    LOG(("CacheFileOutputStream::CheckWriteLocked() - Entry's size exceeds "
+         "4GB while it isn't too big according to "
+         "CacheObserver::EntryIsTooBig(). Failing and dooming the entry. "
+         "[this=%p]", this));
 
     mFile->DoomLocked(nullptr);
     CloseWithStatusLocked(NS_ERROR_FILE_TOO_BIG);
     return NS_ERROR_FILE_TOO_BIG;
   }
 
-  *_retval = aCount;
+  return NS_OK;
+}
+
+nsresult
+CacheFileOutputStream::WriteSegmentsLocked(nsReadSegmentFun aReader,
+                                           void *aClosure, uint32_t aCount,
+                                           uint32_t *_retval)
+{
+  *_retval = 0;
 
   while (aCount) {
+    uint32_t chunkOffset = mPos - (mPos / kChunkSize) * kChunkSize;
+    uint32_t canWrite = kChunkSize - chunkOffset;
+    uint32_t thisWrite = std::min(static_cast<uint32_t>(canWrite), aCount);
+
+    // The size of the entry is checked per chunk since the reader may
+    // provide less data than the caller asked for.
+    nsresult rv = CheckWriteLocked(thisWrite);
+    if (NS_FAILED(rv)) {
+      return rv;
+    }
+
     EnsureCorrectChunk(false);
     if (NS_FAILED(mStatus)) {
       return mStatus;
@@ -132,52 +214,34 @@ CacheFileOutputStream::Write(const char * aBuf, uint32_t aCount,
       return mStatus;
     }
 
-    uint32_t chunkOffset = mPos - (mPos / kChunkSize) * kChunkSize;
-    uint32_t canWrite = kChunkSize - chunkOffset;
-    uint32_t thisWrite = std::min(static_cast<uint32_t>(canWrite), aCount);
-
     CacheFileChunkWriteHandle hnd = mChunk->GetWriteHandle(chunkOffset + thisWrite);
     if (!hnd.Buf()) {
       CloseWithStatusLocked(NS_ERROR_OUT_OF_MEMORY);
       return NS_ERROR_OUT_OF_MEMORY;
     }
 
-    memcpy(hnd.Buf() + chunkOffset, aBuf, thisWrite);
-    hnd.UpdateDataSize(chunkOffset, thisWrite);
+    // The reader fills the chunk buffer directly. Errors it returns only
+    // stop the write, they are not propagated to the caller.
+    uint32_t readCount = 0;
+    rv = aReader(this, aClosure, hnd.Buf() + chunkOffset, *_retval, thisWrite,
+                 &readCount);
+    if (NS_FAILED(rv) || readCount == 0) {
+      break;
+    }
+    MOZ_ASSERT(readCount <= thisWrite, "reader read too much");
+
+    hnd.UpdateDataSize(chunkOffset, readCount);
 
-    mPos += thisWrite;
-    aBuf += thisWrite;
-    aCount -= thisWrite;
+    mPos += readCount;
+    *_retval += readCount;
+    aCount -= readCount;
   }
 
   EnsureCorrectChunk(true);
 
-  LOG(("CacheFileOutputStream::Write() - Wrote %d bytes [this=%p]",
-       *_retval, this));
-
   return NS_OK;
 }
 
-NS_IMETHODIMP
-CacheFileOutputStream::WriteFrom(nsIInputStream *aFromStream, uint32_t aCount,
-                                 uint32_t *_retval)
-{
-  LOG(("CacheFileOutputStream::WriteFrom() - NOT_IMPLEMENTED [this=%p, from=%p"
-       ", count=%d]", this, aFromStream, aCount));
-
-  return NS_ERROR_NOT_IMPLEMENTED;
-}
-
-NS_IMETHODIMP
-CacheFileOutputStream::WriteSegments(nsReadSegmentFun aReader, void *aClosure,
-                                     uint32_t aCount, uint32_t *_retval)
-{
-  LOG(("CacheFileOutputStream::WriteSegments() - NOT_IMPLEMENTED [this=%p, "
-       "count=%d]", this, aCount));
-
-  return NS_ERROR_NOT_IMPLEMENTED;
-}
-
 NS_IMETHODIMP
 CacheFileOutputStream::IsNonBlocking(bool *_retval)
 {
@@ -48,6 +48,11 @@ private:
   virtual ~CacheFileOutputStream();
 
   nsresult CloseWithStatusLocked(nsresult aStatus);
+  nsresult CheckWriteLocked(uint32_t aCount);
+  // Lets |aReader| write straight into the chunk buffers.  It is called with
+  // the CacheFile lock held, so it must not touch the same CacheFile.
+  nsresult WriteSegmentsLocked(nsReadSegmentFun aReader, void *aClosure,
+                               uint32_t aCount, uint32_t *_retval);
   void ReleaseChunk();
   void EnsureCorrectChunk(bool aReleaseOnly);
   void FillHole();
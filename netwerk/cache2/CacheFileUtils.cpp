@@ -23,6 +23,8 @@ namespace CacheFileUtils {
 // When the format changes we need to update the version.
 static uint32_t const kAltDataVersion = 1;
 const char *kAltDataKey = "alt-data";
+const char *kChunkCompressionKey = "chunk-compression";
+const char *kCompressedChunksKey = "compressed-chunks";
 
 namespace {
 
@@ -20,6 +20,10 @@ namespace net {
 namespace CacheFileUtils {
 
 extern const char *kAltDataKey;
+// Setting this element asks for storing the chunks of the entry compressed.
+extern const char *kChunkCompressionKey;
+// Sizes of the compressed chunks on the disk, see CacheFile::StoredChunkSize().
+extern const char *kCompressedChunksKey;
 
 already_AddRefed<nsILoadContextInfo>
 ParseKey(const nsACString& aKey,
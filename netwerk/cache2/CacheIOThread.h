@@ -70,6 +70,8 @@ public:
   uint32_t QueueSize(bool highPriority);
 
   uint32_t EventCounter() const { return mEventCounter; }
+  // Callable only on this thread, the level of the event being executed.
+  uint32_t CurrentLevel() const { return mCurrentlyExecutingLevel; }
 
   /**
    * Callable only on this thread, checks if there is an event waiting in
@@ -28,7 +28,12 @@
 #define kMinDumpInterval       20000 // in milliseconds
 #define kMaxBufSize            16384
 #define kIndexVersion          0x00000005
+#define kJournalVersion        0x00000001
 #define kUpdateIndexStartDelay 50000 // in milliseconds
+// The whole index is written instead of appending to the journal once the
+// journal would hold more than 1/kMaxJournalToIndexRatio of the records in the
+// index.
+#define kMaxJournalToIndexRatio 4
 
 #define INDEX_NAME      "index"
 #define TEMP_INDEX_NAME "index.tmp"
@@ -266,6 +271,12 @@ CacheIndex::CacheIndex()
   , mIndexOnDiskIsValid(false)
   , mDontMarkIndexClean(false)
   , mIndexTimeStamp(0)
+  , mIndexFileTimeStamp(0)
+  , mNewIndexFileTimeStamp(0)
+  , mJournalTimeStamp(0)
+  , mJournalRecords(0)
+  , mIndexWasDirty(false)
+  , mWritingJournal(false)
   , mUpdateEventPending(false)
   , mSkipEntries(0)
   , mProcessEntries(0)
@@ -274,6 +285,7 @@ CacheIndex::CacheIndex()
   , mRWBufPos(0)
   , mRWPending(false)
   , mJournalReadSuccessfully(false)
+  , mJournalReadOffset(0)
   , mAsyncGetDiskConsumptionBlocked(false)
 {
   sLock.AssertCurrentThreadOwns();
@@ -1672,11 +1684,19 @@ CacheIndex::WriteIndexToDiskIfNeeded()
     return false;
   }
 
-  if (mIndexStats.Dirty() < kMinUnwrittenChanges) {
+  if (mIndexStats.Unjournaled() < kMinUnwrittenChanges) {
     return false;
   }
 
-  WriteIndexToDisk();
+  // Appending the changes to the journal is cheaper than writing the whole
+  // index, but all of them are merged when reading the index.
+  if (mIndexOnDiskIsValid && !mDontMarkIndexClean &&
+      (static_cast<uint64_t>(mJournalRecords) + mIndexStats.Unjournaled()) *
+      kMaxJournalToIndexRatio <= mIndexStats.ActiveEntriesCount()) {
+    WriteJournalToDisk();
+  } else {
+    WriteIndexToDisk();
+  }
   return true;
 }
 
@@ -1720,8 +1740,11 @@ CacheIndex::WriteIndexToDisk()
   NetworkEndian::writeUint32(mRWBuf + mRWBufPos, kIndexVersion);
   mRWBufPos += sizeof(uint32_t);
   // timestamp
-  NetworkEndian::writeUint32(mRWBuf + mRWBufPos,
-                             static_cast<uint32_t>(PR_Now() / PR_USEC_PER_SEC));
+  // The timestamp identifies the index file the journal belongs to, so it
+  // must differ from the one of the current index file.
+  mNewIndexFileTimeStamp = std::max(
+    static_cast<uint32_t>(PR_Now() / PR_USEC_PER_SEC), mIndexFileTimeStamp + 1);
+  NetworkEndian::writeUint32(mRWBuf + mRWBufPos, mNewIndexFileTimeStamp);
   mRWBufPos += sizeof(uint32_t);
   // dirty flag
   NetworkEndian::writeUint32(mRWBuf + mRWBufPos, 1);
@@ -1823,10 +1846,119 @@ CacheIndex::WriteRecords()
   mRWBufPos = 0;
 }
 
+void
+CacheIndex::WriteJournalToDisk()
+{
+  LOG(("CacheIndex::WriteJournalToDisk() [journalRecords=%u]",
+       mJournalRecords));
+  mIndexStats.Log();
+
+  nsresult rv;
+
+  sLock.AssertCurrentThreadOwns();
+  MOZ_ASSERT(mState == READY);
+  MOZ_ASSERT(mIndexOnDiskIsValid);
+  MOZ_ASSERT(!mRWBuf);
+  MOZ_ASSERT(!mRWHash);
+  MOZ_ASSERT(!mRWPending);
+
+  ChangeState(WRITING);
+  mWritingJournal = true;
+
+  mProcessEntries = mIndexStats.Unjournaled();
+
+  mJournalFileOpener = new FileOpenHelper(this);
+  rv = CacheFileIOManager::OpenFile(NS_LITERAL_CSTRING(JOURNAL_NAME),
+                                    CacheFileIOManager::SPECIAL_FILE |
+                                    CacheFileIOManager::CREATE,
+                                    mJournalFileOpener);
+  if (NS_FAILED(rv)) {
+    LOG(("CacheIndex::WriteJournalToDisk() - Can't open file [rv=0x%08" PRIx32
+         "]", static_cast<uint32_t>(rv)));
+    FinishWrite(false);
+  }
+}
+
+void
+CacheIndex::WriteJournalSegment()
+{
+  LOG(("CacheIndex::WriteJournalSegment()"));
+
+  nsresult rv;
+
+  sLock.AssertCurrentThreadOwns();
+  MOZ_ASSERT(mState == WRITING);
+  MOZ_ASSERT(mWritingJournal);
+  MOZ_ASSERT(mJournalHandle);
+  MOZ_ASSERT(!mRWPending);
+
+  // The first segment also starts a new journal for the current index file,
+  // replacing any journal written for a previous one.
+  bool newJournal = mJournalRecords == 0;
+  int64_t fileOffset = newJournal ? 0 : mJournalHandle->FileSize();
+
+  mRWBufSize = sizeof(CacheIndexJournalSegmentHeader) +
+               mProcessEntries * sizeof(CacheIndexRecord) +
+               sizeof(CacheHash::Hash32_t);
+  if (newJournal) {
+    mRWBufSize += sizeof(CacheIndexJournalHeader);
+  }
+  mRWBuf = static_cast<char *>(moz_xmalloc(mRWBufSize));
+  mRWBufPos = 0;
+
+  if (newJournal) {
+    NetworkEndian::writeUint32(mRWBuf + mRWBufPos, kJournalVersion);
+    mRWBufPos += sizeof(uint32_t);
+    NetworkEndian::writeUint32(mRWBuf + mRWBufPos, mIndexFileTimeStamp);
+    mRWBufPos += sizeof(uint32_t);
+  }
+
+  uint32_t hashOffset = mRWBufPos;
+  NetworkEndian::writeUint32(mRWBuf + mRWBufPos, mProcessEntries);
+  mRWBufPos += sizeof(uint32_t);
+  NetworkEndian::writeUint32(mRWBuf + mRWBufPos,
+                             static_cast<uint32_t>(PR_Now() / PR_USEC_PER_SEC));
+  mRWBufPos += sizeof(uint32_t);
+
+  uint32_t processed = 0;
+  for (auto iter = mIndex.Iter(); !iter.Done(); iter.Next()) {
+    CacheIndexEntry* entry = iter.Get();
+    if (!entry->IsDirty() || entry->IsJournaled()) {
+      continue;
+    }
+
+    MOZ_ASSERT(processed < mProcessEntries);
+    entry->WriteToBuf(mRWBuf + mRWBufPos);
+    mRWBufPos += sizeof(CacheIndexRecord);
+    processed++;
+  }
+  MOZ_ASSERT(processed == mProcessEntries);
+
+  RefPtr<CacheHash> hash = new CacheHash();
+  hash->Update(mRWBuf + hashOffset, mRWBufPos - hashOffset);
+  NetworkEndian::writeUint32(mRWBuf + mRWBufPos, hash->GetHash());
+  mRWBufPos += sizeof(CacheHash::Hash32_t);
+  MOZ_ASSERT(mRWBufPos == mRWBufSize);
+
+  rv = CacheFileIOManager::Write(mJournalHandle, fileOffset, mRWBuf, mRWBufPos,
+                                 false, newJournal, this);
+  if (NS_FAILED(rv)) {
+    LOG(("CacheIndex::WriteJournalSegment() - CacheFileIOManager::Write() "
+         "failed synchronously [rv=0x%08" PRIx32 "]",
+         static_cast<uint32_t>(rv)));
+    FinishWrite(false);
+  } else {
+    mRWPending = true;
+  }
+
+  mRWBufPos = 0;
+}
+
 void
 CacheIndex::FinishWrite(bool aSucceeded)
 {
-  LOG(("CacheIndex::FinishWrite() [succeeded=%d]", aSucceeded));
+  LOG(("CacheIndex::FinishWrite() [succeeded=%d, journal=%d]", aSucceeded,
+       mWritingJournal));
 
   MOZ_ASSERT((!aSucceeded && mState == SHUTDOWN) || mState == WRITING);
 
@@ -1840,6 +1972,56 @@ CacheIndex::FinishWrite(bool aSucceeded)
   mRWHash = nullptr;
   ReleaseBuffer();
 
+  if (mWritingJournal) {
+    mWritingJournal = false;
+
+    if (mJournalFileOpener) {
+      MOZ_ASSERT(!aSucceeded);
+      mJournalFileOpener->Cancel();
+      mJournalFileOpener = nullptr;
+    }
+
+    if (aSucceeded) {
+      for (auto iter = mIndex.Iter(); !iter.Done(); iter.Next()) {
+        CacheIndexEntry* entry = iter.Get();
+        if (entry->IsDirty() && !entry->IsJournaled()) {
+          CacheIndexEntryAutoManage emng(entry->Hash(), this);
+          entry->MarkJournaled();
+        }
+      }
+
+      mJournalRecords += mProcessEntries;
+    } else {
+      // The journal might end with a partially written segment now. Throw it
+      // away and start a new one containing all dirty entries next time. The
+      // journal is rewritten completely when shutting down anyway.
+      if (mJournalHandle && mState != SHUTDOWN) {
+        CacheFileIOManager::DoomFile(mJournalHandle, nullptr);
+      }
+
+      for (auto iter = mIndex.Iter(); !iter.Done(); iter.Next()) {
+        CacheIndexEntry* entry = iter.Get();
+        if (entry->IsJournaled()) {
+          CacheIndexEntryAutoManage emng(entry->Hash(), this);
+          entry->MarkDirty();
+        }
+      }
+
+      mJournalRecords = 0;
+    }
+
+    mJournalHandle = nullptr;
+
+    ProcessPendingOperations();
+    mIndexStats.Log();
+
+    if (mState == WRITING) {
+      ChangeState(READY);
+      mLastDumpTime = TimeStamp::NowLoRes();
+    }
+    return;
+  }
+
   if (aSucceeded) {
     // Opening of the file must not be in progress if writing succeeded.
     MOZ_ASSERT(!mIndexFileOpener);
@@ -1864,6 +2046,11 @@ CacheIndex::FinishWrite(bool aSucceeded)
     }
 
     mIndexOnDiskIsValid = true;
+
+    // The new index contains all changes from the journal that was written
+    // for the previous one. The next segment replaces it.
+    mIndexFileTimeStamp = mNewIndexFileTimeStamp;
+    mJournalRecords = 0;
   } else {
     if (mIndexFileOpener) {
       // If opening of the file is still in progress (e.g. WRITE process was
@@ -1959,6 +2146,7 @@ public:
     free(mBuf);
   }
 
+  void Start(uint32_t aIndexTimeStamp, uint32_t aCount);
   nsresult AddEntry(CacheIndexEntry *aEntry);
   nsresult Finish();
 
@@ -1973,20 +2161,39 @@ private:
   RefPtr<CacheHash> mHash;
 };
 
+void
+WriteLogHelper::Start(uint32_t aIndexTimeStamp, uint32_t aCount)
+{
+  MOZ_ASSERT(mBufPos == 0);
+
+  NetworkEndian::writeUint32(mBuf + mBufPos, kJournalVersion);
+  mBufPos += sizeof(uint32_t);
+  NetworkEndian::writeUint32(mBuf + mBufPos, aIndexTimeStamp);
+  mBufPos += sizeof(uint32_t);
+
+  // The journal written at shutdown consists of a single segment.
+  char *segment = mBuf + mBufPos;
+  NetworkEndian::writeUint32(mBuf + mBufPos, aCount);
+  mBufPos += sizeof(uint32_t);
+  NetworkEndian::writeUint32(mBuf + mBufPos,
+                             static_cast<uint32_t>(PR_Now() / PR_USEC_PER_SEC));
+  mBufPos += sizeof(uint32_t);
+  mHash->Update(segment, mBufPos - (segment - mBuf));
+}
+
 nsresult
 WriteLogHelper::AddEntry(CacheIndexEntry *aEntry)
 {
   nsresult rv;
 
   if (mBufPos + sizeof(CacheIndexRecord) > mBufSize) {
-    mHash->Update(mBuf, mBufPos);
-
     rv = FlushBuffer();
     NS_ENSURE_SUCCESS(rv, rv);
     MOZ_ASSERT(mBufPos + sizeof(CacheIndexRecord) <= mBufSize);
   }
 
   aEntry->WriteToBuf(mBuf + mBufPos);
+  mHash->Update(mBuf + mBufPos, sizeof(CacheIndexRecord));
   mBufPos += sizeof(CacheIndexRecord);
 
   return NS_OK;
@@ -1997,7 +2204,6 @@ WriteLogHelper::Finish()
 {
   nsresult rv;
 
-  mHash->Update(mBuf, mBufPos);
   if (mBufPos + sizeof(CacheHash::Hash32_t) > mBufSize) {
     rv = FlushBuffer();
     NS_ENSURE_SUCCESS(rv, rv);
@@ -2063,7 +2269,16 @@ CacheIndex::WriteLogToDisk()
                                  0600, &fd);
   NS_ENSURE_SUCCESS(rv, rv);
 
+  uint32_t count = 0;
+  for (auto iter = mIndex.Iter(); !iter.Done(); iter.Next()) {
+    CacheIndexEntry* entry = iter.Get();
+    if (entry->IsRemoved() || entry->IsDirty()) {
+      count++;
+    }
+  }
+
   WriteLogHelper wlh(fd);
+  wlh.Start(mIndexFileTimeStamp, count);
   for (auto iter = mIndex.Iter(); !iter.Done(); iter.Next()) {
     CacheIndexEntry* entry = iter.Get();
     if (entry->IsRemoved() || entry->IsDirty()) {
@@ -2214,13 +2429,13 @@ CacheIndex::ParseRecords()
     pos += sizeof(uint32_t);
 
     mIndexTimeStamp = NetworkEndian::readUint32(mRWBuf + pos);
+    mIndexFileTimeStamp = mIndexTimeStamp;
     pos += sizeof(uint32_t);
 
     if (NetworkEndian::readUint32(mRWBuf + pos)) {
-      if (mJournalHandle) {
-        CacheFileIOManager::DoomFile(mJournalHandle, nullptr);
-        mJournalHandle = nullptr;
-      }
+      // We didn't shut down cleanly. The journal still contains the changes
+      // appended to it before the crash, so keep it.
+      mIndexWasDirty = true;
     } else {
       uint32_t * isDirty = reinterpret_cast<uint32_t *>(
                              moz_xmalloc(sizeof(uint32_t)));
@@ -2334,17 +2549,15 @@ CacheIndex::StartReadingJournal()
   MOZ_ASSERT(mJournalHandle->FileSize() >= 0);
   MOZ_ASSERT(!mRWPending);
 
-  int64_t entriesSize = mJournalHandle->FileSize() -
-                        sizeof(CacheHash::Hash32_t);
-
-  if (entriesSize < 0 || entriesSize % sizeof(CacheIndexRecord)) {
+  if (mJournalHandle->FileSize() <
+      static_cast<int64_t>(sizeof(CacheIndexJournalHeader))) {
     LOG(("CacheIndex::StartReadingJournal() - Journal is corrupted"));
     FinishRead(false);
     return;
   }
 
-  mSkipEntries = 0;
-  mRWHash = new CacheHash();
+  mJournalReadOffset = 0;
+  mJournalTimeStamp = 0;
 
   mRWBufPos = std::min(mRWBufSize,
                        static_cast<uint32_t>(mJournalHandle->FileSize()));
@@ -2370,61 +2583,134 @@ CacheIndex::ParseJournal()
 
   MOZ_ASSERT(!mRWPending);
 
-  uint32_t entryCnt = (mJournalHandle->FileSize() -
-                       sizeof(CacheHash::Hash32_t)) / sizeof(CacheIndexRecord);
-
+  int64_t fileSize = mJournalHandle->FileSize();
   uint32_t pos = 0;
 
-  while (pos + sizeof(CacheIndexRecord) <= mRWBufPos &&
-         mSkipEntries != entryCnt) {
-    CacheIndexEntry tmpEntry(reinterpret_cast<SHA1Sum::Hash *>(mRWBuf + pos));
-    tmpEntry.ReadFromBuf(mRWBuf + pos);
-
-    CacheIndexEntry *entry = mTmpJournal.PutEntry(*tmpEntry.Hash());
-    *entry = tmpEntry;
-
-    if (entry->IsDirty() || entry->IsFresh()) {
-      LOG(("CacheIndex::ParseJournal() - Invalid entry found in journal, "
-           "ignoring whole journal [dirty=%d, fresh=%d]", entry->IsDirty(),
-           entry->IsFresh()));
+  if (mJournalReadOffset == 0) {
+    if (NetworkEndian::readUint32(mRWBuf + pos) != kJournalVersion) {
       FinishRead(false);
       return;
     }
+    pos += sizeof(uint32_t);
 
-    pos += sizeof(CacheIndexRecord);
-    mSkipEntries++;
+    uint32_t indexTimeStamp = NetworkEndian::readUint32(mRWBuf + pos);
+    if (indexTimeStamp != mIndexFileTimeStamp) {
+      // The journal belongs to an older index. Changes written to it are
+      // already contained in the index file.
+      LOG(("CacheIndex::ParseJournal() - Journal doesn't belong to the index "
+           "[journal=%u, index=%u]", indexTimeStamp, mIndexFileTimeStamp));
+      FinishRead(false);
+      return;
+    }
+    pos += sizeof(uint32_t);
   }
 
-  mRWHash->Update(mRWBuf, pos);
+  // Size of the segment at pos, or of its header if that isn't read yet.
+  uint64_t segmentSize = sizeof(CacheIndexJournalSegmentHeader);
+  bool validTail = true;
 
-  if (pos != mRWBufPos) {
-    memmove(mRWBuf, mRWBuf + pos, mRWBufPos - pos);
-  }
+  while (pos + sizeof(CacheIndexJournalSegmentHeader) <= mRWBufPos) {
+    uint32_t count = NetworkEndian::readUint32(mRWBuf + pos);
+    segmentSize = sizeof(CacheIndexJournalSegmentHeader) +
+                  static_cast<uint64_t>(count) * sizeof(CacheIndexRecord) +
+                  sizeof(CacheHash::Hash32_t);
 
-  mRWBufPos -= pos;
-  pos = 0;
+    if (mJournalReadOffset + pos + segmentSize >
+        static_cast<uint64_t>(fileSize)) {
+      LOG(("CacheIndex::ParseJournal() - Journal ends with an incomplete "
+           "segment [count=%u]", count));
+      validTail = false;
+      break;
+    }
 
-  int64_t fileOffset = mSkipEntries * sizeof(CacheIndexRecord) + mRWBufPos;
+    if (pos + segmentSize > mRWBufPos) {
+      // Read the rest of the segment first.
+      break;
+    }
 
-  MOZ_ASSERT(fileOffset <= mJournalHandle->FileSize());
-  if (fileOffset == mJournalHandle->FileSize()) {
-    uint32_t expectedHash = NetworkEndian::readUint32(mRWBuf);
-    if (mRWHash->GetHash() != expectedHash) {
+    uint32_t hashOffset = pos + segmentSize - sizeof(CacheHash::Hash32_t);
+    RefPtr<CacheHash> hash = new CacheHash();
+    hash->Update(mRWBuf + pos, hashOffset - pos);
+    uint32_t expectedHash = NetworkEndian::readUint32(mRWBuf + hashOffset);
+    if (hash->GetHash() != expectedHash) {
       LOG(("CacheIndex::ParseJournal() - Hash mismatch, [is %x, should be %x]",
-           mRWHash->GetHash(), expectedHash));
-      FinishRead(false);
-      return;
+           hash->GetHash(), expectedHash));
+      validTail = false;
+      break;
+    }
+
+    uint32_t timeStamp = NetworkEndian::readUint32(mRWBuf + pos +
+                                                   sizeof(uint32_t));
+    pos += sizeof(CacheIndexJournalSegmentHeader);
+
+    for (uint32_t i = 0; i < count; ++i) {
+      CacheIndexEntry tmpEntry(reinterpret_cast<SHA1Sum::Hash *>(mRWBuf + pos));
+      tmpEntry.ReadFromBuf(mRWBuf + pos);
+
+      if (tmpEntry.IsDirty() || tmpEntry.IsFresh()) {
+        LOG(("CacheIndex::ParseJournal() - Invalid entry found in journal, "
+             "ignoring whole journal [dirty=%d, fresh=%d]", tmpEntry.IsDirty(),
+             tmpEntry.IsFresh()));
+        FinishRead(false);
+        return;
+      }
+
+      // Later segments override earlier ones.
+      CacheIndexEntry *entry = mTmpJournal.PutEntry(*tmpEntry.Hash());
+      *entry = tmpEntry;
+
+      pos += sizeof(CacheIndexRecord);
     }
 
+    pos += sizeof(CacheHash::Hash32_t);
+    mJournalTimeStamp = timeStamp;
+    segmentSize = sizeof(CacheIndexJournalSegmentHeader);
+  }
+
+  if (validTail && mJournalReadOffset + pos == fileSize) {
     mJournalReadSuccessfully = true;
     FinishRead(true);
     return;
   }
 
+  if (!validTail || mJournalReadOffset + mRWBufPos == fileSize) {
+    // The journal is damaged past the last complete segment, which happens
+    // when we crash while appending to it. The index file is dirty then and
+    // it is updated with the files modified since the last segment was
+    // written. Otherwise we don't know what is missing.
+    LOG(("CacheIndex::ParseJournal() - Journal has invalid tail "
+         "[offset=%" PRId64 ", indexWasDirty=%d]", mJournalReadOffset + pos,
+         mIndexWasDirty));
+    if (mIndexWasDirty) {
+      mJournalReadSuccessfully = true;
+      FinishRead(true);
+    } else {
+      FinishRead(false);
+    }
+    return;
+  }
+
+  if (pos != mRWBufPos) {
+    memmove(mRWBuf, mRWBuf + pos, mRWBufPos - pos);
+  }
+
+  mRWBufPos -= pos;
+  mJournalReadOffset += pos;
+  pos = 0;
+
+  // Make sure the whole segment fits into the buffer. Its size was checked
+  // against the size of the file above.
+  if (segmentSize > mRWBufSize) {
+    mRWBufSize = static_cast<uint32_t>(segmentSize);
+    mRWBuf = static_cast<char *>(moz_xrealloc(mRWBuf, mRWBufSize));
+  }
+
+  int64_t fileOffset = mJournalReadOffset + mRWBufPos;
+
+  MOZ_ASSERT(fileOffset < fileSize);
   pos = mRWBufPos;
   uint32_t toRead = std::min(mRWBufSize - pos,
-                             static_cast<uint32_t>(mJournalHandle->FileSize() -
-                                                   fileOffset));
+                             static_cast<uint32_t>(fileSize - fileOffset));
   mRWBufPos = pos + toRead;
 
   rv = CacheFileIOManager::Read(mJournalHandle, fileOffset, mRWBuf + pos,
@@ -2582,6 +2868,14 @@ CacheIndex::FinishRead(bool aSucceeded)
   ProcessPendingOperations();
   mIndexStats.Log();
 
+  if (mIndexWasDirty) {
+    // Only files modified after the last complete segment of the journal
+    // can be missing in the index.
+    mIndexTimeStamp = std::max(mIndexTimeStamp, mJournalTimeStamp);
+    StartUpdatingIndex(false);
+    return;
+  }
+
   ChangeState(READY);
   mLastDumpTime = TimeStamp::NowLoRes(); // Do not dump new index immediately
 }
@@ -2700,6 +2994,11 @@ CacheIndex::SetupDirectoryEnumerator()
     return NS_ERROR_UNEXPECTED;
   }
 
+  // The entries are stat'ed once while being enumerated, instead of once for
+  // each of Exists(), GetLastModifiedTime() and GetFileSize() below.
+  rv = file->SetUseStatCache(true);
+  NS_ENSURE_SUCCESS(rv, rv);
+
   nsCOMPtr<nsISimpleEnumerator> enumerator;
   rv = file->GetDirectoryEntries(getter_AddRefs(enumerator));
   NS_ENSURE_SUCCESS(rv, rv);
@@ -3540,6 +3839,22 @@ CacheIndex::OnFileOpenedInternal(FileOpenHelper *aOpener,
 
   switch (mState) {
     case WRITING:
+      if (mWritingJournal) {
+        MOZ_ASSERT(aOpener == mJournalFileOpener);
+        mJournalFileOpener = nullptr;
+
+        if (NS_FAILED(aResult)) {
+          LOG(("CacheIndex::OnFileOpenedInternal() - Can't open journal for "
+               "writing [rv=0x%08" PRIx32 "]",
+               static_cast<uint32_t>(aResult)));
+          FinishWrite(false);
+        } else {
+          mJournalHandle = aHandle;
+          WriteJournalSegment();
+        }
+        break;
+      }
+
       MOZ_ASSERT(aOpener == mIndexFileOpener);
       mIndexFileOpener = nullptr;
 
@@ -3587,16 +3902,11 @@ CacheIndex::OnFileOpenedInternal(FileOpenHelper *aOpener,
       MOZ_ASSERT(mIndexHandle);
 
       if (mTmpHandle) {
+        // This is either a new index that wasn't completely written or a
+        // journal that wasn't completely read before a crash. The journal
+        // appended to during the session (if any) still belongs to the index.
         CacheFileIOManager::DoomFile(mTmpHandle, nullptr);
         mTmpHandle = nullptr;
-
-        if (mJournalHandle) { // this shouldn't normally happen
-          LOG(("CacheIndex::OnFileOpenedInternal() - Unexpected state, all "
-               "files [%s, %s, %s] should never exist. Removing whole index.",
-               INDEX_NAME, JOURNAL_NAME, TEMP_INDEX_NAME));
-          FinishRead(false);
-          break;
-        }
       }
 
       if (mJournalHandle) {
@@ -3653,10 +3963,12 @@ CacheIndex::OnDataWritten(CacheFileHandle *aHandle, const char *aBuf,
 
   switch (mState) {
     case WRITING:
-      MOZ_ASSERT(mIndexHandle == aHandle);
+      MOZ_ASSERT(mIndexHandle == aHandle || mJournalHandle == aHandle);
 
       if (NS_FAILED(aResult)) {
         FinishWrite(false);
+      } else if (mWritingJournal) {
+        FinishWrite(true);
       } else {
         if (mSkipEntries == mProcessEntries) {
           rv = CacheFileIOManager::RenameFile(mIndexHandle,
@@ -54,9 +54,9 @@ typedef struct {
   uint32_t mTimeStamp;
 
   // We set this flag as soon as possible after parsing index during startup
-  // and clean it after we write journal to disk during shutdown. We ignore the
-  // journal and start update process whenever this flag is set during index
-  // parsing.
+  // and clean it after we write journal to disk during shutdown. When this flag
+  // is set during index parsing we merge only the complete segments from the
+  // journal and start update process for files modified after the last one.
   uint32_t mIsDirty;
 } CacheIndexHeader;
 
@@ -65,6 +65,28 @@ static_assert(
   sizeof(CacheIndexHeader::mIsDirty) == sizeof(CacheIndexHeader),
   "Unexpected sizeof(CacheIndexHeader)!");
 
+// The journal file starts with this header and continues with segments that
+// are appended while the index is in use and during shutdown. Every segment
+// consists of CacheIndexJournalSegmentHeader, mCount records and a hash of the
+// segment header and the records.
+typedef struct {
+  // Version of the journal format.
+  uint32_t mVersion;
+
+  // Timestamp from the header of the index file the journal applies to. The
+  // journal is ignored when it doesn't match.
+  uint32_t mIndexTimeStamp;
+} CacheIndexJournalHeader;
+
+typedef struct {
+  // Number of records in the segment.
+  uint32_t mCount;
+
+  // Timestamp of time when writing of the segment started. Files last modified
+  // before this time are described by the index merged with the journal.
+  uint32_t mTimeStamp;
+} CacheIndexJournalSegmentHeader;
+
 #pragma pack(push, 4)
 struct CacheIndexRecord {
   SHA1Sum::Hash   mHash;
@@ -82,7 +104,7 @@ struct CacheIndexRecord {
    *    0000 1000 0000 0000 0000 0000 0000 0000 : fresh
    *    0000 0100 0000 0000 0000 0000 0000 0000 : pinned
    *    0000 0010 0000 0000 0000 0000 0000 0000 : has cached alt data
-   *    0000 0001 0000 0000 0000 0000 0000 0000 : reserved
+   *    0000 0001 0000 0000 0000 0000 0000 0000 : journaled
    *    0000 0000 1111 1111 1111 1111 1111 1111 : file size (in kB)
    */
   uint32_t        mFlags;
@@ -208,8 +230,11 @@ public:
   void MarkRemoved() { mRec->mFlags |= kRemovedMask; }
 
   bool IsDirty() const { return !!(mRec->mFlags & kDirtyMask); }
-  void MarkDirty() { mRec->mFlags |= kDirtyMask; }
-  void ClearDirty() { mRec->mFlags &= ~kDirtyMask; }
+  void MarkDirty() { mRec->mFlags = (mRec->mFlags | kDirtyMask) & ~kJournaledMask; }
+  void ClearDirty() { mRec->mFlags &= ~(kDirtyMask | kJournaledMask); }
+
+  bool IsJournaled() const { return !!(mRec->mFlags & kJournaledMask); }
+  void MarkJournaled() { mRec->mFlags |= kJournaledMask; }
 
   bool IsFresh() const { return !!(mRec->mFlags & kFreshMask); }
   void MarkFresh() { mRec->mFlags |= kFreshMask; }
@@ -276,9 +301,10 @@ public:
     NetworkEndian::writeUint32(ptr, mRec->mExpirationTime); ptr += sizeof(uint32_t);
     NetworkEndian::writeUint16(ptr, mRec->mOnStartTime); ptr += sizeof(uint16_t);
     NetworkEndian::writeUint16(ptr, mRec->mOnStopTime); ptr += sizeof(uint16_t);
-    // Dirty and fresh flags should never go to disk, since they make sense only
-    // during current session.
-    NetworkEndian::writeUint32(ptr, mRec->mFlags & ~(kDirtyMask | kFreshMask));
+    // Dirty, fresh and journaled flags should never go to disk, since they
+    // make sense only during current session.
+    NetworkEndian::writeUint32(ptr, mRec->mFlags & ~(kDirtyMask | kFreshMask |
+                                                     kJournaledMask));
   }
 
   void ReadFromBuf(void *aBuf)
@@ -290,7 +316,7 @@ public:
     mRec->mExpirationTime = NetworkEndian::readUint32(ptr); ptr += sizeof(uint32_t);
     mRec->mOnStartTime = NetworkEndian::readUint16(ptr); ptr += sizeof(uint16_t);
     mRec->mOnStopTime = NetworkEndian::readUint16(ptr); ptr += sizeof(uint16_t);
-    mRec->mFlags = NetworkEndian::readUint32(ptr);
+    mRec->mFlags = NetworkEndian::readUint32(ptr) & ~kJournaledMask;
   }
 
   void Log() const {
@@ -355,7 +381,10 @@ private:
 
   // Indicates there is cached alternative data in the entry.
   static const uint32_t kHasAltDataMask = 0x02000000;
-  static const uint32_t kReservedMask    = 0x01000000;
+
+  // This flag is set when the dirty entry was appended to the journal on disk
+  // in its current state. It is cleared whenever the entry is marked dirty.
+  static const uint32_t kJournaledMask   = 0x01000000;
 
   // FileSize in kilobytes
   static const uint32_t kFileSizeMask    = 0x00FFFFFF;
@@ -462,6 +491,9 @@ public:
       aDst->mRec->mFlags &= kFileSizeMask;
       aDst->mRec->mFlags |= (mRec->mFlags & ~kHasAltDataMask & ~kFileSizeMask);
     }
+
+    // The updated entry differs from what is in the journal.
+    aDst->mRec->mFlags &= ~kJournaledMask;
   }
 
 private:
@@ -483,6 +515,7 @@ public:
     , mNotInitialized(0)
     , mRemoved(0)
     , mDirty(0)
+    , mUnjournaled(0)
     , mFresh(0)
     , mEmpty(0)
     , mSize(0)
@@ -503,6 +536,7 @@ public:
            aOther.mNotInitialized == mNotInitialized &&
            aOther.mRemoved == mRemoved &&
            aOther.mDirty == mDirty &&
+           aOther.mUnjournaled == mUnjournaled &&
            aOther.mFresh == mFresh &&
            aOther.mEmpty == mEmpty &&
            aOther.mSize == mSize;
@@ -516,8 +550,9 @@ public:
 
   void Log() {
     LOG(("CacheIndexStats::Log() [count=%u, notInitialized=%u, removed=%u, "
-         "dirty=%u, fresh=%u, empty=%u, size=%u]", mCount, mNotInitialized,
-         mRemoved, mDirty, mFresh, mEmpty, mSize));
+         "dirty=%u, unjournaled=%u, fresh=%u, empty=%u, size=%u]", mCount,
+         mNotInitialized, mRemoved, mDirty, mUnjournaled, mFresh, mEmpty,
+         mSize));
   }
 
   void Clear() {
@@ -527,6 +562,7 @@ public:
     mNotInitialized = 0;
     mRemoved = 0;
     mDirty = 0;
+    mUnjournaled = 0;
     mFresh = 0;
     mEmpty = 0;
     mSize = 0;
@@ -548,6 +584,13 @@ public:
     return mDirty;
   }
 
+  // Number of dirty entries that are not in the journal on disk.
+  uint32_t Unjournaled() {
+    MOZ_ASSERT(!mStateLogged, "CacheIndexStats::Unjournaled() - state "
+               "logged!");
+    return mUnjournaled;
+  }
+
   uint32_t Fresh() {
     MOZ_ASSERT(!mStateLogged, "CacheIndexStats::Fresh() - state logged!");
     return mFresh;
@@ -583,6 +626,10 @@ public:
       if (aEntry->IsDirty()) {
         MOZ_ASSERT(mDirty);
         mDirty--;
+        if (!aEntry->IsJournaled()) {
+          MOZ_ASSERT(mUnjournaled);
+          mUnjournaled--;
+        }
       }
       if (aEntry->IsFresh()) {
         MOZ_ASSERT(mFresh);
@@ -618,6 +665,9 @@ public:
       ++mCount;
       if (aEntry->IsDirty()) {
         mDirty++;
+        if (!aEntry->IsJournaled()) {
+          mUnjournaled++;
+        }
       }
       if (aEntry->IsFresh()) {
         mFresh++;
@@ -650,6 +700,7 @@ private:
   uint32_t mNotInitialized;
   uint32_t mRemoved;
   uint32_t mDirty;
+  uint32_t mUnjournaled;
   uint32_t mFresh;
   uint32_t mEmpty;
   uint32_t mSize;
@@ -822,32 +873,41 @@ private:
   // Merge all pending operations from mPendingUpdates into mIndex.
   void ProcessPendingOperations();
 
-  // Following methods perform writing of the index file.
+  // Following methods perform writing of the index file and of the journal
+  // while the index is in use.
   //
-  // The index is written periodically, but not earlier than once in
+  // The changes are written periodically, but not earlier than once in
   // kMinDumpInterval and there must be at least kMinUnwrittenChanges
-  // differences between index on disk and in memory. Index is always first
-  // written to a temporary file and the old index file is replaced when the
-  // writing process succeeds.
+  // differences between the files on disk and the index in memory. The
+  // changes are appended to the journal as a new segment until the journal
+  // holds more than 1/kMaxJournalToIndexRatio of the records in the index,
+  // then the whole index is written. Index is always first written to a
+  // temporary file and the old index file is replaced when the writing
+  // process succeeds, after which the journal is removed.
   //
-  // Starts writing of index when both limits (minimal delay between writes and
-  // minimum number of changes in index) were exceeded.
+  // Starts writing of index or journal when both limits (minimal delay between
+  // writes and minimum number of changes in index) were exceeded.
   bool WriteIndexToDiskIfNeeded();
   // Starts writing of index file.
   void WriteIndexToDisk();
   // Serializes part of mIndex hashtable to the write buffer a writes the buffer
   // to the file.
   void WriteRecords();
+  // Starts appending a segment to the journal file.
+  void WriteJournalToDisk();
+  // Serializes the changes that are not in the journal yet and appends them to
+  // the journal file.
+  void WriteJournalSegment();
   // Finalizes writing process.
   void FinishWrite(bool aSucceeded);
 
   // Following methods perform writing of the journal during shutdown. All these
   // methods must be called only during shutdown since they write/delete files
   // directly on the main thread instead of using CacheFileIOManager that does
-  // it asynchronously on IO thread. Journal contains only entries that are
-  // dirty, i.e. changes that are not present in the index file on the disk.
-  // When the log is written successfully, the dirty flag in index file is
-  // cleared.
+  // it asynchronously on IO thread. Journal is rewritten with a single segment
+  // containing all entries that are dirty, i.e. changes that are not present
+  // in the index file on the disk. When the log is written successfully, the
+  // dirty flag in index file is cleared.
   nsresult GetFile(const nsACString &aName, nsIFile **_retval);
   nsresult RemoveFile(const nsACString &aName);
   void     RemoveAllIndexFiles();
@@ -869,23 +929,29 @@ private:
   // index, journal, tmpfile
   // M      *        *       - index is missing    -> BUILD
   // I      *        *       - index is invalid    -> BUILD
-  // D      *        *       - index is dirty      -> UPDATE
+  // D      M        *       - index is dirty      -> UPDATE
+  // D      I        *       - index is dirty      -> UPDATE
+  // D      V,P      *       - crash after journal segments were written
+  //                                               -> merge journal, UPDATE
+  //                                                  files modified after
+  //                                                  the last segment
   // C      M        *       - index is dirty      -> UPDATE
-  // C      I        *       - unexpected state    -> UPDATE
-  // C      V        E       - unexpected state    -> UPDATE
-  // C      V        M       - index is up to date -> READY
+  // C      I,P      *       - unexpected state    -> UPDATE
+  // C      V        *       - index is up to date -> READY
   //
   // where the letters mean:
   //   * - any state
-  //   E - file exists
   //   M - file is missing
-  //   I - data is invalid (parsing failed or hash didn't match)
+  //   I - data is invalid (parsing failed, hash of the first segment didn't
+  //       match or the journal belongs to another index file)
+  //   P - partially valid (the journal ends with an incomplete or invalid
+  //       segment, e.g. when FF crashed while appending it)
   //   D - dirty (data in index file is correct, but dirty flag is set)
   //   C - clean (index file is clean)
   //   V - valid (data in journal file is correct)
   //
-  // Note: We accept the data from journal only when the index is up to date as
-  // a whole (i.e. C,V,M state).
+  // An existing tmpfile is a leftover of an interrupted write of the index and
+  // it is removed.
   //
   // We rename the journal file to the temporary file as soon as possible after
   // initial test to ensure that we start update process on the next startup if
@@ -1042,8 +1108,21 @@ private:
   // build will be initiated on the next start.
   bool           mDontMarkIndexClean;
   // Timestamp value from index file. It is used during update process to skip
-  // entries that were last modified before this timestamp.
+  // entries that were last modified before this timestamp. When journal
+  // segments are merged after a crash, it is the timestamp of the last one.
   uint32_t       mIndexTimeStamp;
+  // Timestamp in the header of the index file on disk, and of the index file
+  // being written while in WRITING state. The journal is written against it.
+  uint32_t       mIndexFileTimeStamp;
+  uint32_t       mNewIndexFileTimeStamp;
+  // Timestamp of the last journal segment read from disk.
+  uint32_t       mJournalTimeStamp;
+  // Number of records in the journal file on disk.
+  uint32_t       mJournalRecords;
+  // True when the dirty flag was set in the index header during reading.
+  bool           mIndexWasDirty;
+  // True when a segment is being appended to the journal in WRITING state.
+  bool           mWritingJournal;
   // Timestamp of last time the index was dumped to disk.
   // NOTE: The index might not be necessarily dumped at this time. The value
   // is used to schedule next dump of the index.
@@ -1074,10 +1153,13 @@ private:
 
   // Reading of journal succeeded if true.
   bool                      mJournalReadSuccessfully;
+  // Offset in journal file of the data at the beginning of mRWBuf when reading
+  // journal.
+  int64_t                   mJournalReadOffset;
 
   // Handle used for writing and reading index file.
   RefPtr<CacheFileHandle> mIndexHandle;
-  // Handle used for reading journal file.
+  // Handle used for reading journal file and for appending to it.
   RefPtr<CacheFileHandle> mJournalHandle;
   // Used to check the existence of the file during reading process.
   RefPtr<CacheFileHandle> mTmpHandle;
@@ -55,6 +55,8 @@ class CacheObserver : public nsIObserver
                        : sMaxDiskChunksMemoryUsage << 10; }
   static uint32_t CompressionLevel()
     { return sCompressionLevel; }
+  static bool ChunkCompression()
+    { return sChunkCompression; }
   static uint32_t HalfLifeSeconds()
     { return sHalfLifeHours * 60.0F * 60.0F; }
   static int32_t HalfLifeExperiment()
@@ -102,6 +104,7 @@ private:
   static uint32_t sMaxDiskChunksMemoryUsage;
   static uint32_t sMaxDiskPriorityChunksMemoryUsage;
   static uint32_t sCompressionLevel;
+  static bool sChunkCompression;
   static float sHalfLifeHours;
   static int32_t sHalfLifeExperiment;
   static bool sSanitizeOnShutdown;
@@ -31,9 +31,12 @@
 #include "nsWeakReference.h"
 #include "mozilla/TimeStamp.h"
 #include "mozilla/DebugOnly.h"
+#include "mozilla/HashFunctions.h"
 #include "mozilla/Services.h"
 #include "mozilla/IntegerPrintfMacros.h"
 
+#include <algorithm>
+
 namespace mozilla {
 namespace net {
 
@@ -76,9 +79,56 @@ CacheMemoryConsumer::DoMemoryReport(uint32_t aCurrentSize)
   }
 }
 
+CacheStorageService::FrequencySketch::FrequencySketch()
+: mIncrements(0)
+{
+  memset(mCounters, 0, sizeof(mCounters));
+}
+
+/* static */ uint32_t
+CacheStorageService::FrequencySketch::Index(uint32_t aHash, uint32_t aRow)
+{
+  static uint32_t const kSeeds[kDepth] = {
+    0x9E3779B1, 0x85EBCA77, 0xC2B2AE3D, 0x27D4EB2F
+  };
+  return (aHash * kSeeds[aRow]) >> (32 - kWidthLog2);
+}
+
+void
+CacheStorageService::FrequencySketch::Increment(uint32_t aHash)
+{
+  for (uint32_t row = 0; row < kDepth; ++row) {
+    uint8_t& counter = mCounters[row][Index(aHash, row)];
+    if (counter < kMaxCount) {
+      ++counter;
+    }
+  }
+
+  if (++mIncrements == kSampleSize) {
+    for (uint32_t row = 0; row < kDepth; ++row) {
+      for (uint32_t i = 0; i < kWidth; ++i) {
+        mCounters[row][i] >>= 1;
+      }
+    }
+    mIncrements /= 2;
+  }
+}
+
+uint32_t
+CacheStorageService::FrequencySketch::Estimate(uint32_t aHash) const
+{
+  uint32_t estimate = kMaxCount;
+  for (uint32_t row = 0; row < kDepth; ++row) {
+    estimate = std::min<uint32_t>(estimate, mCounters[row][Index(aHash, row)]);
+  }
+  return estimate;
+}
+
 CacheStorageService::MemoryPool::MemoryPool(EType aType)
 : mType(aType)
 , mMemorySize(0)
+, mHits(0)
+, mLookups(0)
 {
 }
 
@@ -970,6 +1020,16 @@ public:
   }
 };
 
+uint32_t
+SketchHash(CacheEntry* aEntry)
+{
+  nsAutoCString key;
+  if (NS_FAILED(aEntry->HashingKeyWithStorage(key))) {
+    return 0;
+  }
+  return HashString(key);
+}
+
 class ExpirationComparator
 {
 public:
@@ -1024,6 +1084,14 @@ CacheStorageService::UnregisterEntry(CacheEntry* aEntry)
   aEntry->SetRegistered(false);
 }
 
+void
+CacheStorageService::RecordEntryUse(CacheEntry* aEntry)
+{
+  MOZ_ASSERT(IsOnManagementThread());
+
+  Pool(aEntry->IsUsingDisk()).mSketch.Increment(SketchHash(aEntry));
+}
+
 static bool
 AddExactEntry(CacheEntryTable* aEntries,
               nsACString const& aKey,
@@ -1396,6 +1464,11 @@ CacheStorageService::MemoryPool::PurgeOverMemoryLimit()
   }
 #endif
 
+  if (mMemorySize > memoryLimit) {
+    LOG(("  memory data consumption over the limit, abandon rarely used entries"));
+    PurgeRarelyUsed(frecencyNeedsSort);
+  }
+
   if (mMemorySize > memoryLimit) {
     LOG(("  memory data consumption over the limit, abandon any entry"));
     PurgeByFrecency(frecencyNeedsSort, CacheEntry::PURGE_WHOLE);
@@ -1433,6 +1506,39 @@ CacheStorageService::MemoryPool::PurgeExpired()
   }
 }
 
+void
+CacheStorageService::MemoryPool::PurgeRarelyUsed(bool &aFrecencyNeedsSort)
+{
+  MOZ_ASSERT(IsOnManagementThread());
+
+  if (aFrecencyNeedsSort) {
+    mFrecencyArray.Sort(FrecencyComparator());
+    aFrecencyNeedsSort = false;
+  }
+
+  uint32_t const memoryLimit = Limit();
+
+  // A fresh entry has a high frecency just because it is fresh, so a burst
+  // of one-off loads (e.g. video segments) would otherwise push out entries
+  // that keep being used.  Make those that were not used again go first.
+  for (uint32_t i = 0; mMemorySize > memoryLimit && i < mFrecencyArray.Length();) {
+    if (CacheIOThread::YieldAndRerun())
+      return;
+
+    RefPtr<CacheEntry> entry = mFrecencyArray[i];
+
+    if (mSketch.Estimate(SketchHash(entry)) <= 1 &&
+        entry->Purge(CacheEntry::PURGE_WHOLE)) {
+      LOG(("  abandoned rarely used entry=%p, frecency=%1.10f",
+        entry.get(), entry->GetFrecency()));
+      continue;
+    }
+
+    // not purged, move to the next one
+    ++i;
+  }
+}
+
 void
 CacheStorageService::MemoryPool::PurgeByFrecency(bool &aFrecencyNeedsSort, uint32_t aWhat)
 {
@@ -1553,6 +1659,12 @@ CacheStorageService::AddStorageEntry(const nsACString& aContextKey,
       }
     }
 
+    MemoryPool& pool = Pool(aWriteToDisk);
+    pool.mLookups++;
+    if (entryExists && !aReplace) {
+      pool.mHits++;
+    }
+
     // If truncate is demanded, delete and doom the current entry
     if (entryExists && aReplace) {
       entries->Remove(entryKey);
@@ -1596,6 +1708,16 @@ CacheStorageService::AddStorageEntry(const nsACString& aContextKey,
   return NS_OK;
 }
 
+void
+CacheStorageService::GetPoolHitCounts(bool aUsingDisk,
+                                      uint32_t* aHits,
+                                      uint32_t* aLookups) const
+{
+  MemoryPool const& pool = Pool(aUsingDisk);
+  *aHits = pool.mHits;
+  *aLookups = pool.mLookups;
+}
+
 nsresult
 CacheStorageService::CheckStorageEntry(CacheStorage const* aStorage,
                                        const nsACString & aURI,
@@ -122,6 +122,10 @@ public:
 
   static uint32_t CacheQueueSize(bool highPriority);
 
+  // How many entry lookups went to the memory or the disk pool, and how many
+  // of them found the entry already in memory.  For about:cache.
+  void GetPoolHitCounts(bool aUsingDisk, uint32_t* aHits, uint32_t* aLookups) const;
+
   // Memory reporting
   size_t SizeOfExcludingThis(mozilla::MallocSizeOf mallocSizeOf) const;
   size_t SizeOfIncludingThis(mozilla::MallocSizeOf mallocSizeOf) const;
@@ -151,6 +155,11 @@ private:
    */
   void UnregisterEntry(CacheEntry* aEntry);
 
+  /**
+   * Counts a use of the entry in its pool's frequency sketch.
+   */
+  void RecordEntryUse(CacheEntry* aEntry);
+
   /**
    * Removes the entry from the related entry hash table, if still present.
    */
@@ -318,6 +327,33 @@ private:
 
   bool mShutdown;
 
+  /**
+   * A count-min sketch of how often entries were used, which unlike their
+   * frecency survives their purge from memory.  The counters saturate at 15
+   * and are all halved every kSampleSize increments, so that old popularity
+   * fades away.
+   */
+  class FrequencySketch
+  {
+  public:
+    FrequencySketch();
+
+    void Increment(uint32_t aHash);
+    uint32_t Estimate(uint32_t aHash) const;
+
+  private:
+    static uint32_t const kDepth = 4;
+    static uint32_t const kWidthLog2 = 10;
+    static uint32_t const kWidth = 1 << kWidthLog2;
+    static uint32_t const kMaxCount = 15;
+    static uint32_t const kSampleSize = 10 * kWidth;
+
+    static uint32_t Index(uint32_t aHash, uint32_t aRow);
+
+    uint8_t mCounters[kDepth][kWidth];
+    uint32_t mIncrements;
+  };
+
   // Accessible only on the service thread
   class MemoryPool
   {
@@ -334,6 +370,11 @@ private:
     nsTArray<RefPtr<CacheEntry> > mFrecencyArray;
     nsTArray<RefPtr<CacheEntry> > mExpirationArray;
     Atomic<uint32_t, Relaxed> mMemorySize;
+    FrequencySketch mSketch;
+
+    // Updated under the service lock, read from anywhere.
+    Atomic<uint32_t, Relaxed> mHits;
+    Atomic<uint32_t, Relaxed> mLookups;
 
     bool OnMemoryConsumptionChange(uint32_t aSavedMemorySize,
                                    uint32_t aCurrentMemoryConsumption);
@@ -342,6 +383,11 @@ private:
      */
     void PurgeOverMemoryLimit();
     void PurgeExpired();
+    /**
+     * Purges entries used only once lately, which have not earned their
+     * place in memory whatever their frecency says.
+     */
+    void PurgeRarelyUsed(bool &aFrecencyNeedsSort);
     void PurgeByFrecency(bool &aFrecencyNeedsSort, uint32_t aWhat);
     void PurgeAll(uint32_t aWhat);
 
@@ -76,6 +76,8 @@ CookieServiceChild::CookieServiceChild()
   mTLDService = do_GetService(NS_EFFECTIVETLDSERVICE_CONTRACTID);
   NS_ASSERTION(mTLDService, "couldn't get TLDService");
 
+  mPermissionService = do_GetService(NS_COOKIEPERMISSION_CONTRACTID);
+
   // Init our prefs and observer.
   nsCOMPtr<nsIPrefBranch> prefBranch =
     do_GetService(NS_PREFSERVICE_CONTRACTID);
@@ -232,13 +234,10 @@ CookieServiceChild::GetCookieStringFromCookieHashTable(nsIURI                 *a
                                                        const OriginAttributes &aOriginAttrs,
                                                        nsCString              &aCookieString)
 {
-  nsCOMPtr<nsIEffectiveTLDService> TLDService =
-    do_GetService(NS_EFFECTIVETLDSERVICE_CONTRACTID);
-  NS_ASSERTION(TLDService, "Can't get TLDService");
   bool requireHostMatch;
   nsAutoCString baseDomain;
   nsCookieService::
-    GetBaseDomain(TLDService, aHostURI, baseDomain, requireHostMatch);
+    GetBaseDomain(mTLDService, aHostURI, baseDomain, requireHostMatch);
   nsCookieKey key(baseDomain, aOriginAttrs);
   CookiesList *cookiesList = nullptr;
   mCookiesMap.Get(key, &cookiesList);
@@ -255,18 +254,16 @@ CookieServiceChild::GetCookieStringFromCookieHashTable(nsIURI                 *a
   int64_t currentTimeInUsec = PR_Now();
   int64_t currentTime = currentTimeInUsec / PR_USEC_PER_SEC;
 
-  nsCOMPtr<nsICookiePermission> permissionService = do_GetService(NS_COOKIEPERMISSION_CONTRACTID);
   CookieStatus cookieStatus =
-    nsCookieService::CheckPrefs(permissionService, mCookieBehavior,
+    nsCookieService::CheckPrefs(mPermissionService, mCookieBehavior,
                                 mThirdPartySession, aHostURI,
                                 aIsForeign, nullptr,
-                                CountCookiesFromHashTable(baseDomain, aOriginAttrs));
+                                cookiesList->Length());
 
   if (cookieStatus != STATUS_ACCEPTED && cookieStatus != STATUS_ACCEPT_SESSION) {
     return;
   }
 
-  cookiesList->Sort(CompareCookiesForSending());
   for (uint32_t i = 0; i < cookiesList->Length(); i++) {
     nsCookie *cookie = cookiesList->ElementAt(i);
     // check the host, since the base domain lookup is conservative.
@@ -399,7 +396,7 @@ CookieServiceChild::RecordDocumentCookie(nsCookie               *aCookie,
     return;
   }
 
-  cookiesList->AppendElement(aCookie);
+  cookiesList->InsertElementSorted(aCookie, CompareCookiesForSending());
 }
 
 nsresult
@@ -494,10 +491,8 @@ CookieServiceChild::SetCookieStringInternal(nsIURI *aHostURI,
   nsCookieService::
     GetBaseDomain(mTLDService, aHostURI, baseDomain, requireHostMatch);
 
-  nsCOMPtr<nsICookiePermission> permissionService = do_GetService(NS_COOKIEPERMISSION_CONTRACTID);
-
   CookieStatus cookieStatus =
-    nsCookieService::CheckPrefs(permissionService, mCookieBehavior,
+    nsCookieService::CheckPrefs(mPermissionService, mCookieBehavior,
                                 mThirdPartySession, aHostURI,
                                 !!isForeign, aCookieString,
                                 CountCookiesFromHashTable(baseDomain, attrs));
@@ -520,7 +515,7 @@ CookieServiceChild::SetCookieStringInternal(nsIURI *aHostURI,
 
     if (canSetCookie) {
       SetCookieInternal(cookieAttributes, attrs, aChannel,
-                        aFromHttp, permissionService);
+                        aFromHttp, mPermissionService);
     }
 
     // document.cookie can only set one cookie at a time.
@@ -35,6 +35,8 @@ public:
   NS_DECL_NSICOOKIESERVICE
   NS_DECL_NSIOBSERVER
 
+  // Each list is kept in CompareCookiesForSending order, so that reads can
+  // serialize it as is.
   typedef nsTArray<RefPtr<nsCookie>> CookiesList;
   typedef nsClassHashtable<nsCookieKey, CookiesList> CookiesMap;
 
@@ -117,6 +119,7 @@ protected:
   CookiesMap mCookiesMap;
   nsCOMPtr<mozIThirdPartyUtil> mThirdPartyUtil;
   nsCOMPtr<nsIEffectiveTLDService> mTLDService;
+  nsCOMPtr<nsICookiePermission> mPermissionService;
   uint8_t mCookieBehavior;
   bool mThirdPartySession;
   bool mIPCSync;
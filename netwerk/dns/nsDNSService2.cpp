@@ -32,6 +32,10 @@
 #include "nsProxyRelease.h"
 #include "nsIObserverService.h"
 #include "nsINetworkLinkService.h"
+#include "nsISafeOutputStream.h"
+#include "nsNetUtil.h"
+#include "nsAppDirectoryServiceDefs.h"
+#include "nsDirectoryServiceUtils.h"
 
 #include "mozilla/Attributes.h"
 #include "mozilla/net/NeckoCommon.h"
@@ -53,6 +57,11 @@ static const char kPrefDnsLocalDomains[]     = "network.dns.localDomains";
 static const char kPrefDnsForceResolve[]     = "network.dns.forceResolve";
 static const char kPrefDnsOfflineLocalhost[] = "network.dns.offline-localhost";
 static const char kPrefDnsNotifyResolution[] = "network.dns.notifyResolution";
+static const char kPrefDnsPersistCache[]     = "network.dns.persistCache";
+
+// Where the cache is saved in the profile, and the largest file read back.
+static const char kDnsCacheFileName[]        = "dnscache.txt";
+static const int64_t kMaxDnsCacheFileSize    = 1024 * 1024;
 
 //-----------------------------------------------------------------------------
 
@@ -485,6 +494,8 @@ nsDNSService::nsDNSService()
     , mNotifyResolution(false)
     , mOfflineLocalhost(false)
     , mForceResolveOn(false)
+    , mPersistCache(false)
+    , mCacheRestored(false)
 {
 }
 
@@ -546,6 +557,7 @@ nsDNSService::Init()
     bool     blockDotOnion    = true;
     int      proxyType        = nsIProtocolProxyService::PROXYCONFIG_DIRECT;
     bool     notifyResolution = false;
+    bool     persistCache     = false;
 
     nsCString ipv4OnlyDomains;
     nsCString localDomains;
@@ -574,6 +586,7 @@ nsDNSService::Init()
         // If a manual proxy is in use, disable prefetch implicitly
         prefs->GetIntPref("network.proxy.type", &proxyType);
         prefs->GetBoolPref(kPrefDnsNotifyResolution, &notifyResolution);
+        prefs->GetBoolPref(kPrefDnsPersistCache, &persistCache);
 
         if (mFirstTime) {
             mFirstTime = false;
@@ -590,6 +603,7 @@ nsDNSService::Init()
             prefs->AddObserver(kPrefDisablePrefetch, this, false);
             prefs->AddObserver(kPrefBlockDotOnion, this, false);
             prefs->AddObserver(kPrefDnsNotifyResolution, this, false);
+            prefs->AddObserver(kPrefDnsPersistCache, this, false);
 
             // Monitor these to see if there is a change in proxy configuration
             // If a manual proxy is in use, disable prefetch implicitly
@@ -602,6 +616,9 @@ nsDNSService::Init()
     if (observerService) {
         observerService->AddObserver(this, "last-pb-context-exited", false);
         observerService->AddObserver(this, NS_NETWORK_LINK_TOPIC, false);
+        observerService->AddObserver(this, "profile-after-change", false);
+        observerService->AddObserver(this, "profile-before-change", false);
+        observerService->AddObserver(this, "browser:purge-session-history", false);
     }
 
     nsDNSPrefetch::Initialize(this);
@@ -638,8 +655,13 @@ nsDNSService::Init()
             }
         }
         mNotifyResolution = notifyResolution;
+        mPersistCache = persistCache;
     }
 
+    // Nothing happens if the profile is not there yet, in which case the
+    // cache is restored on profile-after-change.
+    RestoreCache();
+
     RegisterWeakMemoryReporter(this);
 
     return rv;
@@ -665,11 +687,116 @@ nsDNSService::Shutdown()
     if (observerService) {
         observerService->RemoveObserver(this, NS_NETWORK_LINK_TOPIC);
         observerService->RemoveObserver(this, "last-pb-context-exited");
+        observerService->RemoveObserver(this, "profile-after-change");
+        observerService->RemoveObserver(this, "profile-before-change");
+        observerService->RemoveObserver(this, "browser:purge-session-history");
     }
 
     return NS_OK;
 }
 
+static nsresult
+GetDnsCacheFile(nsIFile **aFile)
+{
+    nsCOMPtr<nsIFile> file;
+    nsresult rv = NS_GetSpecialDirectory(NS_APP_USER_PROFILE_50_DIR,
+                                         getter_AddRefs(file));
+    NS_ENSURE_SUCCESS(rv, rv);
+    rv = file->AppendNative(nsDependentCString(kDnsCacheFileName));
+    NS_ENSURE_SUCCESS(rv, rv);
+    file.forget(aFile);
+    return NS_OK;
+}
+
+void
+nsDNSService::RestoreCache()
+{
+    MOZ_ASSERT(NS_IsMainThread());
+
+    // Only the first resolver of the process gets the previous session's
+    // records: after a pref change they would be older than what it had.
+    if (!mPersistCache || mCacheRestored || !mResolver) {
+        return;
+    }
+
+    nsCOMPtr<nsIFile> file;
+    if (NS_FAILED(GetDnsCacheFile(getter_AddRefs(file)))) {
+        return;
+    }
+    mCacheRestored = true;
+
+    nsCOMPtr<nsIEventTarget> sts =
+        do_GetService(NS_STREAMTRANSPORTSERVICE_CONTRACTID);
+    if (!sts) {
+        return;
+    }
+
+    RefPtr<nsHostResolver> resolver = mResolver;
+    sts->Dispatch(NS_NewRunnableFunction("nsDNSService::RestoreCache",
+        [resolver, file]() {
+            int64_t size;
+            if (NS_FAILED(file->GetFileSize(&size)) || size <= 0 ||
+                size > kMaxDnsCacheFileSize) {
+                return;
+            }
+
+            nsCOMPtr<nsIInputStream> stream;
+            nsresult rv = NS_NewLocalFileInputStream(getter_AddRefs(stream),
+                                                     file);
+            if (NS_FAILED(rv)) {
+                return;
+            }
+
+            nsAutoCString data;
+            rv = NS_ReadInputStreamToString(stream, data, size);
+            if (NS_FAILED(rv)) {
+                return;
+            }
+            resolver->RestoreCache(data);
+        }), NS_DISPATCH_NORMAL);
+}
+
+void
+nsDNSService::PersistCache()
+{
+    MOZ_ASSERT(NS_IsMainThread());
+
+    nsCOMPtr<nsIFile> file;
+    if (NS_FAILED(GetDnsCacheFile(getter_AddRefs(file)))) {
+        return;
+    }
+
+    // Don't leave the records of a session behind once persisting is turned
+    // off.
+    if (!mPersistCache || !mResolver) {
+        file->Remove(false);
+        return;
+    }
+
+    // The file is small: at most network.dnsCacheEntries lines.
+    nsAutoCString data;
+    mResolver->SerializeCache(data);
+
+    nsCOMPtr<nsIOutputStream> stream;
+    nsresult rv = NS_NewSafeLocalFileOutputStream(getter_AddRefs(stream), file,
+                                                  PR_WRONLY | PR_CREATE_FILE |
+                                                  PR_TRUNCATE, 0600);
+    if (NS_FAILED(rv)) {
+        return;
+    }
+
+    uint32_t written;
+    rv = stream->Write(data.get(), data.Length(), &written);
+    if (NS_FAILED(rv) || written != data.Length()) {
+        return;
+    }
+
+    nsCOMPtr<nsISafeOutputStream> safeStream = do_QueryInterface(stream);
+    if (safeStream) {
+        safeStream->Finish();
+    }
+}
+
 bool
 nsDNSService::GetOffline() const
 {
@@ -1079,9 +1206,21 @@ nsDNSService::Observe(nsISupports *subject, const char *topic, const char16_t *d
     // network link event.
     NS_ASSERTION(strcmp(topic, NS_PREFBRANCH_PREFCHANGE_TOPIC_ID) == 0 ||
                  strcmp(topic, "last-pb-context-exited") == 0 ||
-                 strcmp(topic, NS_NETWORK_LINK_TOPIC) == 0,
+                 strcmp(topic, NS_NETWORK_LINK_TOPIC) == 0 ||
+                 strcmp(topic, "profile-after-change") == 0 ||
+                 strcmp(topic, "profile-before-change") == 0 ||
+                 strcmp(topic, "browser:purge-session-history") == 0,
                  "unexpected observe call");
 
+    if (!strcmp(topic, "profile-after-change")) {
+        RestoreCache();
+        return NS_OK;
+    }
+    if (!strcmp(topic, "profile-before-change")) {
+        PersistCache();
+        return NS_OK;
+    }
+
     bool flushCache = false;
     if (!strcmp(topic, NS_NETWORK_LINK_TOPIC)) {
         nsAutoCString converted = NS_ConvertUTF16toUTF8(data);
@@ -1090,6 +1229,12 @@ nsDNSService::Observe(nsISupports *subject, const char *topic, const char16_t *d
         }
     } else if (!strcmp(topic, "last-pb-context-exited")) {
         flushCache = true;
+    } else if (!strcmp(topic, "browser:purge-session-history")) {
+        nsCOMPtr<nsIFile> file;
+        if (NS_SUCCEEDED(GetDnsCacheFile(getter_AddRefs(file)))) {
+            file->Remove(false);
+        }
+        flushCache = !!mResolver;
     }
     if (flushCache) {
         mResolver->FlushCache();
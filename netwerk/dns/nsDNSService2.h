@@ -50,6 +50,11 @@ private:
                                 nsIIDNService    *aIDN,
                                 nsACString       &aACE);
 
+    // Load the records saved by the previous session into mResolver, off the
+    // main thread, and save them for the next one.
+    void RestoreCache();
+    void PersistCache();
+
     RefPtr<nsHostResolver>  mResolver;
     nsCOMPtr<nsIIDNService>   mIDN;
 
@@ -68,6 +73,8 @@ private:
     bool                                      mNotifyResolution;
     bool                                      mOfflineLocalhost;
     bool                                      mForceResolveOn;
+    bool                                      mPersistCache;
+    bool                                      mCacheRestored;
     nsTHashtable<nsCStringHashKey>            mLocalDomains;
 };
 
@@ -206,73 +206,60 @@ nsEffectiveTLDService::GetBaseDomainInternal(nsCString  &aHostname,
   if (aHostname.IsEmpty() || aHostname.Last() == '.')
     return NS_ERROR_INVALID_ARG;
 
-  // Check if we're dealing with an IPv4/IPv6 hostname, and return
-  PRNetAddr addr;
-  PRStatus result = PR_StringToNetAddr(aHostname.get(), &addr);
-  if (result == PR_SUCCESS)
-    return NS_ERROR_HOST_IS_IP_ADDRESS;
+  const char *begin = aHostname.get();
+  const char *end = begin + aHostname.Length();
+  const char *eTLD = nullptr;
 
-  // Lookup in the cache if this is a normal query.
+  // Lookup in the cache first. Only hosts that got through the checks below
+  // are ever cached, so there is no need to make them again on a hit.
   TLDCacheEntry* entry = nullptr;
-  if (aAdditionalParts == 1) {
-    if (LookupForAdd(aHostname, &entry)) {
-      // There was a match, just return the cached value.
-      aBaseDomain = entry->mBaseDomain;
-      if (trailingDot) {
-        aBaseDomain.Append('.');
-      }
-
-      return NS_OK;
-    }
-  }
-
-  // Walk up the domain tree, most specific to least specific,
-  // looking for matches at each level.  Note that a given level may
-  // have multiple attributes (e.g. IsWild() and IsNormal()).
-  const char *prevDomain = nullptr;
-  const char *currDomain = aHostname.get();
-  const char *nextDot = strchr(currDomain, '.');
-  const char *end = currDomain + aHostname.Length();
-  // Default value of *eTLD is currDomain as set in the while loop below
-  const char *eTLD = nullptr;
-  while (true) {
-    // sanity check the string we're about to look up: it should not begin with
-    // a '.'; this would mean the hostname began with a '.' or had an
-    // embedded '..' sequence.
-    if (*currDomain == '.')
+  if (LookupForAdd(aHostname, &entry)) {
+    eTLD = begin + entry->mETLDOffset;
+  } else {
+    // Check if we're dealing with an IPv4/IPv6 hostname, and return
+    PRNetAddr addr;
+    PRStatus status = PR_StringToNetAddr(aHostname.get(), &addr);
+    if (status == PR_SUCCESS)
+      return NS_ERROR_HOST_IS_IP_ADDRESS;
+
+    // sanity check the labels: the hostname should not begin with a '.' or
+    // have an embedded '..' sequence.
+    if (aHostname.First() == '.' || aHostname.Find("..") != kNotFound)
       return NS_ERROR_INVALID_ARG;
 
-    // Perform the lookup.
-    const int result = mGraph.Lookup(Substring(currDomain, end));
-    if (result != Dafsa::kKeyNotFound) {
-      if (result == kWildcardRule && prevDomain) {
+    // Look up every level of the domain tree in one walk of the graph, which
+    // holds the rules reversed, and keep the most specific match.  Note that
+    // a given level may have multiple attributes (e.g. IsWild() and
+    // IsNormal()).
+    size_t suffixLength;
+    const int result =
+      mGraph.LookupLongestReversedSuffix(aHostname, '.', &suffixLength);
+    if (result == Dafsa::kKeyNotFound) {
+      // use the top domain level by default.
+      int32_t lastDot = aHostname.RFindChar('.');
+      eTLD = lastDot == kNotFound ? begin : begin + lastDot + 1;
+    } else {
+      const char *currDomain = end - suffixLength;
+      const char *nextDot = strchr(currDomain, '.');
+      if (result == kWildcardRule && currDomain != begin) {
         // wildcard rules imply an eTLD one level inferior to the match.
-        eTLD = prevDomain;
-        break;
-      }
-      if ((result == kWildcardRule || result != kExceptionRule) || !nextDot) {
-        // specific match, or we've hit the top domain level
-        eTLD = currDomain;
-        break;
-      }
-      if (result == kExceptionRule) {
+        int32_t prevDot =
+          aHostname.RFindChar('.', int32_t(currDomain - begin - 2));
+        eTLD = prevDot == kNotFound ? begin : begin + prevDot + 1;
+      } else if (result == kExceptionRule && nextDot) {
         // exception rules imply an eTLD one level superior to the match.
         eTLD = nextDot + 1;
-        break;
+      } else {
+        // specific match, or we've hit the top domain level
+        eTLD = currDomain;
       }
     }
-    if (!nextDot) {
-      // we've hit the top domain level; use it by default.
-      eTLD = currDomain;
-      break;
-    }
 
-    prevDomain = currDomain;
-    currDomain = nextDot + 1;
-    nextDot = strchr(currDomain, '.');
+    entry->mHost = aHostname;
+    entry->mETLDOffset = eTLD - begin;
   }
 
-  const char *begin, *iter;
+  const char *iter;
   if (aAdditionalParts < 0) {
     NS_ASSERTION(aAdditionalParts == -1,
                  "aAdditionalParts can't be negative and different from -1");
@@ -287,7 +274,6 @@ nsEffectiveTLDService::GetBaseDomainInternal(nsCString  &aHostname,
     }
   } else {
     // count off the number of requested domains.
-    begin = aHostname.get();
     iter = eTLD;
 
     while (true) {
@@ -307,12 +293,6 @@ nsEffectiveTLDService::GetBaseDomainInternal(nsCString  &aHostname,
 
   aBaseDomain = Substring(iter, end);
 
-  // Update the MRU table if in use.
-  if (entry) {
-    entry->mHost = aHostname;
-    entry->mBaseDomain = aBaseDomain;
-  }
-
   // add on the trailing dot, if applicable
   if (trailingDot)
     aBaseDomain.Append('.');
@@ -343,5 +323,11 @@ nsEffectiveTLDService::LookupForAdd(const nsACString& aHost, TLDCacheEntry** aEn
 
   const uint32_t hash = HashString(aHost.BeginReading(), aHost.Length());
   *aEntry = &mMruTable[hash % kTableSize];
-  return (*aEntry)->mHost == aHost;
+  if ((*aEntry)->mHash == hash && (*aEntry)->mHost == aHost) {
+    return true;
+  }
+  // Claim the entry, which is only filled in if the lookup succeeds.
+  (*aEntry)->mHash = hash;
+  (*aEntry)->mHost.Truncate();
+  return false;
 }
@@ -27,6 +27,7 @@
 #include "PLDHashTable.h"
 #include "plstr.h"
 #include "nsURLHelper.h"
+#include "nsCharSeparatedTokenizer.h"
 #include "nsThreadUtils.h"
 #include "GetAddrInfo.h"
 #include "GeckoProfiler.h"
@@ -44,6 +45,14 @@ using namespace mozilla::net;
 // constant always.
 static const unsigned int NEGATIVE_RECORD_LIFETIME = 60;
 
+// Records carried over from a previous session are usable for this long after
+// startup, while they are being renewed.
+static const unsigned int RESTORED_RECORD_GRACE_PERIOD = 600;
+
+// Records of a previous session that expired longer ago than this are not
+// restored.
+static const int64_t RESTORED_RECORD_MAX_AGE = 24 * 60 * 60;
+
 //----------------------------------------------------------------------------
 
 // Use a persistent thread pool in order to avoid spinning up new threads all the time.
@@ -1603,3 +1612,131 @@ nsHostResolver::GetDNSCacheEntries(nsTArray<DNSCacheEntries> *args)
         args->AppendElement(info);
     }
 }
+
+void
+nsHostResolver::SerializeCache(nsACString &aOutput)
+{
+    MutexAutoLock lock(mLock);
+
+    TimeStamp now = TimeStamp::NowLoRes();
+    int64_t wallNow = PR_Now() / PR_USEC_PER_SEC;
+
+    // Only the eviction queue holds completed records.
+    for (PRCList *node = mEvictionQ.next; node != &mEvictionQ;
+         node = node->next) {
+        nsHostRecord *rec = static_cast<nsHostRecord *>(node);
+        // Records of private or isolated origins and of specific network
+        // interfaces must not outlive the session.  Canonical names are not
+        // kept either.
+        if (rec->negative || rec->mDoomed || !rec->host || !*rec->host ||
+            *rec->originSuffix || *rec->netInterface ||
+            RES_KEY_FLAGS(rec->flags) || rec->mValidEnd.IsNull()) {
+            continue;
+        }
+
+        nsAutoCString addrs;
+        {
+            MutexAutoLock lock(rec->addr_info_lock);
+            if (!rec->addr_info) {
+                continue;
+            }
+            for (NetAddrElement *element = rec->addr_info->mAddresses.getFirst();
+                 element; element = element->getNext()) {
+                char buf[kIPv6CStrBufSize];
+                if (NetAddrToString(&element->mAddress, buf, sizeof(buf))) {
+                    if (!addrs.IsEmpty()) {
+                        addrs.Append(',');
+                    }
+                    addrs.Append(buf);
+                }
+            }
+        }
+        if (addrs.IsEmpty()) {
+            continue;
+        }
+
+        int64_t expiry =
+            wallNow + (int64_t)(rec->mValidEnd - now).ToSeconds();
+        aOutput.Append(rec->host);
+        aOutput.Append(' ');
+        aOutput.AppendInt(rec->af);
+        aOutput.Append(' ');
+        aOutput.AppendInt(expiry);
+        aOutput.Append(' ');
+        aOutput.Append(addrs);
+        aOutput.Append('\n');
+    }
+}
+
+void
+nsHostResolver::RestoreCache(const nsACString &aInput)
+{
+    MutexAutoLock lock(mLock);
+
+    if (mShutdown) {
+        return;
+    }
+
+    TimeStamp now = TimeStamp::NowLoRes();
+    int64_t wallNow = PR_Now() / PR_USEC_PER_SEC;
+    uint32_t restored = 0;
+
+    nsCCharSeparatedTokenizer lines(aInput, '\n');
+    while (lines.hasMoreTokens() && mEvictionQSize < mMaxCacheEntries) {
+        const nsACString &line = lines.nextToken();
+        nsCCharSeparatedTokenizer fields(line, ' ');
+
+        nsAutoCString host(fields.nextToken());
+        nsresult rv1, rv2;
+        uint16_t af = nsAutoCString(fields.nextToken()).ToInteger(&rv1);
+        int64_t expiry = nsAutoCString(fields.nextToken()).ToInteger64(&rv2);
+        nsAutoCString addrs(fields.nextToken());
+        if (host.IsEmpty() || NS_FAILED(rv1) || NS_FAILED(rv2) ||
+            addrs.IsEmpty() || fields.hasMoreTokens() ||
+            (af != PR_AF_UNSPEC && af != PR_AF_INET && af != PR_AF_INET6) ||
+            expiry + RESTORED_RECORD_MAX_AGE < wallNow) {
+            continue;
+        }
+
+        nsAutoPtr<AddrInfo> ai(new AddrInfo(host.get(), nullptr));
+        nsCCharSeparatedTokenizer addrTokens(addrs, ',');
+        while (addrTokens.hasMoreTokens()) {
+            PRNetAddr prAddr;
+            memset(&prAddr, 0, sizeof(PRNetAddr));
+            nsAutoCString addr(addrTokens.nextToken());
+            if (PR_StringToNetAddr(addr.get(), &prAddr) == PR_SUCCESS) {
+                ai->AddAddress(new NetAddrElement(&prAddr));
+            }
+        }
+        if (ai->mAddresses.isEmpty()) {
+            continue;
+        }
+
+        nsHostKey key = { host.get(), 0, af, "", "" };
+        auto he = static_cast<nsHostDBEnt*>(mDB.Add(&key, fallible));
+        if (!he) {
+            return;
+        }
+        nsHostRecord *rec = he->rec;
+        // Anything this session knows of the host is better.
+        if (rec->resolving || !rec->mValidEnd.IsNull() || rec->addr) {
+            continue;
+        }
+
+        {
+            MutexAutoLock lock(rec->addr_info_lock);
+            MOZ_ASSERT(!rec->addr_info);
+            rec->addr_info = ai.forget();
+            rec->addr_info_gencnt++;
+        }
+        rec->negative = false;
+        rec->SetExpiration(now, 0, RESTORED_RECORD_GRACE_PERIOD);
+
+        PR_APPEND_LINK(rec, &mEvictionQ);
+        NS_ADDREF(rec);
+        mEvictionQSize++;
+        restored++;
+    }
+
+    LOG(("Restored %u host records from the previous session.\n", restored));
+}
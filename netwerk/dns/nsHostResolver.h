@@ -371,6 +371,16 @@ public:
      * Called by the networking dashboard via the DnsService2
      */
     void GetDNSCacheEntries(nsTArray<mozilla::net::DNSCacheEntries> *);
+
+    /*
+     * Called by the DnsService2 to carry the cache over to the next session.
+     * SerializeCache writes the resolved records that are not tied to an
+     * origin or a network interface, one per line.  RestoreCache adds the
+     * records written by a previous session in their grace period, so that
+     * the first lookup of each is answered from the cache and renews it.
+     */
+    void SerializeCache(nsACString &aOutput);
+    void RestoreCache(const nsACString &aInput);
 };
 
 #endif // nsHostResolver_h__
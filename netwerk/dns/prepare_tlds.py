@@ -130,7 +130,9 @@ def main(output, effective_tld_filename):
     for etld in getEffectiveTLDs(effective_tld_filename):
       yield "%s%d" % (etld.domain(), typeEnum(etld))
 
-  output.write(make_dafsa.words_to_cxx(dafsa_words()))
+  # The graph is searched from the end of the host, to match all its suffixes
+  # in a single walk.
+  output.write(make_dafsa.words_to_cxx(dafsa_words(), reverse_words=True))
 
 if __name__ == '__main__':
     main(sys.stdout, sys.argv[1])
@@ -144,6 +144,8 @@ struct ParamTraits<mozilla::net::ResourceTimingStruct>
 {
   static void Write(Message* aMsg, const mozilla::net::ResourceTimingStruct& aParam)
   {
+    WriteParam(aMsg, aParam.transactionPending);
+    WriteParam(aMsg, aParam.transactionDispatched);
     WriteParam(aMsg, aParam.domainLookupStart);
     WriteParam(aMsg, aParam.domainLookupEnd);
     WriteParam(aMsg, aParam.connectStart);
@@ -163,11 +165,16 @@ struct ParamTraits<mozilla::net::ResourceTimingStruct>
 
     WriteParam(aMsg, aParam.cacheReadStart);
     WriteParam(aMsg, aParam.cacheReadEnd);
+    WriteParam(aMsg, aParam.cacheEntryOpenStart);
+    WriteParam(aMsg, aParam.cacheEntryAvailable);
+    WriteParam(aMsg, aParam.onStartRequestStart);
   }
 
   static bool Read(const Message* aMsg, PickleIterator* aIter, mozilla::net::ResourceTimingStruct* aResult)
   {
-    return ReadParam(aMsg, aIter, &aResult->domainLookupStart) &&
+    return ReadParam(aMsg, aIter, &aResult->transactionPending) &&
+           ReadParam(aMsg, aIter, &aResult->transactionDispatched) &&
+           ReadParam(aMsg, aIter, &aResult->domainLookupStart) &&
            ReadParam(aMsg, aIter, &aResult->domainLookupEnd) &&
            ReadParam(aMsg, aIter, &aResult->connectStart) &&
            ReadParam(aMsg, aIter, &aResult->secureConnectionStart) &&
@@ -182,7 +189,10 @@ struct ParamTraits<mozilla::net::ResourceTimingStruct>
            ReadParam(aMsg, aIter, &aResult->encodedBodySize) &&
            ReadParam(aMsg, aIter, &aResult->protocolVersion) &&
            ReadParam(aMsg, aIter, &aResult->cacheReadStart) &&
-           ReadParam(aMsg, aIter, &aResult->cacheReadEnd);
+           ReadParam(aMsg, aIter, &aResult->cacheReadEnd) &&
+           ReadParam(aMsg, aIter, &aResult->cacheEntryOpenStart) &&
+           ReadParam(aMsg, aIter, &aResult->cacheEntryAvailable) &&
+           ReadParam(aMsg, aIter, &aResult->onStartRequestStart);
   }
 };
 
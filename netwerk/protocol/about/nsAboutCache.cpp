@@ -19,6 +19,7 @@
 #include "nsICacheStorage.h"
 #include "CacheFileUtils.h"
 #include "CacheObserver.h"
+#include "CacheStorageService.h"
 
 #include "nsThreadUtils.h"
 
@@ -361,6 +362,25 @@ nsAboutCache::Channel::OnCacheStorageInfo(uint32_t aEntryCount, uint64_t aConsum
     mBuffer.AppendLiteral("    </td>\n"
                           "  </tr>\n");
 
+    // Share of the lookups that found the entry in memory
+    bool isMemory = mStorageName.EqualsLiteral("memory");
+    CacheStorageService* service = CacheStorageService::Self();
+    if (service && (isMemory || mStorageName.EqualsLiteral("disk"))) {
+        uint32_t hits, lookups;
+        service->GetPoolHitCounts(!isMemory, &hits, &lookups);
+        mBuffer.AppendLiteral("  <tr>\n"
+                              "    <th>Memory pool hits:</th>\n"
+                              "    <td>");
+        mBuffer.AppendInt(hits);
+        mBuffer.AppendLiteral(" of ");
+        mBuffer.AppendInt(lookups);
+        if (lookups) {
+            mBuffer.AppendPrintf(" (%.1f%%)", 100.0 * hits / lookups);
+        }
+        mBuffer.AppendLiteral("</td>\n"
+                              "  </tr>\n");
+    }
+
     if (mOverview) { // The about:cache case
         if (aEntryCount != 0) { // Add the "List Cache Entries" link
             mBuffer.AppendLiteral("  <tr>\n"
@@ -8,12 +8,10 @@
 #include "nsDataChannel.h"
 
 #include "mozilla/Base64.h"
-#include "nsIOService.h"
 #include "nsDataHandler.h"
-#include "nsIPipe.h"
 #include "nsIInputStream.h"
-#include "nsIOutputStream.h"
 #include "nsEscape.h"
+#include "nsStringStream.h"
 
 using namespace mozilla;
 
@@ -45,45 +43,23 @@ nsDataChannel::OpenContentStream(bool async, nsIInputStream **result,
         dataBuffer.StripWhitespace();
     }
 
-    nsCOMPtr<nsIInputStream> bufInStream;
-    nsCOMPtr<nsIOutputStream> bufOutStream;
-
-    // create an unbounded pipe.
-    rv = NS_NewPipe(getter_AddRefs(bufInStream),
-                    getter_AddRefs(bufOutStream),
-                    nsIOService::gDefaultSegmentSize,
-                    UINT32_MAX,
-                    async, true);
-    if (NS_FAILED(rv))
-        return rv;
-
-    uint32_t contentLen;
     if (lBase64) {
-        const uint32_t dataLen = dataBuffer.Length();
-        int32_t resultLen = 0;
-        if (dataLen >= 1 && dataBuffer[dataLen-1] == '=') {
-            if (dataLen >= 2 && dataBuffer[dataLen-2] == '=')
-                resultLen = dataLen-2;
-            else
-                resultLen = dataLen-1;
-        } else {
-            resultLen = dataLen;
-        }
-        resultLen = ((resultLen * 3) / 4);
-
-        nsAutoCString decodedData;
+        nsCString decodedData;
         rv = Base64Decode(dataBuffer, decodedData);
         NS_ENSURE_SUCCESS(rv, rv);
-        rv = bufOutStream->Write(decodedData.get(), resultLen, &contentLen);
-    } else {
-        rv = bufOutStream->Write(dataBuffer.get(), dataBuffer.Length(), &contentLen);
+        dataBuffer.Assign(decodedData);
     }
+
+    // The string stream shares the buffer of dataBuffer, so the data doesn't
+    // have to be copied into a pipe.
+    nsCOMPtr<nsIInputStream> bufInStream;
+    rv = NS_NewCStringInputStream(getter_AddRefs(bufInStream), dataBuffer);
     if (NS_FAILED(rv))
         return rv;
 
     SetContentType(contentType);
     SetContentCharset(contentCharset);
-    mContentLength = contentLen;
+    mContentLength = dataBuffer.Length();
 
     bufInStream.forget(result);
 
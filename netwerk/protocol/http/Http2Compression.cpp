@@ -697,172 +697,103 @@ Http2Decompressor::CopyStringFromInput(uint32_t bytes, nsACString &val)
 }
 
 nsresult
-Http2Decompressor::DecodeFinalHuffmanCharacter(const HuffmanIncomingTable *table,
-                                               uint8_t &c, uint8_t &bitsLeft)
+Http2Decompressor::CopyHuffmanStringFromInput(uint32_t bytes, nsACString &val)
 {
-  uint8_t mask = (1 << bitsLeft) - 1;
-  uint8_t idx = mData[mOffset - 1] & mask;
-  idx <<= (8 - bitsLeft);
-  // Don't update bitsLeft yet, because we need to check that value against the
-  // number of bits used by our encoding later on. We'll update when we are sure
-  // how many bits we've actually used.
-
-  if (table->IndexHasANextTable(idx)) {
-    // Can't chain to another table when we're all out of bits in the encoding
-    LOG(("DecodeFinalHuffmanCharacter trying to chain when we're out of bits"));
-    return NS_ERROR_FAILURE;
-  }
-
-  const HuffmanIncomingEntry *entry = table->Entry(idx);
-
-  if (bitsLeft < entry->mPrefixLen) {
-    // We don't have enough bits to actually make a match, this is some sort of
-    // invalid coding
-    LOG(("DecodeFinalHuffmanCharacter does't have enough bits to match"));
-    return NS_ERROR_FAILURE;
-  }
-
-  // This is a character!
-  if (entry->mValue == 256) {
-    // EOS
-    LOG(("DecodeFinalHuffmanCharacter actually decoded an EOS"));
+  if (mOffset + bytes > mDataLen) {
+    LOG(("CopyHuffmanStringFromInput not enough data"));
     return NS_ERROR_FAILURE;
   }
-  c = static_cast<uint8_t>(entry->mValue & 0xFF);
-  bitsLeft -= entry->mPrefixLen;
 
-  return NS_OK;
-}
-
-uint8_t
-Http2Decompressor::ExtractByte(uint8_t bitsLeft, uint32_t &bytesConsumed)
-{
-  uint8_t rv;
-
-  if (bitsLeft) {
-    // Need to extract bitsLeft bits from the previous byte, and 8 - bitsLeft
-    // bits from the current byte
-    uint8_t mask = (1 << bitsLeft) - 1;
-    rv = (mData[mOffset - 1] & mask) << (8 - bitsLeft);
-    rv |= (mData[mOffset] & ~mask) >> bitsLeft;
-  } else {
-    rv = mData[mOffset];
+  // The shortest code is 5 bits long, which bounds the length of the decoded
+  // string, so we can decode straight into |val|.
+  uint32_t maxLength = (static_cast<uint64_t>(bytes) * 8) / 5;
+  if (!val.SetLength(maxLength, fallible)) {
+    return NS_ERROR_OUT_OF_MEMORY;
   }
+  char *outStart = val.BeginWriting();
+  char *out = outStart;
 
-  // We always update these here, under the assumption that all 8 bits we got
-  // here will be used. These may be re-adjusted later in the case that we don't
-  // use up all 8 bits of the byte.
-  ++mOffset;
-  ++bytesConsumed;
+  const uint8_t *in = mData + mOffset;
+  const uint8_t *end = in + bytes;
 
-  return rv;
-}
-
-nsresult
-Http2Decompressor::DecodeHuffmanCharacter(const HuffmanIncomingTable *table,
-                                          uint8_t &c, uint32_t &bytesConsumed,
-                                          uint8_t &bitsLeft)
-{
-  uint8_t idx = ExtractByte(bitsLeft, bytesConsumed);
-
-  if (table->IndexHasANextTable(idx)) {
-    if (bytesConsumed >= mDataLen) {
-      if (!bitsLeft || (bytesConsumed > mDataLen)) {
-        // TODO - does this get me into trouble in the new world?
-        // No info left in input to try to consume, we're done
-        LOG(("DecodeHuffmanCharacter all out of bits to consume, can't chain"));
-        return NS_ERROR_FAILURE;
-      }
+  // The |bitsLeft| least significant bits of |bits| are the input that hasn't
+  // been decoded yet.
+  uint64_t bits = 0;
+  uint32_t bitsLeft = 0;
 
-      // We might get lucky here!
-      return DecodeFinalHuffmanCharacter(table->NextTable(idx), c, bitsLeft);
+  while (true) {
+    // Codes are at most 30 bits long, so once this is done we either have
+    // enough bits to decode a full character or we're at the end of the input.
+    while (bitsLeft <= 56 && in < end) {
+      bits = (bits << 8) | *in++;
+      bitsLeft += 8;
     }
 
-    // We're sorry, Mario, but your princess is in another castle
-    return DecodeHuffmanCharacter(table->NextTable(idx), c, bytesConsumed, bitsLeft);
-  }
-
-  const HuffmanIncomingEntry *entry = table->Entry(idx);
-  if (entry->mValue == 256) {
-    LOG(("DecodeHuffmanCharacter found an actual EOS"));
-    return NS_ERROR_FAILURE;
-  }
-  c = static_cast<uint8_t>(entry->mValue & 0xFF);
-
-  // Need to adjust bitsLeft (and possibly other values) because we may not have
-  // consumed all of the bits of the byte we extracted.
-  if (entry->mPrefixLen <= bitsLeft) {
-    bitsLeft -= entry->mPrefixLen;
-    --mOffset;
-    --bytesConsumed;
-  } else {
-    bitsLeft = 8 - (entry->mPrefixLen - bitsLeft);
-  }
-  MOZ_ASSERT(bitsLeft < 8);
+    if (!bitsLeft) {
+      break;
+    }
 
-  return NS_OK;
-}
+    // Look the code up 8 bits at a time, chaining to the next table for
+    // codes longer than that.
+    const HuffmanIncomingTable *table = &HuffmanIncomingRoot;
+    const HuffmanIncomingEntry *entry = nullptr;
+    uint32_t bitsUsed = 0;
+    while (true) {
+      uint32_t avail = bitsLeft - bitsUsed;
+      uint8_t idx;
+      if (avail >= 8) {
+        idx = (bits >> (avail - 8)) & 0xFF;
+      } else {
+        idx = (bits << (8 - avail)) & 0xFF;
+      }
 
-nsresult
-Http2Decompressor::CopyHuffmanStringFromInput(uint32_t bytes, nsACString &val)
-{
-  if (mOffset + bytes > mDataLen) {
-    LOG(("CopyHuffmanStringFromInput not enough data"));
-    return NS_ERROR_FAILURE;
-  }
+      if (table->IndexHasANextTable(idx)) {
+        if (avail <= 8) {
+          // The code needs more bits than we have.
+          break;
+        }
+        table = table->NextTable(idx);
+        bitsUsed += 8;
+        continue;
+      }
 
-  uint32_t bytesRead = 0;
-  uint8_t bitsLeft = 0;
-  nsAutoCString buf;
-  nsresult rv;
-  uint8_t c;
-
-  while (bytesRead < bytes) {
-    uint32_t bytesConsumed = 0;
-    rv = DecodeHuffmanCharacter(&HuffmanIncomingRoot, c, bytesConsumed,
-                                bitsLeft);
-    if (NS_FAILED(rv)) {
-      LOG(("CopyHuffmanStringFromInput failed to decode a character"));
-      return rv;
+      entry = table->Entry(idx);
+      if (entry->mPrefixLen > avail) {
+        entry = nullptr;
+      }
+      break;
     }
 
-    bytesRead += bytesConsumed;
-    buf.Append(c);
-  }
-
-  if (bytesRead > bytes) {
-    LOG(("CopyHuffmanStringFromInput read more bytes than was allowed!"));
-    return NS_ERROR_FAILURE;
-  }
+    if (!entry) {
+      // What's left can't be a full character, so it's the padding.
+      MOZ_ASSERT(in == end);
+      if (bitsLeft > 7) {
+        LOG(("CopyHuffmanStringFromInput more than 7 bits of padding"));
+        return NS_ERROR_FAILURE;
+      }
 
-  if (bitsLeft) {
-    // The shortest valid code is 4 bits, so we know there can be at most one
-    // character left that our loop didn't decode. Check to see if that's the
-    // case, and if so, add it to our output.
-    rv = DecodeFinalHuffmanCharacter(&HuffmanIncomingRoot, c, bitsLeft);
-    if (NS_SUCCEEDED(rv)) {
-      buf.Append(c);
+      // The padding must be the start of the EOS symbol, i.e. all ones.
+      uint64_t mask = (1 << bitsLeft) - 1;
+      if ((bits & mask) != mask) {
+        LOG(("CopyHuffmanStringFromInput ran out of data but found possible "
+             "non-EOS symbol"));
+        return NS_ERROR_FAILURE;
+      }
+      break;
     }
-  }
-
-  if (bitsLeft > 7) {
-    LOG(("CopyHuffmanStringFromInput more than 7 bits of padding"));
-    return NS_ERROR_FAILURE;
-  }
 
-  if (bitsLeft) {
-    // Any bits left at this point must belong to the EOS symbol, so make sure
-    // they make sense (ie, are all ones)
-    uint8_t mask = (1 << bitsLeft) - 1;
-    uint8_t bits = mData[mOffset - 1] & mask;
-    if (bits != mask) {
-      LOG(("CopyHuffmanStringFromInput ran out of data but found possible "
-           "non-EOS symbol"));
+    if (entry->mValue == 256) {
+      LOG(("CopyHuffmanStringFromInput found an actual EOS"));
       return NS_ERROR_FAILURE;
     }
+
+    MOZ_ASSERT(out < outStart + maxLength);
+    *out++ = static_cast<char>(entry->mValue & 0xFF);
+    bitsLeft -= bitsUsed + entry->mPrefixLen;
   }
 
-  val = buf;
+  val.SetLength(out - outStart);
+  mOffset += bytes;
   LOG(("CopyHuffmanStringFromInput decoded a full string!"));
   return NS_OK;
 }
@@ -1327,79 +1258,57 @@ Http2Compressor::EncodeInteger(uint32_t prefixLen, uint32_t val)
 void
 Http2Compressor::HuffmanAppend(const nsCString &value)
 {
-  nsAutoCString buf;
-  uint8_t bitsLeft = 8;
   uint32_t length = value.Length();
-  uint32_t offset;
-  uint8_t *startByte;
+  const uint8_t *in = reinterpret_cast<const uint8_t *>(value.BeginReading());
 
+  // Compute the size of the encoded string first, so we can write its length
+  // and then encode the string straight into the output.
+  uint64_t encodedBits = 0;
   for (uint32_t i = 0; i < length; ++i) {
-    uint8_t idx = static_cast<uint8_t>(value[i]);
-    uint8_t huffLength = HuffmanOutgoing[idx].mLength;
-    uint32_t huffValue = HuffmanOutgoing[idx].mValue;
-
-    if (bitsLeft < 8) {
-      // Fill in the least significant <bitsLeft> bits of the previous byte
-      // first
-      uint32_t val;
-      if (huffLength >= bitsLeft) {
-        val = huffValue & ~((1 << (huffLength - bitsLeft)) - 1);
-        val >>= (huffLength - bitsLeft);
-      } else {
-        val = huffValue << (bitsLeft - huffLength);
-      }
-      val &= ((1 << bitsLeft) - 1);
-      offset = buf.Length() - 1;
-      startByte = reinterpret_cast<unsigned char *>(buf.BeginWriting()) + offset;
-      *startByte = *startByte | static_cast<uint8_t>(val & 0xFF);
-      if (huffLength >= bitsLeft) {
-        huffLength -= bitsLeft;
-        bitsLeft = 8;
-      } else {
-        bitsLeft -= huffLength;
-        huffLength = 0;
-      }
-    }
+    encodedBits += HuffmanOutgoing[in[i]].mLength;
+  }
+  uint32_t bufLength = (encodedBits + 7) / 8;
 
-    while (huffLength >= 8) {
-      uint32_t mask = ~((1 << (huffLength - 8)) - 1);
-      uint8_t val = ((huffValue & mask) >> (huffLength - 8)) & 0xFF;
-      buf.Append(reinterpret_cast<char *>(&val), 1);
-      huffLength -= 8;
-    }
+  uint32_t offset = mOutput->Length();
+  EncodeInteger(7, bufLength);
+  uint8_t *startByte =
+    reinterpret_cast<unsigned char *>(mOutput->BeginWriting()) + offset;
+  *startByte = *startByte | 0x80;
 
-    if (huffLength) {
-      // Fill in the most significant <huffLength> bits of the next byte
-      bitsLeft = 8 - huffLength;
-      uint8_t val = (huffValue & ((1 << huffLength) - 1)) << bitsLeft;
-      buf.Append(reinterpret_cast<char *>(&val), 1);
+  offset = mOutput->Length();
+  mOutput->SetLength(offset + bufLength);
+  uint8_t *out =
+    reinterpret_cast<unsigned char *>(mOutput->BeginWriting()) + offset;
+
+  // The |bitCount| least significant bits of |bits| are the encoded bits that
+  // haven't been written yet. There are always less than 8 of them between the
+  // characters, so adding a code of at most 30 bits can't overflow.
+  uint64_t bits = 0;
+  uint32_t bitCount = 0;
+  for (uint32_t i = 0; i < length; ++i) {
+    const HuffmanOutgoingEntry &entry = HuffmanOutgoing[in[i]];
+    bits = (bits << entry.mLength) | entry.mValue;
+    bitCount += entry.mLength;
+    while (bitCount >= 8) {
+      bitCount -= 8;
+      *out++ = static_cast<uint8_t>((bits >> bitCount) & 0xFF);
     }
   }
 
-  if (bitsLeft != 8) {
-    // Pad the last <bitsLeft> bits with ones, which corresponds to the EOS
+  if (bitCount) {
+    // Pad the last <8 - bitCount> bits with ones, which corresponds to the EOS
     // encoding
-    uint8_t val = (1 << bitsLeft) - 1;
-    offset = buf.Length() - 1;
-    startByte = reinterpret_cast<unsigned char *>(buf.BeginWriting()) + offset;
-    *startByte = *startByte | val;
+    uint8_t padding = (1 << (8 - bitCount)) - 1;
+    *out++ = static_cast<uint8_t>((bits << (8 - bitCount)) & 0xFF) | padding;
   }
+  MOZ_ASSERT(out == reinterpret_cast<const uint8_t *>(mOutput->EndReading()));
 
-  // Now we know how long our encoded string is, we can fill in our length
-  uint32_t bufLength = buf.Length();
-  offset = mOutput->Length();
-  EncodeInteger(7, bufLength);
-  startByte = reinterpret_cast<unsigned char *>(mOutput->BeginWriting()) + offset;
-  *startByte = *startByte | 0x80;
-
-  // Finally, we can add our REAL data!
-  mOutput->Append(buf);
   LOG(("Http2Compressor::HuffmanAppend %p encoded %d byte original on %d "
        "bytes.\n", this, length, bufLength));
 }
 
 void
-Http2Compressor::ProcessHeader(const nvPair inputPair, bool noLocalIndex,
+Http2Compressor::ProcessHeader(const nvPair &inputPair, bool noLocalIndex,
                                bool neverIndex)
 {
   uint32_t newSize = inputPair.Size();
@@ -18,8 +18,6 @@
 namespace mozilla {
 namespace net {
 
-struct HuffmanIncomingTable;
-
 void Http2CompressionCleanup();
 
 class nvPair
@@ -131,14 +129,7 @@ private:
 
   MOZ_MUST_USE nsresult CopyHeaderString(uint32_t index, nsACString &name);
   MOZ_MUST_USE nsresult CopyStringFromInput(uint32_t index, nsACString &val);
-  uint8_t ExtractByte(uint8_t bitsLeft, uint32_t &bytesConsumed);
   MOZ_MUST_USE nsresult CopyHuffmanStringFromInput(uint32_t index, nsACString &val);
-  MOZ_MUST_USE nsresult
-  DecodeHuffmanCharacter(const HuffmanIncomingTable *table, uint8_t &c,
-                         uint32_t &bytesConsumed, uint8_t &bitsLeft);
-  MOZ_MUST_USE nsresult
-  DecodeFinalHuffmanCharacter(const HuffmanIncomingTable *table, uint8_t &c,
-                              uint8_t &bitsLeft);
 
   nsCString mHeaderStatus;
   nsCString mHeaderHost;
@@ -192,7 +183,7 @@ private:
   void DoOutput(Http2Compressor::outputCode code,
                 const class nvPair *pair, uint32_t index);
   void EncodeInteger(uint32_t prefixLen, uint32_t val);
-  void ProcessHeader(const nvPair inputPair, bool noLocalIndex,
+  void ProcessHeader(const nvPair &inputPair, bool noLocalIndex,
                      bool neverIndex);
   void HuffmanAppend(const nsCString &value);
   void EncodeTableSizeChange(uint32_t newMaxSize);
@@ -71,6 +71,7 @@ Http2PushedStream::Http2PushedStream(Http2PushTransactionBuffer *aTransaction,
   , mStatus(NS_OK)
   , mPushCompleted(false)
   , mDeferCleanupOnSuccess(true)
+  , mConsumed(false)
   , mDeferCleanupOnPush(false)
   , mOnPushFailed(false)
 {
@@ -247,6 +248,9 @@ Http2PushedStream::SetConsumerStream(Http2Stream *consumer)
 {
   mConsumerStream = consumer;
   mDeferCleanupOnPush = false;
+  if (consumer) {
+    mConsumed = true;
+  }
 }
 
 bool
@@ -41,6 +41,10 @@ public:
   virtual Http2Stream *GetConsumerStream() override { return mConsumerStream; };
 
   void SetConsumerStream(Http2Stream *aStream);
+
+  // Whether a pull stream was ever matched to this push, i.e. the pushed
+  // response was used rather than wasted.
+  bool WasConsumed() { return mConsumed; }
   MOZ_MUST_USE bool GetHashKey(nsCString &key);
 
   // override of Http2Stream
@@ -86,6 +90,7 @@ private:
   nsresult mStatus;
   bool mPushCompleted; // server push FIN received
   bool mDeferCleanupOnSuccess;
+  bool mConsumed;
 
   // mDeferCleanupOnPush prevents Http2Session::CleanupStream() from
   // destroying the push stream on an error code during the period between
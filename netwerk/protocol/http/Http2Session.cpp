@@ -103,6 +103,8 @@ Http2Session::Http2Session(nsISocketTransport *aSocketTransport, uint32_t versio
   , mOutgoingGoAwayID(0)
   , mConcurrent(0)
   , mServerPushedResources(0)
+  , mServerPushedResourcesUsed(0)
+  , mServerPushedResourcesWasted(0)
   , mServerInitialStreamWindow(kDefaultRwin)
   , mLocalSessionWindow(kDefaultRwin)
   , mServerSessionWindow(kDefaultRwin)
@@ -178,6 +180,10 @@ Http2Session::~Http2Session()
   Telemetry::Accumulate(Telemetry::SPDY_REQUEST_PER_CONN, (mNextStreamID - 1) / 2);
   Telemetry::Accumulate(Telemetry::SPDY_SERVER_INITIATED_STREAMS,
                         mServerPushedResources);
+  if (mServerPushedResourcesUsed || mServerPushedResourcesWasted) {
+    LOG3(("Http2Session::~Http2Session %p pushed streams used=%u wasted=%u",
+          this, mServerPushedResourcesUsed, mServerPushedResourcesWasted));
+  }
   Telemetry::Accumulate(Telemetry::SPDY_GOAWAY_LOCAL, mClientGoAwayReason);
   Telemetry::Accumulate(Telemetry::SPDY_GOAWAY_PEER, mPeerGoAwayReason);
 }
@@ -1102,6 +1108,14 @@ Http2Session::CleanupStream(Http2Stream *aStream, nsresult aResult,
     if (!(id & 1)) {
       mPushedStreams.RemoveElement(aStream);
       Http2PushedStream *pushStream = static_cast<Http2PushedStream *>(aStream);
+      bool consumed = pushStream->WasConsumed();
+      if (consumed) {
+        ++mServerPushedResourcesUsed;
+      } else {
+        ++mServerPushedResourcesWasted;
+      }
+      Telemetry::Accumulate(Telemetry::SPDY_SERVER_INITIATED_STREAM_USED,
+                            consumed);
       nsAutoCString hashKey;
       DebugOnly<bool> rv = pushStream->GetHashKey(hashKey);
       MOZ_ASSERT(rv);
@@ -466,6 +466,11 @@ private:
   // The number of server initiated promises, tracked for telemetry
   uint32_t             mServerPushedResources;
 
+  // Of those, the ones that were matched to a request before being cleaned
+  // up, and the ones that were dropped unused.
+  uint32_t             mServerPushedResourcesUsed;
+  uint32_t             mServerPushedResourcesWasted;
+
   // The server rwin for new streams as determined from a SETTINGS frame
   uint32_t             mServerInitialStreamWindow;
 
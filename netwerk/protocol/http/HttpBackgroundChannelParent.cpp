@@ -176,6 +176,16 @@ HttpBackgroundChannelParent::OnStartRequestSent()
   return SendOnStartRequestSent();
 }
 
+already_AddRefed<nsIEventTarget>
+HttpBackgroundChannelParent::GetBackgroundTarget()
+{
+  AssertIsInMainProcess();
+
+  MutexAutoLock lock(mBgThreadMutex);
+  nsCOMPtr<nsIEventTarget> target = mBackgroundThread;
+  return target.forget();
+}
+
 bool
 HttpBackgroundChannelParent::OnTransportAndData(
                                                const nsresult& aChannelStatus,
@@ -43,6 +43,11 @@ public:
   // To send OnStartRequestSend message over background channel.
   bool OnStartRequestSent();
 
+  // The thread this channel sends its messages on. HttpChannelParent delivers
+  // the data of the channel on it, so that OnTransportAndData can be sent
+  // without going through the main thread.
+  already_AddRefed<nsIEventTarget> GetBackgroundTarget();
+
   // To send OnTransportAndData message over background channel.
   bool OnTransportAndData(const nsresult& aChannelStatus,
                           const nsresult& aTransportStatus,
@@ -32,6 +32,7 @@
 #include "nsURLHelper.h"
 #include "nsICookieService.h"
 #include "nsIStreamConverterService.h"
+#include "nsIThreadRetargetableStreamListener.h"
 #include "nsCRT.h"
 #include "nsContentUtils.h"
 #include "nsIScriptSecurityManager.h"
@@ -1065,6 +1066,7 @@ HttpBaseChannel::DoApplyContentConversions(nsIStreamListener* aNextListener,
 // sniffing)
 //
 class InterceptFailedOnStop : public nsIStreamListener
+                            , public nsIThreadRetargetableStreamListener
 {
   virtual ~InterceptFailedOnStop() {}
   nsCOMPtr<nsIStreamListener> mNext;
@@ -1097,9 +1099,24 @@ public:
   {
     return mNext->OnDataAvailable(aRequest, aContext, aInputStream, aOffset, aCount);
   }
+
+  // The converters in front of us are retargetable, so don't stand in the way
+  // of moving the decoding off the main thread when our listener allows it.
+  // OnStopRequest, which touches mChannel, always runs on the main thread.
+  NS_IMETHOD CheckListenerChain() override
+  {
+    MOZ_ASSERT(NS_IsMainThread(), "Should be on main thread!");
+    nsCOMPtr<nsIThreadRetargetableStreamListener> listener =
+      do_QueryInterface(mNext);
+    if (!listener) {
+      return NS_ERROR_NO_INTERFACE;
+    }
+    return listener->CheckListenerChain();
+  }
 };
 
-NS_IMPL_ISUPPORTS(InterceptFailedOnStop, nsIStreamListener, nsIRequestObserver)
+NS_IMPL_ISUPPORTS(InterceptFailedOnStop, nsIStreamListener, nsIRequestObserver,
+                  nsIThreadRetargetableStreamListener)
 
 NS_IMETHODIMP
 HttpBaseChannel::DoApplyContentConversions(nsIStreamListener* aNextListener,
@@ -3876,6 +3893,36 @@ HttpBaseChannel::GetCacheReadEnd(TimeStamp* _retval) {
   return NS_OK;
 }
 
+NS_IMETHODIMP
+HttpBaseChannel::GetTransactionPending(TimeStamp* _retval) {
+  *_retval = mTransactionTimings.transactionPending;
+  return NS_OK;
+}
+
+NS_IMETHODIMP
+HttpBaseChannel::GetTransactionDispatched(TimeStamp* _retval) {
+  *_retval = mTransactionTimings.transactionDispatched;
+  return NS_OK;
+}
+
+NS_IMETHODIMP
+HttpBaseChannel::GetCacheEntryOpenStart(TimeStamp* _retval) {
+  *_retval = mCacheEntryOpenStart;
+  return NS_OK;
+}
+
+NS_IMETHODIMP
+HttpBaseChannel::GetCacheEntryAvailable(TimeStamp* _retval) {
+  *_retval = mCacheEntryAvailable;
+  return NS_OK;
+}
+
+NS_IMETHODIMP
+HttpBaseChannel::GetOnStartRequestStart(TimeStamp* _retval) {
+  *_retval = mOnStartRequestStart;
+  return NS_OK;
+}
+
 NS_IMETHODIMP
 HttpBaseChannel::GetInitiatorType(nsAString & aInitiatorType)
 {
@@ -3924,6 +3971,11 @@ IMPL_TIMING_ATTR(CacheReadStart)
 IMPL_TIMING_ATTR(CacheReadEnd)
 IMPL_TIMING_ATTR(RedirectStart)
 IMPL_TIMING_ATTR(RedirectEnd)
+IMPL_TIMING_ATTR(TransactionPending)
+IMPL_TIMING_ATTR(TransactionDispatched)
+IMPL_TIMING_ATTR(CacheEntryOpenStart)
+IMPL_TIMING_ATTR(CacheEntryAvailable)
+IMPL_TIMING_ATTR(OnStartRequestStart)
 
 #undef IMPL_TIMING_ATTR
 
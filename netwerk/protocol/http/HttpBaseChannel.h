@@ -576,6 +576,9 @@ protected:
   TimeStamp                         mAsyncOpenTime;
   TimeStamp                         mCacheReadStart;
   TimeStamp                         mCacheReadEnd;
+  TimeStamp                         mCacheEntryOpenStart;
+  TimeStamp                         mCacheEntryAvailable;
+  TimeStamp                         mOnStartRequestStart;
   TimeStamp                         mLaunchServiceWorkerStart;
   TimeStamp                         mLaunchServiceWorkerEnd;
   TimeStamp                         mDispatchFetchEventStart;
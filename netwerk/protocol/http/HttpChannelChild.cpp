@@ -1048,6 +1048,8 @@ HttpChannelChild::OnStopRequest(const nsresult& channelStatus,
       conv->GetDecodedDataLength(&mDecodedBodySize);
   }
 
+  mTransactionTimings.transactionPending = timing.transactionPending;
+  mTransactionTimings.transactionDispatched = timing.transactionDispatched;
   mTransactionTimings.domainLookupStart = timing.domainLookupStart;
   mTransactionTimings.domainLookupEnd = timing.domainLookupEnd;
   mTransactionTimings.connectStart = timing.connectStart;
@@ -1072,6 +1074,9 @@ HttpChannelChild::OnStopRequest(const nsresult& channelStatus,
 
   mCacheReadStart = timing.cacheReadStart;
   mCacheReadEnd = timing.cacheReadEnd;
+  mCacheEntryOpenStart = timing.cacheEntryOpenStart;
+  mCacheEntryAvailable = timing.cacheEntryAvailable;
+  mOnStartRequestStart = timing.onStartRequestStart;
 
   Performance* documentPerformance = GetPerformance();
   if (documentPerformance) {
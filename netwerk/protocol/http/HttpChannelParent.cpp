@@ -15,6 +15,7 @@
 #include "mozilla/dom/TabParent.h"
 #include "mozilla/net/NeckoParent.h"
 #include "mozilla/IntegerPrintfMacros.h"
+#include "mozilla/Preferences.h"
 #include "mozilla/UniquePtr.h"
 #include "mozilla/Unused.h"
 #include "HttpBackgroundChannelParent.h"
@@ -60,6 +61,10 @@ using namespace mozilla::ipc;
 namespace mozilla {
 namespace net {
 
+// Whether the data of child channels is delivered on the background channel's
+// thread instead of the main thread.
+static bool sRetargetDeliveryToBackgroundChannel = true;
+
 HttpChannelParent::HttpChannelParent(const PBrowserOrId& iframeEmbedding,
                                      nsILoadContext* aLoadContext,
                                      PBOverrideStatus aOverrideStatus)
@@ -80,6 +85,14 @@ HttpChannelParent::HttpChannelParent(const PBrowserOrId& iframeEmbedding,
 {
   LOG(("Creating HttpChannelParent [this=%p]\n", this));
 
+  static bool sRetargetPrefInited = false;
+  if (!sRetargetPrefInited) {
+    sRetargetPrefInited = true;
+    Preferences::AddBoolVarCache(&sRetargetDeliveryToBackgroundChannel,
+                                 "network.http.parent_data_off_main_thread",
+                                 true);
+  }
+
   // Ensure gHttpHandler is initialized: we need the atom table up and running.
   nsCOMPtr<nsIHttpProtocolHandler> dummyInitializer =
     do_GetService(NS_NETWORK_PROTOCOL_CONTRACTID_PREFIX "http");
@@ -279,6 +292,7 @@ NS_INTERFACE_MAP_BEGIN(HttpChannelParent)
   NS_INTERFACE_MAP_ENTRY(nsIParentRedirectingChannel)
   NS_INTERFACE_MAP_ENTRY(nsIDeprecationWarner)
   NS_INTERFACE_MAP_ENTRY(nsIAsyncVerifyRedirectReadyCallback)
+  NS_INTERFACE_MAP_ENTRY(nsIThreadRetargetableStreamListener)
   NS_INTERFACE_MAP_ENTRY_AMBIGUOUS(nsISupports, nsIParentRedirectingChannel)
   if (aIID.Equals(NS_GET_IID(HttpChannelParent))) {
     foundInterface = static_cast<nsIInterfaceRequestor*>(this);
@@ -1514,12 +1528,49 @@ HttpChannelParent::OnStartRequest(nsIRequest *aRequest, nsISupports *aContext)
     MOZ_ASSERT(mBgParent);
     if (!mBgParent->OnStartRequestSent()) {
       rv = NS_ERROR_UNEXPECTED;
+    } else {
+      RetargetDeliveryToBackgroundChannel(chan);
     }
   }
 
   return rv;
 }
 
+void
+HttpChannelParent::RetargetDeliveryToBackgroundChannel(nsHttpChannel *aChannel)
+{
+  MOZ_ASSERT(NS_IsMainThread());
+  MOZ_ASSERT(mBgParent);
+
+  if (!sRetargetDeliveryToBackgroundChannel) {
+    return;
+  }
+
+  // Only document loads can be diverted back to the parent (downloads, PSM
+  // content and the like), and the listeners they're diverted to expect the
+  // data on the main thread.
+  nsLoadFlags loadFlags = 0;
+  aChannel->GetLoadFlags(&loadFlags);
+  if (loadFlags & nsIChannel::LOAD_DOCUMENT_URI) {
+    return;
+  }
+
+  nsCOMPtr<nsIEventTarget> target = mBgParent->GetBackgroundTarget();
+  if (!target) {
+    return;
+  }
+
+  // Must be set before the data can arrive on the background thread.
+  mDataBgParent = mBgParent;
+
+  nsresult rv = aChannel->RetargetDeliveryTo(target);
+  if (NS_FAILED(rv)) {
+    LOG(("HttpChannelParent::RetargetDeliveryToBackgroundChannel failed "
+         "[this=%p rv=%" PRIx32 "]\n", this, static_cast<uint32_t>(rv)));
+    mDataBgParent = nullptr;
+  }
+}
+
 NS_IMETHODIMP
 HttpChannelParent::OnStopRequest(nsIRequest *aRequest,
                                  nsISupports *aContext,
@@ -1532,6 +1583,8 @@ HttpChannelParent::OnStopRequest(nsIRequest *aRequest,
   MOZ_RELEASE_ASSERT(!mDivertingFromChild,
     "Cannot call OnStopRequest if diverting is set!");
   ResourceTimingStruct timing;
+  mChannel->GetTransactionPending(&timing.transactionPending);
+  mChannel->GetTransactionDispatched(&timing.transactionDispatched);
   mChannel->GetDomainLookupStart(&timing.domainLookupStart);
   mChannel->GetDomainLookupEnd(&timing.domainLookupEnd);
   mChannel->GetConnectStart(&timing.connectStart);
@@ -1551,9 +1604,15 @@ HttpChannelParent::OnStopRequest(nsIRequest *aRequest,
 
   mChannel->GetCacheReadStart(&timing.cacheReadStart);
   mChannel->GetCacheReadEnd(&timing.cacheReadEnd);
+  mChannel->GetCacheEntryOpenStart(&timing.cacheEntryOpenStart);
+  mChannel->GetCacheEntryAvailable(&timing.cacheEntryAvailable);
+  mChannel->GetOnStartRequestStart(&timing.onStartRequestStart);
 
   mChannel->SetWarningReporter(nullptr);
 
+  // All the data has been delivered now.
+  mDataBgParent = nullptr;
+
   // Either IPC channel is closed or background channel
   // is ready to send OnStopRequest.
   MOZ_ASSERT(mIPCClosed || mBgParent);
@@ -1579,17 +1638,35 @@ HttpChannelParent::OnDataAvailable(nsIRequest *aRequest,
 {
   LOG(("HttpChannelParent::OnDataAvailable [this=%p aRequest=%p offset=%" PRIu64
        " count=%" PRIu32 "]\n", this, aRequest, aOffset, aCount));
-  MOZ_ASSERT(NS_IsMainThread());
 
-  MOZ_RELEASE_ASSERT(!mDivertingFromChild,
-    "Cannot call OnDataAvailable if diverting is set!");
+  // Once the delivery was retargeted we're called on the background channel's
+  // thread, where only mDataBgParent may be used; mIPCClosed, mBgParent and
+  // mChannel belong to the main thread.
+  HttpBackgroundChannelParent *bgParent;
+  if (NS_IsMainThread()) {
+    MOZ_RELEASE_ASSERT(!mDivertingFromChild,
+      "Cannot call OnDataAvailable if diverting is set!");
+
+    // Either IPC channel is closed or background channel
+    // is ready to send OnTransportAndData.
+    MOZ_ASSERT(mIPCClosed || mBgParent);
+    bgParent = mIPCClosed ? nullptr : mBgParent.get();
+  } else {
+    MOZ_ASSERT(mDataBgParent);
+    bgParent = mDataBgParent;
+  }
+
+  RefPtr<nsHttpChannel> chan = do_QueryObject(aRequest);
+  if (!chan) {
+    return NS_ERROR_UNEXPECTED;
+  }
 
   nsresult channelStatus = NS_OK;
-  mChannel->GetStatus(&channelStatus);
+  chan->GetStatus(&channelStatus);
 
   nsresult transportStatus =
-    (mChannel->IsReadingFromCache()) ? NS_NET_STATUS_READING
-                                     : NS_NET_STATUS_RECEIVING_FROM;
+    (chan->IsReadingFromCache()) ? NS_NET_STATUS_READING
+                                 : NS_NET_STATUS_RECEIVING_FROM;
 
   static uint32_t const kCopyChunkSize = 128 * 1024;
   uint32_t toRead = std::min<uint32_t>(aCount, kCopyChunkSize);
@@ -1606,13 +1683,9 @@ HttpChannelParent::OnDataAvailable(nsIRequest *aRequest,
       return rv;
     }
 
-    // Either IPC channel is closed or background channel
-    // is ready to send OnTransportAndData.
-    MOZ_ASSERT(mIPCClosed || mBgParent);
-
-    if (mIPCClosed || !mBgParent ||
-        !mBgParent->OnTransportAndData(channelStatus, transportStatus,
-                                       aOffset, toRead, data)) {
+    if (!bgParent ||
+        !bgParent->OnTransportAndData(channelStatus, transportStatus,
+                                      aOffset, toRead, data)) {
       return NS_ERROR_UNEXPECTED;
     }
 
@@ -1624,6 +1697,25 @@ HttpChannelParent::OnDataAvailable(nsIRequest *aRequest,
   return NS_OK;
 }
 
+//-----------------------------------------------------------------------------
+// HttpChannelParent::nsIThreadRetargetableStreamListener
+//-----------------------------------------------------------------------------
+
+NS_IMETHODIMP
+HttpChannelParent::CheckListenerChain()
+{
+  MOZ_ASSERT(NS_IsMainThread());
+
+  // OnDataAvailable only sends the data over the background channel, which
+  // can be done from its own thread. Anything else must stay on the main
+  // thread.
+  if (!mBgParent) {
+    return NS_ERROR_NO_INTERFACE;
+  }
+
+  return NS_OK;
+}
+
 //-----------------------------------------------------------------------------
 // HttpChannelParent::nsIProgressEventSink
 //-----------------------------------------------------------------------------
@@ -21,6 +21,7 @@
 #include "nsIAuthPromptProvider.h"
 #include "mozilla/dom/ipc/IdType.h"
 #include "nsIDeprecationWarner.h"
+#include "nsIThreadRetargetableStreamListener.h"
 
 class nsICacheEntry;
 class nsIAssociatedContentSecurity;
@@ -55,13 +56,15 @@ class HttpChannelParent final : public nsIInterfaceRequestor
                               , public nsIDeprecationWarner
                               , public HttpChannelSecurityWarningReporter
                               , public nsIAsyncVerifyRedirectReadyCallback
+                              , public nsIThreadRetargetableStreamListener
 {
   virtual ~HttpChannelParent();
 
 public:
-  NS_DECL_ISUPPORTS
+  NS_DECL_THREADSAFE_ISUPPORTS
   NS_DECL_NSIREQUESTOBSERVER
   NS_DECL_NSISTREAMLISTENER
+  NS_DECL_NSITHREADRETARGETABLESTREAMLISTENER
   NS_DECL_NSIPARENTCHANNEL
   NS_DECL_NSIPARENTREDIRECTINGCHANNEL
   NS_DECL_NSIPROGRESSEVENTSINK
@@ -253,6 +256,11 @@ private:
   // DocumentChannelCleanup.
   void CleanupBackgroundChannel();
 
+  // Deliver the data of aChannel on the background channel's thread, so that
+  // OnDataAvailable doesn't need the main thread. Called once OnStartRequest
+  // was sent.
+  void RetargetDeliveryToBackgroundChannel(nsHttpChannel *aChannel);
+
   friend class HttpBackgroundChannelParent;
   friend class DivertDataAvailableEvent;
   friend class DivertStopRequestEvent;
@@ -311,6 +319,12 @@ private:
 
   RefPtr<HttpBackgroundChannelParent> mBgParent;
 
+  // The background channel OnDataAvailable sends the data to after the
+  // delivery was retargeted to its thread, see
+  // RetargetDeliveryToBackgroundChannel(). Unlike mBgParent it is kept until
+  // OnStopRequest, so that it can be used off the main thread.
+  RefPtr<HttpBackgroundChannelParent> mDataBgParent;
+
   // Number of events to wait before actually invoking AsyncOpen on the main
   // channel. For each asynchronous step required before InvokeAsyncOpen, should
   // increase 1 to mAsyncOpenBarrier and invoke TryInvokeAsyncOpen after
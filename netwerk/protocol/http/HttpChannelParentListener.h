@@ -13,6 +13,7 @@
 #include "nsIRedirectResultListener.h"
 #include "nsINetworkInterceptController.h"
 #include "nsIStreamListener.h"
+#include "nsIThreadRetargetableStreamListener.h"
 
 namespace mozilla {
 namespace net {
@@ -32,15 +33,17 @@ class HttpChannelParentListener final : public nsIInterfaceRequestor
                                       , public nsIRedirectResultListener
                                       , public nsIStreamListener
                                       , public nsINetworkInterceptController
+                                      , public nsIThreadRetargetableStreamListener
 {
 public:
-  NS_DECL_ISUPPORTS
+  NS_DECL_THREADSAFE_ISUPPORTS
   NS_DECL_NSIINTERFACEREQUESTOR
   NS_DECL_NSICHANNELEVENTSINK
   NS_DECL_NSIREDIRECTRESULTLISTENER
   NS_DECL_NSIREQUESTOBSERVER
   NS_DECL_NSISTREAMLISTENER
   NS_DECL_NSINETWORKINTERCEPTCONTROLLER
+  NS_DECL_NSITHREADRETARGETABLESTREAMLISTENER
 
   NS_DECLARE_STATIC_IID_ACCESSOR(HTTP_CHANNEL_PARENT_LISTENER_IID)
 
@@ -841,6 +841,41 @@ NullHttpChannel::GetCacheReadEnd(mozilla::TimeStamp *aCacheReadEnd)
   return NS_OK;
 }
 
+NS_IMETHODIMP
+NullHttpChannel::GetTransactionPending(mozilla::TimeStamp *aTransactionPending)
+{
+  *aTransactionPending = mAsyncOpenTime;
+  return NS_OK;
+}
+
+NS_IMETHODIMP
+NullHttpChannel::GetTransactionDispatched(mozilla::TimeStamp *aTransactionDispatched)
+{
+  *aTransactionDispatched = mAsyncOpenTime;
+  return NS_OK;
+}
+
+NS_IMETHODIMP
+NullHttpChannel::GetCacheEntryOpenStart(mozilla::TimeStamp *aCacheEntryOpenStart)
+{
+  *aCacheEntryOpenStart = mAsyncOpenTime;
+  return NS_OK;
+}
+
+NS_IMETHODIMP
+NullHttpChannel::GetCacheEntryAvailable(mozilla::TimeStamp *aCacheEntryAvailable)
+{
+  *aCacheEntryAvailable = mAsyncOpenTime;
+  return NS_OK;
+}
+
+NS_IMETHODIMP
+NullHttpChannel::GetOnStartRequestStart(mozilla::TimeStamp *aOnStartRequestStart)
+{
+  *aOnStartRequestStart = mAsyncOpenTime;
+  return NS_OK;
+}
+
 NS_IMETHODIMP
 NullHttpChannel::GetIsMainDocumentChannel(bool* aValue)
 {
@@ -894,6 +929,11 @@ IMPL_TIMING_ATTR(CacheReadStart)
 IMPL_TIMING_ATTR(CacheReadEnd)
 IMPL_TIMING_ATTR(RedirectStart)
 IMPL_TIMING_ATTR(RedirectEnd)
+IMPL_TIMING_ATTR(TransactionPending)
+IMPL_TIMING_ATTR(TransactionDispatched)
+IMPL_TIMING_ATTR(CacheEntryOpenStart)
+IMPL_TIMING_ATTR(CacheEntryAvailable)
+IMPL_TIMING_ATTR(OnStartRequestStart)
 
 #undef IMPL_TIMING_ATTR
 
@@ -11,6 +11,10 @@
 namespace mozilla { namespace net {
 
 struct TimingStruct {
+  // When the connection manager queued the transaction, and when it handed
+  // the transaction to a connection.
+  TimeStamp transactionPending;
+  TimeStamp transactionDispatched;
   TimeStamp domainLookupStart;
   TimeStamp domainLookupEnd;
   TimeStamp connectStart;
@@ -34,6 +38,9 @@ struct ResourceTimingStruct : TimingStruct {
   // the rest of the timings so the timing information in the child is complete.
   TimeStamp cacheReadStart;
   TimeStamp cacheReadEnd;
+  TimeStamp cacheEntryOpenStart;
+  TimeStamp cacheEntryAvailable;
+  TimeStamp onStartRequestStart;
 };
 
 } // namespace net
@@ -52,6 +52,7 @@
 #include "nsQueryObject.h"
 #include "nsThreadUtils.h"
 #include "GeckoProfiler.h"
+#include "ProfilerMarkerPayload.h"
 #include "nsIConsoleService.h"
 #include "mozilla/Attributes.h"
 #include "mozilla/DebugOnly.h"
@@ -3938,6 +3939,9 @@ nsHttpChannel::OpenCacheEntry(bool isHttps)
             if (mNetworkTriggered) {
                 mRaceCacheWithNetwork = true;
             }
+            if (mTimingEnabled) {
+                mCacheEntryOpenStart = TimeStamp::Now();
+            }
             rv = cacheStorage->AsyncOpenURI(openURI, extension, cacheEntryOpenFlags, this);
         } else {
             // We pass `this` explicitly as a parameter due to the raw pointer
@@ -3948,6 +3952,9 @@ nsHttpChannel::OpenCacheEntry(bool isHttps)
                 if (self->mNetworkTriggered) {
                     self->mRaceCacheWithNetwork = true;
                 }
+                if (self->mTimingEnabled) {
+                    self->mCacheEntryOpenStart = TimeStamp::Now();
+                }
                 cacheStorage->AsyncOpenURI(openURI, extension, cacheEntryOpenFlags, self);
             };
 
@@ -4379,6 +4386,9 @@ nsHttpChannel::OnCacheEntryAvailable(nsICacheEntry *entry,
 {
     MOZ_ASSERT(NS_IsMainThread());
     mOnCacheAvailableCalled = true;
+    if (mTimingEnabled && mCacheEntryAvailable.IsNull()) {
+        mCacheEntryAvailable = TimeStamp::Now();
+    }
 
     nsresult rv;
 
@@ -5269,6 +5279,30 @@ nsHttpChannel::InitOfflineCacheEntry()
 }
 
 
+// Whether the body of the response is likely to shrink when the cache stores
+// it compressed.  Content that is already encoded or is an image, video etc.
+// in a compressed format is not worth the CPU.
+static bool
+ShouldCompressCacheEntry(nsHttpResponseHead *responseHead)
+{
+    if (!CacheObserver::ChunkCompression())
+        return false;
+
+    if (responseHead->HasHeader(nsHttp::Content_Encoding))
+        return false;
+
+    nsAutoCString contentType;
+    responseHead->ContentType(contentType);
+
+    return StringBeginsWith(contentType, NS_LITERAL_CSTRING("text/")) ||
+           contentType.EqualsLiteral(APPLICATION_JAVASCRIPT) ||
+           contentType.EqualsLiteral(APPLICATION_XJAVASCRIPT) ||
+           contentType.EqualsLiteral(APPLICATION_ECMASCRIPT) ||
+           contentType.EqualsLiteral(APPLICATION_JSON) ||
+           contentType.EqualsLiteral(APPLICATION_XML) ||
+           contentType.EqualsLiteral(IMAGE_SVG_XML);
+}
+
 nsresult
 DoAddCacheEntryHeaders(nsHttpChannel *self,
                        nsICacheEntry *entry,
@@ -5363,6 +5397,12 @@ DoAddCacheEntryHeaders(nsHttpChannel *self,
     rv = entry->SetMetaDataElement("original-response-headers", head.get());
     if (NS_FAILED(rv)) return rv;
 
+    if (ShouldCompressCacheEntry(responseHead)) {
+        rv = entry->SetMetaDataElement(CacheFileUtils::kChunkCompressionKey,
+                                       "lz4");
+        if (NS_FAILED(rv)) return rv;
+    }
+
     // Indicate we have successfully finished setting metadata on the cache entry.
     rv = entry->MetaDataReady();
 
@@ -6911,6 +6951,24 @@ nsHttpChannel::GetResponseEnd(TimeStamp* _retval) {
     return NS_OK;
 }
 
+NS_IMETHODIMP
+nsHttpChannel::GetTransactionPending(TimeStamp* _retval) {
+    if (mTransaction)
+        *_retval = mTransaction->GetTransactionPending();
+    else
+        *_retval = mTransactionTimings.transactionPending;
+    return NS_OK;
+}
+
+NS_IMETHODIMP
+nsHttpChannel::GetTransactionDispatched(TimeStamp* _retval) {
+    if (mTransaction)
+        *_retval = mTransaction->GetTransactionDispatched();
+    else
+        *_retval = mTransactionTimings.transactionDispatched;
+    return NS_OK;
+}
+
 //-----------------------------------------------------------------------------
 // nsHttpChannel::nsIHttpAuthenticableChannel
 //-----------------------------------------------------------------------------
@@ -7057,6 +7115,9 @@ nsHttpChannel::OnStartRequest(nsIRequest *request, nsISupports *ctxt)
 
     mAfterOnStartRequestBegun = true;
     mOnStartRequestTimestamp = TimeStamp::Now();
+    if (mTimingEnabled && mOnStartRequestStart.IsNull()) {
+        mOnStartRequestStart = mOnStartRequestTimestamp;
+    }
 
     Telemetry::Accumulate(Telemetry::HTTP_ONSTART_SUSPEND_TOTAL_TIME,
                           mSuspendTotalTime);
@@ -7220,6 +7281,8 @@ nsHttpChannel::OnStopRequest(nsIRequest *request, nsISupports *ctxt, nsresult st
         ReportNetVSCacheTelemetry();
     }
 
+    AddNetworkTimingMarkers();
+
     // allow content to be cached if it was loaded successfully (bug #482935)
     bool contentComplete = NS_SUCCEEDED(status);
 
@@ -9085,6 +9148,48 @@ nsHttpChannel::ComputeTelemetryBucketNumber(int64_t difftime_ms)
 	                        : 40 - absBucketIndex;
 }
 
+void
+nsHttpChannel::AddNetworkTimingMarkers()
+{
+    if (!mTimingEnabled || !profiler_is_active()) {
+        return;
+    }
+
+    TimingStruct timings = mTransaction ? mTransaction->Timings()
+                                        : mTransactionTimings;
+    struct {
+        const char* phase;
+        TimeStamp start;
+        TimeStamp end;
+    } phases[] = {
+        { "Queue", timings.transactionPending, timings.transactionDispatched },
+        { "DNS", timings.domainLookupStart, timings.domainLookupEnd },
+        { "Connect", timings.connectStart, timings.connectEnd },
+        { "Request", timings.requestStart, timings.responseStart },
+        { "Response", timings.responseStart, timings.responseEnd },
+        // From the socket thread seeing the response to the main thread
+        // getting to OnStartRequest.
+        { "Dispatch", timings.responseStart, mOnStartRequestStart },
+        { "CacheEntryOpen", mCacheEntryOpenStart, mCacheEntryAvailable },
+        { "CacheRead", mCacheReadStart, mCacheReadEnd },
+    };
+
+    nsAutoCString spec;
+    if (mURI) {
+        mURI->GetAsciiSpec(spec);
+    }
+    for (const auto& phase : phases) {
+        if (phase.start.IsNull() || phase.end.IsNull() ||
+            phase.end < phase.start) {
+            continue;
+        }
+        profiler_add_marker(
+            "Network",
+            MakeUnique<NetworkMarkerPayload>(phase.phase, spec, mChannelId,
+                                             phase.start, phase.end));
+    }
+}
+
 void
 nsHttpChannel::ReportNetVSCacheTelemetry()
 {
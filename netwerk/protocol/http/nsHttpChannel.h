@@ -185,6 +185,8 @@ public:
     NS_IMETHOD GetRequestStart(mozilla::TimeStamp *aRequestStart) override;
     NS_IMETHOD GetResponseStart(mozilla::TimeStamp *aResponseStart) override;
     NS_IMETHOD GetResponseEnd(mozilla::TimeStamp *aResponseEnd) override;
+    NS_IMETHOD GetTransactionPending(mozilla::TimeStamp *aTransactionPending) override;
+    NS_IMETHOD GetTransactionDispatched(mozilla::TimeStamp *aTransactionDispatched) override;
     // nsICorsPreflightCallback
     NS_IMETHOD OnPreflightSucceeded() override;
     NS_IMETHOD OnPreflightFailed(nsresult aError) override;
@@ -484,6 +486,10 @@ private:
     // Report telemetry and stats to about:networking
     void ReportRcwnStats(bool isFromNet);
 
+    // Add a profiler marker for each phase of this request that we have
+    // timings for.
+    void AddNetworkTimingMarkers();
+
     // Create a aggregate set of the current notification callbacks
     // and ensure the transaction is updated to use it.
     void UpdateAggregateCallbacks();
@@ -1669,6 +1669,9 @@ nsHttpConnectionMgr::DispatchTransaction(nsConnectionEntry *ent,
              conn->ConnectionInfo()->Origin()));
         rv = conn->Activate(trans, caps, priority);
         MOZ_ASSERT(NS_SUCCEEDED(rv), "SPDY Cannot Fail Dispatch");
+        if (NS_SUCCEEDED(rv) && trans->TimingEnabled()) {
+            trans->SetTransactionDispatched(TimeStamp::Now(), true);
+        }
         if (NS_SUCCEEDED(rv) && !trans->GetPendingTime().IsNull()) {
             AccumulateTimeDelta(Telemetry::TRANSACTION_WAIT_TIME_SPDY,
                 trans->GetPendingTime(), TimeStamp::Now());
@@ -1682,6 +1685,9 @@ nsHttpConnectionMgr::DispatchTransaction(nsConnectionEntry *ent,
 
     rv = DispatchAbstractTransaction(ent, trans, caps, conn, priority);
 
+    if (NS_SUCCEEDED(rv) && trans->TimingEnabled()) {
+        trans->SetTransactionDispatched(TimeStamp::Now(), true);
+    }
     if (NS_SUCCEEDED(rv) && !trans->GetPendingTime().IsNull()) {
         AccumulateTimeDelta(Telemetry::TRANSACTION_WAIT_TIME_HTTP,
                             trans->GetPendingTime(), TimeStamp::Now());
@@ -1804,6 +1810,9 @@ nsHttpConnectionMgr::ProcessNewTransaction(nsHttpTransaction *trans)
     }
 
     trans->SetPendingTime();
+    if (trans->TimingEnabled()) {
+        trans->SetTransactionPending(trans->GetPendingTime(), true);
+    }
 
     Http2PushedStream *pushedStream = trans->GetPushedStream();
     if (pushedStream) {
@@ -218,6 +218,12 @@ public:
 
     nsresult UpdateCurrentTopLevelOuterContentWindowId(uint64_t aWindowId);
 
+    // the outer window id of the active tab, as last told.  socket thread only.
+    uint64_t CurrentTopLevelOuterContentWindowId()
+    {
+        return mCurrentTopLevelOuterContentWindowId;
+    }
+
     // tracks and untracks active transactions according their throttle status
     void AddActiveTransaction(nsHttpTransaction* aTrans);
     void RemoveActiveTransaction(nsHttpTransaction* aTrans,
@@ -20,6 +20,7 @@
 #include "nsIChannel.h"
 #include "nsIPipe.h"
 #include "nsCRT.h"
+#include "mozilla/Telemetry.h"
 #include "mozilla/Tokenizer.h"
 #include "TCPFastOpenLayer.h"
 
@@ -124,6 +125,7 @@ nsHttpTransaction::nsHttpTransaction()
     , mHttpResponseMatched(false)
     , mPreserveStream(false)
     , mDispatchedAsBlocking(false)
+    , mReportedTimeToFirstByte(false)
     , mResponseTimeoutEnabled(true)
     , mForceRestart(false)
     , mReuseOnRestart(false)
@@ -1141,6 +1143,11 @@ nsHttpTransaction::Close(nsresult reason)
         if (timings.responseEnd.IsNull() && !timings.responseStart.IsNull()) {
             SetResponseEnd(TimeStamp::Now());
         }
+        if (!mReportedTimeToFirstByte && !timings.requestStart.IsNull() &&
+            !timings.responseStart.IsNull()) {
+            mReportedTimeToFirstByte = true;
+            ReportTimeToFirstByte(timings);
+        }
     }
 
     if (relConn && mConnection) {
@@ -1980,6 +1987,26 @@ nsHttpTransaction::BootstrapTimings(TimingStruct times)
     mTimings = times;
 }
 
+void
+nsHttpTransaction::SetTransactionPending(mozilla::TimeStamp timeStamp, bool onlyIfNull)
+{
+    mozilla::MutexAutoLock lock(mLock);
+    if (onlyIfNull && !mTimings.transactionPending.IsNull()) {
+        return; // We only set the timestamp if it was previously null
+    }
+    mTimings.transactionPending = timeStamp;
+}
+
+void
+nsHttpTransaction::SetTransactionDispatched(mozilla::TimeStamp timeStamp, bool onlyIfNull)
+{
+    mozilla::MutexAutoLock lock(mLock);
+    if (onlyIfNull && !mTimings.transactionDispatched.IsNull()) {
+        return; // We only set the timestamp if it was previously null
+    }
+    mTimings.transactionDispatched = timeStamp;
+}
+
 void
 nsHttpTransaction::SetDomainLookupStart(mozilla::TimeStamp timeStamp, bool onlyIfNull)
 {
@@ -2020,6 +2047,39 @@ nsHttpTransaction::SetConnectEnd(mozilla::TimeStamp timeStamp, bool onlyIfNull)
     mTimings.connectEnd = timeStamp;
 }
 
+void
+nsHttpTransaction::ReportTimeToFirstByte(const TimingStruct &aTimings)
+{
+    MOZ_ASSERT(OnSocketThread(), "not on socket thread");
+
+    // Keyed by the scheduling class the connection manager treats the
+    // transaction as, and whether it belongs to the tab in the foreground,
+    // so that the cost background loads impose on the active tab shows up.
+    nsAutoCString key;
+    if (mClassOfService & nsIClassOfService::UrgentStart) {
+        key.AssignLiteral("urgent-start");
+    } else if (mClassOfService & nsIClassOfService::Leader) {
+        key.AssignLiteral("leader");
+    } else if (mClassOfService & nsIClassOfService::Unblocked) {
+        key.AssignLiteral("unblocked");
+    } else if (mClassOfService & (nsIClassOfService::Throttleable |
+                                  nsIClassOfService::Background)) {
+        key.AssignLiteral("background");
+    } else {
+        key.AssignLiteral("other");
+    }
+
+    RefPtr<nsHttpConnectionMgr> connMgr = gHttpHandler->ConnMgr();
+    bool activeTab = connMgr && mTopLevelOuterContentWindowId &&
+        mTopLevelOuterContentWindowId ==
+            connMgr->CurrentTopLevelOuterContentWindowId();
+    key.Append(activeTab ? "-active" : "-inactive");
+
+    Telemetry::Accumulate(Telemetry::HTTP_TRANSACTION_TTFB_BY_CLASS, key,
+        static_cast<uint32_t>(
+            (aTimings.responseStart - aTimings.requestStart).ToMilliseconds()));
+}
+
 void
 nsHttpTransaction::SetRequestStart(mozilla::TimeStamp timeStamp, bool onlyIfNull)
 {
@@ -2050,6 +2110,20 @@ nsHttpTransaction::SetResponseEnd(mozilla::TimeStamp timeStamp, bool onlyIfNull)
     mTimings.responseEnd = timeStamp;
 }
 
+mozilla::TimeStamp
+nsHttpTransaction::GetTransactionPending()
+{
+    mozilla::MutexAutoLock lock(mLock);
+    return mTimings.transactionPending;
+}
+
+mozilla::TimeStamp
+nsHttpTransaction::GetTransactionDispatched()
+{
+    mozilla::MutexAutoLock lock(mLock);
+    return mTimings.transactionDispatched;
+}
+
 mozilla::TimeStamp
 nsHttpTransaction::GetDomainLookupStart()
 {
@@ -149,6 +149,8 @@ public:
     // Locked methods to get and set timing info
     const TimingStruct Timings();
     void BootstrapTimings(TimingStruct times);
+    void SetTransactionPending(mozilla::TimeStamp timeStamp, bool onlyIfNull = false);
+    void SetTransactionDispatched(mozilla::TimeStamp timeStamp, bool onlyIfNull = false);
     void SetDomainLookupStart(mozilla::TimeStamp timeStamp, bool onlyIfNull = false);
     void SetDomainLookupEnd(mozilla::TimeStamp timeStamp, bool onlyIfNull = false);
     void SetConnectStart(mozilla::TimeStamp timeStamp, bool onlyIfNull = false);
@@ -157,6 +159,8 @@ public:
     void SetResponseStart(mozilla::TimeStamp timeStamp, bool onlyIfNull = false);
     void SetResponseEnd(mozilla::TimeStamp timeStamp, bool onlyIfNull = false);
 
+    mozilla::TimeStamp GetTransactionPending();
+    mozilla::TimeStamp GetTransactionDispatched();
     mozilla::TimeStamp GetDomainLookupStart();
     mozilla::TimeStamp GetDomainLookupEnd();
     mozilla::TimeStamp GetConnectStart();
@@ -203,6 +207,7 @@ private:
     MOZ_MUST_USE nsresult ProcessData(char *, uint32_t, uint32_t *);
     void     DeleteSelfOnConsumerThread();
     void     ReleaseBlockingTransaction();
+    void     ReportTimeToFirstByte(const TimingStruct &aTimings);
 
     static MOZ_MUST_USE nsresult ReadRequestSegment(nsIInputStream *, void *,
                                                     const char *, uint32_t,
@@ -344,6 +349,7 @@ private:
     bool                            mHttpResponseMatched;
     bool                            mPreserveStream;
     bool                            mDispatchedAsBlocking;
+    bool                            mReportedTimeToFirstByte;
     bool                            mResponseTimeoutEnabled;
     bool                            mForceRestart;
     bool                            mReuseOnRestart;
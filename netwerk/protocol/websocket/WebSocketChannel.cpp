@@ -10,6 +10,7 @@
 
 #include "mozilla/Atomics.h"
 #include "mozilla/Attributes.h"
+#include "mozilla/CheckedInt.h"
 #include "mozilla/EndianUtils.h"
 #include "mozilla/MathAlgorithms.h"
 #include "mozilla/net/WebSocketEventService.h"
@@ -845,45 +846,52 @@ public:
       mResetDeflater = false;
     }
 
-    mDeflater.avail_out = kBufferLen;
-    mDeflater.next_out = mBuffer;
+    // Deflate straight into |_retval|; the output is rarely much larger than
+    // the input, so it usually fits the first allocation.
+    uint32_t written = _retval.Length();
     mDeflater.avail_in = dataLen;
     mDeflater.next_in = data;
 
     while (true) {
+      if (written == _retval.Length() &&
+          !GrowOutput(_retval, written, dataLen)) {
+        mResetDeflater = true;
+        return NS_ERROR_OUT_OF_MEMORY;
+      }
+
+      mDeflater.avail_out = _retval.Length() - written;
+      mDeflater.next_out =
+        reinterpret_cast<Bytef *>(_retval.BeginWriting()) + written;
+
       int zerr = deflate(&mDeflater, Z_SYNC_FLUSH);
 
       if (zerr != Z_OK) {
+        _retval.SetLength(written);
         mResetDeflater = true;
         return NS_ERROR_UNEXPECTED;
       }
 
-      uint32_t deflated = kBufferLen - mDeflater.avail_out;
-      if (deflated > 0) {
-        _retval.Append(reinterpret_cast<char *>(mBuffer), deflated);
-      }
-
-      mDeflater.avail_out = kBufferLen;
-      mDeflater.next_out = mBuffer;
+      written = _retval.Length() - mDeflater.avail_out;
 
       if (mDeflater.avail_in > 0) {
         continue; // There is still some data to deflate
       }
 
-      if (deflated == kBufferLen) {
+      if (mDeflater.avail_out == 0) {
         continue; // There was not enough space in the buffer
       }
 
       break;
     }
 
-    if (_retval.Length() < 4) {
+    if (written < 4) {
       MOZ_ASSERT(false, "Expected trailing not found in deflated data!");
+      _retval.SetLength(written);
       mResetDeflater = true;
       return NS_ERROR_UNEXPECTED;
     }
 
-    _retval.Truncate(_retval.Length() - 4);
+    _retval.SetLength(written - 4);
 
     return NS_OK;
   }
@@ -895,12 +903,21 @@ public:
     Bytef trailingData[] = { 0x00, 0x00, 0xFF, 0xFF };
     bool trailingDataUsed = false;
 
-    mInflater.avail_out = kBufferLen;
-    mInflater.next_out = mBuffer;
+    // Inflate straight into |_retval|, growing it as the message expands.
+    uint32_t written = _retval.Length();
     mInflater.avail_in = dataLen;
     mInflater.next_in = data;
 
     while (true) {
+      if (written == _retval.Length() &&
+          !GrowOutput(_retval, written, dataLen)) {
+        return NS_ERROR_OUT_OF_MEMORY;
+      }
+
+      mInflater.avail_out = _retval.Length() - written;
+      mInflater.next_out =
+        reinterpret_cast<Bytef *>(_retval.BeginWriting()) + written;
+
       int zerr = inflate(&mInflater, Z_NO_FLUSH);
 
       if (zerr == Z_STREAM_END) {
@@ -916,22 +933,17 @@ public:
         mInflater.next_out = saveNextOut;
         mInflater.avail_out = saveAvailOut;
       } else if (zerr != Z_OK && zerr != Z_BUF_ERROR) {
+        _retval.SetLength(written);
         return NS_ERROR_INVALID_CONTENT_ENCODING;
       }
 
-      uint32_t inflated = kBufferLen - mInflater.avail_out;
-      if (inflated > 0) {
-        _retval.Append(reinterpret_cast<char *>(mBuffer), inflated);
-      }
-
-      mInflater.avail_out = kBufferLen;
-      mInflater.next_out = mBuffer;
+      written = _retval.Length() - mInflater.avail_out;
 
       if (mInflater.avail_in > 0) {
         continue; // There is still some data to inflate
       }
 
-      if (inflated == kBufferLen) {
+      if (mInflater.avail_out == 0) {
         continue; // There was not enough space in the buffer
       }
 
@@ -942,11 +954,24 @@ public:
         continue;
       }
 
+      _retval.SetLength(written);
       return NS_OK;
     }
   }
 
 private:
+  // Makes room past the |aWritten| bytes of output in |aOutput|: at least
+  // twice the input to start with, then doubling.
+  static bool GrowOutput(nsACString &aOutput, uint32_t aWritten,
+                         uint32_t aInputLen)
+  {
+    CheckedUint32 length = aWritten;
+    length += std::max(aWritten, std::max(aInputLen, kBufferLen / 2));
+    length += std::max(aInputLen, kBufferLen / 2);
+    return length.isValid() &&
+           aOutput.SetLength(length.value(), fallible);
+  }
+
   bool                  mActive;
   bool                  mNoContextTakeover;
   bool                  mResetDeflater;
@@ -954,7 +979,6 @@ private:
   z_stream              mDeflater;
   z_stream              mInflater;
   const static uint32_t kBufferLen = 4096;
-  uint8_t               mBuffer[kBufferLen];
 };
 
 //-----------------------------------------------------------------------------
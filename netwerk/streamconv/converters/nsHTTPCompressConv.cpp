@@ -189,15 +189,20 @@ nsHTTPCompressConv::BrotliHandler(nsIInputStream *stream, void *closure, const c
     return NS_OK;
   }
 
-  auto outBuffer = MakeUniqueFallible<uint8_t[]>(kOutSize);
-  if (outBuffer == nullptr) {
-    self->mBrotli->mStatus = NS_ERROR_OUT_OF_MEMORY;
-    return self->mBrotli->mStatus;
+  // ReadSegments calls us once per segment of the pipe, so keep the output
+  // chunk around instead of allocating it for every one of them.
+  if (!self->mBrotli->mOutBuffer) {
+    self->mBrotli->mOutBuffer = MakeUniqueFallible<uint8_t[]>(kOutSize);
+    if (!self->mBrotli->mOutBuffer) {
+      self->mBrotli->mStatus = NS_ERROR_OUT_OF_MEMORY;
+      return self->mBrotli->mStatus;
+    }
   }
+  uint8_t *outBuffer = self->mBrotli->mOutBuffer.get();
 
   do {
     outSize = kOutSize;
-    outPtr = outBuffer.get();
+    outPtr = outBuffer;
 
     // brotli api is documented in brotli/dec/decode.h and brotli/dec/decode.c
     LOG(("nsHttpCompresssConv %p brotlihandler decompress %zu\n", self, avail));
@@ -232,7 +237,7 @@ nsHTTPCompressConv::BrotliHandler(nsIInputStream *stream, void *closure, const c
       nsresult rv = self->do_OnDataAvailable(self->mBrotli->mRequest,
                                              self->mBrotli->mContext,
                                              self->mBrotli->mSourceOffset,
-                                             reinterpret_cast<const char *>(outBuffer.get()),
+                                             reinterpret_cast<const char *>(outBuffer),
                                              outSize);
       LOG(("nsHttpCompressConv %p BrotliHandler ODA rv=%" PRIx32, self, static_cast<uint32_t>(rv)));
       if (NS_FAILED(rv)) {
@@ -14,6 +14,7 @@
 #include "nsAutoPtr.h"
 #include "mozilla/Atomics.h"
 #include "mozilla/Mutex.h"
+#include "mozilla/UniquePtr.h"
 
 #include "zlib.h"
 
@@ -77,6 +78,9 @@ public:
   nsIRequest  *mRequest;
   nsISupports *mContext;
   uint64_t     mSourceOffset;
+
+  // The decoded output, allocated on first use and reused for every segment.
+  UniquePtr<uint8_t[]> mOutBuffer;
 };
 
 class nsHTTPCompressConv
@@ -0,0 +1,94 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "gtest/gtest.h"
+#include "gtest/MozGTestBench.h" // For MOZ_GTEST_BENCH
+
+#include "nsCOMPtr.h"
+#include "nsIEffectiveTLDService.h"
+#include "nsNetCID.h"
+#include "nsPrintfCString.h"
+#include "nsServiceManagerUtils.h"
+#include "nsString.h"
+
+static void
+CheckBaseDomain(nsIEffectiveTLDService* aService, const char* aHost,
+                const char* aBaseDomain)
+{
+  nsAutoCString baseDomain;
+  nsresult rv = aService->GetBaseDomainFromHost(nsDependentCString(aHost), 0,
+                                                baseDomain);
+  if (!aBaseDomain) {
+    EXPECT_TRUE(NS_FAILED(rv)) << aHost;
+    return;
+  }
+  EXPECT_EQ(rv, NS_OK) << aHost;
+  EXPECT_TRUE(baseDomain.Equals(aBaseDomain)) << aHost << " " << baseDomain.get();
+}
+
+TEST(TestEffectiveTLDService, BaseDomain)
+{
+  nsCOMPtr<nsIEffectiveTLDService> tld =
+    do_GetService(NS_EFFECTIVETLDSERVICE_CONTRACTID);
+  ASSERT_TRUE(tld);
+
+  // Twice, to check the results served from the cache too.
+  for (int i = 0; i < 2; i++) {
+    CheckBaseDomain(tld, "com", nullptr);
+    CheckBaseDomain(tld, "example.com", "example.com");
+    CheckBaseDomain(tld, "b.example.com", "example.com");
+    CheckBaseDomain(tld, "a.b.example.com.", "example.com.");
+    CheckBaseDomain(tld, "www.example.co.uk", "example.co.uk");
+    CheckBaseDomain(tld, "co.uk", nullptr);
+    // Unlisted TLDs use the top level by default.
+    CheckBaseDomain(tld, "a.b.example.unlisted", "example.unlisted");
+    // Wildcard and exception rules (*.ck and !www.ck).
+    CheckBaseDomain(tld, "a.b.ck", "a.b.ck");
+    CheckBaseDomain(tld, "b.ck", nullptr);
+    CheckBaseDomain(tld, "a.www.ck", "www.ck");
+    CheckBaseDomain(tld, "a..example.com", nullptr);
+    CheckBaseDomain(tld, ".example.com", nullptr);
+    CheckBaseDomain(tld, "127.0.0.1", nullptr);
+  }
+
+  nsAutoCString suffix;
+  ASSERT_EQ(tld->GetPublicSuffixFromHost(
+              NS_LITERAL_CSTRING("www.example.co.uk"), suffix), NS_OK);
+  EXPECT_TRUE(suffix.EqualsLiteral("co.uk"));
+
+  nsAutoCString nextSubDomain;
+  ASSERT_EQ(tld->GetNextSubDomain(
+              NS_LITERAL_CSTRING("a.b.example.co.uk"), nextSubDomain), NS_OK);
+  EXPECT_TRUE(nextSubDomain.EqualsLiteral("b.example.co.uk"));
+}
+
+// A mix of host shapes found in top site lists: plain and multi-level public
+// suffixes, deep subdomains, wildcard rules and unlisted TLDs.
+static const char* const kBenchHosts[] = {
+  "www.google.com", "mail.google.com", "www.youtube.com", "www.facebook.com",
+  "www.baidu.com", "en.wikipedia.org", "www.amazon.co.jp", "www.bbc.co.uk",
+  "news.yahoo.co.jp", "www.qq.com", "login.live.com", "www.sina.com.cn",
+  "static.xx.fbcdn.net", "a.b.c.d.cloudfront.net", "www.mercadolivre.com.br",
+  "www.gov.uk", "www.city.kawasaki.jp", "assets.example.github.io",
+  "www.nic.ck", "host.example.internal",
+};
+
+MOZ_GTEST_BENCH(TestEffectiveTLDService, BaseDomainPerf, [] {
+  nsCOMPtr<nsIEffectiveTLDService> tld =
+    do_GetService(NS_EFFECTIVETLDSERVICE_CONTRACTID);
+  ASSERT_TRUE(tld);
+
+  nsAutoCString baseDomain;
+  for (int i = 0; i < 2000; i++) {
+    for (const char* host : kBenchHosts) {
+      // Cache hits.
+      tld->GetBaseDomainFromHost(nsDependentCString(host), 0, baseDomain);
+      // Cache misses.
+      tld->GetBaseDomainFromHost(nsPrintfCString("s%d.%s", i, host), 0,
+                                 baseDomain);
+    }
+  }
+});
@@ -0,0 +1,187 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "gtest/gtest.h"
+#include "gtest/MozGTestBench.h" // For MOZ_GTEST_BENCH
+
+#include "Http2Compression.h"
+#include "mozilla/SyncRunnable.h"
+#include "nsCOMPtr.h"
+#include "nsIEventTarget.h"
+#include "nsNetCID.h"
+#include "nsServiceManagerUtils.h"
+#include "nsString.h"
+#include "nsThreadUtils.h"
+
+using namespace mozilla;
+using namespace mozilla::net;
+
+// The HPACK tables may only be used on the socket thread.
+template<typename Function>
+static void
+RunOnSocketThread(Function&& aFunction)
+{
+  nsCOMPtr<nsIEventTarget> sts =
+    do_GetService(NS_SOCKETTRANSPORTSERVICE_CONTRACTID);
+  ASSERT_TRUE(sts);
+  SyncRunnable::DispatchToThread(
+    sts, NS_NewRunnableFunction("TestHttp2Compression", aFunction));
+}
+
+static nsresult
+Decode(Http2Decompressor& aDecompressor, const uint8_t* aData, uint32_t aLen,
+       nsACString& aOutput)
+{
+  return aDecompressor.DecodeHeaderBlock(aData, aLen, aOutput, true);
+}
+
+TEST(TestHttp2Compression, HuffmanRequest)
+{
+  RunOnSocketThread([] {
+    Http2Decompressor decompressor;
+    nsAutoCString output;
+    nsAutoCString host;
+
+    // RFC 7541, C.4.1
+    static const uint8_t kRequest[] = {
+      0x82, 0x86, 0x84, 0x41, 0x8c, 0xf1, 0xe3, 0xc2, 0xe5, 0xf2, 0x3a, 0x6b,
+      0xa0, 0xab, 0x90, 0xf4, 0xff
+    };
+    EXPECT_EQ(Decode(decompressor, kRequest, sizeof(kRequest), output), NS_OK);
+    decompressor.GetHost(host);
+    EXPECT_TRUE(host.EqualsLiteral("www.example.com")) << host.get();
+
+    // RFC 7541, C.4.2
+    static const uint8_t kRequest2[] = {
+      0x82, 0x86, 0x84, 0xbe, 0x58, 0x86, 0xa8, 0xeb, 0x10, 0x64, 0x9c, 0xbf
+    };
+    EXPECT_EQ(Decode(decompressor, kRequest2, sizeof(kRequest2), output),
+              NS_OK);
+    EXPECT_TRUE(output.EqualsLiteral("cache-control: no-cache\r\n"))
+      << output.get();
+  });
+}
+
+TEST(TestHttp2Compression, HuffmanPadding)
+{
+  RunOnSocketThread([] {
+    nsAutoCString output;
+
+    // "0" followed by three bits of padding that are not all ones.
+    {
+      Http2Decompressor decompressor;
+      static const uint8_t kBadPadding[] = { 0x04, 0x81, 0x00 };
+      EXPECT_NE(Decode(decompressor, kBadPadding, sizeof(kBadPadding), output),
+                NS_OK);
+    }
+
+    // A whole byte of padding.
+    {
+      Http2Decompressor decompressor;
+      static const uint8_t kLongPadding[] = { 0x04, 0x82, 0x07, 0xff };
+      EXPECT_NE(Decode(decompressor, kLongPadding, sizeof(kLongPadding),
+                       output), NS_OK);
+    }
+
+    // "0" followed by a valid padding.
+    {
+      Http2Decompressor decompressor;
+      nsAutoCString path;
+      static const uint8_t kGoodPadding[] = { 0x04, 0x81, 0x07 };
+      EXPECT_EQ(Decode(decompressor, kGoodPadding, sizeof(kGoodPadding),
+                       output), NS_OK);
+      decompressor.GetPath(path);
+      EXPECT_TRUE(path.EqualsLiteral("0")) << path.get();
+    }
+  });
+}
+
+static const char kRequestHeaders[] =
+  "GET /static/js/app.min.js?v=20170915 HTTP/1.1\r\n"
+  "Host: www.example.com\r\n"
+  "User-Agent: Mozilla/5.0 (X11; Linux x86_64; rv:57.0) Gecko/20100101 "
+  "Firefox/57.0\r\n"
+  "Accept: */*\r\n"
+  "Accept-Language: en-US,en;q=0.5\r\n"
+  "Accept-Encoding: gzip, deflate, br\r\n"
+  "Referer: https://www.example.com/articles/2017/09/some-article.html\r\n"
+  "Cookie: session=4f1c83b0a1d2e3f4; prefs=lang%3Den%26theme%3Ddark; "
+  "_ga=GA1.2.1234567890.1505480000\r\n"
+  "\r\n";
+
+static void
+EncodeAndDecode(Http2Compressor& aCompressor, Http2Decompressor& aDecompressor,
+                const nsACString& aPath, nsACString& aDecoded)
+{
+  nsAutoCString encoded;
+  nsresult rv =
+    aCompressor.EncodeHeaderBlock(nsDependentCString(kRequestHeaders),
+                                  NS_LITERAL_CSTRING("GET"), aPath,
+                                  NS_LITERAL_CSTRING("www.example.com"),
+                                  NS_LITERAL_CSTRING("https"), false, encoded);
+  ASSERT_EQ(rv, NS_OK);
+
+  rv = Decode(aDecompressor,
+              reinterpret_cast<const uint8_t*>(encoded.BeginReading()),
+              encoded.Length(), aDecoded);
+  ASSERT_EQ(rv, NS_OK);
+}
+
+TEST(TestHttp2Compression, RoundTrip)
+{
+  RunOnSocketThread([] {
+    Http2Compressor compressor;
+    Http2Decompressor decompressor;
+
+    // Encode the same headers a few times so that both static, dynamic and
+    // literal representations are exercised.
+    for (uint32_t i = 0; i < 3; ++i) {
+      nsAutoCString decoded;
+      nsAutoCString path("/static/js/app.min.js?v=");
+      path.AppendInt(i);
+      EncodeAndDecode(compressor, decompressor, path, decoded);
+
+      nsAutoCString value;
+      decompressor.GetPath(value);
+      EXPECT_TRUE(value.Equals(path)) << value.get();
+      decompressor.GetHost(value);
+      EXPECT_TRUE(value.EqualsLiteral("www.example.com")) << value.get();
+      decompressor.GetMethod(value);
+      EXPECT_TRUE(value.EqualsLiteral("GET")) << value.get();
+
+      EXPECT_NE(decoded.Find("user-agent: Mozilla/5.0 (X11; Linux x86_64; "
+                             "rv:57.0) Gecko/20100101 Firefox/57.0\r\n"),
+                kNotFound) << decoded.get();
+      EXPECT_NE(decoded.Find("referer: https://www.example.com/articles/2017/"
+                             "09/some-article.html\r\n"),
+                kNotFound) << decoded.get();
+      // Cookies are crumbled.
+      EXPECT_NE(decoded.Find("cookie: prefs=lang%3Den%26theme%3Ddark\r\n"),
+                kNotFound) << decoded.get();
+      // Hop-by-hop headers are not sent.
+      EXPECT_EQ(decoded.Find("host: "), kNotFound) << decoded.get();
+    }
+  });
+}
+
+#define COUNT 10000
+
+MOZ_GTEST_BENCH(TestHttp2Compression, RoundTripPerf, [] {
+  RunOnSocketThread([] {
+    Http2Compressor compressor;
+    Http2Decompressor decompressor;
+    nsAutoCString decoded;
+    nsAutoCString path;
+
+    for (int i = COUNT; i; --i) {
+      // A distinct path every time, as for the subresources of a page.
+      path.AssignLiteral("/static/img/sprite-");
+      path.AppendInt(i);
+      path.AppendLiteral(".png");
+      EncodeAndDecode(compressor, decompressor, path, decoded);
+    }
+  });
+});
@@ -175,6 +175,28 @@ TEST(TestStandardURL, From_test_standardurldotjs)
     }
 }
 
+TEST(TestStandardURL, NormalizeHost)
+{
+    nsCOMPtr<nsIURL> url( do_CreateInstance(NS_STANDARDURL_CONTRACTID) );
+    ASSERT_TRUE(url);
+
+    // Simple hosts are only lowercased, the others are unescaped and
+    // normalized as well.
+    const char* specs[] = {"http://WWW.Example.COM/a", "http://www.example.com/a",
+                           "http://my_host-1.example/", "http://my_host-1.example/",
+                           "http://0X7F.1/", "http://127.0.0.1/",
+                           "http://ex%41mple.com/", "http://example.com/",
+                           "http://[::1]:8080/", "http://[::1]:8080/"};
+    nsAutoCString out;
+    for (uint32_t i = 0; i < sizeof(specs)/sizeof(specs[0]); i += 2) {
+        ASSERT_EQ(url->SetSpec(nsDependentCString(specs[i])), NS_OK) << specs[i];
+        ASSERT_EQ(url->GetSpec(out), NS_OK);
+        ASSERT_TRUE(out.Equals(specs[i + 1])) << specs[i] << " -> " << out.get();
+    }
+
+    ASSERT_NE(url->SetSpec(NS_LITERAL_CSTRING("http://ex%20ample.com/")), NS_OK);
+}
+
 #define COUNT 10000
 
 MOZ_GTEST_BENCH(TestStandardURL, Perf, [] {
@@ -6,6 +6,7 @@
 
 #include "mozilla/DebugOnly.h"
 #include "mozilla/Likely.h"
+#include "mozilla/Telemetry.h"
 #include "mozilla/dom/nsCSPService.h"
 #include "mozilla/dom/ScriptLoader.h"
 
@@ -291,6 +292,7 @@ nsHtml5TreeOpExecutor::ContinueInterruptedParsingAsync()
     // Now we set up a repetitive idle scheduler for flushing background list.
     gBackgroundFlushRunner =
       IdleTaskRunner::Create(&BackgroundFlushCallback,
+                             "nsHtml5TreeOpExecutor::BackgroundFlushCallback",
                              250, // The hard deadline: 250ms.
                              nsContentSink::sInteractiveParseTime / 1000, // Required budget.
                              true, // repeating
@@ -320,6 +322,7 @@ class nsHtml5FlushLoopGuard
 {
   private:
     RefPtr<nsHtml5TreeOpExecutor> mExecutor;
+    mozilla::TimeStamp mEntryTime;
     #ifdef DEBUG_NS_HTML5_TREE_OP_EXECUTOR_FLUSH
     uint32_t mStartTime;
     #endif
@@ -332,8 +335,23 @@ class nsHtml5FlushLoopGuard
     {
       mExecutor->mRunFlushLoopOnStack = true;
     }
+
+    // Called when the loop is about to run tree ops, so that runs which find
+    // nothing to do aren't recorded.
+    void NoteFlushing()
+    {
+      if (mEntryTime.IsNull()) {
+        mEntryTime = mozilla::TimeStamp::Now();
+      }
+    }
+
     ~nsHtml5FlushLoopGuard()
     {
+      if (!mEntryTime.IsNull()) {
+        mozilla::Telemetry::AccumulateTimeDelta(
+          mozilla::Telemetry::HTML_PARSER_FLUSH_LOOP_MS, mEntryTime);
+      }
+
       #ifdef DEBUG_NS_HTML5_TREE_OP_EXECUTOR_FLUSH
         uint32_t timeOffTheEventLoop = 
           PR_IntervalToMilliseconds(PR_IntervalNow()) - mStartTime;
@@ -444,6 +462,7 @@ nsHtml5TreeOpExecutor::RunFlushLoop()
       return;
     }
 
+    guard.NoteFlushing();
     mFlushState = eInFlush;
 
     nsIContent* scriptElement = nullptr;
@@ -496,6 +496,9 @@ nsHtml5TreeOperation::CreateSVGElement(
   }
 
   int32_t len = aAttributes->getLength();
+  // SVG attributes all live in the element's own attribute slots, so size
+  // them once instead of growing the buffer for every SetAttr.
+  newContent->ReserveAttrCapacity(len);
   for (int32_t i = 0; i < len; i++) {
     // prefix doesn't need regetting. it is always null or a static atom
     // local name is never null
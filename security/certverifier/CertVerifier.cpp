@@ -15,10 +15,12 @@
 #include "MultiLogCTVerifier.h"
 #include "NSSCertDBTrustDomain.h"
 #include "NSSErrorsService.h"
+#include "VerifiedChainCache.h"
 #include "cert.h"
 #include "mozilla/Assertions.h"
 #include "mozilla/Casting.h"
 #include "mozilla/IntegerPrintfMacros.h"
+#include "mozilla/Unused.h"
 #include "nsNSSComponent.h"
 #include "nsPromiseFlatString.h"
 #include "nsServiceManagerUtils.h"
@@ -105,6 +107,7 @@ CertVerifier::CertVerifier(OcspDownloadConfig odc,
   , mNameMatchingMode(nameMatchingMode)
   , mNetscapeStepUpPolicy(netscapeStepUpPolicy)
   , mCTMode(ctMode)
+  , mVerifiedChainCache(MakeUnique<VerifiedChainCache>())
 {
   LoadKnownCTLogs();
 }
@@ -113,6 +116,12 @@ CertVerifier::~CertVerifier()
 {
 }
 
+void
+CertVerifier::ClearVerifiedChainCache()
+{
+  mVerifiedChainCache->Clear();
+}
+
 Result
 IsCertChainRootBuiltInRoot(const UniqueCERTCertList& chain, bool& result)
 {
@@ -331,9 +340,13 @@ CertVerifier::VerifyCertificateTransparencyPolicy(
   }
 
   CTVerifyResult result;
+  TimeStamp ctVerificationStart(TimeStamp::Now());
   rv = mCTVerifier->Verify(endEntityDER, issuerPublicKeyDER,
                            embeddedSCTs, sctsFromOCSP, sctsFromTLS, time,
                            result);
+  Telemetry::Accumulate(Telemetry::SSL_CT_VERIFICATION_TIME_US,
+    static_cast<uint32_t>(
+      (TimeStamp::Now() - ctVerificationStart).ToMicroseconds()));
   if (rv != Success) {
     MOZ_LOG(gCertVerifierLog, LogLevel::Debug,
             ("SCT verification failed with fatal error %" PRId32 "\n",
@@ -976,6 +989,47 @@ CertVerifier::VerifySSLServerCert(const UniqueCERTCertificate& peerCert,
     return Result::ERROR_BAD_CERT_DOMAIN;
   }
 
+  // The SCT verification results aren't cached, so connections for which
+  // they are wanted are always verified in full.
+  bool useCache = !ctInfo || mCTMode == CertificateTransparencyMode::Disabled;
+  SHA256Buffer cacheKey;
+  if (useCache) {
+    uint8_t requestedResults =
+      (evOidPolicy ? RequestedEVOidPolicy : 0) |
+      (ocspStaplingStatus ? RequestedOCSPStaplingStatus : 0) |
+      (keySizeStatus ? RequestedKeySizeStatus : 0) |
+      (sha1ModeResult ? RequestedSHA1ModeResult : 0) |
+      (pinningTelemetryInfo ? RequestedPinningTelemetryInfo : 0) |
+      (ctInfo ? RequestedCTInfo : 0);
+    useCache = VerifiedChainCache::ComputeKey(peerCert, peerCertChain,
+                                              hostname, flags,
+                                              originAttributes,
+                                              stapledOCSPResponse,
+                                              sctsFromTLS, requestedResults,
+                                              cacheKey) == Success;
+  }
+  TimeDuration verificationTime;
+  if (useCache &&
+      mVerifiedChainCache->Get(cacheKey, time, builtChain, evOidPolicy,
+                               ocspStaplingStatus, keySizeStatus,
+                               sha1ModeResult, verificationTime)) {
+    // The pinning and CT telemetry was accumulated for the verification that
+    // was cached, so don't count it again.
+    if (pinningTelemetryInfo) {
+      pinningTelemetryInfo->Reset();
+    }
+    if (ctInfo) {
+      ctInfo->Reset();
+    }
+    if (saveIntermediatesInPermanentDatabase) {
+      SaveIntermediateCerts(builtChain);
+    }
+    Telemetry::Accumulate(Telemetry::CERT_VERIFICATION_CACHE_SAVED_US,
+      static_cast<uint32_t>(verificationTime.ToMicroseconds()));
+    return Success;
+  }
+  TimeStamp verificationStart(TimeStamp::Now());
+
   // CreateCertErrorRunnable assumes that CheckCertHostname is only called
   // if VerifyCert succeeded.
   Result rv = VerifyCert(peerCert.get(), certificateUsageSSLServer, time,
@@ -1042,6 +1096,15 @@ CertVerifier::VerifySSLServerCert(const UniqueCERTCertificate& peerCert,
     SaveIntermediateCerts(builtChain);
   }
 
+  if (useCache) {
+    // Failing to cache the result only costs the next connection a full
+    // verification.
+    Unused << mVerifiedChainCache->Put(cacheKey, time, builtChain,
+                                       evOidPolicy, ocspStaplingStatus,
+                                       keySizeStatus, sha1ModeResult,
+                                       TimeStamp::Now() - verificationStart);
+  }
+
   return Success;
 }
 
@@ -95,6 +95,7 @@ public:
 };
 
 class NSSCertDBTrustDomain;
+class VerifiedChainCache;
 
 class CertVerifier
 {
@@ -205,6 +206,9 @@ public:
   ~CertVerifier();
 
   void ClearOCSPCache() { mOCSPCache.Clear(); }
+  // Forgets the recent successful TLS server verifications. Must be called
+  // whenever the trust of a certificate changes.
+  void ClearVerifiedChainCache();
 
   const OcspDownloadConfig mOCSPDownloadConfig;
   const bool mOCSPStrict;
@@ -220,6 +224,7 @@ public:
 
 private:
   OCSPCache mOCSPCache;
+  UniquePtr<VerifiedChainCache> mVerifiedChainCache;
 
   // We only have a forward declarations of these classes (see above)
   // so we must allocate dynamically.
@@ -8,8 +8,11 @@
 
 #include "CTObjectsExtractor.h"
 #include "CTSerialization.h"
+#include "ScopedNSSTypes.h"
 #include "mozilla/Assertions.h"
 #include "mozilla/Move.h"
+#include "mozilla/Unused.h"
+#include "pk11pub.h"
 
 namespace mozilla { namespace ct {
 
@@ -28,6 +31,15 @@ StoreVerifiedSct(CTVerifyResult& result,
   return Success;
 }
 
+MultiLogCTVerifier::MultiLogCTVerifier()
+  : mSignatureCacheMutex("MultiLogCTVerifier::mSignatureCacheMutex")
+{
+}
+
+MultiLogCTVerifier::~MultiLogCTVerifier()
+{
+}
+
 Result
 MultiLogCTVerifier::AddLog(CTLogVerifier&& log)
 {
@@ -163,7 +175,7 @@ MultiLogCTVerifier::VerifySingleSCT(SignedCertificateTimestamp&& sct,
                             VerifiedSCT::Status::InvalidSignature);
   }
 
-  Result rv = matchingLog->Verify(expectedEntry, verifiedSct.sct);
+  Result rv = VerifySignature(*matchingLog, expectedEntry, verifiedSct.sct);
   if (rv != Success) {
     if (rv == Result::ERROR_BAD_SIGNATURE) {
       return StoreVerifiedSct(result, Move(verifiedSct),
@@ -198,4 +210,101 @@ MultiLogCTVerifier::VerifySingleSCT(SignedCertificateTimestamp&& sct,
                           VerifiedSCT::Status::Valid);
 }
 
+static SECStatus
+DigestBuffer(UniquePK11Context& context, const Buffer& buffer)
+{
+  // Prefix each buffer with its length so that different fields can't be
+  // shifted into each other.
+  uint8_t length[4];
+  length[0] = buffer.length() & 0xff;
+  length[1] = (buffer.length() >> 8) & 0xff;
+  length[2] = (buffer.length() >> 16) & 0xff;
+  length[3] = (buffer.length() >> 24) & 0xff;
+  SECStatus srv = PK11_DigestOp(context.get(), length, sizeof(length));
+  if (srv != SECSuccess || buffer.empty()) {
+    return srv;
+  }
+  return PK11_DigestOp(context.get(), buffer.begin(), buffer.length());
+}
+
+// Computes the hash identifying the signature verification of |sct| over
+// |entry| with the log whose key ID is |logId|.
+static Result
+SignatureCacheKey(const Buffer& logId, const LogEntry& entry,
+                  const SignedCertificateTimestamp& sct,
+                  uint8_t (&hash)[SHA256_LENGTH])
+{
+  UniquePK11Context context(PK11_CreateDigestContext(SEC_OID_SHA256));
+  if (!context || PK11_DigestBegin(context.get()) != SECSuccess) {
+    return Result::FATAL_ERROR_LIBRARY_FAILURE;
+  }
+  uint8_t fixedFields[9];
+  fixedFields[0] = static_cast<uint8_t>(entry.type);
+  for (size_t i = 0; i < 8; ++i) {
+    fixedFields[1 + i] = (sct.timestamp >> (8 * i)) & 0xff;
+  }
+  if (DigestBuffer(context, logId) != SECSuccess ||
+      PK11_DigestOp(context.get(), fixedFields, sizeof(fixedFields))
+        != SECSuccess ||
+      DigestBuffer(context, entry.leafCertificate) != SECSuccess ||
+      DigestBuffer(context, entry.issuerKeyHash) != SECSuccess ||
+      DigestBuffer(context, entry.tbsCertificate) != SECSuccess ||
+      DigestBuffer(context, sct.extensions) != SECSuccess ||
+      DigestBuffer(context, sct.signature.signatureData) != SECSuccess) {
+    return Result::FATAL_ERROR_LIBRARY_FAILURE;
+  }
+  unsigned int hashLength = 0;
+  if (PK11_DigestFinal(context.get(), hash, &hashLength, SHA256_LENGTH)
+        != SECSuccess || hashLength != SHA256_LENGTH) {
+    return Result::FATAL_ERROR_LIBRARY_FAILURE;
+  }
+  return Success;
+}
+
+Result
+MultiLogCTVerifier::VerifySignature(CTLogVerifier& log,
+                                    const LogEntry& expectedEntry,
+                                    const SignedCertificateTimestamp& sct)
+{
+  uint8_t hash[SHA256_LENGTH];
+  Result rv = SignatureCacheKey(log.keyId(), expectedEntry, sct, hash);
+  if (rv != Success) {
+    // Not being able to use the cache doesn't prevent verification.
+    return log.Verify(expectedEntry, sct);
+  }
+
+  {
+    MutexAutoLock lock(mSignatureCacheMutex);
+    for (size_t i = mSignatureCache.length(); i > 0; --i) {
+      SignatureCacheEntry& entry = mSignatureCache[i - 1];
+      if (memcmp(entry.mHash, hash, SHA256_LENGTH) == 0) {
+        SignatureCacheEntry found = entry;
+        mSignatureCache.erase(&entry);
+        // erase() does not shrink or realloc memory, so the append below
+        // should always succeed.
+        MOZ_RELEASE_ASSERT(mSignatureCache.append(found));
+        return found.mResult;
+      }
+    }
+  }
+
+  // Verify without holding the lock, so that other connections' SCTs can be
+  // verified in the meantime.
+  rv = log.Verify(expectedEntry, sct);
+  if (rv != Success && rv != Result::ERROR_BAD_SIGNATURE) {
+    return rv;
+  }
+
+  MutexAutoLock lock(mSignatureCacheMutex);
+  if (mSignatureCache.length() == MaxSignatureCacheEntries) {
+    mSignatureCache.erase(mSignatureCache.begin());
+  }
+  SignatureCacheEntry newEntry;
+  memcpy(newEntry.mHash, hash, SHA256_LENGTH);
+  newEntry.mResult = rv;
+  // Failing to remember the result only costs another verification.
+  Unused << mSignatureCache.append(newEntry);
+  return rv;
+}
+
 } } // namespace mozilla::ct
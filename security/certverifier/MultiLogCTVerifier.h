@@ -9,6 +9,8 @@
 
 #include "CTLogVerifier.h"
 #include "CTVerifyResult.h"
+#include "hasht.h"
+#include "mozilla/Mutex.h"
 #include "mozilla/Vector.h"
 #include "pkix/Input.h"
 #include "pkix/Result.h"
@@ -19,9 +21,13 @@ namespace mozilla { namespace ct {
 
 // A Certificate Transparency verifier that can verify Signed Certificate
 // Timestamps from multiple logs.
+// Verify() is thread-safe once all the logs have been added.
 class MultiLogCTVerifier
 {
 public:
+  MultiLogCTVerifier();
+  ~MultiLogCTVerifier();
+
   // Adds a new log to the list of known logs to verify against.
   pkix::Result AddLog(CTLogVerifier&& log);
 
@@ -37,8 +43,9 @@ public:
   // DER encoding of |cert|), but it does not stop on SCT decoding errors. See
   // CTVerifyResult for more details.
   //
-  // The internal state of the verifier object is not modified
-  // during the verification process.
+  // Apart from the cache of recent signature verifications, the internal
+  // state of the verifier object is not modified during the verification
+  // process.
   //
   // |cert|  DER-encoded certificate to be validated using the provided SCTs.
   // |sctListFromCert|  SCT list embedded in |cert|, empty if not present.
@@ -78,8 +85,29 @@ private:
                                pkix::Time time,
                                CTVerifyResult& result);
 
+  // Verifies the signature of |sct| over |expectedEntry| with |log|, using
+  // the result of a recent verification of the same signature if there is
+  // one. Most connections to a server see the same SCTs, and the signature
+  // checks are the costly part of SCT verification.
+  pkix::Result VerifySignature(CTLogVerifier& log,
+                               const LogEntry& expectedEntry,
+                               const SignedCertificateTimestamp& sct);
+
   // The list of known logs.
   Vector<CTLogVerifier> mLogs;
+
+  struct SignatureCacheEntry
+  {
+    // SHA-256 over the log key ID, the log entry and the SCT.
+    uint8_t mHash[SHA256_LENGTH];
+    // Success or ERROR_BAD_SIGNATURE.
+    pkix::Result mResult;
+  };
+
+  static const size_t MaxSignatureCacheEntries = 64;
+  Mutex mSignatureCacheMutex;
+  // Sorted with the most-recently-used entry at the end.
+  Vector<SignatureCacheEntry> mSignatureCache;
 };
 
 } } // namespace mozilla::ct
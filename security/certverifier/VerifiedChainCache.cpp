@@ -0,0 +1,368 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "VerifiedChainCache.h"
+
+#include "cert.h"
+#include "mozilla/Casting.h"
+#include "mozilla/Unused.h"
+#include "pk11pub.h"
+#include "pkix/pkixnss.h"
+
+extern mozilla::LazyLogModule gCertVerifierLog;
+
+using namespace mozilla::pkix;
+
+namespace mozilla { namespace psm {
+
+typedef mozilla::pkix::Result Result;
+
+static SECStatus
+DigestKeyLength(UniquePK11Context& context, uint32_t length)
+{
+  // Four bytes, because stapled OCSP responses and certificates can be
+  // larger than the two bytes OCSPCache gets away with.
+  unsigned char array[4];
+  array[0] = length & 255;
+  array[1] = (length >> 8) & 255;
+  array[2] = (length >> 16) & 255;
+  array[3] = (length >> 24) & 255;
+
+  return PK11_DigestOp(context.get(), array, MOZ_ARRAY_LENGTH(array));
+}
+
+// Digests the length of the given bytes followed by the bytes, so that no two
+// different sequences of items digest the same string of bytes.
+static SECStatus
+DigestKeyItem(UniquePK11Context& context, const unsigned char* data,
+           uint32_t length)
+{
+  SECStatus rv = DigestKeyLength(context, length);
+  if (rv != SECSuccess) {
+    return rv;
+  }
+  if (length == 0) {
+    return SECSuccess;
+  }
+  return PK11_DigestOp(context.get(), data, length);
+}
+
+static SECStatus
+DigestKeyItem(UniquePK11Context& context, const SECItem* item)
+{
+  if (!item) {
+    return DigestKeyItem(context, nullptr, 0);
+  }
+  return DigestKeyItem(context, item->data, item->len);
+}
+
+static SECStatus
+DigestKeyItem(UniquePK11Context& context, const nsACString& string)
+{
+  return DigestKeyItem(context,
+                    BitwiseCast<const unsigned char*>(string.BeginReading()),
+                    string.Length());
+}
+
+// The key is SHA256 over the length-prefixed DER of the peer certificate, the
+// number of certificates in the peer's chain followed by the length-prefixed
+// DER of each of them, and the length-prefixed hostname, flags, first party
+// domain, stapled OCSP response, SCTs and requested results. Since every item
+// is prefixed with its length, distinct verifications can't produce the same
+// string of bytes, so it is computationally infeasible to find collisions that
+// would subvert this cache.
+/* static */ Result
+VerifiedChainCache::ComputeKey(const UniqueCERTCertificate& aPeerCert,
+                               const UniqueCERTCertList* aPeerCertChain,
+                               const nsACString& aHostname,
+                               CertVerifier::Flags aFlags,
+                               const OriginAttributes& aOriginAttributes,
+                               const SECItem* aStapledOCSPResponse,
+                               const SECItem* aSCTsFromTLS,
+                               uint8_t aRequestedResults,
+                       /*out*/ SHA256Buffer& aKey)
+{
+  UniquePK11Context context(PK11_CreateDigestContext(SEC_OID_SHA256));
+  if (!context) {
+    return MapPRErrorCodeToResult(PR_GetError());
+  }
+  SECStatus rv = PK11_DigestBegin(context.get());
+  if (rv != SECSuccess) {
+    return MapPRErrorCodeToResult(PR_GetError());
+  }
+
+  rv = DigestKeyItem(context, &aPeerCert->derCert);
+  if (rv != SECSuccess) {
+    return MapPRErrorCodeToResult(PR_GetError());
+  }
+
+  uint32_t chainLength = 0;
+  if (aPeerCertChain && *aPeerCertChain) {
+    const UniqueCERTCertList& chain = *aPeerCertChain;
+    for (CERTCertListNode* node = CERT_LIST_HEAD(chain);
+         !CERT_LIST_END(node, chain); node = CERT_LIST_NEXT(node)) {
+      ++chainLength;
+    }
+  }
+  rv = DigestKeyLength(context, chainLength);
+  if (rv != SECSuccess) {
+    return MapPRErrorCodeToResult(PR_GetError());
+  }
+  if (chainLength > 0) {
+    const UniqueCERTCertList& chain = *aPeerCertChain;
+    for (CERTCertListNode* node = CERT_LIST_HEAD(chain);
+         !CERT_LIST_END(node, chain); node = CERT_LIST_NEXT(node)) {
+      rv = DigestKeyItem(context, &node->cert->derCert);
+      if (rv != SECSuccess) {
+        return MapPRErrorCodeToResult(PR_GetError());
+      }
+    }
+  }
+
+  rv = DigestKeyItem(context, aHostname);
+  if (rv != SECSuccess) {
+    return MapPRErrorCodeToResult(PR_GetError());
+  }
+  rv = DigestKeyLength(context, aFlags);
+  if (rv != SECSuccess) {
+    return MapPRErrorCodeToResult(PR_GetError());
+  }
+  // As with OCSP, only first party isolation affects the result.
+  NS_ConvertUTF16toUTF8 firstPartyDomain(aOriginAttributes.mFirstPartyDomain);
+  rv = DigestKeyItem(context, firstPartyDomain);
+  if (rv != SECSuccess) {
+    return MapPRErrorCodeToResult(PR_GetError());
+  }
+  rv = DigestKeyItem(context, aStapledOCSPResponse);
+  if (rv != SECSuccess) {
+    return MapPRErrorCodeToResult(PR_GetError());
+  }
+  rv = DigestKeyItem(context, aSCTsFromTLS);
+  if (rv != SECSuccess) {
+    return MapPRErrorCodeToResult(PR_GetError());
+  }
+  rv = DigestKeyLength(context, aRequestedResults);
+  if (rv != SECSuccess) {
+    return MapPRErrorCodeToResult(PR_GetError());
+  }
+
+  uint32_t outLen = 0;
+  rv = PK11_DigestFinal(context.get(), aKey, &outLen, SHA256_LENGTH);
+  if (rv != SECSuccess || outLen != SHA256_LENGTH) {
+    return Result::FATAL_ERROR_LIBRARY_FAILURE;
+  }
+  return Success;
+}
+
+// Returns a new list holding references to the certificates of aList, or
+// nullptr on failure.
+static UniqueCERTCertList
+CopyCertList(const UniqueCERTCertList& aList)
+{
+  UniqueCERTCertList copy(CERT_NewCertList());
+  if (!copy) {
+    return nullptr;
+  }
+  for (CERTCertListNode* node = CERT_LIST_HEAD(aList);
+       !CERT_LIST_END(node, aList); node = CERT_LIST_NEXT(node)) {
+    UniqueCERTCertificate cert(CERT_DupCertificate(node->cert));
+    if (!cert || CERT_AddCertToListTail(copy.get(), cert.get()) != SECSuccess) {
+      return nullptr;
+    }
+    Unused << cert.release(); // cert is now owned by copy
+  }
+  return copy;
+}
+
+VerifiedChainCache::VerifiedChainCache()
+  : mMutex("VerifiedChainCache-mutex")
+{
+}
+
+VerifiedChainCache::~VerifiedChainCache()
+{
+  Clear();
+}
+
+// Returns false with index in an undefined state if no matching entry was
+// found.
+bool
+VerifiedChainCache::FindInternal(const SHA256Buffer& aKey,
+                                 /*out*/ size_t& index,
+                                 const MutexAutoLock& /* aProofOfLock */)
+{
+  // mEntries is sorted with the most-recently-used entry at the end.
+  // Thus, searching from the end will often be fastest.
+  index = mEntries.length();
+  while (index > 0) {
+    --index;
+    if (memcmp(mEntries[index]->mKey, aKey, SHA256_LENGTH) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void
+VerifiedChainCache::MakeMostRecentlyUsed(size_t aIndex,
+                                         const MutexAutoLock& /* aProofOfLock */)
+{
+  Entry* entry = mEntries[aIndex];
+  mEntries.erase(mEntries.begin() + aIndex);
+  // erase() does not shrink or realloc memory, so the append below should
+  // always succeed.
+  MOZ_RELEASE_ASSERT(mEntries.append(entry));
+}
+
+bool
+VerifiedChainCache::Get(const SHA256Buffer& aKey, Time aTime,
+                /*out*/ UniqueCERTCertList& aBuiltChain,
+       /*optional out*/ SECOidTag* aEVOidPolicy,
+       /*optional out*/ CertVerifier::OCSPStaplingStatus* aOCSPStaplingStatus,
+       /*optional out*/ KeySizeStatus* aKeySizeStatus,
+       /*optional out*/ SHA1ModeResult* aSHA1ModeResult,
+                /*out*/ TimeDuration& aVerificationTime)
+{
+  MutexAutoLock lock(mMutex);
+
+  size_t index;
+  if (!FindInternal(aKey, index, lock)) {
+    MOZ_LOG(gCertVerifierLog, LogLevel::Debug,
+            ("VerifiedChainCache::Get: not in cache"));
+    return false;
+  }
+  Entry* entry = mEntries[index];
+  // A clock going backwards mustn't extend the life of an entry either.
+  if (aTime < entry->mVerifiedAt || aTime > entry->mValidThrough) {
+    MOZ_LOG(gCertVerifierLog, LogLevel::Debug,
+            ("VerifiedChainCache::Get: in cache but stale - evicting"));
+    delete entry;
+    mEntries.erase(mEntries.begin() + index);
+    return false;
+  }
+
+  UniqueCERTCertList builtChain(CopyCertList(entry->mBuiltChain));
+  if (!builtChain) {
+    return false;
+  }
+  MOZ_LOG(gCertVerifierLog, LogLevel::Debug,
+          ("VerifiedChainCache::Get: in cache"));
+  aBuiltChain = Move(builtChain);
+  if (aEVOidPolicy) {
+    *aEVOidPolicy = entry->mEVOidPolicy;
+  }
+  if (aOCSPStaplingStatus) {
+    *aOCSPStaplingStatus = entry->mOCSPStaplingStatus;
+  }
+  if (aKeySizeStatus) {
+    *aKeySizeStatus = entry->mKeySizeStatus;
+  }
+  if (aSHA1ModeResult) {
+    *aSHA1ModeResult = entry->mSHA1ModeResult;
+  }
+  aVerificationTime = entry->mVerificationTime;
+  MakeMostRecentlyUsed(index, lock);
+  return true;
+}
+
+Result
+VerifiedChainCache::Put(const SHA256Buffer& aKey, Time aTime,
+                        const UniqueCERTCertList& aBuiltChain,
+                        const SECOidTag* aEVOidPolicy,
+                        const CertVerifier::OCSPStaplingStatus* aOCSPStaplingStatus,
+                        const KeySizeStatus* aKeySizeStatus,
+                        const SHA1ModeResult* aSHA1ModeResult,
+                        TimeDuration aVerificationTime)
+{
+  if (!aBuiltChain) {
+    return Result::FATAL_ERROR_INVALID_ARGS;
+  }
+
+  Time validThrough(aTime);
+  Result rv = validThrough.AddSeconds(MaxLifetimeSeconds);
+  if (rv != Success) {
+    return rv;
+  }
+  // Never trust the result past the expiry of any certificate in the chain.
+  for (CERTCertListNode* node = CERT_LIST_HEAD(aBuiltChain);
+       !CERT_LIST_END(node, aBuiltChain); node = CERT_LIST_NEXT(node)) {
+    PRTime notBefore;
+    PRTime notAfter;
+    if (CERT_GetCertTimes(node->cert, &notBefore, &notAfter) != SECSuccess ||
+        notAfter < 0) {
+      return Result::ERROR_BAD_DER;
+    }
+    Time certNotAfter(TimeFromEpochInSeconds(
+                        static_cast<uint64_t>(notAfter / PR_USEC_PER_SEC)));
+    if (certNotAfter < validThrough) {
+      validThrough = certNotAfter;
+    }
+  }
+  if (validThrough < aTime) {
+    return Success;
+  }
+
+  UniqueCERTCertList builtChain(CopyCertList(aBuiltChain));
+  if (!builtChain) {
+    return Result::FATAL_ERROR_NO_MEMORY;
+  }
+
+  MutexAutoLock lock(mMutex);
+
+  size_t index;
+  if (FindInternal(aKey, index, lock)) {
+    MOZ_LOG(gCertVerifierLog, LogLevel::Debug,
+            ("VerifiedChainCache::Put: already in cache - replacing"));
+    delete mEntries[index];
+    mEntries.erase(mEntries.begin() + index);
+  } else if (mEntries.length() == MaxEntries) {
+    MOZ_LOG(gCertVerifierLog, LogLevel::Debug,
+            ("VerifiedChainCache::Put: too full - evicting an entry"));
+    delete mEntries[0];
+    mEntries.erase(mEntries.begin());
+  }
+
+  Entry* newEntry = new (std::nothrow) Entry(aTime, validThrough,
+                                             Move(builtChain));
+  if (!newEntry) {
+    return Result::FATAL_ERROR_NO_MEMORY;
+  }
+  if (aEVOidPolicy) {
+    newEntry->mEVOidPolicy = *aEVOidPolicy;
+  }
+  if (aOCSPStaplingStatus) {
+    newEntry->mOCSPStaplingStatus = *aOCSPStaplingStatus;
+  }
+  if (aKeySizeStatus) {
+    newEntry->mKeySizeStatus = *aKeySizeStatus;
+  }
+  if (aSHA1ModeResult) {
+    newEntry->mSHA1ModeResult = *aSHA1ModeResult;
+  }
+  newEntry->mVerificationTime = aVerificationTime;
+  memcpy(newEntry->mKey, aKey, SHA256_LENGTH);
+  if (!mEntries.append(newEntry)) {
+    delete newEntry;
+    return Result::FATAL_ERROR_NO_MEMORY;
+  }
+  MOZ_LOG(gCertVerifierLog, LogLevel::Debug,
+          ("VerifiedChainCache::Put: added to cache"));
+  return Success;
+}
+
+void
+VerifiedChainCache::Clear()
+{
+  MutexAutoLock lock(mMutex);
+  MOZ_LOG(gCertVerifierLog, LogLevel::Debug,
+          ("VerifiedChainCache::Clear: clearing cache"));
+  for (Entry** entry = mEntries.begin(); entry < mEntries.end(); entry++) {
+    delete *entry;
+  }
+  mEntries.clearAndFree();
+}
+
+} } // namespace mozilla::psm
@@ -0,0 +1,139 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef mozilla_psm_VerifiedChainCache_h
+#define mozilla_psm_VerifiedChainCache_h
+
+#include "CertVerifier.h"
+#include "hasht.h"
+#include "mozilla/Mutex.h"
+#include "mozilla/TimeStamp.h"
+#include "mozilla/Vector.h"
+#include "pkix/Result.h"
+#include "pkix/Time.h"
+#include "ScopedNSSTypes.h"
+
+namespace mozilla { namespace psm {
+
+// make SHA256Buffer be of type "array of uint8_t of length SHA256_LENGTH"
+typedef uint8_t SHA256Buffer[SHA256_LENGTH];
+
+// VerifiedChainCache remembers successful TLS server certificate
+// verifications for a short while, so that many connections to the same host
+// in quick succession don't each build and verify the same chain again.
+// Each result is keyed on everything the verification depended on: the
+// certificates sent by the peer, the hostname, the verification flags, the
+// first party domain, the stapled OCSP response, the SCTs from the TLS
+// handshake and which of the optional results the caller asked for.
+// Results are trusted for at most MaxLifetimeSeconds, and never past the
+// expiry of any certificate in the built chain. A maximum of 256 distinct
+// entries can be stored.
+// Policy changes replace the CertVerifier, and this cache with it; changes to
+// certificate trust must call Clear().
+// VerifiedChainCache is thread-safe.
+class VerifiedChainCache
+{
+public:
+  VerifiedChainCache();
+  ~VerifiedChainCache();
+
+  static const uint64_t MaxLifetimeSeconds = 60;
+
+  // Computes the key under which a verification with the given parameters is
+  // cached. Returns an error if the parameters can't be hashed, in which case
+  // the verification shouldn't be cached.
+  static mozilla::pkix::Result ComputeKey(
+                    const UniqueCERTCertificate& aPeerCert,
+                    const UniqueCERTCertList* aPeerCertChain,
+                    const nsACString& aHostname,
+                    CertVerifier::Flags aFlags,
+                    const OriginAttributes& aOriginAttributes,
+                    const SECItem* aStapledOCSPResponse,
+                    const SECItem* aSCTsFromTLS,
+                    uint8_t aRequestedResults,
+            /*out*/ SHA256Buffer& aKey);
+
+  // Returns true if a verification with the given key succeeded recently
+  // enough to still be trusted at the given time. If so, returns by reference
+  // a copy of the chain that was built, the optional results of the
+  // verification (for those that aren't null) and how long it took.
+  bool Get(const SHA256Buffer& aKey,
+           mozilla::pkix::Time aTime,
+   /*out*/ UniqueCERTCertList& aBuiltChain,
+   /*optional out*/ SECOidTag* aEVOidPolicy,
+   /*optional out*/ CertVerifier::OCSPStaplingStatus* aOCSPStaplingStatus,
+   /*optional out*/ KeySizeStatus* aKeySizeStatus,
+   /*optional out*/ SHA1ModeResult* aSHA1ModeResult,
+   /*out*/ TimeDuration& aVerificationTime);
+
+  // Caches the successful verification with the given key, done at the given
+  // time. The optional results that are null are cached as never checked.
+  mozilla::pkix::Result Put(const SHA256Buffer& aKey,
+                            mozilla::pkix::Time aTime,
+                            const UniqueCERTCertList& aBuiltChain,
+                            const SECOidTag* aEVOidPolicy,
+              const CertVerifier::OCSPStaplingStatus* aOCSPStaplingStatus,
+                            const KeySizeStatus* aKeySizeStatus,
+                            const SHA1ModeResult* aSHA1ModeResult,
+                            TimeDuration aVerificationTime);
+
+  // Removes everything from the cache.
+  void Clear();
+
+private:
+  class Entry
+  {
+  public:
+    Entry(mozilla::pkix::Time aVerifiedAt,
+          mozilla::pkix::Time aValidThrough,
+          UniqueCERTCertList aBuiltChain)
+      : mVerifiedAt(aVerifiedAt)
+      , mValidThrough(aValidThrough)
+      , mBuiltChain(Move(aBuiltChain))
+      , mEVOidPolicy(SEC_OID_UNKNOWN)
+      , mOCSPStaplingStatus(CertVerifier::OCSP_STAPLING_NEVER_CHECKED)
+      , mKeySizeStatus(KeySizeStatus::NeverChecked)
+      , mSHA1ModeResult(SHA1ModeResult::NeverChecked)
+    {
+    }
+
+    mozilla::pkix::Time mVerifiedAt;
+    mozilla::pkix::Time mValidThrough;
+    UniqueCERTCertList mBuiltChain;
+    SECOidTag mEVOidPolicy;
+    CertVerifier::OCSPStaplingStatus mOCSPStaplingStatus;
+    KeySizeStatus mKeySizeStatus;
+    SHA1ModeResult mSHA1ModeResult;
+    TimeDuration mVerificationTime;
+    // See the documentation for VerifiedChainCache::ComputeKey.
+    SHA256Buffer mKey;
+  };
+
+  bool FindInternal(const SHA256Buffer& aKey, /*out*/ size_t& index,
+                    const MutexAutoLock& aProofOfLock);
+  void MakeMostRecentlyUsed(size_t aIndex, const MutexAutoLock& aProofOfLock);
+
+  Mutex mMutex;
+  static const size_t MaxEntries = 256;
+  // Sorted with the most-recently-used entry at the end.
+  Vector<Entry*, 16> mEntries;
+};
+
+// Bits of the aRequestedResults argument of VerifiedChainCache::ComputeKey(),
+// saying which of the optional results of VerifySSLServerCert the caller
+// asked for. (Some of them, like EV status, are only checked when asked for.)
+enum VerifiedChainCacheRequestedResult : uint8_t {
+  RequestedEVOidPolicy = 1 << 0,
+  RequestedOCSPStaplingStatus = 1 << 1,
+  RequestedKeySizeStatus = 1 << 2,
+  RequestedSHA1ModeResult = 1 << 3,
+  RequestedPinningTelemetryInfo = 1 << 4,
+  RequestedCTInfo = 1 << 5,
+};
+
+} } // namespace mozilla::psm
+
+#endif // mozilla_psm_VerifiedChainCache_h
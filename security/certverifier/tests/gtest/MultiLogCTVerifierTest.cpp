@@ -190,6 +190,35 @@ TEST_F(MultiLogCTVerifierTest, VerifiesSCTFromTLS)
   CheckForSingleValidSCTInResult(result, VerifiedSCT::Origin::TLSExtension);
 }
 
+TEST_F(MultiLogCTVerifierTest, CachesSignatureVerificationPerCertificate)
+{
+  Buffer sct(GetTestSignedCertificateTimestamp());
+  Buffer sctList;
+  EncodeSCTListForTesting(InputForBuffer(sct), sctList);
+
+  // The second verification uses the cached signature check.
+  for (int i = 0; i < 2; ++i) {
+    CTVerifyResult result;
+    ASSERT_EQ(Success,
+              mVerifier.Verify(InputForBuffer(mTestCert), Input(),
+                               Input(), Input(), InputForBuffer(sctList),
+                               mNow, result));
+    CheckForSingleValidSCTInResult(result, VerifiedSCT::Origin::TLSExtension);
+  }
+
+  // The same SCT presented with another certificate must not hit the cache.
+  Buffer otherCert(mTestCert);
+  otherCert[otherCert.length() - 1] ^= '\xFF';
+  CTVerifyResult result;
+  ASSERT_EQ(Success,
+            mVerifier.Verify(InputForBuffer(otherCert), Input(),
+                             Input(), Input(), InputForBuffer(sctList),
+                             mNow, result));
+  ASSERT_EQ(1U, result.verifiedScts.length());
+  EXPECT_EQ(VerifiedSCT::Status::InvalidSignature,
+            result.verifiedScts[0].status);
+}
+
 TEST_F(MultiLogCTVerifierTest, VerifiesSCTFromMultipleSources)
 {
   Buffer sct(GetTestSignedCertificateTimestamp());
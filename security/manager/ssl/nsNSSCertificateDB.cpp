@@ -266,6 +266,16 @@ ChangeCertTrustWithPossibleAuthentication(const UniqueCERTCertificate& cert,
   return CERT_ChangeCertTrust(nullptr, cert.get(), &trust);
 }
 
+// Recent TLS server verifications may depend on trust that just changed.
+static void
+ClearVerifiedChainCache()
+{
+  RefPtr<SharedCertVerifier> certVerifier(GetDefaultCertVerifier());
+  if (certVerifier) {
+    certVerifier->ClearVerifiedChainCache();
+  }
+}
+
 nsresult
 nsNSSCertificateDB::handleCACertDownload(NotNull<nsIArray*> x509Certs,
                                          nsIInterfaceRequestor *ctx,
@@ -835,6 +845,7 @@ nsNSSCertificateDB::DeleteCertificate(nsIX509Cert *aCert)
     srv = ChangeCertTrustWithPossibleAuthentication(cert, trust.GetTrust(),
                                                     nullptr);
   }
+  ClearVerifiedChainCache();
   MOZ_LOG(gPIPNSSLog, LogLevel::Debug, ("cert deleted: %d", srv));
   return (srv) ? NS_ERROR_FAILURE : NS_OK;
 }
@@ -881,6 +892,7 @@ nsNSSCertificateDB::SetCertTrust(nsIX509Cert *cert,
   SECStatus srv = ChangeCertTrustWithPossibleAuthentication(nsscert,
                                                             trust.GetTrust(),
                                                             nullptr);
+  ClearVerifiedChainCache();
   return MapSECStatus(srv);
 }
 
@@ -1374,6 +1386,7 @@ nsNSSCertificateDB::SetCertTrustFromString(nsIX509Cert* cert,
   }
 
   srv = ChangeCertTrustWithPossibleAuthentication(nssCert, trust, nullptr);
+  ClearVerifiedChainCache();
   return MapSECStatus(srv);
 }
 
@@ -1621,5 +1634,7 @@ nsNSSCertificateDB::ClearOCSPCache()
   RefPtr<SharedCertVerifier> certVerifier(GetDefaultCertVerifier());
   NS_ENSURE_TRUE(certVerifier, NS_ERROR_FAILURE);
   certVerifier->ClearOCSPCache();
+  // Cached verifications may rest on the OCSP responses just forgotten.
+  certVerifier->ClearVerifiedChainCache();
   return NS_OK;
 }
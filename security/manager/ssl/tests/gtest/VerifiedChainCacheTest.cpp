@@ -0,0 +1,133 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <string.h>
+
+#include "CertVerifier.h"
+#include "VerifiedChainCache.h"
+#include "gtest/gtest.h"
+#include "nss.h"
+#include "pkix/pkixtypes.h"
+
+using namespace mozilla::pkix;
+using namespace mozilla::psm;
+
+using mozilla::TimeDuration;
+
+class psm_VerifiedChainCacheTest : public ::testing::Test
+{
+protected:
+  psm_VerifiedChainCacheTest() : now(Now()) { }
+
+  static void SetUpTestCase()
+  {
+    NSS_NoDB_Init(nullptr);
+  }
+
+  // Caches a verification with the given key at the given time. The chain
+  // is empty, so only the lifetime of the cache bounds the entry.
+  void Put(uint8_t aKeyByte, Time aTime,
+           SECOidTag aEVOidPolicy = SEC_OID_UNKNOWN)
+  {
+    SHA256Buffer key;
+    memset(key, aKeyByte, sizeof(key));
+    UniqueCERTCertList chain(CERT_NewCertList());
+    ASSERT_TRUE(chain);
+    ASSERT_EQ(Success, cache.Put(key, aTime, chain, &aEVOidPolicy, nullptr,
+                                 nullptr, nullptr,
+                                 TimeDuration::FromMilliseconds(25)));
+  }
+
+  bool Get(uint8_t aKeyByte, Time aTime,
+           SECOidTag* aEVOidPolicy = nullptr,
+           CertVerifier::OCSPStaplingStatus* aOCSPStaplingStatus = nullptr)
+  {
+    SHA256Buffer key;
+    memset(key, aKeyByte, sizeof(key));
+    UniqueCERTCertList chain;
+    TimeDuration verificationTime;
+    if (!cache.Get(key, aTime, chain, aEVOidPolicy, aOCSPStaplingStatus,
+                   nullptr, nullptr, verificationTime)) {
+      return false;
+    }
+    EXPECT_TRUE(chain);
+    EXPECT_EQ(TimeDuration::FromMilliseconds(25), verificationTime);
+    return true;
+  }
+
+  const Time now;
+  VerifiedChainCache cache;
+};
+
+TEST_F(psm_VerifiedChainCacheTest, TestPutAndGet)
+{
+  Put(1, now, SEC_OID_X509_ANY_POLICY);
+  ASSERT_FALSE(Get(2, now));
+
+  SECOidTag evOidPolicy = SEC_OID_UNKNOWN;
+  CertVerifier::OCSPStaplingStatus ocspStaplingStatus =
+    CertVerifier::OCSP_STAPLING_GOOD;
+  ASSERT_TRUE(Get(1, now, &evOidPolicy, &ocspStaplingStatus));
+  ASSERT_EQ(SEC_OID_X509_ANY_POLICY, evOidPolicy);
+  // Results not cached are reported as never checked.
+  ASSERT_EQ(CertVerifier::OCSP_STAPLING_NEVER_CHECKED, ocspStaplingStatus);
+}
+
+TEST_F(psm_VerifiedChainCacheTest, TestExpiry)
+{
+  Put(1, now);
+
+  Time later(now);
+  ASSERT_EQ(Success,
+            later.AddSeconds(VerifiedChainCache::MaxLifetimeSeconds));
+  ASSERT_TRUE(Get(1, later));
+
+  ASSERT_EQ(Success, later.AddSeconds(1));
+  ASSERT_FALSE(Get(1, later));
+  // Stale entries are evicted.
+  ASSERT_FALSE(Get(1, now));
+}
+
+TEST_F(psm_VerifiedChainCacheTest, TestTimeBeforeVerification)
+{
+  Put(1, now);
+
+  Time earlier(now);
+  ASSERT_EQ(Success, earlier.SubtractSeconds(1));
+  ASSERT_FALSE(Get(1, earlier));
+}
+
+TEST_F(psm_VerifiedChainCacheTest, TestEvictLeastRecentlyUsed)
+{
+  for (int i = 0; i < 256; i++) {
+    Put(static_cast<uint8_t>(i), now);
+  }
+  // Using entry 0 and replacing entry 1 make them the most recently used, so
+  // a new entry evicts entry 2.
+  ASSERT_TRUE(Get(0, now));
+  Put(1, now);
+
+  SHA256Buffer key;
+  memset(key, 0, sizeof(key));
+  key[0] = 1;
+  UniqueCERTCertList chain(CERT_NewCertList());
+  ASSERT_TRUE(chain);
+  ASSERT_EQ(Success, cache.Put(key, now, chain, nullptr, nullptr, nullptr,
+                               nullptr, TimeDuration::FromMilliseconds(25)));
+  ASSERT_TRUE(Get(0, now));
+  ASSERT_TRUE(Get(1, now));
+  ASSERT_FALSE(Get(2, now));
+  ASSERT_TRUE(Get(3, now));
+}
+
+TEST_F(psm_VerifiedChainCacheTest, TestClear)
+{
+  Put(1, now);
+  Put(2, now);
+  cache.Clear();
+  ASSERT_FALSE(Get(1, now));
+  ASSERT_FALSE(Get(2, now));
+}
@@ -386,7 +386,11 @@ CacheCloseHelper(const nsACString& key, const CacheEntry* data,
   NS_ASSERTION(NS_SUCCEEDED(rv) && hasEntry == false,
                "Existing entry in disk StartupCache.");
 #endif
-  rv = writer->AddEntryStream(key, holder->time, true, stream, false);
+  // Store the entries uncompressed: the archive is mapped when it is read, so
+  // reading an entry is then a copy out of the mapping rather than an inflate,
+  // and only the pages of the entries actually used at startup are touched.
+  rv = writer->AddEntryStream(key, holder->time,
+                              nsIZipWriter::COMPRESSION_NONE, stream, false);
 
   if (NS_FAILED(rv)) {
     NS_WARNING("cache entry deleted but not written to disk.");
@@ -4,6 +4,8 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
 
+#include <algorithm>
+
 #include "nsAutoPtr.h"
 
 #include "sqlite3.h"
@@ -35,9 +37,14 @@ namespace storage {
  * consumers are trying to avoid blocking their execution thread for long
  * periods of time, and dispatching many small events to the calling thread will
  * end up blocking it.
+ * MAX_ROWS_PER_RESULT only bounds the first result set: a consumer still
+ * receiving rows after that is reading a large query, and handles bigger sets
+ * just as well with fewer dispatches, so the limit doubles with each set sent
+ * up to MAX_ROWS_PER_RESULT_LIMIT.
  */
 #define MAX_MILLISECONDS_BETWEEN_RESULTS 75
 #define MAX_ROWS_PER_RESULT 15
+#define MAX_ROWS_PER_RESULT_LIMIT 240
 
 ////////////////////////////////////////////////////////////////////////////////
 //// AsyncExecuteStatements
@@ -87,6 +94,7 @@ AsyncExecuteStatements::AsyncExecuteStatements(StatementDataArray &aStatements,
 , mCallback(aCallback)
 , mCallingThread(::do_GetCurrentThread())
 , mMaxWait(TimeDuration::FromMilliseconds(MAX_MILLISECONDS_BETWEEN_RESULTS))
+, mMaxRowsPerResult(MAX_ROWS_PER_RESULT)
 , mIntervalStart(TimeStamp::Now())
 , mState(PENDING)
 , mCancelRequested(false)
@@ -300,7 +308,7 @@ AsyncExecuteStatements::buildAndNotifyResults(sqlite3_stmt *aStatement)
   // calling thread about it.
   TimeStamp now = TimeStamp::Now();
   TimeDuration delta = now - mIntervalStart;
-  if (mResultSet->rows() >= MAX_ROWS_PER_RESULT || delta > mMaxWait) {
+  if (mResultSet->rows() >= mMaxRowsPerResult || delta > mMaxWait) {
     // Notify the caller
     rv = notifyResults();
     if (NS_FAILED(rv))
@@ -308,6 +316,8 @@ AsyncExecuteStatements::buildAndNotifyResults(sqlite3_stmt *aStatement)
 
     // Reset our start time
     mIntervalStart = now;
+    mMaxRowsPerResult = std::min<uint32_t>(mMaxRowsPerResult * 2,
+                                           MAX_ROWS_PER_RESULT_LIMIT);
   }
 
   return NS_OK;
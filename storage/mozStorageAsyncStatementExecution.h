@@ -207,6 +207,14 @@ private:
    */
   const TimeDuration mMaxWait;
 
+  /**
+   * The number of rows after which the current result set is sent to the
+   * calling thread.  Starts at MAX_ROWS_PER_RESULT so that the first rows
+   * arrive quickly, and doubles with each result set sent, up to
+   * MAX_ROWS_PER_RESULT_LIMIT, so that large queries need fewer events.
+   */
+  uint32_t mMaxRowsPerResult;
+
   /**
    * The start time since our last set of results.
    */
@@ -5,16 +5,75 @@
 
 #include "MozGTestBench.h"
 #include "mozilla/TimeStamp.h"
+#include <algorithm>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string>
 #include <vector>
+#ifdef XP_LINUX
+#include <sched.h>
+#endif
 
 #define MOZ_GTEST_BENCH_FRAMEWORK "platform_microbench"
 #define MOZ_GTEST_NUM_ITERATIONS 5
+#define MOZ_GTEST_NUM_WARMUP_ITERATIONS 1
 
 using mozilla::TimeStamp;
 
 namespace mozilla {
+
+#ifndef DEBUG
+// Returns the value of an environment variable as a non-negative int, or
+// aDefault if it isn't set or isn't a number.
+static int
+GetEnvInt(const char* aName, int aDefault)
+{
+  const char* value = getenv(aName);
+  if (!value || !*value) {
+    return aDefault;
+  }
+  char* end;
+  long result = strtol(value, &end, 10);
+  if (*end || result < 0 || result > 10000) {
+    return aDefault;
+  }
+  return int(result);
+}
+
+// Pins the process to the CPU given by MOZ_GTEST_BENCH_CPU, once, so that
+// results aren't skewed by the scheduler moving the test between cores.
+static void
+MaybePinToCPU()
+{
+#ifdef XP_LINUX
+  static bool sPinned = false;
+  if (sPinned) {
+    return;
+  }
+  sPinned = true;
+
+  int cpu = GetEnvInt("MOZ_GTEST_BENCH_CPU", -1);
+  if (cpu < 0 || cpu >= CPU_SETSIZE) {
+    return;
+  }
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+    fprintf(stderr, "MozGTestBench: failed to pin to CPU %d\n", cpu);
+  }
+#endif
+}
+
+// Nearest-rank percentile of aSorted, which must not be empty.
+static int
+Percentile(const std::vector<int>& aSorted, int aPercent)
+{
+  size_t rank = (aSorted.size() * aPercent + 99) / 100;
+  return aSorted[rank ? rank - 1 : 0];
+}
+#endif
+
 void GTestBench(const char* aSuite, const char* aName,
                 const std::function<void()>& aTest)
 {
@@ -24,9 +83,21 @@ void GTestBench(const char* aSuite, const char* aName,
   aTest();
 #else
   bool shouldAlert = bool(getenv("PERFHERDER_ALERTING_ENABLED"));
+  int iterations = std::max(1, GetEnvInt("MOZ_GTEST_BENCH_ITERATIONS",
+                                         MOZ_GTEST_NUM_ITERATIONS));
+  int warmups = GetEnvInt("MOZ_GTEST_BENCH_WARMUP_ITERATIONS",
+                          MOZ_GTEST_NUM_WARMUP_ITERATIONS);
   std::vector<int> durations;
 
-  for (int i=0; i<MOZ_GTEST_NUM_ITERATIONS; i++) {
+  MaybePinToCPU();
+
+  // Unmeasured runs so that the first replicate doesn't include the cost of
+  // faulting in code and data and of warming up caches.
+  for (int i=0; i<warmups; i++) {
+    aTest();
+  }
+
+  for (int i=0; i<iterations; i++) {
     mozilla::TimeStamp start = TimeStamp::Now();
 
     aTest();
@@ -35,7 +106,7 @@ void GTestBench(const char* aSuite, const char* aName,
   }
 
   std::string replicatesStr = "[" + std::to_string(durations[0]);
-  for (int i=1; i<MOZ_GTEST_NUM_ITERATIONS; i++) {
+  for (int i=1; i<iterations; i++) {
     replicatesStr += "," + std::to_string(durations[i]);
   }
   replicatesStr += "]";
@@ -43,7 +114,7 @@ void GTestBench(const char* aSuite, const char* aName,
   // median is at index floor(i/2) if number of replicates is odd,
   // (i/2-1) if even
   std::sort(durations.begin(), durations.end());
-  int medianIndex = (MOZ_GTEST_NUM_ITERATIONS / 2) + ((durations.size() % 2 == 0) ? (-1) : 0);
+  int medianIndex = (iterations / 2) + ((durations.size() % 2 == 0) ? (-1) : 0);
 
   // Print the result for each test. Let perfherder aggregate for us
   printf("PERFHERDER_DATA: {\"framework\": {\"name\": \"%s\"}, "
@@ -53,8 +124,23 @@ void GTestBench(const char* aSuite, const char* aName,
          "}]}\n",
          MOZ_GTEST_BENCH_FRAMEWORK, aSuite, aName, durations[medianIndex],
          replicatesStr.c_str(), shouldAlert ? "true" : "false");
+
+  // For comparing runs locally, also append the distribution as one JSON
+  // object per line to the file named by MOZ_GTEST_BENCH_OUTPUT.
+  if (const char* path = getenv("MOZ_GTEST_BENCH_OUTPUT")) {
+    if (FILE* out = fopen(path, "a")) {
+      fprintf(out, "{\"suite\": \"%s\", \"name\": \"%s\", \"unit\": \"us\", "
+              "\"min\": %i, \"median\": %i, \"p90\": %i, \"max\": %i, "
+              "\"replicates\": %s}\n",
+              aSuite, aName, durations.front(), durations[medianIndex],
+              Percentile(durations, 90), durations.back(),
+              replicatesStr.c_str());
+      fclose(out);
+    } else {
+      fprintf(stderr, "MozGTestBench: failed to open %s\n", path);
+    }
+  }
 #endif
 }
 
 } // mozilla
-
@@ -10,6 +10,13 @@
 
 namespace mozilla {
 
+// Runs aTest once in debug builds. In optimized builds, runs it after
+// MOZ_GTEST_BENCH_WARMUP_ITERATIONS (default 1) unmeasured runs,
+// MOZ_GTEST_BENCH_ITERATIONS (default 5) times, and prints the median
+// duration in microseconds as PERFHERDER_DATA. If MOZ_GTEST_BENCH_CPU is
+// set, the process is pinned to that CPU on Linux. If
+// MOZ_GTEST_BENCH_OUTPUT is set, the min, median, 90th percentile and max
+// durations are appended to that file as one JSON object per line.
 void GTestBench(const char* aSuite, const char* aName, const std::function<void()>& aTest);
 
 } //mozilla
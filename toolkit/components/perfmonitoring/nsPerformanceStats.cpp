@@ -872,6 +872,30 @@ nsPerformanceStatsService::SetIsMonitoringJank(JSContext* cx, bool aIsStopwatchA
   return NS_OK;
 }
 
+/* [implicit_jscontext] attribute unsigned long jankSamplingInterval; */
+NS_IMETHODIMP
+nsPerformanceStatsService::GetJankSamplingInterval(JSContext* cx, uint32_t *aJankSamplingInterval)
+{
+  if (!mIsAvailable) {
+    return NS_ERROR_NOT_AVAILABLE;
+  }
+
+  *aJankSamplingInterval = js::GetStopwatchSamplingInterval(cx);
+  return NS_OK;
+}
+NS_IMETHODIMP
+nsPerformanceStatsService::SetJankSamplingInterval(JSContext* cx, uint32_t aJankSamplingInterval)
+{
+  if (!mIsAvailable) {
+    return NS_ERROR_NOT_AVAILABLE;
+  }
+
+  if (!js::SetStopwatchSamplingInterval(cx, aJankSamplingInterval)) {
+    return NS_ERROR_FAILURE;
+  }
+  return NS_OK;
+}
+
 /* [implicit_jscontext] attribute bool isMonitoringPerCompartment; */
 NS_IMETHODIMP
 nsPerformanceStatsService::GetIsMonitoringPerCompartment(JSContext*, bool *aIsMonitoringPerCompartment)
@@ -193,6 +193,12 @@ namespace places {
 ////////////////////////////////////////////////////////////////////////////////
 //// AutoComplete Matching Function
 
+  MatchAutoCompleteFunction::MatchAutoCompleteFunction()
+    : mMatchResult(new IntegerVariant(1))
+    , mNoMatchResult(new IntegerVariant(0))
+  {
+  }
+
   /* static */
   nsresult
   MatchAutoCompleteFunction::create(mozIStorageConnection *aDBConn)
@@ -358,7 +364,7 @@ namespace places {
         StringBeginsWith(url, NS_LITERAL_CSTRING("javascript:")) &&
         !HAS_BEHAVIOR(JAVASCRIPT) &&
         !StringBeginsWith(searchString, NS_LITERAL_CSTRING("javascript:"))) {
-      NS_ADDREF(*_result = new IntegerVariant(0));
+      NS_ADDREF(*_result = mNoMatchResult);
       return NS_OK;
     }
 
@@ -387,20 +393,29 @@ namespace places {
     }
 
     if (!matches) {
-      NS_ADDREF(*_result = new IntegerVariant(0));
+      NS_ADDREF(*_result = mNoMatchResult);
       return NS_OK;
     }
 
     // Obtain our search function.
     searchFunctionPtr searchFunction = getSearchFunction(matchBehavior);
 
-    // Clean up our URI spec and prepare it for searching.
+    // Cleaning up the URI spec unescapes it into a new buffer, so only do it
+    // once a token actually has to be searched for in the URL: most rows are
+    // rejected, or matched, by the title and tags alone.
     nsCString fixedUrlBuf;
-    nsDependentCSubstring fixedUrl =
-      fixupURISpec(url, matchBehavior, fixedUrlBuf);
-    // Limit the number of chars we search through.
-    const nsDependentCSubstring& trimmedUrl =
-      Substring(fixedUrl, 0, MAX_CHARS_TO_SEARCH_THROUGH);
+    nsDependentCSubstring trimmedUrl;
+    bool urlFixedUp = false;
+    auto searchUrl = [&](const nsDependentCSubstring& aToken) {
+      if (!urlFixedUp) {
+        nsDependentCSubstring fixedUrl =
+          fixupURISpec(url, matchBehavior, fixedUrlBuf);
+        // Limit the number of chars we search through.
+        trimmedUrl.Rebind(fixedUrl, 0, MAX_CHARS_TO_SEARCH_THROUGH);
+        urlFixedUp = true;
+      }
+      return searchFunction(aToken, trimmedUrl);
+    };
 
     nsDependentCString title = getSharedString(aArguments, kArgIndexTitle);
     // Limit the number of chars we search through.
@@ -416,23 +431,23 @@ namespace places {
       if (HAS_BEHAVIOR(TITLE) && HAS_BEHAVIOR(URL)) {
         matches = (searchFunction(token, trimmedTitle) ||
                    searchFunction(token, tags)) &&
-                  searchFunction(token, trimmedUrl);
+                  searchUrl(token);
       }
       else if (HAS_BEHAVIOR(TITLE)) {
         matches = searchFunction(token, trimmedTitle) ||
                   searchFunction(token, tags);
       }
       else if (HAS_BEHAVIOR(URL)) {
-        matches = searchFunction(token, trimmedUrl);
+        matches = searchUrl(token);
       }
       else {
         matches = searchFunction(token, trimmedTitle) ||
                   searchFunction(token, tags) ||
-                  searchFunction(token, trimmedUrl);
+                  searchUrl(token);
       }
     }
 
-    NS_ADDREF(*_result = new IntegerVariant(matches ? 1 : 0));
+    NS_ADDREF(*_result = matches ? mMatchResult : mNoMatchResult);
     return NS_OK;
     #undef HAS_BEHAVIOR
   }
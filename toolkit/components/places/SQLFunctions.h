@@ -71,8 +71,17 @@ public:
   static nsresult create(mozIStorageConnection *aDBConn);
 
 private:
+  MatchAutoCompleteFunction();
   ~MatchAutoCompleteFunction() {}
 
+  /**
+   * The results of the function, created once since the function runs for
+   * every row of the awesomebar queries.  Variants are immutable and
+   * thread-safe, so they can be shared by all the calls.
+   */
+  const nsCOMPtr<nsIVariant> mMatchResult;
+  const nsCOMPtr<nsIVariant> mNoMatchResult;
+
   /**
    * Argument Indexes
    */
@@ -4434,16 +4434,42 @@ nsNavHistory::UpdateFrecency(int64_t aPlaceId)
 
 namespace {
 
+// The number of pages whose frecency is recalculated at once.  Small enough
+// that visits and other writes queued on the async thread never wait long
+// behind a batch, even after a large import or history removal.
+#define FIX_INVALID_FRECENCIES_BATCH_SIZE 500
+
 class FixInvalidFrecenciesCallback : public AsyncStatementCallbackNotifier
 {
 public:
   FixInvalidFrecenciesCallback()
     : AsyncStatementCallbackNotifier(TOPIC_FRECENCY_UPDATED)
+    , mMoreToFix(false)
   {
   }
 
-  NS_IMETHOD HandleCompletion(uint16_t aReason)
+  NS_IMETHOD HandleResult(mozIStorageResultSet* aResultSet) override
+  {
+    nsCOMPtr<mozIStorageRow> row;
+    nsresult rv = aResultSet->GetNextRow(getter_AddRefs(row));
+    NS_ENSURE_SUCCESS(rv, rv);
+    if (row) {
+      mMoreToFix = row->AsInt32(0) != 0;
+    }
+    return NS_OK;
+  }
+
+  NS_IMETHOD HandleCompletion(uint16_t aReason) override
   {
+    if (aReason == REASON_FINISHED && mMoreToFix) {
+      // Fix the next batch once the main thread is idle again, and only
+      // notify about the changes when all the batches are done.
+      nsNavHistory *navHistory = nsNavHistory::GetHistoryService();
+      NS_ENSURE_STATE(navHistory);
+      return NS_IdleDispatchToCurrentThread(
+        NewRunnableMethod("nsNavHistory::FixInvalidFrecencies",
+                          navHistory, &nsNavHistory::FixInvalidFrecencies));
+    }
     nsresult rv = AsyncStatementCallbackNotifier::HandleCompletion(aReason);
     NS_ENSURE_SUCCESS(rv, rv);
     if (aReason == REASON_FINISHED) {
@@ -4453,6 +4479,9 @@ public:
     }
     return NS_OK;
   }
+
+private:
+  bool mMoreToFix;
 };
 
 } // namespace
@@ -4460,17 +4489,38 @@ public:
 nsresult
 nsNavHistory::FixInvalidFrecencies()
 {
-  nsCOMPtr<mozIStorageAsyncStatement> stmt = mDB->GetAsyncStatement(
+  nsCOMPtr<mozIStorageAsyncStatement> fixFrecencies = mDB->GetAsyncStatement(
     "UPDATE moz_places "
     "SET frecency = CALCULATE_FRECENCY(id) "
-    "WHERE frecency < 0"
+    "WHERE id IN ("
+      "SELECT id FROM moz_places "
+      "WHERE frecency < 0 "
+      "LIMIT :batch_size"
+    ")"
   );
-  NS_ENSURE_STATE(stmt);
+  NS_ENSURE_STATE(fixFrecencies);
+  nsresult rv = fixFrecencies->BindInt32ByName(
+    NS_LITERAL_CSTRING("batch_size"), FIX_INVALID_FRECENCIES_BATCH_SIZE);
+  NS_ENSURE_SUCCESS(rv, rv);
+
+  nsCOMPtr<mozIStorageAsyncStatement> moreToFix = mDB->GetAsyncStatement(
+    "SELECT EXISTS(SELECT 1 FROM moz_places WHERE frecency < 0)"
+  );
+  NS_ENSURE_STATE(moreToFix);
 
+  nsCOMPtr<mozIStorageConnection> conn = mDB->MainConn();
+  if (!conn) {
+    return NS_ERROR_UNEXPECTED;
+  }
+  mozIStorageBaseStatement *stmts[] = {
+    fixFrecencies.get(),
+    moreToFix.get()
+  };
   RefPtr<FixInvalidFrecenciesCallback> callback =
     new FixInvalidFrecenciesCallback();
   nsCOMPtr<mozIStoragePendingStatement> ps;
-  (void)stmt->ExecuteAsync(callback, getter_AddRefs(ps));
+  (void)conn->ExecuteAsync(stmts, ArrayLength(stmts), callback,
+                           getter_AddRefs(ps));
 
   return NS_OK;
 }
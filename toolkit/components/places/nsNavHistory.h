@@ -167,6 +167,8 @@ public:
    *  * After a "clear private data"
    *  * After removing visits
    *  * After migrating from older versions
+   * The pages are processed in batches, each one started when the main thread
+   * is idle, so that other writes aren't held up behind thousands of rows.
    */
   nsresult FixInvalidFrecencies();
 
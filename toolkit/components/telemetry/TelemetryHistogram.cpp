@@ -185,9 +185,12 @@ namespace {
 bool gInitDone = false;
 
 // Whether we are collecting the base, opt-out, Histogram data.
-bool gCanRecordBase = false;
+// These two are only written with |gTelemetryHistogramMutex| held, but they
+// are atomic so that accumulations which would be discarded anyway can check
+// them without taking the mutex (see internal_WillDiscardSample).
+mozilla::Atomic<bool, mozilla::Relaxed> gCanRecordBase(false);
 // Whether we are collecting the extended, opt-in, Histogram data.
-bool gCanRecordExtended = false;
+mozilla::Atomic<bool, mozilla::Relaxed> gCanRecordExtended(false);
 
 // The storage for actual Histogram instances.
 // We use separate ones for plain and keyed histograms.
@@ -862,6 +865,27 @@ static StaticMutex gTelemetryHistogramMutex;
 
 namespace {
 
+// Returns true if a sample for |aId| accumulated in this process would
+// certainly be discarded: when nothing can be recorded, or, in the parent
+// process, when the histogram's dataset isn't being recorded (e.g. opt-in
+// probes on release).  This only looks at state that is safe to read without
+// |gTelemetryHistogramMutex|, so that the many accumulations of probes that
+// aren't recorded don't contend on the mutex.  Child processes forward their
+// samples to the parent, which checks their dataset itself.
+bool
+internal_WillDiscardSample(HistogramID aId)
+{
+  if (!internal_CanRecordBase()) {
+    return true;
+  }
+  if (!XRE_IsParentProcess()) {
+    return false;
+  }
+  return !CanRecordDataset(gHistogramInfos[aId].dataset,
+                           internal_CanRecordBase(),
+                           internal_CanRecordExtended());
+}
+
 bool
 internal_RemoteAccumulate(HistogramID aId, uint32_t aSample)
 {
@@ -1780,6 +1804,9 @@ TelemetryHistogram::Accumulate(HistogramID aID,
     MOZ_ASSERT_UNREACHABLE("Histogram usage requires valid ids.");
     return;
   }
+  if (internal_WillDiscardSample(aID)) {
+    return;
+  }
 
   StaticMutexAutoLock locker(gTelemetryHistogramMutex);
   internal_Accumulate(aID, aSample);
@@ -1793,6 +1820,9 @@ TelemetryHistogram::Accumulate(HistogramID aID,
     MOZ_ASSERT_UNREACHABLE("Histogram usage requires valid ids.");
     return;
   }
+  if (internal_WillDiscardSample(aID)) {
+    return;
+  }
 
   StaticMutexAutoLock locker(gTelemetryHistogramMutex);
   internal_Accumulate(aID, aKey, aSample);
@@ -1836,6 +1866,9 @@ TelemetryHistogram::AccumulateCategorical(HistogramID aId,
     MOZ_ASSERT_UNREACHABLE("Histogram usage requires valid ids.");
     return;
   }
+  if (internal_WillDiscardSample(aId)) {
+    return;
+  }
 
   StaticMutexAutoLock locker(gTelemetryHistogramMutex);
   if (!internal_CanRecordBase()) {
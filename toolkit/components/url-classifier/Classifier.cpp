@@ -467,20 +467,28 @@ Classifier::Check(const nsACString& aSpec,
     }
   }
 
-  // Now check each lookup fragment against the entries in the DB.
+  // Hash every lookup fragment once up front.
+  AutoTArray<Completion, 8> lookupHashes;
   for (uint32_t i = 0; i < fragments.Length(); i++) {
-    Completion lookupHash;
-    lookupHash.FromPlaintext(fragments[i], mCryptoHash);
+    Completion* lookupHash = lookupHashes.AppendElement();
+    lookupHash->FromPlaintext(fragments[i], mCryptoHash);
 
     if (LOG_ENABLED()) {
       nsAutoCString checking;
-      lookupHash.ToHexString(checking);
+      lookupHash->ToHexString(checking);
       LOG(("Checking fragment %s, hash %s (%X)", fragments[i].get(),
-           checking.get(), lookupHash.ToUint32()));
+           checking.get(), lookupHash->ToUint32()));
     }
+  }
+
+  // Now check the fragments against the entries in the DB, one table at a
+  // time so that the prefix set of a table stays in the CPU caches for all
+  // of them.
+  for (uint32_t i = 0; i < cacheArray.Length(); i++) {
+    LookupCache *cache = cacheArray[i];
 
-    for (uint32_t i = 0; i < cacheArray.Length(); i++) {
-      LookupCache *cache = cacheArray[i];
+    for (uint32_t j = 0; j < lookupHashes.Length(); j++) {
+      const Completion& lookupHash = lookupHashes[j];
       bool has, confirmed;
       uint32_t matchLength;
 
@@ -6,6 +6,7 @@
 #include "LookupCacheV4.h"
 #include "HashStore.h"
 #include "mozilla/Unused.h"
+#include "nsDataHashtable.h"
 #include <string>
 
 // MOZ_LOG=UrlClassifierDbService:5
@@ -195,6 +196,35 @@ AppendPrefixToMap(PrefixStringMap& prefixes, nsDependentCSubstring& prefix)
   prefixString->Append(prefix.BeginReading(), prefix.Length());
 }
 
+// Reserve room in |aOutputMap| for every prefix of |aInputMap| and of
+// |aAddMap|, the most a merge can produce, so that building the new map does
+// not repeatedly reallocate and copy strings of many megabytes. Returns the
+// number of bytes reserved.
+static uint32_t
+ReservePrefixMap(PrefixStringMap& aOutputMap,
+                 const PrefixStringMap& aInputMap,
+                 const TableUpdateV4::PrefixStdStringMap& aAddMap)
+{
+  nsDataHashtable<nsUint32HashKey, uint32_t> lengths;
+  for (auto iter = aInputMap.ConstIter(); !iter.Done(); iter.Next()) {
+    lengths.GetOrInsert(iter.Key()) += iter.Data()->Length();
+  }
+  for (auto iter = aAddMap.ConstIter(); !iter.Done(); iter.Next()) {
+    lengths.GetOrInsert(iter.Key()) +=
+      iter.Data()->GetPrefixString().Length();
+  }
+
+  uint32_t total = 0;
+  for (auto iter = lengths.ConstIter(); !iter.Done(); iter.Next()) {
+    nsCString* prefixString = aOutputMap.LookupOrAdd(iter.Key());
+    // This is only a hint: on failure the string grows as it is appended to.
+    if (prefixString->SetCapacity(iter.Data(), fallible)) {
+      total += iter.Data();
+    }
+  }
+  return total;
+}
+
 // Read prefix into a buffer and also update the hash which
 // keeps track of the checksum
 static void
@@ -226,6 +256,11 @@ LookupCacheV4::ApplyUpdate(TableUpdateV4* aTableUpdate,
   VLPrefixSet oldPSet(aInputMap);
   VLPrefixSet addPSet(aTableUpdate->Prefixes());
 
+  uint32_t reserved =
+    ReservePrefixMap(aOutputMap, aInputMap, aTableUpdate->Prefixes());
+  Telemetry::Accumulate(Telemetry::URLCLASSIFIER_VLPS_UPDATE_MERGE_SIZE,
+                        mProvider, reserved / 1024);
+
   // RemovalIndiceArray is a sorted integer array indicating the index of prefix we should
   // remove from the old prefix set(according to lexigraphic order).
   // |removalIndex| is the current index of RemovalIndiceArray.
@@ -488,6 +488,10 @@ Addon::UpdateLastModifiedTime()
   nsCOMPtr<nsIFile> file;
   MOZ_TRY_VAR(file, FullPath());
 
+  // Exists(), IsFile() and GetLastModifiedTime() below, and the same on the
+  // manifest, can all share one stat().
+  Unused << file->SetUseStatCache(true);
+
   bool result;
   if (NS_FAILED(file->Exists(&result)) || !result) {
     return true;
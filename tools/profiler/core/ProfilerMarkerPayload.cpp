@@ -93,6 +93,17 @@ UserTimingMarkerPayload::StreamPayload(SpliceableJSONWriter& aWriter,
   aWriter.StringProperty("entryType", mEntryType);
 }
 
+void
+NetworkMarkerPayload::StreamPayload(SpliceableJSONWriter& aWriter,
+                                    const TimeStamp& aProcessStartTime,
+                                    UniqueStacks& aUniqueStacks)
+{
+  StreamCommonProps("Network", aWriter, aProcessStartTime, aUniqueStacks);
+  aWriter.StringProperty("phase", mPhase);
+  aWriter.StringProperty("URI", mURI.get());
+  aWriter.IntProperty("channelId", int64_t(mChannelId));
+}
+
 void
 DOMEventMarkerPayload::StreamPayload(SpliceableJSONWriter& aWriter,
                                      const TimeStamp& aProcessStartTime,
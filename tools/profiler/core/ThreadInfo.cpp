@@ -32,6 +32,8 @@ ThreadInfo::ThreadInfo(const char* aName, int aThreadId, bool aIsMainThread,
   , mContext(nullptr)
   , mJSSampling(INACTIVE)
   , mLastSample()
+  , mLastSampleCPUTime(0)
+  , mSamplePauseCount(0)
 {
   MOZ_COUNT_CTOR(ThreadInfo);
 
@@ -58,6 +60,11 @@ ThreadInfo::StartProfiling()
 {
   mIsBeingProfiled = true;
   mRacyInfo->ReinitializeOnResume();
+  // Our last sample was in the previous profiler session's buffer.
+  mLastSampleCPUTime = 0;
+  mSamplePauseCount = 0;
+  mSamplePauseTotal = mozilla::TimeDuration();
+  mSamplePauseMax = mozilla::TimeDuration();
   if (mIsMainThread) {
     mResponsiveness.emplace();
   }
@@ -137,6 +144,14 @@ ThreadInfo::StreamJSON(const ProfileBuffer& aBuffer,
       mUniqueStacks->mUniqueStrings.SpliceStringTableElements(aWriter);
     }
     aWriter.EndArray();
+
+    aWriter.StartObjectProperty("samplePauses");
+    {
+      aWriter.IntProperty("count", mSamplePauseCount);
+      aWriter.DoubleProperty("totalMs", mSamplePauseTotal.ToMilliseconds());
+      aWriter.DoubleProperty("maxMs", mSamplePauseMax.ToMilliseconds());
+    }
+    aWriter.EndObject();
   }
   aWriter.End();
 
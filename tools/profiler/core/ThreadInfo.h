@@ -192,6 +192,17 @@ public:
 
   ProfileBuffer::LastSample& LastSample() { return mLastSample; }
 
+  uint64_t& LastSampleCPUTime() { return mLastSampleCPUTime; }
+
+  void NoteSamplePause(const mozilla::TimeDuration& aDuration)
+  {
+    mSamplePauseCount++;
+    mSamplePauseTotal += aDuration;
+    if (aDuration > mSamplePauseMax) {
+      mSamplePauseMax = aDuration;
+    }
+  }
+
 private:
   mozilla::UniqueFreePtr<char> mName;
   mozilla::TimeStamp mRegisterTime;
@@ -373,6 +384,16 @@ private:
   // When sampling, this holds the generation number and offset in
   // ActivePS::mBuffer of the most recent sample for this thread.
   ProfileBuffer::LastSample mLastSample;
+
+  // The thread's GetThreadCPUTime() just before its most recent periodic
+  // sample was taken, or 0. If it hasn't changed, the sample can be copied.
+  uint64_t mLastSampleCPUTime;
+
+  // How many times, for how long in total, and for how long at most this
+  // thread was suspended to take a periodic sample.
+  uint32_t mSamplePauseCount;
+  mozilla::TimeDuration mSamplePauseTotal;
+  mozilla::TimeDuration mSamplePauseMax;
 };
 
 void
@@ -120,7 +120,11 @@ tgkill(pid_t tgid, pid_t tid, int signalno)
 class PlatformData
 {
 public:
+  // This is MAKE_THREAD_CPUCLOCK(aThreadId, CPUCLOCK_SCHED) from the kernel's
+  // posix-timers.h, which is what pthread_getcpuclockid() returns for the
+  // thread. We only have its thread ID, not a pthread_t.
   explicit PlatformData(int aThreadId)
+    : mCPUClockId((~clockid_t(aThreadId) << 3) | 6)
   {
     MOZ_COUNT_CTOR(PlatformData);
   }
@@ -129,8 +133,23 @@ public:
   {
     MOZ_COUNT_DTOR(PlatformData);
   }
+
+  clockid_t CPUClockId() { return mCPUClockId; }
+
+private:
+  clockid_t mCPUClockId;
 };
 
+uint64_t
+GetThreadCPUTime(PlatformData* aData)
+{
+  struct timespec ts;
+  if (clock_gettime(aData->CPUClockId(), &ts) != 0) {
+    return 0;
+  }
+  return uint64_t(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
 ////////////////////////////////////////////////////////////////////////
 // BEGIN Sampler target specifics
 
@@ -61,6 +61,14 @@ private:
   thread_act_t mProfiledThread;
 };
 
+uint64_t
+GetThreadCPUTime(PlatformData* aData)
+{
+  // thread_info() reports CPU time in microseconds, which can miss a thread
+  // that ran only briefly, so always take a full sample.
+  return 0;
+}
+
 ////////////////////////////////////////////////////////////////////////
 // BEGIN Sampler target specifics
 
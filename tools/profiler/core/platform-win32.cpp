@@ -97,6 +97,16 @@ GetThreadHandle(PlatformData* aData)
   return aData->ProfiledThread();
 }
 
+uint64_t
+GetThreadCPUTime(PlatformData* aData)
+{
+  ULONG64 cycles;
+  if (!QueryThreadCycleTime(aData->ProfiledThread(), &cycles)) {
+    return 0;
+  }
+  return cycles;
+}
+
 static const HANDLE kNoThread = INVALID_HANDLE_VALUE;
 
 ////////////////////////////////////////////////////////////////////////
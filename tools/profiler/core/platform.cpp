@@ -1782,6 +1782,12 @@ PrintUsageThenExit(int aExitCode)
     "  MOZ_PROFILER_SHUTDOWN\n"
     "  If set, the profiler saves a profile to the named file on shutdown.\n"
     "\n"
+    "  MOZ_PROFILER_HANG_DIR\n"
+    "  If set, the profile of each hang detected by the background hang\n"
+    "  monitor, and of the 5 seconds before it, is saved to the named\n"
+    "  directory. Combine with MOZ_PROFILER_STARTUP, a long interval and no\n"
+    "  'stackwalk' feature for a low-overhead profiler that's always on.\n"
+    "\n"
     "  MOZ_PROFILER_LUL_TEST\n"
     "  If set to any value, runs LUL unit tests at startup.\n"
     "\n"
@@ -1954,9 +1960,13 @@ SamplerThread::Run()
           }
 
           // If the thread is asleep and has been sampled before in the same
-          // sleep episode, find and copy the previous sample, as that's
-          // cheaper than taking a new sample.
-          if (info->RacyInfo()->CanDuplicateLastSampleDueToSleep()) {
+          // sleep episode, or if it hasn't run at all since it was last
+          // sampled (e.g. it's blocked somewhere that doesn't mark it as
+          // asleep), find and copy the previous sample, as that's cheaper
+          // than suspending the thread and walking its stack again.
+          uint64_t cpuTime = GetThreadCPUTime(info->GetPlatformData());
+          if (info->RacyInfo()->CanDuplicateLastSampleDueToSleep() ||
+              (cpuTime != 0 && cpuTime == info->LastSampleCPUTime())) {
             bool dup_ok =
               ActivePS::Buffer(lock).DuplicateLastSample(
                 info->ThreadId(), CorePS::ProcessStartTime(),
@@ -1965,6 +1975,7 @@ SamplerThread::Run()
               continue;
             }
           }
+          info->LastSampleCPUTime() = cpuTime;
 
           // We only track responsiveness for the main thread.
           if (info->IsMainThread()) {
@@ -1986,6 +1997,7 @@ SamplerThread::Run()
                                           [&](const Registers& aRegs) {
             DoPeriodicSample(lock, *info, now, aRegs, rssMemory, ussMemory);
           });
+          info->NoteSamplePause(TimeStamp::Now() - now);
         }
 
 #if defined(USE_LUL_STACKWALK)
@@ -2392,7 +2404,7 @@ profiler_init(void* aStackTop)
 
 static void
 locked_profiler_save_profile_to_file(PSLockRef aLock, const char* aFilename,
-                                     bool aIsShuttingDown);
+                                     double aSinceTime, bool aIsShuttingDown);
 
 static SamplerThread*
 locked_profiler_stop(PSLockRef aLock);
@@ -2416,6 +2428,7 @@ profiler_shutdown()
       const char* filename = getenv("MOZ_PROFILER_SHUTDOWN");
       if (filename) {
         locked_profiler_save_profile_to_file(lock, filename,
+                                             /* aSinceTime */ 0,
                                              /* aIsShuttingDown */ true);
       }
 
@@ -2555,6 +2568,7 @@ AutoSetProfilerEnvVarsForChildProcess::~AutoSetProfilerEnvVarsForChildProcess()
 
 static void
 locked_profiler_save_profile_to_file(PSLockRef aLock, const char* aFilename,
+                                     double aSinceTime,
                                      bool aIsShuttingDown = false)
 {
   LOG("locked_profiler_save_profile_to_file(%s)", aFilename);
@@ -2567,7 +2581,7 @@ locked_profiler_save_profile_to_file(PSLockRef aLock, const char* aFilename,
     SpliceableJSONWriter w(MakeUnique<OStreamJSONWriteFunc>(stream));
     w.Start(SpliceableJSONWriter::SingleLineStyle);
     {
-      locked_profiler_stream_json_for_this_process(aLock, w, /* sinceTime */ 0,
+      locked_profiler_stream_json_for_this_process(aLock, w, aSinceTime,
                                                    aIsShuttingDown);
 
       // Don't include profiles from other processes because this is a
@@ -2594,7 +2608,23 @@ profiler_save_profile_to_file(const char* aFilename)
     return;
   }
 
-  locked_profiler_save_profile_to_file(lock, aFilename);
+  locked_profiler_save_profile_to_file(lock, aFilename, /* aSinceTime */ 0);
+}
+
+void
+profiler_save_recent_profile_to_file(const char* aFilename, double aSinceTime)
+{
+  LOG("profiler_save_recent_profile_to_file(%s, %f)", aFilename, aSinceTime);
+
+  MOZ_RELEASE_ASSERT(CorePS::Exists());
+
+  PSAutoLock lock(gPSMutex);
+
+  if (!ActivePS::Exists(lock)) {
+    return;
+  }
+
+  locked_profiler_save_profile_to_file(lock, aFilename, aSinceTime);
 }
 
 uint32_t
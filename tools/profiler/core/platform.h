@@ -122,6 +122,11 @@ typedef mozilla::UniquePtr<PlatformData, PlatformDataDestructor>
   UniquePlatformData;
 UniquePlatformData AllocPlatformData(int aThreadId);
 
+// Returns a counter of the CPU time used by the thread, in platform-dependent
+// units, or 0 if it can't be determined. A thread whose counter hasn't changed
+// hasn't run, and so its stack hasn't changed either.
+uint64_t GetThreadCPUTime(PlatformData* aData);
+
 namespace mozilla {
 class JSONWriter;
 }
@@ -479,6 +479,12 @@ extern "C" {
 PROFILER_FUNC_VOID(profiler_save_profile_to_file(const char* aFilename))
 }
 
+// Like profiler_save_profile_to_file(), but only writes the samples and
+// markers recorded since aSinceTime (see profiler_time()). This does file
+// I/O, so call it off the main thread.
+PROFILER_FUNC_VOID(profiler_save_recent_profile_to_file(const char* aFilename,
+                                                        double aSinceTime))
+
 //---------------------------------------------------------------------------
 // RAII classes
 //---------------------------------------------------------------------------
@@ -172,6 +172,32 @@ private:
   nsString mName;
 };
 
+// One phase of a network request, such as waiting in the connection manager's
+// queue or for a cache entry, so that a request's waits can be broken down.
+class NetworkMarkerPayload : public ProfilerMarkerPayload
+{
+public:
+  NetworkMarkerPayload(const char* aPhase, const nsACString& aURI,
+                       uint64_t aChannelId,
+                       const mozilla::TimeStamp& aStartTime,
+                       const mozilla::TimeStamp& aEndTime)
+    : ProfilerMarkerPayload(aStartTime, aEndTime)
+    , mPhase(aPhase)
+    , mURI(aURI)
+    , mChannelId(aChannelId)
+  {
+    MOZ_ASSERT(aPhase);
+  }
+
+  DECL_STREAM_PAYLOAD
+
+private:
+  // A static string.
+  const char* mPhase;
+  nsCString mURI;
+  uint64_t mChannelId;
+};
+
 // Contains the translation applied to a 2d layer so we can track the layer
 // position at each frame.
 class LayerTranslationMarkerPayload : public ProfilerMarkerPayload
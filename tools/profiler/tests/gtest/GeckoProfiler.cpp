@@ -18,9 +18,14 @@
 #include "mozilla/UniquePtrExtensions.h"
 #include "ProfileBuffer.h"
 #include "ProfileJSONWriter.h"
+#include "nsDirectoryServiceDefs.h"
+#include "nsDirectoryServiceUtils.h"
+#include "nsIFile.h"
 #include "nsIThread.h"
 #include "nsThreadUtils.h"
 
+#include <fstream>
+#include <sstream>
 #include <string.h>
 
 // Note: profiler_init() has already been called in XRE_main(), so we can't
@@ -616,6 +621,44 @@ JSONOutputCheck(const char* aOutput)
   ASSERT_TRUE(strstr(aOutput, "\"stringTable\""));
 }
 
+TEST(GeckoProfiler, SaveRecentProfileToFile)
+{
+  uint32_t features = 0;
+  const char* filters[] = { "GeckoMain" };
+
+  nsCOMPtr<nsIFile> file;
+  ASSERT_EQ(NS_OK, NS_GetSpecialDirectory(NS_OS_TEMP_DIR,
+                                          getter_AddRefs(file)));
+  ASSERT_EQ(NS_OK, file->AppendNative(NS_LITERAL_CSTRING("recent.json")));
+  ASSERT_EQ(NS_OK, file->CreateUnique(nsIFile::NORMAL_FILE_TYPE, 0600));
+  nsAutoCString path;
+  ASSERT_EQ(NS_OK, file->GetNativePath(path));
+
+  profiler_start(PROFILER_DEFAULT_ENTRIES, PROFILER_DEFAULT_INTERVAL,
+                 features, filters, MOZ_ARRAY_LENGTH(filters));
+
+  // Markers reach the buffer when their thread is next sampled.
+  profiler_add_marker("Before");
+  PR_Sleep(PR_MillisecondsToInterval(100));
+  double sinceTime = profiler_time();
+  profiler_add_marker("After");
+  PR_Sleep(PR_MillisecondsToInterval(100));
+
+  profiler_save_recent_profile_to_file(path.get(), sinceTime);
+
+  profiler_stop();
+
+  std::ifstream stream(path.get());
+  std::stringstream contents;
+  contents << stream.rdbuf();
+  std::string profile = contents.str();
+  file->Remove(false);
+
+  JSONOutputCheck(profile.c_str());
+  ASSERT_TRUE(strstr(profile.c_str(), "\"After\""));
+  ASSERT_TRUE(!strstr(profile.c_str(), "\"Before\""));
+}
+
 TEST(GeckoProfiler, StreamJSONForThisProcess)
 {
   uint32_t features = ProfilerFeature::StackWalk;
@@ -171,6 +171,8 @@
 #include "nsThreadUtils.h"
 #include "nsXULAppAPI.h"
 #include "prenv.h"
+#include "prsystem.h"
+#include "prthread.h"
 #include "nsPrintfCString.h"
 #include "nsTArray.h"
 #include "nsIConsoleService.h"
@@ -182,6 +184,7 @@
 #include "nsDumpUtils.h"
 #include "xpcpublic.h"
 #include "GeckoProfiler.h"
+#include <algorithm>
 #include <stdint.h>
 #include <stdio.h>
 
@@ -777,6 +780,28 @@ public:
     PtrInfo*& mLast;
   };
 
+  // The nodes of one block, for scanning the blocks of the pool separately.
+  struct BlockNodes
+  {
+    PtrInfo* mStart;
+    PtrInfo* mEnd;
+  };
+
+  // Append the nodes of every block to aBlocks. Returns false on OOM.
+  bool GetBlockNodes(nsTArray<BlockNodes>& aBlocks) const
+  {
+    for (NodeBlock* b = mBlocks; b; b = b->mNext) {
+      PtrInfo* end = b->mNext ? b->mEntries + NodeBlockSize : mLast;
+      BlockNodes* nodes = aBlocks.AppendElement(fallible);
+      if (!nodes) {
+        return false;
+      }
+      nodes->mStart = b->mEntries;
+      nodes->mEnd = end;
+    }
+    return true;
+  }
+
   size_t SizeOfExcludingThis(MallocSizeOf aMallocSizeOf) const
   {
     // We don't measure the things pointed to by mEntries[] because those
@@ -1226,6 +1251,7 @@ enum ccType
 using js::SliceBudget;
 
 class JSPurpleBuffer;
+class ScanWhiteTask;
 
 class nsCycleCollector : public nsIMemoryReporter
 {
@@ -1331,6 +1357,7 @@ private:
   void ScanRoots(bool aFullySynchGraphBuild);
   void ScanIncrementalRoots();
   void ScanWhiteNodes(bool aFullySynchGraphBuild);
+  void FinishScanWhiteNodes(const ScanWhiteTask* aTasks, uint32_t aTaskCount);
   void ScanBlackNodes();
   void ScanWeakMaps();
 
@@ -3124,39 +3151,150 @@ nsCycleCollector::ScanIncrementalRoots()
   }
 }
 
-// Mark nodes white and make sure their refcounts are ok.
-// No nodes are marked black during this pass to ensure that refcount
-// checking is run on all nodes not marked black by ScanIncrementalRoots.
-void
-nsCycleCollector::ScanWhiteNodes(bool aFullySynchGraphBuild)
+// Scanning the nodes for ScanWhiteNodes only reads and writes the nodes
+// themselves, so for large graphs it is split between the collecting thread
+// and up to kMaxScanHelperThreads helper threads, one node block at a time.
+// Blocks hold 4K nodes, and every thread gets at least 16 of them, so only
+// graphs of at least 128K nodes are split.
+static const uint32_t kMaxScanHelperThreads = 3;
+static const uint32_t kMinBlocksPerScanThread = 16;
+
+class ScanWhiteTask
 {
-  NodePool::Enumerator nodeEnum(mGraph.mNodes);
-  while (!nodeEnum.IsDone()) {
-    PtrInfo* pi = nodeEnum.GetNext();
-    if (pi->mColor == black) {
+public:
+  ScanWhiteTask(const nsTArray<NodePool::BlockNodes>& aBlocks,
+                uint32_t aFirstBlock, uint32_t aBlockStride,
+                bool aFullySynchGraphBuild)
+    : mBlocks(aBlocks)
+    , mFirstBlock(aFirstBlock)
+    , mBlockStride(aBlockStride)
+    , mFullySynchGraphBuild(aFullySynchGraphBuild)
+    , mWhiteNodeCount(0)
+    , mOverReferenced(nullptr)
+  {
+  }
+
+  static void ThreadMain(void* aTask)
+  {
+    static_cast<ScanWhiteTask*>(aTask)->Run();
+  }
+
+  void Run()
+  {
+    for (uint32_t i = mFirstBlock; i < mBlocks.Length(); i += mBlockStride) {
+      const NodePool::BlockNodes& nodes = mBlocks[i];
+      for (PtrInfo* pi = nodes.mStart; pi != nodes.mEnd; ++pi) {
+        ScanNode(pi);
+      }
+    }
+  }
+
+  // Mark the node white if its refcount is ok.
+  void ScanNode(PtrInfo* aPi)
+  {
+    if (aPi->mColor == black) {
       // Incremental roots can be in a nonsensical state, so don't
       // check them. This will miss checking nodes that are merely
       // reachable from incremental roots.
-      MOZ_ASSERT(!aFullySynchGraphBuild,
+      MOZ_ASSERT(!mFullySynchGraphBuild,
                  "In a synch CC, no nodes should be marked black early on.");
-      continue;
+      return;
     }
-    MOZ_ASSERT(pi->mColor == grey);
+    MOZ_ASSERT(aPi->mColor == grey);
 
-    if (!pi->WasTraversed()) {
+    if (!aPi->WasTraversed()) {
       // This node was deleted before it was traversed, so there's no reason
       // to look at it.
-      MOZ_ASSERT(!pi->mParticipant, "Live nodes should all have been traversed");
-      continue;
+      MOZ_ASSERT(!aPi->mParticipant, "Live nodes should all have been traversed");
+      return;
     }
 
-    if (pi->mInternalRefs == pi->mRefCount || pi->IsGrayJS()) {
-      pi->mColor = white;
+    if (aPi->mInternalRefs == aPi->mRefCount || aPi->IsGrayJS()) {
+      aPi->mColor = white;
       ++mWhiteNodeCount;
-      continue;
+      return;
+    }
+
+    if (aPi->mInternalRefs > aPi->mRefCount && !mOverReferenced) {
+      // The collecting thread crashes once every task is done.
+      mOverReferenced = aPi;
     }
 
-    if (pi->mInternalRefs > pi->mRefCount) {
+    // This node will get marked black in the next pass.
+  }
+
+  uint32_t WhiteNodeCount() const { return mWhiteNodeCount; }
+  PtrInfo* OverReferenced() const { return mOverReferenced; }
+
+private:
+  const nsTArray<NodePool::BlockNodes>& mBlocks;
+  const uint32_t mFirstBlock;
+  const uint32_t mBlockStride;
+  const bool mFullySynchGraphBuild;
+  uint32_t mWhiteNodeCount;
+  PtrInfo* mOverReferenced;
+};
+
+// Mark nodes white and make sure their refcounts are ok.
+// No nodes are marked black during this pass to ensure that refcount
+// checking is run on all nodes not marked black by ScanIncrementalRoots.
+void
+nsCycleCollector::ScanWhiteNodes(bool aFullySynchGraphBuild)
+{
+  nsTArray<NodePool::BlockNodes> blocks;
+  uint32_t threadCount = 1;
+  if (mGraph.mNodes.GetBlockNodes(blocks)) {
+    uint32_t processors = std::max(PR_GetNumberOfProcessors(), 1);
+    threadCount = std::min(uint32_t(blocks.Length()) / kMinBlocksPerScanThread,
+                           std::min(processors, kMaxScanHelperThreads + 1));
+  }
+
+  if (threadCount <= 1) {
+    ScanWhiteTask task(blocks, 0, 1, aFullySynchGraphBuild);
+    NodePool::Enumerator nodeEnum(mGraph.mNodes);
+    while (!nodeEnum.IsDone()) {
+      task.ScanNode(nodeEnum.GetNext());
+    }
+    FinishScanWhiteNodes(&task, 1);
+    return;
+  }
+
+  // Task 0 runs on this thread, after starting the others.
+  AutoTArray<ScanWhiteTask, kMaxScanHelperThreads + 1> tasks;
+  AutoTArray<PRThread*, kMaxScanHelperThreads> helpers;
+  for (uint32_t i = 0; i < threadCount; i++) {
+    tasks.AppendElement(ScanWhiteTask(blocks, i, threadCount,
+                                      aFullySynchGraphBuild));
+  }
+  for (uint32_t i = 1; i < threadCount; i++) {
+    PRThread* thread = PR_CreateThread(PR_USER_THREAD,
+                                       ScanWhiteTask::ThreadMain, &tasks[i],
+                                       PR_PRIORITY_NORMAL, PR_GLOBAL_THREAD,
+                                       PR_JOINABLE_THREAD, 0);
+    if (thread) {
+      helpers.AppendElement(thread);
+    } else {
+      // Do the work of the helper that failed to start here instead.
+      tasks[i].Run();
+    }
+  }
+  tasks[0].Run();
+  for (PRThread* thread : helpers) {
+    PR_JoinThread(thread);
+  }
+
+  FinishScanWhiteNodes(tasks.Elements(), tasks.Length());
+}
+
+void
+nsCycleCollector::FinishScanWhiteNodes(const ScanWhiteTask* aTasks,
+                                       uint32_t aTaskCount)
+{
+  for (uint32_t i = 0; i < aTaskCount; i++) {
+    mWhiteNodeCount += aTasks[i].WhiteNodeCount();
+
+    PtrInfo* pi = aTasks[i].OverReferenced();
+    if (pi) {
 #ifdef MOZ_CRASHREPORTER
       const char* piName = "Unknown";
       if (pi->mParticipant) {
@@ -3167,8 +3305,6 @@ nsCycleCollector::ScanWhiteNodes(bool aFullySynchGraphBuild)
 #endif
       MOZ_CRASH();
     }
-
-    // This node will get marked black in the next pass.
   }
 }
 
@@ -807,7 +807,7 @@ class WindowsAddressSpaceReporter final : public nsIMemoryReporter
   ~WindowsAddressSpaceReporter() {}
 
 public:
-  NS_DECL_ISUPPORTS
+  NS_DECL_THREADSAFE_ISUPPORTS
 
   NS_IMETHOD CollectReports(nsIHandleReportCallback* aHandleReport,
                             nsISupports* aData, bool aAnonymize) override
@@ -986,7 +986,7 @@ class VsizeMaxContiguousReporter final : public nsIMemoryReporter
   ~VsizeMaxContiguousReporter() {}
 
 public:
-  NS_DECL_ISUPPORTS
+  NS_DECL_THREADSAFE_ISUPPORTS
 
   NS_IMETHOD CollectReports(nsIHandleReportCallback* aHandleReport,
                             nsISupports* aData, bool aAnonymize) override
@@ -1090,7 +1090,7 @@ class ResidentUniqueReporter final : public nsIMemoryReporter
   ~ResidentUniqueReporter() {}
 
 public:
-  NS_DECL_ISUPPORTS
+  NS_DECL_THREADSAFE_ISUPPORTS
 
   NS_IMETHOD CollectReports(nsIHandleReportCallback* aHandleReport,
                             nsISupports* aData, bool aAnonymize) override
@@ -1118,7 +1118,7 @@ class SystemHeapReporter final : public nsIMemoryReporter
   ~SystemHeapReporter() {}
 
 public:
-  NS_DECL_ISUPPORTS
+  NS_DECL_THREADSAFE_ISUPPORTS
 
   NS_IMETHOD CollectReports(nsIHandleReportCallback* aHandleReport,
                             nsISupports* aData, bool aAnonymize) override
@@ -1297,7 +1297,7 @@ class JemallocHeapReporter final : public nsIMemoryReporter
   ~JemallocHeapReporter() {}
 
 public:
-  NS_DECL_ISUPPORTS
+  NS_DECL_THREADSAFE_ISUPPORTS
 
   NS_IMETHOD CollectReports(nsIHandleReportCallback* aHandleReport,
                             nsISupports* aData, bool aAnonymize) override
@@ -1526,8 +1526,11 @@ nsMemoryReporterManager::Init()
   }
 #endif
 
+  // The reporters that walk the heap or the address space are the expensive
+  // ones, so they run on the thread pool while the others run on the main
+  // thread.
 #ifdef HAVE_JEMALLOC_STATS
-  RegisterStrongReporter(new JemallocHeapReporter());
+  RegisterStrongThreadSafeReporter(new JemallocHeapReporter());
 #endif
 
 #ifdef HAVE_VSIZE_AND_RESIDENT_REPORTERS
@@ -1536,7 +1539,7 @@ nsMemoryReporterManager::Init()
 #endif
 
 #ifdef HAVE_VSIZE_MAX_CONTIGUOUS_REPORTER
-  RegisterStrongReporter(new VsizeMaxContiguousReporter());
+  RegisterStrongThreadSafeReporter(new VsizeMaxContiguousReporter());
 #endif
 
 #ifdef HAVE_RESIDENT_PEAK_REPORTER
@@ -1544,7 +1547,7 @@ nsMemoryReporterManager::Init()
 #endif
 
 #ifdef HAVE_RESIDENT_UNIQUE_REPORTER
-  RegisterStrongReporter(new ResidentUniqueReporter());
+  RegisterStrongThreadSafeReporter(new ResidentUniqueReporter());
 #endif
 
 #ifdef HAVE_PAGE_FAULT_REPORTERS
@@ -1557,7 +1560,7 @@ nsMemoryReporterManager::Init()
 #endif
 
 #ifdef HAVE_SYSTEM_HEAP_REPORTER
-  RegisterStrongReporter(new SystemHeapReporter());
+  RegisterStrongThreadSafeReporter(new SystemHeapReporter());
 #endif
 
   RegisterStrongReporter(new AtomTablesReporter());
@@ -1577,7 +1580,7 @@ nsMemoryReporterManager::Init()
 #endif
 
 #ifdef XP_WIN
-  RegisterStrongReporter(new WindowsAddressSpaceReporter());
+  RegisterStrongThreadSafeReporter(new WindowsAddressSpaceReporter());
 #endif
 
 #ifdef XP_UNIX
@@ -1597,9 +1600,7 @@ nsMemoryReporterManager::nsMemoryReporterManager()
   , mNextGeneration(1)
   , mPendingProcessesState(nullptr)
   , mPendingReportersState(nullptr)
-#ifdef HAVE_JEMALLOC_STATS
   , mThreadPool(do_GetService(NS_STREAMTRANSPORTSERVICE_CONTRACTID))
-#endif
 {
 }
 
@@ -1758,9 +1759,56 @@ nsMemoryReporterManager::StartGettingReports()
   return NS_OK;
 }
 
+// Records the reports of a thread-safe reporter running on the thread pool,
+// so that they can be passed to the real callback on the main thread.
+class BufferedReportCallback final : public nsIHandleReportCallback
+{
+  ~BufferedReportCallback() {}
+
+  struct Report
+  {
+    nsCString mProcess;
+    nsCString mPath;
+    int32_t mKind;
+    int32_t mUnits;
+    int64_t mAmount;
+    nsCString mDescription;
+  };
+  nsTArray<Report> mReports;
+
+public:
+  NS_DECL_THREADSAFE_ISUPPORTS
+
+  NS_IMETHOD Callback(const nsACString& aProcess, const nsACString& aPath,
+                      int32_t aKind, int32_t aUnits, int64_t aAmount,
+                      const nsACString& aDescription,
+                      nsISupports* aData) override
+  {
+    Report* report = mReports.AppendElement();
+    report->mProcess = aProcess;
+    report->mPath = aPath;
+    report->mKind = aKind;
+    report->mUnits = aUnits;
+    report->mAmount = aAmount;
+    report->mDescription = aDescription;
+    return NS_OK;
+  }
+
+  void Replay(nsIHandleReportCallback* aHandleReport, nsISupports* aData)
+  {
+    MOZ_ASSERT(NS_IsMainThread());
+    for (const Report& report : mReports) {
+      aHandleReport->Callback(report.mProcess, report.mPath, report.mKind,
+                              report.mUnits, report.mAmount,
+                              report.mDescription, aData);
+    }
+  }
+};
+NS_IMPL_ISUPPORTS(BufferedReportCallback, nsIHandleReportCallback)
+
 void
 nsMemoryReporterManager::DispatchReporter(
-  nsIMemoryReporter* aReporter, bool aIsAsync,
+  nsIMemoryReporter* aReporter, ReporterKind aKind,
   nsIHandleReportCallback* aHandleReport,
   nsISupports* aHandleReportData,
   bool aAnonymize)
@@ -1770,14 +1818,50 @@ nsMemoryReporterManager::DispatchReporter(
   // Grab refs to everything used in the lambda function.
   RefPtr<nsMemoryReporterManager> self = this;
   nsCOMPtr<nsIMemoryReporter> reporter = aReporter;
+
+  if (aKind == ReporterKind::ThreadSafe && mThreadPool) {
+    // The callback is often implemented in JS, so it (and its data) must
+    // only be used and released on the main thread.
+    nsMainThreadPtrHandle<nsIHandleReportCallback> handleReport(
+      new nsMainThreadPtrHolder<nsIHandleReportCallback>(
+        "nsMemoryReporterManager::DispatchReporter", aHandleReport));
+    nsMainThreadPtrHandle<nsISupports> handleReportData(
+      new nsMainThreadPtrHolder<nsISupports>(
+        "nsMemoryReporterManager::DispatchReporter", aHandleReportData));
+
+    nsCOMPtr<nsIRunnable> event = NS_NewRunnableFunction(
+      "nsMemoryReporterManager::DispatchReporter",
+      [self, reporter, handleReport, handleReportData, aAnonymize]() {
+        MOZ_ASSERT(!NS_IsMainThread());
+
+        RefPtr<BufferedReportCallback> buffer = new BufferedReportCallback();
+        reporter->CollectReports(buffer, nullptr, aAnonymize);
+
+        nsCOMPtr<nsIRunnable> replayEvent = NS_NewRunnableFunction(
+          "nsMemoryReporterManager::DispatchReporter",
+          [self, buffer, handleReport, handleReportData]() {
+            buffer->Replay(handleReport, handleReportData);
+            self->EndReport();
+          });
+        Unused << NS_DispatchToMainThread(replayEvent);
+      });
+
+    if (NS_SUCCEEDED(mThreadPool->Dispatch(event, NS_DISPATCH_NORMAL))) {
+      mPendingReportersState->mReportsPending++;
+      return;
+    }
+    // Run it on the main thread like any other reporter instead.
+  }
+
   nsCOMPtr<nsIHandleReportCallback> handleReport = aHandleReport;
   nsCOMPtr<nsISupports> handleReportData = aHandleReportData;
+  bool isAsync = aKind == ReporterKind::Async;
 
   nsCOMPtr<nsIRunnable> event = NS_NewRunnableFunction(
     "nsMemoryReporterManager::DispatchReporter",
-    [self, reporter, aIsAsync, handleReport, handleReportData, aAnonymize]() {
+    [self, reporter, isAsync, handleReport, handleReportData, aAnonymize]() {
       reporter->CollectReports(handleReport, handleReportData, aAnonymize);
-      if (!aIsAsync) {
+      if (!isAsync) {
         self->EndReport();
       }
     });
@@ -2076,7 +2160,7 @@ CrashIfRefcountIsZero(nsISupports* aObj)
 
 nsresult
 nsMemoryReporterManager::RegisterReporterHelper(
-  nsIMemoryReporter* aReporter, bool aForce, bool aStrong, bool aIsAsync)
+  nsIMemoryReporter* aReporter, bool aForce, bool aStrong, ReporterKind aKind)
 {
   // This method is thread-safe.
   mozilla::MutexAutoLock autoLock(mMutex);
@@ -2103,7 +2187,7 @@ nsMemoryReporterManager::RegisterReporterHelper(
   //
   if (aStrong) {
     nsCOMPtr<nsIMemoryReporter> kungFuDeathGrip = aReporter;
-    mStrongReporters->Put(aReporter, aIsAsync);
+    mStrongReporters->Put(aReporter, aKind);
     CrashIfRefcountIsZero(aReporter);
   } else {
     CrashIfRefcountIsZero(aReporter);
@@ -2116,7 +2200,7 @@ nsMemoryReporterManager::RegisterReporterHelper(
       // CollectReports().
       return NS_ERROR_XPC_BAD_CONVERT_JS;
     }
-    mWeakReporters->Put(aReporter, aIsAsync);
+    mWeakReporters->Put(aReporter, aKind);
   }
 
   return NS_OK;
@@ -2127,7 +2211,7 @@ nsMemoryReporterManager::RegisterStrongReporter(nsIMemoryReporter* aReporter)
 {
   return RegisterReporterHelper(aReporter, /* force = */ false,
                                 /* strong = */ true,
-                                /* async = */ false);
+                                ReporterKind::Sync);
 }
 
 NS_IMETHODIMP
@@ -2135,7 +2219,7 @@ nsMemoryReporterManager::RegisterStrongAsyncReporter(nsIMemoryReporter* aReporte
 {
   return RegisterReporterHelper(aReporter, /* force = */ false,
                                 /* strong = */ true,
-                                /* async = */ true);
+                                ReporterKind::Async);
 }
 
 NS_IMETHODIMP
@@ -2143,7 +2227,7 @@ nsMemoryReporterManager::RegisterWeakReporter(nsIMemoryReporter* aReporter)
 {
   return RegisterReporterHelper(aReporter, /* force = */ false,
                                 /* strong = */ false,
-                                /* async = */ false);
+                                ReporterKind::Sync);
 }
 
 NS_IMETHODIMP
@@ -2151,7 +2235,21 @@ nsMemoryReporterManager::RegisterWeakAsyncReporter(nsIMemoryReporter* aReporter)
 {
   return RegisterReporterHelper(aReporter, /* force = */ false,
                                 /* strong = */ false,
-                                /* async = */ true);
+                                ReporterKind::Async);
+}
+
+NS_IMETHODIMP
+nsMemoryReporterManager::RegisterStrongThreadSafeReporter(
+  nsIMemoryReporter* aReporter)
+{
+  // JS-implemented reporters can only run on the main thread.
+  nsCOMPtr<nsIXPConnectWrappedJS> jsComponent = do_QueryInterface(aReporter);
+  if (jsComponent) {
+    return NS_ERROR_XPC_BAD_CONVERT_JS;
+  }
+  return RegisterReporterHelper(aReporter, /* force = */ false,
+                                /* strong = */ true,
+                                ReporterKind::ThreadSafe);
 }
 
 NS_IMETHODIMP
@@ -2160,7 +2258,7 @@ nsMemoryReporterManager::RegisterStrongReporterEvenIfBlocked(
 {
   return RegisterReporterHelper(aReporter, /* force = */ true,
                                 /* strong = */ true,
-                                /* async = */ false);
+                                ReporterKind::Sync);
 }
 
 NS_IMETHODIMP
@@ -2417,6 +2515,45 @@ nsMemoryReporterManager::GetHeapAllocatedAsync(nsIHeapAllocatedCallback *aCallba
 #endif
 }
 
+NS_IMETHODIMP
+nsMemoryReporterManager::GetSummaryAsync(nsIMemorySummaryCallback* aCallback)
+{
+  if (!mThreadPool) {
+    return NS_ERROR_UNEXPECTED;
+  }
+
+  RefPtr<nsIMemoryReporterManager> self{this};
+  nsMainThreadPtrHandle<nsIMemorySummaryCallback> mainThreadCallback(
+    new nsMainThreadPtrHolder<nsIMemorySummaryCallback>("MemorySummaryCallback",
+                                                        aCallback));
+
+  nsCOMPtr<nsIRunnable> getSummaryRunnable = NS_NewRunnableFunction(
+    "nsMemoryReporterManager::GetSummaryAsync",
+    [self, mainThreadCallback]() mutable {
+      MOZ_ASSERT(!NS_IsMainThread());
+
+      int64_t heapAllocated;
+      if (NS_FAILED(self->GetHeapAllocated(&heapAllocated))) {
+        heapAllocated = -1;
+      }
+      int64_t resident;
+      if (NS_FAILED(self->GetResidentFast(&resident))) {
+        resident = -1;
+      }
+
+      nsCOMPtr<nsIRunnable> resultCallbackRunnable = NS_NewRunnableFunction(
+        "nsMemoryReporterManager::GetSummaryAsync",
+        [mainThreadCallback, heapAllocated, resident]() mutable {
+          MOZ_ASSERT(NS_IsMainThread());
+          mainThreadCallback->Callback(heapAllocated, resident);
+        });  // resultCallbackRunnable.
+
+      Unused << NS_DispatchToMainThread(resultCallbackRunnable);
+    }); // getSummaryRunnable.
+
+  return mThreadPool->Dispatch(getSummaryRunnable, NS_DISPATCH_NORMAL);
+}
+
 // This has UNITS_PERCENTAGE, so it is multiplied by 100x.
 NS_IMETHODIMP
 nsMemoryReporterManager::GetHeapOverheadFraction(int64_t* aAmount)
@@ -2696,6 +2833,16 @@ RegisterStrongAsyncMemoryReporter(nsIMemoryReporter* aReporter)
   return mgr->RegisterStrongAsyncReporter(reporter);
 }
 
+nsresult
+RegisterStrongThreadSafeMemoryReporter(nsIMemoryReporter* aReporter)
+{
+  // Hold a strong reference to the argument to make sure it gets released if
+  // we return early below.
+  nsCOMPtr<nsIMemoryReporter> reporter = aReporter;
+  GET_MEMORY_REPORTER_MANAGER(mgr)
+  return mgr->RegisterStrongThreadSafeReporter(reporter);
+}
+
 nsresult
 RegisterWeakMemoryReporter(nsIMemoryReporter* aReporter)
 {
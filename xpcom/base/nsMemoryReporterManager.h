@@ -43,8 +43,20 @@ public:
     return static_cast<nsMemoryReporterManager*>(imgr.get());
   }
 
-  typedef nsDataHashtable<nsRefPtrHashKey<nsIMemoryReporter>, bool> StrongReportersTable;
-  typedef nsDataHashtable<nsPtrHashKey<nsIMemoryReporter>, bool> WeakReportersTable;
+  // How GetReportsForThisProcessExtended() runs a registered reporter.
+  enum class ReporterKind : uint8_t
+  {
+    // On the main thread; the report is done when CollectReports() returns.
+    Sync,
+    // On the main thread; the reporter calls EndReport() when it is done.
+    Async,
+    // On mThreadPool, concurrently with the other reporters; the reports are
+    // buffered and handled on the main thread.
+    ThreadSafe
+  };
+
+  typedef nsDataHashtable<nsRefPtrHashKey<nsIMemoryReporter>, ReporterKind> StrongReportersTable;
+  typedef nsDataHashtable<nsPtrHashKey<nsIMemoryReporter>, ReporterKind> WeakReportersTable;
 
   // Inter-process memory reporting proceeds as follows.
   //
@@ -187,13 +199,13 @@ public:
 private:
   MOZ_MUST_USE nsresult
   RegisterReporterHelper(nsIMemoryReporter* aReporter,
-                         bool aForce, bool aStrongRef, bool aIsAsync);
+                         bool aForce, bool aStrongRef, ReporterKind aKind);
 
   MOZ_MUST_USE nsresult StartGettingReports();
   // No MOZ_MUST_USE here because ignoring the result is common and reasonable.
   nsresult FinishReporting();
 
-  void DispatchReporter(nsIMemoryReporter* aReporter, bool aIsAsync,
+  void DispatchReporter(nsIMemoryReporter* aReporter, ReporterKind aKind,
                         nsIHandleReportCallback* aHandleReport,
                         nsISupports* aHandleReportData,
                         bool aAnonymize);
@@ -277,7 +289,8 @@ private:
   // This is reinitialized each time a call to GetReports is initiated.
   PendingReportersState* mPendingReportersState;
 
-  // Used in GetHeapAllocatedAsync() to run jemalloc_stats async.
+  // Used to run thread-safe reporters, and in GetHeapAllocatedAsync() and
+  // GetSummaryAsync() to measure off the main thread.
   nsCOMPtr<nsIEventTarget> mThreadPool;
 
   PendingProcessesState* GetStateForGeneration(uint32_t aGeneration);
@@ -0,0 +1,190 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "mozilla/ArenaTArray.h"
+
+#include "mozilla/MathAlgorithms.h"
+#include "mozilla/PodOperations.h"
+#include "nsThreadUtils.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+namespace mozilla {
+
+// The innermost AutoTArrayArena.  Only used on the main thread.
+static AutoTArrayArena* sCurrentArena = nullptr;
+
+AutoTArrayArena::AutoTArrayArena()
+  : mPrevious(sCurrentArena)
+#ifdef DEBUG
+  , mLiveBlocks(0)
+#endif
+{
+  static_assert(sizeof(BlockHeader) % 8 == 0,
+                "BlockHeader must keep the arena's alignment");
+  MOZ_ASSERT(NS_IsMainThread());
+  PodArrayZero(mFreeLists);
+  sCurrentArena = this;
+}
+
+AutoTArrayArena::~AutoTArrayArena()
+{
+  MOZ_ASSERT(sCurrentArena == this,
+             "AutoTArrayArenas must be destroyed in reverse order");
+  MOZ_ASSERT(mLiveBlocks == 0,
+             "An ArenaTArray's storage outlived its AutoTArrayArena");
+  sCurrentArena = mPrevious;
+}
+
+#ifdef DEBUG
+/* static */ bool
+AutoTArrayArena::IsAlive(AutoTArrayArena* aArena)
+{
+  for (AutoTArrayArena* arena = sCurrentArena; arena; arena = arena->mPrevious) {
+    if (arena == aArena) {
+      return true;
+    }
+  }
+  return false;
+}
+#endif
+
+/* static */ size_t
+AutoTArrayArena::SizeClass(size_t aSize)
+{
+  MOZ_ASSERT(aSize <= kMaxBlockSize);
+  if (aSize <= (size_t(1) << kMinBlockSizeLog2)) {
+    return 0;
+  }
+  return CeilingLog2(aSize) - kMinBlockSizeLog2;
+}
+
+void*
+AutoTArrayArena::Allocate(size_t aSize)
+{
+  size_t sizeClass = SizeClass(aSize);
+  BlockHeader* header = mFreeLists[sizeClass];
+  if (header) {
+    mFreeLists[sizeClass] = *reinterpret_cast<BlockHeader**>(header + 1);
+  } else {
+    size_t capacity = size_t(1) << (sizeClass + kMinBlockSizeLog2);
+    header = static_cast<BlockHeader*>(
+      mArena.Allocate(sizeof(BlockHeader) + capacity, fallible));
+    if (!header) {
+      return nullptr;
+    }
+    header->mArena = this;
+    header->mCapacity = capacity;
+  }
+
+#ifdef DEBUG
+  mLiveBlocks++;
+#endif
+  return header + 1;
+}
+
+void
+AutoTArrayArena::Release(BlockHeader* aHeader)
+{
+  MOZ_ASSERT(aHeader->mArena == this);
+
+  size_t sizeClass = SizeClass(aHeader->mCapacity);
+  *reinterpret_cast<BlockHeader**>(aHeader + 1) = mFreeLists[sizeClass];
+  mFreeLists[sizeClass] = aHeader;
+
+#ifdef DEBUG
+  MOZ_ASSERT(mLiveBlocks > 0);
+  mLiveBlocks--;
+#endif
+}
+
+/* static */ void*
+AutoTArrayArena::AllocateIn(AutoTArrayArena* aArena, size_t aSize)
+{
+  if (aArena && aSize <= kMaxBlockSize) {
+    return aArena->Allocate(aSize);
+  }
+
+  if (aSize > SIZE_MAX - sizeof(BlockHeader)) {
+    return nullptr;
+  }
+  BlockHeader* header =
+    static_cast<BlockHeader*>(malloc(sizeof(BlockHeader) + aSize));
+  if (!header) {
+    return nullptr;
+  }
+  header->mArena = nullptr;
+  header->mCapacity = aSize;
+  return header + 1;
+}
+
+/* static */ void*
+AutoTArrayArena::Malloc(size_t aSize)
+{
+  return AllocateIn(NS_IsMainThread() ? sCurrentArena : nullptr, aSize);
+}
+
+/* static */ void*
+AutoTArrayArena::Realloc(void* aPtr, size_t aSize)
+{
+  if (!aPtr) {
+    return Malloc(aSize);
+  }
+
+  BlockHeader* header = static_cast<BlockHeader*>(aPtr) - 1;
+  if (!header->mArena) {
+    if (aSize > SIZE_MAX - sizeof(BlockHeader)) {
+      return nullptr;
+    }
+    header =
+      static_cast<BlockHeader*>(realloc(header, sizeof(BlockHeader) + aSize));
+    if (!header) {
+      return nullptr;
+    }
+    header->mCapacity = aSize;
+    return header + 1;
+  }
+
+  MOZ_ASSERT(NS_IsMainThread());
+  MOZ_ASSERT(IsAlive(header->mArena),
+             "An ArenaTArray's storage outlived its AutoTArrayArena");
+
+  // Blocks are never shrunk, and grow in place up to their size class.
+  if (aSize <= header->mCapacity) {
+    return aPtr;
+  }
+
+  // Stay in the same arena, even if a nested one was created since.
+  void* newPtr = AllocateIn(header->mArena, aSize);
+  if (!newPtr) {
+    return nullptr;
+  }
+  memcpy(newPtr, aPtr, header->mCapacity);
+  header->mArena->Release(header);
+  return newPtr;
+}
+
+/* static */ void
+AutoTArrayArena::Free(void* aPtr)
+{
+  if (!aPtr) {
+    return;
+  }
+
+  BlockHeader* header = static_cast<BlockHeader*>(aPtr) - 1;
+  if (!header->mArena) {
+    free(header);
+    return;
+  }
+
+  MOZ_ASSERT(NS_IsMainThread());
+  MOZ_ASSERT(IsAlive(header->mArena),
+             "An ArenaTArray's storage outlived its AutoTArrayArena");
+  header->mArena->Release(header);
+}
+
+} // namespace mozilla
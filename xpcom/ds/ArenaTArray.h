@@ -0,0 +1,210 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef mozilla_ArenaTArray_h
+#define mozilla_ArenaTArray_h
+
+#include "mozilla/ArenaAllocator.h"
+#include "mozilla/Attributes.h"
+#include "mozilla/Move.h"
+#include "nsTArray.h"
+
+namespace mozilla {
+
+/**
+ * Backs the storage of ArenaTArrays created on the main thread while it is
+ * alive with an ArenaAllocator, so that the short-lived arrays of a phase
+ * such as a reflow or a paint don't go through malloc and are all released at
+ * once at its end.
+ *
+ * Storage is handed out in power of two size classes, matching how nsTArray
+ * grows, and freed blocks are reused by later allocations of the same class.
+ * Storage larger than the biggest size class, or requested off the main
+ * thread or without an active AutoTArrayArena, comes from malloc.
+ *
+ * AutoTArrayArenas nest; new storage comes from the innermost one, and grown
+ * storage stays in the arena it came from.  Every array using an arena must be
+ * destroyed (or have its storage freed) before the arena is, which is checked
+ * in debug builds.
+ *
+ * Example usage:
+ *
+ * {
+ *   AutoTArrayArena arena;
+ *   ArenaTArray<nsIFrame*> frames;
+ *   CollectFrames(frames);
+ *   ...
+ * } // All the storage of |frames| is released here.
+ */
+class MOZ_STACK_CLASS AutoTArrayArena final
+{
+public:
+  AutoTArrayArena();
+  ~AutoTArrayArena();
+
+  AutoTArrayArena(const AutoTArrayArena&) = delete;
+  AutoTArrayArena& operator=(const AutoTArrayArena&) = delete;
+
+  // These behave like malloc, realloc and free, and may be passed blocks
+  // allocated by any AutoTArrayArena that is still alive.
+  static void* Malloc(size_t aSize);
+  static void* Realloc(void* aPtr, size_t aSize);
+  static void Free(void* aPtr);
+
+  size_t SizeOfExcludingThis(MallocSizeOf aMallocSizeOf) const
+  {
+    return mArena.SizeOfExcludingThis(aMallocSizeOf);
+  }
+
+private:
+  // Precedes every block, inside or outside of an arena.
+  struct BlockHeader
+  {
+    // The arena the block belongs to, or nullptr if it was malloc'ed.
+    AutoTArrayArena* mArena;
+    size_t mCapacity;
+  };
+
+  static const size_t kMinBlockSizeLog2 = 4;
+  static const size_t kMaxBlockSizeLog2 = 13;
+  static const size_t kMaxBlockSize = size_t(1) << kMaxBlockSizeLog2;
+  static const size_t kNumSizeClasses = kMaxBlockSizeLog2 - kMinBlockSizeLog2 + 1;
+
+  static size_t SizeClass(size_t aSize);
+
+  // Allocate from |aArena|, or from malloc if it is null or |aSize| is too
+  // big for it.
+  static void* AllocateIn(AutoTArrayArena* aArena, size_t aSize);
+
+  void* Allocate(size_t aSize);
+  void Release(BlockHeader* aHeader);
+
+#ifdef DEBUG
+  // Whether |aArena| is alive, i.e. is the current arena or one it nests in.
+  static bool IsAlive(AutoTArrayArena* aArena);
+#endif
+
+  ArenaAllocator<32768, 8> mArena;
+  // Singly linked through the first word of each free block.
+  BlockHeader* mFreeLists[kNumSizeClasses];
+  AutoTArrayArena* mPrevious;
+#ifdef DEBUG
+  size_t mLiveBlocks;
+#endif
+};
+
+} // namespace mozilla
+
+struct nsTArrayArenaFallibleAllocator : nsTArrayFallibleAllocatorBase
+{
+  static void* Malloc(size_t aSize)
+  {
+    return mozilla::AutoTArrayArena::Malloc(aSize);
+  }
+
+  static void* Realloc(void* aPtr, size_t aSize)
+  {
+    return mozilla::AutoTArrayArena::Realloc(aPtr, aSize);
+  }
+
+  static void Free(void* aPtr) { mozilla::AutoTArrayArena::Free(aPtr); }
+  static void SizeTooBig(size_t) {}
+};
+
+struct nsTArrayArenaInfallibleAllocator : nsTArrayInfallibleAllocatorBase
+{
+  static void* Malloc(size_t aSize)
+  {
+    void* ptr = mozilla::AutoTArrayArena::Malloc(aSize);
+    if (MOZ_UNLIKELY(!ptr)) {
+      NS_ABORT_OOM(aSize);
+    }
+    return ptr;
+  }
+
+  static void* Realloc(void* aPtr, size_t aSize)
+  {
+    void* newptr = mozilla::AutoTArrayArena::Realloc(aPtr, aSize);
+    if (MOZ_UNLIKELY(!newptr && aSize)) {
+      NS_ABORT_OOM(aSize);
+    }
+    return newptr;
+  }
+
+  static void Free(void* aPtr) { mozilla::AutoTArrayArena::Free(aPtr); }
+  static void SizeTooBig(size_t aSize) { NS_ABORT_OOM(aSize); }
+};
+
+template<>
+struct nsTArray_FallibleAllocator<nsTArrayArenaFallibleAllocator>
+{
+  typedef nsTArrayArenaFallibleAllocator Type;
+};
+
+template<>
+struct nsTArray_FallibleAllocator<nsTArrayArenaInfallibleAllocator>
+{
+  typedef nsTArrayArenaFallibleAllocator Type;
+};
+
+namespace mozilla {
+
+/**
+ * An infallible array whose storage comes from the innermost AutoTArrayArena
+ * when there is one.  Moving from or to an array with another allocator copies
+ * the elements.
+ */
+template<class E>
+class ArenaTArray : public nsTArray_Impl<E, nsTArrayArenaInfallibleAllocator>
+{
+public:
+  typedef nsTArray_Impl<E, nsTArrayArenaInfallibleAllocator> base_type;
+  typedef ArenaTArray<E>                                     self_type;
+  typedef typename base_type::size_type                      size_type;
+
+  ArenaTArray() {}
+  explicit ArenaTArray(size_type aCapacity) : base_type(aCapacity) {}
+  explicit ArenaTArray(const ArenaTArray& aOther) : base_type(aOther) {}
+  MOZ_IMPLICIT ArenaTArray(ArenaTArray&& aOther) : base_type(Move(aOther)) {}
+
+  template<class Allocator>
+  explicit ArenaTArray(const nsTArray_Impl<E, Allocator>& aOther)
+    : base_type(aOther)
+  {
+  }
+  template<class Allocator>
+  explicit ArenaTArray(nsTArray_Impl<E, Allocator>&& aOther)
+    : base_type(Move(aOther))
+  {
+  }
+
+  self_type& operator=(const self_type& aOther)
+  {
+    base_type::operator=(aOther);
+    return *this;
+  }
+  template<class Allocator>
+  self_type& operator=(const nsTArray_Impl<E, Allocator>& aOther)
+  {
+    base_type::operator=(aOther);
+    return *this;
+  }
+  self_type& operator=(self_type&& aOther)
+  {
+    base_type::operator=(Move(aOther));
+    return *this;
+  }
+  template<class Allocator>
+  self_type& operator=(nsTArray_Impl<E, Allocator>&& aOther)
+  {
+    base_type::operator=(Move(aOther));
+    return *this;
+  }
+};
+
+} // namespace mozilla
+
+#endif // mozilla_ArenaTArray_h
@@ -148,6 +148,82 @@ int LookupString(const unsigned char* graph, size_t length, const char* key,
   return mozilla::Dafsa::kKeyNotFound;  // No match
 }
 
+// Advance the walk at pos by the character c. in_label tells whether pos is
+// within the label of a node, rather than at the offsets of its children.
+// Returns false, and leaves pos at end, if no string continues with c.
+bool Advance(const unsigned char** pos, const unsigned char* end,
+             bool* in_label, char c) {
+  // Bytes outside of this range never encode a character.
+  const unsigned char uc = static_cast<unsigned char>(c);
+  if (uc >= 0x20 && uc < 0x80) {
+    if (*in_label) {
+      MOZ_ASSERT(*pos < end);
+      if ((**pos & 0x7F) == uc) {
+        *in_label = !IsEOL(*pos, end);
+        ++*pos;
+        return true;
+      }
+    } else {
+      const unsigned char* offset = *pos;
+      while (GetNextOffset(pos, end, &offset)) {
+        if ((*offset & 0x7F) == uc) {
+          *in_label = !IsEOL(offset, end);
+          *pos = offset + 1;
+          return true;
+        }
+      }
+    }
+  }
+  *pos = end;
+  *in_label = false;
+  return false;
+}
+
+// Read the return value of the string the walk at pos has consumed.
+// Returns kKeyNotFound if that string isn't in the graph.
+int GetCurrentValue(const unsigned char* pos, const unsigned char* end,
+                    bool in_label) {
+  int return_value = mozilla::Dafsa::kKeyNotFound;
+  if (in_label) {
+    GetReturnValue(pos, end, &return_value);
+    return return_value;
+  }
+  // Look for a child holding a return value, without moving pos, which
+  // Advance() still has to go through all the children from.
+  const unsigned char* offset = pos;
+  while (GetNextOffset(&pos, end, &offset)) {
+    if (GetReturnValue(offset, end, &return_value))
+      break;
+  }
+  return return_value;
+}
+
+// Lookup the suffixes of a key starting after a separator, or the whole key,
+// in a byte array generated by make_dafsa.py from reversed strings.
+// The rule type of the longest one is returned if one is found, otherwise
+// kKeyNotFound is returned.
+int LookupLongestReversedSuffix(const unsigned char* graph, size_t length,
+                                const char* key, size_t key_length,
+                                char separator, size_t* suffix_length) {
+  const unsigned char* pos = graph;
+  const unsigned char* end = graph + length;
+  bool in_label = false;
+  int result = mozilla::Dafsa::kKeyNotFound;
+  for (size_t i = key_length; ; --i) {
+    // key[i..key_length) has been consumed.
+    if (i < key_length && (i == 0 || key[i - 1] == separator)) {
+      int return_value = GetCurrentValue(pos, end, in_label);
+      if (return_value != mozilla::Dafsa::kKeyNotFound) {
+        result = return_value;
+        *suffix_length = key_length - i;
+      }
+    }
+    if (i == 0 || !Advance(&pos, end, &in_label, key[i - 1]))
+      break;
+  }
+  return result;
+}
+
 namespace mozilla {
 
 int Dafsa::Lookup(const nsACString& aKey) const
@@ -156,4 +232,13 @@ int Dafsa::Lookup(const nsACString& aKey) const
                       aKey.BeginReading(), aKey.Length());
 }
 
+int Dafsa::LookupLongestReversedSuffix(const nsACString& aKey,
+                                       char aSeparator,
+                                       size_t* aSuffixLength) const
+{
+  return ::LookupLongestReversedSuffix(mData.Elements(), mData.Length(),
+                                       aKey.BeginReading(), aKey.Length(),
+                                       aSeparator, aSuffixLength);
+}
+
 } // namespace mozilla
@@ -44,6 +44,21 @@ public:
    */
   int Lookup(const nsACString& aKey) const;
 
+  /**
+   * Searches a DAFSA generated from reversed strings (see `make_dafsa.py`)
+   * for the longest suffix of the given string that is either all of it or
+   * starts right after a separator. All those suffixes are looked up in a
+   * single walk from the end of the string, which is much cheaper than
+   * looking each of them up on its own.
+   *
+   * @param aKey The string to search the suffixes of.
+   * @param aSeparator The character the suffixes must start after.
+   * @param aSuffixLength Out param, the length of the suffix found, if any.
+   * @returns kKeyNotFound if not found, otherwise the tag of the suffix.
+   */
+  int LookupLongestReversedSuffix(const nsACString& aKey, char aSeparator,
+                                  size_t* aSuffixLength) const;
+
   static const int kKeyNotFound;
 
 private:
@@ -18,6 +18,14 @@
 #include "mozilla/MemoryReporting.h"
 #include "mozilla/ChaosMode.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+# define PL_DHASH_GROUPS_SSE2 1
+# include <emmintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+# define PL_DHASH_GROUPS_NEON 1
+# include <arm_neon.h>
+#endif
+
 using namespace mozilla;
 
 #ifdef DEBUG
@@ -67,7 +75,8 @@ public:
 /* static */ PLDHashNumber
 PLDHashTable::HashStringKey(const void* aKey)
 {
-  return HashString(static_cast<const char*>(aKey));
+  const char* key = static_cast<const char*>(aKey);
+  return HashBytes(key, strlen(key));
 }
 
 /* static */ PLDHashNumber
@@ -123,11 +132,17 @@ PLDHashTable::StubOps()
   return &gStubOps;
 }
 
+typedef PLDHashTable::Probing Probing;
+
+// With Probing::Groups the entry store starts with one control byte per
+// entry.
 static bool
-SizeOfEntryStore(uint32_t aCapacity, uint32_t aEntrySize, uint32_t* aNbytes)
+SizeOfEntryStore(uint32_t aCapacity, uint32_t aEntrySize, Probing aProbing,
+                 uint32_t* aNbytes)
 {
-  uint64_t nbytes64 = uint64_t(aCapacity) * uint64_t(aEntrySize);
-  *aNbytes = aCapacity * aEntrySize;
+  uint32_t slotSize = aEntrySize + (aProbing == Probing::Groups ? 1 : 0);
+  uint64_t nbytes64 = uint64_t(aCapacity) * uint64_t(slotSize);
+  *aNbytes = aCapacity * slotSize;
   return uint64_t(*aNbytes) == nbytes64;   // returns false on overflow
 }
 
@@ -136,36 +151,58 @@ SizeOfEntryStore(uint32_t aCapacity, uint32_t aEntrySize, uint32_t* aNbytes)
 // (i.e. if ChangeTable() fails). The table slows down drastically if the
 // secondary max is too close to 1, but 0.96875 gives only a slight slowdown
 // while allowing 1.3x more elements.
+//
+// Group probing only compares the entries whose control byte matches, so it
+// stays fast up to a higher load. Its lookups stop at the first group with a
+// free entry, so even an overloaded table must keep at least one.
 static inline uint32_t
-MaxLoad(uint32_t aCapacity)
+MaxLoad(uint32_t aCapacity, Probing aProbing)
 {
-  return aCapacity - (aCapacity >> 2);  // == aCapacity * 0.75
+  if (aProbing == Probing::Groups) {
+    return aCapacity - (aCapacity >> 3);  // == aCapacity * 0.875
+  }
+  return aCapacity - (aCapacity >> 2);    // == aCapacity * 0.75
 }
 static inline uint32_t
-MaxLoadOnGrowthFailure(uint32_t aCapacity)
+MaxLoadOnGrowthFailure(uint32_t aCapacity, Probing aProbing)
 {
-  return aCapacity - (aCapacity >> 5);  // == aCapacity * 0.96875
+  if (aProbing == Probing::Groups) {
+    return aCapacity - 1 - (aCapacity >> 5);
+  }
+  return aCapacity - (aCapacity >> 5);    // == aCapacity * 0.96875
 }
 static inline uint32_t
 MinLoad(uint32_t aCapacity)
 {
-  return aCapacity >> 2;                // == aCapacity * 0.25
+  return aCapacity >> 2;                  // == aCapacity * 0.25
+}
+
+static inline uint32_t
+MinCapacity(Probing aProbing)
+{
+  return aProbing == Probing::Groups ? PLDHashTable::kGroupWidth
+                                     : PLDHashTable::kMinCapacity;
 }
 
 // Compute the minimum capacity (and the Log2 of that capacity) for a table
 // containing |aLength| elements while respecting the following contraints:
-// - table must be at most 75% full;
+// - table must be at most 75% full (87.5% with group probing);
 // - capacity must be a power of two;
 // - capacity cannot be too small.
 static inline void
-BestCapacity(uint32_t aLength, uint32_t* aCapacityOut,
+BestCapacity(uint32_t aLength, Probing aProbing, uint32_t* aCapacityOut,
              uint32_t* aLog2CapacityOut)
 {
   // Compute the smallest capacity allowing |aLength| elements to be inserted
   // without rehashing.
-  uint32_t capacity = (aLength * 4 + (3 - 1)) / 3; // == ceil(aLength * 4 / 3)
-  if (capacity < PLDHashTable::kMinCapacity) {
-    capacity = PLDHashTable::kMinCapacity;
+  uint32_t capacity;
+  if (aProbing == Probing::Groups) {
+    capacity = (aLength * 8 + (7 - 1)) / 7; // == ceil(aLength * 8 / 7)
+  } else {
+    capacity = (aLength * 4 + (3 - 1)) / 3; // == ceil(aLength * 4 / 3)
+  }
+  if (capacity < MinCapacity(aProbing)) {
+    capacity = MinCapacity(aProbing);
   }
 
   // Round up capacity to next power-of-two.
@@ -178,17 +215,18 @@ BestCapacity(uint32_t aLength, uint32_t* aCapacityOut,
 }
 
 /* static */ MOZ_ALWAYS_INLINE uint32_t
-PLDHashTable::HashShift(uint32_t aEntrySize, uint32_t aLength)
+PLDHashTable::HashShift(uint32_t aEntrySize, uint32_t aLength,
+                        Probing aProbing)
 {
   if (aLength > kMaxInitialLength) {
     MOZ_CRASH("Initial length is too large");
   }
 
   uint32_t capacity, log2;
-  BestCapacity(aLength, &capacity, &log2);
+  BestCapacity(aLength, aProbing, &capacity, &log2);
 
   uint32_t nbytes;
-  if (!SizeOfEntryStore(capacity, aEntrySize, &nbytes)) {
+  if (!SizeOfEntryStore(capacity, aEntrySize, aProbing, &nbytes)) {
     MOZ_CRASH("Initial entry store size is too large");
   }
 
@@ -197,9 +235,10 @@ PLDHashTable::HashShift(uint32_t aEntrySize, uint32_t aLength)
 }
 
 PLDHashTable::PLDHashTable(const PLDHashTableOps* aOps, uint32_t aEntrySize,
-                           uint32_t aLength)
+                           uint32_t aLength, Probing aProbing)
   : mOps(aOps)
-  , mHashShift(HashShift(aEntrySize, aLength))
+  , mHashShift(HashShift(aEntrySize, aLength, aProbing))
+  , mProbing(aProbing)
   , mEntrySize(aEntrySize)
   , mEntryCount(0)
   , mRemovedCount(0)
@@ -220,12 +259,13 @@ PLDHashTable::operator=(PLDHashTable&& aOther)
   // Destruct |this|.
   this->~PLDHashTable();
 
-  // |mOps| and |mEntrySize| are const so we can't assign them. Instead, we
-  // require that they are equal. The justification for this is that they're
-  // conceptually part of the type -- indeed, if PLDHashTable was a templated
-  // type like nsTHashtable, they *would* be part of the type -- so it only
-  // makes sense to assign in cases where they match.
+  // |mOps|, |mProbing| and |mEntrySize| are const so we can't assign them.
+  // Instead, we require that they are equal. The justification for this is
+  // that they're conceptually part of the type -- indeed, if PLDHashTable was
+  // a templated type like nsTHashtable, they *would* be part of the type -- so
+  // it only makes sense to assign in cases where they match.
   MOZ_RELEASE_ASSERT(mOps == aOther.mOps);
+  MOZ_RELEASE_ASSERT(mProbing == aOther.mProbing);
   MOZ_RELEASE_ASSERT(mEntrySize == aOther.mEntrySize);
 
   // Move non-const pieces over.
@@ -299,6 +339,147 @@ PLDHashTable::AddressEntry(uint32_t aIndex)
     mEntryStore.Get() + aIndex * mEntrySize);
 }
 
+// Group probing keeps a control byte per entry: kCtrlEmpty for free entries,
+// kCtrlDeleted for removed ones, and for live entries the 7 bits of their
+// hash just below the ones used by Hash1(). Groups are the aligned runs of
+// kGroupWidth control bytes, and are probed quadratically from the group
+// Hash1() falls in. Because the number of groups is a power of two, the
+// probe sequence visits every group.
+static const uint8_t kCtrlEmpty = 0x80;
+static const uint8_t kCtrlDeleted = 0xfe;
+
+static MOZ_ALWAYS_INLINE uint8_t
+GroupTag(PLDHashNumber aKeyHash, int16_t aHashShift)
+{
+  return (aHashShift >= 7 ? aKeyHash >> (aHashShift - 7) : aKeyHash) & 0x7f;
+}
+
+namespace {
+
+// A set of entries of a group, as returned by the Group::Match* methods.
+class GroupMask
+{
+  uint64_t mBits;
+
+public:
+  // The number of bits per entry in mBits.
+#if defined(PL_DHASH_GROUPS_NEON)
+  static const uint32_t kShift = 2;
+#else
+  static const uint32_t kShift = 0;
+#endif
+
+  explicit GroupMask(uint64_t aBits) : mBits(aBits) {}
+
+  explicit operator bool() const { return mBits != 0; }
+
+  // The index in the group of the first entry of the set.
+  uint32_t Lowest() const
+  {
+    return CountTrailingZeroes64(mBits) >> kShift;
+  }
+
+  void RemoveLowest() { mBits &= mBits - 1; }
+};
+
+// The control bytes of one group.
+class Group
+{
+#if defined(PL_DHASH_GROUPS_SSE2)
+  __m128i mCtrl;
+
+  GroupMask Mask(__m128i aMatches) const
+  {
+    return GroupMask(uint32_t(_mm_movemask_epi8(aMatches)));
+  }
+#elif defined(PL_DHASH_GROUPS_NEON)
+  uint8x16_t mCtrl;
+
+  // Narrow the comparison to 4 bits per byte, and keep one of them.
+  GroupMask Mask(uint8x16_t aMatches) const
+  {
+    uint8x8_t narrowed = vshrn_n_u16(vreinterpretq_u16_u8(aMatches), 4);
+    return GroupMask(vget_lane_u64(vreinterpret_u64_u8(narrowed), 0) &
+                     UINT64_C(0x8888888888888888));
+  }
+#else
+  const uint8_t* mCtrl;
+
+  template <typename Predicate>
+  GroupMask Mask(Predicate aPredicate) const
+  {
+    uint64_t bits = 0;
+    for (uint32_t i = 0; i < PLDHashTable::kGroupWidth; i++) {
+      if (aPredicate(mCtrl[i])) {
+        bits |= uint64_t(1) << i;
+      }
+    }
+    return GroupMask(bits);
+  }
+#endif
+
+public:
+#if defined(PL_DHASH_GROUPS_SSE2)
+  explicit Group(const uint8_t* aCtrl)
+    : mCtrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(aCtrl)))
+  {}
+
+  GroupMask Match(uint8_t aTag) const
+  {
+    return Mask(_mm_cmpeq_epi8(mCtrl, _mm_set1_epi8(char(aTag))));
+  }
+  GroupMask MatchEmpty() const
+  {
+    return Mask(_mm_cmpeq_epi8(mCtrl, _mm_set1_epi8(char(kCtrlEmpty))));
+  }
+  // Free and removed control bytes are the ones with the high bit set.
+  GroupMask MatchEmptyOrDeleted() const { return Mask(mCtrl); }
+#elif defined(PL_DHASH_GROUPS_NEON)
+  explicit Group(const uint8_t* aCtrl) : mCtrl(vld1q_u8(aCtrl)) {}
+
+  GroupMask Match(uint8_t aTag) const
+  {
+    return Mask(vceqq_u8(mCtrl, vdupq_n_u8(aTag)));
+  }
+  GroupMask MatchEmpty() const
+  {
+    return Mask(vceqq_u8(mCtrl, vdupq_n_u8(kCtrlEmpty)));
+  }
+  GroupMask MatchEmptyOrDeleted() const
+  {
+    return Mask(vcltzq_s8(vreinterpretq_s8_u8(mCtrl)));
+  }
+#else
+  explicit Group(const uint8_t* aCtrl) : mCtrl(aCtrl) {}
+
+  GroupMask Match(uint8_t aTag) const
+  {
+    return Mask([aTag](uint8_t aCtrl) { return aCtrl == aTag; });
+  }
+  GroupMask MatchEmpty() const
+  {
+    return Mask([](uint8_t aCtrl) { return aCtrl == kCtrlEmpty; });
+  }
+  GroupMask MatchEmptyOrDeleted() const
+  {
+    return Mask([](uint8_t aCtrl) { return (aCtrl & 0x80) != 0; });
+  }
+#endif
+};
+
+} // namespace
+
+void
+PLDHashTable::InitEntryStore(char* aEntryStore, uint32_t aCapacity)
+{
+  uint32_t nbytes;
+  MOZ_ALWAYS_TRUE(SizeOfEntryStore(aCapacity, mEntrySize, mProbing, &nbytes));
+  memset(aEntryStore, 0, nbytes);
+  if (mProbing == Probing::Groups) {
+    memset(aEntryStore, kCtrlEmpty, aCapacity);
+  }
+}
+
 PLDHashTable::~PLDHashTable()
 {
 #ifdef DEBUG
@@ -310,7 +491,7 @@ PLDHashTable::~PLDHashTable()
   }
 
   // Clear any remaining live entries.
-  char* entryAddr = mEntryStore.Get();
+  char* entryAddr = EntryArray();
   char* entryLimit = entryAddr + Capacity() * mEntrySize;
   while (entryAddr < entryLimit) {
     PLDHashEntryHdr* entry = (PLDHashEntryHdr*)entryAddr;
@@ -329,9 +510,10 @@ PLDHashTable::ClearAndPrepareForLength(uint32_t aLength)
   // Get these values before the destructor clobbers them.
   const PLDHashTableOps* ops = mOps;
   uint32_t entrySize = mEntrySize;
+  Probing probing = mProbing;
 
   this->~PLDHashTable();
-  new (KnownNotNull, this) PLDHashTable(ops, entrySize, aLength);
+  new (KnownNotNull, this) PLDHashTable(ops, entrySize, aLength, probing);
 }
 
 void
@@ -451,6 +633,81 @@ PLDHashTable::FindFreeEntry(PLDHashNumber aKeyHash)
   // NOTREACHED
 }
 
+// The group probing equivalent of SearchTable(). Lookups only stop at a group
+// with a free entry, so removed entries are only left behind when their group
+// is full.
+template <PLDHashTable::SearchReason Reason>
+PLDHashEntryHdr* NS_FASTCALL
+PLDHashTable::SearchGroups(const void* aKey, PLDHashNumber aKeyHash)
+{
+  MOZ_ASSERT(mEntryStore.Get());
+  NS_ASSERTION(!(aKeyHash & kCollisionFlag),
+               "!(aKeyHash & kCollisionFlag)");
+
+  const uint8_t* ctrl = Controls();
+  uint32_t sizeMask = CapacityFromHashShift() - 1;
+  uint8_t tag = GroupTag(aKeyHash, mHashShift);
+  PLDHashMatchEntry matchEntry = mOps->matchEntry;
+
+  // Save the first free or removed entry so Add() can use it. (Only used if
+  // Reason==ForAdd.)
+  PLDHashEntryHdr* firstAvailable = nullptr;
+
+  uint32_t index = Hash1(aKeyHash) & ~(kGroupWidth - 1);
+  for (uint32_t stride = kGroupWidth; ; stride += kGroupWidth) {
+    Group group(ctrl + index);
+    for (GroupMask matches = group.Match(tag); matches;
+         matches.RemoveLowest()) {
+      PLDHashEntryHdr* entry = GroupEntry(index + matches.Lowest());
+      if (MatchEntryKeyhash(entry, aKeyHash) && matchEntry(entry, aKey)) {
+        return entry;
+      }
+    }
+
+    if (Reason == ForAdd && !firstAvailable) {
+      GroupMask available = group.MatchEmptyOrDeleted();
+      if (available) {
+        firstAvailable = GroupEntry(index + available.Lowest());
+      }
+    }
+
+    // Miss: return space for a new entry.
+    if (group.MatchEmpty()) {
+      return (Reason == ForAdd) ? firstAvailable : nullptr;
+    }
+
+    index = (index + stride) & sizeMask;
+  }
+
+  // NOTREACHED
+  return nullptr;
+}
+
+// The group probing equivalent of FindFreeEntry(). It also sets the control
+// byte of the entry it returns.
+PLDHashEntryHdr*
+PLDHashTable::FindFreeGroupEntry(PLDHashNumber aKeyHash)
+{
+  MOZ_ASSERT(mEntryStore.Get());
+
+  uint8_t* ctrl = Controls();
+  uint32_t sizeMask = CapacityFromHashShift() - 1;
+
+  uint32_t index = Hash1(aKeyHash) & ~(kGroupWidth - 1);
+  for (uint32_t stride = kGroupWidth; ; stride += kGroupWidth) {
+    GroupMask empty = Group(ctrl + index).MatchEmpty();
+    if (empty) {
+      index += empty.Lowest();
+      ctrl[index] = GroupTag(aKeyHash, mHashShift);
+      return GroupEntry(index);
+    }
+    index = (index + stride) & sizeMask;
+  }
+
+  // NOTREACHED
+  return nullptr;
+}
+
 bool
 PLDHashTable::ChangeTable(int32_t aDeltaLog2)
 {
@@ -465,7 +722,7 @@ PLDHashTable::ChangeTable(int32_t aDeltaLog2)
   }
 
   uint32_t nbytes;
-  if (!SizeOfEntryStore(newCapacity, mEntrySize, &nbytes)) {
+  if (!SizeOfEntryStore(newCapacity, mEntrySize, mProbing, &nbytes)) {
     return false;   // overflowed
   }
 
@@ -479,20 +736,25 @@ PLDHashTable::ChangeTable(int32_t aDeltaLog2)
   mRemovedCount = 0;
 
   // Assign the new entry store to table.
-  memset(newEntryStore, 0, nbytes);
+  InitEntryStore(newEntryStore, newCapacity);
+  uint32_t oldCapacity = 1u << oldLog2;
   char* oldEntryStore;
   char* oldEntryAddr;
   oldEntryAddr = oldEntryStore = mEntryStore.Get();
+  if (mProbing == Probing::Groups) {
+    oldEntryAddr += oldCapacity;
+  }
   mEntryStore.Set(newEntryStore);
   PLDHashMoveEntry moveEntry = mOps->moveEntry;
 
   // Copy only live entries, leaving removed ones behind.
-  uint32_t oldCapacity = 1u << oldLog2;
   for (uint32_t i = 0; i < oldCapacity; ++i) {
     PLDHashEntryHdr* oldEntry = (PLDHashEntryHdr*)oldEntryAddr;
     if (EntryIsLive(oldEntry)) {
       oldEntry->mKeyHash &= ~kCollisionFlag;
-      PLDHashEntryHdr* newEntry = FindFreeEntry(oldEntry->mKeyHash);
+      PLDHashEntryHdr* newEntry = mProbing == Probing::Groups
+                                ? FindFreeGroupEntry(oldEntry->mKeyHash)
+                                : FindFreeEntry(oldEntry->mKeyHash);
       NS_ASSERTION(EntryIsFree(newEntry), "EntryIsFree(newEntry)");
       moveEntry(this, oldEntry, newEntry);
       newEntry->mKeyHash = oldEntry->mKeyHash;
@@ -521,6 +783,14 @@ PLDHashTable::ComputeKeyHash(const void* aKey)
   return keyHash;
 }
 
+template <PLDHashTable::SearchReason Reason>
+MOZ_ALWAYS_INLINE PLDHashEntryHdr*
+PLDHashTable::SearchEntry(const void* aKey, PLDHashNumber aKeyHash)
+{
+  return mProbing == Probing::Groups ? SearchGroups<Reason>(aKey, aKeyHash)
+                                     : SearchTable<Reason>(aKey, aKeyHash);
+}
+
 PLDHashEntryHdr*
 PLDHashTable::Search(const void* aKey)
 {
@@ -529,7 +799,7 @@ PLDHashTable::Search(const void* aKey)
 #endif
 
   PLDHashEntryHdr* entry = mEntryStore.Get()
-                         ? SearchTable<ForSearchOrRemove>(aKey,
+                         ? SearchEntry<ForSearchOrRemove>(aKey,
                                                           ComputeKeyHash(aKey))
                          : nullptr;
   return entry;
@@ -547,19 +817,19 @@ PLDHashTable::Add(const void* aKey, const mozilla::fallible_t&)
     uint32_t nbytes;
     // We already checked this in the constructor, so it must still be true.
     MOZ_RELEASE_ASSERT(SizeOfEntryStore(CapacityFromHashShift(), mEntrySize,
-                                        &nbytes));
+                                        mProbing, &nbytes));
     mEntryStore.Set((char*)malloc(nbytes));
     if (!mEntryStore.Get()) {
       return nullptr;
     }
-    memset(mEntryStore.Get(), 0, nbytes);
+    InitEntryStore(mEntryStore.Get(), CapacityFromHashShift());
   }
 
-  // If alpha is >= .75, grow or compress the table. If aKey is already in the
-  // table, we may grow once more than necessary, but only if we are on the
-  // edge of being overloaded.
+  // If alpha is >= .75 (.875 with group probing), grow or compress the table.
+  // If aKey is already in the table, we may grow once more than necessary,
+  // but only if we are on the edge of being overloaded.
   uint32_t capacity = Capacity();
-  if (mEntryCount + mRemovedCount >= MaxLoad(capacity)) {
+  if (mEntryCount + mRemovedCount >= MaxLoad(capacity, mProbing)) {
     // Compress if a quarter or more of all entries are removed.
     int deltaLog2;
     if (mRemovedCount >= capacity >> 2) {
@@ -571,7 +841,8 @@ PLDHashTable::Add(const void* aKey, const mozilla::fallible_t&)
     // Grow or compress the table. If ChangeTable() fails, allow overloading up
     // to the secondary max. Once we hit the secondary max, return null.
     if (!ChangeTable(deltaLog2) &&
-        mEntryCount + mRemovedCount >= MaxLoadOnGrowthFailure(capacity)) {
+        mEntryCount + mRemovedCount >=
+          MaxLoadOnGrowthFailure(capacity, mProbing)) {
       return nullptr;
     }
   }
@@ -579,16 +850,21 @@ PLDHashTable::Add(const void* aKey, const mozilla::fallible_t&)
   // Look for entry after possibly growing, so we don't have to add it,
   // then skip it while growing the table and re-add it after.
   PLDHashNumber keyHash = ComputeKeyHash(aKey);
-  PLDHashEntryHdr* entry = SearchTable<ForAdd>(aKey, keyHash);
+  PLDHashEntryHdr* entry = SearchEntry<ForAdd>(aKey, keyHash);
   if (!EntryIsLive(entry)) {
     // Initialize the entry, indicating that it's no longer free.
     if (EntryIsRemoved(entry)) {
       mRemovedCount--;
-      keyHash |= kCollisionFlag;
+      if (mProbing == Probing::DoubleHashing) {
+        keyHash |= kCollisionFlag;
+      }
     }
     if (mOps->initEntry) {
       mOps->initEntry(entry, aKey);
     }
+    if (mProbing == Probing::Groups) {
+      Controls()[GroupEntryIndex(entry)] = GroupTag(keyHash, mHashShift);
+    }
     entry->mKeyHash = keyHash;
     mEntryCount++;
   }
@@ -604,7 +880,8 @@ PLDHashTable::Add(const void* aKey)
     if (!mEntryStore.Get()) {
       // We OOM'd while allocating the initial entry storage.
       uint32_t nbytes;
-      (void) SizeOfEntryStore(CapacityFromHashShift(), mEntrySize, &nbytes);
+      (void) SizeOfEntryStore(CapacityFromHashShift(), mEntrySize, mProbing,
+                              &nbytes);
       NS_ABORT_OOM(nbytes);
     } else {
       // We failed to resize the existing entry storage, either due to OOM or
@@ -625,7 +902,7 @@ PLDHashTable::Remove(const void* aKey)
 #endif
 
   PLDHashEntryHdr* entry = mEntryStore.Get()
-                         ? SearchTable<ForSearchOrRemove>(aKey,
+                         ? SearchEntry<ForSearchOrRemove>(aKey,
                                                           ComputeKeyHash(aKey))
                          : nullptr;
   if (entry) {
@@ -660,7 +937,21 @@ PLDHashTable::RawRemove(PLDHashEntryHdr* aEntry)
   // Load keyHash first in case clearEntry() goofs it.
   PLDHashNumber keyHash = aEntry->mKeyHash;
   mOps->clearEntry(this, aEntry);
-  if (keyHash & kCollisionFlag) {
+  if (mProbing == Probing::Groups) {
+    // A removed entry in a group that has a free one can be freed: no lookup
+    // ever went past that group, and it cannot become full before the next
+    // ChangeTable().
+    uint8_t* ctrl = Controls();
+    uint32_t index = GroupEntryIndex(aEntry);
+    if (Group(ctrl + (index & ~(kGroupWidth - 1))).MatchEmpty()) {
+      ctrl[index] = kCtrlEmpty;
+      MarkEntryFree(aEntry);
+    } else {
+      ctrl[index] = kCtrlDeleted;
+      MarkEntryRemoved(aEntry);
+      mRemovedCount++;
+    }
+  } else if (keyHash & kCollisionFlag) {
     MarkEntryRemoved(aEntry);
     mRemovedCount++;
   } else {
@@ -677,9 +968,9 @@ PLDHashTable::ShrinkIfAppropriate()
 {
   uint32_t capacity = Capacity();
   if (mRemovedCount >= capacity >> 2 ||
-      (capacity > kMinCapacity && mEntryCount <= MinLoad(capacity))) {
+      (capacity > MinCapacity(mProbing) && mEntryCount <= MinLoad(capacity))) {
     uint32_t log2;
-    BestCapacity(mEntryCount, &capacity, &log2);
+    BestCapacity(mEntryCount, mProbing, &capacity, &log2);
 
     int32_t deltaLog2 = log2 - (kHashBits - mHashShift);
     MOZ_ASSERT(deltaLog2 <= 0);
@@ -725,9 +1016,9 @@ PLDHashTable::Iterator::Iterator(Iterator&& aOther)
 
 PLDHashTable::Iterator::Iterator(PLDHashTable* aTable)
   : mTable(aTable)
-  , mStart(mTable->mEntryStore.Get())
-  , mLimit(mTable->mEntryStore.Get() + mTable->Capacity() * mTable->mEntrySize)
-  , mCurrent(mTable->mEntryStore.Get())
+  , mStart(mTable->EntryArray())
+  , mLimit(mStart + mTable->Capacity() * mTable->mEntrySize)
+  , mCurrent(mStart)
   , mNexts(0)
   , mNextsLimit(mTable->EntryCount())
   , mHaveRemoved(false)
@@ -204,8 +204,25 @@ private:
 // and use it after an add or remove operation, unless you sample Generation()
 // before adding or removing, and compare the sample after, dereferencing the
 // entry pointer only if Generation() has not changed.
+//
+// A table can instead be created with Probing::Groups. Then every entry also
+// has a control byte, holding 7 bits of its hash or marking it free or
+// removed, and the control bytes are kept in their own array in front of the
+// entries. Lookups probe groups of kGroupWidth neighbouring control bytes at
+// once, using SSE2 or NEON where available, and only touch the entries whose
+// control byte matches. This costs one byte per entry but allows a max load
+// factor of 87.5% instead of 75%, and avoids most of the cache misses on
+// large tables. The PLDHashTableOps hooks are used the same way in both
+// modes.
 class PLDHashTable
 {
+public:
+  enum class Probing : uint8_t
+  {
+    DoubleHashing,
+    Groups
+  };
+
 private:
   // This class maintains the invariant that every time the entry store is
   // changed, the generation is updated.
@@ -239,6 +256,7 @@ private:
 
   const PLDHashTableOps* const mOps;  // Virtual operations; see below.
   int16_t             mHashShift;     // Multiplicative hash shift.
+  const Probing       mProbing;       // How entries are probed; see above.
   const uint32_t      mEntrySize;     // Number of bytes in an entry.
   uint32_t            mEntryCount;    // Number of entries in table.
   uint32_t            mRemovedCount;  // Removed entry sentinels in table.
@@ -259,6 +277,10 @@ public:
 
   static const uint32_t kMinCapacity = 8;
 
+  // The number of control bytes probed at once with Probing::Groups. This is
+  // also the minimum capacity of such tables.
+  static const uint32_t kGroupWidth = 16;
+
   // Making this half of kMaxCapacity ensures it'll fit. Nobody should need an
   // initial length anywhere nearly this large, anyway.
   static const uint32_t kMaxInitialLength = kMaxCapacity / 2;
@@ -271,16 +293,19 @@ public:
   // rehashing; if |aLength| is a power-of-two, this capacity will be
   // |2*length|. However, because entry storage is allocated lazily, this
   // initial capacity won't be relevant until the first element is added; prior
-  // to that the capacity will be zero.
+  // to that the capacity will be zero. |aProbing| chooses how entries are
+  // probed; see above.
   //
   // This will crash if |aEntrySize| and/or |aLength| are too large.
   PLDHashTable(const PLDHashTableOps* aOps, uint32_t aEntrySize,
-               uint32_t aLength = kDefaultInitialLength);
+               uint32_t aLength = kDefaultInitialLength,
+               Probing aProbing = Probing::DoubleHashing);
 
   PLDHashTable(PLDHashTable&& aOther)
-      // These two fields are |const|. Initialize them here because the
+      // These three fields are |const|. Initialize them here because the
       // move assignment operator cannot modify them.
     : mOps(aOther.mOps)
+    , mProbing(aOther.mProbing)
     , mEntrySize(aOther.mEntrySize)
       // Initialize this field because it is required for a safe call to the
       // destructor, which the move assignment operator does.
@@ -307,6 +332,7 @@ public:
     return mEntryStore.Get() ? CapacityFromHashShift() : 0;
   }
 
+  Probing GetProbing() const { return mProbing; }
   uint32_t EntrySize()  const { return mEntrySize; }
   uint32_t EntryCount() const { return mEntryCount; }
   uint32_t Generation() const { return mEntryStore.Generation(); }
@@ -495,7 +521,8 @@ private:
   static const uint32_t kHashBits = 32;
   static const uint32_t kGoldenRatio = 0x9E3779B9U;
 
-  static uint32_t HashShift(uint32_t aEntrySize, uint32_t aLength);
+  static uint32_t HashShift(uint32_t aEntrySize, uint32_t aLength,
+                            Probing aProbing);
 
   static const PLDHashNumber kCollisionFlag = 1;
 
@@ -527,6 +554,32 @@ private:
   static bool MatchEntryKeyhash(PLDHashEntryHdr* aEntry, PLDHashNumber aHash);
   PLDHashEntryHdr* AddressEntry(uint32_t aIndex);
 
+  // The first entry. With Probing::Groups it comes after the control bytes.
+  char* EntryArray() const
+  {
+    char* store = const_cast<char*>(mEntryStore.Get());
+    if (store && mProbing == Probing::Groups) {
+      store += Capacity();
+    }
+    return store;
+  }
+
+  // Probing::Groups helpers.
+  uint8_t* Controls() const
+  {
+    return reinterpret_cast<uint8_t*>(const_cast<char*>(mEntryStore.Get()));
+  }
+  PLDHashEntryHdr* GroupEntry(uint32_t aIndex) const
+  {
+    return reinterpret_cast<PLDHashEntryHdr*>(EntryArray() +
+                                             aIndex * mEntrySize);
+  }
+  uint32_t GroupEntryIndex(PLDHashEntryHdr* aEntry) const
+  {
+    return (reinterpret_cast<char*>(aEntry) - EntryArray()) / mEntrySize;
+  }
+  void InitEntryStore(char* aEntryStore, uint32_t aCapacity);
+
   // We store mHashShift rather than sizeLog2 to optimize the collision-free
   // case in SearchTable.
   uint32_t CapacityFromHashShift() const
@@ -542,7 +595,15 @@ private:
   PLDHashEntryHdr* NS_FASTCALL
     SearchTable(const void* aKey, PLDHashNumber aKeyHash);
 
+  template <SearchReason Reason>
+  PLDHashEntryHdr* NS_FASTCALL
+    SearchGroups(const void* aKey, PLDHashNumber aKeyHash);
+
+  template <SearchReason Reason>
+  PLDHashEntryHdr* SearchEntry(const void* aKey, PLDHashNumber aKeyHash);
+
   PLDHashEntryHdr* FindFreeEntry(PLDHashNumber aKeyHash);
+  PLDHashEntryHdr* FindFreeGroupEntry(PLDHashNumber aKeyHash);
 
   bool ChangeTable(int aDeltaLog2);
 
@@ -435,8 +435,14 @@ def to_cxx(data, preamble=None):
   return text
 
 
-def words_to_cxx(words, preamble=None):
-  """Generates C++ code from a word list"""
+def words_to_cxx(words, preamble=None, reverse_words=False):
+  """Generates C++ code from a word list.
+
+  With reverse_words, the strings (but not their return values) are reversed,
+  for graphs searched by suffix with Dafsa::LookupLongestReversedSuffix().
+  """
+  if reverse_words:
+    words = [word[-2::-1] + word[-1] for word in words]
   dafsa = to_dafsa(words)
   for fun in (reverse, join_suffixes, reverse, join_suffixes, join_labels):
     dafsa = fun(dafsa)
@@ -466,13 +472,17 @@ def parse_gperf(infile):
   return (preamble, [line[:-3] + line[-1] for line in lines])
 
 
-def main(outfile, infile):
+def main(outfile, infile, reverse_words=False):
   with open(infile, 'r') as infile:
     preamble, words = parse_gperf(infile)
-    outfile.write(words_to_cxx(words, preamble))
+    outfile.write(words_to_cxx(words, preamble, reverse_words))
   return 0
 
 
+def main_reversed(outfile, infile):
+  return main(outfile, infile, reverse_words=True)
+
+
 if __name__ == '__main__':
   if len(sys.argv) != 3:
     print('usage: %s infile outfile' % sys.argv[0])
@@ -40,8 +40,9 @@
 //   atoms ignore all AddRef/Release calls, which ensures they stay alive until
 //   |gAtomTable| itself is destroyed whereupon they are explicitly deleted.
 //
-//   Note that gAtomTable is used on multiple threads, and callers must
-//   acquire gAtomTableLock before touching it.
+//   Note that gAtomTable is used on multiple threads. It is split into
+//   sub-tables that each have their own lock, and callers must acquire the
+//   lock of a sub-table before touching it.
 
 using namespace mozilla;
 
@@ -85,8 +86,8 @@ public:
     Shutdown,
   };
 
-  static void GCAtomTableLocked(const MutexAutoLock& aProofOfLock,
-                                GCKind aKind);
+  // Locks each sub-table in turn.
+  static void GCAtomSubTables(GCKind aKind);
 
 private:
   DynamicAtom(const nsAString& aString, uint32_t aHash)
@@ -299,14 +300,6 @@ nsIAtom::Release()
 
 //----------------------------------------------------------------------
 
-/**
- * The shared hash table for atom lookups.
- *
- * Callers must hold gAtomTableLock before manipulating the table.
- */
-static PLDHashTable* gAtomTable;
-static Mutex* gAtomTableLock;
-
 struct AtomTableKey
 {
   AtomTableKey(const char16_t* aUTF16String, uint32_t aLength, uint32_t aHash)
@@ -418,6 +411,58 @@ static const PLDHashTableOps AtomTableOps = {
   AtomTableInitEntry
 };
 
+// The atom table very quickly gets 10,000+ entries in it (or even 100,000+).
+// But choosing the best initial length has some subtleties: we add ~2700
+// static atoms to the table at start-up, and then we start adding and removing
+// dynamic atoms. If we make the table too big to start with, when the first
+// dynamic atom gets removed the load factor will be < 25% and so we will
+// shrink it.
+//
+// By choosing an initial length of 4096, we get an initial capacity of 8192
+// over all sub-tables. That's the biggest initial capacity that will let us be
+// > 25% full when the first dynamic atom is removed (when the count is ~2700),
+// thus avoiding any shrinking.
+#define ATOM_HASHTABLE_INITIAL_LENGTH  4096
+
+// The number of sub-tables of the atom table. It must be a power of two.
+#define ATOM_HASHTABLE_SUBTABLE_COUNT  128
+
+/**
+ * One shard of the shared hash table for atom lookups. Atoms are spread over
+ * the sub-tables by the low bits of their hash, so threads atomizing different
+ * strings mostly take different locks. (PLDHashTable indexes its entries with
+ * the high bits of the scrambled hash, so these bits are not wasted.)
+ *
+ * Callers must hold mLock before manipulating mTable.
+ */
+class AtomSubTable
+{
+public:
+  AtomSubTable()
+    : mLock("Atom Sub-Table Lock")
+    , mTable(&AtomTableOps, sizeof(AtomTableEntry),
+             ATOM_HASHTABLE_INITIAL_LENGTH / ATOM_HASHTABLE_SUBTABLE_COUNT)
+  {}
+
+  AtomTableEntry* Add(AtomTableKey& aKey)
+  {
+    mLock.AssertCurrentThreadOwns();
+    // This is an infallible add.
+    return static_cast<AtomTableEntry*>(mTable.Add(&aKey));
+  }
+
+  Mutex mLock;
+  PLDHashTable mTable;
+};
+
+static AtomSubTable* gAtomTable;
+
+static inline AtomSubTable&
+SelectSubTable(const AtomTableKey& aKey)
+{
+  return gAtomTable[aKey.mHash & (ATOM_HASHTABLE_SUBTABLE_COUNT - 1)];
+}
+
 //----------------------------------------------------------------------
 
 #define RECENTLY_USED_MAIN_THREAD_ATOM_CACHE_SIZE 31
@@ -428,14 +473,12 @@ void
 DynamicAtom::GCAtomTable()
 {
   if (NS_IsMainThread()) {
-    MutexAutoLock lock(*gAtomTableLock);
-    GCAtomTableLocked(lock, GCKind::RegularOperation);
+    GCAtomSubTables(GCKind::RegularOperation);
   }
 }
 
 void
-DynamicAtom::GCAtomTableLocked(const MutexAutoLock& aProofOfLock,
-                               GCKind aKind)
+DynamicAtom::GCAtomSubTables(GCKind aKind)
 {
   MOZ_ASSERT(NS_IsMainThread());
   for (uint32_t i = 0; i < RECENTLY_USED_MAIN_THREAD_ATOM_CACHE_SIZE; ++i) {
@@ -445,37 +488,41 @@ DynamicAtom::GCAtomTableLocked(const MutexAutoLock& aProofOfLock,
   uint32_t removedCount = 0; // Use a non-atomic temporary for cheaper increments.
   nsAutoCString nonZeroRefcountAtoms;
   uint32_t nonZeroRefcountAtomsCount = 0;
-  for (auto i = gAtomTable->Iter(); !i.Done(); i.Next()) {
-    auto entry = static_cast<AtomTableEntry*>(i.Get());
-    if (entry->mAtom->IsStaticAtom()) {
-      continue;
-    }
+  for (uint32_t t = 0; t < ATOM_HASHTABLE_SUBTABLE_COUNT; ++t) {
+    AtomSubTable& subTable = gAtomTable[t];
+    MutexAutoLock lock(subTable.mLock);
+    for (auto i = subTable.mTable.Iter(); !i.Done(); i.Next()) {
+      auto entry = static_cast<AtomTableEntry*>(i.Get());
+      if (entry->mAtom->IsStaticAtom()) {
+        continue;
+      }
 
-    auto atom = static_cast<DynamicAtom*>(entry->mAtom);
-    if (atom->mRefCnt == 0) {
-      i.Remove();
-      delete atom;
-      ++removedCount;
-    }
+      auto atom = static_cast<DynamicAtom*>(entry->mAtom);
+      if (atom->mRefCnt == 0) {
+        i.Remove();
+        delete atom;
+        ++removedCount;
+      }
 #ifdef NS_FREE_PERMANENT_DATA
-    else if (aKind == GCKind::Shutdown && PR_GetEnv("XPCOM_MEM_BLOAT_LOG")) {
-      // Only report leaking atoms in leak-checking builds in a run
-      // where we are checking for leaks, during shutdown. If
-      // something is anomalous, then we'll assert later in this
-      // function.
-      nsAutoCString name;
-      atom->ToUTF8String(name);
-      if (nonZeroRefcountAtomsCount == 0) {
-        nonZeroRefcountAtoms = name;
-      } else if (nonZeroRefcountAtomsCount < 20) {
-        nonZeroRefcountAtoms += NS_LITERAL_CSTRING(",") + name;
-      } else if (nonZeroRefcountAtomsCount == 20) {
-        nonZeroRefcountAtoms += NS_LITERAL_CSTRING(",...");
+      else if (aKind == GCKind::Shutdown && PR_GetEnv("XPCOM_MEM_BLOAT_LOG")) {
+        // Only report leaking atoms in leak-checking builds in a run
+        // where we are checking for leaks, during shutdown. If
+        // something is anomalous, then we'll assert later in this
+        // function.
+        nsAutoCString name;
+        atom->ToUTF8String(name);
+        if (nonZeroRefcountAtomsCount == 0) {
+          nonZeroRefcountAtoms = name;
+        } else if (nonZeroRefcountAtomsCount < 20) {
+          nonZeroRefcountAtoms += NS_LITERAL_CSTRING(",") + name;
+        } else if (nonZeroRefcountAtomsCount == 20) {
+          nonZeroRefcountAtoms += NS_LITERAL_CSTRING(",...");
+        }
+        nonZeroRefcountAtomsCount++;
       }
-      nonZeroRefcountAtomsCount++;
-    }
 #endif
 
+    }
   }
   if (nonZeroRefcountAtomsCount) {
     nsPrintfCString msg("%d dynamic atom(s) with non-zero refcount: %s",
@@ -485,15 +532,15 @@ DynamicAtom::GCAtomTableLocked(const MutexAutoLock& aProofOfLock,
 
   // We would like to assert that gUnusedAtomCount matches the number of atoms
   // we found in the table which we removed. During the course of this function,
-  // the atom table is locked, but this lock is not acquired for AddRef() and
-  // Release() calls. This means we might see a gUnusedAtomCount value in
+  // each sub-table is locked in turn, but these locks are not acquired for
+  // AddRef() and Release() calls. This means we might see a gUnusedAtomCount value in
   // between, say, AddRef() incrementing mRefCnt and it decrementing
   // gUnusedAtomCount. So, we don't bother asserting that there are no unused
   // atoms at the end of a regular GC. But we can (and do) assert thist just
   // after the last GC at shutdown.
   //
   // Note that, barring refcounting bugs, an atom can only go from a zero
-  // refcount to a non-zero refcount while the atom table lock is held, so
+  // refcount to a non-zero refcount while the lock of its sub-table is held,
   // so we won't try to resurrect a zero refcount atom while trying to delete
   // it.
 
@@ -587,26 +634,11 @@ static StaticAtomTable* gStaticAtomTable = nullptr;
  */
 static bool gStaticAtomTableSealed = false;
 
-// The atom table very quickly gets 10,000+ entries in it (or even 100,000+).
-// But choosing the best initial length has some subtleties: we add ~2700
-// static atoms to the table at start-up, and then we start adding and removing
-// dynamic atoms. If we make the table too big to start with, when the first
-// dynamic atom gets removed the load factor will be < 25% and so we will
-// shrink it to 4096 entries.
-//
-// By choosing an initial length of 4096, we get an initial capacity of 8192.
-// That's the biggest initial capacity that will let us be > 25% full when the
-// first dynamic atom is removed (when the count is ~2700), thus avoiding any
-// shrinking.
-#define ATOM_HASHTABLE_INITIAL_LENGTH  4096
-
 void
 NS_InitAtomTable()
 {
   MOZ_ASSERT(!gAtomTable);
-  gAtomTable = new PLDHashTable(&AtomTableOps, sizeof(AtomTableEntry),
-                                ATOM_HASHTABLE_INITIAL_LENGTH);
-  gAtomTableLock = new Mutex("Atom Table Lock");
+  gAtomTable = new AtomSubTable[ATOM_HASHTABLE_SUBTABLE_COUNT];
 
   // Bug 1340710 has caused us to generate an empty atom at arbitrary times
   // after startup.  If we end up creating one before nsGkAtoms::_empty is
@@ -635,27 +667,26 @@ NS_ShutdownAtomTable()
 #ifdef NS_FREE_PERMANENT_DATA
   // Do a final GC to satisfy leak checking. We skip this step in release
   // builds.
-  {
-    MutexAutoLock lock(*gAtomTableLock);
-    DynamicAtom::GCAtomTableLocked(lock, DynamicAtom::GCKind::Shutdown);
-  }
+  DynamicAtom::GCAtomSubTables(DynamicAtom::GCKind::Shutdown);
 #endif
 
-  delete gAtomTable;
+  delete[] gAtomTable;
   gAtomTable = nullptr;
-  delete gAtomTableLock;
-  gAtomTableLock = nullptr;
 }
 
 void
 NS_SizeOfAtomTablesIncludingThis(MallocSizeOf aMallocSizeOf,
                                  size_t* aMain, size_t* aStatic)
 {
-  MutexAutoLock lock(*gAtomTableLock);
-  *aMain = gAtomTable->ShallowSizeOfIncludingThis(aMallocSizeOf);
-  for (auto iter = gAtomTable->Iter(); !iter.Done(); iter.Next()) {
-    auto entry = static_cast<AtomTableEntry*>(iter.Get());
-    *aMain += entry->mAtom->SizeOfIncludingThis(aMallocSizeOf);
+  *aMain = aMallocSizeOf(gAtomTable);
+  for (uint32_t t = 0; t < ATOM_HASHTABLE_SUBTABLE_COUNT; ++t) {
+    AtomSubTable& subTable = gAtomTable[t];
+    MutexAutoLock lock(subTable.mLock);
+    *aMain += subTable.mTable.ShallowSizeOfExcludingThis(aMallocSizeOf);
+    for (auto iter = subTable.mTable.Iter(); !iter.Done(); iter.Next()) {
+      auto entry = static_cast<AtomTableEntry*>(iter.Get());
+      *aMain += entry->mAtom->SizeOfIncludingThis(aMallocSizeOf);
+    }
   }
 
   // The atoms pointed to by gStaticAtomTable are also pointed to by gAtomTable,
@@ -665,29 +696,11 @@ NS_SizeOfAtomTablesIncludingThis(MallocSizeOf aMallocSizeOf,
            : 0;
 }
 
-static inline AtomTableEntry*
-GetAtomHashEntry(const char* aString, uint32_t aLength, uint32_t* aHashOut)
-{
-  gAtomTableLock->AssertCurrentThreadOwns();
-  AtomTableKey key(aString, aLength, aHashOut);
-  // This is an infallible add.
-  return static_cast<AtomTableEntry*>(gAtomTable->Add(&key));
-}
-
-static inline AtomTableEntry*
-GetAtomHashEntry(const char16_t* aString, uint32_t aLength, uint32_t* aHashOut)
-{
-  gAtomTableLock->AssertCurrentThreadOwns();
-  AtomTableKey key(aString, aLength, aHashOut);
-  // This is an infallible add.
-  return static_cast<AtomTableEntry*>(gAtomTable->Add(&key));
-}
-
 void
 RegisterStaticAtoms(const nsStaticAtom* aAtoms, uint32_t aAtomCount)
 {
-  MutexAutoLock lock(*gAtomTableLock);
-
+  // Static atoms are registered on the main thread during startup, and
+  // gStaticAtomTable is only read once it is sealed, so it needs no lock.
   MOZ_RELEASE_ASSERT(!gStaticAtomTableSealed,
                      "Atom table has already been sealed!");
 
@@ -704,9 +717,11 @@ RegisterStaticAtoms(const nsStaticAtom* aAtoms, uint32_t aAtomCount)
     uint32_t stringLen = stringBuffer->StorageSize() / sizeof(char16_t) - 1;
 
     uint32_t hash;
-    AtomTableEntry* he =
-      GetAtomHashEntry(static_cast<char16_t*>(stringBuffer->Data()),
-                       stringLen, &hash);
+    AtomTableKey key(static_cast<char16_t*>(stringBuffer->Data()),
+                     stringLen, &hash);
+    AtomSubTable& subTable = SelectSubTable(key);
+    MutexAutoLock lock(subTable.mLock);
+    AtomTableEntry* he = subTable.Add(key);
 
     nsIAtom* atom = he->mAtom;
     if (atom) {
@@ -744,11 +759,11 @@ NS_Atomize(const char* aUTF8String)
 already_AddRefed<nsIAtom>
 NS_Atomize(const nsACString& aUTF8String)
 {
-  MutexAutoLock lock(*gAtomTableLock);
   uint32_t hash;
-  AtomTableEntry* he = GetAtomHashEntry(aUTF8String.Data(),
-                                        aUTF8String.Length(),
-                                        &hash);
+  AtomTableKey key(aUTF8String.Data(), aUTF8String.Length(), &hash);
+  AtomSubTable& subTable = SelectSubTable(key);
+  MutexAutoLock lock(subTable.mLock);
+  AtomTableEntry* he = subTable.Add(key);
 
   if (he->mAtom) {
     nsCOMPtr<nsIAtom> atom = he->mAtom;
@@ -777,11 +792,11 @@ NS_Atomize(const char16_t* aUTF16String)
 already_AddRefed<nsIAtom>
 NS_Atomize(const nsAString& aUTF16String)
 {
-  MutexAutoLock lock(*gAtomTableLock);
   uint32_t hash;
-  AtomTableEntry* he = GetAtomHashEntry(aUTF16String.Data(),
-                                        aUTF16String.Length(),
-                                        &hash);
+  AtomTableKey key(aUTF16String.Data(), aUTF16String.Length(), &hash);
+  AtomSubTable& subTable = SelectSubTable(key);
+  MutexAutoLock lock(subTable.mLock);
+  AtomTableEntry* he = subTable.Add(key);
 
   if (he->mAtom) {
     nsCOMPtr<nsIAtom> atom = he->mAtom;
@@ -815,8 +830,9 @@ NS_AtomizeMainThread(const nsAString& aUTF16String)
     }
   }
 
-  MutexAutoLock lock(*gAtomTableLock);
-  AtomTableEntry* he = static_cast<AtomTableEntry*>(gAtomTable->Add(&key));
+  AtomSubTable& subTable = SelectSubTable(key);
+  MutexAutoLock lock(subTable.mLock);
+  AtomTableEntry* he = subTable.Add(key);
 
   if (he->mAtom) {
     retVal = he->mAtom;
@@ -833,8 +849,13 @@ nsrefcnt
 NS_GetNumberOfAtoms(void)
 {
   DynamicAtom::GCAtomTable(); // Trigger a GC so that we return a deterministic result.
-  MutexAutoLock lock(*gAtomTableLock);
-  return gAtomTable->EntryCount();
+  nsrefcnt count = 0;
+  for (uint32_t t = 0; t < ATOM_HASHTABLE_SUBTABLE_COUNT; ++t) {
+    AtomSubTable& subTable = gAtomTable[t];
+    MutexAutoLock lock(subTable.mLock);
+    count += subTable.mTable.EntryCount();
+  }
+  return count;
 }
 
 nsIAtom*
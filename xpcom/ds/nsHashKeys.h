@@ -183,7 +183,7 @@ public:
   static KeyTypePointer KeyToPointer(KeyType aKey) { return &aKey; }
   static PLDHashNumber HashKey(KeyTypePointer aKey)
   {
-    return mozilla::HashString(*aKey);
+    return mozilla::HashBytes(aKey->BeginReading(), aKey->Length());
   }
 
 #ifdef MOZILLA_INTERNAL_API
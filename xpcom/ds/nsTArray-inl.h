@@ -220,20 +220,20 @@ nsTArray_base<Alloc, Copy>::ShrinkCapacity(size_type aElemSize,
     header->mLength = length;
     Copy::MoveNonOverlappingRegion(header + 1, mHdr + 1, length, aElemSize);
 
-    nsTArrayFallibleAllocator::Free(mHdr);
+    FallibleAlloc::Free(mHdr);
     mHdr = header;
     return;
   }
 
   if (length == 0) {
     MOZ_ASSERT(!IsAutoArray(), "autoarray should have fit 0 elements");
-    nsTArrayFallibleAllocator::Free(mHdr);
+    FallibleAlloc::Free(mHdr);
     mHdr = EmptyHdr();
     return;
   }
 
   size_type size = sizeof(Header) + length * aElemSize;
-  void* ptr = nsTArrayFallibleAllocator::Realloc(mHdr, size);
+  void* ptr = FallibleAlloc::Realloc(mHdr, size);
   if (!ptr) {
     return;
   }
@@ -350,10 +350,16 @@ nsTArray_base<Alloc, Copy>::SwapArrayElements(nsTArray_base<Allocator,
   typename nsTArray_base<Allocator, Copy>::IsAutoArrayRestorer
     otherAutoRestorer(aOther, aElemAlign);
 
+  // Buffers can only change hands if both allocators free them the same way.
+  const bool canSwapBuffers =
+    mozilla::IsSame<typename nsTArray_FallibleAllocator<Alloc>::Type,
+                    typename nsTArray_FallibleAllocator<Allocator>::Type>::value;
+
   // If neither array uses an auto buffer which is big enough to store the
   // other array's elements, then ensure that both arrays use malloc'ed storage
   // and swap their mHdr pointers.
-  if ((!UsesAutoArrayBuffer() || Capacity() < aOther.Length()) &&
+  if (canSwapBuffers &&
+      (!UsesAutoArrayBuffer() || Capacity() < aOther.Length()) &&
       (!aOther.UsesAutoArrayBuffer() || aOther.Capacity() < Length())) {
 
     if (!EnsureNotUsingAutoArrayBuffer<ActualAlloc>(aElemSize) ||
@@ -369,8 +375,9 @@ nsTArray_base<Alloc, Copy>::SwapArrayElements(nsTArray_base<Allocator,
   }
 
   // Swap the two arrays by copying, since at least one is using an auto
-  // buffer which is large enough to hold all of the aOther's elements.  We'll
-  // copy the shorter array into temporary storage.
+  // buffer which is large enough to hold all of the aOther's elements, or
+  // their buffers can't be swapped.  We'll copy the shorter array into
+  // temporary storage.
   //
   // (We could do better than this in some circumstances.  Suppose we're
   // swapping arrays X and Y.  X has space for 2 elements in its auto buffer,
@@ -386,7 +393,8 @@ nsTArray_base<Alloc, Copy>::SwapArrayElements(nsTArray_base<Allocator,
 
   // The EnsureCapacity calls above shouldn't have caused *both* arrays to
   // switch from their auto buffers to malloc'ed space.
-  MOZ_ASSERT(UsesAutoArrayBuffer() || aOther.UsesAutoArrayBuffer(),
+  MOZ_ASSERT(!canSwapBuffers ||
+             UsesAutoArrayBuffer() || aOther.UsesAutoArrayBuffer(),
              "One of the arrays should be using its auto buffer.");
 
   size_type smallerLength = XPCOM_MIN(Length(), aOther.Length());
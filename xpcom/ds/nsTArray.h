@@ -151,7 +151,8 @@ struct nsTArrayInfallibleResult
 
 //
 // nsTArray*Allocators must all use the same |free()|, to allow swap()'ing
-// between fallible and infallible variants.
+// between fallible and infallible variants.  Allocators with storage of their
+// own (see mozilla/ArenaTArray.h) specialize nsTArray_FallibleAllocator.
 //
 
 struct nsTArrayFallibleAllocatorBase
@@ -245,6 +246,15 @@ struct nsTArrayInfallibleAllocator : nsTArrayInfallibleAllocatorBase
 
 #endif
 
+// The allocator used by the fallible methods of arrays using |Alloc|.  Arrays
+// only take over each other's buffers if this is the same for both of their
+// allocators; otherwise their elements are copied.
+template<class Alloc>
+struct nsTArray_FallibleAllocator
+{
+  typedef nsTArrayFallibleAllocator Type;
+};
+
 // nsTArray_base stores elements into the space allocated beyond
 // sizeof(*this).  This is done to minimize the size of the nsTArray
 // object when it is empty.
@@ -378,8 +388,8 @@ template<class Alloc, class Copy>
 class nsTArray_base
 {
   // Allow swapping elements with |nsTArray_base|s created using a
-  // different allocator.  This is kosher because all allocators use
-  // the same free().
+  // different allocator.  Buffers only change hands between allocators that
+  // use the same free(); see nsTArray_FallibleAllocator.
   template<class Allocator, class Copier>
   friend class nsTArray_base;
   friend void Gecko_EnsureTArrayCapacity(void* aArray, size_t aCapacity,
@@ -389,6 +399,7 @@ class nsTArray_base
 
 protected:
   typedef nsTArrayHeader Header;
+  typedef typename nsTArray_FallibleAllocator<Alloc>::Type FallibleAlloc;
 
 public:
   typedef size_t size_type;
@@ -849,7 +860,7 @@ class nsTArray_Impl
   , public nsTArray_TypedBase<E, nsTArray_Impl<E, Alloc>>
 {
 private:
-  typedef nsTArrayFallibleAllocator FallibleAlloc;
+  typedef typename nsTArray_FallibleAllocator<Alloc>::Type FallibleAlloc;
   typedef nsTArrayInfallibleAllocator InfallibleAlloc;
 
 public:
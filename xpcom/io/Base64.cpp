@@ -6,14 +6,12 @@
 
 #include "Base64.h"
 
-#include "mozilla/ScopeExit.h"
+#include "mozilla/CheckedInt.h"
 #include "mozilla/UniquePtrExtensions.h"
 #include "nsIInputStream.h"
 #include "nsString.h"
 #include "nsTArray.h"
 
-#include "plbase64.h"
-
 namespace {
 
 // BEGIN base64 encode code copied and modified from NSPR
@@ -22,47 +20,48 @@ const unsigned char* base =
                   "abcdefghijklmnopqrstuvwxyz"
                   "0123456789+/";
 
-template<typename T>
+// The source may be a UTF-16 string, of which only the low byte of every
+// character is encoded.
+template<typename S, typename T>
 static void
-Encode3to4(const unsigned char* aSrc, T* aDest)
+Encode3to4(const S* aSrc, T* aDest)
 {
-  uint32_t b32 = (uint32_t)0;
-  int i, j = 18;
-
-  for (i = 0; i < 3; ++i) {
-    b32 <<= 8;
-    b32 |= (uint32_t)aSrc[i];
-  }
-
-  for (i = 0; i < 4; ++i) {
-    aDest[i] = base[(uint32_t)((b32 >> j) & 0x3F)];
-    j -= 6;
-  }
+  uint32_t b32 = uint32_t(uint8_t(aSrc[0])) << 16 |
+                 uint32_t(uint8_t(aSrc[1])) << 8 |
+                 uint32_t(uint8_t(aSrc[2]));
+
+  aDest[0] = base[b32 >> 18];
+  aDest[1] = base[(b32 >> 12) & 0x3F];
+  aDest[2] = base[(b32 >> 6) & 0x3F];
+  aDest[3] = base[b32 & 0x3F];
 }
 
-template<typename T>
+template<typename S, typename T>
 static void
-Encode2to4(const unsigned char* aSrc, T* aDest)
+Encode2to4(const S* aSrc, T* aDest)
 {
-  aDest[0] = base[(uint32_t)((aSrc[0] >> 2) & 0x3F)];
-  aDest[1] = base[(uint32_t)(((aSrc[0] & 0x03) << 4) | ((aSrc[1] >> 4) & 0x0F))];
-  aDest[2] = base[(uint32_t)((aSrc[1] & 0x0F) << 2)];
+  uint8_t src0 = uint8_t(aSrc[0]);
+  uint8_t src1 = uint8_t(aSrc[1]);
+  aDest[0] = base[(uint32_t)((src0 >> 2) & 0x3F)];
+  aDest[1] = base[(uint32_t)(((src0 & 0x03) << 4) | ((src1 >> 4) & 0x0F))];
+  aDest[2] = base[(uint32_t)((src1 & 0x0F) << 2)];
   aDest[3] = (unsigned char)'=';
 }
 
-template<typename T>
+template<typename S, typename T>
 static void
-Encode1to4(const unsigned char* aSrc, T* aDest)
+Encode1to4(const S* aSrc, T* aDest)
 {
-  aDest[0] = base[(uint32_t)((aSrc[0] >> 2) & 0x3F)];
-  aDest[1] = base[(uint32_t)((aSrc[0] & 0x03) << 4)];
+  uint8_t src0 = uint8_t(aSrc[0]);
+  aDest[0] = base[(uint32_t)((src0 >> 2) & 0x3F)];
+  aDest[1] = base[(uint32_t)((src0 & 0x03) << 4)];
   aDest[2] = (unsigned char)'=';
   aDest[3] = (unsigned char)'=';
 }
 
-template<typename T>
+template<typename S, typename T>
 static void
-Encode(const unsigned char* aSrc, uint32_t aSrcLen, T* aDest)
+Encode(const S* aSrc, uint32_t aSrcLen, T* aDest)
 {
   while (aSrcLen >= 3) {
     Encode3to4(aSrc, aDest);
@@ -87,6 +86,113 @@ Encode(const unsigned char* aSrc, uint32_t aSrcLen, T* aDest)
 
 // END base64 encode code copied and modified from NSPR.
 
+// Maps an encoded character to a value in the Base64 alphabet, per RFC 4648,
+// Table 1. Invalid input characters map to UINT8_MAX.
+static const uint8_t kBase64DecodeTable[] = {
+  255, 255, 255, 255, 255, 255, 255, 255,
+  255, 255, 255, 255, 255, 255, 255, 255,
+  255, 255, 255, 255, 255, 255, 255, 255,
+  255, 255, 255, 255, 255, 255, 255, 255,
+  255, 255, 255, 255, 255, 255, 255, 255,
+  255, 255, 255,
+  62 /* + */,
+  255, 255, 255,
+  63 /* / */,
+  52, 53, 54, 55, 56, 57, 58, 59, 60, 61, /* 0 - 9 */
+  255, 255, 255, 255, 255, 255, 255,
+  0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+  16, 17, 18, 19, 20, 21, 22, 23, 24, 25, /* A - Z */
+  255, 255, 255, 255, 255, 255,
+  26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40, 41,
+  42, 43, 44, 45, 46, 47, 48, 49, 50, 51, /* a - z */
+  255, 255, 255, 255, 255,
+};
+
+static inline uint32_t
+CharIndex(char aChar)
+{
+  return uint8_t(aChar);
+}
+
+static inline uint32_t
+CharIndex(char16_t aChar)
+{
+  return aChar;
+}
+
+// Decodes up to four characters into |aValue|, six bits per character.
+// Invalid characters map to 255 and characters outside of the table have bits
+// above 0x7f set, so both are caught by a single test of the combined bits
+// instead of a branch per character.
+template<typename T>
+static inline bool
+DecodeBits(const T* aSrc, uint32_t aCount, uint32_t* aValue)
+{
+  uint32_t value = 0;
+  uint32_t invalid = 0;
+  for (uint32_t i = 0; i < aCount; i++) {
+    uint32_t index = CharIndex(aSrc[i]);
+    uint32_t bits = kBase64DecodeTable[index & 0x7f];
+    invalid |= bits | (index & ~0x7f);
+    value = (value << 6) | bits;
+  }
+  *aValue = value;
+  return !(invalid & ~0x7f);
+}
+
+// Like PL_Base64Decode, ignores up to two trailing '=' when the length is a
+// multiple of 4, and accepts unpadded input.  |aDest| must be large enough to
+// hold (aSrcLen * 3) / 4 bytes, |aDestLen| is set to the length of the
+// decoded data.
+template<typename T, typename U>
+static bool
+Decode(const T* aSrc, uint32_t aSrcLen, U* aDest, uint32_t* aDestLen)
+{
+  if (aSrcLen && !(aSrcLen & 3) && aSrc[aSrcLen - 1] == '=') {
+    if (aSrc[aSrcLen - 2] == '=') {
+      aSrcLen -= 2;
+    } else {
+      aSrcLen -= 1;
+    }
+  }
+
+  U* dest = aDest;
+  uint32_t bits;
+  for (; aSrcLen >= 4; aSrcLen -= 4, aSrc += 4, dest += 3) {
+    if (!DecodeBits(aSrc, 4, &bits)) {
+      return false;
+    }
+    dest[0] = U(uint8_t(bits >> 16));
+    dest[1] = U(uint8_t(bits >> 8));
+    dest[2] = U(uint8_t(bits));
+  }
+
+  switch (aSrcLen) {
+    case 3:
+      if (!DecodeBits(aSrc, 3, &bits)) {
+        return false;
+      }
+      dest[0] = U(uint8_t(bits >> 10));
+      dest[1] = U(uint8_t(bits >> 2));
+      dest += 2;
+      break;
+    case 2:
+      if (!DecodeBits(aSrc, 2, &bits)) {
+        return false;
+      }
+      dest[0] = U(uint8_t(bits >> 4));
+      dest += 1;
+      break;
+    case 1:
+      return false;
+    case 0:
+      break;
+  }
+
+  *aDestLen = dest - aDest;
+  return true;
+}
+
 template<typename T>
 struct EncodeInputStream_State
 {
@@ -291,7 +397,6 @@ Base64Encode(const char* aBinary, uint32_t aBinaryLen, char** aBase64)
     return NS_ERROR_FAILURE;
   }
 
-  // Don't ask PR_Base64Encode to encode empty strings.
   if (aBinaryLen == 0) {
     *aBase64 = (char*)moz_xmalloc(1);
     (*aBase64)[0] = '\0';
@@ -307,18 +412,34 @@ Base64Encode(const char* aBinary, uint32_t aBinaryLen, char** aBase64)
     return NS_ERROR_OUT_OF_MEMORY;
   }
 
-  if (!PL_Base64Encode(aBinary, aBinaryLen, base64.get())) {
-    return NS_ERROR_INVALID_ARG;
-  }
-
-  // PL_Base64Encode doesn't null terminate the buffer for us when we pass
-  // the buffer in. Do that manually.
+  Encode(aBinary, aBinaryLen, base64.get());
   base64[base64Len] = '\0';
 
   *aBase64 = base64.release();
   return NS_OK;
 }
 
+nsresult
+Base64EncodeAppend(const char* aBinary, uint32_t aBinaryLen,
+                   nsACString& aBase64)
+{
+  // Check for overflow.
+  if (aBinaryLen > (UINT32_MAX / 4) * 3) {
+    return NS_ERROR_FAILURE;
+  }
+
+  uint32_t oldLength = aBase64.Length();
+  CheckedInt<uint32_t> newLength(((aBinaryLen + 2) / 3) * 4);
+  newLength += oldLength;
+  if (!newLength.isValid() ||
+      !aBase64.SetLength(newLength.value(), fallible)) {
+    return NS_ERROR_OUT_OF_MEMORY;
+  }
+
+  Encode(aBinary, aBinaryLen, aBase64.BeginWriting() + oldLength);
+  return NS_OK;
+}
+
 nsresult
 Base64Encode(const nsACString& aBinary, nsACString& aBase64)
 {
@@ -327,7 +448,6 @@ Base64Encode(const nsACString& aBinary, nsACString& aBase64)
     return NS_ERROR_FAILURE;
   }
 
-  // Don't ask PR_Base64Encode to encode empty strings.
   if (aBinary.IsEmpty()) {
     aBase64.Truncate();
     return NS_OK;
@@ -341,13 +461,7 @@ Base64Encode(const nsACString& aBinary, nsACString& aBase64)
   }
 
   char* base64 = aBase64.BeginWriting();
-  if (!PL_Base64Encode(aBinary.BeginReading(), aBinary.Length(), base64)) {
-    aBase64.Truncate();
-    return NS_ERROR_INVALID_ARG;
-  }
-
-  // PL_Base64Encode doesn't null terminate the buffer for us when we pass
-  // the buffer in. Do that manually.
+  Encode(aBinary.BeginReading(), aBinary.Length(), base64);
   base64[base64Len] = '\0';
 
   aBase64.SetLength(base64Len);
@@ -357,50 +471,51 @@ Base64Encode(const nsACString& aBinary, nsACString& aBase64)
 nsresult
 Base64Encode(const nsAString& aBinary, nsAString& aBase64)
 {
-  auto truncater = mozilla::MakeScopeExit([&]() { aBase64.Truncate(); });
-
-  // XXX We should really consider decoding directly from the string, rather
-  // than making a separate copy here.
-  nsAutoCString binary;
-  if (!binary.SetCapacity(aBinary.Length(), mozilla::fallible)) {
-    return NS_ERROR_OUT_OF_MEMORY;
+  // The encoded string is longer than the input, so it can't be written over
+  // it.
+  if (&aBinary == &aBase64) {
+    nsAutoString binary;
+    if (!binary.Assign(aBinary, mozilla::fallible)) {
+      aBase64.Truncate();
+      return NS_ERROR_OUT_OF_MEMORY;
+    }
+    return Base64Encode(binary, aBase64);
   }
-  LossyCopyUTF16toASCII(aBinary, binary);
 
-  nsAutoCString base64;
+  // Check for overflow.
+  if (aBinary.Length() > (UINT32_MAX / 4) * 3) {
+    aBase64.Truncate();
+    return NS_ERROR_FAILURE;
+  }
 
-  nsresult rv = Base64Encode(binary, base64);
-  NS_ENSURE_SUCCESS(rv, rv);
+  if (aBinary.IsEmpty()) {
+    aBase64.Truncate();
+    return NS_OK;
+  }
 
-  if (!CopyASCIItoUTF16(base64, aBase64, mozilla::fallible)) {
+  uint32_t base64Len = ((aBinary.Length() + 2) / 3) * 4;
+  if (!aBase64.SetLength(base64Len, mozilla::fallible)) {
+    aBase64.Truncate();
     return NS_ERROR_OUT_OF_MEMORY;
   }
 
-  truncater.release();
-
-  return rv;
+  // Like LossyCopyUTF16toASCII, only the low byte of each character is
+  // encoded.
+  Encode(aBinary.BeginReading(), aBinary.Length(), aBase64.BeginWriting());
+  return NS_OK;
 }
 
+template<typename T, typename U>
 static nsresult
-Base64DecodeHelper(const char* aBase64, uint32_t aBase64Len, char* aBinary,
+Base64DecodeHelper(const T* aBase64, uint32_t aBase64Len, U* aBinary,
                    uint32_t* aBinaryLen)
 {
   MOZ_ASSERT(aBinary);
-  if (!PL_Base64Decode(aBase64, aBase64Len, aBinary)) {
+  if (!Decode(aBase64, aBase64Len, aBinary, aBinaryLen)) {
     return NS_ERROR_INVALID_ARG;
   }
 
-  // PL_Base64Decode doesn't null terminate the buffer for us when we pass
-  // the buffer in. Do that manually, taking into account the number of '='
-  // characters we were passed.
-  if (aBase64Len != 0 && aBase64[aBase64Len - 1] == '=') {
-    if (aBase64Len > 1 && aBase64[aBase64Len - 2] == '=') {
-      *aBinaryLen -= 2;
-    } else {
-      *aBinaryLen -= 1;
-    }
-  }
-  aBinary[*aBinaryLen] = '\0';
+  aBinary[*aBinaryLen] = U('\0');
   return NS_OK;
 }
 
@@ -413,7 +528,6 @@ Base64Decode(const char* aBase64, uint32_t aBase64Len, char** aBinary,
     return NS_ERROR_FAILURE;
   }
 
-  // Don't ask PR_Base64Decode to decode the empty string.
   if (aBase64Len == 0) {
     *aBinary = (char*)moz_xmalloc(1);
     (*aBinary)[0] = '\0';
@@ -448,7 +562,6 @@ Base64Decode(const nsACString& aBase64, nsACString& aBinary)
     return NS_ERROR_FAILURE;
   }
 
-  // Don't ask PR_Base64Decode to decode the empty string
   if (aBase64.IsEmpty()) {
     aBinary.Truncate();
     return NS_OK;
@@ -476,28 +589,36 @@ Base64Decode(const nsACString& aBase64, nsACString& aBinary)
 nsresult
 Base64Decode(const nsAString& aBase64, nsAString& aBinary)
 {
-  auto truncater = mozilla::MakeScopeExit([&]() { aBinary.Truncate(); });
-
-  // XXX We should really consider decoding directly from the string, rather
-  // than making a separate copy here.
-  nsAutoCString base64;
-  if (!base64.SetCapacity(aBase64.Length(), mozilla::fallible)) {
-    return NS_ERROR_OUT_OF_MEMORY;
+  // Check for overflow.
+  if (aBase64.Length() > UINT32_MAX / 3) {
+    aBinary.Truncate();
+    return NS_ERROR_FAILURE;
   }
-  LossyCopyUTF16toASCII(aBase64, base64);
 
-  nsAutoCString binary;
+  if (aBase64.IsEmpty()) {
+    aBinary.Truncate();
+    return NS_OK;
+  }
 
-  nsresult rv = Base64Decode(base64, binary);
-  NS_ENSURE_SUCCESS(rv, rv);
+  uint32_t binaryLen = ((aBase64.Length() * 3) / 4);
 
-  if (!CopyASCIItoUTF16(binary, aBinary, mozilla::fallible)) {
+  // Add one character for null termination.  Decoding is still fine if both
+  // strings are the same, as the output never overtakes the input.
+  if (!aBinary.SetCapacity(binaryLen + 1, fallible)) {
+    aBinary.Truncate();
     return NS_ERROR_OUT_OF_MEMORY;
   }
 
-  truncater.release();
+  char16_t* binary = aBinary.BeginWriting();
+  nsresult rv = Base64DecodeHelper(aBase64.BeginReading(), aBase64.Length(),
+                                   binary, &binaryLen);
+  if (NS_FAILED(rv)) {
+    aBinary.Truncate();
+    return rv;
+  }
 
-  return rv;
+  aBinary.SetLength(binaryLen);
+  return NS_OK;
 }
 
 nsresult
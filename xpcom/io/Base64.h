@@ -31,6 +31,15 @@ Base64Encode(const nsACString& aBinary, nsACString& aBase64);
 MOZ_MUST_USE nsresult
 Base64Encode(const nsAString& aBinary, nsAString& aBase64);
 
+/**
+ * Appends the Base64 encoding of |aBinary| to |aBase64|.  Unless this is the
+ * end of the data, |aBinaryLen| should be a multiple of 3, so that no padding
+ * is written in the middle of the encoded string.
+ */
+MOZ_MUST_USE nsresult
+Base64EncodeAppend(const char* aBinary, uint32_t aBinaryLen,
+                   nsACString& aBase64);
+
 MOZ_MUST_USE nsresult
 Base64Decode(const char* aBase64, uint32_t aBase64Len, char** aBinary,
              uint32_t* aBinaryLen);
@@ -150,6 +150,18 @@ FileDescriptorFile::GetFollowLinks(bool* aFollowLinks)
   return mFile->GetFollowLinks(aFollowLinks);
 }
 
+NS_IMETHODIMP
+FileDescriptorFile::GetUseStatCache(bool* aUseStatCache)
+{
+  return mFile->GetUseStatCache(aUseStatCache);
+}
+
+NS_IMETHODIMP
+FileDescriptorFile::InvalidateStatCache()
+{
+  return mFile->InvalidateStatCache();
+}
+
 //-----------------------------------------------------------------------------
 // FileDescriptorFile::nsIFile functions that are not currently supported
 //-----------------------------------------------------------------------------
@@ -214,6 +226,12 @@ FileDescriptorFile::SetFollowLinks(bool aFollowLinks)
   return NS_ERROR_NOT_IMPLEMENTED;
 }
 
+NS_IMETHODIMP
+FileDescriptorFile::SetUseStatCache(bool aUseStatCache)
+{
+  return NS_ERROR_NOT_IMPLEMENTED;
+}
+
 nsresult
 FileDescriptorFile::AppendRelativePath(const nsAString& aNode)
 {
@@ -118,11 +118,15 @@ protected:
   DIR*           mDir;
   struct dirent* mEntry;
   nsCString      mParentPath;
+  // Whether to stat the entries as they are enumerated, for the stat cache of
+  // the files we return.
+  bool           mUseStatCache;
 };
 
 nsDirEnumeratorUnix::nsDirEnumeratorUnix() :
   mDir(nullptr),
-  mEntry(nullptr)
+  mEntry(nullptr),
+  mUseStatCache(false)
 {
 }
 
@@ -152,6 +156,7 @@ nsDirEnumeratorUnix::Init(nsLocalFile* aParent,
   if (!mDir) {
     return NSRESULT_FOR_ERRNO();
   }
+  mUseStatCache = aParent->mUseStatCache;
   return GetNextEntry();
 }
 
@@ -206,13 +211,24 @@ nsDirEnumeratorUnix::GetNextFile(nsIFile** aResult)
     return NS_OK;
   }
 
-  nsCOMPtr<nsIFile> file = new nsLocalFile();
+  RefPtr<nsLocalFile> file = new nsLocalFile();
 
   if (NS_FAILED(rv = file->InitWithNativePath(mParentPath)) ||
       NS_FAILED(rv = file->AppendNative(nsDependentCString(mEntry->d_name)))) {
     return rv;
   }
 
+  if (mUseStatCache) {
+    // Stat the entry relative to the directory we are reading, which saves
+    // the kernel from resolving the whole path again, and hand the result to
+    // the file so that asking it for its metadata doesn't stat it again.
+    file->mUseStatCache = true;
+    file->mStatCacheValid =
+      FSTATAT(dirfd(mDir), mEntry->d_name, &file->mCachedStat, 0) == 0 ||
+      FSTATAT(dirfd(mDir), mEntry->d_name, &file->mCachedStat,
+              AT_SYMLINK_NOFOLLOW) == 0;
+  }
+
   file.forget(aResult);
   return GetNextEntry();
 }
@@ -228,11 +244,16 @@ nsDirEnumeratorUnix::Close()
 }
 
 nsLocalFile::nsLocalFile()
+  : mUseStatCache(false)
+  , mStatCacheValid(false)
 {
 }
 
 nsLocalFile::nsLocalFile(const nsLocalFile& aOther)
-  : mPath(aOther.mPath)
+  : mCachedStat(aOther.mCachedStat)
+  , mPath(aOther.mPath)
+  , mUseStatCache(aOther.mUseStatCache)
+  , mStatCacheValid(aOther.mStatCacheValid)
 {
 }
 
@@ -268,15 +289,45 @@ nsLocalFile::nsLocalFileConstructor(nsISupports* aOuter,
 bool
 nsLocalFile::FillStatCache()
 {
+  if (mStatCacheValid) {
+    return true;
+  }
+
   if (STAT(mPath.get(), &mCachedStat) == -1) {
     // try lstat it may be a symlink
     if (LSTAT(mPath.get(), &mCachedStat) == -1) {
       return false;
     }
   }
+  mStatCacheValid = mUseStatCache;
   return true;
 }
 
+NS_IMETHODIMP
+nsLocalFile::GetUseStatCache(bool* aUseStatCache)
+{
+  if (NS_WARN_IF(!aUseStatCache)) {
+    return NS_ERROR_INVALID_ARG;
+  }
+  *aUseStatCache = mUseStatCache;
+  return NS_OK;
+}
+
+NS_IMETHODIMP
+nsLocalFile::SetUseStatCache(bool aUseStatCache)
+{
+  mUseStatCache = aUseStatCache;
+  mStatCacheValid = false;
+  return NS_OK;
+}
+
+NS_IMETHODIMP
+nsLocalFile::InvalidateStatCache()
+{
+  mStatCacheValid = false;
+  return NS_OK;
+}
+
 NS_IMETHODIMP
 nsLocalFile::Clone(nsIFile** aFile)
 {
@@ -309,6 +360,7 @@ nsLocalFile::InitWithNativePath(const nsACString& aFilePath)
     }
     mPath = aFilePath;
   }
+  mStatCacheValid = false;
 
   // trim off trailing slashes
   ssize_t len = mPath.Length();
@@ -394,6 +446,7 @@ NS_IMETHODIMP
 nsLocalFile::OpenNSPRFileDesc(int32_t aFlags, int32_t aMode,
                               PRFileDesc** aResult)
 {
+  mStatCacheValid = false;
   *aResult = PR_Open(mPath.get(), aFlags, aMode);
   if (!*aResult) {
     return NS_ErrorAccordingToNSPR();
@@ -415,6 +468,7 @@ nsLocalFile::OpenNSPRFileDesc(int32_t aFlags, int32_t aMode,
 NS_IMETHODIMP
 nsLocalFile::OpenANSIFileDesc(const char* aMode, FILE** aResult)
 {
+  mStatCacheValid = false;
   *aResult = fopen(mPath.get(), aMode);
   if (!*aResult) {
     return NS_ERROR_FAILURE;
@@ -448,6 +502,8 @@ nsLocalFile::CreateAndKeepOpen(uint32_t aType, int aFlags,
   int (*createFunc)(const char*, int, mode_t, PRFileDesc**) =
     (aType == NORMAL_FILE_TYPE) ? do_create : do_mkdir;
 
+  mStatCacheValid = false;
+
   int result = createFunc(mPath.get(), aFlags, aPermissions, aResult);
   if (result == -1 && errno == ENOENT) {
     /*
@@ -535,6 +591,7 @@ nsLocalFile::AppendRelativeNativePath(const nsACString& aFragment)
     mPath.Append('/');
   }
   mPath.Append(aFragment);
+  mStatCacheValid = false;
 
   return NS_OK;
 }
@@ -553,6 +610,7 @@ nsLocalFile::Normalize()
   }
 
   mPath = resolved_path;
+  mStatCacheValid = false;
   return NS_OK;
 }
 
@@ -593,6 +651,7 @@ nsLocalFile::SetNativeLeafName(const nsACString& aLeafName)
   nsACString::const_iterator begin, end;
   LocateNativeLeafName(begin, end);
   mPath.Replace(begin.get() - mPath.get(), Distance(begin, end), aLeafName);
+  mStatCacheValid = false;
   return NS_OK;
 }
 
@@ -1001,6 +1060,8 @@ nsLocalFile::MoveToNative(nsIFile* aNewParent, const nsACString& aNewName)
     return rv;
   }
 
+  mStatCacheValid = false;
+
   // try for atomic rename, falling back to copy/delete
   if (rename(mPath.get(), newPathName.get()) < 0) {
     if (errno == EXDEV) {
@@ -1033,6 +1094,9 @@ nsLocalFile::Remove(bool aRecursive)
     return rv;
   }
 
+  // mCachedStat stays usable below, but won't describe the file anymore.
+  mStatCacheValid = false;
+
   if (isSymLink || !S_ISDIR(mCachedStat.st_mode)) {
     return NSRESULT_FOR_RETURN(unlink(mPath.get()));
   }
@@ -1084,6 +1148,19 @@ nsLocalFile::GetLastModifiedTime(PRTime* aLastModTime)
     return NS_ERROR_INVALID_ARG;
   }
 
+  if (mUseStatCache) {
+    ENSURE_STAT_CACHE();
+    // Behave like PR_GetFileInfo64, which doesn't fall back to the link.
+    if (S_ISLNK(mCachedStat.st_mode)) {
+      return NS_ERROR_FILE_NOT_FOUND;
+    }
+    *aLastModTime = PRTime(mCachedStat.st_mtime) * PR_MSEC_PER_SEC;
+#ifdef XP_DARWIN
+    *aLastModTime += mCachedStat.st_mtimespec.tv_nsec / PR_NSEC_PER_MSEC;
+#endif
+    return NS_OK;
+  }
+
   PRFileInfo64 info;
   if (PR_GetFileInfo64(mPath.get(), &info) != PR_SUCCESS) {
     return NSRESULT_FOR_ERRNO();
@@ -1115,6 +1192,7 @@ nsLocalFile::SetLastModifiedTime(PRTime aLastModTime)
   } else {
     result = utime(mPath.get(), nullptr);
   }
+  mStatCacheValid = false;
   return NSRESULT_FOR_RETURN(result);
 }
 
@@ -1187,6 +1265,7 @@ nsLocalFile::SetPermissions(uint32_t aPermissions)
    * Race condition here: we should use fchmod instead, there's no way to
    * guarantee the name still refers to the same file.
    */
+  mStatCacheValid = false;
   if (chmod(mPath.get(), aPermissions) >= 0) {
     return NS_OK;
   }
@@ -1233,6 +1312,7 @@ NS_IMETHODIMP
 nsLocalFile::SetFileSize(int64_t aFileSize)
 {
   CHECK_mPath();
+  mStatCacheValid = false;
 
 #if defined(ANDROID)
   /* no truncate on bionic */
@@ -1480,6 +1560,12 @@ nsLocalFile::Exists(bool* aResult)
     return NS_ERROR_INVALID_ARG;
   }
 
+  if (mUseStatCache) {
+    // Like access(), don't count a dangling symlink as existing.
+    *aResult = FillStatCache() && !S_ISLNK(mCachedStat.st_mode);
+    return NS_OK;
+  }
+
   *aResult = (access(mPath.get(), F_OK) == 0);
   return NS_OK;
 }
@@ -2151,6 +2237,8 @@ nsLocalFile::RenameToNative(nsIFile* aNewParentDir, const nsACString& aNewName)
     return rv;
   }
 
+  mStatCacheValid = false;
+
   // try for atomic rename
   if (rename(mPath.get(), newPathName.get()) < 0) {
     if (errno == EXDEV) {
@@ -72,10 +72,12 @@
   #endif
   #define STAT stat64
   #define LSTAT lstat64
+  #define FSTATAT fstatat64
   #define HAVE_STATS64 1
 #else
   #define STAT stat
   #define LSTAT lstat
+  #define FSTATAT fstatat
 #endif
 
 
@@ -114,10 +116,17 @@ private:
   }
 
 protected:
-  // This stat cache holds the *last stat* - it does not invalidate.
-  // Call "FillStatCache" whenever you want to stat our file.
+  friend class nsDirEnumeratorUnix;
+
+  // This stat cache holds the *last stat*.  Unless mUseStatCache is set it
+  // does not invalidate: call "FillStatCache" whenever you want to stat our
+  // file.  With mUseStatCache, FillStatCache only stats the file when
+  // mStatCacheValid is false, which InvalidateStatCache() and everything
+  // changing mPath or the file itself through us makes it.
   struct STAT  mCachedStat;
   nsCString    mPath;
+  bool         mUseStatCache;
+  bool         mStatCacheValid;
 
   void LocateNativeLeafName(nsACString::const_iterator&,
                             nsACString::const_iterator&);
@@ -934,6 +934,7 @@ nsLocalFile::nsLocalFile()
   : mDirty(true)
   , mResolveDirty(true)
   , mFollowSymlinks(false)
+  , mUseStatCache(false)
 {
 }
 
@@ -976,6 +977,7 @@ nsLocalFile::nsLocalFile(const nsLocalFile& aOther)
   : mDirty(true)
   , mResolveDirty(true)
   , mFollowSymlinks(aOther.mFollowSymlinks)
+  , mUseStatCache(aOther.mUseStatCache)
   , mWorkingPath(aOther.mWorkingPath)
 {
 }
@@ -2864,7 +2866,9 @@ nsLocalFile::Exists(bool* aResult)
   }
   *aResult = false;
 
-  MakeDirty();
+  if (!mUseStatCache) {
+    MakeDirty();
+  }
   nsresult rv = ResolveAndStat();
   *aResult = NS_SUCCEEDED(rv) || rv == NS_ERROR_FILE_IS_LOCKED;
 
@@ -3268,6 +3272,28 @@ nsLocalFile::SetFollowLinks(bool aFollowLinks)
   return NS_OK;
 }
 
+NS_IMETHODIMP
+nsLocalFile::GetUseStatCache(bool* aUseStatCache)
+{
+  *aUseStatCache = mUseStatCache;
+  return NS_OK;
+}
+
+NS_IMETHODIMP
+nsLocalFile::SetUseStatCache(bool aUseStatCache)
+{
+  MakeDirty();
+  mUseStatCache = aUseStatCache;
+  return NS_OK;
+}
+
+NS_IMETHODIMP
+nsLocalFile::InvalidateStatCache()
+{
+  MakeDirty();
+  return NS_OK;
+}
+
 
 NS_IMETHODIMP
 nsLocalFile::GetDirectoryEntries(nsISimpleEnumerator** aEntries)
@@ -74,6 +74,7 @@ private:
   bool mDirty;            // cached information can only be used when this is false
   bool mResolveDirty;
   bool mFollowSymlinks;   // should we follow symlinks when working on this file
+  bool mUseStatCache;     // whether Exists() may use the cached information
 
   // this string will always be in native format!
   nsString mWorkingPath;
@@ -10,6 +10,7 @@
 #include <algorithm>
 
 #include "mozilla/CheckedInt.h"
+#include "mozilla/arm.h"
 
 #include "nscore.h"
 #include "nsMemory.h"
@@ -69,6 +70,75 @@ FirstNonASCIIUnvectorized(const char16_t* aBegin, const char16_t* aEnd)
 static inline int32_t
 FirstNonASCII(const char16_t* aBegin, const char16_t* aEnd)
 {
+#ifdef BUILD_ARM_NEON
+  if (mozilla::supports_neon()) {
+    return mozilla::NEON::FirstNonASCII(aBegin, aEnd);
+  }
+#endif
+
+#ifdef MOZILLA_MAY_SUPPORT_SSE2
+  if (mozilla::supports_sse2()) {
+    return mozilla::SSE2::FirstNonASCII(aBegin, aEnd);
+  }
+#endif
+
+  return FirstNonASCIIUnvectorized(aBegin, aEnd);
+}
+
+/**
+ * Fallback implementation for finding the first non-ASCII character in an
+ * 8-bit string.
+ */
+static inline int32_t
+FirstNonASCIIUnvectorized(const char* aBegin, const char* aEnd)
+{
+  typedef mozilla::NonASCIIParameters<sizeof(size_t)> p;
+  const size_t kMask = p::charMask();
+  const uintptr_t kAlignMask = p::alignMask();
+  const size_t kNumCharsPerWord = sizeof(size_t);
+
+  const char* idx = aBegin;
+
+  // Align ourselves to a word boundary.
+  for (; idx != aEnd && ((uintptr_t(idx) & kAlignMask) != 0); idx++) {
+    if (!IsASCII(*idx)) {
+      return idx - aBegin;
+    }
+  }
+
+  // Check one word at a time.
+  const char* wordWalkEnd = mozilla::aligned(aEnd, kAlignMask);
+  for (; idx != wordWalkEnd; idx += kNumCharsPerWord) {
+    const size_t word = *reinterpret_cast<const size_t*>(idx);
+    if (word & kMask) {
+      return idx - aBegin;
+    }
+  }
+
+  // Take care of the remainder one character at a time.
+  for (; idx != aEnd; idx++) {
+    if (!IsASCII(*idx)) {
+      return idx - aBegin;
+    }
+  }
+
+  return -1;
+}
+
+/*
+ * Like the UTF-16 version above: returns -1 if all characters are ASCII,
+ * otherwise a value less than or equal to the index of the first non-ASCII
+ * character.
+ */
+static inline int32_t
+FirstNonASCII(const char* aBegin, const char* aEnd)
+{
+#ifdef BUILD_ARM_NEON
+  if (mozilla::supports_neon()) {
+    return mozilla::NEON::FirstNonASCII(aBegin, aEnd);
+  }
+#endif
+
 #ifdef MOZILLA_MAY_SUPPORT_SSE2
   if (mozilla::supports_sse2()) {
     return mozilla::SSE2::FirstNonASCII(aBegin, aEnd);
@@ -350,12 +420,31 @@ bool
 AppendUTF8toUTF16(const nsACString& aSource, nsAString& aDest,
                   const mozilla::fallible_t& aFallible)
 {
+  // Same threshold as in AppendUTF16toUTF8.
+  const nsACString::size_type kFastPathMinLength = 16;
+
+  int32_t firstNonASCII = 0;
+  if (aSource.Length() >= kFastPathMinLength) {
+    firstNonASCII = FirstNonASCII(aSource.BeginReading(), aSource.EndReading());
+  }
+
+  if (firstNonASCII == -1) {
+    // This is all ASCII, we can use the more efficient lossy append.
+    return AppendASCIItoUTF16(aSource, aDest, aFallible);
+  }
+
   nsACString::const_iterator source_start, source_end;
   CalculateUTF8Length calculator;
-  copy_string(aSource.BeginReading(source_start),
-              aSource.EndReading(source_end), calculator);
+  aSource.BeginReading(source_start);
+  aSource.EndReading(source_end);
 
-  uint32_t count = calculator.Length();
+  // Skip the characters that we know are single byte.
+  source_start.advance(firstNonASCII);
+
+  copy_string(source_start, source_end, calculator);
+
+  // Include the ASCII characters that were skipped in the count.
+  uint32_t count = calculator.Length() + firstNonASCII;
 
   // Avoid making the string mutable if we're appending an empty string
   if (count) {
@@ -368,12 +457,30 @@ AppendUTF8toUTF16(const nsACString& aSource, nsAString& aDest,
 
     // All ready? Time to convert
 
-    ConvertUTF8toUTF16 converter(aDest.BeginWriting() + old_dest_length);
-    copy_string(aSource.BeginReading(source_start),
-                aSource.EndReading(source_end), converter);
+    nsACString::const_iterator ascii_end;
+    aSource.BeginReading(ascii_end);
+
+    if (firstNonASCII >= static_cast<int32_t>(kFastPathMinLength)) {
+      // Use the more efficient lossy converter for the ASCII portion.
+      LossyConvertEncoding8to16 lossy_converter(
+          aDest.BeginWriting() + old_dest_length);
+      nsACString::const_iterator ascii_start;
+      aSource.BeginReading(ascii_start);
+      ascii_end.advance(firstNonASCII);
+
+      copy_string(ascii_start, ascii_end, lossy_converter);
+    } else {
+      // Not using the lossy shortcut, we need to include the leading ASCII
+      // chars.
+      firstNonASCII = 0;
+    }
+
+    ConvertUTF8toUTF16 converter(
+        aDest.BeginWriting() + old_dest_length + firstNonASCII);
+    copy_string(ascii_end, aSource.EndReading(source_end), converter);
 
     NS_ASSERTION(converter.ErrorEncountered() ||
-                 converter.Length() == count,
+                 converter.Length() == count - firstNonASCII,
                  "CalculateUTF8Length produced the wrong length");
 
     if (converter.ErrorEncountered()) {
@@ -596,49 +703,13 @@ AppendUnicodeTo(const nsAString::const_iterator& aSrcStart,
 bool
 IsASCII(const nsAString& aString)
 {
-  static const char16_t NOT_ASCII = char16_t(~0x007F);
-
-
-  // Don't want to use |copy_string| for this task, since we can stop at the first non-ASCII character
-
-  nsAString::const_iterator iter, done_reading;
-  aString.BeginReading(iter);
-  aString.EndReading(done_reading);
-
-  const char16_t* c = iter.get();
-  const char16_t* end = done_reading.get();
-
-  while (c < end) {
-    if (*c++ & NOT_ASCII) {
-      return false;
-    }
-  }
-
-  return true;
+  return FirstNonASCII(aString.BeginReading(), aString.EndReading()) == -1;
 }
 
 bool
 IsASCII(const nsACString& aString)
 {
-  static const char NOT_ASCII = char(~0x7F);
-
-
-  // Don't want to use |copy_string| for this task, since we can stop at the first non-ASCII character
-
-  nsACString::const_iterator iter, done_reading;
-  aString.BeginReading(iter);
-  aString.EndReading(done_reading);
-
-  const char* c = iter.get();
-  const char* end = done_reading.get();
-
-  while (c < end) {
-    if (*c++ & NOT_ASCII) {
-      return false;
-    }
-  }
-
-  return true;
+  return FirstNonASCII(aString.BeginReading(), aString.EndReading()) == -1;
 }
 
 bool
@@ -657,6 +728,9 @@ IsUTF8(const nsACString& aString, bool aRejectNonChar)
   nsReadingIterator<char> iter;
   aString.BeginReading(iter);
 
+  // Runs of ASCII at least this long are skipped with |FirstNonASCII|.
+  const ptrdiff_t kFastPathMinLength = 16;
+
   const char* ptr = iter.get();
   const char* end = done_reading.get();
   while (ptr < end) {
@@ -666,6 +740,10 @@ IsUTF8(const nsACString& aString, bool aRejectNonChar)
       c = *ptr++;
 
       if (UTF8traits::isASCII(c)) {
+        if (end - ptr >= kFastPathMinLength) {
+          int32_t firstNonASCII = FirstNonASCII(ptr, end);
+          ptr = firstNonASCII == -1 ? end : ptr + firstNonASCII;
+        }
         continue;
       }
 
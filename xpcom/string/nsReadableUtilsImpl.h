@@ -12,6 +12,10 @@ inline bool IsASCII(char16_t aChar) {
   return (aChar & 0xFF80) == 0;
 }
 
+inline bool IsASCII(char aChar) {
+  return (aChar & 0x80) == 0;
+}
+
 /**
  * Provides a pointer before or equal to |aPtr| that is is suitably aligned.
  */
@@ -21,13 +25,20 @@ inline const char16_t* aligned(const char16_t* aPtr, const uintptr_t aMask)
       reinterpret_cast<const uintptr_t>(aPtr) & ~aMask);
 }
 
+inline const char* aligned(const char* aPtr, const uintptr_t aMask)
+{
+  return reinterpret_cast<const char*>(
+      reinterpret_cast<const uintptr_t>(aPtr) & ~aMask);
+}
+
 /**
- * Structures for word-sized vectorization of ASCII checking for UTF-16
- * strings.
+ * Structures for word-sized vectorization of ASCII checking for UTF-16 and
+ * 8-bit strings.
  */
 template<size_t size> struct NonASCIIParameters;
 template<> struct NonASCIIParameters<4> {
   static inline size_t mask() { return 0xff80ff80; }
+  static inline size_t charMask() { return 0x80808080; }
   static inline uintptr_t alignMask() { return 0x3; }
   static inline size_t numUnicharsPerWord() { return 2; }
 };
@@ -42,6 +53,10 @@ template<> struct NonASCIIParameters<8> {
     // So it is, in fact, OK that this value is too large for a 32-bit size_t.)
     return (size_t)maskAsUint64;
   }
+  static inline size_t charMask() {
+    static const uint64_t maskAsUint64 = UINT64_C(0x8080808080808080);
+    return (size_t)maskAsUint64;
+  }
   static inline uintptr_t alignMask() { return 0x7; }
   static inline size_t numUnicharsPerWord() { return 4; }
 };
@@ -49,6 +64,14 @@ template<> struct NonASCIIParameters<8> {
 namespace SSE2 {
 
 int32_t FirstNonASCII(const char16_t* aBegin, const char16_t* aEnd);
+int32_t FirstNonASCII(const char* aBegin, const char* aEnd);
 
 } // namespace SSE2
+
+namespace NEON {
+
+int32_t FirstNonASCII(const char16_t* aBegin, const char16_t* aEnd);
+int32_t FirstNonASCII(const char* aBegin, const char* aEnd);
+
+} // namespace NEON
 } // namespace mozilla
@@ -0,0 +1,83 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <arm_neon.h>
+
+#include "nsReadableUtilsImpl.h"
+
+namespace mozilla {
+namespace NEON {
+
+// ARMv7 has no horizontal reductions, so fold a vector into 64 bits and test
+// those against the mask of the non-ASCII bits.
+static inline bool
+any_bits (uint8x16_t x, uint64_t aMask)
+{
+  uint8x8_t folded = vorr_u8(vget_low_u8(x), vget_high_u8(x));
+  return (vget_lane_u64(vreinterpret_u64_u8(folded), 0) & aMask) != 0;
+}
+
+int32_t
+FirstNonASCII(const char16_t* aBegin, const char16_t* aEnd)
+{
+  const size_t kNumUnicharsPerVector = 16 / sizeof(char16_t);
+  const uint64_t kMask = UINT64_C(0xff80ff80ff80ff80);
+
+  const char16_t* idx = aBegin;
+
+  // Check two Q registers (16 characters) at a time.  Unaligned loads are as
+  // fast as aligned ones, so there is no alignment prologue.
+  for (; aEnd - idx >= ptrdiff_t(2 * kNumUnicharsPerVector);
+       idx += 2 * kNumUnicharsPerVector) {
+    const uint16_t* p = reinterpret_cast<const uint16_t*>(idx);
+    uint16x8_t vect = vorrq_u16(vld1q_u16(p), vld1q_u16(p + kNumUnicharsPerVector));
+    if (any_bits(vreinterpretq_u8_u16(vect), kMask)) {
+      break;
+    }
+  }
+
+  // Find the exact position, or take care of the remainder, one character at
+  // a time.
+  for (; idx != aEnd; idx++) {
+    if (!IsASCII(*idx)) {
+      return idx - aBegin;
+    }
+  }
+
+  return -1;
+}
+
+int32_t
+FirstNonASCII(const char* aBegin, const char* aEnd)
+{
+  const size_t kNumCharsPerVector = 16;
+  const uint64_t kMask = UINT64_C(0x8080808080808080);
+
+  const char* idx = aBegin;
+
+  // Check two Q registers (32 bytes) at a time.
+  for (; aEnd - idx >= ptrdiff_t(2 * kNumCharsPerVector);
+       idx += 2 * kNumCharsPerVector) {
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(idx);
+    uint8x16_t vect = vorrq_u8(vld1q_u8(p), vld1q_u8(p + kNumCharsPerVector));
+    if (any_bits(vect, kMask)) {
+      break;
+    }
+  }
+
+  // Find the exact position, or take care of the remainder, one character at
+  // a time.
+  for (; idx != aEnd; idx++) {
+    if (!IsASCII(*idx)) {
+      return idx - aBegin;
+    }
+  }
+
+  return -1;
+}
+
+} // namespace NEON
+} // namespace mozilla
@@ -7,6 +7,7 @@
 #include <emmintrin.h>
 
 #include "nsReadableUtilsImpl.h"
+#include "mozilla/MathAlgorithms.h"
 
 namespace mozilla {
 namespace SSE2 {
@@ -66,5 +67,54 @@ FirstNonASCII(const char16_t* aBegin, const char16_t* aEnd)
   return -1;
 }
 
+int32_t
+FirstNonASCII(const char* aBegin, const char* aEnd)
+{
+  const size_t kNumCharsPerVector = sizeof(__m128i);
+  const uintptr_t kXmmAlignMask = 0xf;
+
+  const char* idx = aBegin;
+
+  // Align ourselves to a 16-byte boundary as required by _mm_load_si128
+  for (; idx != aEnd && ((uintptr_t(idx) & kXmmAlignMask) != 0); idx++) {
+    if (!IsASCII(*idx)) {
+      return idx - aBegin;
+    }
+  }
+
+  // Check four XMM registers (64 bytes) at a time.  _mm_movemask_epi8
+  // collects the high bit of every byte, so it is non-zero as soon as one of
+  // the bytes isn't ASCII.
+  const char* vectWalkEnd = aligned(aEnd, kXmmAlignMask);
+  for (; vectWalkEnd - idx >= 4 * ptrdiff_t(kNumCharsPerVector);
+       idx += 4 * kNumCharsPerVector) {
+    const __m128i* vect = reinterpret_cast<const __m128i*>(idx);
+    __m128i folded = _mm_or_si128(_mm_or_si128(vect[0], vect[1]),
+                                  _mm_or_si128(vect[2], vect[3]));
+    if (_mm_movemask_epi8(folded)) {
+      break;
+    }
+  }
+
+  // Check one XMM register at a time, which also finds the exact position of
+  // the non-ASCII character in the block the loop above stopped at.
+  for (; idx != vectWalkEnd; idx += kNumCharsPerVector) {
+    const __m128i vect = *reinterpret_cast<const __m128i*>(idx);
+    int mask = _mm_movemask_epi8(vect);
+    if (mask) {
+      return idx - aBegin + CountTrailingZeroes32(mask);
+    }
+  }
+
+  // Take care of the remainder one character at a time.
+  for (; idx != aEnd; idx++) {
+    if (!IsASCII(*idx)) {
+      return idx - aBegin;
+    }
+  }
+
+  return -1;
+}
+
 } // namespace SSE2
 } // namespace mozilla
@@ -0,0 +1,111 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "mozilla/ArenaTArray.h"
+#include "nsTArray.h"
+
+#include "gtest/gtest.h"
+
+using mozilla::ArenaTArray;
+using mozilla::AutoTArrayArena;
+
+TEST(ArenaTArray, WithoutArena)
+{
+  ArenaTArray<int> a;
+  for (int i = 0; i < 1000; i++) {
+    a.AppendElement(i);
+  }
+  for (int i = 0; i < 1000; i++) {
+    EXPECT_EQ(i, a[i]);
+  }
+  a.Compact();
+  EXPECT_EQ(1000u, a.Length());
+}
+
+TEST(ArenaTArray, Grow)
+{
+  AutoTArrayArena arena;
+
+  // Grow beyond the largest size class, so the storage moves to the heap.
+  ArenaTArray<uint32_t> a;
+  for (uint32_t i = 0; i < 10000; i++) {
+    a.AppendElement(i);
+  }
+  for (uint32_t i = 0; i < 10000; i++) {
+    EXPECT_EQ(i, a[i]);
+  }
+
+  EXPECT_TRUE(a.AppendElement(10000u, mozilla::fallible));
+  a.RemoveElementsAt(10, a.Length() - 10);
+  a.Compact();
+  EXPECT_EQ(10u, a.Length());
+  EXPECT_EQ(9u, a[9]);
+}
+
+TEST(ArenaTArray, ReuseFreedBlocks)
+{
+  AutoTArrayArena arena;
+
+  const int* first;
+  {
+    ArenaTArray<int> a;
+    a.AppendElements(10);
+    first = a.Elements();
+  }
+
+  ArenaTArray<int> b;
+  b.AppendElements(10);
+  EXPECT_EQ(first, b.Elements());
+}
+
+TEST(ArenaTArray, Nested)
+{
+  AutoTArrayArena outer;
+  ArenaTArray<int> a;
+  a.AppendElement(0);
+  {
+    AutoTArrayArena inner;
+    ArenaTArray<int> b;
+    b.AppendElement(0);
+
+    // Growing |a| keeps it in the outer arena, so it can outlive |inner|.
+    for (int i = 1; i < 100; i++) {
+      a.AppendElement(i);
+    }
+  }
+  for (int i = 0; i < 100; i++) {
+    EXPECT_EQ(i, a[i]);
+  }
+}
+
+TEST(ArenaTArray, SwapWithHeapArray)
+{
+  AutoTArrayArena arena;
+
+  ArenaTArray<int> a;
+  nsTArray<int> b;
+  for (int i = 0; i < 100; i++) {
+    a.AppendElement(i);
+  }
+  b.AppendElement(-1);
+
+  a.SwapElements(b);
+  ASSERT_EQ(1u, a.Length());
+  ASSERT_EQ(100u, b.Length());
+  EXPECT_EQ(-1, a[0]);
+  for (int i = 0; i < 100; i++) {
+    EXPECT_EQ(i, b[i]);
+  }
+
+  nsTArray<int> c(mozilla::Move(a));
+  ASSERT_EQ(1u, c.Length());
+  EXPECT_EQ(-1, c[0]);
+  EXPECT_TRUE(a.IsEmpty());
+
+  ArenaTArray<int> d(mozilla::Move(b));
+  EXPECT_EQ(100u, d.Length());
+  EXPECT_TRUE(b.IsEmpty());
+}
@@ -4,11 +4,13 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
 
 #include "mozilla/Attributes.h"
+#include "mozilla/Base64.h"
 #include "nsIScriptableBase64Encoder.h"
 #include "nsIInputStream.h"
 #include "nsString.h"
 
 #include "gtest/gtest.h"
+#include "gtest/MozGTestBench.h" // For MOZ_GTEST_BENCH
 
 struct Chunk {
   Chunk(uint32_t l, const char* c)
@@ -289,3 +291,115 @@ TEST(Base64, Test)
     stream->CheckTest(string);
   } while (stream->NextTest());
 }
+
+TEST(Base64, RoundTrip)
+{
+  // Lengths around the sizes of the triplets and of the unrolled loops.
+  nsAutoCString binary;
+  for (uint32_t length = 0; length < 70; length++) {
+    binary.SetLength(length);
+    for (uint32_t i = 0; i < length; i++) {
+      binary.BeginWriting()[i] = char(i * 37 + length);
+    }
+
+    nsAutoCString base64;
+    ASSERT_TRUE(NS_SUCCEEDED(mozilla::Base64Encode(binary, base64)));
+    ASSERT_EQ(base64.Length(), (length + 2) / 3 * 4);
+
+    nsAutoCString decoded;
+    ASSERT_TRUE(NS_SUCCEEDED(mozilla::Base64Decode(base64, decoded)));
+    ASSERT_TRUE(decoded.Equals(binary));
+
+    // The UTF-16 versions encode and decode the bytes as characters.
+    NS_ConvertASCIItoUTF16 wideBinary(binary);
+    nsAutoString wideBase64;
+    ASSERT_TRUE(NS_SUCCEEDED(mozilla::Base64Encode(wideBinary, wideBase64)));
+    ASSERT_TRUE(wideBase64.EqualsASCII(base64.get()));
+
+    nsAutoString wideDecoded;
+    ASSERT_TRUE(NS_SUCCEEDED(mozilla::Base64Decode(wideBase64, wideDecoded)));
+    ASSERT_TRUE(wideDecoded.Equals(wideBinary));
+
+    // Encoding and decoding a string into itself.
+    ASSERT_TRUE(NS_SUCCEEDED(mozilla::Base64Encode(wideBinary, wideBinary)));
+    ASSERT_TRUE(wideBinary.Equals(wideBase64));
+    ASSERT_TRUE(NS_SUCCEEDED(mozilla::Base64Decode(wideBinary, wideBinary)));
+    ASSERT_TRUE(wideBinary.Equals(wideDecoded));
+  }
+}
+
+TEST(Base64, Decode)
+{
+  struct DecodeTest {
+    const char* mBase64;
+    const char* mBinary;
+  };
+  // A null mBinary means the input is invalid.
+  static const DecodeTest kDecodeTests[] = {
+    { "TWFu", "Man" },
+    { "TWE=", "Ma" },
+    { "TWE", "Ma" },
+    { "TQ==", "M" },
+    { "TQ", "M" },
+    { "TWFuTWFu", "ManMan" },
+    { "+/+/", "\xfb\xff\xbf" },
+    { "T", nullptr },
+    { "TWFuT", nullptr },
+    { "TQ=", nullptr },
+    { "T===", nullptr },
+    { "TW=u", nullptr },
+    { "TW u", nullptr },
+    { "TWF\xc3", nullptr },
+    { "-_-_", nullptr },
+  };
+
+  for (const DecodeTest& test : kDecodeTests) {
+    nsAutoCString binary;
+    nsresult rv =
+      mozilla::Base64Decode(nsDependentCString(test.mBase64), binary);
+    if (test.mBinary) {
+      EXPECT_TRUE(NS_SUCCEEDED(rv)) << test.mBase64;
+      EXPECT_TRUE(binary.Equals(test.mBinary)) << test.mBase64;
+    } else {
+      EXPECT_EQ(rv, NS_ERROR_INVALID_ARG) << test.mBase64;
+    }
+  }
+
+  // Characters that are only valid in their low byte are invalid.
+  nsAutoString wide(NS_LITERAL_STRING("TWFu"));
+  wide.BeginWriting()[1] = char16_t(0x157);
+  nsAutoString wideBinary;
+  EXPECT_EQ(mozilla::Base64Decode(wide, wideBinary), NS_ERROR_INVALID_ARG);
+  EXPECT_TRUE(wideBinary.IsEmpty());
+}
+
+static const uint32_t kBenchLength = 1024 * 1024;
+
+static void
+FillBenchBinary(nsACString& aBinary)
+{
+  aBinary.SetLength(kBenchLength);
+  for (uint32_t i = 0; i < kBenchLength; i++) {
+    aBinary.BeginWriting()[i] = char(i * 37);
+  }
+}
+
+MOZ_GTEST_BENCH(Base64, Encode1MB, [] {
+  nsAutoCString binary;
+  FillBenchBinary(binary);
+  for (int i = 0; i < 20; i++) {
+    nsAutoCString base64;
+    ASSERT_TRUE(NS_SUCCEEDED(mozilla::Base64Encode(binary, base64)));
+  }
+});
+
+MOZ_GTEST_BENCH(Base64, Decode1MB, [] {
+  nsAutoCString binary;
+  FillBenchBinary(binary);
+  nsAutoCString base64;
+  ASSERT_TRUE(NS_SUCCEEDED(mozilla::Base64Encode(binary, base64)));
+  for (int i = 0; i < 20; i++) {
+    nsAutoCString decoded;
+    ASSERT_TRUE(NS_SUCCEEDED(mozilla::Base64Decode(base64, decoded)));
+  }
+});
@@ -15,6 +15,10 @@ namespace dafsa_test_1 {
 #include "dafsa_test_1.inc" // kDafsa
 }
 
+namespace dafsa_test_1_reversed {
+#include "dafsa_test_1_reversed.inc" // kDafsa
+}
+
 TEST(Dafsa, Constructor)
 {
   Dafsa d(dafsa_test_1::kDafsa);
@@ -83,3 +87,54 @@ TEST(Dafsa, HugeString)
         ));
   EXPECT_EQ(tag, Dafsa::kKeyNotFound);
 }
+
+TEST(Dafsa, ReversedSuffixesFound)
+{
+  Dafsa d(dafsa_test_1_reversed::kDafsa);
+
+  size_t length = 0;
+  int tag = d.LookupLongestReversedSuffix(NS_LITERAL_CSTRING("foo.bar.baz"),
+                                          '.', &length);
+  EXPECT_EQ(tag, 1);
+  EXPECT_EQ(length, 11u);
+
+  tag = d.LookupLongestReversedSuffix(NS_LITERAL_CSTRING("x.y.foo.bar.baz"),
+                                      '.', &length);
+  EXPECT_EQ(tag, 1);
+  EXPECT_EQ(length, 11u);
+
+  tag = d.LookupLongestReversedSuffix(NS_LITERAL_CSTRING("b.a.test.string2"),
+                                      '.', &length);
+  EXPECT_EQ(tag, 2);
+  EXPECT_EQ(length, 14u);
+
+  tag = d.LookupLongestReversedSuffix(NS_LITERAL_CSTRING("a.aaaa"), '.',
+                                      &length);
+  EXPECT_EQ(tag, 4);
+  EXPECT_EQ(length, 4u);
+}
+
+TEST(Dafsa, ReversedSuffixesNotFound)
+{
+  Dafsa d(dafsa_test_1_reversed::kDafsa);
+
+  // Matches a suffix that doesn't start after a separator.
+  size_t length = 0;
+  int tag = d.LookupLongestReversedSuffix(NS_LITERAL_CSTRING("xfoo.bar.baz"),
+                                          '.', &length);
+  EXPECT_EQ(tag, Dafsa::kKeyNotFound);
+
+  // Matches the end of a string only.
+  tag = d.LookupLongestReversedSuffix(NS_LITERAL_CSTRING("bar.baz"), '.',
+                                      &length);
+  EXPECT_EQ(tag, Dafsa::kKeyNotFound);
+
+  // Matches repeating pattern with extra letters.
+  tag = d.LookupLongestReversedSuffix(NS_LITERAL_CSTRING("aaaaa"), '.',
+                                      &length);
+  EXPECT_EQ(tag, Dafsa::kKeyNotFound);
+
+  // Empty string.
+  tag = d.LookupLongestReversedSuffix(NS_LITERAL_CSTRING(""), '.', &length);
+  EXPECT_EQ(tag, Dafsa::kKeyNotFound);
+}
@@ -6,6 +6,7 @@
 #include "prio.h"
 #include "prsystem.h"
 
+#include "nsIDirectoryEnumerator.h"
 #include "nsIFile.h"
 #include "nsString.h"
 #include "nsDirectoryServiceDefs.h"
@@ -402,6 +403,110 @@ static bool TestNormalizeNativePath(nsIFile* aBase, nsIFile* aStart)
   return true;
 }
 
+// Test nsIFile::useStatCache, verifying that the metadata of a file only
+// changes after invalidateStatCache(), and that directory entries come with it
+static bool TestStatCache(nsIFile* aBase, const char* aName)
+{
+  nsCOMPtr<nsIFile> file = NewFile(aBase);
+  if (!file)
+    return false;
+
+  nsCString name = FixName(aName);
+  nsresult rv = file->AppendNative(name);
+  if (!VerifyResult(rv, "AppendNative"))
+    return false;
+  rv = file->Create(nsIFile::NORMAL_FILE_TYPE, 0600);
+  if (!VerifyResult(rv, "Create"))
+    return false;
+
+  rv = file->SetUseStatCache(true);
+  if (!VerifyResult(rv, "SetUseStatCache"))
+    return false;
+
+  int64_t size;
+  rv = file->GetFileSize(&size);
+  if (!VerifyResult(rv, "GetFileSize (before)"))
+    return false;
+  EXPECT_EQ(size, 0);
+
+  // Change the file behind its back.
+  nsCOMPtr<nsIFile> other = NewFile(file);
+  if (!other)
+    return false;
+  PRFileDesc* fileDesc;
+  rv = other->OpenNSPRFileDesc(PR_WRONLY, 0600, &fileDesc);
+  if (!VerifyResult(rv, "OpenNSPRFileDesc"))
+    return false;
+  EXPECT_EQ(PR_Write(fileDesc, "hello", 5), 5);
+  PR_Close(fileDesc);
+
+  rv = file->GetFileSize(&size);
+  if (!VerifyResult(rv, "GetFileSize (cached)"))
+    return false;
+  EXPECT_EQ(size, 0) << "File " << name.get() << " was stat'ed again";
+
+  rv = file->InvalidateStatCache();
+  if (!VerifyResult(rv, "InvalidateStatCache"))
+    return false;
+  rv = file->GetFileSize(&size);
+  if (!VerifyResult(rv, "GetFileSize (after)"))
+    return false;
+  EXPECT_EQ(size, 5);
+
+  // The entries of a directory using the cache use it too, and already know
+  // their size.
+  nsCOMPtr<nsIFile> dir = NewFile(aBase);
+  if (!dir)
+    return false;
+  rv = dir->SetUseStatCache(true);
+  if (!VerifyResult(rv, "SetUseStatCache (directory)"))
+    return false;
+  nsCOMPtr<nsISimpleEnumerator> entries;
+  rv = dir->GetDirectoryEntries(getter_AddRefs(entries));
+  if (!VerifyResult(rv, "GetDirectoryEntries"))
+    return false;
+  nsCOMPtr<nsIDirectoryEnumerator> dirEntries = do_QueryInterface(entries);
+  bool found = false;
+  nsCOMPtr<nsIFile> entry;
+  while (NS_SUCCEEDED(dirEntries->GetNextFile(getter_AddRefs(entry))) && entry) {
+    nsAutoCString leafName;
+    rv = entry->GetNativeLeafName(leafName);
+    if (!VerifyResult(rv, "GetNativeLeafName") || !leafName.Equals(name))
+      continue;
+    found = true;
+    bool useStatCache;
+    rv = entry->GetUseStatCache(&useStatCache);
+    if (!VerifyResult(rv, "GetUseStatCache"))
+      return false;
+    EXPECT_TRUE(useStatCache);
+    rv = entry->GetFileSize(&size);
+    if (!VerifyResult(rv, "GetFileSize (entry)"))
+      return false;
+    EXPECT_EQ(size, 5);
+  }
+  dirEntries->Close();
+  EXPECT_TRUE(found) << "File " << name.get() << " was not enumerated";
+
+  rv = other->Remove(false);
+  if (!VerifyResult(rv, "Remove"))
+    return false;
+
+  bool exists;
+  rv = file->Exists(&exists);
+  if (!VerifyResult(rv, "Exists (cached)"))
+    return false;
+  EXPECT_TRUE(exists);
+  rv = file->InvalidateStatCache();
+  if (!VerifyResult(rv, "InvalidateStatCache"))
+    return false;
+  rv = file->Exists(&exists);
+  if (!VerifyResult(rv, "Exists (after)"))
+    return false;
+  EXPECT_FALSE(exists) << "File " << name.get() << " was not removed";
+
+  return found && !exists;
+}
+
 TEST(TestFile, Tests)
 {
   nsCOMPtr<nsIFile> base;
@@ -472,6 +577,8 @@ TEST(TestFile, Tests)
 
   ASSERT_TRUE(TestDeleteOnClose(base, "file7.txt", PR_RDWR | PR_CREATE_FILE, 0600));
 
+  ASSERT_TRUE(TestStatCache(base, "file8.txt"));
+
   // Clean up temporary stuff
   rv = base->Remove(true);
   VerifyResult(rv, "Cleaning up temp directory");
@@ -410,6 +410,31 @@ TEST(MozPromise, HeterogeneousChaining)
     });
 }
 
+TEST(MozPromise, DirectTaskDispatch)
+{
+  RefPtr<TaskQueue> queue =
+    new TaskQueue(GetMediaThreadPool(MediaThreadType::PLAYBACK),
+                  /* aSupportsTailDispatch = */ true);
+  static bool sResolved;
+  sResolved = false;
+  RunOnTaskQueue(queue, [queue] () -> void {
+    // Dispatched before the promise is resolved, but runs after the callback,
+    // which runs at the end of this task without going through the queue.
+    RunOnTaskQueue(queue, [queue] () -> void {
+      EXPECT_TRUE(sResolved);
+      queue->BeginShutdown();
+    });
+
+    RefPtr<TestPromise::Private> p = new TestPromise::Private(__func__);
+    p->UseDirectTaskDispatch(__func__);
+    p->Then(queue, __func__,
+      [] (int aResolveValue) -> void { EXPECT_EQ(aResolveValue, 42); sResolved = true; },
+      DO_FAIL);
+    p->Resolve(42, __func__);
+  });
+  queue->AwaitShutdownAndIdle();
+}
+
 TEST(MozPromise, XPCOMEventTarget)
 {
   TestPromise::CreateAndResolve(42, __func__)->Then(GetCurrentThreadSerialEventTarget(), __func__,
@@ -8,6 +8,7 @@
 #include "nsCOMPtr.h"
 #include "nsServiceManagerUtils.h"
 #include "gtest/gtest.h"
+#include "gtest/MozGTestBench.h" // For MOZ_GTEST_BENCH
 
 // This test mostly focuses on edge cases. But more coverage of normal
 // operations wouldn't be a bad thing.
@@ -332,6 +333,223 @@ TEST(PLDHashTableTest, Iterator)
   ASSERT_EQ(t.Capacity(), unsigned(PLDHashTable::kMinCapacity));
 }
 
+// Unlike trivialOps, this scrambles the keys, as most real hash functions do.
+static const PLDHashTableOps ptrOps = {
+  PLDHashTable::HashVoidPtrKeyStub,
+  PLDHashTable::MatchEntryStub,
+  PLDHashTable::MoveEntryStub,
+  PLDHashTable::ClearEntryStub,
+  TrivialInitEntry
+};
+
+static const PLDHashTable::Probing Groups = PLDHashTable::Probing::Groups;
+static const PLDHashTable::Probing DoubleHashing =
+  PLDHashTable::Probing::DoubleHashing;
+
+static const void*
+Key(uintptr_t aIndex)
+{
+  return (const void*)((aIndex + 1) * sizeof(void*));
+}
+
+TEST(PLDHashTableTest, GroupProbing)
+{
+  PLDHashTable t(&ptrOps, sizeof(PLDHashEntryStub), 4, Groups);
+  ASSERT_EQ(t.GetProbing(), Groups);
+
+  // Add, look up and remove enough entries to need many groups.
+  for (uintptr_t i = 0; i < 2000; i++) {
+    ASSERT_TRUE(t.Add(Key(i), mozilla::fallible));
+  }
+  ASSERT_EQ(t.EntryCount(), 2000u);
+  for (uintptr_t i = 0; i < 4000; i++) {
+    PLDHashEntryHdr* entry = t.Search(Key(i));
+    ASSERT_EQ(entry != nullptr, i < 2000);
+    if (entry) {
+      ASSERT_EQ(static_cast<PLDHashEntryStub*>(entry)->key, Key(i));
+    }
+  }
+  for (uintptr_t i = 0; i < 2000; i += 2) {
+    t.Remove(Key(i));
+  }
+  ASSERT_EQ(t.EntryCount(), 1000u);
+  for (uintptr_t i = 0; i < 2000; i++) {
+    ASSERT_EQ(t.Search(Key(i)) != nullptr, i % 2 == 1);
+  }
+
+  // Re-adding an entry finds the existing one.
+  PLDHashEntryHdr* entry = t.Add(Key(1));
+  ASSERT_EQ(t.Add(Key(1)), entry);
+  ASSERT_EQ(t.EntryCount(), 1000u);
+
+  // Check the iterator goes through each entry once.
+  uint32_t n = 0;
+  for (auto iter = t.Iter(); !iter.Done(); iter.Next()) {
+    auto stub = static_cast<PLDHashEntryStub*>(iter.Get());
+    ASSERT_EQ((uintptr_t)stub->key / sizeof(void*) % 2, 0u);
+    n++;
+  }
+  ASSERT_EQ(n, 1000u);
+
+  // Churn the table, so that it goes through removed entries and rehashing.
+  for (uintptr_t round = 0; round < 20; round++) {
+    for (uintptr_t i = 0; i < 1000; i++) {
+      t.Remove(Key(round * 1000 + i));
+      t.Add(Key((round + 2) * 1000 + i));
+    }
+    ASSERT_EQ(t.EntryCount(), 1500u);
+    for (uintptr_t i = 0; i < 1000; i++) {
+      ASSERT_FALSE(t.Search(Key(round * 1000 + i)));
+      ASSERT_TRUE(t.Search(Key((round + 2) * 1000 + i)));
+    }
+  }
+
+  // Removing everything shrinks the table to its minimum capacity.
+  for (auto iter = t.Iter(); !iter.Done(); iter.Next()) {
+    iter.Remove();
+  }
+  ASSERT_EQ(t.EntryCount(), 0u);
+  ASSERT_EQ(t.Capacity(), PLDHashTable::kGroupWidth);
+
+  // Clear() keeps the probing mode.
+  t.Clear();
+  ASSERT_EQ(t.GetProbing(), Groups);
+  t.Add(Key(0));
+  ASSERT_TRUE(t.Search(Key(0)));
+}
+
+TEST(PLDHashTableTest, GroupProbingLoad)
+{
+  // Group probing fills tables up to 87.5% before growing them, where double
+  // hashing stops at 75%.
+  PLDHashTable t1(&ptrOps, sizeof(PLDHashEntryStub), 4, Groups);
+  PLDHashTable t2(&ptrOps, sizeof(PLDHashEntryStub), 4, DoubleHashing);
+  for (uintptr_t i = 0; i < 112; i++) {
+    t1.Add(Key(i));
+    t2.Add(Key(i));
+  }
+  ASSERT_EQ(t1.Capacity(), 128u);
+  ASSERT_EQ(t2.Capacity(), 256u);
+
+  t1.Add(Key(112));
+  ASSERT_EQ(t1.Capacity(), 256u);
+
+  // The initial length is honored the same way.
+  PLDHashTable t3(&ptrOps, sizeof(PLDHashEntryStub), 112, Groups);
+  t3.Add(Key(0));
+  ASSERT_EQ(t3.Capacity(), 128u);
+
+  // Each entry costs one more byte, for its control byte.
+  ASSERT_GE(t1.ShallowSizeOfExcludingThis(moz_malloc_size_of),
+            t1.Capacity() * (sizeof(PLDHashEntryStub) + 1));
+}
+
+// Benchmarks of both probing modes, at various load factors of a table with
+// a capacity of 65536.
+static const uint32_t kBenchCapacity = 65536;
+
+static void
+BenchFill(PLDHashTable& aTable, uint32_t aLength)
+{
+  for (uintptr_t i = 0; i < aLength; i++) {
+    aTable.Add(Key(i));
+  }
+  ASSERT_EQ(aTable.Capacity(), kBenchCapacity);
+}
+
+// Look up every entry of the table, and as many missing keys.
+static void
+BenchLookups(PLDHashTable::Probing aProbing, uint32_t aLength)
+{
+  PLDHashTable t(&ptrOps, sizeof(PLDHashEntryStub), aLength, aProbing);
+  BenchFill(t, aLength);
+
+  uint32_t hits = 0;
+  for (int round = 0; round < 10; round++) {
+    for (uintptr_t i = 0; i < 2 * aLength; i++) {
+      if (t.Search(Key(i))) {
+        hits++;
+      }
+    }
+  }
+  ASSERT_EQ(hits, 10 * aLength);
+}
+
+static void
+BenchInserts(PLDHashTable::Probing aProbing, uint32_t aLength)
+{
+  for (int round = 0; round < 10; round++) {
+    PLDHashTable t(&ptrOps, sizeof(PLDHashEntryStub), aLength, aProbing);
+    BenchFill(t, aLength);
+  }
+}
+
+// Replace every entry of the table, one at a time.
+static void
+BenchRemoves(PLDHashTable::Probing aProbing, uint32_t aLength)
+{
+  PLDHashTable t(&ptrOps, sizeof(PLDHashEntryStub), aLength, aProbing);
+  BenchFill(t, aLength);
+
+  for (uintptr_t round = 0; round < 10; round++) {
+    for (uintptr_t i = 0; i < aLength; i++) {
+      t.Remove(Key(round * aLength + i));
+      t.Add(Key((round + 1) * aLength + i));
+    }
+  }
+  ASSERT_EQ(t.EntryCount(), aLength);
+}
+
+// 50%, 75% and 87.5% of kBenchCapacity. Double hashing tables grow before
+// reaching the latter.
+static const uint32_t kBenchLength50 = kBenchCapacity / 2;
+static const uint32_t kBenchLength75 = kBenchCapacity / 4 * 3;
+static const uint32_t kBenchLength87 = kBenchCapacity / 8 * 7;
+
+MOZ_GTEST_BENCH(PLDHashTableTest, PerfLookupDoubleHashing50, [] {
+  BenchLookups(DoubleHashing, kBenchLength50);
+});
+
+MOZ_GTEST_BENCH(PLDHashTableTest, PerfLookupDoubleHashing75, [] {
+  BenchLookups(DoubleHashing, kBenchLength75);
+});
+
+MOZ_GTEST_BENCH(PLDHashTableTest, PerfLookupGroups50, [] {
+  BenchLookups(Groups, kBenchLength50);
+});
+
+MOZ_GTEST_BENCH(PLDHashTableTest, PerfLookupGroups75, [] {
+  BenchLookups(Groups, kBenchLength75);
+});
+
+MOZ_GTEST_BENCH(PLDHashTableTest, PerfLookupGroups87, [] {
+  BenchLookups(Groups, kBenchLength87);
+});
+
+MOZ_GTEST_BENCH(PLDHashTableTest, PerfInsertDoubleHashing75, [] {
+  BenchInserts(DoubleHashing, kBenchLength75);
+});
+
+MOZ_GTEST_BENCH(PLDHashTableTest, PerfInsertGroups75, [] {
+  BenchInserts(Groups, kBenchLength75);
+});
+
+MOZ_GTEST_BENCH(PLDHashTableTest, PerfInsertGroups87, [] {
+  BenchInserts(Groups, kBenchLength87);
+});
+
+MOZ_GTEST_BENCH(PLDHashTableTest, PerfRemoveDoubleHashing75, [] {
+  BenchRemoves(DoubleHashing, kBenchLength75);
+});
+
+MOZ_GTEST_BENCH(PLDHashTableTest, PerfRemoveGroups75, [] {
+  BenchRemoves(Groups, kBenchLength75);
+});
+
+MOZ_GTEST_BENCH(PLDHashTableTest, PerfRemoveGroups87, [] {
+  BenchRemoves(Groups, kBenchLength87);
+});
+
 // This test involves resizing a table repeatedly up to 512 MiB in size. On
 // 32-bit platforms (Win32, Android) it sometimes OOMs, causing the test to
 // fail. (See bug 931062 and bug 1267227.) Therefore, we only run it on 64-bit
@@ -1375,4 +1375,85 @@ MOZ_GTEST_BENCH(Strings, PerfStripCharsCRLF, [] {
     }
 });
 
+// Samples of the input classes of the UTF-8/UTF-16 benchmarks below.  The
+// benchmarks repeat them to 64KB.
+static const char kSampleASCII[] =
+  "The quick brown fox jumps over the lazy dog. ";
+static const char kSampleLatin[] =
+  "Fran\xc3\xa7" "ais caf\xc3\xa9 na\xc3\xafve \xc3\xa0 la cr\xc3\xa8me. ";
+static const char kSampleCJK[] =
+  "\xe6\x96\x87\xe5\xad\x97\xe5\x8c\x96\xe3\x81\x91\xe3\x81\xae"
+  "\xe3\x83\x86\xe3\x82\xb9\xe3\x83\x88\xe3\x80\x82";
+static const char kSampleEmoji[] =
+  "\xf0\x9f\x98\x80\xf0\x9f\x8e\x89 ok \xf0\x9f\x91\x8d ";
+
+static void
+RepeatSample(const char* aSample, nsCString& aResult)
+{
+  aResult.Truncate();
+  while (aResult.Length() < 64 * 1024) {
+    aResult.Append(aSample);
+  }
+}
+
+static void
+PerfConvertUTF(const char* aSample)
+{
+  nsCString utf8;
+  RepeatSample(aSample, utf8);
+  nsString utf16;
+  nsCString roundTrip;
+  for (int i = 0; i < 200; i++) {
+    CopyUTF8toUTF16(utf8, utf16);
+    CopyUTF16toUTF8(utf16, roundTrip);
+  }
+  EXPECT_TRUE(roundTrip.Equals(utf8));
+}
+
+static void
+PerfValidateUTF(const char* aSample)
+{
+  nsCString utf8;
+  RepeatSample(aSample, utf8);
+  NS_ConvertUTF8toUTF16 utf16(utf8);
+  bool isASCII = aSample == kSampleASCII;
+  for (int i = 0; i < 200; i++) {
+    EXPECT_TRUE(IsUTF8(utf8));
+    EXPECT_EQ(IsASCII(utf8), isASCII);
+    EXPECT_EQ(IsASCII(utf16), isASCII);
+  }
+}
+
+MOZ_GTEST_BENCH(Strings, PerfConvertUTFASCII, [] {
+    PerfConvertUTF(kSampleASCII);
+});
+
+MOZ_GTEST_BENCH(Strings, PerfConvertUTFLatin, [] {
+    PerfConvertUTF(kSampleLatin);
+});
+
+MOZ_GTEST_BENCH(Strings, PerfConvertUTFCJK, [] {
+    PerfConvertUTF(kSampleCJK);
+});
+
+MOZ_GTEST_BENCH(Strings, PerfConvertUTFEmoji, [] {
+    PerfConvertUTF(kSampleEmoji);
+});
+
+MOZ_GTEST_BENCH(Strings, PerfValidateUTFASCII, [] {
+    PerfValidateUTF(kSampleASCII);
+});
+
+MOZ_GTEST_BENCH(Strings, PerfValidateUTFLatin, [] {
+    PerfValidateUTF(kSampleLatin);
+});
+
+MOZ_GTEST_BENCH(Strings, PerfValidateUTFCJK, [] {
+    PerfValidateUTF(kSampleCJK);
+});
+
+MOZ_GTEST_BENCH(Strings, PerfValidateUTFEmoji, [] {
+    PerfValidateUTF(kSampleEmoji);
+});
+
 } // namespace TestStrings
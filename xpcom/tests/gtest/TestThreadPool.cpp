@@ -130,3 +130,31 @@ TEST(ThreadPool, Parallelism)
 
   pool->Shutdown();
 }
+
+TEST(ThreadPool, WorkStealing)
+{
+  nsCOMPtr<nsIThreadPool> pool = do_CreateInstance(NS_THREADPOOL_CONTRACTID);
+  EXPECT_TRUE(pool);
+
+  EXPECT_TRUE(NS_SUCCEEDED(pool->SetWorkStealing(true)));
+  bool workStealing = false;
+  pool->GetWorkStealing(&workStealing);
+  EXPECT_TRUE(workStealing);
+
+  Atomic<int> count(0);
+  for (int i = 0; i < 10000; ++i) {
+    pool->Dispatch(NS_NewRunnableFunction("TestRunnable", [&count]() {
+      ++count;
+    }), NS_DISPATCH_NORMAL);
+  }
+
+  // The mode can't change once events were dispatched.
+  EXPECT_TRUE(NS_FAILED(pool->SetWorkStealing(false)));
+
+  pool->Shutdown();
+  EXPECT_EQ(count, 10000);
+
+  // Events dispatched after shutdown are rejected.
+  nsCOMPtr<nsIRunnable> late = new Runnable("TestRunnable");
+  EXPECT_TRUE(NS_FAILED(pool->Dispatch(late, NS_DISPATCH_NORMAL)));
+}
@@ -684,6 +684,7 @@ TEST(ThreadUtils, IdleTaskRunner)
   int cnt1 = 0;
   RefPtr<IdleTaskRunner> runner1 =
     IdleTaskRunner::Create([&cnt1](TimeStamp) { cnt1++; return true; },
+                           "TestIdleTaskRunner1",
                            10,
                            3,
                            true,
@@ -693,6 +694,7 @@ TEST(ThreadUtils, IdleTaskRunner)
   int cnt2 = 0;
   RefPtr<IdleTaskRunner> runner2 =
     IdleTaskRunner::Create([&cnt2](TimeStamp) { cnt2++; return false; },
+                           "TestIdleTaskRunner2",
                            10,
                            3,
                            false,
@@ -704,6 +706,7 @@ TEST(ThreadUtils, IdleTaskRunner)
   int cnt3 = 0;
   RefPtr<IdleTaskRunner> runner3 =
     IdleTaskRunner::Create([&cnt3](TimeStamp) { cnt3++; return true; },
+                           "TestIdleTaskRunner3",
                            10,
                            3,
                            true,
@@ -714,6 +717,7 @@ TEST(ThreadUtils, IdleTaskRunner)
   int cnt4 = 0;
   RefPtr<IdleTaskRunner> runner4 =
     IdleTaskRunner::Create([&cnt4](TimeStamp) { cnt4++; return true; },
+                           "TestIdleTaskRunner4",
                            10,
                            3,
                            false,
@@ -11,6 +11,7 @@
 #include "nsCOMPtr.h"
 #include "nsIServiceManager.h"
 #include "nsXPCOM.h"
+#include "mozilla/Atomics.h"
 #include "mozilla/Monitor.h"
 #include "gtest/gtest.h"
 
@@ -276,3 +277,36 @@ TEST(Threads, StressNSPR)
         delete [] array;
     }
 }
+
+TEST(Threads, ManyProducers)
+{
+    const uint32_t producers = 4;
+    const uint32_t events = 10000;
+
+    // The consumer keeps running out of events and waiting for more, while
+    // the producers add them and cross the pages of its queue.
+    nsCOMPtr<nsIThread> consumer;
+    nsresult rv = NS_NewNamedThread("TestConsumer", getter_AddRefs(consumer));
+    EXPECT_TRUE(NS_SUCCEEDED(rv));
+
+    mozilla::Atomic<uint32_t> count(0);
+    nsCOMPtr<nsIThread> threads[producers];
+    for (auto& thread : threads) {
+        nsCOMPtr<nsIRunnable> producer =
+            NS_NewRunnableFunction("TestProducer", [&]() {
+                for (uint32_t i = 0; i < events; i++) {
+                    consumer->Dispatch(NS_NewRunnableFunction("TestRunnable", [&]() {
+                        ++count;
+                    }), NS_DISPATCH_NORMAL);
+                }
+            });
+        rv = NS_NewNamedThread("TestProducer", getter_AddRefs(thread), producer);
+        EXPECT_TRUE(NS_SUCCEEDED(rv));
+    }
+
+    for (auto& thread : threads) {
+        thread->Shutdown();
+    }
+    consumer->Shutdown();
+    EXPECT_EQ(count, producers * events);
+}
@@ -13,6 +13,7 @@
 #include "prinrval.h"
 #include "prmon.h"
 #include "prthread.h"
+#include "mozilla/Atomics.h"
 #include "mozilla/Attributes.h"
 
 #include "mozilla/ReentrantMonitor.h"
@@ -164,6 +165,60 @@ TEST(Timers, TimerWithStoppedTarget)
   PR_Sleep(400);
 }
 
+class CountingTimerCallback final : public nsITimerCallback
+{
+public:
+  NS_DECL_THREADSAFE_ISUPPORTS
+
+  NS_IMETHOD Notify(nsITimer* aTimer) override {
+    ++mCount;
+    return NS_OK;
+  }
+
+  Atomic<uint32_t> mCount;
+
+private:
+  ~CountingTimerCallback() {}
+};
+
+NS_IMPL_ISUPPORTS(CountingTimerCallback, nsITimerCallback)
+
+TEST(Timers, ClusteredTimers)
+{
+  AutoTestThread testThread;
+  ASSERT_TRUE(testThread);
+
+  RefPtr<CountingTimerCallback> callback = new CountingTimerCallback();
+
+  // Timers due at the same time are fired as one batch.
+  static const uint32_t kNumTimers = 200;
+  nsCOMPtr<nsITimer> timers[kNumTimers];
+  for (auto& timer : timers) {
+    nsresult rv;
+    timer = do_CreateInstance(NS_TIMER_CONTRACTID, &rv);
+    ASSERT_TRUE(NS_SUCCEEDED(rv));
+    rv = timer->SetTarget(static_cast<nsIEventTarget*>(testThread));
+    ASSERT_TRUE(NS_SUCCEEDED(rv));
+    rv = timer->InitWithCallback(callback, 100, nsITimer::TYPE_ONE_SHOT);
+    ASSERT_TRUE(NS_SUCCEEDED(rv));
+  }
+
+  // Pushing a timer out again and again leaves canceled entries behind in
+  // the timer thread, which are compacted away.
+  for (uint32_t i = 0; i < 1000; ++i) {
+    nsresult rv =
+      timers[0]->InitWithCallback(callback, 100 + i, nsITimer::TYPE_ONE_SHOT);
+    ASSERT_TRUE(NS_SUCCEEDED(rv));
+  }
+
+  PRIntervalTime start = PR_IntervalNow();
+  while (callback->mCount != kNumTimers) {
+    uint32_t elapsedMs = PR_IntervalToMilliseconds(PR_IntervalNow() - start);
+    ASSERT_LE(elapsedMs, uint32_t(10000)) << "Timed out waiting for all timers to pop";
+    PR_Sleep(PR_MillisecondsToInterval(10));
+  }
+}
+
 // gtest on 32bit Win7 debug build is unstable and somehow this test
 // makes it even worse.
 #if !defined(XP_WIN) || !defined(DEBUG) || defined(HAVE_64BIT_BUILD)
@@ -188,4 +188,83 @@ TEST(UTF, NonASCII16)
   NonASCII16_helper(512);
 }
 
+/**
+ * This tests the handling of a non-ascii character at various locations in a
+ * UTF-8 string, at various alignments, by the ASCII checks, the UTF-8
+ * validation and the conversion to UTF-16.
+ */
+void NonASCII8_helper(const size_t aStrSize, const size_t aOffset)
+{
+  const size_t kTestSize = aStrSize;
+  const size_t kMaxASCII = 0x80;
+  const char16_t kUTF16Char = 0xC9;
+  const char kUTF8Surrogates[] = { char(0xC3), char(0x89) };
+
+  // Generate a string containing only ASCII characters, preceded by aOffset
+  // characters that are cut off again to shift its alignment.
+  nsCString asciiBuffer;
+  asciiBuffer.SetLength(aOffset + kTestSize);
+  nsString asciiString;
+  asciiString.SetLength(kTestSize);
+
+  auto cstr_buff = asciiBuffer.BeginWriting();
+  auto str_buff = asciiString.BeginWriting();
+  for (size_t i = 0; i < aOffset + kTestSize; i++) {
+    cstr_buff[i] = i % kMaxASCII;
+  }
+  for (size_t i = 0; i < kTestSize; i++) {
+    str_buff[i] = (aOffset + i) % kMaxASCII;
+  }
+
+  const nsDependentCSubstring asciiCString(asciiBuffer, aOffset);
+  EXPECT_TRUE(IsASCII(asciiCString));
+  EXPECT_TRUE(IsUTF8(asciiCString));
+
+  nsString dest;
+  AppendUTF8toUTF16(asciiCString, dest);
+  EXPECT_TRUE(dest.Equals(asciiString));
+
+  // Now go through and test when exactly one character is a multibyte
+  // sequence.
+  for (size_t i = 0; i < kTestSize; i++) {
+    // Setup the UTF-8 string.
+    nsCString utf8Buffer(asciiBuffer);
+    utf8Buffer.Replace(aOffset + i, 1, kUTF8Surrogates,
+                       ArrayLength(kUTF8Surrogates));
+    const nsDependentCSubstring utf8String(utf8Buffer, aOffset);
+    EXPECT_FALSE(IsASCII(utf8String));
+    EXPECT_TRUE(IsUTF8(utf8String));
+
+    // Do the conversion, make sure the length decreased by 1.
+    nsString converted;
+    AppendUTF8toUTF16(utf8String, converted);
+    EXPECT_EQ(converted.Length(), utf8String.Length() - 1);
+
+    nsString expected(asciiString);
+    expected.BeginWriting()[i] = kUTF16Char;
+    EXPECT_TRUE(converted.Equals(expected));
+
+    nsString unicodeString(asciiString);
+    unicodeString.BeginWriting()[i] = kUTF16Char;
+    EXPECT_FALSE(IsASCII(unicodeString));
+
+    // An overlong sequence is invalid wherever it is.
+    nsCString invalidBuffer(asciiBuffer);
+    invalidBuffer.Replace(aOffset + i, 1, "\xC0\x80", 2);
+    EXPECT_FALSE(IsUTF8(nsDependentCSubstring(invalidBuffer, aOffset)));
+  }
+}
+
+TEST(UTF, NonASCII8)
+{
+  // Test with various string sizes and alignments to catch any special
+  // casing.
+  const size_t kSizes[] = { 1, 8, 15, 16, 17, 32, 63, 64, 65, 130, 512 };
+  for (size_t size : kSizes) {
+    for (size_t offset = 0; offset < 4; offset++) {
+      NonASCII8_helper(size, offset);
+    }
+  }
+}
+
 } // namespace TestUTF
@@ -5,6 +5,7 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
 
 #include "mozilla/ArrayUtils.h"
+#include "mozilla/Atomics.h"
 #include "mozilla/BackgroundHangMonitor.h"
 #include "mozilla/LinkedList.h"
 #include "mozilla/Monitor.h"
@@ -16,6 +17,7 @@
 #include "mozilla/ThreadLocal.h"
 #include "mozilla/SystemGroup.h"
 
+#include "prenv.h"
 #include "prinrval.h"
 #include "prthread.h"
 #include "ThreadStackHelper.h"
@@ -30,6 +32,15 @@
 
 #include <algorithm>
 
+#ifdef XP_WIN
+#include <process.h>
+#ifndef getpid
+#define getpid _getpid
+#endif
+#else
+#include <unistd.h>
+#endif
+
 // Activate BHR only for one every BHR_BETA_MOD users.
 // This is now 100% of Beta population for the Beta 45/46 e10s A/B trials
 // It can be scaled back again in the future
@@ -39,6 +50,13 @@
 // the 99.9th percentile of the thread hangs stack depths reported by Telemetry.
 static const size_t kMaxThreadHangStackDepth = 30;
 
+// When MOZ_PROFILER_HANG_DIR is set and the profiler is running, the profile of
+// each hang, and of the kHangProfileLeadMs before it, is saved to that
+// directory as hang-<pid>-<n>.json. At most kMaxHangProfiles are saved per
+// process.
+static const uint32_t kHangProfileLeadMs = 5000;
+static const uint32_t kMaxHangProfiles = 32;
+
 // An utility comparator function used by std::unique to collapse "(* script)" entries in
 // a vector representing a call stack.
 bool StackScriptEntriesCollapser(const char* aStackEntry, const char *aAnotherStackEntry)
@@ -87,16 +105,28 @@ public:
   static StaticRefPtr<BackgroundHangManager> sInstance;
   static bool sDisabled;
 
-  // Lock for access to members of this class
+  // Lock for access to members of this class, except for the atomic ones
   Monitor mLock;
-  // Current time as seen by hang monitors
-  PRIntervalTime mIntervalNow;
+  // Current time as seen by hang monitors; written by the monitor thread with
+  // mLock held, read by monitored threads without it
+  Atomic<PRIntervalTime> mIntervalNow;
+  // Upper bound on how long until the monitor thread next checks the threads
+  // for hangs, PR_INTERVAL_NO_TIMEOUT if it waits until woken up, or 0 while
+  // it's checking them; see BackgroundHangThread::Update
+  Atomic<PRIntervalTime> mRecheckTimeout;
   // List of BackgroundHangThread instances associated with each thread
   LinkedList<BackgroundHangThread> mHangThreads;
   // A reference to the StreamTransportService. This is gotten on the main
   // thread, and carried around, as nsStreamTransportService::Init is
   // non-threadsafe.
   nsCOMPtr<nsIEventTarget> mSTS;
+  // Where to save hang profiles, or null
+  const char* mHangProfileDir;
+  // Number of hang profiles saved so far
+  uint32_t mHangProfileCount;
+  // Is a hang profile being saved; set on the monitor thread and cleared on
+  // the StreamTransportService thread that saves it
+  Atomic<bool> mSavingHangProfile;
 
   void Shutdown()
   {
@@ -112,6 +142,14 @@ public:
     mLock.NotifyAll();
   }
 
+  // Wake up the hang monitor thread from a monitored thread, which doesn't
+  // hold mLock.
+  void WakeupFromThread()
+  {
+    MonitorAutoLock autoLock(mLock);
+    Wakeup();
+  }
+
   BackgroundHangManager();
 private:
   virtual ~BackgroundHangManager();
@@ -175,14 +213,16 @@ public:
   const PRIntervalTime mTimeout;
   // PermaHang timeout in ticks
   const PRIntervalTime mMaxTimeout;
-  // Time at last activity
-  PRIntervalTime mInterval;
+  // Time at last activity; written by the thread without holding
+  // mManager->mLock
+  Atomic<PRIntervalTime> mInterval;
   // Time when a hang started
   PRIntervalTime mHangStart;
   // Is the thread in a hang
   bool mHanging;
-  // Is the thread in a waiting state
-  bool mWaiting;
+  // Is the thread in a waiting state; written by the thread without holding
+  // mManager->mLock
+  Atomic<bool> mWaiting;
   // Is the thread dedicated to a single BackgroundHangMonitor
   BackgroundHangMonitor::ThreadType mThreadType;
   // Platform-specific helper to get hang stacks
@@ -213,17 +253,16 @@ public:
   void ReportHang(PRIntervalTime aHangTime);
   // Report a permanent hang; aManager->mLock IS locked
   void ReportPermaHang();
+  // Save the profile around a hang if requested; aManager->mLock IS locked
+  void SaveHangProfile(PRIntervalTime aHangTime);
   // Called by BackgroundHangMonitor::NotifyActivity
   void NotifyActivity()
   {
-    MonitorAutoLock autoLock(mManager->mLock);
     Update();
   }
   // Called by BackgroundHangMonitor::NotifyWait
   void NotifyWait()
   {
-    MonitorAutoLock autoLock(mManager->mLock);
-
     if (mWaiting) {
       return;
     }
@@ -271,8 +310,16 @@ BackgroundHangManager::BackgroundHangManager()
   : mShutdown(false)
   , mLock("BackgroundHangManager")
   , mIntervalNow(0)
+  , mRecheckTimeout(0)
   , mSTS(do_GetService(NS_STREAMTRANSPORTSERVICE_CONTRACTID))
+  , mHangProfileDir(PR_GetEnv("MOZ_PROFILER_HANG_DIR"))
+  , mHangProfileCount(0)
+  , mSavingHangProfile(false)
 {
+  if (mHangProfileDir && !*mHangProfileDir) {
+    mHangProfileDir = nullptr;
+  }
+
   // Lock so we don't race against the new monitor thread
   MonitorAutoLock autoLock(mLock);
 
@@ -346,6 +393,7 @@ BackgroundHangManager::RunMonitorThread()
        monitors and update waitTime and recheckTimeout. */
     waitTime = PR_INTERVAL_NO_TIMEOUT;
     recheckTimeout = PR_INTERVAL_NO_TIMEOUT;
+    mRecheckTimeout = 0;
 
     // Locally hold mIntervalNow
     PRIntervalTime intervalNow = mIntervalNow;
@@ -419,6 +467,25 @@ BackgroundHangManager::RunMonitorThread()
         waitTime = std::min(waitTime, currentThread->mTimeout / 4);
       }
     }
+
+    /* A thread that stops waiting has to wake us up if we wouldn't otherwise
+       check it again before its timeout, e.g. because all threads were waiting
+       and so we wait indefinitely. Threads don't take mLock to find out, so
+       publish mRecheckTimeout before looking for threads that stopped waiting
+       during the loop above: either such a thread sees it, or we see the
+       thread. */
+    mRecheckTimeout = recheckTimeout;
+    for (BackgroundHangThread* currentThread = mHangThreads.getFirst();
+         currentThread; currentThread = currentThread->getNext()) {
+      if (!currentThread->mWaiting && !currentThread->mHanging &&
+          currentThread->mTimeout < recheckTimeout) {
+        // Go through the hang monitors again right away.
+        mRecheckTimeout = 0;
+        waitTime = PR_INTERVAL_NO_WAIT;
+        recheckTimeout = PR_INTERVAL_NO_WAIT;
+        break;
+      }
+    }
   }
 
   /* We are shutting down now.
@@ -578,6 +645,8 @@ BackgroundHangThread::ReportHang(PRIntervalTime aHangTime)
   // Recovered from a hang; called on the monitor thread
   // mManager->mLock IS locked
 
+  SaveHangProfile(aHangTime);
+
   // Remove unwanted "js::RunScript" frame from the stack
   for (size_t i = 0; i < mHangStack.length(); ) {
     const char** f = mHangStack.begin() + i;
@@ -659,6 +728,36 @@ BackgroundHangThread::ReportHang(PRIntervalTime aHangTime)
   }
 }
 
+void
+BackgroundHangThread::SaveHangProfile(PRIntervalTime aHangTime)
+{
+  // Only one profile is saved at a time, and not here, since writing it takes
+  // long enough that holding mManager->mLock would stall every monitored
+  // thread.
+  if (!mManager->mHangProfileDir || !profiler_is_active() ||
+      mManager->mHangProfileCount >= kMaxHangProfiles ||
+      mManager->mSavingHangProfile.exchange(true)) {
+    return;
+  }
+
+  double sinceTime = profiler_time() -
+                     PR_IntervalToMilliseconds(aHangTime) - kHangProfileLeadMs;
+  nsCString filename;
+  filename.AppendPrintf("%s/hang-%d-%u.json", mManager->mHangProfileDir,
+                        int(getpid()),
+                        mManager->mHangProfileCount++);
+
+  RefPtr<BackgroundHangManager> manager = mManager;
+  nsCOMPtr<nsIRunnable> runnable =
+    NS_NewRunnableFunction("SaveHangProfile", [manager, filename, sinceTime] {
+      profiler_save_recent_profile_to_file(filename.get(), sinceTime);
+      manager->mSavingHangProfile = false;
+    });
+  if (!mManager->mSTS || NS_FAILED(mManager->mSTS->Dispatch(runnable.forget()))) {
+    mManager->mSavingHangProfile = false;
+  }
+}
+
 void
 BackgroundHangThread::ReportPermaHang()
 {
@@ -677,21 +776,28 @@ BackgroundHangThread::ReportPermaHang()
 MOZ_ALWAYS_INLINE void
 BackgroundHangThread::Update()
 {
+  // This is called for every event on the monitored threads, so it doesn't
+  // take mManager->mLock unless the monitor thread needs waking up.
   PRIntervalTime intervalNow = mManager->mIntervalNow;
   if (mWaiting) {
     mInterval = intervalNow;
     mWaiting = false;
-    /* We have to wake up the manager thread because when all threads
-       are waiting, the manager thread waits indefinitely as well. */
-    mManager->Wakeup();
+    /* We have to wake up the manager thread if it won't check us again
+       before our timeout, e.g. when all threads were waiting, because the
+       manager thread then waits indefinitely as well. */
+    if (mManager->mRecheckTimeout > mTimeout) {
+      mManager->WakeupFromThread();
+    }
   } else {
     PRIntervalTime duration = intervalNow - mInterval;
+    // ThreadHangStatsIterator reads this with mManager->mLock held, and may
+    // see slightly stale counts; tolerate that race.
     mStats.mActivity.Add(duration);
+    mInterval = intervalNow;
     if (MOZ_UNLIKELY(duration >= mTimeout)) {
       /* Wake up the manager thread to tell it that a hang ended */
-      mManager->Wakeup();
+      mManager->WakeupFromThread();
     }
-    mInterval = intervalNow;
   }
 }
 
@@ -6,13 +6,194 @@
 
 #include "IdleTaskRunner.h"
 #include "nsRefreshDriver.h"
+#include "mozilla/ClearOnShutdown.h"
+#include "mozilla/StaticPtr.h"
 #include "mozilla/SystemGroup.h"
+#include "mozilla/Telemetry.h"
 #include "nsComponentManagerUtils.h"
 
 namespace mozilla {
 
+// The queue of the IdleTaskRunners waiting for idle time. It is dispatched
+// to the idle queue as a single idle runnable, and runs the runners that fit
+// into the idle period it is given, earliest hard deadline first.
+class IdleTaskRunnerScheduler final : public IdleRunnable
+{
+public:
+  IdleTaskRunnerScheduler()
+    : IdleRunnable("IdleTaskRunnerScheduler")
+    , mDispatched(false)
+  {
+  }
+
+  static IdleTaskRunnerScheduler* Get();
+
+  void Enqueue(IdleTaskRunner* aRunner, bool aAllowIdleDispatch);
+  void Remove(IdleTaskRunner* aRunner);
+
+  NS_IMETHOD Run() override;
+
+  void SetDeadline(TimeStamp aDeadline) override { mDeadline = aDeadline; }
+  // The runners have timers of their own.
+  void SetTimer(uint32_t aDelay, nsIEventTarget* aTarget) override {}
+
+private:
+  ~IdleTaskRunnerScheduler()
+  {
+    if (mScheduleTimer) {
+      mScheduleTimer->Cancel();
+    }
+  }
+
+  void Dispatch(bool aAllowIdleDispatch);
+
+  static void ScheduleTimedOut(nsITimer* aTimer, void* aClosure);
+
+  struct HardDeadlineComparator
+  {
+    // Runners without an active timer go last.
+    static TimeStamp Key(const IdleTaskRunner* aRunner)
+    {
+      return aRunner->mTimerActive ? aRunner->mTimerDeadline : TimeStamp();
+    }
+
+    bool Equals(const RefPtr<IdleTaskRunner>& aA,
+                const RefPtr<IdleTaskRunner>& aB) const
+    {
+      return Key(aA) == Key(aB);
+    }
+
+    bool LessThan(const RefPtr<IdleTaskRunner>& aA,
+                  const RefPtr<IdleTaskRunner>& aB) const
+    {
+      TimeStamp a = Key(aA);
+      TimeStamp b = Key(aB);
+      return !a.IsNull() && (b.IsNull() || a < b);
+    }
+  };
+
+  nsTArray<RefPtr<IdleTaskRunner>> mQueue;
+  nsCOMPtr<nsITimer> mScheduleTimer;
+  TimeStamp mDeadline;
+  bool mDispatched;
+};
+
+static StaticRefPtr<IdleTaskRunnerScheduler> sIdleTaskRunnerScheduler;
+
+/* static */ IdleTaskRunnerScheduler*
+IdleTaskRunnerScheduler::Get()
+{
+  MOZ_ASSERT(NS_IsMainThread());
+  if (!sIdleTaskRunnerScheduler) {
+    sIdleTaskRunnerScheduler = new IdleTaskRunnerScheduler();
+    ClearOnShutdown(&sIdleTaskRunnerScheduler);
+  }
+  return sIdleTaskRunnerScheduler;
+}
+
+void
+IdleTaskRunnerScheduler::Enqueue(IdleTaskRunner* aRunner,
+                                 bool aAllowIdleDispatch)
+{
+  if (!mQueue.Contains(aRunner)) {
+    mQueue.AppendElement(aRunner);
+  }
+  Dispatch(aAllowIdleDispatch);
+}
+
+void
+IdleTaskRunnerScheduler::Remove(IdleTaskRunner* aRunner)
+{
+  mQueue.RemoveElement(aRunner);
+}
+
+void
+IdleTaskRunnerScheduler::Dispatch(bool aAllowIdleDispatch)
+{
+  if (mDispatched) {
+    return;
+  }
+
+  TimeStamp now = TimeStamp::Now();
+  TimeStamp hint = nsRefreshDriver::GetIdleDeadlineHint(now);
+  if (hint != now) {
+    // RefreshDriver is ticking, let it schedule the idle dispatch.
+    nsRefreshDriver::DispatchIdleRunnableAfterTick(this, 0);
+  } else if (aAllowIdleDispatch) {
+    // RefreshDriver doesn't seem to be running.
+    nsCOMPtr<nsIRunnable> runnable = this;
+    NS_IdleDispatchToCurrentThread(runnable.forget());
+  } else {
+    if (!mScheduleTimer) {
+      mScheduleTimer = do_CreateInstance(NS_TIMER_CONTRACTID);
+      if (!mScheduleTimer) {
+        return;
+      }
+    }
+    // Nothing could run in the current idle period, so don't dispatch into it
+    // again right away, since that could lead to a loop until it ends.
+    mScheduleTimer->InitWithNamedFuncCallback(ScheduleTimedOut, this, 16,
+                                              nsITimer::TYPE_ONE_SHOT_LOW_PRIORITY,
+                                              "IdleTaskRunnerScheduler");
+  }
+  mDispatched = true;
+}
+
+/* static */ void
+IdleTaskRunnerScheduler::ScheduleTimedOut(nsITimer* aTimer, void* aClosure)
+{
+  RefPtr<IdleTaskRunnerScheduler> scheduler =
+    static_cast<IdleTaskRunnerScheduler*>(aClosure);
+  scheduler->mDispatched = false;
+  if (!scheduler->mQueue.IsEmpty()) {
+    scheduler->Dispatch(true);
+  }
+}
+
+NS_IMETHODIMP
+IdleTaskRunnerScheduler::Run()
+{
+  mDispatched = false;
+  TimeStamp deadline = mDeadline;
+  mDeadline = TimeStamp();
+
+  // Runners scheduling themselves again while we run them go into mQueue,
+  // to wait for the next idle period.
+  nsTArray<RefPtr<IdleTaskRunner>> queue;
+  queue.SwapElements(mQueue);
+  queue.Sort(HardDeadlineComparator());
+
+  bool didRun = false;
+  for (RefPtr<IdleTaskRunner>& runner : queue) {
+    // Runners may cancel each other.
+    if (!runner->mCallback) {
+      continue;
+    }
+
+    // A runner that doesn't fit into what is left of the idle period waits for
+    // the next one, but a cheaper one after it may still fit.
+    if (deadline.IsNull() ||
+        TimeStamp::Now() + runner->mBudget >= deadline) {
+      if (!mQueue.Contains(runner)) {
+        mQueue.AppendElement(runner);
+      }
+      continue;
+    }
+
+    runner->SetDeadline(deadline);
+    runner->Run();
+    didRun = true;
+  }
+
+  if (!mQueue.IsEmpty()) {
+    Dispatch(didRun);
+  }
+  return NS_OK;
+}
+
 already_AddRefed<IdleTaskRunner>
-IdleTaskRunner::Create(const CallbackType& aCallback, uint32_t aDelay,
+IdleTaskRunner::Create(const CallbackType& aCallback,
+                       const char* aRunnableName, uint32_t aDelay,
                        int64_t aBudget, bool aRepeating,
                        const MayStopProcessingCallbackType& aMayStopProcessing,
                        TaskCategory aTaskCategory)
@@ -22,18 +203,21 @@ IdleTaskRunner::Create(const CallbackType& aCallback, uint32_t aDelay,
   }
 
   RefPtr<IdleTaskRunner> runner =
-    new IdleTaskRunner(aCallback, aDelay, aBudget, aRepeating,
+    new IdleTaskRunner(aCallback, aRunnableName, aDelay, aBudget, aRepeating,
                        aMayStopProcessing, aTaskCategory);
   runner->Schedule(false); // Initial scheduling shouldn't use idle dispatch.
   return runner.forget();
 }
 
 IdleTaskRunner::IdleTaskRunner(const CallbackType& aCallback,
+                               const char* aRunnableName,
                                uint32_t aDelay, int64_t aBudget,
                                bool aRepeating,
                                const MayStopProcessingCallbackType& aMayStopProcessing,
                                TaskCategory aTaskCategory)
-  : mCallback(aCallback), mDelay(aDelay)
+  : IdleRunnable(aRunnableName)
+  , mCallback(aCallback), mDelay(aDelay)
+  , mName(aRunnableName)
   , mBudget(TimeDuration::FromMilliseconds(aBudget))
   , mRepeating(aRepeating), mTimerActive(false)
   , mMayStopProcessing(aMayStopProcessing)
@@ -73,11 +257,26 @@ IdleTaskRunner::Run()
   return NS_OK;
 }
 
+void
+IdleTaskRunner::TimerFired()
+{
+  mTimerActive = false;
+  if (!mCallback) {
+    return;
+  }
+
+  // Our hard deadline passed without idle time we fit in.
+  Telemetry::Accumulate(Telemetry::IDLE_TASK_RUNNER_MISSED_DEADLINE,
+                        nsDependentCString(mName), 1);
+  mDeadline = TimeStamp();
+  Run();
+}
+
 static void
 TimedOut(nsITimer* aTimer, void* aClosure)
 {
   RefPtr<IdleTaskRunner> runnable = static_cast<IdleTaskRunner*>(aClosure);
-  runnable->Run();
+  runnable->TimerFired();
 }
 
 void
@@ -128,35 +327,28 @@ IdleTaskRunner::Schedule(bool aAllowIdleDispatch)
   mDeadline = TimeStamp();
   TimeStamp now = TimeStamp::Now();
   TimeStamp hint = nsRefreshDriver::GetIdleDeadlineHint(now);
-  if (hint != now) {
-    // RefreshDriver is ticking, let it schedule the idle dispatch.
-    nsRefreshDriver::DispatchIdleRunnableAfterTick(this, mDelay);
-    // Ensure we get called at some point, even if RefreshDriver is stopped.
+  if (hint != now || aAllowIdleDispatch) {
+    // Ensure we get called at some point, even if there's no idle time.
     SetTimerInternal(mDelay);
+    IdleTaskRunnerScheduler::Get()->Enqueue(this, aAllowIdleDispatch);
   } else {
     // RefreshDriver doesn't seem to be running.
-    if (aAllowIdleDispatch) {
-      nsCOMPtr<nsIRunnable> runnable = this;
-      SetTimerInternal(mDelay);
-      NS_IdleDispatchToCurrentThread(runnable.forget());
-    } else {
+    if (!mScheduleTimer) {
+      mScheduleTimer = do_CreateInstance(NS_TIMER_CONTRACTID);
       if (!mScheduleTimer) {
-        mScheduleTimer = do_CreateInstance(NS_TIMER_CONTRACTID);
-        if (!mScheduleTimer) {
-          return;
-        }
-      } else {
-        mScheduleTimer->Cancel();
+        return;
       }
-      if (TaskCategory::Count != mTaskCategory) {
-        mScheduleTimer->SetTarget(SystemGroup::EventTargetFor(mTaskCategory));
-      }
-      // We weren't allowed to do idle dispatch immediately, do it after a
-      // short timeout.
-      mScheduleTimer->InitWithNamedFuncCallback(ScheduleTimedOut, this, 16,
-                                                nsITimer::TYPE_ONE_SHOT_LOW_PRIORITY,
-                                                "IdleTaskRunner");
+    } else {
+      mScheduleTimer->Cancel();
     }
+    if (TaskCategory::Count != mTaskCategory) {
+      mScheduleTimer->SetTarget(SystemGroup::EventTargetFor(mTaskCategory));
+    }
+    // We weren't allowed to do idle dispatch immediately, do it after a
+    // short timeout.
+    mScheduleTimer->InitWithNamedFuncCallback(ScheduleTimedOut, this, 16,
+                                              nsITimer::TYPE_ONE_SHOT_LOW_PRIORITY,
+                                              "IdleTaskRunner");
   }
 }
 
@@ -168,7 +360,9 @@ IdleTaskRunner::~IdleTaskRunner()
 void
 IdleTaskRunner::CancelTimer()
 {
-  nsRefreshDriver::CancelIdleRunnable(this);
+  if (sIdleTaskRunnerScheduler) {
+    sIdleTaskRunnerScheduler->Remove(this);
+  }
   if (mTimer) {
     mTimer->Cancel();
   }
@@ -197,7 +391,8 @@ IdleTaskRunner::SetTimerInternal(uint32_t aDelay)
     }
     mTimer->InitWithNamedFuncCallback(TimedOut, this, aDelay,
                                       nsITimer::TYPE_ONE_SHOT,
-                                      "IdleTaskRunner");
+                                      mName);
+    mTimerDeadline = TimeStamp::Now() + TimeDuration::FromMilliseconds(aDelay);
     mTimerActive = true;
   }
 }
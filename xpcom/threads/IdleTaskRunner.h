@@ -14,11 +14,20 @@
 
 namespace mozilla {
 
+class IdleTaskRunnerScheduler;
+
 // A general purpose repeating callback runner (it can be configured
 // to a one-time runner, too.) If it is running repeatedly,
 // one has to either explicitly Cancel() the runner or have
 // MayContinueProcessing() callback return false to completely remove
 // the runner.
+//
+// All the runners of the main thread wait for idle time in one queue, which
+// runs them in order of their hard deadline (aDelay after being scheduled),
+// packing as many as fit their budgets into each idle period. A runner whose
+// hard deadline passes without idle time runs from its timer instead, which
+// is counted in the IDLE_TASK_RUNNER_MISSED_DEADLINE telemetry keyed by its
+// name.
 class IdleTaskRunner final : public IdleRunnable
 {
 public:
@@ -32,8 +41,8 @@ public:
 
 public:
   static already_AddRefed<IdleTaskRunner>
-  Create(const CallbackType& aCallback, uint32_t aDelay,
-         int64_t aBudget, bool aRepeating,
+  Create(const CallbackType& aCallback, const char* aRunnableName,
+         uint32_t aDelay, int64_t aBudget, bool aRepeating,
          const MayStopProcessingCallbackType& aMayStopProcessing,
          TaskCategory aTaskCategory = TaskCategory::Count);
 
@@ -46,7 +55,10 @@ public:
   void Schedule(bool aAllowIdleDispatch);
 
 private:
+  friend class IdleTaskRunnerScheduler;
+
   explicit IdleTaskRunner(const CallbackType& aCallback,
+                          const char* aRunnableName,
                           uint32_t aDelay, int64_t aBudget,
                           bool aRepeating,
                           const MayStopProcessingCallbackType& aMayStopProcessing,
@@ -54,12 +66,16 @@ private:
   ~IdleTaskRunner();
   void CancelTimer();
   void SetTimerInternal(uint32_t aDelay);
+  void TimerFired();
 
   nsCOMPtr<nsITimer> mTimer;
   nsCOMPtr<nsITimer> mScheduleTimer;
   CallbackType mCallback;
   uint32_t mDelay;
+  const char* mName;
   TimeStamp mDeadline;
+  // When mTimer fires, if it is active.
+  TimeStamp mTimerDeadline;
   TimeDuration mBudget;
   bool mRepeating;
   bool mTimerActive;
@@ -7,6 +7,7 @@
 #if !defined(MozPromise_h_)
 #define MozPromise_h_
 
+#include "mozilla/AbstractThread.h"
 #include "mozilla/IndexSequence.h"
 #include "mozilla/Logging.h"
 #include "mozilla/Maybe.h"
@@ -14,6 +15,7 @@
 #include "mozilla/Monitor.h"
 #include "mozilla/Tuple.h"
 #include "mozilla/TypeTraits.h"
+#include "mozilla/TaskDispatcher.h"
 #include "mozilla/Variant.h"
 
 #include "nsISerialEventTarget.h"
@@ -138,6 +140,12 @@ struct IsMozPromise<MozPromise<ResolveValueT, RejectValueT, IsExclusive>>
  *
  * When IsExclusive is true, the MozPromise does a release-mode assertion that
  * there is at most one call to either Then(...) or ChainTo(...).
+ *
+ * A promise that is resolved or rejected on the thread its consumers target
+ * can opt out of the event loop round-trip with Private::UseDirectTaskDispatch:
+ * if that thread is an AbstractThread supporting tail dispatch, the callbacks
+ * then run as direct tasks once the current task ends, ahead of the events
+ * already queued.
  */
 
 class MozPromiseRefcountable
@@ -243,6 +251,7 @@ protected:
     , mMutex("MozPromise Mutex")
     , mHaveRequest(false)
     , mIsCompletionPromise(aIsCompletionPromise)
+    , mUseDirectTaskDispatch(false)
 #ifdef PROMISE_DEBUG
     , mMagic4(&mMutex)
 #endif
@@ -458,6 +467,19 @@ protected:
                   aPromise->mValue.IsResolve() ? "Resolving" : "Rejecting", mCallSite,
                   r.get(), aPromise, this);
 
+      // Run the callback once the current task ends rather than going through
+      // the event queue, saving the task group and the event that dispatching
+      // from a tail dispatching thread costs.
+      if (aPromise->mUseDirectTaskDispatch) {
+        AbstractThread* current = AbstractThread::GetCurrent();
+        if (current && current->SupportsTailDispatch() &&
+            mResponseTarget.get() == static_cast<nsISerialEventTarget*>(current)) {
+          PROMISE_LOG("Direct task dispatch [Runnable=%p]", r.get());
+          current->TailDispatcher().AddDirectTask(r.forget());
+          return;
+        }
+      }
+
       // Promise consumers are allowed to disconnect the Request object and
       // then shut down the thread or task queue that the promise result would
       // be dispatched on. So we unfortunately can't assert that promise
@@ -1091,6 +1113,7 @@ protected:
 #endif
   bool mHaveRequest;
   const bool mIsCompletionPromise;
+  bool mUseDirectTaskDispatch;
 #ifdef PROMISE_DEBUG
   void* mMagic4;
 #endif
@@ -1104,6 +1127,16 @@ public:
   explicit Private(const char* aCreationSite, bool aIsCompletionPromise = false)
     : MozPromise(aCreationSite, aIsCompletionPromise) {}
 
+  // Run the callbacks targeting the thread resolving or rejecting this
+  // promise as direct tasks of its tail dispatcher, see above.
+  void UseDirectTaskDispatch(const char* aSite)
+  {
+    PROMISE_ASSERT(mMagic1 == sMagic && mMagic2 == sMagic && mMagic3 == sMagic && mMagic4 == &mMutex);
+    MutexAutoLock lock(mMutex);
+    PROMISE_LOG("%s UseDirectTaskDispatch MozPromise (%p created at %s)", aSite, this, mCreationSite);
+    mUseDirectTaskDispatch = true;
+  }
+
   template<typename ResolveValueT_>
   void Resolve(ResolveValueT_&& aResolveValue, const char* aResolveSite)
   {
@@ -1190,6 +1223,15 @@ public:
   // Provide a Monitor that should always be held when accessing this instance.
   void SetMonitor(Monitor* aMonitor) { mMonitor = aMonitor; }
 
+  void UseDirectTaskDispatch(const char* aSite)
+  {
+    if (mMonitor) {
+      mMonitor->AssertCurrentThreadOwns();
+    }
+    MOZ_ASSERT(mPromise);
+    mPromise->UseDirectTaskDispatch(aSite);
+  }
+
   bool IsEmpty() const
   {
     if (mMonitor) {
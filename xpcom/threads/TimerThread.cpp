@@ -35,6 +35,7 @@ TimerThread::TimerThread() :
   mWaiting(false),
   mNotified(false),
   mSleeping(false),
+  mCanceledTimers(0),
   mAllowedEarlyFiringMicroseconds(0)
 {
 }
@@ -351,6 +352,7 @@ TimerThread::Shutdown()
     // that leads to unexpected behavior or deadlock.
     // See bug 422472.
     mTimers.SwapElements(timers);
+    mCanceledTimers = 0;
   }
 
   uint32_t timersCount = timers.Length();
@@ -435,44 +437,35 @@ TimerThread::Run()
       if (!mTimers.IsEmpty()) {
         if (now >= mTimers[0]->Value()->mTimeout || forceRunThisTimer) {
     next:
-          // NB: AddRef before the Release under RemoveTimerInternal to avoid
-          // mRefCnt passing through zero, in case all other refs than the one
-          // from mTimers have gone away (the last non-mTimers[i]-ref's Release
-          // must be racing with us, blocked in gThread->RemoveTimer waiting
-          // for TimerThread::mMonitor, under nsTimerImpl::Release.
-
-          RefPtr<nsTimerImpl> timerRef(mTimers[0]->Take());
-          RemoveFirstTimerInternal();
-
-          MOZ_LOG(GetTimerLog(), LogLevel::Debug,
-                 ("Timer thread woke up %fms from when it was supposed to\n",
-                  fabs((now - timerRef->mTimeout).ToMilliseconds())));
-
-          // We are going to let the call to PostTimerEvent here handle the
-          // release of the timer so that we don't end up releasing the timer
-          // on the TimerThread instead of on the thread it targets.
-          timerRef = PostTimerEvent(timerRef.forget());
-
-          if (timerRef) {
-            // We got our reference back due to an error.
-            // Unhook the nsRefPtr, and release manually so we can get the
-            // refcount.
-            nsrefcnt rc = timerRef.forget().take()->Release();
-            (void)rc;
-
-            // The nsITimer interface requires that its users keep a reference
-            // to the timers they use while those timers are initialized but
-            // have not yet fired.  If this ever happens, it is a bug in the
-            // code that created and used the timer.
-            //
-            // Further, note that this should never happen even with a
-            // misbehaving user, because nsTimerImpl::Release checks for a
-            // refcount of 1 with an armed timer (a timer whose only reference
-            // is from the timer thread) and when it hits this will remove the
-            // timer from the timer thread and thus destroy the last reference,
-            // preventing this situation from occurring.
-            MOZ_ASSERT(rc != 0, "destroyed timer off its target thread!");
-          }
+          // Fire the first timer together with every other timer due within
+          // the early firing window, so that timers clustered around the same
+          // time cost a single wakeup and a single unlock of mMonitor.
+          TimeStamp batchEnd = now +
+            TimeDuration::FromMicroseconds(mAllowedEarlyFiringMicroseconds);
+          AutoTArray<RefPtr<nsTimerImpl>, 8> timers;
+          do {
+            // NB: AddRef before the Release under RemoveTimerInternal to avoid
+            // mRefCnt passing through zero, in case all other refs than the one
+            // from mTimers have gone away (the last non-mTimers[i]-ref's Release
+            // must be racing with us, blocked in gThread->RemoveTimer waiting
+            // for TimerThread::mMonitor, under nsTimerImpl::Release.
+
+            RefPtr<nsTimerImpl> timerRef(mTimers[0]->Take());
+            RemoveFirstTimerInternal();
+
+            MOZ_LOG(GetTimerLog(), LogLevel::Debug,
+                   ("Timer thread woke up %fms from when it was supposed to\n",
+                    fabs((now - timerRef->mTimeout).ToMilliseconds())));
+
+            timers.AppendElement(timerRef.forget());
+            RemoveLeadingCanceledTimersInternal();
+          } while (!mTimers.IsEmpty() &&
+                   mTimers[0]->Value()->mTimeout <= batchEnd);
+
+          // We are going to let the call to PostTimerEvents here handle the
+          // release of the timers so that we don't end up releasing them on
+          // the TimerThread instead of on the threads they target.
+          PostTimerEvents(timers);
 
           if (mShutdown) {
             break;
@@ -700,6 +693,15 @@ TimerThread::RemoveTimerInternal(nsTimerImpl* aTimer)
     return false;
   }
   aTimer->mHolder->Forget(aTimer);
+
+  // Canceled entries are only dropped once they reach the front of the heap,
+  // which a timer re-armed with a longer delay each time (network and idle
+  // timeouts are) never lets happen. Dropping them all once they make up
+  // half of the heap keeps it proportional to the armed timers.
+  ++mCanceledTimers;
+  if (mCanceledTimers > 64 && mCanceledTimers > mTimers.Length() / 2) {
+    CompactTimersInternal();
+  }
   return true;
 }
 
@@ -727,8 +729,10 @@ TimerThread::RemoveLeadingCanceledTimersInternal()
   // nsTArray.  Note, since std::pop_heap() uses iterators
   // we must convert to nsTArray indices and number of
   // elements here.
-  mTimers.RemoveElementsAt(sortedEnd - mTimers.begin(),
-                           mTimers.end() - sortedEnd);
+  size_t canceled = mTimers.end() - sortedEnd;
+  MOZ_ASSERT(canceled <= mCanceledTimers);
+  mCanceledTimers -= canceled;
+  mTimers.RemoveElementsAt(sortedEnd - mTimers.begin(), canceled);
 }
 
 void
@@ -740,60 +744,120 @@ TimerThread::RemoveFirstTimerInternal()
   mTimers.RemoveElementAt(mTimers.Length() - 1);
 }
 
-already_AddRefed<nsTimerImpl>
-TimerThread::PostTimerEvent(already_AddRefed<nsTimerImpl> aTimerRef)
+void
+TimerThread::CompactTimersInternal()
 {
   mMonitor.AssertCurrentThreadOwns();
 
-  RefPtr<nsTimerImpl> timer(aTimerRef);
-  if (!timer->mEventTarget) {
-    NS_ERROR("Attempt to post timer event to NULL event target");
-    return timer.forget();
-  }
+  mTimers.RemoveElementsBy([](UniquePtr<Entry>& aEntry) {
+    return !aEntry->Value();
+  });
+  std::make_heap(mTimers.begin(), mTimers.end(), Entry::UniquePtrLessThan);
+  mCanceledTimers = 0;
+}
 
-  // XXX we may want to reuse this nsTimerEvent in the case of repeating timers.
+namespace {
 
-  // Since we already addref'd 'timer', we don't need to addref here.
-  // We will release either in ~nsTimerEvent(), or pass the reference back to
-  // the caller. We need to copy the generation number from this timer into the
-  // event, so we can avoid firing a timer that was re-initialized after being
-  // canceled.
+// Release the timer thread's reference to a timer whose event couldn't be
+// posted.
+void
+ReleaseUnpostedTimer(already_AddRefed<nsTimerImpl> aTimerRef)
+{
+  // Unhook the reference, and release manually so we can get the refcount.
+  nsrefcnt rc = aTimerRef.take()->Release();
+  (void)rc;
+
+  // The nsITimer interface requires that its users keep a reference to the
+  // timers they use while those timers are initialized but have not yet
+  // fired.  If this ever happens, it is a bug in the code that created and
+  // used the timer.
+  //
+  // Further, note that this should never happen even with a misbehaving
+  // user, because nsTimerImpl::Release checks for a refcount of 1 with an
+  // armed timer (a timer whose only reference is from the timer thread) and
+  // when it hits this will remove the timer from the timer thread and thus
+  // destroy the last reference, preventing this situation from occurring.
+  MOZ_ASSERT(rc != 0, "destroyed timer off its target thread!");
+}
 
-  RefPtr<nsTimerEvent> event = new nsTimerEvent;
-  if (!event) {
-    return timer.forget();
-  }
+} // namespace
 
-  if (MOZ_LOG_TEST(GetTimerLog(), LogLevel::Debug)) {
-    event->mInitTime = TimeStamp::Now();
-  }
+void
+TimerThread::PostTimerEvents(nsTArray<RefPtr<nsTimerImpl>>& aTimers)
+{
+  mMonitor.AssertCurrentThreadOwns();
 
+  struct PendingTimerEvent
+  {
+    RefPtr<nsTimerEvent> mEvent;
+    nsCOMPtr<nsIEventTarget> mTarget;
 #ifdef MOZ_TASK_TRACER
-  // During the dispatch of TimerEvent, we overwrite the current TraceInfo
-  // partially with the info saved in timer earlier, and restore it back by
-  // AutoSaveCurTraceInfo.
-  AutoSaveCurTraceInfo saveCurTraceInfo;
-  (timer->GetTracedTask()).SetTLSTraceInfo();
+    TracedTaskCommon mTracedTask;
 #endif
+  };
+
+  AutoTArray<PendingTimerEvent, 8> events;
+  for (RefPtr<nsTimerImpl>& timer : aTimers) {
+    if (!timer->mEventTarget) {
+      NS_ERROR("Attempt to post timer event to NULL event target");
+      ReleaseUnpostedTimer(timer.forget());
+      continue;
+    }
+
+    // XXX we may want to reuse this nsTimerEvent in the case of repeating timers.
+
+    // Since we already addref'd 'timer', we don't need to addref here.
+    // We will release either in ~nsTimerEvent(), or below if the dispatch
+    // fails. We need to copy the generation number from this timer into the
+    // event, so we can avoid firing a timer that was re-initialized after
+    // being canceled.
+
+    RefPtr<nsTimerEvent> event = new nsTimerEvent;
+    if (!event) {
+      ReleaseUnpostedTimer(timer.forget());
+      continue;
+    }
+
+    if (MOZ_LOG_TEST(GetTimerLog(), LogLevel::Debug)) {
+      event->mInitTime = TimeStamp::Now();
+    }
 
-  nsCOMPtr<nsIEventTarget> target = timer->mEventTarget;
-  event->SetTimer(timer.forget());
+    PendingTimerEvent* pending = events.AppendElement();
+    pending->mTarget = timer->mEventTarget;
+#ifdef MOZ_TASK_TRACER
+    pending->mTracedTask = timer->GetTracedTask();
+#endif
+    event->SetTimer(timer.forget());
+    pending->mEvent = event.forget();
+  }
+  aTimers.Clear();
 
-  nsresult rv;
   {
-    // We release mMonitor around the Dispatch because if this timer is targeted
+    // We release mMonitor around the Dispatch because if a timer is targeted
     // at the TimerThread we'll deadlock.
     MonitorAutoUnlock unlock(mMonitor);
-    rv = target->Dispatch(event, NS_DISPATCH_NORMAL);
+    for (PendingTimerEvent& pending : events) {
+#ifdef MOZ_TASK_TRACER
+      // During the dispatch of TimerEvent, we overwrite the current TraceInfo
+      // partially with the info saved in timer earlier, and restore it back by
+      // AutoSaveCurTraceInfo.
+      AutoSaveCurTraceInfo saveCurTraceInfo;
+      pending.mTracedTask.SetTLSTraceInfo();
+#endif
+      nsresult rv = pending.mTarget->Dispatch(pending.mEvent, NS_DISPATCH_NORMAL);
+      if (NS_SUCCEEDED(rv)) {
+        pending.mEvent = nullptr;
+      }
+    }
   }
 
-  if (NS_FAILED(rv)) {
-    timer = event->ForgetTimer();
-    RemoveTimerInternal(timer);
-    return timer.forget();
+  for (PendingTimerEvent& pending : events) {
+    if (pending.mEvent) {
+      RefPtr<nsTimerImpl> timer = pending.mEvent->ForgetTimer();
+      RemoveTimerInternal(timer);
+      ReleaseUnpostedTimer(timer.forget());
+    }
   }
-
-  return nullptr;
 }
 
 void
@@ -70,9 +70,12 @@ private:
   bool    RemoveTimerInternal(nsTimerImpl* aTimer);
   void    RemoveLeadingCanceledTimersInternal();
   void    RemoveFirstTimerInternal();
+  void    CompactTimersInternal();
   nsresult Init();
 
-  already_AddRefed<nsTimerImpl> PostTimerEvent(already_AddRefed<nsTimerImpl> aTimerRef);
+  // Post the events of a batch of due timers to their targets, releasing
+  // mMonitor once for the whole batch. aTimers is left empty.
+  void PostTimerEvents(nsTArray<RefPtr<nsTimerImpl>>& aTimers);
 
   nsCOMPtr<nsIThread> mThread;
   Monitor mMonitor;
@@ -124,6 +127,9 @@ private:
   };
 
   nsTArray<UniquePtr<Entry>> mTimers;
+  // The number of entries of mTimers whose timer was canceled, and that
+  // haven't reached the front of the heap yet.
+  uint32_t mCanceledTimers;
   uint32_t mAllowedEarlyFiringMicroseconds;
 };
 
@@ -11,6 +11,8 @@
 #include "prthread.h"
 #include "mozilla/ChaosMode.h"
 
+#include <string.h>
+
 using namespace mozilla;
 
 static LazyLogModule sEventQueueLog("nsEventQueue");
@@ -22,10 +24,12 @@ static LazyLogModule sEventQueueLog("nsEventQueue");
 nsEventQueue::nsEventQueue(mozilla::CondVar& aCondVar, EventQueueType aType)
   : mHead(nullptr)
   , mTail(nullptr)
+  , mSparePage(nullptr)
   , mOffsetHead(0)
   , mOffsetTail(0)
   , mEventsAvailable(aCondVar)
   , mType(aType)
+  , mWaiting(false)
 {
 }
 
@@ -39,6 +43,32 @@ nsEventQueue::~nsEventQueue()
   if (mHead) {
     FreePage(mHead);
   }
+  if (mSparePage) {
+    FreePage(mSparePage);
+  }
+}
+
+nsEventQueue::Page*
+nsEventQueue::TakePage()
+{
+  Page* page = mSparePage;
+  if (!page) {
+    return NewPage();
+  }
+  mSparePage = nullptr;
+  return page;
+}
+
+void
+nsEventQueue::RecyclePage(Page* aPage)
+{
+  if (mSparePage) {
+    FreePage(aPage);
+    return;
+  }
+  // PutEvent expects the slots of a new page to be null.
+  memset(aPage, 0, sizeof(Page));
+  mSparePage = aPage;
 }
 
 bool
@@ -73,7 +103,10 @@ nsEventQueue::GetEvent(bool aMayWait, nsIRunnable** aResult,
       return false;
     }
     LOG(("EVENTQ(%p): wait begin\n", this));
+    MOZ_ASSERT(!mWaiting, "Only one thread may wait for the events of a queue");
+    mWaiting = true;
     mEventsAvailable.Wait();
+    mWaiting = false;
     LOG(("EVENTQ(%p): wait end\n", this));
 
     if (mType == eSharedCondVarQueue) {
@@ -96,7 +129,7 @@ nsEventQueue::GetEvent(bool aMayWait, nsIRunnable** aResult,
     if (mOffsetHead == EVENTS_PER_PAGE) {
       Page* dead = mHead;
       mHead = mHead->mNext;
-      FreePage(dead);
+      RecyclePage(dead);
       mOffsetHead = 0;
     }
   }
@@ -109,14 +142,14 @@ nsEventQueue::PutEvent(already_AddRefed<nsIRunnable>&& aRunnable,
                        MutexAutoLock& aProofOfLock)
 {
   if (!mHead) {
-    mHead = NewPage();
+    mHead = TakePage();
     MOZ_ASSERT(mHead);
 
     mTail = mHead;
     mOffsetHead = 0;
     mOffsetTail = 0;
   } else if (mOffsetTail == EVENTS_PER_PAGE) {
-    Page* page = NewPage();
+    Page* page = TakePage();
     MOZ_ASSERT(page);
 
     mTail->mNext = page;
@@ -128,8 +161,10 @@ nsEventQueue::PutEvent(already_AddRefed<nsIRunnable>&& aRunnable,
   MOZ_ASSERT(!queueLocation);
   queueLocation = aRunnable.take();
   ++mOffsetTail;
-  LOG(("EVENTQ(%p): notify\n", this));
-  mEventsAvailable.Notify();
+  if (mWaiting) {
+    LOG(("EVENTQ(%p): notify\n", this));
+    mEventsAvailable.Notify();
+  }
 }
 
 void
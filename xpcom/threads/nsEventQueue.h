@@ -15,8 +15,6 @@
 #include "mozilla/AlreadyAddRefed.h"
 #include "mozilla/UniquePtr.h"
 
-class nsThreadPool;
-
 // A threadsafe FIFO event queue...
 class nsEventQueue
 {
@@ -34,11 +32,21 @@ public:
 
   // This method adds a new event to the pending event queue.  The queue holds
   // a strong reference to the event after this method returns.  This method
-  // cannot fail.
+  // cannot fail.  The condition variable is only notified when a thread waits
+  // for an event in GetEvent.
   void PutEvent(nsIRunnable* aEvent, MutexAutoLock& aProofOfLock);
   void PutEvent(already_AddRefed<nsIRunnable>&& aEvent,
                 MutexAutoLock& aProofOfLock);
 
+  // Wake up the thread waiting for an event of this queue, if any.  Used when
+  // an event was added to another queue sharing its condition variable.
+  void NotifyWaiter(MutexAutoLock& aProofOfLock)
+  {
+    if (mWaiting) {
+      mEventsAvailable.Notify();
+    }
+  }
+
   // Return the first event in the queue without popping it. Returns whether the
   // queue was empty or not. aEvent is set to null if the queue was empty.
   bool PeekEvent(nsIRunnable** aEvent, MutexAutoLock& aProofOfLock);
@@ -98,8 +106,14 @@ private:
     free(aPage);
   }
 
+  // Recycle the spare page, if any, so that a queue with a steady flow of
+  // events doesn't allocate and free a page every EVENTS_PER_PAGE events.
+  Page* TakePage();
+  void RecyclePage(Page* aPage);
+
   Page* mHead;
   Page* mTail;
+  Page* mSparePage;
 
   uint16_t mOffsetHead;  // offset into mHead where next item is removed
   uint16_t mOffsetTail;  // offset into mTail where next item is added
@@ -107,21 +121,9 @@ private:
 
   EventQueueType mType;
 
-  // These methods are made available to nsThreadPool as a hack, since
-  // nsThreadPool needs to have its threads sleep for fixed amounts of
-  // time as well as being able to wake up all threads when thread
-  // limits change.
-  friend class nsThreadPool;
-  void Wait(PRIntervalTime aInterval)
-  {
-    MOZ_ASSERT(mType == eNormalQueue);
-    mEventsAvailable.Wait(aInterval);
-  }
-  void NotifyAll()
-  {
-    MOZ_ASSERT(mType == eNormalQueue);
-    mEventsAvailable.NotifyAll();
-  }
+  // Whether a thread waits for mEventsAvailable in GetEvent.  Protected by
+  // the lock of mEventsAvailable.
+  bool mWaiting;
 };
 
 #endif  // nsEventQueue_h__
@@ -174,19 +174,35 @@ protected:
                   mozilla::MutexAutoLock& aProofOfLock)
     {
       RefPtr<nsIRunnable> event(aEvent);
+      uint32_t prio = GetPriority(event);
+      PutEvent(event.forget(), prio, aProofOfLock);
+    }
+
+    // aPriority must be GetPriority(aEvent), which callers can compute
+    // before taking the lock.
+    void PutEvent(already_AddRefed<nsIRunnable> aEvent, uint32_t aPriority,
+                  mozilla::MutexAutoLock& aProofOfLock)
+    {
+      if (aPriority == nsIRunnablePriority::PRIORITY_NORMAL) {
+        mNormalQueue->PutEvent(Move(aEvent), aProofOfLock);
+      } else {
+        mSecondaryQueue->PutEvent(Move(aEvent), aProofOfLock);
+        // Only GetEvent on the normal queue waits on the shared CondVar.
+        mNormalQueue->NotifyWaiter(aProofOfLock);
+      }
+    }
+
+    static uint32_t GetPriority(nsIRunnable* aEvent)
+    {
       nsCOMPtr<nsIRunnablePriority> runnablePrio =
-        do_QueryInterface(event);
+        do_QueryInterface(aEvent);
       uint32_t prio = nsIRunnablePriority::PRIORITY_NORMAL;
       if (runnablePrio) {
         runnablePrio->GetPriority(&prio);
       }
       MOZ_ASSERT(prio == nsIRunnablePriority::PRIORITY_NORMAL ||
                  prio == nsIRunnablePriority::PRIORITY_HIGH);
-      if (prio == nsIRunnablePriority::PRIORITY_NORMAL) {
-        mNormalQueue->PutEvent(event.forget(), aProofOfLock);
-      } else {
-        mSecondaryQueue->PutEvent(event.forget(), aProofOfLock);
-      }
+      return prio;
     }
 
     bool HasPendingEvent(mozilla::MutexAutoLock& aProofOfLock)
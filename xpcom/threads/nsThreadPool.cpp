@@ -12,8 +12,12 @@
 #include "nsAutoPtr.h"
 #include "prinrval.h"
 #include "mozilla/Logging.h"
+#include "mozilla/Maybe.h"
+#include "mozilla/Telemetry.h"
 #include "nsThreadSyncDispatch.h"
 
+#include <algorithm>
+
 using namespace mozilla;
 
 static LazyLogModule sThreadPoolLog("nsThreadPool");
@@ -27,6 +31,10 @@ static LazyLogModule sThreadPoolLog("nsThreadPool");
 //  o  Use nsThreadPool::Run as the main routine for each thread.
 //  o  Each thread waits on the event queue's monitor, checking for
 //     pending events and rescheduling itself as an idle thread.
+//  o  In work stealing mode, events are spread over one queue per thread,
+//     each with its own lock. Threads take events from their home queue
+//     first, then from the others, and only take the pool lock to go idle.
+//     Dispatching takes the pool lock only to wake an idle thread.
 
 #define DEFAULT_THREAD_LIMIT 4
 #define DEFAULT_IDLE_THREAD_LIMIT 1
@@ -43,13 +51,17 @@ NS_IMPL_CI_INTERFACE_GETTER(nsThreadPool, nsIThreadPool, nsIEventTarget)
 nsThreadPool::nsThreadPool()
   : mMutex("[nsThreadPool.mMutex]")
   , mEventsAvailable(mMutex, "[nsThreadPool.mEventsAvailable]")
-  , mEvents(mEventsAvailable, nsEventQueue::eNormalQueue)
   , mThreadLimit(DEFAULT_THREAD_LIMIT)
   , mIdleThreadLimit(DEFAULT_IDLE_THREAD_LIMIT)
   , mIdleThreadTimeout(DEFAULT_IDLE_THREAD_TIMEOUT)
   , mIdleCount(0)
+  , mThreadCount(0)
   , mStackSize(nsIThreadManager::DEFAULT_STACK_SIZE)
   , mShutdown(false)
+  , mDispatched(false)
+  , mStealingQueueCount(0)
+  , mNextStealingQueue(0)
+  , mNextHomeQueue(0)
 {
   LOG(("THRD-P(%p) constructor!!!\n", this));
 }
@@ -71,18 +83,24 @@ nsThreadPool::PutEvent(nsIRunnable* aEvent)
 nsresult
 nsThreadPool::PutEvent(already_AddRefed<nsIRunnable> aEvent, uint32_t aFlags)
 {
+  if (!mDispatched) {
+    mDispatched = true;
+  }
+  if (mStealingQueues) {
+    return PutStealingEvent(Move(aEvent), aFlags);
+  }
+
   // Avoid spawning a new thread while holding the event queue lock...
 
   bool spawnThread = false;
-  uint32_t stackSize = 0;
   {
     MutexAutoLock lock(mMutex);
 
     if (NS_WARN_IF(mShutdown)) {
       return NS_ERROR_NOT_AVAILABLE;
     }
-    LOG(("THRD-P(%p) put [%d %d %d]\n", this, mIdleCount, mThreads.Count(),
-         mThreadLimit));
+    LOG(("THRD-P(%p) put [%d %d %d]\n", this, uint32_t(mIdleCount),
+         mThreads.Count(), mThreadLimit));
     MOZ_ASSERT(mIdleCount <= (uint32_t)mThreads.Count(), "oops");
 
     // Make sure we have a thread to service this event.
@@ -90,18 +108,85 @@ nsThreadPool::PutEvent(already_AddRefed<nsIRunnable> aEvent, uint32_t aFlags)
         !(aFlags & NS_DISPATCH_AT_END) &&
         // Spawn a new thread if we don't have enough idle threads to serve
         // pending events immediately.
-        mEvents.Count(lock) >= mIdleCount) {
+        mEvents.size() >= mIdleCount) {
       spawnThread = true;
     }
 
-    mEvents.PutEvent(Move(aEvent), lock);
-    stackSize = mStackSize;
+    mEvents.push_back(PendingEvent { Move(aEvent), TimeStamp::Now() });
+    mEventsAvailable.Notify();
   }
 
   LOG(("THRD-P(%p) put [spawn=%d]\n", this, spawnThread));
   if (!spawnThread) {
     return NS_OK;
   }
+  return SpawnThread();
+}
+
+nsresult
+nsThreadPool::PutStealingEvent(already_AddRefed<nsIRunnable> aEvent,
+                               uint32_t aFlags)
+{
+  if (NS_WARN_IF(mShutdown)) {
+    return NS_ERROR_NOT_AVAILABLE;
+  }
+
+  StealingQueue& queue =
+    mStealingQueues[mNextStealingQueue++ % mStealingQueueCount];
+  {
+    MutexAutoLock lock(queue.mMutex);
+
+    // Shutdown() takes every queue lock after setting mShutdown, so no event
+    // is added once the threads stop looking for them.
+    if (NS_WARN_IF(mShutdown)) {
+      return NS_ERROR_NOT_AVAILABLE;
+    }
+    queue.mEvents.push_back(PendingEvent { Move(aEvent), TimeStamp::Now() });
+  }
+
+  // A thread only waits after it went idle and looked at every queue again
+  // with mMutex held, so an idle thread either sees this event or gets
+  // notified below.
+  if (mIdleCount > 0) {
+    MutexAutoLock lock(mMutex);
+    if (mIdleCount > 0) {
+      mEventsAvailable.Notify();
+      return NS_OK;
+    }
+  }
+
+  LOG(("THRD-P(%p) put stealing [%d %d]\n", this, uint32_t(mThreadCount),
+       mThreadLimit));
+  if (mThreadCount >= mThreadLimit || (aFlags & NS_DISPATCH_AT_END)) {
+    return NS_OK;
+  }
+  return SpawnThread();
+}
+
+bool
+nsThreadPool::GetStealingEvent(uint32_t aHomeQueue, PendingEvent& aEvent)
+{
+  for (uint32_t i = 0; i < mStealingQueueCount; ++i) {
+    StealingQueue& queue =
+      mStealingQueues[(aHomeQueue + i) % mStealingQueueCount];
+    MutexAutoLock lock(queue.mMutex);
+    if (!queue.mEvents.empty()) {
+      aEvent = Move(queue.mEvents.front());
+      queue.mEvents.pop_front();
+      return true;
+    }
+  }
+  return false;
+}
+
+nsresult
+nsThreadPool::SpawnThread()
+{
+  uint32_t stackSize;
+  {
+    MutexAutoLock lock(mMutex);
+    stackSize = mStackSize;
+  }
 
   nsCOMPtr<nsIThread> thread;
   nsresult rv = NS_NewNamedThread(mThreadNaming.GetNextThreadName(mName),
@@ -115,6 +200,7 @@ nsThreadPool::PutEvent(already_AddRefed<nsIRunnable> aEvent, uint32_t aFlags)
     MutexAutoLock lock(mMutex);
     if (mThreads.Count() < (int32_t)mThreadLimit) {
       mThreads.AppendObject(thread);
+      mThreadCount = mThreads.Count();
     } else {
       killThread = true;  // okay, we don't need this thread anymore
     }
@@ -173,12 +259,32 @@ nsThreadPool::Run()
     listener->OnThreadCreated();
   }
 
+  // In work stealing mode, the queue this thread looks at first.
+  uint32_t homeQueue = 0;
+  if (mStealingQueues) {
+    homeQueue = mNextHomeQueue++ % mStealingQueueCount;
+  }
+
   do {
-    nsCOMPtr<nsIRunnable> event;
-    {
+    PendingEvent event;
+    bool haveEvent = mStealingQueues && GetStealingEvent(homeQueue, event);
+    if (haveEvent) {
+      if (wasIdle) {
+        wasIdle = false;
+        --mIdleCount;
+      }
+    } else {
       MutexAutoLock lock(mMutex);
 
-      if (!mEvents.GetPendingEvent(getter_AddRefs(event), lock)) {
+      if (mStealingQueues) {
+        haveEvent = GetStealingEvent(homeQueue, event);
+      } else if (!mEvents.empty()) {
+        event = Move(mEvents.front());
+        mEvents.pop_front();
+        haveEvent = true;
+      }
+
+      if (!haveEvent) {
         PRIntervalTime now     = PR_IntervalNow();
         PRIntervalTime timeout = PR_MillisecondsToInterval(mIdleThreadTimeout);
 
@@ -200,19 +306,29 @@ nsThreadPool::Run()
               ++mIdleCount;
               idleSince = now;
               wasIdle = true;
+
+              // An event dispatched to a queue we already looked at before
+              // becoming idle didn't notify us, so look again before waiting.
+              if (mStealingQueues) {
+                haveEvent = GetStealingEvent(homeQueue, event);
+              }
             }
           }
         }
 
-        if (exitThread) {
+        if (haveEvent) {
+          wasIdle = false;
+          --mIdleCount;
+        } else if (exitThread) {
           if (wasIdle) {
             --mIdleCount;
           }
           shutdownThreadOnExit = mThreads.RemoveObject(current);
+          mThreadCount = mThreads.Count();
         } else {
           PRIntervalTime delta = timeout - (now - idleSince);
           LOG(("THRD-P(%p) %s waiting [%d]\n", this, mName.BeginReading(), delta));
-          mEvents.Wait(delta);
+          mEventsAvailable.Wait(delta);
           LOG(("THRD-P(%p) done waiting\n", this));
         }
       } else if (wasIdle) {
@@ -220,9 +336,18 @@ nsThreadPool::Run()
         --mIdleCount;
       }
     }
-    if (event) {
-      LOG(("THRD-P(%p) %s running [%p]\n", this, mName.BeginReading(), event.get()));
-      event->Run();
+    if (haveEvent) {
+      LOG(("THRD-P(%p) %s running [%p]\n", this, mName.BeginReading(),
+           event.mEvent.get()));
+#ifndef RELEASE_OR_BETA
+      Maybe<Telemetry::AutoTimer<Telemetry::THREAD_POOL_EVENT_RUN_MS>> timer;
+      if (!mName.IsEmpty()) {
+        Telemetry::Accumulate(Telemetry::THREAD_POOL_EVENT_QUEUE_MS, mName,
+          uint32_t((TimeStamp::Now() - event.mDispatchTime).ToMilliseconds()));
+        timer.emplace(mName);
+      }
+#endif
+      event.mEvent->Run();
     }
   } while (!exitThread);
 
@@ -323,10 +448,16 @@ nsThreadPool::Shutdown()
   {
     MutexAutoLock lock(mMutex);
     mShutdown = true;
-    mEvents.NotifyAll();
+    mEventsAvailable.NotifyAll();
+
+    // Wait for the dispatches that raced with setting mShutdown.
+    for (uint32_t i = 0; i < mStealingQueueCount; ++i) {
+      MutexAutoLock queueLock(mStealingQueues[i].mMutex);
+    }
 
     threads.AppendObjects(mThreads);
     mThreads.Clear();
+    mThreadCount = 0;
 
     // Swap in a null listener so that we release the listener at the end of
     // this method. The listener will be kept alive as long as the other threads
@@ -362,7 +493,7 @@ nsThreadPool::SetThreadLimit(uint32_t aValue)
   }
 
   if (static_cast<uint32_t>(mThreads.Count()) > mThreadLimit) {
-    mEvents.NotifyAll();  // wake up threads so they observe this change
+    mEventsAvailable.NotifyAll();  // wake up threads so they observe this change
   }
   return NS_OK;
 }
@@ -386,7 +517,7 @@ nsThreadPool::SetIdleThreadLimit(uint32_t aValue)
 
   // Do we need to kill some idle threads?
   if (mIdleCount > mIdleThreadLimit) {
-    mEvents.NotifyAll();  // wake up threads so they observe this change
+    mEventsAvailable.NotifyAll();  // wake up threads so they observe this change
   }
   return NS_OK;
 }
@@ -407,7 +538,7 @@ nsThreadPool::SetIdleThreadTimeout(uint32_t aValue)
 
   // Do we need to notify any idle threads that their sleep time has shortened?
   if (mIdleThreadTimeout < oldTimeout && mIdleCount > 0) {
-    mEvents.NotifyAll();  // wake up threads so they observe this change
+    mEventsAvailable.NotifyAll();  // wake up threads so they observe this change
   }
   return NS_OK;
 }
@@ -447,6 +578,34 @@ nsThreadPool::SetListener(nsIThreadPoolListener* aListener)
   return NS_OK;
 }
 
+NS_IMETHODIMP
+nsThreadPool::GetWorkStealing(bool* aValue)
+{
+  *aValue = !!mStealingQueues;
+  return NS_OK;
+}
+
+NS_IMETHODIMP
+nsThreadPool::SetWorkStealing(bool aValue)
+{
+  MutexAutoLock lock(mMutex);
+  // The queues are read without mMutex, so they can't change once events are
+  // being dispatched.
+  if (mDispatched || mThreads.Count() || mShutdown) {
+    return NS_ERROR_NOT_AVAILABLE;
+  }
+
+  if (!aValue) {
+    mStealingQueues = nullptr;
+    mStealingQueueCount = 0;
+    return NS_OK;
+  }
+
+  mStealingQueueCount = std::max(mThreadLimit, 1u);
+  mStealingQueues = MakeUnique<StealingQueue[]>(mStealingQueueCount);
+  return NS_OK;
+}
+
 NS_IMETHODIMP
 nsThreadPool::SetName(const nsACString& aName)
 {
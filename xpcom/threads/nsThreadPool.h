@@ -10,14 +10,18 @@
 #include "nsIThreadPool.h"
 #include "nsIThread.h"
 #include "nsIRunnable.h"
-#include "nsEventQueue.h"
 #include "nsCOMArray.h"
 #include "nsCOMPtr.h"
 #include "nsThreadUtils.h"
+#include "mozilla/Atomics.h"
 #include "mozilla/Attributes.h"
 #include "mozilla/AlreadyAddRefed.h"
 #include "mozilla/Mutex.h"
 #include "mozilla/Monitor.h"
+#include "mozilla/TimeStamp.h"
+#include "mozilla/UniquePtr.h"
+
+#include <deque>
 
 class nsThreadPool final
   : public nsIThreadPool
@@ -34,23 +38,58 @@ public:
 private:
   ~nsThreadPool();
 
+  // An event, and when it was dispatched.
+  struct PendingEvent
+  {
+    nsCOMPtr<nsIRunnable> mEvent;
+    mozilla::TimeStamp    mDispatchTime;
+  };
+  typedef std::deque<PendingEvent> EventQueue;
+
+  // One of the queues of a work stealing pool. Each thread has a home queue,
+  // and dispatched events are spread over the queues in turn.
+  struct StealingQueue
+  {
+    StealingQueue() : mMutex("[nsThreadPool.StealingQueue.mMutex]") {}
+
+    mozilla::Mutex mMutex;
+    EventQueue     mEvents;
+  };
+
   void ShutdownThread(nsIThread* aThread);
   nsresult PutEvent(nsIRunnable* aEvent);
   nsresult PutEvent(already_AddRefed<nsIRunnable> aEvent, uint32_t aFlags);
+  nsresult PutStealingEvent(already_AddRefed<nsIRunnable> aEvent,
+                            uint32_t aFlags);
+  nsresult SpawnThread();
+
+  // Take the first event of a queue, starting with aHomeQueue. Doesn't
+  // require mMutex.
+  bool GetStealingEvent(uint32_t aHomeQueue, PendingEvent& aEvent);
 
   nsCOMArray<nsIThread> mThreads;
   mozilla::Mutex        mMutex;
   mozilla::CondVar      mEventsAvailable;
-  nsEventQueue          mEvents;
+  EventQueue            mEvents;
   uint32_t              mThreadLimit;
   uint32_t              mIdleThreadLimit;
   uint32_t              mIdleThreadTimeout;
-  uint32_t              mIdleCount;
+  // Read without mMutex by PutStealingEvent().
+  mozilla::Atomic<uint32_t> mIdleCount;
+  mozilla::Atomic<uint32_t> mThreadCount;
   uint32_t              mStackSize;
   nsCOMPtr<nsIThreadPoolListener> mListener;
-  bool                  mShutdown;
+  mozilla::Atomic<bool> mShutdown;
+  // Set by the first dispatch, after which the mode can't change.
+  mozilla::Atomic<bool, mozilla::Relaxed> mDispatched;
   nsCString             mName;
   nsThreadPoolNaming    mThreadNaming;
+
+  // Only used by work stealing pools.
+  mozilla::UniquePtr<StealingQueue[]> mStealingQueues;
+  uint32_t              mStealingQueueCount;
+  mozilla::Atomic<uint32_t, mozilla::Relaxed> mNextStealingQueue;
+  mozilla::Atomic<uint32_t, mozilla::Relaxed> mNextHomeQueue;
 };
 
 #define NS_THREADPOOL_CID                          \